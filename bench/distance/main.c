@@ -0,0 +1,173 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../harness.h"
+
+#include <nmealib/distance.h>
+#include <nmealib/nmath.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define POSITIONS (4096)
+
+static volatile double sink;
+static volatile size_t sinkIndex;
+
+typedef struct _DistanceBench {
+    NmeaPosition  from;
+    NmeaPosition *positions;
+    double       *distances;
+} DistanceBench;
+
+static void oneToManyLoop(void *arg, size_t iterations) {
+  DistanceBench *b = (DistanceBench *) arg;
+  size_t repeat;
+  size_t i;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    for (i = 0; i < POSITIONS; i++) {
+      b->distances[i] = nmeaMathDistance(&b->from, &b->positions[i]);
+    }
+    sink = b->distances[repeat % POSITIONS];
+  }
+}
+
+static void oneToManyExact(void *arg, size_t iterations) {
+  DistanceBench *b = (DistanceBench *) arg;
+  size_t repeat;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    nmeaDistanceOneToMany(&b->from, b->positions, POSITIONS, b->distances, NMEALIB_DISTANCE_EXACT);
+    sink = b->distances[repeat % POSITIONS];
+  }
+}
+
+static void oneToManyFast(void *arg, size_t iterations) {
+  DistanceBench *b = (DistanceBench *) arg;
+  size_t repeat;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    nmeaDistanceOneToMany(&b->from, b->positions, POSITIONS, b->distances, NMEALIB_DISTANCE_FAST);
+    sink = b->distances[repeat % POSITIONS];
+  }
+}
+
+static void pathLoop(void *arg, size_t iterations) {
+  DistanceBench *b = (DistanceBench *) arg;
+  size_t repeat;
+  size_t i;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    double length = 0.0;
+
+    for (i = 1; i < POSITIONS; i++) {
+      length += nmeaMathDistance(&b->positions[i - 1], &b->positions[i]);
+    }
+    sink = length;
+  }
+}
+
+static void pathExact(void *arg, size_t iterations) {
+  DistanceBench *b = (DistanceBench *) arg;
+  size_t repeat;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    sink = nmeaDistancePath(b->positions, POSITIONS, NULL, NMEALIB_DISTANCE_EXACT);
+  }
+}
+
+static void pathFast(void *arg, size_t iterations) {
+  DistanceBench *b = (DistanceBench *) arg;
+  size_t repeat;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    sink = nmeaDistancePath(b->positions, POSITIONS, NULL, NMEALIB_DISTANCE_FAST);
+  }
+}
+
+static void nearestExact(void *arg, size_t iterations) {
+  DistanceBench *b = (DistanceBench *) arg;
+  size_t repeat;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    sinkIndex = nmeaDistanceNearest(&b->from, b->positions, POSITIONS, NULL, NMEALIB_DISTANCE_EXACT);
+  }
+}
+
+static void nearestFast(void *arg, size_t iterations) {
+  DistanceBench *b = (DistanceBench *) arg;
+  size_t repeat;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    sinkIndex = nmeaDistanceNearest(&b->from, b->positions, POSITIONS, NULL, NMEALIB_DISTANCE_FAST);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  BenchHarness harness;
+  DistanceBench b;
+  size_t i;
+  double error = 0.0;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  b.positions = malloc(POSITIONS * sizeof(*b.positions));
+  b.distances = malloc(POSITIONS * sizeof(*b.distances));
+  if (!b.positions //
+      || !b.distances) {
+    fprintf(stderr, "out of memory\n");
+    free(b.positions);
+    free(b.distances);
+    benchHarnessFinish(&harness);
+    return 1;
+  }
+
+  for (i = 0; i < POSITIONS; i++) {
+    b.positions[i].lat = nmeaMathDegreeToRadian(52.0 + (sin((double) i * 0.01) * 0.5));
+    b.positions[i].lon = nmeaMathDegreeToRadian(4.5 + (cos((double) i * 0.013) * 0.5));
+  }
+  b.from.lat = nmeaMathDegreeToRadian(52.1);
+  b.from.lon = nmeaMathDegreeToRadian(4.4);
+
+  benchHarnessSection(&harness, "one to many (ns/distance)");
+  benchHarnessRun(&harness, "distance/one-to-many-loop", oneToManyLoop, &b, POSITIONS);
+  benchHarnessRun(&harness, "distance/one-to-many-exact", oneToManyExact, &b, POSITIONS);
+  if (benchHarnessRun(&harness, "distance/one-to-many-fast", oneToManyFast, &b, POSITIONS) //
+      && harness.table) {
+    for (i = 0; i < POSITIONS; i++) {
+      error = fmax(error, fabs(b.distances[i] - nmeaMathDistance(&b.from, &b.positions[i])));
+    }
+    printf("%-36s %12.2e m\n", "max fast error", error);
+  }
+
+  benchHarnessSection(&harness, "path (ns/distance)");
+  benchHarnessRun(&harness, "distance/path-loop", pathLoop, &b, POSITIONS - 1);
+  benchHarnessRun(&harness, "distance/path-exact", pathExact, &b, POSITIONS - 1);
+  benchHarnessRun(&harness, "distance/path-fast", pathFast, &b, POSITIONS - 1);
+
+  benchHarnessSection(&harness, "nearest (ns/distance)");
+  benchHarnessRun(&harness, "distance/nearest-exact", nearestExact, &b, POSITIONS);
+  benchHarnessRun(&harness, "distance/nearest-fast", nearestFast, &b, POSITIONS);
+
+  free(b.positions);
+  free(b.distances);
+  benchHarnessFinish(&harness);
+  return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../harness.h"
+
+#include <nmealib/format.h>
+#include <nmealib/info.h>
+#include <nmealib/sentence.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static volatile int sink;
+
+typedef struct _FormatBench {
+    NmeaMallocedBuffer buf;
+    NmeaInfo           info;
+    unsigned int       sentences;
+} FormatBench;
+
+static void formatSnprintfDouble(void *arg __attribute__((unused)), size_t iterations) {
+  char s[64];
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    double v = 5000.0 + ((double) (i & 0xffff) / 16384.0);
+
+    sink += snprintf(s, sizeof(s), ",%09.4f", v);
+  }
+}
+
+static void formatDouble(void *arg __attribute__((unused)), size_t iterations) {
+  char s[64];
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    double v = 5000.0 + ((double) (i & 0xffff) / 16384.0);
+
+    sink += nmeaFormatChar(s, sizeof(s), ',');
+    sink += nmeaFormatDouble(&s[1], sizeof(s) - 1, v, 9, 4);
+  }
+}
+
+static void formatSnprintfUnsigned(void *arg __attribute__((unused)), size_t iterations) {
+  char s[64];
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sink += snprintf(s, sizeof(s), ",%02u", (unsigned int) (i % 60));
+  }
+}
+
+static void formatUnsigned(void *arg __attribute__((unused)), size_t iterations) {
+  char s[64];
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sink += nmeaFormatChar(s, sizeof(s), ',');
+    sink += nmeaFormatUnsigned(&s[1], sizeof(s) - 1, i % 60, 2);
+  }
+}
+
+static void formatSentences(void *arg, size_t iterations) {
+  FormatBench *b = (FormatBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sink += (int) nmeaSentenceFromInfo(&b->buf, &b->info, b->sentences);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  BenchHarness harness;
+  FormatBench b;
+  size_t i;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  /* fields */
+
+  benchHarnessSection(&harness, "fields (ns/field)");
+  benchHarnessRun(&harness, "format/snprintf-double", formatSnprintfDouble, NULL, 1);
+  benchHarnessRun(&harness, "format/double", formatDouble, NULL, 1);
+  benchHarnessRun(&harness, "format/snprintf-unsigned", formatSnprintfUnsigned, NULL, 1);
+  benchHarnessRun(&harness, "format/unsigned", formatUnsigned, NULL, 1);
+
+  /* sentences */
+
+  memset(&b, 0, sizeof(b));
+  b.sentences = NMEALIB_SENTENCE_GPGGA //
+      | NMEALIB_SENTENCE_GPGSA //
+      | NMEALIB_SENTENCE_GPGSV //
+      | NMEALIB_SENTENCE_GPRMC //
+      | NMEALIB_SENTENCE_GPVTG;
+  nmeaInfoClear(&b.info);
+  nmeaTimeSet(&b.info.utc, &b.info.present, NULL);
+
+  b.info.sig = NMEALIB_SIG_FIX;
+  b.info.fix = NMEALIB_FIX_3D;
+  b.info.latitude = 5000.1234;
+  b.info.longitude = 3600.5678;
+  b.info.speed = 7.704;
+  b.info.elevation = 10.86;
+  b.info.track = 45;
+  b.info.mtrack = 55;
+  b.info.magvar = 55;
+  b.info.hdop = 2.3;
+  b.info.vdop = 1.2;
+  b.info.pdop = 2.594224354;
+  nmeaInfoSetPresent(&b.info.present, NMEALIB_PRESENT_SIG | NMEALIB_PRESENT_FIX | NMEALIB_PRESENT_LAT
+      | NMEALIB_PRESENT_LON | NMEALIB_PRESENT_SPEED | NMEALIB_PRESENT_ELV | NMEALIB_PRESENT_TRACK
+      | NMEALIB_PRESENT_MTRACK | NMEALIB_PRESENT_MAGVAR | NMEALIB_PRESENT_HDOP | NMEALIB_PRESENT_VDOP
+      | NMEALIB_PRESENT_PDOP);
+
+  b.info.satellites.inUseCount = 8;
+  b.info.satellites.inViewCount = 12;
+  for (i = 0; i < b.info.satellites.inViewCount; i++) {
+    if (i < b.info.satellites.inUseCount) {
+      b.info.satellites.inUse[i] = (unsigned int) (i + 1);
+    }
+    b.info.satellites.inView[i].prn = (unsigned int) (i + 1);
+    b.info.satellites.inView[i].elevation = (int) ((i * 10) % 90);
+    b.info.satellites.inView[i].azimuth = (unsigned int) (i * 30);
+    b.info.satellites.inView[i].snr = 40 + (unsigned int) i;
+  }
+  nmeaInfoSetPresent(&b.info.present, NMEALIB_PRESENT_SATINUSECOUNT | NMEALIB_PRESENT_SATINUSE
+      | NMEALIB_PRESENT_SATINVIEWCOUNT | NMEALIB_PRESENT_SATINVIEW);
+
+  benchHarnessSection(&harness, "sentences (ns/info)");
+  benchHarnessRun(&harness, "format/sentences-from-info", formatSentences, &b, 1);
+
+  free(b.buf.buffer);
+  benchHarnessFinish(&harness);
+  return 0;
+}
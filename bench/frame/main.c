@@ -0,0 +1,220 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Speed of the coordinate frame conversion kernels, per point, against a
+ * scalar geodetic to ENU loop over NmeaPosition arrays.
+ */
+
+#include "../harness.h"
+
+#include <nmealib/frame.h>
+#include <nmealib/nmath.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define POINTS (1u << 20)
+
+static volatile double sink;
+
+typedef struct _FrameBench {
+    NmeaFrameOrigin origin;
+    NmeaFrameMode   mode;
+    NmeaPosition   *positions;
+    double         *lat;
+    double         *lon;
+    double         *height;
+    double         *a;
+    double         *b;
+    double         *c;
+    double         *d;
+} FrameBench;
+
+/**
+ * Geodetic to ENU, one point at a time, the way a consumer would write it
+ */
+static void scalarEnu(const NmeaFrameOrigin *origin, const NmeaPosition *positions, size_t count, double *east,
+    double *north, double *up) {
+  double e2 = NMEALIB_EARTH_FLATTENING * (2.0 - NMEALIB_EARTH_FLATTENING);
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    double sinLat = sin(positions[i].lat);
+    double cosLat = cos(positions[i].lat);
+    double nu = NMEALIB_EARTHRADIUS_M / sqrt(1.0 - (e2 * sinLat * sinLat));
+    double dx = (nu * cosLat * cos(positions[i].lon)) - origin->x;
+    double dy = (nu * cosLat * sin(positions[i].lon)) - origin->y;
+    double dz = (nu * (1.0 - e2) * sinLat) - origin->z;
+    double t = (origin->cosLon * dx) + (origin->sinLon * dy);
+
+    east[i] = (origin->cosLon * dy) - (origin->sinLon * dx);
+    north[i] = (origin->cosLat * dz) - (origin->sinLat * t);
+    up[i] = (origin->cosLat * t) + (origin->sinLat * dz);
+  }
+}
+
+static void frameSplitPositions(void *arg, size_t iterations) {
+  FrameBench *f = (FrameBench *) arg;
+  size_t repeat;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    nmeaFrameSplitPositions(f->positions, POINTS, f->lat, f->lon);
+    sink = f->lat[repeat % POINTS];
+  }
+}
+
+static void frameScalarEnu(void *arg, size_t iterations) {
+  FrameBench *f = (FrameBench *) arg;
+  size_t repeat;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    scalarEnu(&f->origin, f->positions, POINTS, f->a, f->b, f->c);
+    sink = f->a[repeat % POINTS];
+  }
+}
+
+static void frameGeodeticToEnu(void *arg, size_t iterations) {
+  FrameBench *f = (FrameBench *) arg;
+  size_t repeat;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    nmeaFrameGeodeticToEnu(&f->origin, f->lat, f->lon, f->height, POINTS, f->a, f->b, f->c, f->mode);
+    sink = f->a[repeat % POINTS];
+  }
+}
+
+static void frameGeodeticToEcef(void *arg, size_t iterations) {
+  FrameBench *f = (FrameBench *) arg;
+  size_t repeat;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    nmeaFrameGeodeticToEcef(f->lat, f->lon, f->height, POINTS, f->a, f->b, f->c, f->mode);
+    sink = f->a[repeat % POINTS];
+  }
+}
+
+static void frameGeodeticToUtm(void *arg, size_t iterations) {
+  FrameBench *f = (FrameBench *) arg;
+  size_t repeat;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    nmeaFrameGeodeticToUtm(31, false, f->lat, f->lon, POINTS, f->a, f->b, f->mode);
+    sink = f->a[repeat % POINTS];
+  }
+}
+
+static void frameUtmToGeodetic(void *arg, size_t iterations) {
+  FrameBench *f = (FrameBench *) arg;
+  size_t repeat;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    nmeaFrameUtmToGeodetic(31, false, f->a, f->b, POINTS, f->c, f->d, f->mode);
+    sink = f->c[repeat % POINTS];
+  }
+}
+
+static void frameEcefToGeodetic(void *arg, size_t iterations) {
+  FrameBench *f = (FrameBench *) arg;
+  size_t repeat;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    nmeaFrameEcefToGeodetic(f->a, f->b, f->c, POINTS, f->lat, f->lon, f->d);
+    sink = f->lat[repeat % POINTS];
+  }
+}
+
+int main(int argc, char *argv[]) {
+  BenchHarness harness;
+  FrameBench f;
+  double *buffers;
+  NmeaPosition position;
+  size_t m;
+  size_t i;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  f.positions = malloc(POINTS * sizeof(*f.positions));
+  buffers = malloc(7 * POINTS * sizeof(*buffers));
+  if (!f.positions //
+      || !buffers) {
+    fprintf(stderr, "out of memory\n");
+    free(f.positions);
+    free(buffers);
+    benchHarnessFinish(&harness);
+    return 1;
+  }
+
+  f.lat = buffers;
+  f.lon = &buffers[POINTS];
+  f.height = &buffers[2 * POINTS];
+  f.a = &buffers[3 * POINTS];
+  f.b = &buffers[4 * POINTS];
+  f.c = &buffers[5 * POINTS];
+  f.d = &buffers[6 * POINTS];
+
+  for (i = 0; i < POINTS; i++) {
+    f.positions[i].lat = nmeaMathDegreeToRadian(52.0 + (sin((double) i * 0.01) * 0.5));
+    f.positions[i].lon = nmeaMathDegreeToRadian(4.5 + (cos((double) i * 0.013) * 0.5));
+    f.height[i] = 10.0 + (sin((double) i * 0.1) * 5.0);
+  }
+  position.lat = nmeaMathDegreeToRadian(52.1);
+  position.lon = nmeaMathDegreeToRadian(4.4);
+  nmeaFrameOriginInit(&f.origin, &position, 0.0);
+  nmeaFrameSplitPositions(f.positions, POINTS, f.lat, f.lon);
+
+  benchHarnessSection(&harness, "positions (ns/point)");
+  benchHarnessRun(&harness, "frame/split-positions", frameSplitPositions, &f, POINTS);
+  benchHarnessRun(&harness, "frame/enu-scalar-loop", frameScalarEnu, &f, POINTS);
+
+  for (m = 0; m < 2; m++) {
+    const char *suffix = m ?
+        "fast" :
+        "exact";
+    char name[64];
+
+    f.mode = m ?
+        NMEALIB_FRAME_FAST :
+        NMEALIB_FRAME_EXACT;
+
+    snprintf(name, sizeof(name), "conversions, %s (ns/point)", suffix);
+    benchHarnessSection(&harness, name);
+    snprintf(name, sizeof(name), "frame/geodetic-to-enu-%s", suffix);
+    benchHarnessRun(&harness, name, frameGeodeticToEnu, &f, POINTS);
+    snprintf(name, sizeof(name), "frame/geodetic-to-ecef-%s", suffix);
+    benchHarnessRun(&harness, name, frameGeodeticToEcef, &f, POINTS);
+
+    /* the UTM coordinates are the input of the inverse */
+    nmeaFrameGeodeticToUtm(31, false, f.lat, f.lon, POINTS, f.a, f.b, f.mode);
+    snprintf(name, sizeof(name), "frame/geodetic-to-utm-%s", suffix);
+    benchHarnessRun(&harness, name, frameGeodeticToUtm, &f, POINTS);
+    snprintf(name, sizeof(name), "frame/utm-to-geodetic-%s", suffix);
+    benchHarnessRun(&harness, name, frameUtmToGeodetic, &f, POINTS);
+  }
+
+  /* the ECEF coordinates are the input, the geodetic coordinates round trip */
+  nmeaFrameGeodeticToEcef(f.lat, f.lon, f.height, POINTS, f.a, f.b, f.c, NMEALIB_FRAME_EXACT);
+  benchHarnessSection(&harness, "inverse (ns/point)");
+  benchHarnessRun(&harness, "frame/ecef-to-geodetic", frameEcefToGeodetic, &f, POINTS);
+
+  free(buffers);
+  free(f.positions);
+  benchHarnessFinish(&harness);
+  return 0;
+}
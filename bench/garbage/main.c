@@ -0,0 +1,139 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../harness.h"
+
+#include <nmealib/corpus.h>
+#include <nmealib/info.h>
+#include <nmealib/parser.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FIXES (20000)
+
+static volatile size_t sink;
+
+typedef struct _GarbageBench {
+    NmeaParser  parser;
+    NmeaInfo    info;
+    const char *s;
+    size_t      sz;
+} GarbageBench;
+
+static void garbageParse(void *arg, size_t iterations) {
+  GarbageBench *b = (GarbageBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sink = nmeaParserParse(&b->parser, b->s, b->sz, &b->info);
+  }
+}
+
+/**
+ * Parse a corpus and report throughput and recovery
+ */
+static void run(BenchHarness *harness, const char *name, const NmeaCorpusConfig *config) {
+  NmeaMallocedBuffer buf;
+  NmeaCorpusStats stats;
+  GarbageBench b;
+  size_t parsed;
+
+  memset(&buf, 0, sizeof(buf));
+  memset(&b, 0, sizeof(b));
+  b.sz = nmeaCorpusGenerate(config, FIXES, &buf, &stats);
+  if (!b.sz) {
+    fprintf(stderr, "%s: could not generate the corpus\n", name);
+    return;
+  }
+
+  nmeaParserInit(&b.parser, 0);
+  b.s = buf.buffer;
+  parsed = nmeaParserParse(&b.parser, b.s, b.sz, &b.info);
+
+  if (benchHarnessRun(harness, name, garbageParse, &b, b.sz) //
+      && harness->table) {
+    printf("  %lu bytes, %.1f%% mutated, %.1f%% recovered\n", (unsigned long) b.sz,
+        100.0 * (1.0 - ((double) stats.intact / (double) stats.sentences)),
+        stats.intact ?
+            (100.0 * (double) parsed) / (double) stats.intact :
+            0.0);
+  }
+
+  nmeaParserDestroy(&b.parser);
+  free(buf.buffer);
+}
+
+int main(int argc, char *argv[]) {
+  static const double ratios[] = {
+      0.0,
+      0.01,
+      0.05,
+      0.1,
+      0.2,
+      0.3,
+      0.5 };
+  BenchHarness harness;
+  NmeaCorpusConfig config;
+  char name[32];
+  size_t i;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  memset(&config, 0, sizeof(config));
+  config.type = NMEALIB_GENERATOR_ROTATE;
+  config.mask = NMEALIB_SENTENCE_MASK;
+  config.seed = 1;
+
+  benchHarnessSection(&harness, "garbage ratio, every mutation and noise (ns/byte)");
+  for (i = 0; i < (sizeof(ratios) / sizeof(ratios[0])); i++) {
+    nmeaCorpusConfigGarbage(&config, ratios[i]);
+    snprintf(name, sizeof(name), "garbage/ratio-%.2f", ratios[i]);
+    run(&harness, name, &config);
+  }
+
+  benchHarnessSection(&harness, "reset paths, half of the sentences (ns/byte)");
+
+  nmeaCorpusConfigGarbage(&config, 0.0);
+  config.truncateRate = 0.5;
+  run(&harness, "garbage/truncated", &config);
+
+  nmeaCorpusConfigGarbage(&config, 0.0);
+  config.bitFlipRate = 0.5;
+  run(&harness, "garbage/bit-flip", &config);
+
+  nmeaCorpusConfigGarbage(&config, 0.0);
+  config.checksumRate = 0.5;
+  run(&harness, "garbage/checksum", &config);
+
+  nmeaCorpusConfigGarbage(&config, 0.0);
+  config.hexRate = 0.5;
+  run(&harness, "garbage/bad-hex", &config);
+
+  nmeaCorpusConfigGarbage(&config, 0.0);
+  config.overlongRate = 0.5;
+  run(&harness, "garbage/overlong", &config);
+
+  nmeaCorpusConfigGarbage(&config, 0.0);
+  config.noiseRate = 0.5;
+  run(&harness, "garbage/noise", &config);
+
+  benchHarnessFinish(&harness);
+  return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../harness.h"
+
+#include <nmealib/geodesic.h>
+#include <nmealib/nmath.h>
+#include <nmealib/random.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define UNITS (1000)
+
+/** The ratio of the distances on WGS84 to the ones of nmeaMathDistanceEllipsoid, which has the semi-minor axis for a */
+#define SCALE ((double) NMEALIB_EARTHRADIUS_M / NMEALIB_EARTH_SEMIMAJORAXIS_M)
+
+typedef struct _GeodesicBench {
+    NmeaPosition *units;
+    double       *vincenty;
+    double       *geodesic;
+} GeodesicBench;
+
+/**
+ * Rows of the distance matrix of the fleet with nmeaMathDistanceEllipsoid
+ */
+static void matrixVincenty(void *arg, size_t iterations) {
+  GeodesicBench *b = (GeodesicBench *) arg;
+  size_t i;
+  size_t column;
+
+  for (i = 0; i < iterations; i++) {
+    size_t row = i % UNITS;
+
+    for (column = 0; column < UNITS; column++) {
+      b->vincenty[(row * UNITS) + column] = nmeaMathDistanceEllipsoid(&b->units[row], &b->units[column], NULL, NULL);
+    }
+  }
+}
+
+/**
+ * Rows of the distance matrix of the fleet with nmeaGeodesicDistances
+ */
+static void matrixGeodesic(void *arg, size_t iterations) {
+  GeodesicBench *b = (GeodesicBench *) arg;
+  NmeaGeodesicOrigin origin;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    size_t row = i % UNITS;
+
+    nmeaGeodesicOriginInit(&origin, &b->units[row]);
+    nmeaGeodesicDistances(&origin, b->units, UNITS, &b->geodesic[row * UNITS]);
+  }
+}
+
+/**
+ * Compute a distance matrix of a fleet with both solvers
+ */
+static void run(BenchHarness *harness, const char *name, GeodesicBench *b) {
+  char benchmark[64];
+  size_t i;
+  size_t differ = 0;
+  double error = 0.0;
+
+  snprintf(benchmark, sizeof(benchmark), "%s, %d x %d (ns/distance)", name, UNITS, UNITS);
+  benchHarnessSection(harness, benchmark);
+  snprintf(benchmark, sizeof(benchmark), "geodesic/%s-distance-ellipsoid", name);
+  benchHarnessRun(harness, benchmark, matrixVincenty, b, UNITS);
+  snprintf(benchmark, sizeof(benchmark), "geodesic/%s-geodesic-distances", name);
+  benchHarnessRun(harness, benchmark, matrixGeodesic, b, UNITS);
+
+  if (!harness->table) {
+    return;
+  }
+
+  /* the whole matrix */
+  matrixVincenty(b, UNITS);
+  matrixGeodesic(b, UNITS);
+
+  /* nmeaMathDistanceEllipsoid takes the arc sine of the arc length, so only compare below a quarter meridian */
+  for (i = 0; i < (UNITS * UNITS); i++) {
+    if (b->geodesic[i] < 9E6) {
+      error = fmax(error, fabs((SCALE * b->vincenty[i]) - b->geodesic[i]));
+    } else if (!(fabs((SCALE * b->vincenty[i]) - b->geodesic[i]) < 1.0)) {
+      differ++;
+    }
+  }
+  printf("%-36s %12.2e m (below 9000 km), %lu beyond differ\n", "max difference, scaled", error, (unsigned long) differ);
+}
+
+int main(int argc, char *argv[]) {
+  BenchHarness harness;
+  GeodesicBench b;
+  NmeaRandom random;
+  size_t i;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  b.units = malloc(UNITS * sizeof(*b.units));
+  b.vincenty = malloc(UNITS * UNITS * sizeof(*b.vincenty));
+  b.geodesic = malloc(UNITS * UNITS * sizeof(*b.geodesic));
+  if (!b.units //
+      || !b.vincenty //
+      || !b.geodesic) {
+    fprintf(stderr, "out of memory\n");
+    free(b.units);
+    free(b.vincenty);
+    free(b.geodesic);
+    benchHarnessFinish(&harness);
+    return 1;
+  }
+
+  nmeaRandomSeed(&random, 1);
+
+  /* a regional fleet */
+  for (i = 0; i < UNITS; i++) {
+    b.units[i].lat = nmeaMathDegreeToRadian(nmeaRandomDouble(&random, 50.0, 54.0));
+    b.units[i].lon = nmeaMathDegreeToRadian(nmeaRandomDouble(&random, 2.0, 8.0));
+  }
+  run(&harness, "regional", &b);
+
+  /* a global fleet, with nearly antipodal pairs */
+  for (i = 0; i < UNITS; i++) {
+    b.units[i].lat = asin(nmeaRandomDouble(&random, -1.0, 1.0));
+    b.units[i].lon = nmeaRandomDouble(&random, -NMEALIB_PI, NMEALIB_PI);
+  }
+  run(&harness, "global", &b);
+
+  free(b.units);
+  free(b.vincenty);
+  free(b.geodesic);
+  benchHarnessFinish(&harness);
+  return 0;
+}
@@ -0,0 +1,230 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../harness.h"
+
+#include <nmealib/geofence.h>
+#include <nmealib/nmath.h>
+#include <nmealib/random.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CIRCLES (4000u)
+#define POLYGONS (1000u)
+#define FENCES (CIRCLES + POLYGONS)
+#define RECEIVERS (1000u)
+#define FIXES (200000u)
+
+static volatile size_t sinkCount;
+static size_t transitions;
+
+typedef struct _GeofenceBench {
+    NmeaGeofenceMode  mode;
+    NmeaGeofenceSet  *set;
+    NmeaPosition     *centers;
+    double           *radii;
+    NmeaPosition     *start;
+    NmeaPosition     *steps;
+    NmeaPosition     *receivers;
+    size_t            fixes;
+} GeofenceBench;
+
+static void callback(void *userData __attribute__((unused)), uint64_t receiver __attribute__((unused)),
+    uint64_t fence __attribute__((unused)), NmeaGeofenceTransition transition __attribute__((unused))) {
+  transitions++;
+}
+
+/**
+ * A position in a 300 x 300 km region around Utrecht
+ */
+static void randomPosition(NmeaRandom *random, NmeaPosition *position) {
+  position->lat = nmeaMathDegreeToRadian(52.1 + nmeaRandomDouble(random, -1.35, 1.35));
+  position->lon = nmeaMathDegreeToRadian(5.1 + nmeaRandomDouble(random, -2.2, 2.2));
+}
+
+/**
+ * Add the same fences to a set
+ */
+static void addFences(NmeaGeofenceSet *set, const NmeaPosition *centers, const double *radii) {
+  size_t i;
+
+  for (i = 0; i < CIRCLES; i++) {
+    nmeaGeofenceAddCircle(set, i, &centers[i], radii[i]);
+  }
+
+  /* hexagons of about 4 km wide */
+  for (i = CIRCLES; i < FENCES; i++) {
+    NmeaPosition vertices[6];
+    size_t v;
+
+    for (v = 0; v < 6; v++) {
+      double angle = (double) v * (NMEALIB_PI / 3.0);
+
+      vertices[v].lat = centers[i].lat + (3E-4 * sin(angle));
+      vertices[v].lon = centers[i].lon + (5E-4 * cos(angle));
+    }
+    nmeaGeofenceAddPolygon(set, i, vertices, 6);
+  }
+
+  nmeaGeofenceCompile(set);
+}
+
+static void geofenceCompile(void *arg, size_t iterations) {
+  GeofenceBench *b = (GeofenceBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    NmeaGeofenceSet *set = nmeaGeofenceCreate(NMEALIB_GEOFENCE_SPHERICAL, 0.0, callback, NULL);
+
+    addFences(set, b->centers, b->radii);
+    nmeaGeofenceDestroy(set);
+  }
+}
+
+/**
+ * Naive: a nmeaMathDistance call per circle, without transitions
+ */
+static void geofenceNaive(void *arg, size_t iterations) {
+  GeofenceBench *b = (GeofenceBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    const NmeaPosition *position = &b->start[i % RECEIVERS];
+    size_t count = 0;
+    size_t c;
+
+    for (c = 0; c < CIRCLES; c++) {
+      if (nmeaMathDistance(&b->centers[c], position) <= b->radii[c]) {
+        count++;
+      }
+    }
+    sinkCount = count;
+  }
+}
+
+/**
+ * Evaluate fixes, moving every receiver a bit per fix, back to the start
+ * every FIXES fixes
+ */
+static void geofenceUpdate(void *arg, size_t iterations) {
+  GeofenceBench *b = (GeofenceBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++, b->fixes++) {
+    size_t r = b->fixes % RECEIVERS;
+
+    if (!(b->fixes % FIXES)) {
+      size_t j;
+
+      for (j = 0; j < RECEIVERS; j++) {
+        b->receivers[j] = b->start[j];
+      }
+    }
+
+    b->receivers[r].lat += b->steps[r].lat;
+    b->receivers[r].lon += b->steps[r].lon;
+    nmeaGeofenceUpdate(b->set, r, &b->receivers[r]);
+  }
+}
+
+static void run(BenchHarness *harness, const char *name, GeofenceBench *b) {
+  b->set = nmeaGeofenceCreate(b->mode, 0.0, callback, NULL);
+  if (!b->set) {
+    fprintf(stderr, "%s: out of memory\n", name);
+    return;
+  }
+
+  addFences(b->set, b->centers, b->radii);
+  b->fixes = 0;
+  transitions = 0;
+  if (benchHarnessRun(harness, name, geofenceUpdate, b, 1) //
+      && harness->table) {
+    printf("%-36s %12.4f transitions/fix\n", "", (double) transitions / (double) b->fixes);
+  }
+
+  nmeaGeofenceDestroy(b->set);
+  b->set = NULL;
+}
+
+int main(int argc, char *argv[]) {
+  BenchHarness harness;
+  GeofenceBench b;
+  NmeaRandom random;
+  size_t i;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  b.set = NULL;
+  b.centers = malloc(FENCES * sizeof(*b.centers));
+  b.radii = malloc(FENCES * sizeof(*b.radii));
+  b.start = malloc(RECEIVERS * sizeof(*b.start));
+  b.steps = malloc(RECEIVERS * sizeof(*b.steps));
+  b.receivers = malloc(RECEIVERS * sizeof(*b.receivers));
+  if (!b.centers //
+      || !b.radii //
+      || !b.start //
+      || !b.steps //
+      || !b.receivers) {
+    fprintf(stderr, "out of memory\n");
+    free(b.centers);
+    free(b.radii);
+    free(b.start);
+    free(b.steps);
+    free(b.receivers);
+    benchHarnessFinish(&harness);
+    return 1;
+  }
+
+  nmeaRandomSeed(&random, 42);
+  for (i = 0; i < FENCES; i++) {
+    randomPosition(&random, &b.centers[i]);
+    b.radii[i] = nmeaRandomDouble(&random, 200.0, 5000.0);
+  }
+  for (i = 0; i < RECEIVERS; i++) {
+    randomPosition(&random, &b.start[i]);
+    /* up to about 60 m per fix */
+    b.steps[i].lat = nmeaRandomDouble(&random, -1E-5, 1E-5);
+    b.steps[i].lon = nmeaRandomDouble(&random, -1E-5, 1E-5);
+  }
+
+  if (harness.table) {
+    printf("%u circles, %u polygons, %u receivers\n", CIRCLES, POLYGONS, RECEIVERS);
+  }
+
+  benchHarnessSection(&harness, "compile (ns/fence)");
+  benchHarnessRun(&harness, "geofence/create-add-compile", geofenceCompile, &b, FENCES);
+
+  benchHarnessSection(&harness, "naive, circles only (ns/fix)");
+  benchHarnessRun(&harness, "geofence/naive-circles", geofenceNaive, &b, 1);
+
+  benchHarnessSection(&harness, "engine (ns/fix)");
+  b.mode = NMEALIB_GEOFENCE_SPHERICAL;
+  run(&harness, "geofence/update-spherical", &b);
+  b.mode = NMEALIB_GEOFENCE_ELLIPSOIDAL;
+  run(&harness, "geofence/update-ellipsoidal", &b);
+
+  free(b.centers);
+  free(b.radii);
+  free(b.start);
+  free(b.steps);
+  free(b.receivers);
+  benchHarnessFinish(&harness);
+  return 0;
+}
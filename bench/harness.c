@@ -0,0 +1,294 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "harness.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** The maximum number of iterations of a sample */
+#define BENCH_MAX_ITERATIONS ((size_t) 1 << 40)
+
+/* the build mode and compiler flags, set by the Makefile */
+#ifndef BENCH_DEBUG
+#define BENCH_DEBUG "unknown"
+#endif
+#ifndef BENCH_CFLAGS
+#define BENCH_CFLAGS "unknown"
+#endif
+
+/*
+ * Helpers
+ */
+
+static double benchNow(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + ((double) ts.tv_nsec / 1E9);
+}
+
+static double benchTime(BenchFunction function, void *arg, size_t iterations) {
+  double start = benchNow();
+
+  function(arg, iterations);
+  return benchNow() - start;
+}
+
+static int benchCompare(const void *a, const void *b) {
+  double x = *(const double *) a;
+  double y = *(const double *) b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+ * Get a percentile of sorted samples (nearest rank)
+ *
+ * @param sorted The sorted samples
+ * @param count The number of samples, at least 1
+ * @param p The percentile, in [0, 1]
+ * @return The percentile
+ */
+static double benchPercentile(const double *sorted, size_t count, double p) {
+  double rank = ceil(p * (double) count);
+  size_t i = (rank < 1.0) ?
+      0 :
+      (size_t) rank - 1;
+
+  if (i >= count) {
+    i = count - 1;
+  }
+
+  return sorted[i];
+}
+
+static void benchUsage(const char *program) {
+  fprintf(stderr, "Usage: %s [--json FILE] [--label LABEL] [--filter TEXT] [--samples N] [--warmup N]"
+      " [--min-time MS]\n", program);
+}
+
+static bool benchParseSize(const char *s, size_t *value) {
+  char *end = NULL;
+  unsigned long v = strtoul(s, &end, 10);
+
+  if (!*s //
+      || *end) {
+    return false;
+  }
+
+  *value = v;
+  return true;
+}
+
+static void benchJsonString(FILE *f, const char *s) {
+  fputc('"', f);
+  for (; *s; s++) {
+    unsigned char c = (unsigned char) *s;
+
+    if ((c == '"') //
+        || (c == '\\')) {
+      fputc('\\', f);
+      fputc(c, f);
+    } else if (c < 0x20) {
+      fprintf(f, "\\u%04x", c);
+    } else {
+      fputc(c, f);
+    }
+  }
+  fputc('"', f);
+}
+
+/*
+ * Public
+ */
+
+bool benchHarnessInit(BenchHarness *harness, int argc, char *argv[]) {
+  const char *json = NULL;
+  size_t minTime = 20;
+  int i;
+
+  if (!harness) {
+    return false;
+  }
+
+  memset(harness, 0, sizeof(*harness));
+  harness->samples = 15;
+  harness->warmup = 2;
+  harness->table = true;
+
+  for (i = 1; i < argc; i++) {
+    const char *option = argv[i];
+    const char *value = (i + 1 < argc) ?
+        argv[i + 1] :
+        NULL;
+    bool valid = !!value;
+
+    if (valid //
+        && !strcmp(option, "--json")) {
+      json = value;
+    } else if (valid //
+        && !strcmp(option, "--label")) {
+      harness->label = value;
+    } else if (valid //
+        && !strcmp(option, "--filter")) {
+      harness->filter = value;
+    } else if (valid //
+        && !strcmp(option, "--samples")) {
+      valid = benchParseSize(value, &harness->samples) //
+          && harness->samples //
+          && (harness->samples <= BENCH_MAX_SAMPLES);
+    } else if (valid //
+        && !strcmp(option, "--warmup")) {
+      valid = benchParseSize(value, &harness->warmup);
+    } else if (valid //
+        && !strcmp(option, "--min-time")) {
+      valid = benchParseSize(value, &minTime);
+    } else {
+      valid = false;
+    }
+
+    if (!valid) {
+      benchUsage(argv[0]);
+      return false;
+    }
+
+    i++;
+  }
+
+  harness->minTime = (double) minTime / 1E3;
+
+  if (strcmp(BENCH_DEBUG, "0")) {
+    fprintf(stderr, "Warning: not an optimised build (DEBUG=%s), the results measure the compiler\n", BENCH_DEBUG);
+  }
+
+  if (json) {
+    if (!strcmp(json, "-")) {
+      harness->json = stdout;
+      harness->table = false;
+    } else {
+      harness->json = fopen(json, "w");
+      if (!harness->json) {
+        fprintf(stderr, "Could not open '%s'\n", json);
+        return false;
+      }
+    }
+
+    fprintf(harness->json, "{\n  \"label\": ");
+    if (harness->label) {
+      benchJsonString(harness->json, harness->label);
+    } else {
+      fprintf(harness->json, "null");
+    }
+    fprintf(harness->json, ",\n  \"build\": { \"debug\": ");
+    benchJsonString(harness->json, BENCH_DEBUG);
+    fprintf(harness->json, ", \"cflags\": ");
+    benchJsonString(harness->json, BENCH_CFLAGS);
+    fprintf(harness->json, " },\n  \"samples\": %lu,\n  \"warmup\": %lu,\n  \"minTime\": %g,\n  \"unit\": \"ns/op\",\n"
+        "  \"results\": [", (unsigned long) harness->samples, (unsigned long) harness->warmup, harness->minTime);
+  }
+
+  if (harness->table) {
+    printf("%-36s %12s %10s %10s %10s %10s %14s\n", "benchmark", "iterations", "min", "p50", "p90", "p99",
+        "ops/s");
+  }
+
+  return true;
+}
+
+void benchHarnessSection(BenchHarness *harness, const char *name) {
+  if (!harness //
+      || !harness->table) {
+    return;
+  }
+
+  printf("\n%s\n", name);
+}
+
+bool benchHarnessRun(BenchHarness *harness, const char *name, BenchFunction function, void *arg, size_t ops) {
+  double samples[BENCH_MAX_SAMPLES];
+  size_t iterations = 1;
+  double sum = 0.0;
+  double perOp;
+  double p50;
+  size_t i;
+
+  if (!harness //
+      || !name //
+      || !function //
+      || !ops //
+      || (harness->filter //
+          && !strstr(name, harness->filter))) {
+    return false;
+  }
+
+  /* calibrate: double the iterations until a sample takes the minimum time */
+  while ((benchTime(function, arg, iterations) < harness->minTime) //
+      && (iterations < BENCH_MAX_ITERATIONS)) {
+    iterations *= 2;
+  }
+
+  for (i = 0; i < harness->warmup; i++) {
+    benchTime(function, arg, iterations);
+  }
+
+  perOp = 1E9 / ((double) iterations * (double) ops);
+  for (i = 0; i < harness->samples; i++) {
+    samples[i] = benchTime(function, arg, iterations) * perOp;
+    sum += samples[i];
+  }
+
+  qsort(samples, harness->samples, sizeof(samples[0]), benchCompare);
+  p50 = benchPercentile(samples, harness->samples, 0.5);
+
+  if (harness->table) {
+    printf("%-36s %12lu %10.2f %10.2f %10.2f %10.2f %14.0f\n", name, (unsigned long) iterations, samples[0], p50,
+        benchPercentile(samples, harness->samples, 0.9), benchPercentile(samples, harness->samples, 0.99),
+        1E9 / p50);
+    fflush(stdout);
+  }
+
+  if (harness->json) {
+    fprintf(harness->json, "%s\n    { \"name\": ", harness->results ?
+        "," :
+        "");
+    benchJsonString(harness->json, name);
+    fprintf(harness->json, ", \"iterations\": %lu, \"ops\": %lu, \"samples\": %lu, \"min\": %.3f, \"mean\": %.3f,"
+        " \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f, \"opsPerSecond\": %.1f }",
+        (unsigned long) iterations, (unsigned long) ops, (unsigned long) harness->samples, samples[0],
+        sum / (double) harness->samples, p50, benchPercentile(samples, harness->samples, 0.9),
+        benchPercentile(samples, harness->samples, 0.99), samples[harness->samples - 1], 1E9 / p50);
+  }
+
+  harness->results++;
+  return true;
+}
+
+void benchHarnessFinish(BenchHarness *harness) {
+  if (!harness //
+      || !harness->json) {
+    return;
+  }
+
+  fprintf(harness->json, "\n  ]\n}\n");
+  if (harness->json != stdout) {
+    fclose(harness->json);
+  }
+  harness->json = NULL;
+}
@@ -0,0 +1,137 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Benchmark harness
+ *
+ * A benchmark is a function that performs an operation a given number of
+ * times. The harness:
+ * - calibrates the number of iterations so that a sample takes at least the
+ *   minimum sample time;
+ * - runs a number of warmup samples, which are discarded;
+ * - runs a number of samples and reports the minimum, the mean, the median,
+ *   the 90th and 99th percentiles and the maximum of the time per operation.
+ *
+ * Results are printed as a table, and written as JSON when requested, so that
+ * results of different commits can be compared by machine:
+ * <pre>
+ * {
+ *   "label": "...",
+ *   "build": { "debug": "...", "cflags": "..." },
+ *   "samples": ..., "warmup": ..., "minTime": ..., "unit": "ns/op",
+ *   "results": [
+ *     { "name": "...", "iterations": ..., "samples": ..., "min": ..., "mean": ..., "p50": ...,
+ *       "p90": ..., "p99": ..., "max": ..., "opsPerSecond": ... },
+ *     ...
+ *   ]
+ * }
+ * </pre>
+ * Times are in nanoseconds per operation. The build records the DEBUG setting
+ * and the compiler flags of the benchmarks: only the results of optimised
+ * builds (DEBUG=0) are meaningful, a warning is printed otherwise.
+ *
+ * Command line options:
+ * - --json FILE: write the results as JSON to FILE ('-' for stdout, which
+ *   suppresses the table);
+ * - --label LABEL: the label of the results, for example a commit;
+ * - --filter TEXT: only run the benchmarks with TEXT in their name;
+ * - --samples N: the number of samples (default 15);
+ * - --warmup N: the number of warmup samples (default 2);
+ * - --min-time MS: the minimum sample time in milliseconds (default 20).
+ */
+
+#ifndef __NMEALIB_BENCH_HARNESS_H__
+#define __NMEALIB_BENCH_HARNESS_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The maximum number of samples of a benchmark */
+#define BENCH_MAX_SAMPLES (1000u)
+
+/**
+ * A benchmark function
+ *
+ * @param arg The argument of the benchmark
+ * @param iterations The number of times to perform the operation
+ */
+typedef void (*BenchFunction)(void *arg, size_t iterations);
+
+/**
+ * Harness state
+ */
+typedef struct _BenchHarness {
+    const char *label;      /**< The label of the results, may be NULL        */
+    const char *filter;     /**< The benchmarks to run, NULL for all          */
+    size_t      samples;    /**< The number of samples                        */
+    size_t      warmup;     /**< The number of warmup samples                 */
+    double      minTime;    /**< The minimum sample time, in seconds          */
+    FILE       *json;       /**< The JSON output, NULL for none               */
+    bool        table;      /**< True to print the table                      */
+    size_t      results;    /**< The number of results written                */
+} BenchHarness;
+
+/**
+ * Initialise the harness from the command line
+ *
+ * @param harness The harness
+ * @param argc The number of arguments
+ * @param argv The arguments
+ * @return True on success, false on invalid options (after printing the
+ * usage) or when the JSON file can't be opened
+ */
+bool benchHarnessInit(BenchHarness *harness, int argc, char *argv[]);
+
+/**
+ * Print a section header in the table
+ *
+ * @param harness The harness
+ * @param name The name of the section
+ */
+void benchHarnessSection(BenchHarness *harness, const char *name);
+
+/**
+ * Run a benchmark
+ *
+ * @param harness The harness
+ * @param name The name of the benchmark, by convention 'area/operation'
+ * @param function The benchmark function
+ * @param arg The argument of the benchmark function
+ * @param ops The number of operations per iteration (for example bytes or
+ * sentences), the times are reported per operation
+ * @return True when the benchmark was run, false when it was filtered out
+ */
+bool benchHarnessRun(BenchHarness *harness, const char *name, BenchFunction function, void *arg, size_t ops);
+
+/**
+ * Finish the harness, completing and closing the JSON output
+ *
+ * @param harness The harness
+ */
+void benchHarnessFinish(BenchHarness *harness);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_BENCH_HARNESS_H__ */
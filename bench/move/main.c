@@ -0,0 +1,173 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Speed and positional error of the exact and fast flat moves, and the speed
+ * of a random move generator in both modes.
+ */
+
+#include "../harness.h"
+
+#include <nmealib/generator.h>
+#include <nmealib/nmath.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define POSITIONS (4096)
+
+static volatile double sink;
+
+typedef struct _MoveBench {
+    const NmeaPosition *positions;
+    NmeaPosition       *to;
+    double              distance;
+    NmeaMathMode        mode;
+} MoveBench;
+
+typedef struct _GeneratorBench {
+    NmeaGenerator *gen;
+    NmeaInfo       info;
+} GeneratorBench;
+
+static void moves(void *arg, size_t iterations) {
+  MoveBench *b = (MoveBench *) arg;
+  size_t repeat;
+  size_t i;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    for (i = 0; i < POSITIONS; i++) {
+      nmeaMathMoveFlatMode(&b->positions[i], &b->to[i], (double) ((i * 7) % 360), b->distance, b->mode);
+    }
+    sink = b->to[repeat % POSITIONS].lat;
+  }
+}
+
+static void invokes(void *arg, size_t iterations) {
+  GeneratorBench *b = (GeneratorBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    nmeaGeneratorInvoke(b->gen, &b->info);
+  }
+  sink = b->info.latitude;
+}
+
+static void runGenerator(BenchHarness *harness, const char *name, NmeaMathMode mode) {
+  GeneratorBench b;
+  NmeaRandom random;
+
+  memset(&b, 0, sizeof(b));
+  b.gen = nmeaGeneratorCreate(NMEALIB_GENERATOR_POS_RANDMOVE, &b.info);
+  if (!b.gen) {
+    return;
+  }
+
+  nmeaRandomSeed(&random, 1234);
+  nmeaGeneratorSetRandom(b.gen, &random);
+  nmeaGeneratorSetMathMode(b.gen, mode);
+
+  benchHarnessRun(harness, name, invokes, &b, 1);
+
+  nmeaGeneratorDestroy(b.gen);
+}
+
+int main(int argc, char *argv[]) {
+  static const double distances[] = {
+      0.001,
+      0.1,
+      10.0,
+      100.0 };
+  BenchHarness harness;
+  NmeaPosition *positions;
+  NmeaPosition *exact;
+  NmeaPosition *fast;
+  MoveBench b;
+  char name[64];
+  size_t d;
+  size_t i;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  positions = malloc(POSITIONS * sizeof(*positions));
+  exact = malloc(POSITIONS * sizeof(*exact));
+  fast = malloc(POSITIONS * sizeof(*fast));
+  if (!positions //
+      || !exact //
+      || !fast) {
+    fprintf(stderr, "out of memory\n");
+    free(positions);
+    free(exact);
+    free(fast);
+    benchHarnessFinish(&harness);
+    return 1;
+  }
+
+  /* latitudes from -85 to 85 degrees, all longitudes */
+  for (i = 0; i < POSITIONS; i++) {
+    positions[i].lat = nmeaMathDegreeToRadian(sin((double) i * 0.01) * 85.0);
+    positions[i].lon = nmeaMathDegreeToRadian(cos((double) i * 0.013) * 180.0);
+  }
+
+  b.positions = positions;
+  for (d = 0; d < (sizeof(distances) / sizeof(distances[0])); d++) {
+    bool ran;
+
+    b.distance = distances[d];
+    snprintf(name, sizeof(name), "move %g km (ns/move)", distances[d]);
+    benchHarnessSection(&harness, name);
+
+    b.to = exact;
+    b.mode = NMEALIB_MATH_EXACT;
+    snprintf(name, sizeof(name), "move/%gkm-exact", distances[d]);
+    ran = benchHarnessRun(&harness, name, moves, &b, POSITIONS);
+
+    b.to = fast;
+    b.mode = NMEALIB_MATH_FAST;
+    snprintf(name, sizeof(name), "move/%gkm-fast", distances[d]);
+    ran = benchHarnessRun(&harness, name, moves, &b, POSITIONS) //
+        && ran;
+
+    if (ran //
+        && harness.table) {
+      double error = 0.0;
+
+      for (i = 0; i < POSITIONS; i++) {
+        double north = fast[i].lat - exact[i].lat;
+        double east = (fast[i].lon - exact[i].lon) * cos(exact[i].lat);
+
+        error = fmax(error, hypot(north, east) * NMEALIB_EARTHRADIUS_M);
+      }
+      printf("%-36s %12.2e m\n", "max fast error", error);
+    }
+  }
+
+  /* generator */
+
+  benchHarnessSection(&harness, "random move generator (ns/invocation)");
+  runGenerator(&harness, "move/generator-exact", NMEALIB_MATH_EXACT);
+  runGenerator(&harness, "move/generator-fast", NMEALIB_MATH_FAST);
+
+  free(positions);
+  free(exact);
+  free(fast);
+  benchHarnessFinish(&harness);
+  return 0;
+}
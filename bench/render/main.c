@@ -0,0 +1,106 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../harness.h"
+
+#include <nmealib/info.h>
+#include <nmealib/render.h>
+#include <nmealib/sentence.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static volatile size_t sink;
+
+typedef struct _RenderBench {
+    NmeaMallocedBuffer buf;
+    NmeaRender         render;
+    NmeaInfo           info;
+} RenderBench;
+
+static void fix(NmeaInfo *info, size_t i) {
+  info->utc.sec = (unsigned int) (i % 60);
+  info->utc.min = (unsigned int) ((i / 60) % 60);
+  info->latitude = 5000.0 + ((double) (i & 0xffff) / 16384.0);
+  info->longitude = 400.0 - ((double) (i & 0xffff) / 16384.0);
+}
+
+static void sentenceFromInfo(void *arg, size_t iterations) {
+  RenderBench *b = (RenderBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    fix(&b->info, i);
+    sink += nmeaSentenceFromInfo(&b->buf, &b->info, NMEALIB_SENTENCE_MASK);
+  }
+}
+
+static void renderFromInfo(void *arg, size_t iterations) {
+  RenderBench *b = (RenderBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    fix(&b->info, i);
+    sink += nmeaRenderFromInfo(&b->render, &b->buf, &b->info, NMEALIB_SENTENCE_MASK);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  BenchHarness harness;
+  RenderBench b;
+  size_t i;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  memset(&b, 0, sizeof(b));
+  nmeaInfoClear(&b.info);
+  nmeaTimeSet(&b.info.utc, &b.info.present, NULL);
+  b.info.sig = NMEALIB_SIG_FIX;
+  b.info.fix = NMEALIB_FIX_3D;
+  b.info.elevation = 10.86;
+  b.info.speed = 7.704;
+  b.info.track = 45;
+  b.info.hdop = 2.3;
+  nmeaInfoSetPresent(&b.info.present, NMEALIB_PRESENT_SIG | NMEALIB_PRESENT_FIX | NMEALIB_PRESENT_LAT
+      | NMEALIB_PRESENT_LON | NMEALIB_PRESENT_ELV | NMEALIB_PRESENT_SPEED | NMEALIB_PRESENT_TRACK
+      | NMEALIB_PRESENT_HDOP);
+
+  b.info.satellites.inViewCount = 9;
+  for (i = 0; i < b.info.satellites.inViewCount; i++) {
+    b.info.satellites.inView[i].prn = (unsigned int) (i + 1);
+    b.info.satellites.inView[i].elevation = (int) (i * 10);
+    b.info.satellites.inView[i].azimuth = (unsigned int) (i * 40);
+    b.info.satellites.inView[i].snr = 30 + (unsigned int) i;
+  }
+  nmeaInfoSetPresent(&b.info.present, NMEALIB_PRESENT_SATINVIEWCOUNT | NMEALIB_PRESENT_SATINVIEW);
+
+  nmeaRenderInit(&b.render);
+
+  benchHarnessSection(&harness, "all sentences of a fix (ns/fix)");
+  benchHarnessRun(&harness, "render/sentence-from-info", sentenceFromInfo, &b, 1);
+  if (benchHarnessRun(&harness, "render/render-from-info", renderFromInfo, &b, 1) //
+      && harness.table) {
+    printf("%-36s %zu reused, %zu rendered, %zu fields\n", "render cache", b.render.sentencesReused,
+        b.render.sentencesRendered, b.render.fieldsRendered);
+  }
+
+  free(b.buf.buffer);
+  benchHarnessFinish(&harness);
+  return 0;
+}
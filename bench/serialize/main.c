@@ -0,0 +1,166 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../harness.h"
+
+#include <nmealib/info.h>
+#include <nmealib/parser.h>
+#include <nmealib/sentence.h>
+#include <nmealib/serialize.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static volatile size_t sink;
+
+typedef struct _SerializeBench {
+    uint8_t            frame[NMEALIB_SERIALIZE_MAX_SIZE];
+    size_t             frameSize;
+    NmeaMallocedBuffer buf;
+    size_t             length;
+    unsigned int       sentences;
+    NmeaParser         parser;
+    NmeaInfo           info;
+    NmeaInfo           out;
+} SerializeBench;
+
+static void textEncode(void *arg, size_t iterations) {
+  SerializeBench *b = (SerializeBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sink = nmeaSentenceFromInfo(&b->buf, &b->info, b->sentences);
+  }
+}
+
+static void textDecode(void *arg, size_t iterations) {
+  SerializeBench *b = (SerializeBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sink = nmeaParserParse(&b->parser, b->buf.buffer, b->length, &b->out);
+  }
+}
+
+static void binaryEncode(void *arg, size_t iterations) {
+  SerializeBench *b = (SerializeBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sink = nmeaSerializeInfo(&b->info, b->frame, sizeof(b->frame));
+  }
+}
+
+static void binaryDecode(void *arg, size_t iterations) {
+  SerializeBench *b = (SerializeBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sink = nmeaDeserializeInfo(b->frame, sizeof(b->frame), &b->out);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  BenchHarness harness;
+  SerializeBench *b;
+  size_t i;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  b = calloc(1, sizeof(*b));
+  if (!b) {
+    fprintf(stderr, "out of memory\n");
+    benchHarnessFinish(&harness);
+    return 1;
+  }
+
+  b->sentences = NMEALIB_SENTENCE_GPGGA //
+      | NMEALIB_SENTENCE_GPGSA //
+      | NMEALIB_SENTENCE_GPGSV //
+      | NMEALIB_SENTENCE_GPRMC //
+      | NMEALIB_SENTENCE_GPVTG;
+  nmeaInfoClear(&b->info);
+  nmeaTimeSet(&b->info.utc, &b->info.present, NULL);
+
+  b->info.sig = NMEALIB_SIG_FIX;
+  b->info.fix = NMEALIB_FIX_3D;
+  b->info.latitude = 5000.1234;
+  b->info.longitude = 3600.5678;
+  b->info.speed = 7.704;
+  b->info.elevation = 10.86;
+  b->info.track = 45;
+  b->info.mtrack = 55;
+  b->info.magvar = 55;
+  b->info.hdop = 2.3;
+  b->info.vdop = 1.2;
+  b->info.pdop = 2.594224354;
+  nmeaInfoSetPresent(&b->info.present, NMEALIB_PRESENT_SIG | NMEALIB_PRESENT_FIX | NMEALIB_PRESENT_LAT
+      | NMEALIB_PRESENT_LON | NMEALIB_PRESENT_SPEED | NMEALIB_PRESENT_ELV | NMEALIB_PRESENT_TRACK
+      | NMEALIB_PRESENT_MTRACK | NMEALIB_PRESENT_MAGVAR | NMEALIB_PRESENT_HDOP | NMEALIB_PRESENT_VDOP
+      | NMEALIB_PRESENT_PDOP);
+
+  b->info.satellites.inUseCount = 8;
+  b->info.satellites.inViewCount = 12;
+  for (i = 0; i < b->info.satellites.inViewCount; i++) {
+    if (i < b->info.satellites.inUseCount) {
+      b->info.satellites.inUse[i] = (unsigned int) (i + 1);
+    }
+    b->info.satellites.inView[i].prn = (unsigned int) (i + 1);
+    b->info.satellites.inView[i].elevation = (int) ((i * 10) % 90);
+    b->info.satellites.inView[i].azimuth = (unsigned int) (i * 30);
+    b->info.satellites.inView[i].snr = 40 + (unsigned int) i;
+  }
+  nmeaInfoSetPresent(&b->info.present, NMEALIB_PRESENT_SATINUSECOUNT | NMEALIB_PRESENT_SATINUSE
+      | NMEALIB_PRESENT_SATINVIEWCOUNT | NMEALIB_PRESENT_SATINVIEW);
+
+  /* the encoded fix is the input of the decoders */
+  b->length = nmeaSentenceFromInfo(&b->buf, &b->info, b->sentences);
+  b->frameSize = nmeaSerializeInfo(&b->info, b->frame, sizeof(b->frame));
+  nmeaDeserializeInfo(b->frame, sizeof(b->frame), &b->out);
+  if (!b->length //
+      || !b->frameSize //
+      || memcmp(&b->out, &b->info, sizeof(b->info))) {
+    fprintf(stderr, "binary round trip mismatch\n");
+    free(b->buf.buffer);
+    free(b);
+    benchHarnessFinish(&harness);
+    return 1;
+  }
+
+  if (harness.table) {
+    printf("%lu bytes/fix as text, %lu bytes/fix as binary\n", (unsigned long) b->length,
+        (unsigned long) b->frameSize);
+  }
+
+  nmeaParserInit(&b->parser, 0);
+
+  benchHarnessSection(&harness, "text (ns/fix)");
+  benchHarnessRun(&harness, "serialize/text-encode", textEncode, b, 1);
+  benchHarnessRun(&harness, "serialize/text-decode", textDecode, b, 1);
+
+  benchHarnessSection(&harness, "binary (ns/fix)");
+  benchHarnessRun(&harness, "serialize/binary-encode", binaryEncode, b, 1);
+  benchHarnessRun(&harness, "serialize/binary-decode", binaryDecode, b, 1);
+
+  nmeaParserDestroy(&b->parser);
+  free(b->buf.buffer);
+  free(b);
+  benchHarnessFinish(&harness);
+  return 0;
+}
@@ -0,0 +1,254 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Compression ratio and speed of the track simplifier on an NMEA log and on a
+ * synthetic drive. The log is read from NMEALIB_BENCH_GPSLOG (default
+ * ../samples/parse_file/gpslog.txt, which only holds a handful of fixes,
+ * skipped when it can't be read).
+ */
+
+#include "../harness.h"
+
+#include <nmealib/geodesic.h>
+#include <nmealib/nmath.h>
+#include <nmealib/parser.h>
+#include <nmealib/random.h>
+#include <nmealib/record.h>
+#include <nmealib/simplify.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GPSLOG_DEFAULT "../samples/parse_file/gpslog.txt"
+#define DRIVE_RECORDS (36000u)
+
+static const double tolerances[] = {
+    0.5,
+    1.0,
+    2.0,
+    5.0,
+    10.0,
+    20.0 };
+
+static volatile size_t sinkCount;
+
+typedef struct _SimplifyBench {
+    const NmeaRecord *records;
+    size_t            count;
+    NmeaSimplifyMode  mode;
+    double            tolerance;
+    size_t            kept;
+} SimplifyBench;
+
+/**
+ * Parse a log into fix records, one per epoch with a position
+ *
+ * @return The number of records, 0 on failure
+ */
+static size_t load(const char *path, NmeaRecord **records) {
+  FILE *file = fopen(path, "rb");
+  NmeaParser parser;
+  NmeaInfo info;
+  NmeaRecord record;
+  NmeaRecord *r;
+  char buffer[4096];
+  size_t capacity = 0;
+  size_t count = 0;
+  size_t size;
+
+  *records = NULL;
+  if (!file) {
+    fprintf(stderr, "Skipping %s: could not open it\n", path);
+    return 0;
+  }
+
+  nmeaInfoClear(&info);
+  nmeaParserInit(&parser, 0);
+
+  while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    size_t offset;
+
+    /* sentence by sentence, since the parser only fills info with the last sentence of a chunk */
+    for (offset = 0; offset < size; offset++) {
+      if (!nmeaParserParse(&parser, &buffer[offset], 1, &info) //
+          || !nmeaRecordFromInfo(&info, &record) //
+          || !nmeaInfoIsPresentAll(record.present, NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON)) {
+        continue;
+      }
+
+      if (count //
+          && ((*records)[count - 1].time == record.time)) {
+        /* a later sentence of the same epoch */
+        (*records)[count - 1] = record;
+        continue;
+      }
+
+      if (count == capacity) {
+        capacity = capacity ?
+            (capacity * 2) :
+            1024;
+        r = realloc(*records, capacity * sizeof(*r));
+        if (!r) {
+          break;
+        }
+        *records = r;
+      }
+      (*records)[count++] = record;
+    }
+  }
+
+  nmeaParserDestroy(&parser);
+  fclose(file);
+  return count;
+}
+
+/**
+ * A one hour drive at 10 Hz and 50 kph: straight roads, turns and curves,
+ * with a GPS noise of up to 1.5 m
+ *
+ * @return The number of records, 0 on failure
+ */
+static size_t drive(NmeaRecord **records) {
+  NmeaGeodesicOrigin origin;
+  NmeaPosition position;
+  NmeaPosition noisy;
+  NmeaRandom random;
+  double heading = 1.0;
+  double turn = 0.0;
+  size_t i;
+
+  *records = malloc(DRIVE_RECORDS * sizeof(**records));
+  if (!*records) {
+    return 0;
+  }
+
+  nmeaRandomSeed(&random, 44);
+  position.lat = nmeaMathDegreeToRadian(52.1);
+  position.lon = nmeaMathDegreeToRadian(5.1);
+
+  for (i = 0; i < DRIVE_RECORDS; i++) {
+    NmeaRecord *record = &(*records)[i];
+
+    nmeaGeodesicOriginInit(&origin, &position);
+    nmeaGeodesicDirect(&origin, nmeaRandomDouble(&random, -NMEALIB_PI, NMEALIB_PI),
+        nmeaRandomDouble(&random, 0.0, 1.5), &noisy, NULL);
+
+    memset(record, 0, sizeof(*record));
+    record->time = (int64_t) i * 100000000;
+    record->present = NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON;
+    record->latitude = nmeaMathRadianToDegree(noisy.lat);
+    record->longitude = nmeaMathRadianToDegree(noisy.lon);
+
+    /* every 30 s a new stretch: straight (most), a curve or a turn */
+    if ((i % 300) == 0) {
+      double u = nmeaRandomDouble(&random, 0.0, 1.0);
+
+      turn = (u < 0.2) ?
+          nmeaRandomDouble(&random, -0.002, 0.002) :
+          0.0;
+      if (u > 0.8) {
+        heading += nmeaRandomDouble(&random, -1.6, 1.6);
+      }
+    }
+    heading += turn;
+    nmeaGeodesicDirect(&origin, heading, 50.0 / 36.0, &position, NULL);
+  }
+
+  return DRIVE_RECORDS;
+}
+
+/**
+ * Simplify all records
+ */
+static void simplify(void *arg, size_t iterations) {
+  SimplifyBench *b = (SimplifyBench *) arg;
+  size_t round;
+
+  for (round = 0; round < iterations; round++) {
+    NmeaSimplifier simplifier;
+    NmeaRecord kept;
+    size_t i;
+
+    nmeaSimplifierInit(&simplifier, b->mode, b->tolerance);
+    for (i = 0; i < b->count; i++) {
+      nmeaSimplifierAdd(&simplifier, &b->records[i], &kept);
+    }
+    nmeaSimplifierFlush(&simplifier, &kept);
+    b->kept = simplifier.kept;
+    sinkCount = simplifier.kept;
+  }
+}
+
+static void run(BenchHarness *harness, const char *name, const NmeaRecord *records, size_t count) {
+  SimplifyBench b;
+  char benchmark[64];
+  size_t m;
+  size_t t;
+
+  snprintf(benchmark, sizeof(benchmark), "%s, %lu fixes (ns/record)", name, (unsigned long) count);
+  benchHarnessSection(harness, benchmark);
+
+  b.records = records;
+  b.count = count;
+  for (m = 0; m < 2; m++) {
+    b.mode = m ?
+        NMEALIB_SIMPLIFY_ELLIPSOIDAL :
+        NMEALIB_SIMPLIFY_SPHERICAL;
+
+    for (t = 0; t < (sizeof(tolerances) / sizeof(tolerances[0])); t++) {
+      b.tolerance = tolerances[t];
+      snprintf(benchmark, sizeof(benchmark), "simplify/%s-%s-%gm", name, m ?
+          "ellipsoidal" :
+          "spherical", tolerances[t]);
+      if (benchHarnessRun(harness, benchmark, simplify, &b, count) //
+          && harness->table) {
+        printf("%-36s %12lu kept %8.1fx\n", "", (unsigned long) b.kept, (double) count / (double) b.kept);
+      }
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  BenchHarness harness;
+  const char *gpslog = getenv("NMEALIB_BENCH_GPSLOG");
+  NmeaRecord *records;
+  size_t count;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  if (!gpslog) {
+    gpslog = GPSLOG_DEFAULT;
+  }
+
+  count = load(gpslog, &records);
+  if (count) {
+    run(&harness, "gpslog", records, count);
+  }
+  free(records);
+
+  count = drive(&records);
+  if (count) {
+    run(&harness, "drive", records, count);
+  }
+  free(records);
+
+  benchHarnessFinish(&harness);
+  return 0;
+}
@@ -0,0 +1,272 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../harness.h"
+
+#include <nmealib/nmath.h>
+#include <nmealib/random.h>
+#include <nmealib/spatial.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define UNITS (100000u)
+#define QUERIES (1000u)
+#define SCAN_QUERIES (50u)
+#define RADIUS (5000.0)
+#define K (10u)
+
+static volatile size_t sinkCount;
+
+typedef struct _SpatialBench {
+    NmeaSpatial       *index;
+    NmeaPosition      *positions;
+    NmeaPosition      *moved;
+    NmeaPosition      *centers;
+    NmeaSpatialResult *results;
+    uint64_t          *ids;
+    size_t             round;
+    size_t             k;
+} SpatialBench;
+
+/**
+ * A position in a 300 x 300 km region around Utrecht
+ */
+static void randomPosition(NmeaRandom *random, NmeaPosition *position) {
+  position->lat = nmeaMathDegreeToRadian(52.1 + nmeaRandomDouble(random, -1.35, 1.35));
+  position->lon = nmeaMathDegreeToRadian(5.1 + nmeaRandomDouble(random, -2.2, 2.2));
+}
+
+static size_t radiusScan(const SpatialBench *b, size_t q) {
+  size_t count = 0;
+  size_t i;
+
+  for (i = 0; i < UNITS; i++) {
+    if (nmeaMathDistance(&b->centers[q], &b->moved[i]) <= RADIUS) {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+static void spatialInsert(void *arg, size_t iterations) {
+  SpatialBench *b = (SpatialBench *) arg;
+  size_t round;
+  size_t i;
+
+  for (round = 0; round < iterations; round++) {
+    NmeaSpatial *index = nmeaSpatialCreate(RADIUS);
+
+    for (i = 0; i < UNITS; i++) {
+      nmeaSpatialUpdate(index, i, &b->positions[i]);
+    }
+    nmeaSpatialDestroy(index);
+  }
+}
+
+/**
+ * Move all units back and forth
+ */
+static void spatialMove(void *arg, size_t iterations) {
+  SpatialBench *b = (SpatialBench *) arg;
+  size_t round;
+  size_t i;
+
+  for (round = 0; round < iterations; round++, b->round++) {
+    const NmeaPosition *positions = (b->round & 1) ?
+        b->positions :
+        b->moved;
+
+    for (i = 0; i < UNITS; i++) {
+      nmeaSpatialUpdate(b->index, i, &positions[i]);
+    }
+  }
+}
+
+static void spatialRadiusScan(void *arg, size_t iterations) {
+  SpatialBench *b = (SpatialBench *) arg;
+  size_t q;
+
+  for (q = 0; q < iterations; q++) {
+    sinkCount = radiusScan(b, q % SCAN_QUERIES);
+  }
+}
+
+static void spatialRadius(void *arg, size_t iterations) {
+  SpatialBench *b = (SpatialBench *) arg;
+  size_t q;
+
+  for (q = 0; q < iterations; q++) {
+    sinkCount = nmeaSpatialRadius(b->index, &b->centers[q % QUERIES], RADIUS, b->results, UNITS);
+  }
+}
+
+static void spatialNearestScan(void *arg, size_t iterations) {
+  SpatialBench *b = (SpatialBench *) arg;
+  size_t q;
+  size_t i;
+
+  for (q = 0; q < iterations; q++) {
+    const NmeaPosition *center = &b->centers[q % SCAN_QUERIES];
+    double best = INFINITY;
+
+    for (i = 0; i < UNITS; i++) {
+      double d = nmeaMathDistance(center, &b->moved[i]);
+
+      if (d < best) {
+        best = d;
+        sinkCount = i;
+      }
+    }
+  }
+}
+
+static void spatialNearest(void *arg, size_t iterations) {
+  SpatialBench *b = (SpatialBench *) arg;
+  size_t q;
+
+  for (q = 0; q < iterations; q++) {
+    sinkCount = nmeaSpatialNearest(b->index, &b->centers[q % QUERIES], b->results, b->k);
+  }
+}
+
+static void spatialBox(void *arg, size_t iterations) {
+  SpatialBench *b = (SpatialBench *) arg;
+  size_t q;
+
+  for (q = 0; q < iterations; q++) {
+    NmeaPosition southWest = b->centers[q % QUERIES];
+    NmeaPosition northEast = b->centers[q % QUERIES];
+
+    southWest.lat -= 1E-3;
+    southWest.lon -= 2E-3;
+    northEast.lat += 1E-3;
+    northEast.lon += 2E-3;
+    sinkCount = nmeaSpatialBox(b->index, &southWest, &northEast, b->ids, UNITS);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  BenchHarness harness;
+  SpatialBench b;
+  NmeaRandom random;
+  size_t q;
+  size_t i;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  b.positions = malloc(UNITS * sizeof(*b.positions));
+  b.moved = malloc(UNITS * sizeof(*b.moved));
+  b.centers = malloc(QUERIES * sizeof(*b.centers));
+  b.results = malloc(UNITS * sizeof(*b.results));
+  b.ids = malloc(UNITS * sizeof(*b.ids));
+  b.index = nmeaSpatialCreate(RADIUS);
+  b.round = 0;
+  if (!b.positions //
+      || !b.moved //
+      || !b.centers //
+      || !b.results //
+      || !b.ids //
+      || !b.index) {
+    fprintf(stderr, "out of memory\n");
+    free(b.positions);
+    free(b.moved);
+    free(b.centers);
+    free(b.results);
+    free(b.ids);
+    nmeaSpatialDestroy(b.index);
+    benchHarnessFinish(&harness);
+    return 1;
+  }
+
+  nmeaRandomSeed(&random, 42);
+  for (i = 0; i < UNITS; i++) {
+    randomPosition(&random, &b.positions[i]);
+  }
+  for (q = 0; q < QUERIES; q++) {
+    randomPosition(&random, &b.centers[q]);
+  }
+  for (i = 0; i < UNITS; i++) {
+    b.moved[i].lat = b.positions[i].lat + nmeaRandomDouble(&random, -1E-5, 1E-5);
+    b.moved[i].lon = b.positions[i].lon + nmeaRandomDouble(&random, -1E-5, 1E-5);
+  }
+
+  if (harness.table) {
+    printf("%u units, %u queries, cell size %.0f m\n", UNITS, QUERIES, RADIUS);
+  }
+
+  /* updates */
+
+  benchHarnessSection(&harness, "updates (ns/update)");
+  benchHarnessRun(&harness, "spatial/insert", spatialInsert, &b, UNITS);
+  for (i = 0; i < UNITS; i++) {
+    nmeaSpatialUpdate(b.index, i, &b.positions[i]);
+  }
+  benchHarnessRun(&harness, "spatial/move-60m", spatialMove, &b, UNITS);
+
+  /* the queries find the moved units */
+  for (i = 0; i < UNITS; i++) {
+    nmeaSpatialUpdate(b.index, i, &b.moved[i]);
+  }
+
+  /* radius */
+
+  benchHarnessSection(&harness, "radius, 5 km (ns/query)");
+  benchHarnessRun(&harness, "spatial/radius-scan", spatialRadiusScan, &b, 1);
+  if (benchHarnessRun(&harness, "spatial/radius", spatialRadius, &b, 1) //
+      && harness.table) {
+    size_t matches = 0;
+    size_t mismatches = 0;
+
+    for (q = 0; q < QUERIES; q++) {
+      matches += nmeaSpatialRadius(b.index, &b.centers[q], RADIUS, NULL, 0);
+    }
+    for (q = 0; q < SCAN_QUERIES; q++) {
+      if (radiusScan(&b, q) != nmeaSpatialRadius(b.index, &b.centers[q], RADIUS, NULL, 0)) {
+        mismatches++;
+      }
+    }
+    printf("%-36s %12.1f units/query, %lu count mismatches\n", "", (double) matches / QUERIES,
+        (unsigned long) mismatches);
+  }
+
+  /* k nearest */
+
+  benchHarnessSection(&harness, "nearest (ns/query)");
+  benchHarnessRun(&harness, "spatial/nearest-scan", spatialNearestScan, &b, 1);
+  b.k = 1;
+  benchHarnessRun(&harness, "spatial/nearest-1", spatialNearest, &b, 1);
+  b.k = K;
+  benchHarnessRun(&harness, "spatial/nearest-10", spatialNearest, &b, 1);
+
+  /* box */
+
+  benchHarnessSection(&harness, "box, ~13 x 13 km (ns/query)");
+  benchHarnessRun(&harness, "spatial/box", spatialBox, &b, 1);
+
+  nmeaSpatialDestroy(b.index);
+  free(b.positions);
+  free(b.moved);
+  free(b.centers);
+  free(b.results);
+  free(b.ids);
+  benchHarnessFinish(&harness);
+  return 0;
+}
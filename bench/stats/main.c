@@ -0,0 +1,160 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Update and merge speed of the running fix statistics, on a synthetic
+ * static receiver at 10 Hz with 12 satellites in view.
+ */
+
+#include "../harness.h"
+
+#include <nmealib/info.h>
+#include <nmealib/nmath.h>
+#include <nmealib/random.h>
+#include <nmealib/stats.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EPOCHS (10000u)
+#define SHARDS (1024u)
+
+static volatile double sinkValue;
+
+typedef struct _StatsBench {
+    NmeaInfo  *infos;
+    NmeaStats *shards;
+    NmeaStats  stats;
+} StatsBench;
+
+static void epoch(NmeaRandom *random, NmeaInfo *info, size_t i) {
+  size_t s;
+
+  memset(info, 0, sizeof(*info));
+  info->utc.year = 2020;
+  info->utc.mon = 1;
+  info->utc.day = 1;
+  info->utc.hour = (unsigned int) (i / 36000);
+  info->utc.min = (unsigned int) ((i / 600) % 60);
+  info->utc.sec = (unsigned int) ((i / 10) % 60);
+  info->utc.hsec = (unsigned int) ((i % 10) * 10);
+  info->sig = NMEALIB_SIG_FIX;
+  info->fix = NMEALIB_FIX_3D;
+  info->latitude = nmeaMathDegreeToNdeg(52.0 + nmeaRandomDouble(random, -2E-5, 2E-5));
+  info->longitude = nmeaMathDegreeToNdeg(5.0 + nmeaRandomDouble(random, -3E-5, 3E-5));
+  info->elevation = nmeaRandomDouble(random, 5.0, 15.0);
+  info->pdop = nmeaRandomDouble(random, 1.2, 4.0);
+  info->hdop = nmeaRandomDouble(random, 0.6, 2.5);
+  info->vdop = nmeaRandomDouble(random, 1.0, 3.0);
+  for (s = 0; s < 12; s++) {
+    info->satellites.inView[s].prn = (unsigned int) (s + 1);
+    info->satellites.inView[s].snr = 15 + (unsigned int) (nmeaRandomNext(random) % 36);
+  }
+  info->present = NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_SIG | NMEALIB_PRESENT_FIX
+      | NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON | NMEALIB_PRESENT_ELV | NMEALIB_PRESENT_PDOP | NMEALIB_PRESENT_HDOP
+      | NMEALIB_PRESENT_VDOP | NMEALIB_PRESENT_SATINVIEW;
+}
+
+static void statsUpdate(void *arg, size_t iterations) {
+  StatsBench *b = (StatsBench *) arg;
+  size_t round;
+  size_t i;
+
+  for (round = 0; round < iterations; round++) {
+    nmeaStatsClear(&b->stats);
+    for (i = 0; i < EPOCHS; i++) {
+      nmeaStatsAddInfo(&b->stats, &b->infos[i]);
+    }
+    nmeaStatsFlush(&b->stats);
+    sinkValue = b->stats.east;
+  }
+}
+
+static void statsMerge(void *arg, size_t iterations) {
+  StatsBench *b = (StatsBench *) arg;
+  size_t round;
+  size_t i;
+
+  for (round = 0; round < iterations; round++) {
+    nmeaStatsClear(&b->stats);
+    for (i = 0; i < SHARDS; i++) {
+      nmeaStatsMerge(&b->stats, &b->shards[i]);
+    }
+    sinkValue = b->stats.east;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  BenchHarness harness;
+  NmeaRandom random;
+  StatsBench b;
+  size_t i;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  b.infos = malloc(EPOCHS * sizeof(*b.infos));
+  b.shards = malloc(SHARDS * sizeof(*b.shards));
+  if (!b.infos //
+      || !b.shards) {
+    fprintf(stderr, "out of memory\n");
+    free(b.infos);
+    free(b.shards);
+    benchHarnessFinish(&harness);
+    return 1;
+  }
+
+  nmeaRandomSeed(&random, 45);
+  for (i = 0; i < EPOCHS; i++) {
+    epoch(&random, &b.infos[i], i);
+  }
+
+  /* updates */
+
+  benchHarnessSection(&harness, "updates (ns/epoch)");
+  if (benchHarnessRun(&harness, "stats/update", statsUpdate, &b, EPOCHS) //
+      && harness.table) {
+    printf("%u epochs: fix rate %.3f, %.1f Hz, CEP %.2f m, 2DRMS %.2f m\n", EPOCHS, nmeaStatsFixRate(&b.stats),
+        nmeaStatsEpochRate(&b.stats), nmeaStatsCep(&b.stats), nmeaStatsDrms2(&b.stats));
+    printf("  HDOP p50 %.2f p95 %.2f, SNR p5 %.1f p50 %.1f\n", nmeaSketchQuantile(&b.stats.hdop, 0.5),
+        nmeaSketchQuantile(&b.stats.hdop, 0.95), nmeaSketchQuantile(&b.stats.snr, 0.05),
+        nmeaSketchQuantile(&b.stats.snr, 0.5));
+  }
+
+  /* merges, of shards of EPOCHS / SHARDS epochs each */
+
+  for (i = 0; i < SHARDS; i++) {
+    size_t e;
+
+    nmeaStatsClear(&b.shards[i]);
+    for (e = i; e < EPOCHS; e += SHARDS) {
+      nmeaStatsAddInfo(&b.shards[i], &b.infos[e]);
+    }
+  }
+
+  benchHarnessSection(&harness, "merges (ns/shard)");
+  if (benchHarnessRun(&harness, "stats/merge", statsMerge, &b, SHARDS) //
+      && harness.table) {
+    printf("%u shards: CEP %.2f m\n", SHARDS, nmeaStatsCep(&b.stats));
+  }
+
+  free(b.shards);
+  free(b.infos);
+  benchHarnessFinish(&harness);
+  return 0;
+}
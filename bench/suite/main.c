@@ -0,0 +1,599 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The benchmark suite: parsing and generation of every sentence type, parser
+ * throughput on the sample log and on generated corpora with increasing
+ * garbage ratios, the scanner and string converters, the distance and move
+ * functions, and the generators. See harness.h for the options and the JSON
+ * output. The sample log is read from NMEALIB_BENCH_GPSLOG (default
+ * ../samples/parse_file/gpslog.txt, skipped when it can't be read).
+ */
+
+#include "../harness.h"
+
+#include <nmealib/corpus.h>
+#include <nmealib/generator.h>
+#include <nmealib/gpgga.h>
+#include <nmealib/gpgsa.h>
+#include <nmealib/gpgsv.h>
+#include <nmealib/gprmc.h>
+#include <nmealib/gpvtg.h>
+#include <nmealib/info.h>
+#include <nmealib/nmath.h>
+#include <nmealib/parser.h>
+#include <nmealib/util.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GPSLOG_DEFAULT "../samples/parse_file/gpslog.txt"
+#define GPSLOG_MAX (1024u * 1024u)
+#define CORPUS_FIXES (2000u)
+#define SENTENCE_SIZE (NMEALIB_BUFFER_CHUNK_SIZE)
+
+static volatile size_t sinkSize;
+static volatile double sinkDouble;
+static volatile long sinkLong;
+
+/*
+ * Sentences
+ */
+
+typedef struct _SentenceBench {
+    const NmeaInfo *info;
+    char            s[SENTENCE_SIZE];
+    size_t          sz;
+} SentenceBench;
+
+static void parseGPGGA(void *arg, size_t iterations) {
+  SentenceBench *b = (SentenceBench *) arg;
+  NmeaGPGGA pack;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sinkSize = nmeaGPGGAParse(b->s, b->sz, &pack);
+  }
+}
+
+static void parseGPGSA(void *arg, size_t iterations) {
+  SentenceBench *b = (SentenceBench *) arg;
+  NmeaGPGSA pack;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sinkSize = nmeaGPGSAParse(b->s, b->sz, &pack);
+  }
+}
+
+static void parseGPGSV(void *arg, size_t iterations) {
+  SentenceBench *b = (SentenceBench *) arg;
+  NmeaGPGSV pack;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sinkSize = nmeaGPGSVParse(b->s, b->sz, &pack);
+  }
+}
+
+static void parseGPRMC(void *arg, size_t iterations) {
+  SentenceBench *b = (SentenceBench *) arg;
+  NmeaGPRMC pack;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sinkSize = nmeaGPRMCParse(b->s, b->sz, &pack);
+  }
+}
+
+static void parseGPVTG(void *arg, size_t iterations) {
+  SentenceBench *b = (SentenceBench *) arg;
+  NmeaGPVTG pack;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sinkSize = nmeaGPVTGParse(b->s, b->sz, &pack);
+  }
+}
+
+static void generateGPGGA(void *arg, size_t iterations) {
+  SentenceBench *b = (SentenceBench *) arg;
+  char s[SENTENCE_SIZE];
+  NmeaGPGGA pack;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    nmeaGPGGAFromInfo(b->info, &pack);
+    sinkSize = nmeaGPGGAGenerate(s, sizeof(s), &pack);
+  }
+}
+
+static void generateGPGSA(void *arg, size_t iterations) {
+  SentenceBench *b = (SentenceBench *) arg;
+  char s[SENTENCE_SIZE];
+  NmeaGPGSA pack;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    nmeaGPGSAFromInfo(b->info, &pack);
+    sinkSize = nmeaGPGSAGenerate(s, sizeof(s), &pack);
+  }
+}
+
+static void generateGPGSV(void *arg, size_t iterations) {
+  SentenceBench *b = (SentenceBench *) arg;
+  char s[SENTENCE_SIZE];
+  NmeaGPGSV pack;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    nmeaGPGSVFromInfo(b->info, &pack, 0);
+    sinkSize = nmeaGPGSVGenerate(s, sizeof(s), &pack);
+  }
+}
+
+static void generateGPRMC(void *arg, size_t iterations) {
+  SentenceBench *b = (SentenceBench *) arg;
+  char s[SENTENCE_SIZE];
+  NmeaGPRMC pack;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    nmeaGPRMCFromInfo(b->info, &pack);
+    sinkSize = nmeaGPRMCGenerate(s, sizeof(s), &pack);
+  }
+}
+
+static void generateGPVTG(void *arg, size_t iterations) {
+  SentenceBench *b = (SentenceBench *) arg;
+  char s[SENTENCE_SIZE];
+  NmeaGPVTG pack;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    nmeaGPVTGFromInfo(b->info, &pack);
+    sinkSize = nmeaGPVTGGenerate(s, sizeof(s), &pack);
+  }
+}
+
+typedef struct _SentenceType {
+    const char   *name;
+    BenchFunction parse;
+    BenchFunction generate;
+    size_t (*render)(char *s, const NmeaInfo *info);
+} SentenceType;
+
+static size_t renderGPGGA(char *s, const NmeaInfo *info) {
+  NmeaGPGGA pack;
+
+  nmeaGPGGAFromInfo(info, &pack);
+  return nmeaGPGGAGenerate(s, SENTENCE_SIZE, &pack);
+}
+
+static size_t renderGPGSA(char *s, const NmeaInfo *info) {
+  NmeaGPGSA pack;
+
+  nmeaGPGSAFromInfo(info, &pack);
+  return nmeaGPGSAGenerate(s, SENTENCE_SIZE, &pack);
+}
+
+static size_t renderGPGSV(char *s, const NmeaInfo *info) {
+  NmeaGPGSV pack;
+
+  nmeaGPGSVFromInfo(info, &pack, 0);
+  return nmeaGPGSVGenerate(s, SENTENCE_SIZE, &pack);
+}
+
+static size_t renderGPRMC(char *s, const NmeaInfo *info) {
+  NmeaGPRMC pack;
+
+  nmeaGPRMCFromInfo(info, &pack);
+  return nmeaGPRMCGenerate(s, SENTENCE_SIZE, &pack);
+}
+
+static size_t renderGPVTG(char *s, const NmeaInfo *info) {
+  NmeaGPVTG pack;
+
+  nmeaGPVTGFromInfo(info, &pack);
+  return nmeaGPVTGGenerate(s, SENTENCE_SIZE, &pack);
+}
+
+static const SentenceType sentenceTypes[] = {
+    { "GPGGA", parseGPGGA, generateGPGGA, renderGPGGA },
+    { "GPGSA", parseGPGSA, generateGPGSA, renderGPGSA },
+    { "GPGSV", parseGPGSV, generateGPGSV, renderGPGSV },
+    { "GPRMC", parseGPRMC, generateGPRMC, renderGPRMC },
+    { "GPVTG", parseGPVTG, generateGPVTG, renderGPVTG } };
+
+static void benchSentences(BenchHarness *harness, const NmeaInfo *info) {
+  SentenceBench b;
+  char name[64];
+  size_t i;
+
+  benchHarnessSection(harness, "sentences (ns/sentence)");
+
+  for (i = 0; i < (sizeof(sentenceTypes) / sizeof(sentenceTypes[0])); i++) {
+    const SentenceType *type = &sentenceTypes[i];
+
+    memset(&b, 0, sizeof(b));
+    b.info = info;
+    b.sz = type->render(b.s, info);
+
+    snprintf(name, sizeof(name), "parse/%s", type->name);
+    benchHarnessRun(harness, name, type->parse, &b, 1);
+    snprintf(name, sizeof(name), "generate/%s", type->name);
+    benchHarnessRun(harness, name, type->generate, &b, 1);
+  }
+}
+
+/*
+ * Parser
+ */
+
+typedef struct _ParserBench {
+    NmeaParser  parser;
+    NmeaInfo    info;
+    const char *s;
+    size_t      sz;
+} ParserBench;
+
+static void parserParse(void *arg, size_t iterations) {
+  ParserBench *b = (ParserBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sinkSize = nmeaParserParse(&b->parser, b->s, b->sz, &b->info);
+  }
+}
+
+static void benchParserRun(BenchHarness *harness, const char *name, const char *s, size_t sz) {
+  ParserBench b;
+
+  memset(&b, 0, sizeof(b));
+  if (!nmeaParserInit(&b.parser, 0)) {
+    return;
+  }
+
+  b.s = s;
+  b.sz = sz;
+  benchHarnessRun(harness, name, parserParse, &b, sz);
+  nmeaParserDestroy(&b.parser);
+}
+
+static size_t readFile(const char *path, char *buf, size_t sz) {
+  FILE *f = fopen(path, "rb");
+  size_t length;
+
+  if (!f) {
+    return 0;
+  }
+
+  length = fread(buf, 1, sz, f);
+  fclose(f);
+  return length;
+}
+
+static void benchParser(BenchHarness *harness) {
+  static const double garbage[] = {
+      0.0,
+      0.01,
+      0.1,
+      0.5 };
+  const char *gpslog = getenv("NMEALIB_BENCH_GPSLOG");
+  char *log = malloc(GPSLOG_MAX);
+  char name[64];
+  size_t length;
+  size_t i;
+
+  benchHarnessSection(harness, "parser (ns/byte)");
+
+  if (!gpslog) {
+    gpslog = GPSLOG_DEFAULT;
+  }
+
+  length = log ?
+      readFile(gpslog, log, GPSLOG_MAX) :
+      0;
+  if (length) {
+    benchParserRun(harness, "parser/gpslog", log, length);
+  } else {
+    fprintf(stderr, "Skipping parser/gpslog: could not read '%s'\n", gpslog);
+  }
+  free(log);
+
+  for (i = 0; i < (sizeof(garbage) / sizeof(garbage[0])); i++) {
+    NmeaCorpusConfig config;
+    NmeaMallocedBuffer buf;
+
+    memset(&config, 0, sizeof(config));
+    config.type = NMEALIB_GENERATOR_ROTATE;
+    config.mask = NMEALIB_SENTENCE_MASK;
+    config.seed = 1;
+    nmeaCorpusConfigGarbage(&config, garbage[i]);
+
+    memset(&buf, 0, sizeof(buf));
+    length = nmeaCorpusGenerate(&config, CORPUS_FIXES, &buf, NULL);
+    if (length) {
+      snprintf(name, sizeof(name), "parser/corpus-garbage-%02u", (unsigned int) (garbage[i] * 100.0));
+      benchParserRun(harness, name, buf.buffer, length);
+    }
+    free(buf.buffer);
+  }
+}
+
+/*
+ * Scanner and converters
+ */
+
+typedef struct _StringBench {
+    const char *s;
+    size_t      sz;
+} StringBench;
+
+static void stringScanf(void *arg, size_t iterations) {
+  StringBench *b = (StringBench *) arg;
+  char timeBuf[16];
+  double latitude;
+  char ns;
+  int quality;
+  unsigned int satellites;
+  float hdop;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sinkSize = nmeaScanf(b->s, b->sz, "$GPGGA,%16s,%F,%C,%d,%u,%f*", timeBuf, &latitude, &ns, &quality, &satellites,
+        &hdop);
+  }
+}
+
+static void stringToInteger(void *arg, size_t iterations) {
+  StringBench *b = (StringBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sinkLong = nmeaStringToInteger(b->s, b->sz, 10);
+  }
+}
+
+static void stringToUnsignedInteger(void *arg, size_t iterations) {
+  StringBench *b = (StringBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sinkLong = nmeaStringToUnsignedInteger(b->s, b->sz, 16);
+  }
+}
+
+static void stringToLong(void *arg, size_t iterations) {
+  StringBench *b = (StringBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sinkLong = nmeaStringToLong(b->s, b->sz, 10);
+  }
+}
+
+static void stringToDouble(void *arg, size_t iterations) {
+  StringBench *b = (StringBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sinkDouble = nmeaStringToDouble(b->s, b->sz);
+  }
+}
+
+static void calculateCRC(void *arg, size_t iterations) {
+  StringBench *b = (StringBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sinkLong = nmeaCalculateCRC(b->s, b->sz);
+  }
+}
+
+static void benchStrings(BenchHarness *harness) {
+  static const char *gga = "$GPGGA,111609.14,5001.27,N,3613.06,E,3,08,0.0,10.2,M,0.0,M,0.0,0000*70";
+  StringBench b;
+
+  benchHarnessSection(harness, "scanner and converters (ns/call)");
+
+  b.s = gga;
+  b.sz = strlen(gga);
+  benchHarnessRun(harness, "string/scanf", stringScanf, &b, 1);
+  b.s = gga + 1;
+  b.sz = strlen(gga) - 4;
+  benchHarnessRun(harness, "string/crc", calculateCRC, &b, 1);
+
+  b.s = "-1234567";
+  b.sz = strlen(b.s);
+  benchHarnessRun(harness, "string/integer", stringToInteger, &b, 1);
+  b.s = "7f3a";
+  b.sz = strlen(b.s);
+  benchHarnessRun(harness, "string/unsigned-integer-hex", stringToUnsignedInteger, &b, 1);
+  b.s = "1234567890";
+  b.sz = strlen(b.s);
+  benchHarnessRun(harness, "string/long", stringToLong, &b, 1);
+  b.s = "5001.2743";
+  b.sz = strlen(b.s);
+  benchHarnessRun(harness, "string/double", stringToDouble, &b, 1);
+}
+
+/*
+ * Math
+ */
+
+#define MATH_POSITIONS (64u)
+
+typedef struct _MathBench {
+    NmeaPosition positions[MATH_POSITIONS];
+} MathBench;
+
+static void mathDistance(void *arg, size_t iterations) {
+  MathBench *b = (MathBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    size_t j = i % (MATH_POSITIONS - 1);
+
+    sinkDouble = nmeaMathDistance(&b->positions[j], &b->positions[j + 1]);
+  }
+}
+
+static void mathDistanceEllipsoid(void *arg, size_t iterations) {
+  MathBench *b = (MathBench *) arg;
+  double fromAzimuth;
+  double toAzimuth;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    size_t j = i % (MATH_POSITIONS - 1);
+
+    sinkDouble = nmeaMathDistanceEllipsoid(&b->positions[j], &b->positions[j + 1], &fromAzimuth, &toAzimuth);
+  }
+}
+
+static void mathMoveFlat(void *arg, size_t iterations) {
+  MathBench *b = (MathBench *) arg;
+  NmeaPosition to;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    nmeaMathMoveFlat(&b->positions[i % MATH_POSITIONS], &to, (double) (i % 360u) * NMEALIB_DEGREE_TO_RADIAN, 1000.0);
+    sinkDouble = to.lat;
+  }
+}
+
+static void mathMoveFlatFast(void *arg, size_t iterations) {
+  MathBench *b = (MathBench *) arg;
+  NmeaPosition to;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    nmeaMathMoveFlatMode(&b->positions[i % MATH_POSITIONS], &to, (double) (i % 360u) * NMEALIB_DEGREE_TO_RADIAN, 1000.0,
+        NMEALIB_MATH_FAST);
+    sinkDouble = to.lat;
+  }
+}
+
+static void mathMoveFlatEllipsoid(void *arg, size_t iterations) {
+  MathBench *b = (MathBench *) arg;
+  NmeaPosition to;
+  double toAzimuth;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    nmeaMathMoveFlatEllipsoid(&b->positions[i % MATH_POSITIONS], &to, (double) (i % 360u) * NMEALIB_DEGREE_TO_RADIAN, 1000.0,
+        &toAzimuth);
+    sinkDouble = to.lat;
+  }
+}
+
+static void benchMath(BenchHarness *harness) {
+  MathBench b;
+  size_t i;
+
+  benchHarnessSection(harness, "math (ns/call)");
+
+  for (i = 0; i < MATH_POSITIONS; i++) {
+    b.positions[i].lat = nmeaMathDegreeToRadian(-60.0 + (120.0 * (double) i / MATH_POSITIONS));
+    b.positions[i].lon = nmeaMathDegreeToRadian(-170.0 + (5.3 * (double) i));
+  }
+
+  benchHarnessRun(harness, "math/distance", mathDistance, &b, 1);
+  benchHarnessRun(harness, "math/distance-ellipsoid", mathDistanceEllipsoid, &b, 1);
+  benchHarnessRun(harness, "math/move-flat", mathMoveFlat, &b, 1);
+  benchHarnessRun(harness, "math/move-flat-fast", mathMoveFlatFast, &b, 1);
+  benchHarnessRun(harness, "math/move-flat-ellipsoid", mathMoveFlatEllipsoid, &b, 1);
+}
+
+/*
+ * Generators
+ */
+
+typedef struct _GeneratorBench {
+    NmeaGenerator *gen;
+    NmeaInfo       info;
+} GeneratorBench;
+
+static void generatorInvoke(void *arg, size_t iterations) {
+  GeneratorBench *b = (GeneratorBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sinkSize = nmeaGeneratorInvoke(b->gen, &b->info);
+  }
+}
+
+static void benchGenerators(BenchHarness *harness) {
+  static const struct {
+      const char *name;
+      NmeaGeneratorType type;
+  } generators[] = {
+      { "generator/noise", NMEALIB_GENERATOR_NOISE },
+      { "generator/static", NMEALIB_GENERATOR_STATIC },
+      { "generator/rotate", NMEALIB_GENERATOR_ROTATE },
+      { "generator/sat-static", NMEALIB_GENERATOR_SAT_STATIC },
+      { "generator/sat-rotate", NMEALIB_GENERATOR_SAT_ROTATE },
+      { "generator/pos-randmove", NMEALIB_GENERATOR_POS_RANDMOVE } };
+  size_t i;
+
+  benchHarnessSection(harness, "generators (ns/invocation)");
+
+  for (i = 0; i < (sizeof(generators) / sizeof(generators[0])); i++) {
+    GeneratorBench b;
+
+    memset(&b, 0, sizeof(b));
+    nmeaInfoClear(&b.info);
+    b.gen = nmeaGeneratorCreate(generators[i].type, &b.info);
+    if (!b.gen) {
+      continue;
+    }
+
+    benchHarnessRun(harness, generators[i].name, generatorInvoke, &b, 1);
+    nmeaGeneratorDestroy(b.gen);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  BenchHarness harness;
+  NmeaGenerator *gen;
+  NmeaInfo info;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  /* a fix with all fields and satellites, for the sentence benchmarks */
+  memset(&info, 0, sizeof(info));
+  nmeaInfoClear(&info);
+  gen = nmeaGeneratorCreate(NMEALIB_GENERATOR_ROTATE, &info);
+  if (!gen //
+      || !nmeaGeneratorInvoke(gen, &info)) {
+    fprintf(stderr, "Could not generate a fix\n");
+    benchHarnessFinish(&harness);
+    return 1;
+  }
+  nmeaGeneratorDestroy(gen);
+
+  benchSentences(&harness, &info);
+  benchParser(&harness);
+  benchStrings(&harness);
+  benchMath(&harness);
+  benchGenerators(&harness);
+
+  benchHarnessFinish(&harness);
+  return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Speed of the invalid character and checksum validation of whole sentences,
+ * against byte by byte loops.
+ */
+
+#include "../harness.h"
+
+#include <nmealib/util.h>
+#include <nmealib/validate.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SENTENCES (sizeof(sentences) / sizeof(sentences[0]))
+
+static const char *sentences[] = {
+    "GPGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,", //
+    "GPRMC,092750.000,A,5321.6802,N,00630.3372,W,0.02,31.66,280511,,,A", //
+    "GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30", //
+    "GPGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38" };
+
+static const NmeaInvalidCharacter * volatile sinkInvalid;
+static volatile unsigned int sink;
+
+static size_t lengths[SENTENCES];
+
+static const NmeaInvalidCharacter *scalarInvalid(const char *s, size_t sz) {
+  size_t i;
+
+  for (i = 0; i < sz; i++) {
+    const NmeaInvalidCharacter *invalid = nmeaValidateIsInvalidCharacter(s[i]);
+    if (invalid) {
+      return invalid;
+    }
+  }
+
+  return NULL;
+}
+
+static unsigned int scalarCRC(const char *s, size_t sz) {
+  unsigned int crc = 0;
+  size_t i;
+
+  for (i = 0; i < sz; i++) {
+    crc ^= (unsigned char) s[i];
+  }
+
+  return crc;
+}
+
+static void invalidScalar(void *arg __attribute__((unused)), size_t iterations) {
+  size_t repeat;
+  size_t i;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    for (i = 0; i < SENTENCES; i++) {
+      sinkInvalid = scalarInvalid(sentences[i], lengths[i]);
+    }
+  }
+}
+
+static void invalid(void *arg __attribute__((unused)), size_t iterations) {
+  size_t repeat;
+  size_t i;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    for (i = 0; i < SENTENCES; i++) {
+      sinkInvalid = nmeaValidateSentenceHasInvalidCharacters(sentences[i], lengths[i]);
+    }
+  }
+}
+
+static void checksumScalar(void *arg __attribute__((unused)), size_t iterations) {
+  size_t repeat;
+  size_t i;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    for (i = 0; i < SENTENCES; i++) {
+      sink = scalarCRC(sentences[i], lengths[i]);
+    }
+  }
+}
+
+static void checksum(void *arg __attribute__((unused)), size_t iterations) {
+  size_t repeat;
+  size_t i;
+
+  for (repeat = 0; repeat < iterations; repeat++) {
+    for (i = 0; i < SENTENCES; i++) {
+      sink = nmeaCalculateCRC(sentences[i], lengths[i]);
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  BenchHarness harness;
+  size_t bytes = 0;
+  size_t i;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  for (i = 0; i < SENTENCES; i++) {
+    lengths[i] = strlen(sentences[i]);
+    bytes += lengths[i];
+    if ((nmeaValidateSentenceHasInvalidCharacters(sentences[i], lengths[i]) != scalarInvalid(sentences[i], lengths[i])) //
+        || (nmeaCalculateCRC(sentences[i], lengths[i]) != scalarCRC(sentences[i], lengths[i]))) {
+      fprintf(stderr, "mismatch on sentence %lu\n", (unsigned long) i);
+      benchHarnessFinish(&harness);
+      return 1;
+    }
+  }
+
+  if (harness.table) {
+    printf("%lu sentences, %lu bytes\n", (unsigned long) SENTENCES, (unsigned long) bytes);
+  }
+
+  benchHarnessSection(&harness, "invalid characters (ns/byte)");
+  benchHarnessRun(&harness, "validate/invalid-characters-scalar", invalidScalar, NULL, bytes);
+  benchHarnessRun(&harness, "validate/invalid-characters", invalid, NULL, bytes);
+
+  benchHarnessSection(&harness, "checksum (ns/byte)");
+  benchHarnessRun(&harness, "validate/checksum-scalar", checksumScalar, NULL, bytes);
+  benchHarnessRun(&harness, "validate/checksum", checksum, NULL, bytes);
+
+  benchHarnessFinish(&harness);
+  return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Parser throughput per validation policy, on a clean generated corpus of
+ * all sentence types.
+ */
+
+#include "../harness.h"
+
+#include <nmealib/corpus.h>
+#include <nmealib/info.h>
+#include <nmealib/parser.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FIXES (20000)
+
+static volatile size_t sink;
+
+typedef struct _ValidationBench {
+    NmeaParser  parser;
+    NmeaInfo    info;
+    const char *s;
+    size_t      sz;
+} ValidationBench;
+
+static void validationParse(void *arg, size_t iterations) {
+  ValidationBench *b = (ValidationBench *) arg;
+  size_t i;
+
+  for (i = 0; i < iterations; i++) {
+    sink = nmeaParserParse(&b->parser, b->s, b->sz, &b->info);
+  }
+}
+
+/**
+ * Parse the corpus with a policy and report throughput
+ */
+static void run(BenchHarness *harness, const char *name, const char *corpus, size_t length,
+    NmeaValidationPolicy policy) {
+  ValidationBench b;
+
+  memset(&b, 0, sizeof(b));
+  nmeaParserInit(&b.parser, 0);
+  b.parser.validation = policy;
+  b.s = corpus;
+  b.sz = length;
+
+  benchHarnessRun(harness, name, validationParse, &b, length);
+
+  nmeaParserDestroy(&b.parser);
+}
+
+int main(int argc, char *argv[]) {
+  BenchHarness harness;
+  NmeaCorpusConfig config;
+  NmeaMallocedBuffer buf;
+  NmeaCorpusStats stats;
+  size_t length;
+
+  if (!benchHarnessInit(&harness, argc, argv)) {
+    return 1;
+  }
+
+  memset(&config, 0, sizeof(config));
+  config.type = NMEALIB_GENERATOR_ROTATE;
+  config.mask = NMEALIB_SENTENCE_MASK;
+  config.seed = 1;
+  nmeaCorpusConfigGarbage(&config, 0.0);
+
+  memset(&buf, 0, sizeof(buf));
+  length = nmeaCorpusGenerate(&config, FIXES, &buf, &stats);
+  if (!length) {
+    fprintf(stderr, "could not generate the corpus\n");
+    benchHarnessFinish(&harness);
+    return 1;
+  }
+
+  if (harness.table) {
+    printf("%lu bytes, %lu sentences\n", (unsigned long) length, (unsigned long) stats.sentences);
+  }
+
+  benchHarnessSection(&harness, "parse per validation policy (ns/byte)");
+  run(&harness, "validation/strict", buf.buffer, length, NMEALIB_VALIDATION_STRICT);
+  run(&harness, "validation/structural", buf.buffer, length, NMEALIB_VALIDATION_STRUCTURAL);
+  run(&harness, "validation/trusted", buf.buffer, length, NMEALIB_VALIDATION_TRUSTED);
+
+  free(buf.buffer);
+  benchHarnessFinish(&harness);
+  return 0;
+}
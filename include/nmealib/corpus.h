@@ -0,0 +1,120 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Malformed-input corpus generation
+ *
+ * A corpus is a stream of generated sentences of which a fraction is damaged
+ * the way real serial links damage them, mixed with blocks of binary noise.
+ * Every mutation hits a different reset path of the parser:
+ * - truncated: the sentence is cut off and loses its line ending, the parser
+ *   drops it on the start of the next sentence;
+ * - bit flipped: a bit of a data character is flipped, the checksum no
+ *   longer matches (or the character became invalid);
+ * - bad checksum: a checksum digit is replaced by another hex digit;
+ * - bad hex: a checksum digit is replaced by a non-hex character;
+ * - overlong: the sentence is padded with fields until it overflows the
+ *   parser buffer.
+ *
+ * A sentence gets at most one mutation. The corpus is reproducible: the same
+ * configuration gives the same bytes, and the same seed gives the same
+ * sentences whatever the rates.
+ */
+
+#ifndef __NMEALIB_CORPUS_H__
+#define __NMEALIB_CORPUS_H__
+
+#include <nmealib/generator.h>
+#include <nmealib/sentence.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The default maximum length of a block of noise */
+#define NMEALIB_CORPUS_NOISE_MAX_DEFAULT (64u)
+
+/**
+ * Corpus configuration
+ *
+ * The mutation rates are fractions of the sentences and must not add up to
+ * more than 1.
+ */
+typedef struct _NmeaCorpusConfig {
+    NmeaGeneratorType type;           /**< The type of the generator                                            */
+    NmeaSentence      mask;           /**< The sentences to generate                                            */
+    uint64_t          seed;           /**< The seed of the random number generator                              */
+    double            truncateRate;   /**< The fraction of sentences that is truncated                          */
+    double            bitFlipRate;    /**< The fraction of sentences that gets a bit flipped                    */
+    double            checksumRate;   /**< The fraction of sentences that gets a bad checksum                   */
+    double            hexRate;        /**< The fraction of sentences that gets a non-hex checksum character     */
+    double            overlongRate;   /**< The fraction of sentences that is made overlong                      */
+    double            noiseRate;      /**< The probability of a block of binary noise after a sentence          */
+    size_t            noiseMax;       /**< The maximum length of a block of noise, 0 for the default            */
+    size_t            overlongLength; /**< The minimum length of an overlong sentence, 0 for the parser default */
+} NmeaCorpusConfig;
+
+/**
+ * Corpus statistics
+ */
+typedef struct _NmeaCorpusStats {
+    uint64_t fixes;       /**< The number of generated fixes                       */
+    uint64_t sentences;   /**< The number of generated sentences                   */
+    uint64_t intact;      /**< The number of sentences that were not mutated       */
+    uint64_t truncated;   /**< The number of truncated sentences                   */
+    uint64_t bitFlipped;  /**< The number of sentences with a flipped bit          */
+    uint64_t checksums;   /**< The number of sentences with a bad checksum         */
+    uint64_t badHex;      /**< The number of sentences with a non-hex checksum     */
+    uint64_t overlong;    /**< The number of overlong sentences                    */
+    uint64_t noiseBlocks; /**< The number of blocks of noise                       */
+    uint64_t noiseBytes;  /**< The number of bytes of noise                        */
+    uint64_t bytes;       /**< The length of the corpus                            */
+} NmeaCorpusStats;
+
+/**
+ * Configure the rates of a corpus from a single garbage ratio
+ *
+ * The ratio is spread evenly over the mutations, and is also the probability
+ * of a block of noise after a sentence. The other fields are not changed.
+ *
+ * @param config The configuration
+ * @param garbage The garbage ratio, in [0, 1]
+ */
+void nmeaCorpusConfigGarbage(NmeaCorpusConfig *config, double garbage);
+
+/**
+ * Generate a corpus
+ *
+ * @param config The configuration
+ * @param fixes The number of fixes to generate
+ * @param buf The buffer in which to store the corpus (do read the comments
+ * of NmeaMallocedBuffer). The corpus contains binary noise and is not
+ * NUL-terminated.
+ * @param stats The structure in which to store the statistics, may be NULL
+ * @return The length of the corpus, 0 on invalid inputs
+ */
+size_t nmeaCorpusGenerate(const NmeaCorpusConfig *config, size_t fixes, NmeaMallocedBuffer *buf,
+    NmeaCorpusStats *stats);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_CORPUS_H__ */
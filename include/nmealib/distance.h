@@ -0,0 +1,124 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Batched great-circle distance kernels
+ *
+ * The kernels compute great-circle distances (on a sphere with radius
+ * NMEALIB_EARTHRADIUS_M, like nmeaMathDistance) over arrays of positions in
+ * radians: from one position to many, along a path, and between all rows and
+ * columns of a tile. They use the haversine formula, which (unlike the
+ * spherical law of cosines of nmeaMathDistance) is also accurate for short
+ * distances.
+ *
+ * Positions are processed in blocks: the trigonometric functions of a block
+ * are evaluated in one pass over an array, the rest is plain arithmetic. In
+ * NMEALIB_DISTANCE_FAST mode the passes use the vectorised approximations of
+ * fastmath.h, which are off by less than a nanometre. In
+ * NMEALIB_DISTANCE_EXACT mode they use the C library.
+ *
+ * Near antipodal positions the haversine formula is ill-conditioned: there
+ * the distances of both modes can be off by decimetres.
+ */
+
+#ifndef __NMEALIB_DISTANCE_H__
+#define __NMEALIB_DISTANCE_H__
+
+#include <nmealib/info.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The number of positions in a block */
+#define NMEALIB_DISTANCE_BLOCK (64u)
+
+/**
+ * Accuracy modes
+ */
+typedef enum _NmeaDistanceMode {
+  NMEALIB_DISTANCE_EXACT = 0u, /**< Use the C library        */
+  NMEALIB_DISTANCE_FAST  = 1u  /**< Use fastmath.h           */
+} NmeaDistanceMode;
+
+/**
+ * Distances from one position to many
+ *
+ * @param from The position to measure from
+ * @param to The positions to measure to
+ * @param count The number of positions in to
+ * @param distances The array (of count elements) in which to store the
+ * distances in meters
+ * @param mode The accuracy mode
+ * @return True on success
+ */
+bool nmeaDistanceOneToMany(const NmeaPosition *from, const NmeaPosition *to, size_t count, double *distances,
+    NmeaDistanceMode mode);
+
+/**
+ * Length of a path: the distances between consecutive positions
+ *
+ * @param points The positions of the path
+ * @param count The number of positions
+ * @param distances The array (of count - 1 elements) in which to store the
+ * distances between consecutive positions in meters, may be NULL
+ * @param mode The accuracy mode
+ * @return The length of the path in meters, NaN on invalid inputs
+ */
+double nmeaDistancePath(const NmeaPosition *points, size_t count, double *distances, NmeaDistanceMode mode);
+
+/**
+ * Distances between all rows and columns of a tile
+ *
+ * @param rows The row positions
+ * @param rowCount The number of row positions
+ * @param columns The column positions
+ * @param columnCount The number of column positions
+ * @param distances The array (of rowCount * columnCount elements, row-major)
+ * in which to store the distances in meters
+ * @param mode The accuracy mode
+ * @return True on success
+ */
+bool nmeaDistanceTile(const NmeaPosition *rows, size_t rowCount, const NmeaPosition *columns, size_t columnCount,
+    double *distances, NmeaDistanceMode mode);
+
+/**
+ * Find the nearest of many positions
+ *
+ * Compares the haversines of the distances, so only the distance to the
+ * nearest position is completed.
+ *
+ * @param from The position to measure from
+ * @param to The positions to search
+ * @param count The number of positions in to
+ * @param distance The location in which to store the distance to the nearest
+ * position in meters, may be NULL
+ * @param mode The accuracy mode
+ * @return The index of the nearest position, count when there are no
+ * positions or on invalid inputs
+ */
+size_t nmeaDistanceNearest(const NmeaPosition *from, const NmeaPosition *to, size_t count, double *distance,
+    NmeaDistanceMode mode);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_DISTANCE_H__ */
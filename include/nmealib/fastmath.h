@@ -0,0 +1,137 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Fast polynomial approximations of trigonometric functions
+ *
+ * The approximations use only multiplications, additions, min/max and a
+ * square root, so they vectorise: the array functions process 2 values per
+ * SSE2 instruction where SSE2 is available (define NMEALIB_NO_SSE2 to
+ * disable it) and fall back to the same polynomials in scalar code
+ * elsewhere.
+ *
+ * Error bounds (absolute, against the C library):
+ * - nmeaFastSin, nmeaFastCos and nmeaFastSinCos: below 1E-14 for |x| <= 1E6 radians. The
+ *   argument is reduced exactly (for |x| < 2^23 * 2 pi) to [-pi/2, pi/2],
+ *   after which the error is that of a degree 17 polynomial that interpolates
+ *   the sine at Chebyshev nodes (below 3E-16). Small arguments keep their
+ *   relative accuracy. Arguments beyond 2^31 * 2 pi give undefined results.
+ * - nmeaFastAsin: below 1E-15 on [-1, 1]. Arguments above 0.5 are reduced
+ *   with asin(x) = pi/2 - 2 asin(sqrt((1 - x) / 2)), after which the error is
+ *   that of a degree 25 polynomial that interpolates the arc sine at
+ *   Chebyshev nodes on [0, 0.5].
+ * - nmeaFastAtan2: below 1E-15 for finite arguments. The ratio of the
+ *   smaller to the larger absolute argument is reduced with
+ *   atan(t) = pi/4 + atan((t - 1) / (t + 1)) to [-tan(pi/8), tan(pi/8)], after
+ *   which the error is that of a degree 21 polynomial that interpolates the
+ *   arc tangent at Chebyshev nodes.
+ *
+ * A distance on earth computed with these functions is off by less than a
+ * nanometre, a position moved with them (see nmeaMathMoveFlatMode) by less
+ * than 0.1 micrometre below 85 degrees of latitude. Nearer the poles the
+ * rounding of the arc sine of the latitude dominates, in the C library as well:
+ * moves then differ by up to a few times the error of the C library, a few
+ * centimetres within 0.001 degree of a pole.
+ */
+
+#ifndef __NMEALIB_FASTMATH_H__
+#define __NMEALIB_FASTMATH_H__
+
+#include <stddef.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Fast sine
+ *
+ * @param x The angle in radians
+ * @return The sine of the angle
+ */
+double nmeaFastSin(double x);
+
+/**
+ * Fast cosine
+ *
+ * @param x The angle in radians
+ * @return The cosine of the angle
+ */
+double nmeaFastCos(double x);
+
+/**
+ * Fast sine and cosine
+ *
+ * Cheaper than nmeaFastSin and nmeaFastCos for the same angle, since the
+ * argument is reduced once. The error bounds are those of nmeaFastSin.
+ *
+ * @param x The angle in radians
+ * @param s The location in which to store the sine
+ * @param c The location in which to store the cosine
+ */
+void nmeaFastSinCos(double x, double *s, double *c);
+
+/**
+ * Fast arc sine
+ *
+ * @param x The value, in [-1, 1]
+ * @return The arc sine of the value in radians, in [-pi/2, pi/2]
+ */
+double nmeaFastAsin(double x);
+
+/**
+ * Fast arc tangent of a quotient
+ *
+ * @param y The numerator
+ * @param x The denominator
+ * @return The angle of (x, y) in radians, in [-pi, pi], like atan2
+ */
+double nmeaFastAtan2(double y, double x);
+
+/**
+ * Fast sine of an array
+ *
+ * @param x The angles in radians
+ * @param y The array in which to store the sines, may be x
+ * @param count The number of angles
+ */
+void nmeaFastSinArray(const double *x, double *y, size_t count);
+
+/**
+ * Fast cosine of an array
+ *
+ * @param x The angles in radians
+ * @param y The array in which to store the cosines, may be x
+ * @param count The number of angles
+ */
+void nmeaFastCosArray(const double *x, double *y, size_t count);
+
+/**
+ * Fast arc sine of an array
+ *
+ * @param x The values, in [-1, 1]
+ * @param y The array in which to store the arc sines, may be x
+ * @param count The number of values
+ */
+void nmeaFastAsinArray(const double *x, double *y, size_t count);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_FASTMATH_H__ */
@@ -0,0 +1,167 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Multithreaded fleet simulator
+ *
+ * A fleet simulates many independent receivers (units), each driven by its
+ * own generator chain, for load-testing consumers of NMEA streams.
+ *
+ * The units are sharded over worker threads. Every shard owns its units, a
+ * single pool from which the generator nodes of its units are allocated, its
+ * own random number generator and its own output buffer, so the workers share
+ * nothing while running. The generators of the units of a shard draw from the
+ * random number generator of the shard, which is an independent stream of
+ * the seed of the fleet, so the random parts of a run are reproducible for a
+ * given seed and number of threads.
+ *
+ * Every tick every unit invokes its generator chain once and appends the
+ * generated sentences to the output buffer of its shard. A full output buffer
+ * is handed to the output callback, from the worker thread that owns it, and
+ * then reused. Within a shard the sentences of a unit are appended in tick
+ * order, so the stream of every unit is contiguous per tick and in order.
+ *
+ * The fleet can be throttled to a target aggregate rate of fixes (one fix is
+ * one generator invocation of one unit) per second.
+ *
+ * Fleets are only supported on POSIX systems.
+ */
+
+#ifndef __NMEALIB_FLEET_H__
+#define __NMEALIB_FLEET_H__
+
+#include <nmealib/generator.h>
+#include <nmealib/gpgsv.h>
+#include <nmealib/info.h>
+#include <nmealib/sentence.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The default size of the output buffer of a shard */
+#define NMEALIB_FLEET_BUFFER_SIZE_DEFAULT (64u * 1024u)
+
+/** The minimum size of the output buffer of a shard: all sentences of one fix */
+#define NMEALIB_FLEET_BUFFER_SIZE_MIN (((4u + NMEALIB_GPGSV_MAX_SENTENCES) * NMEALIB_SENTENCE_MAX_LENGTH) + 1u)
+
+/* Forward declaration */
+typedef struct _NmeaFleet NmeaFleet;
+
+/**
+ * Fleet output callback
+ *
+ * Invoked from the worker thread of a shard, concurrently with the output
+ * callbacks of other shards.
+ *
+ * @param userData The user data of the fleet configuration
+ * @param shard The shard
+ * @param s The sentences, not NUL-terminated
+ * @param len The length of the sentences
+ */
+typedef void (*NmeaFleetOutput)(void *userData, size_t shard, const char *s, size_t len);
+
+/**
+ * Fleet configuration
+ */
+typedef struct _NmeaFleetConfig {
+    size_t             units;      /**< The number of simulated units                                */
+    size_t             threads;    /**< The number of worker threads (shards), 0 for 1                */
+    NmeaGeneratorType  type;       /**< The type of the generator chain of every unit                 */
+    NmeaSentence       mask;       /**< The sentences to generate                                     */
+    NmeaMathMode       mathMode;   /**< The accuracy mode of the position math of the generators     */
+    double             rate;       /**< The target aggregate rate in fixes per second, 0 for no limit */
+    uint64_t           seed;       /**< The seed of the random number generators of the shards       */
+    size_t             bufferSize; /**< The size of the output buffer of a shard, 0 for the default  */
+    NmeaFleetOutput    output;     /**< The output callback, NULL to discard the output               */
+    void              *userData;   /**< The user data for the output callback                        */
+} NmeaFleetConfig;
+
+/**
+ * Fleet throughput metrics
+ */
+typedef struct _NmeaFleetMetrics {
+    uint64_t fixes;          /**< The number of fixes                                  */
+    uint64_t bytes;          /**< The number of generated bytes                        */
+    uint64_t flushes;        /**< The number of output callback invocations            */
+    double   seconds;        /**< The wall-clock time spent running                    */
+    double   fixesPerSecond; /**< The throughput in fixes per second                   */
+    double   bytesPerSecond; /**< The throughput in bytes per second                   */
+} NmeaFleetMetrics;
+
+/**
+ * Create a fleet
+ *
+ * Allocates the units, their generator nodes and the output buffers and
+ * initialises the generator of every unit. The initial position of every unit
+ * is scattered around the default position with the random number generator
+ * of its shard, so a fleet created with the same configuration starts at the
+ * same positions.
+ *
+ * @param config The configuration
+ * @return The fleet, or NULL on failure
+ */
+NmeaFleet *nmeaFleetCreate(const NmeaFleetConfig *config);
+
+/**
+ * Destroy a fleet
+ *
+ * @param fleet The fleet
+ */
+void nmeaFleetDestroy(NmeaFleet *fleet);
+
+/**
+ * Run a fleet
+ *
+ * Starts the worker threads, lets every unit generate ticks fixes, flushes the
+ * output buffers and waits for the worker threads to finish. The metrics are
+ * accumulated over all runs.
+ *
+ * @param fleet The fleet
+ * @param ticks The number of fixes to generate per unit
+ * @return True on success
+ */
+bool nmeaFleetRun(NmeaFleet *fleet, size_t ticks);
+
+/**
+ * Get the metrics of a fleet
+ *
+ * @param fleet The fleet
+ * @param metrics The structure in which to store the metrics
+ */
+void nmeaFleetMetrics(const NmeaFleet *fleet, NmeaFleetMetrics *metrics);
+
+/**
+ * Get the info structure of a unit of a fleet
+ *
+ * Must not be called while the fleet is running.
+ *
+ * @param fleet The fleet
+ * @param unit The unit
+ * @return The info structure, or NULL when the unit does not exist
+ */
+const NmeaInfo *nmeaFleetUnitInfo(const NmeaFleet *fleet, size_t unit);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_FLEET_H__ */
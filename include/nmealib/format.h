@@ -0,0 +1,246 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Fast formatting of NMEA fields
+ *
+ * The functions in this file are replacements for snprintf with the specific
+ * formats that are used by the sentence generators. Their output, return
+ * value and truncation behaviour are identical to those of snprintf:
+ *
+ * - at most sz - 1 characters are written, followed by a terminating null
+ *   character (nothing is written when sz is zero);
+ * - the return value is the number of characters that would have been
+ *   written had sz been large enough, not counting the terminating null
+ *   character.
+ *
+ * This allows them to be used with the dst/available idiom of the generators:
+ *
+ * <pre>
+ *   chars += nmeaFormatChar(dst, available, ',');
+ *   chars += nmeaFormatDouble(dst, available, pack->latitude, 9, 4);
+ * </pre>
+ *
+ * Numbers are formatted with integer arithmetic instead of by parsing a
+ * format string, and floating point numbers are rounded correctly (on the
+ * exact binary value, ties to even) like glibc does.
+ *
+ * The sentence generators use a formatter (NmeaFormatter) instead, which
+ * keeps track of the output position and folds every character into the NMEA
+ * checksum as it is written, so that the checksum doesn't need a second pass
+ * over the sentence:
+ *
+ * <pre>
+ *   NmeaFormatter out;
+ *
+ *   nmeaFormatterInit(&out, s, sz);
+ *   nmeaFormatterString(&out, "$GPVTG");
+ *   nmeaFormatterChar(&out, ',');
+ *   nmeaFormatterDouble(&out, pack->track, 0, 1);
+ *   ...
+ *   nmeaFormatterChecksum(&out);
+ *   return out.length;
+ * </pre>
+ */
+
+#ifndef __NMEALIB_FORMAT_H__
+#define __NMEALIB_FORMAT_H__
+
+#include <nmealib/util.h>
+#include <stddef.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Format a string, like snprintf(s, sz, "%s", str)
+ *
+ * @param s The buffer
+ * @param sz The size of the buffer
+ * @param str The string
+ * @return The length of the string
+ */
+int nmeaFormatString(char *s, size_t sz, const char *str);
+
+/**
+ * Format a character, like snprintf(s, sz, "%c", c)
+ *
+ * @param s The buffer
+ * @param sz The size of the buffer
+ * @param c The character
+ * @return 1
+ */
+int nmeaFormatChar(char *s, size_t sz, char c);
+
+/**
+ * Format an unsigned integer, like snprintf(s, sz, "%0*lu", width, v)
+ *
+ * @param s The buffer
+ * @param sz The size of the buffer
+ * @param v The value
+ * @param width The minimum width, zero-padded
+ * @return The length of the formatted value
+ */
+int nmeaFormatUnsigned(char *s, size_t sz, unsigned long v, unsigned int width);
+
+/**
+ * Format a signed integer, like snprintf(s, sz, "%0*ld", width, v)
+ *
+ * @param s The buffer
+ * @param sz The size of the buffer
+ * @param v The value
+ * @param width The minimum width (including the sign), zero-padded
+ * @return The length of the formatted value
+ */
+int nmeaFormatInt(char *s, size_t sz, long v, unsigned int width);
+
+/**
+ * Format a floating point number, like
+ * snprintf(s, sz, "%0*.*f", width, precision, v)
+ *
+ * Infinities, NaNs, very large numbers and precisions beyond 4 digits are
+ * formatted by snprintf.
+ *
+ * @param s The buffer
+ * @param sz The size of the buffer
+ * @param v The value
+ * @param width The minimum width (including the sign and the decimal point),
+ * zero-padded
+ * @param precision The number of digits after the decimal point
+ * @return The length of the formatted value
+ */
+int nmeaFormatDouble(char *s, size_t sz, double v, unsigned int width, unsigned int precision);
+
+/**
+ * Format the checksum trailer of a NMEA sentence: '*', 2 upper case hex
+ * digits, CR and LF
+ *
+ * @param trailer The buffer for the trailer, of NMEALIB_CHECKSUM_LENGTH
+ * characters (it is not null-terminated)
+ * @param checksum The checksum
+ */
+void nmeaFormatChecksum(char *trailer, unsigned int checksum);
+
+/**
+ * Sentence formatter
+ *
+ * Accumulates the output of the nmeaFormatter* functions in a buffer, with
+ * snprintf semantics for the whole sentence: length is the number of
+ * characters that would have been written had the buffer been large enough.
+ */
+typedef struct _NmeaFormatter {
+    char          *s;        /**< The buffer                                               */
+    size_t         sz;       /**< The size of the buffer                                   */
+    size_t         length;   /**< The length of the output                                 */
+    unsigned char  checksum; /**< The XOR of the output, without the start-of-line character */
+} NmeaFormatter;
+
+/**
+ * The position in the buffer of a formatter where the next characters go
+ *
+ * @param f The formatter
+ * @return The position
+ */
+static INLINE char *nmeaFormatterDst(const NmeaFormatter *f) {
+  return (f->length < f->sz) ?
+      &f->s[f->length] :
+      f->s;
+}
+
+/**
+ * The space that is left in the buffer of a formatter
+ *
+ * @param f The formatter
+ * @return The space, including the space for the terminating null character
+ */
+static INLINE size_t nmeaFormatterAvailable(const NmeaFormatter *f) {
+  return (f->length < f->sz) ?
+      (f->sz - f->length) :
+      0;
+}
+
+/**
+ * Initialise a formatter
+ *
+ * The output must start with the NMEA start-of-line character ('$'), which
+ * is not part of the checksum.
+ *
+ * @param f The formatter
+ * @param s The buffer, can be NULL to only determine the length
+ * @param sz The size of the buffer
+ */
+void nmeaFormatterInit(NmeaFormatter *f, char *s, size_t sz);
+
+/**
+ * Append a string, see nmeaFormatString
+ *
+ * @param f The formatter
+ * @param str The string
+ */
+void nmeaFormatterString(NmeaFormatter *f, const char *str);
+
+/**
+ * Append a character, see nmeaFormatChar
+ *
+ * @param f The formatter
+ * @param c The character
+ */
+void nmeaFormatterChar(NmeaFormatter *f, char c);
+
+/**
+ * Append an unsigned integer, see nmeaFormatUnsigned
+ *
+ * @param f The formatter
+ * @param v The value
+ * @param width The minimum width, zero-padded
+ */
+void nmeaFormatterUnsigned(NmeaFormatter *f, unsigned long v, unsigned int width);
+
+/**
+ * Append a signed integer, see nmeaFormatInt
+ *
+ * @param f The formatter
+ * @param v The value
+ * @param width The minimum width (including the sign), zero-padded
+ */
+void nmeaFormatterInt(NmeaFormatter *f, long v, unsigned int width);
+
+/**
+ * Append a floating point number, see nmeaFormatDouble
+ *
+ * @param f The formatter
+ * @param v The value
+ * @param width The minimum width (including the sign and the decimal point),
+ * zero-padded
+ * @param precision The number of digits after the decimal point
+ */
+void nmeaFormatterDouble(NmeaFormatter *f, double v, unsigned int width, unsigned int precision);
+
+/**
+ * Append the checksum trailer ("*XX\r\n") of the output so far
+ *
+ * @param f The formatter
+ */
+void nmeaFormatterChecksum(NmeaFormatter *f);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_FORMAT_H__ */
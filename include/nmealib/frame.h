@@ -0,0 +1,255 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Batched coordinate frame conversion kernels
+ *
+ * The kernels convert arrays of coordinates between frames on the WGS84
+ * ellipsoid (semi-major axis NMEALIB_EARTHRADIUS_M, flattening
+ * NMEALIB_EARTH_FLATTENING):
+ * - geodetic: latitude and longitude in radians, height above the ellipsoid
+ *   in meters;
+ * - ECEF: earth-centred, earth-fixed cartesian coordinates in meters;
+ * - ENU: east, north and up in meters, in the tangent plane at an origin;
+ * - UTM: easting and northing in meters, in a given zone and hemisphere.
+ *
+ * Coordinates are passed as structure-of-arrays: one array per coordinate.
+ * nmeaFrameSplitPositions and nmeaFrameSplitRecords fill such arrays from
+ * NmeaPosition and NmeaRecord arrays (for example the records of a track).
+ *
+ * Coordinates are processed in blocks: the trigonometric functions of a
+ * block are evaluated in one pass over an array, the rest is arithmetic in
+ * loops without branches. In NMEALIB_FRAME_FAST mode the sines and cosines
+ * use the vectorised approximations of fastmath.h; in NMEALIB_FRAME_EXACT
+ * mode they use the C library. Other functions always use the C library.
+ *
+ * Accuracy:
+ * - geodetic to ECEF and ENU: exact up to rounding (nanometres) in both
+ *   modes;
+ * - ECEF to geodetic: the closed form of Heikkinen (1982), exact up to
+ *   rounding for heights above -6000 km;
+ * - UTM: the Krueger series of order 6 in the third flattening (after
+ *   C. F. F. Karney, "Transverse Mercator with an accuracy of a few
+ *   nanometers", J. Geodesy 85 (2011)), accurate to well below a micrometre
+ *   within a few zones of the central meridian.
+ *
+ * UTM zones are numbered 1 to 60. Positions are converted into the given
+ * zone (also outside of it), so that a batch stays in a single grid. The
+ * polar regions (UPS) are not supported.
+ */
+
+#ifndef __NMEALIB_FRAME_H__
+#define __NMEALIB_FRAME_H__
+
+#include <nmealib/info.h>
+#include <nmealib/record.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The number of coordinates in a block */
+#define NMEALIB_FRAME_BLOCK (64u)
+
+/** The scale factor on the central meridian of a UTM zone */
+#define NMEALIB_UTM_SCALE (0.9996)
+
+/** The easting of the central meridian of a UTM zone, in meters */
+#define NMEALIB_UTM_EASTING (500000.0)
+
+/** The northing of the equator in the southern hemisphere, in meters */
+#define NMEALIB_UTM_NORTHING_SOUTH (10000000.0)
+
+/**
+ * Accuracy modes
+ */
+typedef enum _NmeaFrameMode {
+  NMEALIB_FRAME_EXACT = 0u, /**< Use the C library        */
+  NMEALIB_FRAME_FAST  = 1u  /**< Use fastmath.h           */
+} NmeaFrameMode;
+
+/**
+ * The origin of an ENU frame
+ */
+typedef struct _NmeaFrameOrigin {
+    NmeaPosition position; /**< The position (in radians)                   */
+    double       height;   /**< The height above the ellipsoid, in meters   */
+    double       x;        /**< The ECEF X coordinate, in meters            */
+    double       y;        /**< The ECEF Y coordinate, in meters            */
+    double       z;        /**< The ECEF Z coordinate, in meters            */
+    double       sinLat;   /**< The sine of the latitude                    */
+    double       cosLat;   /**< The cosine of the latitude                  */
+    double       sinLon;   /**< The sine of the longitude                   */
+    double       cosLon;   /**< The cosine of the longitude                 */
+} NmeaFrameOrigin;
+
+/**
+ * Initialise the origin of an ENU frame
+ *
+ * @param origin The origin
+ * @param position The position (in radians)
+ * @param height The height above the ellipsoid, in meters
+ * @return True on success
+ */
+bool nmeaFrameOriginInit(NmeaFrameOrigin *origin, const NmeaPosition *position, double height);
+
+/**
+ * Split positions into coordinate arrays
+ *
+ * @param positions The positions (in radians)
+ * @param count The number of positions
+ * @param lat The array in which to store the latitudes
+ * @param lon The array in which to store the longitudes
+ * @return True on success
+ */
+bool nmeaFrameSplitPositions(const NmeaPosition *positions, size_t count, double *lat, double *lon);
+
+/**
+ * Split records into coordinate arrays
+ *
+ * The elevation of a record is relative to mean sea level (the geoid), it is
+ * used as the height above the ellipsoid (the difference is at most about
+ * 100 meters). Records without an elevation get a height of 0.
+ *
+ * @param records The records
+ * @param count The number of records
+ * @param lat The array in which to store the latitudes (in radians)
+ * @param lon The array in which to store the longitudes (in radians)
+ * @param height The array in which to store the heights, in meters, may be
+ * NULL
+ * @return True on success
+ */
+bool nmeaFrameSplitRecords(const NmeaRecord *records, size_t count, double *lat, double *lon, double *height);
+
+/**
+ * Convert geodetic coordinates to ECEF coordinates
+ *
+ * @param lat The latitudes (in radians)
+ * @param lon The longitudes (in radians)
+ * @param height The heights above the ellipsoid in meters, NULL for 0
+ * @param count The number of coordinates
+ * @param x The array in which to store the X coordinates
+ * @param y The array in which to store the Y coordinates
+ * @param z The array in which to store the Z coordinates
+ * @param mode The accuracy mode
+ * @return True on success
+ */
+bool nmeaFrameGeodeticToEcef(const double *lat, const double *lon, const double *height, size_t count, double *x,
+    double *y, double *z, NmeaFrameMode mode);
+
+/**
+ * Convert ECEF coordinates to geodetic coordinates
+ *
+ * @param x The X coordinates
+ * @param y The Y coordinates
+ * @param z The Z coordinates
+ * @param count The number of coordinates
+ * @param lat The array in which to store the latitudes (in radians)
+ * @param lon The array in which to store the longitudes (in radians)
+ * @param height The array in which to store the heights above the ellipsoid,
+ * may be NULL
+ * @return True on success
+ */
+bool nmeaFrameEcefToGeodetic(const double *x, const double *y, const double *z, size_t count, double *lat,
+    double *lon, double *height);
+
+/**
+ * Convert geodetic coordinates to ENU coordinates
+ *
+ * @param origin The origin of the ENU frame
+ * @param lat The latitudes (in radians)
+ * @param lon The longitudes (in radians)
+ * @param height The heights above the ellipsoid in meters, NULL for 0
+ * @param count The number of coordinates
+ * @param east The array in which to store the east coordinates
+ * @param north The array in which to store the north coordinates
+ * @param up The array in which to store the up coordinates, may be NULL
+ * @param mode The accuracy mode
+ * @return True on success
+ */
+bool nmeaFrameGeodeticToEnu(const NmeaFrameOrigin *origin, const double *lat, const double *lon,
+    const double *height, size_t count, double *east, double *north, double *up, NmeaFrameMode mode);
+
+/**
+ * Convert ENU coordinates to geodetic coordinates
+ *
+ * @param origin The origin of the ENU frame
+ * @param east The east coordinates
+ * @param north The north coordinates
+ * @param up The up coordinates, NULL for 0
+ * @param count The number of coordinates
+ * @param lat The array in which to store the latitudes (in radians)
+ * @param lon The array in which to store the longitudes (in radians)
+ * @param height The array in which to store the heights above the ellipsoid,
+ * may be NULL
+ * @return True on success
+ */
+bool nmeaFrameEnuToGeodetic(const NmeaFrameOrigin *origin, const double *east, const double *north,
+    const double *up, size_t count, double *lat, double *lon, double *height);
+
+/**
+ * Get the UTM zone of a position
+ *
+ * Includes the exceptions of southern Norway and Svalbard.
+ *
+ * @param position The position (in radians)
+ * @return The zone, in [1, 60], 0 on invalid inputs
+ */
+unsigned int nmeaFrameUtmZone(const NmeaPosition *position);
+
+/**
+ * Convert geodetic coordinates to UTM coordinates
+ *
+ * @param zone The zone, in [1, 60]
+ * @param south True for the southern hemisphere (false northing)
+ * @param lat The latitudes (in radians), within about 85 degrees
+ * @param lon The longitudes (in radians), the accuracy degrades beyond a few
+ * zones from the central meridian of the zone
+ * @param count The number of coordinates
+ * @param easting The array in which to store the eastings
+ * @param northing The array in which to store the northings
+ * @param mode The accuracy mode
+ * @return True on success
+ */
+bool nmeaFrameGeodeticToUtm(unsigned int zone, bool south, const double *lat, const double *lon, size_t count,
+    double *easting, double *northing, NmeaFrameMode mode);
+
+/**
+ * Convert UTM coordinates to geodetic coordinates
+ *
+ * @param zone The zone, in [1, 60]
+ * @param south True for the southern hemisphere (false northing)
+ * @param easting The eastings
+ * @param northing The northings
+ * @param count The number of coordinates
+ * @param lat The array in which to store the latitudes (in radians)
+ * @param lon The array in which to store the longitudes (in radians), in
+ * [-pi, pi]
+ * @param mode The accuracy mode
+ * @return True on success
+ */
+bool nmeaFrameUtmToGeodetic(unsigned int zone, bool south, const double *easting, const double *northing,
+    size_t count, double *lat, double *lon, NmeaFrameMode mode);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_FRAME_H__ */
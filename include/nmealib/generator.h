@@ -19,6 +19,8 @@
 #define __NMEALIB_GENERATOR_H__
 
 #include <nmealib/info.h>
+#include <nmealib/nmath.h>
+#include <nmealib/random.h>
 #include <nmealib/sentence.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -75,10 +77,12 @@ typedef bool (*NmeaGeneratorReset)(NmeaGenerator *gen, NmeaInfo *info);
  * Generator structure
  */
 typedef struct _NmeaGenerator {
-    NmeaGeneratorInit     init;   /**< initialiser function */
-    NmeaGeneratorInvoke   invoke; /**< invoke function      */
-    NmeaGeneratorReset    reset;  /**< reset function       */
-    NmeaGenerator        *next;   /**< the next generator   */
+    NmeaGeneratorInit     init;     /**< initialiser function                                    */
+    NmeaGeneratorInvoke   invoke;   /**< invoke function                                         */
+    NmeaGeneratorReset    reset;    /**< reset function                                          */
+    NmeaRandom           *random;   /**< random number generator, NULL for the one of the thread */
+    NmeaMathMode          mathMode; /**< the accuracy mode of the position math                  */
+    NmeaGenerator        *next;     /**< the next generator                                      */
 } NmeaGenerator;
 
 /**
@@ -92,6 +96,31 @@ typedef struct _NmeaGenerator {
  */
 NmeaGenerator *nmeaGeneratorCreate(NmeaGeneratorType type, NmeaInfo *info);
 
+/**
+ * The number of generator nodes a generator of a type consists of
+ *
+ * @param type The type of the generator
+ * @return The number of nodes, 0 for an invalid type
+ */
+size_t nmeaGeneratorNodes(NmeaGeneratorType type);
+
+/**
+ * Create a generator in caller-provided nodes and initialise it
+ *
+ * Does not allocate memory: the generator (chain) is constructed in the
+ * nodes, which must hold at least nmeaGeneratorNodes(type) nodes. This allows
+ * the nodes of many generators to be allocated from a single pool. A
+ * generator created this way must not be destroyed with
+ * nmeaGeneratorDestroy, the owner of the nodes frees them.
+ *
+ * @param nodes The nodes
+ * @param count The number of nodes
+ * @param type The type of the generator to create
+ * @param info The info structure to use during generation
+ * @return The generator (the first node), or NULL on failure
+ */
+NmeaGenerator *nmeaGeneratorCreateIn(NmeaGenerator *nodes, size_t count, NmeaGeneratorType type, NmeaInfo *info);
+
 /**
  * Destroy the generator
  *
@@ -128,6 +157,39 @@ bool nmeaGeneratorInvoke(NmeaGenerator *gen, NmeaInfo *info);
  */
 bool nmeaGeneratorReset(NmeaGenerator *gen, NmeaInfo *info);
 
+/**
+ * Set the random number generator of a generator (chain)
+ *
+ * By default generators use the random number generator of the thread that
+ * invokes them (see nmeaRandomThreadState). Setting a seeded random number
+ * generator makes the random parts of the generated information
+ * reproducible.
+ *
+ * Sets the random number generator of all generators in the chain: generators
+ * that are appended later must be set separately.
+ *
+ * @param gen The generator
+ * @param random The random number generator, NULL for the one of the thread
+ */
+void nmeaGeneratorSetRandom(NmeaGenerator *gen, NmeaRandom *random);
+
+/**
+ * Set the accuracy mode of the position math of a generator (chain)
+ *
+ * By default generators move positions with the C library trigonometry
+ * (NMEALIB_MATH_EXACT). NMEALIB_MATH_FAST makes moves much cheaper, see
+ * nmeaMathMoveFlatMode, at a positional error below 0.1 micrometre per move
+ * below 85 degrees of latitude (and within a few times the error of the exact
+ * mode nearer the poles).
+ *
+ * Sets the mode of all generators in the chain: generators that are appended
+ * later must be set separately.
+ *
+ * @param gen The generator
+ * @param mode The accuracy mode
+ */
+void nmeaGeneratorSetMathMode(NmeaGenerator *gen, NmeaMathMode mode);
+
 /**
  * Append a generator to another generator
  *
@@ -0,0 +1,123 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Geodesics on the ellipsoid
+ *
+ * Solves the inverse (distance and azimuths between 2 positions) and direct
+ * (position at a distance and azimuth) geodesic problems on the WGS84
+ * ellipsoid (semi-major axis NMEALIB_EARTHRADIUS_M, flattening
+ * NMEALIB_EARTH_FLATTENING), after C. F. F. Karney, "Algorithms for
+ * geodesics", J. Geodesy 87 (2013): the distance and longitude integrals are
+ * evaluated with series of order 6 in the third flattening, which are
+ * accurate to well below a micrometre.
+ *
+ * nmeaMathDistanceEllipsoid and nmeaMathMoveFlatEllipsoid take
+ * NMEALIB_EARTH_SEMIMAJORAXIS_M, which is the semi-minor axis of WGS84, as
+ * their semi-major axis: their distances are 0.34% shorter than the ones
+ * here.
+ *
+ * Unlike the Vincenty iterations of nmath.h, the inverse problem converges
+ * for all pairs of positions, including nearly antipodal ones: the azimuth
+ * at the origin is found with Newton steps, from a spherical estimate or, near
+ * the antipode, from the astroid estimate of Karney, safeguarded by bisection
+ * on an interval that always contains it.
+ *
+ * An origin caches the terms that only depend on the origin position, so
+ * that one-to-many queries don't recompute them.
+ *
+ * Positions and azimuths are in radians, azimuths are clockwise from north
+ * in [-pi, pi], and distances are in meters.
+ */
+
+#ifndef __NMEALIB_GEODESIC_H__
+#define __NMEALIB_GEODESIC_H__
+
+#include <nmealib/info.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * A geodesic origin
+ */
+typedef struct _NmeaGeodesicOrigin {
+    NmeaPosition position; /**< The position                                */
+    double       sinBeta;  /**< The sine of the reduced latitude            */
+    double       cosBeta;  /**< The cosine of the reduced latitude          */
+} NmeaGeodesicOrigin;
+
+/**
+ * Initialise a geodesic origin
+ *
+ * @param origin The origin
+ * @param position The position of the origin (in radians)
+ * @return True on success
+ */
+bool nmeaGeodesicOriginInit(NmeaGeodesicOrigin *origin, const NmeaPosition *position);
+
+/**
+ * Solve the inverse geodesic problem
+ *
+ * @param origin The origin
+ * @param to The position to measure to (in radians)
+ * @param fromAzimuth The location in which to store the azimuth at the origin
+ * (in radians), may be NULL
+ * @param toAzimuth The location in which to store the (forward) azimuth at
+ * the 'to' position (in radians), may be NULL
+ * @return The distance in meters, NaN on invalid inputs
+ */
+double nmeaGeodesicInverse(const NmeaGeodesicOrigin *origin, const NmeaPosition *to, double *fromAzimuth,
+    double *toAzimuth);
+
+/**
+ * Distances from an origin to many positions
+ *
+ * @param origin The origin
+ * @param to The positions to measure to (in radians)
+ * @param count The number of positions in to
+ * @param distances The array (of count elements) in which to store the
+ * distances in meters
+ * @return True on success
+ */
+bool nmeaGeodesicDistances(const NmeaGeodesicOrigin *origin, const NmeaPosition *to, size_t count,
+    double *distances);
+
+/**
+ * Solve the direct geodesic problem
+ *
+ * @param origin The origin
+ * @param azimuth The azimuth at the origin (in radians)
+ * @param distance The distance in meters
+ * @param to The location in which to store the end position (in radians),
+ * with a longitude in [-pi, pi]
+ * @param toAzimuth The location in which to store the (forward) azimuth at
+ * the end position (in radians), may be NULL
+ * @return True on success
+ */
+bool nmeaGeodesicDirect(const NmeaGeodesicOrigin *origin, double azimuth, double distance, NmeaPosition *to,
+    double *toAzimuth);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_GEODESIC_H__ */
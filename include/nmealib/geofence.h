@@ -0,0 +1,217 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Streaming geofence engine
+ *
+ * A geofence set holds many circular and polygonal fences and evaluates the
+ * fixes of many receivers against all of them, reporting the transitions
+ * (a receiver entering or exiting a fence) through a callback.
+ *
+ * Compiling a set puts its fences in a grid of latitude/longitude cells:
+ * every cell lists the fences whose bounding boxes overlap it, so a fix is
+ * only tested against the fences of its cell. Fences that would overlap
+ * very many cells are tested for every fix instead (against their bounding
+ * boxes first).
+ *
+ * Per receiver the set remembers the fences the receiver was last inside, so
+ * that a fix only reports the changes.
+ *
+ * Circles are tested with great-circle distances on a sphere with radius
+ * NMEALIB_EARTHRADIUS_M (like nmeaMathDistance), or with geodesic distances
+ * on the ellipsoid of geodesic.h. In the ellipsoidal mode the spherical
+ * distance decides unless it is within 2% of the radius, so that the
+ * geodesic is only solved for fixes near the edge of a circle.
+ *
+ * Polygons are tested in the latitude/longitude plane (their edges are
+ * rhumb lines, not great circles) and may cross the antimeridian, but must
+ * not contain a pole.
+ *
+ * Typical use:
+ *
+ * <pre>
+ *   nmeaGeofenceAddCircle(set, 1, &center, 500.0);
+ *   nmeaGeofenceAddPolygon(set, 2, vertices, 5);
+ *   nmeaGeofenceCompile(set);
+ *
+ *   if (nmeaParserParse(&parser[unit], buf, len, &info)) {
+ *     nmeaGeofenceUpdateInfo(set, unit, &info);
+ *   }
+ * </pre>
+ */
+
+#ifndef __NMEALIB_GEOFENCE_H__
+#define __NMEALIB_GEOFENCE_H__
+
+#include <nmealib/info.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The default cell size in meters */
+#define NMEALIB_GEOFENCE_CELL_SIZE_DEFAULT (10000.0)
+
+/** The minimum cell size in meters */
+#define NMEALIB_GEOFENCE_CELL_SIZE_MIN (100.0)
+
+/** The maximum number of cells of a fence, larger fences are tested for every fix */
+#define NMEALIB_GEOFENCE_CELLS_MAX (1024u)
+
+/* Forward declaration */
+typedef struct _NmeaGeofenceSet NmeaGeofenceSet;
+
+/**
+ * Distance modes of circular fences
+ */
+typedef enum _NmeaGeofenceMode {
+  NMEALIB_GEOFENCE_SPHERICAL   = 0u, /**< Great-circle distances, like nmeaMathDistance */
+  NMEALIB_GEOFENCE_ELLIPSOIDAL = 1u  /**< Geodesic distances, like geodesic.h          */
+} NmeaGeofenceMode;
+
+/**
+ * Transitions
+ */
+typedef enum _NmeaGeofenceTransition {
+  NMEALIB_GEOFENCE_ENTER = 0u, /**< The receiver entered the fence */
+  NMEALIB_GEOFENCE_EXIT  = 1u  /**< The receiver exited the fence  */
+} NmeaGeofenceTransition;
+
+/**
+ * Transition callback
+ *
+ * @param userData The user data of the set
+ * @param receiver The identifier of the receiver
+ * @param fence The identifier of the fence
+ * @param transition The transition
+ */
+typedef void (*NmeaGeofenceCallback)(void *userData, uint64_t receiver, uint64_t fence,
+    NmeaGeofenceTransition transition);
+
+/**
+ * Create a geofence set
+ *
+ * @param mode The distance mode of circular fences
+ * @param cellSize The (north-south) size of a grid cell in meters, 0 for the
+ * default, at least NMEALIB_GEOFENCE_CELL_SIZE_MIN
+ * @param callback The transition callback, may be NULL
+ * @param userData The user data for the callback
+ * @return The set, or NULL on failure
+ */
+NmeaGeofenceSet *nmeaGeofenceCreate(NmeaGeofenceMode mode, double cellSize, NmeaGeofenceCallback callback,
+    void *userData);
+
+/**
+ * Destroy a geofence set
+ *
+ * @param set The set
+ */
+void nmeaGeofenceDestroy(NmeaGeofenceSet *set);
+
+/**
+ * Add a circular fence to a set
+ *
+ * Invalidates the compilation of the set.
+ *
+ * @param set The set
+ * @param id The identifier of the fence
+ * @param center The center (in radians)
+ * @param radius The radius in meters
+ * @return True on success
+ */
+bool nmeaGeofenceAddCircle(NmeaGeofenceSet *set, uint64_t id, const NmeaPosition *center, double radius);
+
+/**
+ * Add a polygonal fence to a set
+ *
+ * Invalidates the compilation of the set.
+ *
+ * @param set The set
+ * @param id The identifier of the fence
+ * @param vertices The vertices (in radians), the polygon is closed implicitly
+ * @param count The number of vertices, at least 3
+ * @return True on success
+ */
+bool nmeaGeofenceAddPolygon(NmeaGeofenceSet *set, uint64_t id, const NmeaPosition *vertices, size_t count);
+
+/**
+ * Get the number of fences in a set
+ *
+ * @param set The set
+ * @return The number of fences
+ */
+size_t nmeaGeofenceCount(const NmeaGeofenceSet *set);
+
+/**
+ * Compile the fences of a set into its grid
+ *
+ * Done automatically by the first update after adding fences.
+ *
+ * @param set The set
+ * @return True on success
+ */
+bool nmeaGeofenceCompile(NmeaGeofenceSet *set);
+
+/**
+ * Find the fences that contain a position
+ *
+ * @param set The set, tested against every fence when it is not compiled
+ * @param position The position (in radians)
+ * @param fences The array (of capacity elements) in which to store the
+ * identifiers of the fences, in the order in which they were added, may be
+ * NULL when capacity is 0
+ * @param capacity The size of the fences array
+ * @return The number of fences that contain the position, which is more than
+ * capacity when not all fences could be stored
+ */
+size_t nmeaGeofenceContains(const NmeaGeofenceSet *set, const NmeaPosition *position, uint64_t *fences,
+    size_t capacity);
+
+/**
+ * Evaluate a fix of a receiver
+ *
+ * Invokes the callback for every fence that the receiver exited, then for
+ * every fence that it entered, since its previous fix. The first fix of a
+ * receiver enters all fences that contain it.
+ *
+ * @param set The set
+ * @param receiver The identifier of the receiver
+ * @param position The position of the fix (in radians)
+ * @return True on success
+ */
+bool nmeaGeofenceUpdate(NmeaGeofenceSet *set, uint64_t receiver, const NmeaPosition *position);
+
+/**
+ * Evaluate a fix of a receiver from a NmeaInfo structure
+ *
+ * @param set The set
+ * @param receiver The identifier of the receiver
+ * @param info The NmeaInfo structure, must have its latitude and longitude
+ * present (in NDEG)
+ * @return True on success
+ */
+bool nmeaGeofenceUpdateInfo(NmeaGeofenceSet *set, uint64_t receiver, const NmeaInfo *info);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_GEOFENCE_H__ */
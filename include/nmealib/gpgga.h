@@ -23,7 +23,9 @@
 #ifndef __NMEALIB_GPGGA_H__
 #define __NMEALIB_GPGGA_H__
 
+#include <nmealib/format.h>
 #include <nmealib/info.h>
+#include <nmealib/validate.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -98,6 +100,25 @@ typedef struct _NmeaGPGGA {
   unsigned int dgpsSid;
 } NmeaGPGGA;
 
+/**
+ * The fields of a GPGGA sentence, in sentence order
+ *
+ * Fields that belong together (like a value and its unit) are a single field.
+ */
+typedef enum _NmeaGPGGAField {
+  NMEALIB_GPGGA_FIELD_UTC = 0, /**< time */
+  NMEALIB_GPGGA_FIELD_LAT, /**< latitude and ns */
+  NMEALIB_GPGGA_FIELD_LON, /**< longitude and ew */
+  NMEALIB_GPGGA_FIELD_SIG, /**< signal */
+  NMEALIB_GPGGA_FIELD_SATS, /**< satellites */
+  NMEALIB_GPGGA_FIELD_HDOP, /**< hdop */
+  NMEALIB_GPGGA_FIELD_ELV, /**< elv and elv unit */
+  NMEALIB_GPGGA_FIELD_HEIGHT, /**< height and height unit */
+  NMEALIB_GPGGA_FIELD_DGPSAGE, /**< dgps age */
+  NMEALIB_GPGGA_FIELD_DGPSSID, /**< dgps id */
+  NMEALIB_GPGGA_FIELD_COUNT
+} NmeaGPGGAField;
+
 /**
  * Parse a GPGGA sentence
  *
@@ -108,6 +129,17 @@ typedef struct _NmeaGPGGA {
  */
 bool nmeaGPGGAParse(const char *s, const size_t sz, NmeaGPGGA *pack);
 
+/**
+ * Parse a GPGGA sentence, with a validation policy
+ *
+ * @param s The sentence
+ * @param sz The length of the sentence
+ * @param pack Where the result should be stored
+ * @param policy The validation policy
+ * @return True on success
+ */
+bool nmeaGPGGAParsePolicy(const char *s, const size_t sz, NmeaGPGGA *pack, NmeaValidationPolicy policy);
+
 /**
  * Update an unsanitised NmeaInfo structure from a GPGGA packet structure
  *
@@ -124,6 +156,17 @@ void nmeaGPGGAToInfo(const NmeaGPGGA *pack, NmeaInfo *info);
  */
 void nmeaGPGGAFromInfo(const NmeaInfo *info, NmeaGPGGA *pack);
 
+/**
+ * Generate a single field of a GPGGA sentence, including its leading comma(s)
+ *
+ * nmeaGPGGAGenerate generates the prefix, all fields in order and the checksum.
+ *
+ * @param out The formatter
+ * @param pack The NmeaGPGGA structure
+ * @param field The field
+ */
+void nmeaGPGGAGenerateField(NmeaFormatter *out, const NmeaGPGGA *pack, const NmeaGPGGAField field);
+
 /**
  * Generate a GPGGA sentence
  *
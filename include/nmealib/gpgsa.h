@@ -24,6 +24,7 @@
 #define __NMEALIB_GPGSA_H__
 
 #include <nmealib/info.h>
+#include <nmealib/validate.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -108,6 +109,17 @@ typedef struct _NmeaGPGSA {
  */
 bool nmeaGPGSAParse(const char *s, const size_t sz, NmeaGPGSA *pack);
 
+/**
+ * Parse a GPGSA sentence, with a validation policy
+ *
+ * @param s The sentence
+ * @param sz The length of the sentence
+ * @param pack Where the result should be stored
+ * @param policy The validation policy
+ * @return True on success
+ */
+bool nmeaGPGSAParsePolicy(const char *s, const size_t sz, NmeaGPGSA *pack, NmeaValidationPolicy policy);
+
 /**
  * Update an unsanitised NmeaInfo structure from a GPGSA packet structure
  *
@@ -24,6 +24,7 @@
 #define __NMEALIB_GPGSV_H__
 
 #include <nmealib/info.h>
+#include <nmealib/validate.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -132,6 +133,17 @@ size_t nmeaGPGSVsatellitesToSentencesCount(const size_t satellites);
  */
 bool nmeaGPGSVParse(const char *s, const size_t sz, NmeaGPGSV *pack);
 
+/**
+ * Parse a GPGSV sentence, with a validation policy
+ *
+ * @param s The sentence
+ * @param sz The length of the sentence
+ * @param pack Where the result should be stored
+ * @param policy The validation policy
+ * @return True on success
+ */
+bool nmeaGPGSVParsePolicy(const char *s, const size_t sz, NmeaGPGSV *pack, NmeaValidationPolicy policy);
+
 /**
  * Update an unsanitised NmeaInfo structure from a GPGSV packet structure
  *
@@ -23,7 +23,9 @@
 #ifndef __NMEALIB_GPRMC_H__
 #define __NMEALIB_GPRMC_H__
 
+#include <nmealib/format.h>
 #include <nmealib/info.h>
+#include <nmealib/validate.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -88,6 +90,24 @@ typedef struct _NmeaGPRMC {
   char     sig;
 } NmeaGPRMC;
 
+/**
+ * The fields of a GPRMC sentence, in sentence order
+ *
+ * Fields that belong together (like a value and its unit) are a single field.
+ */
+typedef enum _NmeaGPRMCField {
+  NMEALIB_GPRMC_FIELD_UTC = 0, /**< time */
+  NMEALIB_GPRMC_FIELD_SIGSELECTION, /**< selection */
+  NMEALIB_GPRMC_FIELD_LAT, /**< latitude and ns */
+  NMEALIB_GPRMC_FIELD_LON, /**< longitude and ew */
+  NMEALIB_GPRMC_FIELD_SPEED, /**< speed */
+  NMEALIB_GPRMC_FIELD_TRACK, /**< track */
+  NMEALIB_GPRMC_FIELD_DATE, /**< date */
+  NMEALIB_GPRMC_FIELD_MAGVAR, /**< magvar and magvar ew */
+  NMEALIB_GPRMC_FIELD_SIG, /**< mode (only for NMEA 2.3 and later) */
+  NMEALIB_GPRMC_FIELD_COUNT
+} NmeaGPRMCField;
+
 /**
  * Parse a GPRMC sentence
  *
@@ -98,6 +118,17 @@ typedef struct _NmeaGPRMC {
  */
 bool nmeaGPRMCParse(const char *s, const size_t sz, NmeaGPRMC *pack);
 
+/**
+ * Parse a GPRMC sentence, with a validation policy
+ *
+ * @param s The sentence
+ * @param sz The length of the sentence
+ * @param pack Where the result should be stored
+ * @param policy The validation policy
+ * @return True on success
+ */
+bool nmeaGPRMCParsePolicy(const char *s, const size_t sz, NmeaGPRMC *pack, NmeaValidationPolicy policy);
+
 /**
  * Update an unsanitised NmeaInfo structure from a GPRMC packet structure
  *
@@ -114,6 +145,17 @@ void nmeaGPRMCToInfo(const NmeaGPRMC *pack, NmeaInfo *info);
  */
 void nmeaGPRMCFromInfo(const NmeaInfo *info, NmeaGPRMC *pack);
 
+/**
+ * Generate a single field of a GPRMC sentence, including its leading comma(s)
+ *
+ * nmeaGPRMCGenerate generates the prefix, all fields in order and the checksum.
+ *
+ * @param out The formatter
+ * @param pack The NmeaGPRMC structure
+ * @param field The field
+ */
+void nmeaGPRMCGenerateField(NmeaFormatter *out, const NmeaGPRMC *pack, const NmeaGPRMCField field);
+
 /**
  * Generate a GPRMC sentence
  *
@@ -24,6 +24,7 @@
 #define __NMEALIB_GPVTG_H__
 
 #include <nmealib/info.h>
+#include <nmealib/validate.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -88,6 +89,17 @@ typedef struct _NmeaGPVTG {
  */
 bool nmeaGPVTGParse(const char *s, const size_t sz, NmeaGPVTG *pack);
 
+/**
+ * Parse a GPVTG sentence, with a validation policy
+ *
+ * @param s The sentence
+ * @param sz The length of the sentence
+ * @param pack Where the result should be stored
+ * @param policy The validation policy
+ * @return True on success
+ */
+bool nmeaGPVTGParsePolicy(const char *s, const size_t sz, NmeaGPVTG *pack, NmeaValidationPolicy policy);
+
 /**
  * Update an unsanitised NmeaInfo structure from a GPVTG packet structure
  *
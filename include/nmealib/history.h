@@ -0,0 +1,168 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Time-indexed fix history
+ *
+ * A history is a ring buffer of fix records (see NmeaRecord) that is ordered
+ * by time. It holds at most a fixed number of records and, optionally, only
+ * the records that are not older than a maximum age (relative to the newest
+ * record). When the history is full then the oldest record is dropped.
+ *
+ * Records are indexed from 0 (the oldest record) to count - 1 (the newest
+ * record). Looking up a time is a binary search and therefore O(log n).
+ *
+ * Typical use is to feed the history from the parser:
+ *
+ * <pre>
+ *   if (nmeaParserParse(&parser, buf, len, &info)) {
+ *     nmeaHistoryAddInfo(&history, &info);
+ *   }
+ * </pre>
+ */
+
+#ifndef __NMEALIB_HISTORY_H__
+#define __NMEALIB_HISTORY_H__
+
+#include <nmealib/info.h>
+#include <nmealib/record.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Fix history
+ */
+typedef struct _NmeaHistory {
+    NmeaRecord *records;  /**< The ring buffer                                        */
+    size_t      capacity; /**< The size of the ring buffer, in records                */
+    size_t      head;     /**< The ring buffer index of the oldest record             */
+    size_t      count;    /**< The number of records in the history                   */
+    int64_t     maxAge;   /**< The maximum age of a record, in nanoseconds (0 = none) */
+} NmeaHistory;
+
+/**
+ * Initialise a history
+ *
+ * Allocates memory for the ring buffer.
+ *
+ * @param history The history
+ * @param capacity The maximum number of records in the history
+ * @param maxAge The maximum age of a record relative to the newest record,
+ * in nanoseconds. Older records are dropped. Zero disables dropping by age.
+ * @return True on success
+ */
+bool nmeaHistoryInit(NmeaHistory *history, size_t capacity, int64_t maxAge);
+
+/**
+ * Destroy a history
+ *
+ * Frees the memory of the ring buffer.
+ *
+ * @param history The history
+ */
+void nmeaHistoryDestroy(NmeaHistory *history);
+
+/**
+ * Remove all records from a history
+ *
+ * @param history The history
+ */
+void nmeaHistoryClear(NmeaHistory *history);
+
+/**
+ * Add a fix record to a history
+ *
+ * The record must not be older than the newest record in the history. A
+ * record with the same time as the newest record replaces the newest record,
+ * which allows the history to be fed after every parsed sentence of an epoch.
+ *
+ * @param history The history
+ * @param record The fix record
+ * @return True when the record was added, false when it is older than the
+ * newest record
+ */
+bool nmeaHistoryAdd(NmeaHistory *history, const NmeaRecord *record);
+
+/**
+ * Add a fix to a history from a NmeaInfo structure
+ *
+ * @param history The history
+ * @param info The NmeaInfo structure, must have its UTC date and time present
+ * @return True when the fix was added
+ */
+bool nmeaHistoryAddInfo(NmeaHistory *history, const NmeaInfo *info);
+
+/**
+ * Get a fix record from a history
+ *
+ * @param history The history
+ * @param index The index of the record, 0 being the oldest record
+ * @return The fix record, or NULL when the index is out of range
+ */
+const NmeaRecord *nmeaHistoryGet(const NmeaHistory *history, size_t index);
+
+/**
+ * Find the first record in a history that is not older than a time
+ *
+ * @param history The history
+ * @param time The time, in nanoseconds since the UNIX epoch
+ * @return The index of the first record with a time equal to or later than
+ * the time, or the number of records in the history when there is no such
+ * record
+ */
+size_t nmeaHistoryFind(const NmeaHistory *history, int64_t time);
+
+/**
+ * Determine the records in a history that lie in a time range
+ *
+ * Iterate over the range with nmeaHistoryGet(history, *first + i) for i in
+ * [0, count>.
+ *
+ * @param history The history
+ * @param from The start of the range (inclusive), in nanoseconds since the
+ * UNIX epoch
+ * @param to The end of the range (inclusive), in nanoseconds since the UNIX
+ * epoch
+ * @param first The index of the first record in the range
+ * @return The number of records in the range
+ */
+size_t nmeaHistoryRange(const NmeaHistory *history, int64_t from, int64_t to, size_t *first);
+
+/**
+ * Determine the (interpolated) fix at a time
+ *
+ * See nmeaRecordInterpolate for how the fix is interpolated.
+ *
+ * @param history The history
+ * @param time The time, in nanoseconds since the UNIX epoch
+ * @param record The (interpolated) fix record
+ * @return True on success, false when the time is outside of the time range
+ * of the history
+ */
+bool nmeaHistoryInterpolate(const NmeaHistory *history, int64_t time, NmeaRecord *record);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_HISTORY_H__ */
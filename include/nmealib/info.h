@@ -437,6 +437,26 @@ static INLINE void nmeaInfoUnsetPresent(uint32_t *present, NmeaPresence fieldNam
  */
 void nmeaTimeSet(NmeaTime *utc, uint32_t *present, struct timeval *timeval);
 
+/**
+ * Convert a time (date and time) into the number of nanoseconds since the
+ * UNIX epoch (1970-01-01 00:00:00 UTC)
+ *
+ * @param t The time
+ * @return The number of nanoseconds since the UNIX epoch, or 0 when t is NULL
+ */
+int64_t nmeaTimeToEpochNs(const NmeaTime *t);
+
+/**
+ * Convert a number of nanoseconds since the UNIX epoch (1970-01-01 00:00:00
+ * UTC) into a time (date and time)
+ *
+ * The sub-hundredth-second part of the number is truncated.
+ *
+ * @param ns The number of nanoseconds since the UNIX epoch
+ * @param t The time
+ */
+void nmeaTimeFromEpochNs(int64_t ns, NmeaTime *t);
+
 /**
  * Clear an info structure.
  *
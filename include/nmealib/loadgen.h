@@ -0,0 +1,199 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Sustained-rate NMEA load generator
+ *
+ * A load generator invokes a generator and writes the sentences generated
+ * from it (with nmeaSentenceFromInfo) into a file descriptor: a
+ * pseudo-terminal, a Unix socket, a pipe or FIFO, or any descriptor of the
+ * caller. It is a local stand-in for GPS receivers when benchmarking serial
+ * ingest.
+ *
+ * The output is paced by:
+ * - a rate limit in sentences per second and/or bytes per second, averaged
+ *   over the bursts;
+ * - a burst pattern: the sentences of a number of fixes are written back to
+ *   back, after which the load generator waits until the rate limits allow
+ *   the next burst (a receiver typically emits one burst per fix);
+ * - a baud rate: every sentence occupies the emulated serial line for 10 bits
+ *   (start bit, 8 data bits, stop bit) per byte, also within a burst.
+ *
+ * Writes are non-blocking. When the reader does not keep up, the load
+ * generator waits for the descriptor to become writable and accounts the
+ * time as backpressure.
+ *
+ * Writing to a pipe, FIFO or socket whose reader has gone away raises
+ * SIGPIPE, which callers should ignore.
+ *
+ * Load generators are only supported on POSIX systems.
+ */
+
+#ifndef __NMEALIB_LOADGEN_H__
+#define __NMEALIB_LOADGEN_H__
+
+#include <nmealib/generator.h>
+#include <nmealib/info.h>
+#include <nmealib/random.h>
+#include <nmealib/sentence.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The size of the buffer for the name of a pseudo-terminal */
+#define NMEALIB_LOADGEN_PTY_NAME_SIZE (64u)
+
+/**
+ * Load generator configuration
+ */
+typedef struct _NmeaLoadGenConfig {
+    NmeaGeneratorType type;               /**< The type of the generator                                 */
+    NmeaSentence      mask;               /**< The sentences to generate                                 */
+    double            sentencesPerSecond; /**< The rate limit in sentences per second, 0 for no limit    */
+    double            bytesPerSecond;     /**< The rate limit in bytes per second, 0 for no limit        */
+    unsigned int      baud;               /**< The emulated baud rate, 0 for no emulation                */
+    size_t            burstFixes;         /**< The number of fixes per burst, 0 for 1                    */
+    uint64_t          seed;               /**< The seed of the random number generator of the generator */
+} NmeaLoadGenConfig;
+
+/**
+ * Load generator metrics
+ */
+typedef struct _NmeaLoadGenMetrics {
+    uint64_t fixes;              /**< The number of generated fixes                        */
+    uint64_t sentences;          /**< The number of written sentences                      */
+    uint64_t bytes;              /**< The number of written bytes                          */
+    uint64_t bursts;             /**< The number of bursts                                 */
+    uint64_t blocked;            /**< The number of writes that found the output full      */
+    double   blockedSeconds;     /**< The time spent waiting for the output (backpressure) */
+    double   seconds;            /**< The time spent running                               */
+    double   sentencesPerSecond; /**< The achieved rate in sentences per second            */
+    double   bytesPerSecond;     /**< The achieved rate in bytes per second                */
+} NmeaLoadGenMetrics;
+
+/**
+ * Load generator
+ */
+typedef struct _NmeaLoadGen {
+    NmeaLoadGenConfig   config;                              /**< The configuration                             */
+    NmeaInfo            info;                                /**< The info structure of the generator           */
+    NmeaGenerator      *gen;                                 /**< The generator                                 */
+    NmeaRandom          random;                              /**< The random number generator of the generator  */
+    NmeaMallocedBuffer  buf;                                 /**< The buffer for the generated sentences        */
+    int                 fd;                                  /**< The output, -1 when not opened                */
+    bool                ownFd;                               /**< True when the output is closed on destruction */
+    int                 ptySlave;                            /**< The slave of the pseudo-terminal, or -1       */
+    char                ptyName[NMEALIB_LOADGEN_PTY_NAME_SIZE]; /**< The name of the pseudo-terminal            */
+    NmeaLoadGenMetrics  metrics;                             /**< The metrics, accumulated over all runs        */
+} NmeaLoadGen;
+
+/**
+ * Initialise a load generator
+ *
+ * Creates the generator, which is seeded from the configuration.
+ *
+ * @param loadgen The load generator
+ * @param config The configuration
+ * @return True on success
+ */
+bool nmeaLoadGenInit(NmeaLoadGen *loadgen, const NmeaLoadGenConfig *config);
+
+/**
+ * Destroy a load generator
+ *
+ * Closes the output when the load generator opened it.
+ *
+ * @param loadgen The load generator
+ */
+void nmeaLoadGenDestroy(NmeaLoadGen *loadgen);
+
+/**
+ * Write into a file descriptor of the caller
+ *
+ * The descriptor is made non-blocking and is not closed by the load
+ * generator.
+ *
+ * @param loadgen The load generator
+ * @param fd The file descriptor
+ * @return True on success
+ */
+bool nmeaLoadGenOpenFd(NmeaLoadGen *loadgen, int fd);
+
+/**
+ * Write into a path: a FIFO, a (serial) device or a file
+ *
+ * Opening a FIFO blocks until it has a reader.
+ *
+ * @param loadgen The load generator
+ * @param path The path
+ * @return True on success
+ */
+bool nmeaLoadGenOpenPath(NmeaLoadGen *loadgen, const char *path);
+
+/**
+ * Write into a Unix stream socket
+ *
+ * @param loadgen The load generator
+ * @param path The path of the socket to connect to
+ * @return True on success
+ */
+bool nmeaLoadGenOpenUnix(NmeaLoadGen *loadgen, const char *path);
+
+/**
+ * Write into a new pseudo-terminal
+ *
+ * The name of the pseudo-terminal (for the reader to open) is stored in
+ * ptyName. The pseudo-terminal is in raw mode and the load generator keeps it
+ * open, so writes don't fail before a reader opened it.
+ *
+ * @param loadgen The load generator
+ * @return True on success
+ */
+bool nmeaLoadGenOpenPty(NmeaLoadGen *loadgen);
+
+/**
+ * Run a load generator
+ *
+ * Generates and writes sentences until a duration has elapsed or a number of
+ * sentences has been written, whichever comes first.
+ *
+ * @param loadgen The load generator
+ * @param seconds The duration in seconds, 0 for no limit
+ * @param sentences The number of sentences, 0 for no limit
+ * @return True on success, false when no output is opened, when both limits
+ * are 0, or on a write error
+ */
+bool nmeaLoadGenRun(NmeaLoadGen *loadgen, double seconds, uint64_t sentences);
+
+/**
+ * Get the metrics of a load generator
+ *
+ * @param loadgen The load generator
+ * @param metrics The structure in which to store the metrics
+ */
+void nmeaLoadGenMetrics(const NmeaLoadGen *loadgen, NmeaLoadGenMetrics *metrics);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_LOADGEN_H__ */
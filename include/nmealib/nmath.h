@@ -38,6 +38,14 @@ extern "C" {
 #define NMEALIB_EARTH_SEMIMAJORAXIS_M (6356752.3142)
 #define NMEALIB_EARTH_FLATTENING      (1.0 / 298.257223563)
 
+/**
+ * Accuracy modes
+ */
+typedef enum _NmeaMathMode {
+  NMEALIB_MATH_EXACT = 0u, /**< Use the C library        */
+  NMEALIB_MATH_FAST  = 1u  /**< Use fastmath.h           */
+} NmeaMathMode;
+
 /*
  * Degrees and Radians
  */
@@ -159,6 +167,9 @@ double nmeaMathDistance(const NmeaPosition *from, const NmeaPosition *to);
  * The algorithm is described here:
  *   http://www.ngs.noaa.gov/PUBS_LIB/inverse.pdf
  *
+ * It doesn't converge for nearly antipodal positions, see nmeaGeodesicInverse
+ * for a solver that does.
+ *
  * @param from The 'from' position (in radians)
  * @param to The 'to' position (in radians)
  * @param fromAzimuth The azimuth at 'from' position (in radians)
@@ -179,6 +190,29 @@ double nmeaMathDistanceEllipsoid(const NmeaPosition *from, const NmeaPosition *t
  */
 bool nmeaMathMoveFlat(const NmeaPosition *from, NmeaPosition *to, double azimuth, double distance);
 
+/**
+ * Perform a flat (horizontal) move, with a choice of accuracy.
+ *
+ * In NMEALIB_MATH_FAST mode the trigonometric functions are the polynomial
+ * approximations of fastmath.h, which move the position by less than 0.1
+ * micrometre more or less than NMEALIB_MATH_EXACT mode (the C library, like
+ * nmeaMathMoveFlat) from latitudes below 85 degrees, at about two thirds of the
+ * cost. Nearer the poles both modes lose accuracy to the rounding of the arc
+ * sine of the latitude, and the modes differ by up to a few times the error of
+ * the exact mode: micrometres within a degree of a pole, up to a few
+ * centimetres within 0.001 degree. The longitude of a move from a pole is
+ * undefined in both modes.
+ *
+ * @param from The 'from' position (in radians)
+ * @param to The 'to' position (in radians)
+ * @param azimuth Azimuth (in degrees, [0, 359])
+ * @param distance The distance (in km)
+ * @param mode The accuracy mode
+ * @return True on success
+ */
+bool nmeaMathMoveFlatMode(const NmeaPosition *from, NmeaPosition *to, double azimuth, double distance,
+    NmeaMathMode mode);
+
 /**
  * Perform a flat (horizontal) move against the ellipsoid.
  *
@@ -19,6 +19,7 @@
 #define __NMEALIB_PARSER_H__
 
 #include <nmealib/info.h>
+#include <nmealib/validate.h>
 #include <stdbool.h>
 #include <stddef.h>
 
@@ -58,12 +59,16 @@ typedef struct _NmeaParserSentence {
 
 /**
  * parsed NMEA data and frame parser state
+ *
+ * The validation policy is NMEALIB_VALIDATION_STRICT after nmeaParserInit,
+ * it can be changed at any time.
  */
 typedef struct _NmeaParser {
     NmeaParserSentence sentence;
     size_t bufferLength;
     char *buffer;
     size_t bufferSize;
+    NmeaValidationPolicy validation;
 } NmeaParser;
 
 /**
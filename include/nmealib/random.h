@@ -0,0 +1,125 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Fast, seedable pseudo random number generation
+ *
+ * NmeaRandom is an explicit pseudo random number generator state
+ * (xoshiro256**), so that every generator or every thread can use its own
+ * state: there is no hidden global state and no locking, and a seeded state
+ * produces the same sequence on every run and on every platform.
+ *
+ * nmeaRandomJump advances a state by 2^128 numbers, which gives independent,
+ * non-overlapping streams from a single seed (for example one per thread).
+ *
+ * Every thread also has its own state that is seeded from the entropy of the
+ * system on first use, see nmeaRandomThreadState. It is used by nmeaRandom
+ * and by generators that have no state of their own.
+ */
+
+#ifndef __NMEALIB_RANDOM_H__
+#define __NMEALIB_RANDOM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Pseudo random number generator state
+ */
+typedef struct _NmeaRandom {
+  uint64_t s[4]; /**< The state, never all zero */
+} NmeaRandom;
+
+/**
+ * Seed a state
+ *
+ * The seed is expanded into the state with splitmix64, so every seed
+ * (including 0) gives a valid state.
+ *
+ * @param random The state
+ * @param seed The seed
+ */
+void nmeaRandomSeed(NmeaRandom *random, uint64_t seed);
+
+/**
+ * Seed a state from the entropy of the system
+ *
+ * @param random The state
+ */
+void nmeaRandomSeedEntropy(NmeaRandom *random);
+
+/**
+ * Advance a state by 2^128 numbers
+ *
+ * Calling this n times on copies of a seeded state gives n non-overlapping
+ * streams.
+ *
+ * @param random The state
+ */
+void nmeaRandomJump(NmeaRandom *random);
+
+/**
+ * Get the next 64-bit random number
+ *
+ * @param random The state
+ * @return The random number
+ */
+uint64_t nmeaRandomNext(NmeaRandom *random);
+
+/**
+ * Get a random double
+ *
+ * @param random The state
+ * @param min The minimum value of the random number
+ * @param max The maximum value of the random number
+ * @return A random number in the range [min, max)
+ */
+double nmeaRandomDouble(NmeaRandom *random, const double min, const double max);
+
+/**
+ * Fill an array with random doubles
+ *
+ * Generates the raw numbers in blocks and converts every block in a separate
+ * loop without dependencies, which compilers vectorise.
+ *
+ * @param random The state
+ * @param values The array
+ * @param count The number of entries in the array
+ * @param min The minimum value of the random numbers
+ * @param max The maximum value of the random numbers
+ */
+void nmeaRandomFill(NmeaRandom *random, double *values, size_t count, const double min, const double max);
+
+/**
+ * Get the state of the current thread
+ *
+ * The state is seeded from the entropy of the system on first use.
+ *
+ * @return The state of the current thread
+ */
+NmeaRandom *nmeaRandomThreadState(void);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_RANDOM_H__ */
@@ -0,0 +1,131 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Compact fix records
+ *
+ * A fix record holds the part of a NmeaInfo structure that describes a single
+ * fix: time, position, speed, track, DOPs, signal and fix. It does not hold
+ * the satellite tables, which makes it about 25 times smaller than a NmeaInfo
+ * structure and therefore suitable for storing fix histories.
+ *
+ * Fix records always use the same units, regardless of the units of the
+ * NmeaInfo structure they were created from:
+ *
+ * | Field     | Unit                                       |
+ * | :-------- | :----------------------------------------- |
+ * | time      | nanoseconds since the UNIX epoch (UTC)     |
+ * | latitude  | decimal degrees                            |
+ * | longitude | decimal degrees                            |
+ * | elevation | meters                                     |
+ * | speed     | kph                                        |
+ * | track     | degrees true north                         |
+ * | DOPs      | plain DOP (not in meters)                  |
+ */
+
+#ifndef __NMEALIB_RECORD_H__
+#define __NMEALIB_RECORD_H__
+
+#include <nmealib/info.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The NmeaPresence fields that can be present in a fix record */
+#define NMEALIB_RECORD_PRESENT_MASK ( \
+    NMEALIB_PRESENT_UTCDATE | \
+    NMEALIB_PRESENT_UTCTIME | \
+    NMEALIB_PRESENT_SIG | \
+    NMEALIB_PRESENT_FIX | \
+    NMEALIB_PRESENT_PDOP | \
+    NMEALIB_PRESENT_HDOP | \
+    NMEALIB_PRESENT_VDOP | \
+    NMEALIB_PRESENT_LAT | \
+    NMEALIB_PRESENT_LON | \
+    NMEALIB_PRESENT_ELV | \
+    NMEALIB_PRESENT_SPEED | \
+    NMEALIB_PRESENT_TRACK)
+
+/**
+ * Compact fix record
+ */
+typedef struct _NmeaRecord {
+  int64_t  time;      /**< UTC of the fix, in nanoseconds since the UNIX epoch      */
+  double   latitude;  /**< Latitude, in decimal degrees                              */
+  double   longitude; /**< Longitude, in decimal degrees                             */
+  float    elevation; /**< Elevation above/below mean sea level (geoid), in meters   */
+  float    speed;     /**< Speed over the ground in kph                              */
+  float    track;     /**< Track angle in degrees true north                         */
+  float    pdop;      /**< Position Dilution Of Precision                            */
+  float    hdop;      /**< Horizontal Dilution Of Precision                          */
+  float    vdop;      /**< Vertical Dilution Of Precision                            */
+  uint32_t present;   /**< Bit-mask of NmeaPresence fields that are present          */
+  uint8_t  sig;       /**< Signal quality, see NMEALIB_SIG_* signals                 */
+  uint8_t  fix;       /**< Operating mode, see NMEALIB_FIX_* fixes                   */
+} NmeaRecord;
+
+/**
+ * Create a fix record from a NmeaInfo structure
+ *
+ * The NmeaInfo structure must have both its UTC date and UTC time present,
+ * since a fix record without a time is meaningless.
+ *
+ * @param info The NmeaInfo structure (metric or original units)
+ * @param record The fix record
+ * @return True on success, false when the time is not present
+ */
+bool nmeaRecordFromInfo(const NmeaInfo *info, NmeaRecord *record);
+
+/**
+ * Update a NmeaInfo structure from a fix record
+ *
+ * Only the fields that are present in the fix record are updated (in the
+ * units of the NmeaInfo structure), all other fields are left untouched.
+ *
+ * @param record The fix record
+ * @param info The NmeaInfo structure
+ */
+void nmeaRecordToInfo(const NmeaRecord *record, NmeaInfo *info);
+
+/**
+ * Interpolate between two fix records
+ *
+ * Position, elevation, speed and DOPs are interpolated linearly, the track is
+ * interpolated along the shortest arc and the longitude is interpolated
+ * across the anti-meridian when that is shorter. Signal and fix are taken
+ * from the nearest record.
+ *
+ * A field is only present in the result when it is present in both records.
+ *
+ * @param from The earlier fix record
+ * @param to The later fix record
+ * @param time The time at which to interpolate, in [from->time, to->time]
+ * @param record The interpolated fix record
+ * @return True on success, false when the time is outside of the range of
+ * the two records
+ */
+bool nmeaRecordInterpolate(const NmeaRecord *from, const NmeaRecord *to, int64_t time, NmeaRecord *record);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_RECORD_H__ */
@@ -0,0 +1,129 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Incremental sentence generation with a render cache
+ *
+ * A render cache remembers the sentences (and, for GPGGA and GPRMC, the
+ * individual fields) it generated from the previous NmeaInfo structure, so
+ * that generating sentences for a stream of fixes only renders what changed:
+ *
+ * - GPGSA, GPGSV and GPVTG sentences are reused verbatim when the
+ *   information they are generated from did not change, and are regenerated
+ *   completely otherwise. These typically change rarely.
+ * - GPGGA and GPRMC sentences typically change every fix, but only in a few
+ *   fields (time and position). Only the fields that changed are rendered
+ *   again; they are patched into the cached sentence (in place when their
+ *   length did not change) and the checksum is patched by XOR-ing out the
+ *   old field and XOR-ing in the new field.
+ *
+ * The output is identical to that of nmeaSentenceFromInfo.
+ */
+
+#ifndef __NMEALIB_RENDER_H__
+#define __NMEALIB_RENDER_H__
+
+#include <nmealib/gpgga.h>
+#include <nmealib/gpgsa.h>
+#include <nmealib/gpgsv.h>
+#include <nmealib/gprmc.h>
+#include <nmealib/gpvtg.h>
+#include <nmealib/info.h>
+#include <nmealib/sentence.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The size of the cached text of a sentence, longer sentences are not cached */
+#define NMEALIB_RENDER_SENTENCE_SIZE (128u)
+
+/** The size of the cached text of a field, longer fields are not cached */
+#define NMEALIB_RENDER_FIELD_SIZE (32u)
+
+/** The maximum number of fields of a sentence that is cached per field */
+#define NMEALIB_RENDER_FIELDS_MAX (10u)
+
+/**
+ * The cached text of a field
+ */
+typedef struct _NmeaRenderField {
+  char          text[NMEALIB_RENDER_FIELD_SIZE]; /**< The text, including the leading comma(s) */
+  size_t        length;                          /**< The length of the text                    */
+  size_t        offset;                          /**< The offset of the text in the sentence    */
+  unsigned char checksum;                        /**< The XOR of the text                       */
+} NmeaRenderField;
+
+/**
+ * The cached text of a sentence
+ */
+typedef struct _NmeaRenderSentence {
+  char            text[NMEALIB_RENDER_SENTENCE_SIZE]; /**< The text of the sentence                   */
+  size_t          length;                             /**< The length of the text                     */
+  bool            valid;                              /**< True when the text is valid                */
+  unsigned char   checksum;                           /**< The checksum (fields cache only)           */
+  NmeaRenderField fields[NMEALIB_RENDER_FIELDS_MAX];  /**< The fields (fields cache only)             */
+} NmeaRenderSentence;
+
+/**
+ * Render cache
+ */
+typedef struct _NmeaRender {
+  NmeaGPGGA          gpgga;                                     /**< The GPGGA pack of the cached sentence */
+  NmeaGPGSA          gpgsa;                                     /**< The GPGSA pack of the cached sentence */
+  NmeaGPGSV          gpgsv[NMEALIB_GPGSV_MAX_SENTENCES];        /**< The GPGSV packs of the cached sentences */
+  NmeaGPRMC          gprmc;                                     /**< The GPRMC pack of the cached sentence */
+  NmeaGPVTG          gpvtg;                                     /**< The GPVTG pack of the cached sentence */
+  NmeaRenderSentence gpggaText;                                 /**< The cached GPGGA sentence            */
+  NmeaRenderSentence gpgsaText;                                 /**< The cached GPGSA sentence            */
+  NmeaRenderSentence gpgsvText[NMEALIB_GPGSV_MAX_SENTENCES];    /**< The cached GPGSV sentences           */
+  NmeaRenderSentence gprmcText;                                 /**< The cached GPRMC sentence            */
+  NmeaRenderSentence gpvtgText;                                 /**< The cached GPVTG sentence            */
+  size_t             sentencesReused;                           /**< Sentences that were reused verbatim  */
+  size_t             sentencesRendered;                         /**< Sentences that were (partly) rendered */
+  size_t             fieldsRendered;                            /**< Fields that were rendered            */
+} NmeaRender;
+
+/**
+ * Initialise (or reset) a render cache
+ *
+ * @param render The render cache
+ */
+void nmeaRenderInit(NmeaRender *render);
+
+/**
+ * Generate NMEA sentences from a sanitised NmeaInfo structure, rendering only
+ * what changed since the previous call.
+ *
+ * Allocates memory as needed, like nmeaSentenceFromInfo.
+ *
+ * @param render The render cache
+ * @param buf The allocated buffer (do read the comments of NmeaMallocedBuffer)
+ * @param info The sanitised NmeaInfo structure
+ * @param mask The bit-mask of sentences to generate
+ * @return The total length of the generated sentences
+ */
+size_t nmeaRenderFromInfo(NmeaRender *render, NmeaMallocedBuffer *buf, const NmeaInfo *info, const NmeaSentence mask);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_RENDER_H__ */
@@ -0,0 +1,180 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Replay of captured NMEA logs with time-warp playback
+ *
+ * A replay indexes a captured log once: the offset and length of every
+ * sentence, and the time at which it is due, relative to the first sentence.
+ * The time of a sentence is the UTC time of the last GPGGA or GPRMC sentence
+ * up to and including it, so all sentences of one fix are due at the same
+ * time and the original timing between fixes is kept. A UTC time that jumps
+ * back more than 12 hours is taken as a wrap past midnight.
+ *
+ * Sentences are then streamed at a speed: 1.0 plays the log in real time,
+ * 10.0 ten times as fast and 0.0 as fast as possible. Pacing uses absolute
+ * deadlines on the monotonic clock (so errors don't accumulate): the replay
+ * sleeps until just before a deadline and spins for the remainder.
+ *
+ * A looping replay starts over after the last sentence, one (average) fix
+ * interval later, with monotonically increasing deadlines, for soak tests.
+ *
+ * Replays are only supported on POSIX systems.
+ */
+
+#ifndef __NMEALIB_REPLAY_H__
+#define __NMEALIB_REPLAY_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The time before a deadline (in ns) at which a replay stops sleeping and starts spinning */
+#define NMEALIB_REPLAY_SPIN_NS (200000ll)
+
+/**
+ * An indexed sentence of a log
+ */
+typedef struct _NmeaReplaySentence {
+    size_t  offset; /**< The offset of the sentence in the log                             */
+    size_t  length; /**< The length of the sentence, including its line ending           */
+    int64_t time;   /**< The time (in ns) at which the sentence is due, relative to the log */
+} NmeaReplaySentence;
+
+/**
+ * Replay throughput metrics
+ */
+typedef struct _NmeaReplayMetrics {
+    uint64_t sentences;               /**< The number of streamed sentences                              */
+    uint64_t bytes;                   /**< The number of streamed bytes                                  */
+    uint64_t loops;                   /**< The number of completed loops                                 */
+    double   seconds;                 /**< The time from the start to the last streamed sentence         */
+    double   sentencesPerSecond;      /**< The achieved rate in sentences per second                    */
+    double   targetSentencesPerSecond; /**< The rate in sentences per second the log and speed call for, 0 when unpaced */
+    double   maxLateSeconds;          /**< The maximum time a sentence was streamed after its deadline  */
+} NmeaReplayMetrics;
+
+/**
+ * Replay of a log
+ */
+typedef struct _NmeaReplay {
+    char               *log;       /**< The log                                                  */
+    size_t              logSize;   /**< The size of the log                                      */
+    NmeaReplaySentence *sentences; /**< The index of the sentences of the log                    */
+    size_t              count;     /**< The number of sentences                                  */
+    int64_t             period;    /**< The time (in ns) between the starts of 2 loops           */
+
+    double              speed;     /**< The speed, 0.0 for as fast as possible                   */
+    bool                loop;      /**< True to start over after the last sentence               */
+    size_t              index;     /**< The index of the next sentence                           */
+    int64_t             loopTime;  /**< The time (in ns) of the start of the current loop        */
+    int64_t             start;     /**< The monotonic time (in ns) of the start of the replay    */
+    int64_t             last;      /**< The monotonic time (in ns) of the last streamed sentence */
+    int64_t             lastDue;   /**< The deadline (in ns) of the last streamed sentence       */
+    int64_t             maxLate;   /**< The maximum lateness (in ns) of a streamed sentence      */
+    uint64_t            streamed;  /**< The number of streamed sentences                         */
+    uint64_t            bytes;     /**< The number of streamed bytes                             */
+    uint64_t            loops;     /**< The number of completed loops                            */
+} NmeaReplay;
+
+/**
+ * Replay output callback
+ *
+ * @param userData The user data
+ * @param s The sentence, not NUL-terminated
+ * @param len The length of the sentence
+ * @return True to continue, false to stop the replay
+ */
+typedef bool (*NmeaReplayOutput)(void *userData, const char *s, size_t len);
+
+/**
+ * Initialise a replay from a log in memory
+ *
+ * Copies and indexes the log. Lines that do not start with '$' are skipped.
+ *
+ * @param replay The replay
+ * @param log The log
+ * @param size The size of the log
+ * @return True on success, false when the log holds no sentences
+ */
+bool nmeaReplayInit(NmeaReplay *replay, const char *log, size_t size);
+
+/**
+ * Initialise a replay from a log file
+ *
+ * @param replay The replay
+ * @param path The path of the log file
+ * @return True on success
+ */
+bool nmeaReplayOpen(NmeaReplay *replay, const char *path);
+
+/**
+ * Destroy a replay
+ *
+ * @param replay The replay
+ */
+void nmeaReplayDestroy(NmeaReplay *replay);
+
+/**
+ * (Re)start a replay at its first sentence
+ *
+ * Also resets the metrics.
+ *
+ * @param replay The replay
+ * @param speed The speed, 0.0 for as fast as possible
+ * @param loop True to start over after the last sentence
+ */
+void nmeaReplayStart(NmeaReplay *replay, double speed, bool loop);
+
+/**
+ * Wait for the next sentence of a replay to be due
+ *
+ * @param replay The replay
+ * @param s The location in which to store the sentence (not NUL-terminated)
+ * @return The length of the sentence, 0 when the replay has ended
+ */
+size_t nmeaReplayNext(NmeaReplay *replay, const char **s);
+
+/**
+ * Stream the sentences of a replay to an output callback
+ *
+ * @param replay The replay
+ * @param output The output callback
+ * @param userData The user data for the output callback
+ * @param max The maximum number of sentences to stream, 0 for no maximum
+ * @return The number of streamed sentences
+ */
+size_t nmeaReplayRun(NmeaReplay *replay, NmeaReplayOutput output, void *userData, size_t max);
+
+/**
+ * Get the metrics of a replay
+ *
+ * @param replay The replay
+ * @param metrics The structure in which to store the metrics
+ */
+void nmeaReplayMetrics(const NmeaReplay *replay, NmeaReplayMetrics *metrics);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_REPLAY_H__ */
@@ -0,0 +1,127 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Scatter/gather output of generated sentences
+ *
+ * A scatter generates NMEA sentences from a NmeaInfo structure into a
+ * reusable arena and describes every sentence with its own struct iovec, so
+ * that the sentences can be handed to writev or sendmsg without copying them
+ * into per-destination buffers.
+ *
+ * Since every sentence keeps its own iovec, subscribers can take a subset of
+ * the sentences by NmeaSentence mask, again without copying:
+ *
+ * <pre>
+ *   struct iovec iov[NMEALIB_SCATTER_MAX_SENTENCES];
+ *
+ *   if (nmeaScatterFromInfo(&scatter, &info, NMEALIB_SENTENCE_MASK)) {
+ *     writev(allFd, scatter.iov, (int) scatter.count);
+ *     writev(rmcFd, iov, (int) nmeaScatterSelect(&scatter, NMEALIB_SENTENCE_GPRMC, iov, NMEALIB_SCATTER_MAX_SENTENCES));
+ *   }
+ * </pre>
+ *
+ * The arena and the iovec array are only (re)allocated when they are too
+ * small, so a scatter that is reused for every fix stops allocating after
+ * the first few fixes. The iovecs are valid until the next call to
+ * nmeaScatterFromInfo or nmeaScatterDestroy.
+ *
+ * Scatters are only supported on POSIX systems.
+ */
+
+#ifndef __NMEALIB_SCATTER_H__
+#define __NMEALIB_SCATTER_H__
+
+#include <nmealib/gpgsv.h>
+#include <nmealib/info.h>
+#include <nmealib/sentence.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/uio.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The maximum number of sentences that is generated from a NmeaInfo structure */
+#define NMEALIB_SCATTER_MAX_SENTENCES (4u + NMEALIB_GPGSV_MAX_SENTENCES)
+
+/**
+ * Scatter/gather output of generated sentences
+ */
+typedef struct _NmeaScatter {
+    char          *arena;     /**< The arena holding the sentences                    */
+    size_t         arenaSize; /**< The size of the arena                              */
+    struct iovec  *iov;       /**< The iovecs of the sentences, in generation order   */
+    NmeaSentence  *sentences; /**< The type of the sentence of every iovec            */
+    size_t         capacity;  /**< The number of entries in iov and sentences         */
+    size_t         count;     /**< The number of sentences                            */
+    size_t         length;    /**< The total length of the sentences                  */
+} NmeaScatter;
+
+/**
+ * Initialise a scatter
+ *
+ * Nothing is allocated until the first sentences are generated.
+ *
+ * @param scatter The scatter
+ */
+void nmeaScatterInit(NmeaScatter *scatter);
+
+/**
+ * Destroy a scatter
+ *
+ * Frees the arena and the iovecs.
+ *
+ * @param scatter The scatter
+ */
+void nmeaScatterDestroy(NmeaScatter *scatter);
+
+/**
+ * Generate NMEA sentences from a sanitised NmeaInfo structure into a scatter
+ *
+ * The sentences are generated in the same order as nmeaSentenceFromInfo
+ * generates them, every sentence exactly once (unless it exceeds
+ * NMEALIB_SENTENCE_MAX_LENGTH, in which case the arena is grown and only that
+ * sentence is generated once more).
+ *
+ * @param scatter The scatter
+ * @param info The sanitised NmeaInfo structure
+ * @param mask The bit-mask of sentences to generate
+ * @return The number of generated sentences, 0 on failure
+ */
+size_t nmeaScatterFromInfo(NmeaScatter *scatter, const NmeaInfo *info, const NmeaSentence mask);
+
+/**
+ * Select the iovecs of the sentences of a scatter that match a mask
+ *
+ * The iovecs point into the arena of the scatter, no sentences are copied.
+ *
+ * @param scatter The scatter
+ * @param mask The bit-mask of sentences to select
+ * @param iov The array in which to store the selected iovecs
+ * @param iovcnt The number of entries in the array
+ * @return The number of selected iovecs, at most iovcnt
+ */
+size_t nmeaScatterSelect(const NmeaScatter *scatter, const NmeaSentence mask, struct iovec *iov, size_t iovcnt);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_SCATTER_H__ */
@@ -88,6 +88,12 @@ typedef enum _NmeaSentence {
 /** The fixed length of a NMEA prefix */
 #define NMEALIB_PREFIX_LENGTH 5
 
+/**
+ * The maximum length of a NMEA sentence according to the standard, including
+ * the start-of-line character and the CR/LF
+ */
+#define NMEALIB_SENTENCE_MAX_LENGTH (82u)
+
 /**
  * The type definition for an entry mapping a NMEA sentence prefix to a sentence type
  */
@@ -221,10 +227,52 @@ NmeaSentence nmeaSentenceFromPrefix(const char *s, const size_t sz);
  */
 bool nmeaSentenceToInfo(const char *s, const size_t sz, NmeaInfo *info);
 
+/**
+ * Parse a NMEA sentence into an unsanitised NmeaInfo structure, with a
+ * validation policy
+ *
+ * @param s The NMEA sentence
+ * @param sz The length of the NMEA sentence
+ * @param info The unsanitised NmeaInfo structure in which to stored the information
+ * @param policy The validation policy
+ * @return True when successful
+ */
+bool nmeaSentenceToInfoPolicy(const char *s, const size_t sz, NmeaInfo *info, NmeaValidationPolicy policy);
+
+/**
+ * Determine the number of sentences of a type that are generated from a
+ * sanitised NmeaInfo structure.
+ *
+ * This is 1 for all types except GPGSV, which needs a sentence for every
+ * NMEALIB_GPGSV_MAX_SATS_PER_SENTENCE satellites in view (but at least 1).
+ *
+ * @param info The sanitised NmeaInfo structure
+ * @param sentence The sentence type (a single bit)
+ * @return The number of sentences, 0 for unknown types
+ */
+size_t nmeaSentenceCount(const NmeaInfo *info, const NmeaSentence sentence);
+
+/**
+ * Generate a single NMEA sentence from a sanitised NmeaInfo structure.
+ *
+ * @param s The buffer to generate the sentence in
+ * @param sz The size of the buffer
+ * @param info The sanitised NmeaInfo structure
+ * @param sentence The sentence type (a single bit)
+ * @param index The index of the sentence within its type, in
+ * [0, nmeaSentenceCount>. Only relevant for GPGSV.
+ * @return The length of the generated sentence (larger than or equal to sz
+ * when the buffer is too small, like snprintf), 0 for unknown types
+ */
+size_t nmeaSentenceGenerate(char *s, const size_t sz, const NmeaInfo *info, const NmeaSentence sentence,
+    const size_t index);
+
 /**
  * Generate NMEA sentences from a sanitised NmeaInfo structure.
  *
- * Allocates memory as needed.
+ * Allocates memory as needed: the buffer is grown (in chunks of
+ * NMEALIB_BUFFER_CHUNK_SIZE) to nmeaSentenceFromInfoSize before the sentences
+ * are generated, so normally every sentence is generated exactly once.
  *
  * @param buf The allocated buffer (do read the comments of NmeaMallocedBuffer)
  * @param info The sanitised NmeaInfo structure
@@ -233,6 +281,41 @@ bool nmeaSentenceToInfo(const char *s, const size_t sz, NmeaInfo *info);
  */
 size_t nmeaSentenceFromInfo(NmeaMallocedBuffer *buf, const NmeaInfo *info, const NmeaSentence mask);
 
+/**
+ * Determine the buffer size that is needed to generate NMEA sentences from a
+ * sanitised NmeaInfo structure.
+ *
+ * The size is the number of sentences that will be generated times
+ * NMEALIB_SENTENCE_MAX_LENGTH, plus 1 for the terminating null character.
+ * Sentences of well-formed information never exceed the maximum length of the
+ * standard, but nmeaSentenceFromInfoFixed reports it when they do.
+ *
+ * @param info The sanitised NmeaInfo structure
+ * @param mask The bit-mask of sentences to generate
+ * @return The buffer size
+ */
+size_t nmeaSentenceFromInfoSize(const NmeaInfo *info, const NmeaSentence mask);
+
+/**
+ * Generate NMEA sentences from a sanitised NmeaInfo structure into a fixed
+ * buffer.
+ *
+ * Every sentence is generated exactly once and nothing is allocated. Like
+ * snprintf, the return value is the total length of all sentences, also when
+ * they did not fit: the output was truncated when the return value is not
+ * smaller than the size of the buffer. A truncated buffer only holds the
+ * sentences that fitted completely and is always null-terminated (unless its
+ * size is zero).
+ *
+ * @param s The buffer, can be NULL when sz is zero to only determine the
+ * length
+ * @param sz The size of the buffer
+ * @param info The sanitised NmeaInfo structure
+ * @param mask The bit-mask of sentences to generate
+ * @return The total length of the generated sentences
+ */
+size_t nmeaSentenceFromInfoFixed(char *s, const size_t sz, const NmeaInfo *info, const NmeaSentence mask);
+
 #ifdef  __cplusplus
 }
 #endif /* __cplusplus */
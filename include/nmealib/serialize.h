@@ -0,0 +1,185 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Compact, versioned binary encoding of NmeaInfo structures
+ *
+ * The encoding is endian-stable (little-endian) and lossless. A frame
+ * consists of a header followed by the fields that are present in the
+ * NmeaInfo structure, in the order of their NmeaPresence bits:
+ *
+ * | Part            | Encoding                                                 |
+ * | :-------------- | :------------------------------------------------------- |
+ * | magic           | 1 byte, NMEALIB_SERIALIZE_MAGIC                          |
+ * | version         | 1 byte, NMEALIB_SERIALIZE_VERSION                        |
+ * | flags           | 1 byte, bit 0 set when the units are metric              |
+ * | length          | 2 bytes, the length of the frame (including the header)  |
+ * | present         | varint                                                   |
+ * | smask           | varint                                                   |
+ * | utc date        | 2 bytes year, 1 byte month, 1 byte day                   |
+ * | utc time        | 1 byte each for hour, minute, second and hundredths      |
+ * | sig, fix        | 1 byte each                                              |
+ * | doubles         | 8 bytes, IEEE 754                                        |
+ * | counts, dgpsSid | varint                                                   |
+ * | satellites      | 1 byte count, then for each non-empty slot: 1 byte slot  |
+ * |                 | followed by varints for its PRN (in use) or its PRN,     |
+ * |                 | zig-zag elevation, azimuth and SNR (in view)             |
+ *
+ * Decoding can be done into a NmeaInfo structure or, without copying, into
+ * a view on the frame from which individual fields can be read.
+ */
+
+#ifndef __NMEALIB_SERIALIZE_H__
+#define __NMEALIB_SERIALIZE_H__
+
+#include <nmealib/info.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The first byte of a frame */
+#define NMEALIB_SERIALIZE_MAGIC (0x4eu)
+
+/** The version of the encoding */
+#define NMEALIB_SERIALIZE_VERSION (1u)
+
+/** The length of the frame header */
+#define NMEALIB_SERIALIZE_HEADER_SIZE (5u)
+
+/** The number of NmeaPresence fields */
+#define NMEALIB_SERIALIZE_FIELDS (22u)
+
+/** The maximum length of a frame */
+#define NMEALIB_SERIALIZE_MAX_SIZE ( \
+    NMEALIB_SERIALIZE_HEADER_SIZE + \
+    4u /* present */ + \
+    5u /* smask */ + \
+    8u /* utc */ + \
+    2u /* sig, fix */ + \
+    (12u * 8u) /* doubles */ + \
+    (3u * 5u) /* counts, dgpsSid */ + \
+    1u + (NMEALIB_MAX_SATELLITES * (1u + 5u)) /* in use */ + \
+    1u + (NMEALIB_MAX_SATELLITES * (1u + (4u * 5u))) /* in view */)
+
+/**
+ * Zero-copy view on a frame
+ */
+typedef struct _NmeaSerializeView {
+  const uint8_t *buffer;                            /**< The frame                                      */
+  size_t         length;                            /**< The length of the frame                        */
+  bool           metric;                            /**< When true then units are metric                */
+  uint32_t       present;                           /**< Bit-mask of NmeaPresence fields in the frame   */
+  uint16_t       offsets[NMEALIB_SERIALIZE_FIELDS]; /**< The offsets of the fields, by NmeaPresence bit */
+} NmeaSerializeView;
+
+/**
+ * Encode a NmeaInfo structure into a frame
+ *
+ * Only the fields that are present are encoded. The progress information is
+ * not encoded.
+ *
+ * @param info The NmeaInfo structure
+ * @param buffer The buffer in which to store the frame, can be NULL when size
+ * is zero
+ * @param size The size of the buffer
+ * @return The length of the frame, 0 on invalid inputs. When the length is
+ * larger than size then the buffer was too small and its contents are
+ * undefined.
+ */
+size_t nmeaSerializeInfo(const NmeaInfo *info, uint8_t *buffer, size_t size);
+
+/**
+ * Decode a frame into a NmeaInfo structure
+ *
+ * @param buffer The buffer holding the frame
+ * @param size The size of the buffer, can be larger than the frame
+ * @param info The NmeaInfo structure, cleared before decoding
+ * @return The length of the frame, 0 when the frame is invalid or incomplete
+ */
+size_t nmeaDeserializeInfo(const uint8_t *buffer, size_t size, NmeaInfo *info);
+
+/**
+ * Validate a frame and set up a view on it
+ *
+ * The view refers to the buffer, which must therefore remain valid and
+ * unmodified as long as the view is used.
+ *
+ * @param view The view
+ * @param buffer The buffer holding the frame
+ * @param size The size of the buffer, can be larger than the frame
+ * @return The length of the frame, 0 when the frame is invalid or incomplete
+ */
+size_t nmeaSerializeViewInit(NmeaSerializeView *view, const uint8_t *buffer, size_t size);
+
+/**
+ * Get an unsigned integer field from a view
+ *
+ * @param view The view
+ * @param field The field: NMEALIB_PRESENT_SMASK, NMEALIB_PRESENT_SIG,
+ * NMEALIB_PRESENT_FIX, NMEALIB_PRESENT_SATINUSECOUNT,
+ * NMEALIB_PRESENT_SATINVIEWCOUNT or NMEALIB_PRESENT_DGPSSID
+ * @param value The value
+ * @return True when the field is present in the view
+ */
+bool nmeaSerializeViewGetUnsigned(const NmeaSerializeView *view, NmeaPresence field, uint32_t *value);
+
+/**
+ * Get a floating point field from a view
+ *
+ * @param view The view
+ * @param field The field: NMEALIB_PRESENT_PDOP, NMEALIB_PRESENT_HDOP,
+ * NMEALIB_PRESENT_VDOP, NMEALIB_PRESENT_LAT, NMEALIB_PRESENT_LON,
+ * NMEALIB_PRESENT_ELV, NMEALIB_PRESENT_SPEED, NMEALIB_PRESENT_TRACK,
+ * NMEALIB_PRESENT_MTRACK, NMEALIB_PRESENT_MAGVAR, NMEALIB_PRESENT_HEIGHT or
+ * NMEALIB_PRESENT_DGPSAGE
+ * @param value The value
+ * @return True when the field is present in the view
+ */
+bool nmeaSerializeViewGetDouble(const NmeaSerializeView *view, NmeaPresence field, double *value);
+
+/**
+ * Get the UTC date and/or time from a view
+ *
+ * Only the parts that are present in the view are set.
+ *
+ * @param view The view
+ * @param utc The UTC date and/or time
+ * @return True when the date and/or time is present in the view
+ */
+bool nmeaSerializeViewGetTime(const NmeaSerializeView *view, NmeaTime *utc);
+
+/**
+ * Get the satellites from a view
+ *
+ * Only the parts that are present in the view are set.
+ *
+ * @param view The view
+ * @param satellites The satellites
+ * @return True when any satellite information is present in the view
+ */
+bool nmeaSerializeViewGetSatellites(const NmeaSerializeView *view, NmeaSatellites *satellites);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_SERIALIZE_H__ */
@@ -0,0 +1,148 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Streaming track simplification
+ *
+ * A simplifier drops the fix records of a track that are not needed to keep
+ * the track within a cross-track tolerance: every dropped record lies within
+ * the tolerance of the line through the kept records before and after it,
+ * and not more than the tolerance beyond the kept record after it.
+ *
+ * The simplifier is an opening window algorithm that does not store the
+ * records of its window. Instead it keeps the range of directions (seen from
+ * the last kept record, the anchor) in which the window can still be closed:
+ * a record at distance d and azimuth a from the anchor narrows the range to
+ * within asin(tolerance / d) of a. A record outside of the range closes the
+ * window: the record before it is kept and becomes the new anchor. Every
+ * record therefore takes O(1) time and a simplifier takes a fixed amount of
+ * memory, regardless of the length of the track.
+ *
+ * Distances and azimuths from the anchor are measured on a sphere with radius
+ * NMEALIB_EARTHRADIUS_M (like nmeaMathDistance), or on the ellipsoid of
+ * geodesic.h. The cross-track distance is determined in the azimuthal
+ * equidistant projection around the anchor, which on the sphere is never
+ * less than the distance to the great circle.
+ *
+ * Records are kept with a delay of one record, since a record can only be
+ * dropped once the next record is known. Typical use:
+ *
+ * <pre>
+ *   if (nmeaParserParse(&parser, buf, len, &info) //
+ *       && nmeaSimplifierAddInfo(&simplifier, &info, &record)) {
+ *     nmeaTrackAppend(&track, &record);
+ *   }
+ *   ...
+ *   if (nmeaSimplifierFlush(&simplifier, &record)) {
+ *     nmeaTrackAppend(&track, &record);
+ *   }
+ * </pre>
+ */
+
+#ifndef __NMEALIB_SIMPLIFY_H__
+#define __NMEALIB_SIMPLIFY_H__
+
+#include <nmealib/geodesic.h>
+#include <nmealib/info.h>
+#include <nmealib/record.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Distance modes
+ */
+typedef enum _NmeaSimplifyMode {
+  NMEALIB_SIMPLIFY_SPHERICAL   = 0u, /**< Great-circle distances, like nmeaMathDistance */
+  NMEALIB_SIMPLIFY_ELLIPSOIDAL = 1u  /**< Geodesic distances, like geodesic.h          */
+} NmeaSimplifyMode;
+
+/**
+ * Track simplifier
+ */
+typedef struct _NmeaSimplifier {
+    NmeaSimplifyMode   mode;        /**< The distance mode                                             */
+    double             tolerance;   /**< The cross-track tolerance, in meters                          */
+    NmeaGeodesicOrigin anchor;      /**< The last kept record (in radians)                             */
+    double             sinLat;      /**< The sine of the latitude of the anchor                        */
+    double             cosLat;      /**< The cosine of the latitude of the anchor                      */
+    NmeaRecord         candidate;   /**< The last added record                                         */
+    bool               anchored;    /**< True when there is an anchor                                  */
+    bool               pending;     /**< True when the candidate has not been kept                     */
+    bool               constrained; /**< True when the range of directions is restricted               */
+    double             reference;   /**< The azimuth relative to which the range is stored             */
+    double             low;         /**< The start of the range of directions, relative to reference   */
+    double             high;        /**< The end of the range of directions, relative to reference     */
+    double             distanceMax; /**< The largest distance from the anchor in the window, in meters */
+    size_t             added;       /**< The number of records with a position that were added         */
+    size_t             kept;        /**< The number of records that were kept                          */
+} NmeaSimplifier;
+
+/**
+ * Initialise a simplifier
+ *
+ * @param simplifier The simplifier
+ * @param mode The distance mode
+ * @param tolerance The cross-track tolerance in meters, must be positive
+ * @return True on success
+ */
+bool nmeaSimplifierInit(NmeaSimplifier *simplifier, NmeaSimplifyMode mode, double tolerance);
+
+/**
+ * Add a fix record to a simplifier
+ *
+ * Records without a position are ignored. The first record is always kept.
+ *
+ * @param simplifier The simplifier
+ * @param record The fix record
+ * @param kept The location in which to store the record that is kept, which
+ * is an earlier record than the added record (except for the first record)
+ * @return True when a record was kept and stored in kept
+ */
+bool nmeaSimplifierAdd(NmeaSimplifier *simplifier, const NmeaRecord *record, NmeaRecord *kept);
+
+/**
+ * Add a fix to a simplifier from a NmeaInfo structure
+ *
+ * @param simplifier The simplifier
+ * @param info The NmeaInfo structure, must have its UTC date and time present
+ * @param kept The location in which to store the record that is kept
+ * @return True when a record was kept and stored in kept
+ */
+bool nmeaSimplifierAddInfo(NmeaSimplifier *simplifier, const NmeaInfo *info, NmeaRecord *kept);
+
+/**
+ * Keep the last added record of a simplifier, at the end of a track
+ *
+ * The record becomes the anchor, so records can still be added afterwards.
+ *
+ * @param simplifier The simplifier
+ * @param kept The location in which to store the record that is kept
+ * @return True when a record was kept and stored in kept, false when the
+ * last added record was already kept
+ */
+bool nmeaSimplifierFlush(NmeaSimplifier *simplifier, NmeaRecord *kept);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_SIMPLIFY_H__ */
@@ -0,0 +1,203 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * In-memory spatial index of units
+ *
+ * A spatial index holds the latest position of many units (receivers), keyed
+ * by a unit identifier, and answers k-nearest, radius and bounding-box
+ * queries without scanning all units.
+ *
+ * The index is a grid of latitude/longitude cells of (about) a configurable
+ * size. Only the cells that hold units are stored, in a hash table, so the
+ * memory use is proportional to the number of units and not to the number of
+ * cells. Every unit is also stored as a unit vector, so that candidate units
+ * are tested with a few multiplications instead of trigonometric functions.
+ *
+ * Updating the position of a unit is O(1). A query visits the cells that
+ * overlap its area, so it is cheapest with a cell size in the order of the
+ * query radius. A query that would visit more cells than there are units
+ * scans all units instead.
+ *
+ * Distances are great-circle distances on a sphere with radius
+ * NMEALIB_EARTHRADIUS_M, like nmeaMathDistance, but computed from the chord,
+ * so they are also accurate for short distances.
+ *
+ * Typical use is to feed the index from the parsers of the units:
+ *
+ * <pre>
+ *   if (nmeaParserParse(&parser[unit], buf, len, &info)) {
+ *     nmeaSpatialUpdateInfo(index, unit, &info);
+ *   }
+ * </pre>
+ */
+
+#ifndef __NMEALIB_SPATIAL_H__
+#define __NMEALIB_SPATIAL_H__
+
+#include <nmealib/info.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The default cell size in meters */
+#define NMEALIB_SPATIAL_CELL_SIZE_DEFAULT (5000.0)
+
+/** The minimum cell size in meters */
+#define NMEALIB_SPATIAL_CELL_SIZE_MIN (100.0)
+
+/* Forward declaration */
+typedef struct _NmeaSpatial NmeaSpatial;
+
+/**
+ * A query result
+ */
+typedef struct _NmeaSpatialResult {
+    uint64_t id;       /**< The identifier of the unit      */
+    double   distance; /**< The distance in meters          */
+} NmeaSpatialResult;
+
+/**
+ * Create a spatial index
+ *
+ * @param cellSize The (north-south) size of a grid cell in meters, 0 for the
+ * default, at least NMEALIB_SPATIAL_CELL_SIZE_MIN
+ * @return The spatial index, or NULL on failure
+ */
+NmeaSpatial *nmeaSpatialCreate(double cellSize);
+
+/**
+ * Destroy a spatial index
+ *
+ * @param index The spatial index
+ */
+void nmeaSpatialDestroy(NmeaSpatial *index);
+
+/**
+ * Remove all units from a spatial index
+ *
+ * @param index The spatial index
+ */
+void nmeaSpatialClear(NmeaSpatial *index);
+
+/**
+ * Get the number of units in a spatial index
+ *
+ * @param index The spatial index
+ * @return The number of units
+ */
+size_t nmeaSpatialCount(const NmeaSpatial *index);
+
+/**
+ * Add a unit to a spatial index, or update its position
+ *
+ * @param index The spatial index
+ * @param id The identifier of the unit
+ * @param position The position of the unit (in radians)
+ * @return True on success
+ */
+bool nmeaSpatialUpdate(NmeaSpatial *index, uint64_t id, const NmeaPosition *position);
+
+/**
+ * Add a unit to a spatial index, or update its position, from a NmeaInfo
+ * structure
+ *
+ * @param index The spatial index
+ * @param id The identifier of the unit
+ * @param info The NmeaInfo structure, must have its latitude and longitude
+ * present (in NDEG)
+ * @return True on success
+ */
+bool nmeaSpatialUpdateInfo(NmeaSpatial *index, uint64_t id, const NmeaInfo *info);
+
+/**
+ * Remove a unit from a spatial index
+ *
+ * @param index The spatial index
+ * @param id The identifier of the unit
+ * @return True when the unit was removed, false when it is not in the index
+ */
+bool nmeaSpatialRemove(NmeaSpatial *index, uint64_t id);
+
+/**
+ * Get the position of a unit in a spatial index
+ *
+ * @param index The spatial index
+ * @param id The identifier of the unit
+ * @param position The location in which to store the position (in radians)
+ * @return True when the unit is in the index
+ */
+bool nmeaSpatialGet(const NmeaSpatial *index, uint64_t id, NmeaPosition *position);
+
+/**
+ * Find the k units nearest to a position
+ *
+ * @param index The spatial index
+ * @param center The position (in radians)
+ * @param results The array (of k elements) in which to store the nearest
+ * units, nearest first
+ * @param k The number of units to find
+ * @return The number of units found: k, or fewer when there are fewer units
+ * in the index
+ */
+size_t nmeaSpatialNearest(const NmeaSpatial *index, const NmeaPosition *center, NmeaSpatialResult *results,
+    size_t k);
+
+/**
+ * Find the units within a radius of a position
+ *
+ * @param index The spatial index
+ * @param center The position (in radians)
+ * @param radius The radius in meters
+ * @param results The array (of capacity elements) in which to store the
+ * units, in no particular order, may be NULL when capacity is 0
+ * @param capacity The size of the results array
+ * @return The number of units within the radius, which is more than
+ * capacity when not all units could be stored
+ */
+size_t nmeaSpatialRadius(const NmeaSpatial *index, const NmeaPosition *center, double radius,
+    NmeaSpatialResult *results, size_t capacity);
+
+/**
+ * Find the units in a latitude/longitude box
+ *
+ * A box with a western longitude that is larger than its eastern longitude
+ * crosses the antimeridian.
+ *
+ * @param index The spatial index
+ * @param southWest The south-western corner of the box (in radians)
+ * @param northEast The north-eastern corner of the box (in radians)
+ * @param ids The array (of capacity elements) in which to store the
+ * identifiers of the units, in no particular order, may be NULL when capacity
+ * is 0
+ * @param capacity The size of the ids array
+ * @return The number of units in the box, which is more than capacity when
+ * not all units could be stored
+ */
+size_t nmeaSpatialBox(const NmeaSpatial *index, const NmeaPosition *southWest, const NmeaPosition *northEast,
+    uint64_t *ids, size_t capacity);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_SPATIAL_H__ */
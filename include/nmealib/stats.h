@@ -0,0 +1,290 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Running fix statistics
+ *
+ * A statistics accumulator summarises the fixes of a receiver in a fixed
+ * amount of memory, in O(1) time per fix:
+ * - the number of epochs, the fraction of epochs with a fix and the epoch
+ *   rate;
+ * - the mean and the (co)variance of the position and the mean and the
+ *   variance of the elevation, from which CEP and 2DRMS follow;
+ * - quantile sketches of HDOP, PDOP, VDOP and of the SNR of the satellites
+ *   in view.
+ *
+ * The moments are Welford running moments of the east and north offsets (in
+ * meters) from the first position, in a local east-north-up frame: the
+ * offsets are the latitude and longitude differences scaled by the meridian
+ * and prime vertical radii of curvature (WGS84) at the first position. To
+ * first order this is the tangent plane, its error grows with the square of
+ * the spread of the positions (a few millimeters over 100 meters).
+ *
+ * A quantile sketch counts values in buckets of which the bounds grow
+ * geometrically by NMEALIB_SKETCH_GAMMA, which gives quantiles with a relative
+ * error of about 2% between NMEALIB_SKETCH_MIN and NMEALIB_SKETCH_MAX.
+ *
+ * Accumulators (and sketches) are mergeable: merging the accumulators of
+ * shards of a fix stream gives (up to rounding) the accumulator of the whole
+ * stream. The frames of the shards are assumed to differ by a translation
+ * only, which holds when their first positions are close together.
+ *
+ * Typical use:
+ *
+ * <pre>
+ *   if (nmeaParserParse(&parser, buf, len, &info)) {
+ *     nmeaStatsAddInfo(&stats[unit], &info);
+ *   }
+ *   ...
+ *   nmeaStatsFlush(&stats[unit]);
+ *   nmeaStatsMerge(&total, &stats[unit]);
+ *   hdop95 = nmeaSketchQuantile(&total.hdop, 0.95);
+ * </pre>
+ */
+
+#ifndef __NMEALIB_STATS_H__
+#define __NMEALIB_STATS_H__
+
+#include <nmealib/info.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The number of buckets of a quantile sketch */
+#define NMEALIB_SKETCH_BUCKETS (256u)
+
+/** The lower bound of the first bucket of a quantile sketch */
+#define NMEALIB_SKETCH_MIN (0.05)
+
+/** The ratio of the bounds of a bucket of a quantile sketch */
+#define NMEALIB_SKETCH_GAMMA (1.04)
+
+/** The upper bound of the last bucket of a quantile sketch: MIN * GAMMA^BUCKETS */
+#define NMEALIB_SKETCH_MAX (1146.8453679347358)
+
+/**
+ * Quantile sketch
+ */
+typedef struct _NmeaSketch {
+    uint64_t count;                           /**< The number of values                            */
+    uint64_t low;                             /**< The number of values below NMEALIB_SKETCH_MIN   */
+    double   min;                             /**< The smallest value                              */
+    double   max;                             /**< The largest value                               */
+    uint32_t buckets[NMEALIB_SKETCH_BUCKETS]; /**< The number of values per bucket                 */
+} NmeaSketch;
+
+/**
+ * The contributions of an epoch to a fix statistics accumulator
+ */
+typedef struct _NmeaStatsEpoch {
+    bool         timed;                        /**< True when the epoch has a time                      */
+    int64_t      time;                         /**< The time of the epoch, in nanoseconds               */
+    bool         fix;                          /**< True when the epoch has a fix                       */
+    bool         positioned;                   /**< True when the epoch has a position                  */
+    NmeaPosition position;                     /**< The position (in radians)                           */
+    bool         elevated;                     /**< True when the epoch has an elevation                */
+    double       elevation;                    /**< The elevation, in meters                            */
+    double       hdop;                         /**< The HDOP, NaN when not known                        */
+    double       pdop;                         /**< The PDOP, NaN when not known                        */
+    double       vdop;                         /**< The VDOP, NaN when not known                        */
+    size_t       snrs;                         /**< The number of SNRs                                  */
+    unsigned int snr[NMEALIB_MAX_SATELLITES];  /**< The SNRs of the satellites in view                  */
+} NmeaStatsEpoch;
+
+/**
+ * Fix statistics accumulator
+ */
+typedef struct _NmeaStats {
+    uint64_t       epochs;      /**< The number of epochs                                     */
+    uint64_t       fixes;       /**< The number of epochs with a (2D or 3D) fix               */
+    uint64_t       timed;       /**< The number of epochs with a time                         */
+    int64_t        timeFirst;   /**< The time of the first timed epoch, in nanoseconds        */
+    int64_t        timeLast;    /**< The time of the last timed epoch, in nanoseconds         */
+    bool           referenced;  /**< True when the frame has a reference position             */
+    NmeaPosition   reference;   /**< The reference position of the frame (in radians)         */
+    double         eastScale;   /**< Meters per radian of longitude at the reference          */
+    double         northScale;  /**< Meters per radian of latitude at the reference           */
+    uint64_t       positions;   /**< The number of positions                                  */
+    double         east;        /**< The mean east offset, in meters                          */
+    double         north;       /**< The mean north offset, in meters                         */
+    double         m2East;      /**< The sum of squared deviations of the east offset         */
+    double         m2North;     /**< The sum of squared deviations of the north offset        */
+    double         cEastNorth;  /**< The sum of products of deviations of the offsets         */
+    uint64_t       elevations;  /**< The number of elevations                                 */
+    double         elevation;   /**< The mean elevation, in meters                            */
+    double         m2Elevation; /**< The sum of squared deviations of the elevation           */
+    NmeaSketch     hdop;        /**< The HDOP sketch                                          */
+    NmeaSketch     pdop;        /**< The PDOP sketch                                          */
+    NmeaSketch     vdop;        /**< The VDOP sketch                                          */
+    NmeaSketch     snr;         /**< The sketch of the SNR of the satellites in view          */
+    bool           pending;     /**< True when the last epoch is not yet added to the above   */
+    NmeaStatsEpoch epoch;       /**< The last epoch, while pending                            */
+} NmeaStats;
+
+/**
+ * Clear a quantile sketch
+ *
+ * @param sketch The sketch
+ */
+void nmeaSketchClear(NmeaSketch *sketch);
+
+/**
+ * Add a value to a quantile sketch
+ *
+ * @param sketch The sketch
+ * @param value The value, negative and non-finite values are ignored
+ */
+void nmeaSketchAdd(NmeaSketch *sketch, double value);
+
+/**
+ * Merge a quantile sketch into another
+ *
+ * @param sketch The sketch to merge into
+ * @param other The sketch to merge
+ */
+void nmeaSketchMerge(NmeaSketch *sketch, const NmeaSketch *other);
+
+/**
+ * Estimate a quantile of the values of a quantile sketch
+ *
+ * @param sketch The sketch
+ * @param q The quantile, in [0, 1] (0.5 for the median)
+ * @return The estimate, within the smallest and the largest value (which are
+ * exact for q = 0 and q = 1), NaN when the sketch is empty or q is out of
+ * range
+ */
+double nmeaSketchQuantile(const NmeaSketch *sketch, double q);
+
+/**
+ * Clear a fix statistics accumulator
+ *
+ * @param stats The accumulator
+ */
+void nmeaStatsClear(NmeaStats *stats);
+
+/**
+ * Add a fix to a fix statistics accumulator
+ *
+ * An epoch has a fix when its fix is 2D or 3D, or (without a fix) when its
+ * signal is valid. Positions and elevations are only added for epochs with
+ * a fix, and elevations only for 3D fixes (when the fix is present).
+ *
+ * The last epoch is held back until a NmeaInfo structure with a different
+ * time arrives: a NmeaInfo structure with the same time as the last epoch is
+ * a new version of it and replaces it, so that the accumulator can be fed
+ * after every parsed sentence and counts the most complete version of each
+ * epoch. Call nmeaStatsFlush to add the last epoch before reading the
+ * accumulator.
+ *
+ * @param stats The accumulator
+ * @param info The NmeaInfo structure
+ * @return True when the NmeaInfo structure starts a new epoch, false when it
+ * replaces the last epoch (or on invalid input)
+ */
+bool nmeaStatsAddInfo(NmeaStats *stats, const NmeaInfo *info);
+
+/**
+ * Add the last epoch of a fix statistics accumulator, which is held back by
+ * nmeaStatsAddInfo
+ *
+ * @param stats The accumulator
+ */
+void nmeaStatsFlush(NmeaStats *stats);
+
+/**
+ * Merge a fix statistics accumulator into another
+ *
+ * The last epoch of the accumulator to merge is included, that of the
+ * accumulator to merge into stays held back.
+ *
+ * @param stats The accumulator to merge into
+ * @param other The accumulator to merge
+ */
+void nmeaStatsMerge(NmeaStats *stats, const NmeaStats *other);
+
+/**
+ * Get the mean position of a fix statistics accumulator
+ *
+ * @param stats The accumulator
+ * @param mean The location in which to store the mean position (in radians)
+ * @return True on success, false when there are no positions
+ */
+bool nmeaStatsMean(const NmeaStats *stats, NmeaPosition *mean);
+
+/**
+ * Get the (sample) covariance of the positions of a fix statistics
+ * accumulator
+ *
+ * @param stats The accumulator
+ * @param east The location in which to store the variance of the east
+ * offset, in square meters, may be NULL
+ * @param north The location in which to store the variance of the north
+ * offset, in square meters, may be NULL
+ * @param eastNorth The location in which to store the covariance of the
+ * offsets, in square meters, may be NULL
+ * @return True on success, false when there are less than 2 positions
+ */
+bool nmeaStatsCovariance(const NmeaStats *stats, double *east, double *north, double *eastNorth);
+
+/**
+ * Get the circular error probable of a fix statistics accumulator
+ *
+ * The radius around the mean position that holds 50% of the positions,
+ * approximated as 0.5887 times the sum of the principal standard deviations
+ * (within a few percent when the smaller is at least a third of the larger).
+ *
+ * @param stats The accumulator
+ * @return The CEP in meters, NaN when there are less than 2 positions
+ */
+double nmeaStatsCep(const NmeaStats *stats);
+
+/**
+ * Get twice the distance root mean square of a fix statistics accumulator
+ *
+ * @param stats The accumulator
+ * @return The 2DRMS in meters, NaN when there are less than 2 positions
+ */
+double nmeaStatsDrms2(const NmeaStats *stats);
+
+/**
+ * Get the fraction of the epochs of a fix statistics accumulator that have
+ * a fix
+ *
+ * @param stats The accumulator
+ * @return The fraction, in [0, 1], NaN when there are no epochs
+ */
+double nmeaStatsFixRate(const NmeaStats *stats);
+
+/**
+ * Get the epoch rate of a fix statistics accumulator
+ *
+ * @param stats The accumulator
+ * @return The average number of epochs per second, NaN when there are less
+ * than 2 epochs with a time
+ */
+double nmeaStatsEpochRate(const NmeaStats *stats);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_STATS_H__ */
@@ -0,0 +1,220 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Columnar, delta-encoded in-memory track store
+ *
+ * A track stores fix records (see NmeaRecord) of a single receiver in a
+ * compact, columnar form. Records are grouped in blocks of
+ * NMEALIB_TRACK_BLOCK_SIZE records, and every block stores each field in its
+ * own column:
+ *
+ * | Column    | Encoding                                         | Precision  |
+ * | :-------- | :----------------------------------------------- | :--------- |
+ * | time      | delta-of-delta, zig-zag varint                   | 1 ns       |
+ * | present   | XOR with the previous record, varint             | -          |
+ * | sig/fix   | one byte, (sig << 4) \| fix                      | -          |
+ * | latitude  | fixed-point delta, zig-zag varint                | 1e-7 deg   |
+ * | longitude | fixed-point delta, zig-zag varint                | 1e-7 deg   |
+ * | elevation | fixed-point delta, zig-zag varint                | 0.01 m     |
+ * | speed     | fixed-point delta, zig-zag varint                | 0.01 kph   |
+ * | track     | fixed-point delta, zig-zag varint                | 0.01 deg   |
+ * | hdop      | fixed-point delta, zig-zag varint                | 0.01       |
+ *
+ * A value is only stored when it is present in the record. PDOP and VDOP are
+ * not stored. A record with a fix at 1 Hz typically takes about 15 bytes,
+ * which is more than 100 times less than a NmeaInfo structure.
+ *
+ * Every block is independently decodable and has a summary of the time range
+ * and the bounding box of its records, which allows scans by time and/or area
+ * to skip blocks without decoding them.
+ *
+ * Records must be appended in chronological order.
+ */
+
+#ifndef __NMEALIB_TRACK_H__
+#define __NMEALIB_TRACK_H__
+
+#include <nmealib/info.h>
+#include <nmealib/record.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The number of records in a block */
+#define NMEALIB_TRACK_BLOCK_SIZE (256u)
+
+/** The number of columns in a block */
+#define NMEALIB_TRACK_COLUMNS (9u)
+
+/** The NmeaPresence fields that can be present in a track record */
+#define NMEALIB_TRACK_PRESENT_MASK (NMEALIB_RECORD_PRESENT_MASK & ~(NMEALIB_PRESENT_PDOP | NMEALIB_PRESENT_VDOP))
+
+/**
+ * A column of a block
+ */
+typedef struct _NmeaTrackColumn {
+  uint8_t *data;     /**< The encoded values                  */
+  size_t   size;     /**< The number of bytes in use          */
+  size_t   capacity; /**< The number of bytes allocated       */
+} NmeaTrackColumn;
+
+/**
+ * A block of records
+ */
+typedef struct _NmeaTrackBlock {
+  NmeaTrackColumn columns[NMEALIB_TRACK_COLUMNS]; /**< The columns                                     */
+  size_t          count;                          /**< The number of records in the block              */
+  int64_t         timeMin;                        /**< The time of the first record                    */
+  int64_t         timeMax;                        /**< The time of the last record                     */
+  bool            area;                           /**< True when at least one record has a position    */
+  int64_t         latMin;                         /**< The minimum latitude, in 1e-7 degrees           */
+  int64_t         latMax;                         /**< The maximum latitude, in 1e-7 degrees           */
+  int64_t         lonMin;                         /**< The minimum longitude, in 1e-7 degrees          */
+  int64_t         lonMax;                         /**< The maximum longitude, in 1e-7 degrees          */
+} NmeaTrackBlock;
+
+/**
+ * Track store
+ */
+typedef struct _NmeaTrack {
+  NmeaTrackBlock *blocks;                          /**< The blocks, the last block is open for appends */
+  size_t          blockCount;                      /**< The number of blocks in use                    */
+  size_t          blockCapacity;                   /**< The number of blocks allocated                 */
+  size_t          count;                           /**< The number of records in the track             */
+  int64_t         values[NMEALIB_TRACK_COLUMNS];   /**< Encoder state: the previous values             */
+  int64_t         delta;                           /**< Encoder state: the previous time delta         */
+} NmeaTrack;
+
+/**
+ * Track iterator
+ *
+ * Iterates over the records of a track, optionally restricted to a time range
+ * and/or a bounding box. The track must not be modified during iteration.
+ */
+typedef struct _NmeaTrackIterator {
+  const NmeaTrack *track;                         /**< The track                                      */
+  int64_t          from;                          /**< The start of the time range (inclusive)        */
+  int64_t          to;                            /**< The end of the time range (inclusive)          */
+  bool             area;                          /**< True when restricted to a bounding box         */
+  int64_t          latMin;                        /**< The minimum latitude, in 1e-7 degrees          */
+  int64_t          latMax;                        /**< The maximum latitude, in 1e-7 degrees          */
+  int64_t          lonMin;                        /**< The minimum longitude, in 1e-7 degrees         */
+  int64_t          lonMax;                        /**< The maximum longitude, in 1e-7 degrees         */
+  size_t           block;                         /**< The current block                              */
+  size_t           index;                         /**< The index of the next record in the block      */
+  size_t           offsets[NMEALIB_TRACK_COLUMNS]; /**< Decoder state: the offsets in the columns     */
+  int64_t          values[NMEALIB_TRACK_COLUMNS];  /**< Decoder state: the previous values            */
+  int64_t          delta;                         /**< Decoder state: the previous time delta         */
+} NmeaTrackIterator;
+
+/**
+ * Initialise a track
+ *
+ * @param track The track
+ */
+void nmeaTrackInit(NmeaTrack *track);
+
+/**
+ * Destroy a track
+ *
+ * Frees all memory of the track.
+ *
+ * @param track The track
+ */
+void nmeaTrackDestroy(NmeaTrack *track);
+
+/**
+ * Append a fix record to a track
+ *
+ * @param track The track
+ * @param record The fix record, must not be older than the last record in the
+ * track
+ * @return True on success, false when the record is older than the last record
+ * in the track or when out of memory
+ */
+bool nmeaTrackAppend(NmeaTrack *track, const NmeaRecord *record);
+
+/**
+ * Append a fix to a track from a NmeaInfo structure
+ *
+ * @param track The track
+ * @param info The NmeaInfo structure, must have its UTC date and time present
+ * @return True on success
+ */
+bool nmeaTrackAppendInfo(NmeaTrack *track, const NmeaInfo *info);
+
+/**
+ * Determine the memory used by a track
+ *
+ * @param track The track
+ * @return The number of bytes allocated by the track, including the track
+ * structure itself
+ */
+size_t nmeaTrackMemory(const NmeaTrack *track);
+
+/**
+ * Initialise a track iterator
+ *
+ * Blocks that lie completely outside of the time range are skipped without
+ * decoding them.
+ *
+ * @param iterator The iterator
+ * @param track The track
+ * @param from The start of the time range (inclusive), in nanoseconds since
+ * the UNIX epoch. Use INT64_MIN for no start.
+ * @param to The end of the time range (inclusive), in nanoseconds since the
+ * UNIX epoch. Use INT64_MAX for no end.
+ */
+void nmeaTrackIteratorInit(NmeaTrackIterator *iterator, const NmeaTrack *track, int64_t from, int64_t to);
+
+/**
+ * Restrict a track iterator to a bounding box
+ *
+ * Only records with both latitude and longitude present and inside the
+ * bounding box are returned. Blocks whose bounding box does not intersect
+ * the bounding box are skipped without decoding them. A bounding box that
+ * crosses the anti-meridian must be scanned as two bounding boxes.
+ *
+ * @param iterator The (initialised) iterator
+ * @param latMin The minimum latitude, in decimal degrees
+ * @param lonMin The minimum longitude, in decimal degrees
+ * @param latMax The maximum latitude, in decimal degrees
+ * @param lonMax The maximum longitude, in decimal degrees
+ */
+void nmeaTrackIteratorSetArea(NmeaTrackIterator *iterator, double latMin, double lonMin, double latMax,
+    double lonMax);
+
+/**
+ * Get the next record from a track iterator
+ *
+ * @param iterator The iterator
+ * @param record The record
+ * @return True when a record was returned, false at the end of the iteration
+ */
+bool nmeaTrackIteratorNext(NmeaTrackIterator *iterator, NmeaRecord *record);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_TRACK_H__ */
@@ -0,0 +1,215 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Memory-mapped, append-only track file
+ *
+ * A track file stores fix records (see NmeaRecord) of a single receiver in
+ * chronological order. It consists of a header followed by fixed-size
+ * records. All values are stored little-endian.
+ *
+ * Header (NMEALIB_TRACKFILE_HEADER_SIZE bytes):
+ *
+ * | Offset | Size | Field                                         |
+ * | -----: | ---: | :-------------------------------------------- |
+ * |      0 |    8 | magic, NMEALIB_TRACKFILE_MAGIC                |
+ * |      8 |    4 | version, NMEALIB_TRACKFILE_VERSION            |
+ * |     12 |    4 | record size, NMEALIB_TRACKFILE_RECORD_SIZE    |
+ * |     16 |   48 | reserved, zero                                |
+ *
+ * Record (NMEALIB_TRACKFILE_RECORD_SIZE bytes):
+ *
+ * | Offset | Size | Field                                         |
+ * | -----: | ---: | :-------------------------------------------- |
+ * |      0 |    8 | time, nanoseconds since the UNIX epoch        |
+ * |      8 |    8 | latitude, IEEE 754 double                     |
+ * |     16 |    8 | longitude, IEEE 754 double                    |
+ * |     24 |   24 | elevation, speed, track, pdop, hdop and vdop, |
+ * |        |      | IEEE 754 floats                               |
+ * |     48 |    4 | present                                       |
+ * |     52 |    1 | sig                                           |
+ * |     53 |    1 | fix                                           |
+ * |     54 |    6 | reserved, zero                                |
+ * |     60 |    4 | CRC-32 of bytes 0 - 59                        |
+ *
+ * The file is read through a memory map, so records are read without
+ * copying them into a buffer and sequential scans read pages in order.
+ * Seeking by time is a binary search on a sparse in-memory index (every
+ * NMEALIB_TRACKFILE_INDEX_STRIDE-th time, built when opening the file)
+ * followed by a binary search over the records between two index entries.
+ *
+ * A fix can be appended more than once, for example after every parsed
+ * sentence of an epoch: records with the same time are versions of the same
+ * fix, and the last of them is the current one. nmeaTrackFileSeek and
+ * nmeaTrackFileNext only return current records.
+ *
+ * Appends are crash-safe: records are never written in place, and a record is
+ * only valid when it is complete and its CRC matches. When a file is opened
+ * for writing, a partially written record at the end of the file is removed,
+ * as are trailing records with a bad CRC.
+ *
+ * Track files are only supported on POSIX systems.
+ */
+
+#ifndef __NMEALIB_TRACKFILE_H__
+#define __NMEALIB_TRACKFILE_H__
+
+#include <nmealib/info.h>
+#include <nmealib/record.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** The magic at the start of a track file */
+#define NMEALIB_TRACKFILE_MAGIC "NMEATRK"
+
+/** The version of the track file format */
+#define NMEALIB_TRACKFILE_VERSION (1u)
+
+/** The size of the track file header */
+#define NMEALIB_TRACKFILE_HEADER_SIZE (64u)
+
+/** The size of a record in a track file */
+#define NMEALIB_TRACKFILE_RECORD_SIZE (64u)
+
+/** The number of records per entry in the sparse time index */
+#define NMEALIB_TRACKFILE_INDEX_STRIDE (1024u)
+
+/**
+ * Track file
+ */
+typedef struct _NmeaTrackFile {
+  int            fd;            /**< The file descriptor                                  */
+  bool           writable;      /**< True when the file is opened for writing             */
+  const uint8_t *map;           /**< The memory map of the file                           */
+  size_t         mapSize;       /**< The size of the memory map                           */
+  size_t         count;         /**< The number of records in the file, including versions */
+  int64_t       *index;         /**< The sparse time index                                */
+  size_t         indexCount;    /**< The number of entries in the sparse time index       */
+  size_t         indexCapacity; /**< The number of entries allocated                      */
+  int64_t        lastTime;      /**< The time of the last record                          */
+} NmeaTrackFile;
+
+/**
+ * Open a track file
+ *
+ * When opened for writing, the file is created when it does not exist and a
+ * partially written or corrupt tail is removed.
+ *
+ * @param file The track file
+ * @param path The path of the file
+ * @param writable True to open the file for writing (appending)
+ * @return True on success
+ */
+bool nmeaTrackFileOpen(NmeaTrackFile *file, const char *path, bool writable);
+
+/**
+ * Close a track file
+ *
+ * @param file The track file
+ * @return True on success
+ */
+bool nmeaTrackFileClose(NmeaTrackFile *file);
+
+/**
+ * Append a fix record to a track file
+ *
+ * A record with the same time as the last record in the file is a new
+ * version of that fix: it is appended and supersedes the last record, which
+ * stays in the file. This allows the file to be fed after every parsed
+ * sentence of an epoch.
+ *
+ * @param file The track file, opened for writing
+ * @param record The fix record, must not be older than the last record in
+ * the file
+ * @return True on success
+ */
+bool nmeaTrackFileAppend(NmeaTrackFile *file, const NmeaRecord *record);
+
+/**
+ * Append a fix to a track file from a NmeaInfo structure
+ *
+ * @param file The track file, opened for writing
+ * @param info The NmeaInfo structure, must have its UTC date and time present
+ * @return True on success
+ */
+bool nmeaTrackFileAppendInfo(NmeaTrackFile *file, const NmeaInfo *info);
+
+/**
+ * Flush appended records to disk
+ *
+ * @param file The track file, opened for writing
+ * @return True on success
+ */
+bool nmeaTrackFileSync(NmeaTrackFile *file);
+
+/**
+ * Pick up records that were appended to a track file by another process
+ *
+ * @param file The track file
+ * @return True on success
+ */
+bool nmeaTrackFileRefresh(NmeaTrackFile *file);
+
+/**
+ * Get a fix record from a track file
+ *
+ * @param file The track file
+ * @param index The index of the record
+ * @param record The fix record
+ * @return True on success, false when the index is out of range or when the
+ * record is corrupt
+ */
+bool nmeaTrackFileGet(NmeaTrackFile *file, size_t index, NmeaRecord *record);
+
+/**
+ * Find the first current record in a track file that is not older than a
+ * time
+ *
+ * Iterate over a time range with nmeaTrackFileGet and nmeaTrackFileNext from
+ * the returned index until the time of a record is beyond the end of the
+ * range.
+ *
+ * @param file The track file
+ * @param time The time, in nanoseconds since the UNIX epoch
+ * @return The index of the last version of the first fix with a time equal to
+ * or later than the time, or the number of records in the file when there is
+ * no such record
+ */
+size_t nmeaTrackFileSeek(NmeaTrackFile *file, int64_t time);
+
+/**
+ * Find the current record of the fix that follows the fix of a record in a
+ * track file
+ *
+ * @param file The track file
+ * @param index The index of the record (any version of its fix)
+ * @return The index of the last version of the next fix, or the number of
+ * records in the file when there is no such record
+ */
+size_t nmeaTrackFileNext(NmeaTrackFile *file, size_t index);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEALIB_TRACKFILE_H__ */
@@ -45,6 +45,9 @@ extern "C" {
 /** The power-of-2 chunk size of a buffer allocation */
 #define NMEALIB_BUFFER_CHUNK_SIZE (4096UL)
 
+/** The length of the checksum trailer of a NMEA sentence: '*', 2 hex digits, CR and LF */
+#define NMEALIB_CHECKSUM_LENGTH (5u)
+
 /** NaN that is a double (and not a float) */
 #define NaN strtod("NAN()", NULL)
 
@@ -148,7 +151,9 @@ double nmeaStringToDouble(const char *s, const size_t sz);
  *
  * @param s The buffer containing the string
  * @param sz The size of the buffer
- * @param len The length of the string in the buffer
+ * @param len The length of the string in the buffer. When it is not smaller
+ * than the size of the buffer then the string was truncated and nothing is
+ * appended
  * @return The number of printed characters, -1 on error
  */
 int nmeaAppendChecksum(char *s, size_t sz, size_t len);
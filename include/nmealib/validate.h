@@ -34,6 +34,35 @@ typedef struct _NmeaInvalidCharacter {
   const char *description;
 } NmeaInvalidCharacter;
 
+/**
+ * Validation policies of the parser and the sentence parsers
+ *
+ * - NMEALIB_VALIDATION_STRICT: every check. The parser rejects sentences with
+ *   invalid characters (see nmeaValidateIsInvalidCharacter) or a checksum
+ *   that doesn't match, the sentence parsers reject sentences with a wrong
+ *   number of fields, fields that can't be read, and values that are out of
+ *   range: times and dates (nmeaValidateTime, nmeaValidateDate), hemispheres
+ *   (nmeaValidateNSEW), signals, fixes and modes (nmeaValidateSignal,
+ *   nmeaValidateFix, nmeaValidateMode), satellites (nmeaValidateSatellite),
+ *   units, selection modes and statuses.
+ * - NMEALIB_VALIDATION_STRUCTURAL: the checks of the structure of a
+ *   sentence only. Like strict, but values are not range checked: a sentence
+ *   with, say, a time of 25:00 or a hemisphere 'X' is accepted as is.
+ * - NMEALIB_VALIDATION_TRUSTED: the checksum only, for input from trusted
+ *   sources. Like structural, but the parser doesn't check for invalid
+ *   characters either. The number of fields and the GPGSV sentence and
+ *   satellite counts are still checked, since the fields can't be read
+ *   safely without them.
+ *
+ * A sentence that is accepted in strict mode gives the same result in all
+ * modes.
+ */
+typedef enum _NmeaValidationPolicy {
+  NMEALIB_VALIDATION_STRICT     = 0u, /**< Every check                      */
+  NMEALIB_VALIDATION_STRUCTURAL = 1u, /**< No range checks of values        */
+  NMEALIB_VALIDATION_TRUSTED    = 2u  /**< The checksum only                */
+} NmeaValidationPolicy;
+
 /**
  * Determine whether the given character is not allowed in an NMEA string
  *
@@ -0,0 +1,74 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <nmealib/fleet.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void output(void *userData __attribute__((unused)), size_t shard __attribute__((unused)), const char *s,
+    size_t len) {
+  fwrite(s, 1, len, stdout);
+}
+
+int main(int argc, char *argv[]) {
+  NmeaFleetConfig config;
+  NmeaFleetMetrics metrics;
+  NmeaFleet *fleet;
+  size_t ticks;
+
+  if ((argc < 4) //
+      || (argc > 6)) {
+    printf("Usage: %s <units> <threads> <ticks> [<fixes per second> [-]]\n", argv[0]);
+    printf("  Writes the sentences to stdout when the last argument is '-'\n");
+    return 1;
+  }
+
+  memset(&config, 0, sizeof(config));
+  config.units = strtoul(argv[1], NULL, 10);
+  config.threads = strtoul(argv[2], NULL, 10);
+  config.type = NMEALIB_GENERATOR_ROTATE;
+  config.mask = NMEALIB_SENTENCE_GPGGA | NMEALIB_SENTENCE_GPRMC;
+  config.rate = (argc > 4) ?
+      strtod(argv[4], NULL) :
+      0.0;
+  config.seed = 1;
+  config.output = ((argc > 5) && !strcmp(argv[5], "-")) ?
+      output :
+      NULL;
+  ticks = strtoul(argv[3], NULL, 10);
+
+  fleet = nmeaFleetCreate(&config);
+  if (!fleet) {
+    fprintf(stderr, "Could not create a fleet of %s units\n", argv[1]);
+    return 1;
+  }
+
+  if (!nmeaFleetRun(fleet, ticks)) {
+    fprintf(stderr, "Could not run the fleet\n");
+    nmeaFleetDestroy(fleet);
+    return 1;
+  }
+
+  nmeaFleetMetrics(fleet, &metrics);
+  fprintf(stderr, "%llu fixes, %llu bytes, %llu flushes in %.3f s: %.0f fixes/s, %.1f MB/s\n", //
+      (unsigned long long) metrics.fixes, (unsigned long long) metrics.bytes, (unsigned long long) metrics.flushes, //
+      metrics.seconds, metrics.fixesPerSecond, metrics.bytesPerSecond / 1E6);
+
+  nmeaFleetDestroy(fleet);
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <nmealib/loadgen.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+int main(int argc, char *argv[]) {
+  NmeaLoadGenMetrics metrics;
+  NmeaLoadGenConfig config;
+  NmeaLoadGen loadgen;
+  const char *target;
+  double seconds;
+  bool r;
+
+  if ((argc < 3) //
+      || (argc > 6)) {
+    printf("Usage: %s <target> <seconds> [<sentences/s> [<baud> [<fixes per burst>]]]\n", argv[0]);
+    printf("  The target is 'pty' for a new pseudo-terminal, 'unix:<path>' for a Unix socket,\n");
+    printf("  '-' for stdout, or the path of a FIFO or device. Rates and baud of 0 are unlimited\n");
+    return 1;
+  }
+
+  /* a reader that goes away is reported as a write error */
+  signal(SIGPIPE, SIG_IGN);
+
+  memset(&config, 0, sizeof(config));
+  config.type = NMEALIB_GENERATOR_ROTATE;
+  config.mask = NMEALIB_SENTENCE_MASK;
+  config.seed = 1;
+  config.sentencesPerSecond = (argc > 3) ?
+      strtod(argv[3], NULL) :
+      0.0;
+  config.baud = (argc > 4) ?
+      (unsigned int) strtoul(argv[4], NULL, 10) :
+      0;
+  config.burstFixes = (argc > 5) ?
+      strtoul(argv[5], NULL, 10) :
+      1;
+
+  target = argv[1];
+  seconds = strtod(argv[2], NULL);
+
+  if (!nmeaLoadGenInit(&loadgen, &config)) {
+    printf("Invalid configuration\n");
+    return 1;
+  }
+
+  if (!strcmp(target, "pty")) {
+    r = nmeaLoadGenOpenPty(&loadgen);
+    if (r) {
+      fprintf(stderr, "Writing to %s\n", loadgen.ptyName);
+    }
+  } else if (!strncmp(target, "unix:", 5)) {
+    r = nmeaLoadGenOpenUnix(&loadgen, &target[5]);
+  } else if (!strcmp(target, "-")) {
+    r = nmeaLoadGenOpenFd(&loadgen, STDOUT_FILENO);
+  } else {
+    r = nmeaLoadGenOpenPath(&loadgen, target);
+  }
+
+  if (!r) {
+    printf("Could not open %s\n", target);
+    nmeaLoadGenDestroy(&loadgen);
+    return 1;
+  }
+
+  r = nmeaLoadGenRun(&loadgen, seconds, 0);
+
+  nmeaLoadGenMetrics(&loadgen, &metrics);
+  fprintf(stderr, "%llu fixes, %llu sentences, %llu bytes in %llu bursts in %.3f s: %.1f sentences/s, %.1f bytes/s\n",
+      (unsigned long long) metrics.fixes, (unsigned long long) metrics.sentences, (unsigned long long) metrics.bytes,
+      (unsigned long long) metrics.bursts, metrics.seconds, metrics.sentencesPerSecond, metrics.bytesPerSecond);
+  fprintf(stderr, "backpressure: %llu blocked writes, %.3f s\n", (unsigned long long) metrics.blocked,
+      metrics.blockedSeconds);
+
+  nmeaLoadGenDestroy(&loadgen);
+
+  return r ?
+      0 :
+      1;
+}
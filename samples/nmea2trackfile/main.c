@@ -0,0 +1,92 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/info.h>
+#include <nmealib/parser.h>
+#include <nmealib/trackfile.h>
+#include <stdio.h>
+#include <string.h>
+
+int main(int argc, char *argv[]) {
+  NmeaTrackFile trackFile;
+  NmeaRecord first;
+  NmeaRecord last;
+  NmeaInfo info;
+  NmeaParser parser;
+  FILE *file;
+  char buff[2048];
+  size_t sentences = 0;
+  size_t records = 0;
+  size_t i;
+
+  if (argc != 3) {
+    printf("Usage: %s <NMEA log> <track file>\n", argv[0]);
+    return 1;
+  }
+
+  file = fopen(argv[1], "rb");
+  if (!file) {
+    printf("Could not open file %s\n", argv[1]);
+    return 1;
+  }
+
+  if (!nmeaTrackFileOpen(&trackFile, argv[2], true)) {
+    printf("Could not open track file %s\n", argv[2]);
+    fclose(file);
+    return 1;
+  }
+
+  nmeaInfoClear(&info);
+  nmeaParserInit(&parser, 0);
+
+  while (fgets(&buff[0], sizeof(buff), file)) {
+    size_t parsed = nmeaParserParse(&parser, &buff[0], strlen(&buff[0]), &info);
+
+    /* a sentence with the same time as the previous one appends a new version of the last record */
+    if (parsed //
+        && nmeaTrackFileAppendInfo(&trackFile, &info)) {
+      sentences += parsed;
+    }
+  }
+
+  nmeaParserDestroy(&parser);
+  fclose(file);
+
+  nmeaTrackFileSync(&trackFile);
+
+  for (i = nmeaTrackFileSeek(&trackFile, INT64_MIN); i < trackFile.count; i = nmeaTrackFileNext(&trackFile, i)) {
+    records++;
+  }
+
+  printf("%lu sentences, %lu records (%lu fixes)\n", (unsigned long) sentences, (unsigned long) trackFile.count,
+      (unsigned long) records);
+  if (nmeaTrackFileGet(&trackFile, 0, &first) //
+      && nmeaTrackFileGet(&trackFile, trackFile.count - 1, &last)) {
+    NmeaTime utcFirst;
+    NmeaTime utcLast;
+
+    nmeaTimeFromEpochNs(first.time, &utcFirst);
+    nmeaTimeFromEpochNs(last.time, &utcLast);
+    printf("from %04u-%02u-%02u %02u:%02u:%02u.%02u to %04u-%02u-%02u %02u:%02u:%02u.%02u\n", //
+        utcFirst.year, utcFirst.mon, utcFirst.day, utcFirst.hour, utcFirst.min, utcFirst.sec, utcFirst.hsec, //
+        utcLast.year, utcLast.mon, utcLast.day, utcLast.hour, utcLast.min, utcLast.sec, utcLast.hsec);
+  }
+
+  nmeaTrackFileClose(&trackFile);
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <nmealib/replay.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool output(void *userData __attribute__((unused)), const char *s, size_t len) {
+  return fwrite(s, 1, len, stdout) == len;
+}
+
+int main(int argc, char *argv[]) {
+  NmeaReplayMetrics metrics;
+  NmeaReplay replay;
+  double speed;
+  bool loop;
+  size_t max;
+
+  if ((argc < 3) //
+      || (argc > 4)) {
+    printf("Usage: %s <NMEA log> <speed> [<sentences>]\n", argv[0]);
+    printf("  A speed of 0 replays as fast as possible, with a number of sentences the log loops\n");
+    return 1;
+  }
+
+  if (!nmeaReplayOpen(&replay, argv[1])) {
+    printf("Could not open log %s\n", argv[1]);
+    return 1;
+  }
+
+  speed = strtod(argv[2], NULL);
+  max = (argc > 3) ?
+      strtoul(argv[3], NULL, 10) :
+      0;
+  loop = max != 0;
+
+  nmeaReplayStart(&replay, speed, loop);
+  nmeaReplayRun(&replay, output, NULL, max);
+  fflush(stdout);
+
+  nmeaReplayMetrics(&replay, &metrics);
+  fprintf(stderr, "%llu sentences, %llu bytes, %llu loops in %.3f s: %.1f sentences/s (target %.1f), max late %.3f ms\n",
+      (unsigned long long) metrics.sentences, (unsigned long long) metrics.bytes, (unsigned long long) metrics.loops,
+      metrics.seconds, metrics.sentencesPerSecond, metrics.targetSentencesPerSecond, metrics.maxLateSeconds * 1E3);
+
+  nmeaReplayDestroy(&replay);
+
+  return 0;
+}
@@ -0,0 +1,385 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/corpus.h>
+
+#include <nmealib/info.h>
+#include <nmealib/parser.h>
+#include <nmealib/random.h>
+#include <nmealib/util.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The number of mutations */
+#define NMEALIB_CORPUS_MUTATIONS (5u)
+
+/** The time of the first fix of a corpus (2020-01-01 00:00:00 UTC), fixes are 1s apart */
+#define NMEALIB_CORPUS_EPOCH (1577836800l)
+
+/** The hex digits of a checksum */
+static const char nmealibCorpusHex[] = "0123456789ABCDEF";
+
+/**
+ * Mutations of a sentence
+ */
+typedef enum _NmeaCorpusMutation {
+  NMEALIB_CORPUS_INTACT,
+  NMEALIB_CORPUS_TRUNCATE,
+  NMEALIB_CORPUS_BITFLIP,
+  NMEALIB_CORPUS_CHECKSUM,
+  NMEALIB_CORPUS_HEX,
+  NMEALIB_CORPUS_OVERLONG
+} NmeaCorpusMutation;
+
+/**
+ * The state of the generation of a corpus
+ */
+typedef struct _NmeaCorpusState {
+    const NmeaCorpusConfig *config; /**< The configuration          */
+    NmeaRandom              random; /**< The random number generator */
+    NmeaMallocedBuffer     *buf;    /**< The corpus                  */
+    size_t                  length; /**< The length of the corpus    */
+    NmeaCorpusStats         stats;  /**< The statistics              */
+} NmeaCorpusState;
+
+/*
+ * Helpers
+ */
+
+/**
+ * @param state The state
+ * @param n The upper bound, must not be 0
+ * @return A random number in [0, n)
+ */
+static INLINE size_t nmeaCorpusBelow(NmeaCorpusState *state, size_t n) {
+  return (size_t) (nmeaRandomNext(&state->random) % n);
+}
+
+/**
+ * Make sure that the corpus has room for a number of bytes
+ *
+ * @param state The state
+ * @param sz The number of bytes to append
+ * @return A pointer to the end of the corpus, or NULL on failure
+ */
+static char *nmeaCorpusReserve(NmeaCorpusState *state, size_t sz) {
+  NmeaMallocedBuffer *buf = state->buf;
+  size_t needed = state->length + sz;
+  size_t newSize;
+  char *s;
+
+  if (buf->bufferSize < needed) {
+    newSize = MAX(buf->bufferSize * 2, needed);
+    newSize = (newSize + NMEALIB_BUFFER_CHUNK_SIZE - 1) & ~(NMEALIB_BUFFER_CHUNK_SIZE - 1);
+
+    s = realloc(buf->buffer, newSize);
+    if (!s) {
+      /* can't be covered in a test */
+      return NULL;
+    }
+
+    buf->buffer = s;
+    buf->bufferSize = newSize;
+  }
+
+  return &buf->buffer[state->length];
+}
+
+/**
+ * Append bytes to the corpus
+ *
+ * @param state The state
+ * @param s The bytes
+ * @param sz The number of bytes
+ * @return True on success
+ */
+static bool nmeaCorpusAppend(NmeaCorpusState *state, const char *s, size_t sz) {
+  char *dst = nmeaCorpusReserve(state, sz);
+
+  if (!dst) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  memcpy(dst, s, sz);
+  state->length += sz;
+
+  return true;
+}
+
+/**
+ * Pick the mutation of a sentence
+ *
+ * @param state The state
+ * @return The mutation
+ */
+static NmeaCorpusMutation nmeaCorpusPick(NmeaCorpusState *state) {
+  const NmeaCorpusConfig *config = state->config;
+  const double rates[NMEALIB_CORPUS_MUTATIONS] = {
+      config->truncateRate, //
+      config->bitFlipRate, //
+      config->checksumRate, //
+      config->hexRate, //
+      config->overlongRate };
+  double u = nmeaRandomDouble(&state->random, 0.0, 1.0);
+  double cumulative = 0.0;
+  size_t i;
+
+  for (i = 0; i < NMEALIB_CORPUS_MUTATIONS; i++) {
+    cumulative += rates[i];
+    if (u < cumulative) {
+      return (NmeaCorpusMutation) (NMEALIB_CORPUS_TRUNCATE + i);
+    }
+  }
+
+  return NMEALIB_CORPUS_INTACT;
+}
+
+/**
+ * Append a sentence to the corpus, possibly mutated
+ *
+ * @param state The state
+ * @param s The sentence, including its checksum and line ending
+ * @param sz The length of the sentence
+ * @return True on success
+ */
+static bool nmeaCorpusSentence(NmeaCorpusState *state, const char *s, size_t sz) {
+  const char *star = memchr(s, '*', sz);
+  NmeaCorpusMutation mutation = nmeaCorpusPick(state);
+  size_t data = star ?
+      (size_t) (star - s) :
+      0;
+  char *dst;
+
+  state->stats.sentences++;
+
+  /* only sentences of the form $...*hh\r\n can be mutated */
+  if ((data < 2) //
+      || ((data + 5) != sz)) {
+    mutation = NMEALIB_CORPUS_INTACT;
+  }
+
+  switch (mutation) {
+    case NMEALIB_CORPUS_TRUNCATE:
+      state->stats.truncated++;
+      return nmeaCorpusAppend(state, s, 1 + nmeaCorpusBelow(state, sz - 2));
+
+    case NMEALIB_CORPUS_BITFLIP:
+    case NMEALIB_CORPUS_CHECKSUM:
+    case NMEALIB_CORPUS_HEX:
+      dst = nmeaCorpusReserve(state, sz);
+      if (!dst) {
+        /* can't be covered in a test */
+        return false;
+      }
+
+      memcpy(dst, s, sz);
+      state->length += sz;
+
+      if (mutation == NMEALIB_CORPUS_BITFLIP) {
+        /* a data character: the checksum no longer matches */
+        state->stats.bitFlipped++;
+        dst[1 + nmeaCorpusBelow(state, data - 1)] ^= (char) (1u << nmeaCorpusBelow(state, 8));
+      } else if (mutation == NMEALIB_CORPUS_CHECKSUM) {
+        size_t digit = data + 1 + nmeaCorpusBelow(state, 2);
+        const char *hex = strchr(nmealibCorpusHex, dst[digit]);
+        size_t value = hex ?
+            (size_t) (hex - nmealibCorpusHex) :
+            0;
+
+        state->stats.checksums++;
+        dst[digit] = nmealibCorpusHex[(value + 1 + nmeaCorpusBelow(state, 15)) & 0xf];
+      } else {
+        state->stats.badHex++;
+        dst[data + 1 + nmeaCorpusBelow(state, 2)] = (char) ('G' + nmeaCorpusBelow(state, 20));
+      }
+      return true;
+
+    case NMEALIB_CORPUS_OVERLONG: {
+      size_t overlong = state->config->overlongLength ?
+          state->config->overlongLength :
+          NMEALIB_PARSER_SENTENCE_SIZE;
+      size_t padding = (overlong > data) ?
+          (overlong - data) + 1 :
+          1;
+
+      state->stats.overlong++;
+
+      dst = nmeaCorpusReserve(state, sz + padding);
+      if (!dst) {
+        /* can't be covered in a test */
+        return false;
+      }
+
+      /* empty fields, so every character is valid until the buffer overflows */
+      memcpy(dst, s, data);
+      memset(&dst[data], ',', padding);
+      memcpy(&dst[data + padding], star, sz - data);
+      state->length += sz + padding;
+      return true;
+    }
+
+    case NMEALIB_CORPUS_INTACT:
+    default:
+      state->stats.intact++;
+      return nmeaCorpusAppend(state, s, sz);
+  }
+}
+
+/**
+ * Append a block of binary noise to the corpus
+ *
+ * @param state The state
+ * @return True on success
+ */
+static bool nmeaCorpusNoise(NmeaCorpusState *state) {
+  size_t noiseMax = state->config->noiseMax ?
+      state->config->noiseMax :
+      NMEALIB_CORPUS_NOISE_MAX_DEFAULT;
+  size_t sz = 1 + nmeaCorpusBelow(state, noiseMax);
+  char *dst = nmeaCorpusReserve(state, sz);
+  size_t i;
+
+  if (!dst) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  for (i = 0; i < sz; i++) {
+    dst[i] = (char) (nmeaRandomNext(&state->random) >> 56);
+  }
+
+  state->length += sz;
+  state->stats.noiseBlocks++;
+  state->stats.noiseBytes += sz;
+
+  return true;
+}
+
+/*
+ * Public
+ */
+
+void nmeaCorpusConfigGarbage(NmeaCorpusConfig *config, double garbage) {
+  double rate;
+
+  if (!config) {
+    return;
+  }
+
+  garbage = MAX(0.0, MIN(garbage, 1.0));
+  rate = garbage / NMEALIB_CORPUS_MUTATIONS;
+
+  config->truncateRate = rate;
+  config->bitFlipRate = rate;
+  config->checksumRate = rate;
+  config->hexRate = rate;
+  config->overlongRate = rate;
+  config->noiseRate = garbage;
+}
+
+size_t nmeaCorpusGenerate(const NmeaCorpusConfig *config, size_t fixes, NmeaMallocedBuffer *buf,
+    NmeaCorpusStats *stats) {
+  NmeaMallocedBuffer sentences;
+  NmeaCorpusState state;
+  NmeaRandom random;
+  struct timeval time;
+  NmeaGenerator *gen;
+  NmeaInfo info;
+  bool r = true;
+  size_t fix;
+
+  if (stats) {
+    memset(stats, 0, sizeof(*stats));
+  }
+
+  if (!config //
+      || !config->mask //
+      || !fixes //
+      || !buf //
+      || (!buf->buffer && buf->bufferSize) //
+      || (buf->buffer && !buf->bufferSize)) {
+    return 0;
+  }
+
+  nmeaInfoClear(&info);
+  gen = nmeaGeneratorCreate(config->type, &info);
+  if (!gen) {
+    return 0;
+  }
+
+  memset(&state, 0, sizeof(state));
+  state.config = config;
+  state.buf = buf;
+
+  /* separate streams, so the sentences don't depend on the rates */
+  nmeaRandomSeed(&random, config->seed);
+  nmeaGeneratorSetRandom(gen, &random);
+  state.random = random;
+  nmeaRandomJump(&state.random);
+
+  memset(&sentences, 0, sizeof(sentences));
+
+  for (fix = 0; r && (fix < fixes); fix++) {
+    size_t length;
+    size_t offset = 0;
+
+    nmeaGeneratorInvoke(gen, &info);
+
+    /* generators stamp the wall-clock time, which would make the corpus irreproducible */
+    time.tv_sec = NMEALIB_CORPUS_EPOCH + (long) fix;
+    time.tv_usec = 0;
+    nmeaTimeSet(&info.utc, &info.present, &time);
+
+    length = nmeaSentenceFromInfo(&sentences, &info, config->mask);
+    state.stats.fixes++;
+
+    while (r //
+        && (offset < length)) {
+      const char *s = &sentences.buffer[offset];
+      const char *eol = memchr(s, '\n', length - offset);
+      size_t sz = eol ?
+          (size_t) (eol - s) + 1 :
+          length - offset;
+
+      r = nmeaCorpusSentence(&state, s, sz);
+
+      if (r //
+          && (config->noiseRate > 0.0) //
+          && (nmeaRandomDouble(&state.random, 0.0, 1.0) < config->noiseRate)) {
+        r = nmeaCorpusNoise(&state);
+      }
+
+      offset += sz;
+    }
+  }
+
+  free(sentences.buffer);
+  nmeaGeneratorDestroy(gen);
+
+  if (!r) {
+    /* can't be covered in a test */
+    return 0;
+  }
+
+  state.stats.bytes = state.length;
+  if (stats) {
+    *stats = state.stats;
+  }
+
+  return state.length;
+}
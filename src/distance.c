@@ -0,0 +1,262 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/distance.h>
+
+#include <nmealib/fastmath.h>
+#include <nmealib/nmath.h>
+#include <nmealib/util.h>
+#include <math.h>
+
+/**
+ * A function over an array
+ *
+ * @param x The arguments
+ * @param y The array in which to store the values, may be x
+ * @param count The number of arguments
+ */
+typedef void (*NmeaDistanceArrayFunction)(const double *x, double *y, size_t count);
+
+/**
+ * The trigonometric functions of an accuracy mode
+ */
+typedef struct _NmeaDistanceFunctions {
+    NmeaDistanceArrayFunction sin;  /**< The sine      */
+    NmeaDistanceArrayFunction asin; /**< The arc sine  */
+} NmeaDistanceFunctions;
+
+/*
+ * Helpers
+ */
+
+static void nmeaDistanceSinExact(const double *x, double *y, size_t count) {
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    y[i] = sin(x[i]);
+  }
+}
+
+static void nmeaDistanceAsinExact(const double *x, double *y, size_t count) {
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    y[i] = asin(x[i]);
+  }
+}
+
+/**
+ * Get the trigonometric functions of an accuracy mode
+ *
+ * @param mode The accuracy mode
+ * @param functions The structure in which to store the functions
+ */
+static void nmeaDistanceFunctionsGet(NmeaDistanceMode mode, NmeaDistanceFunctions *functions) {
+  switch (mode) {
+    case NMEALIB_DISTANCE_FAST:
+      functions->sin = nmeaFastSinArray;
+      functions->asin = nmeaFastAsinArray;
+      break;
+
+    case NMEALIB_DISTANCE_EXACT:
+    default:
+      functions->sin = nmeaDistanceSinExact;
+      functions->asin = nmeaDistanceAsinExact;
+      break;
+  }
+}
+
+/**
+ * Compute the haversines of the central angles of a block of position pairs
+ *
+ * hav = sin^2(dlat / 2) + cos(lat1) * cos(lat2) * sin^2(dlon / 2), where the
+ * cosines are computed as sines, so that a block takes a single pass of the
+ * sine function over 4 arrays.
+ *
+ * @param a The first positions of the pairs
+ * @param aStride The stride of a: 0 for a single position, 1 for an array
+ * @param b The second positions of the pairs
+ * @param n The number of pairs, at most NMEALIB_DISTANCE_BLOCK
+ * @param functions The trigonometric functions
+ * @param hav The array in which to store the haversines, in [0, 1]
+ */
+static void nmeaDistanceHaversines(const NmeaPosition *a, size_t aStride, const NmeaPosition *b, size_t n,
+    const NmeaDistanceFunctions *functions, double *hav) {
+  double args[4 * NMEALIB_DISTANCE_BLOCK];
+  double *dlat = args;
+  double *dlon = &args[n];
+  double *cosLat1 = &args[2 * n];
+  double *cosLat2 = &args[3 * n];
+  size_t i;
+
+  for (i = 0; i < n; i++) {
+    const NmeaPosition *pa = &a[i * aStride];
+
+    dlat[i] = (b[i].lat - pa->lat) * 0.5;
+    dlon[i] = (b[i].lon - pa->lon) * 0.5;
+    cosLat1[i] = pa->lat + (NMEALIB_PI / 2.0);
+    cosLat2[i] = b[i].lat + (NMEALIB_PI / 2.0);
+  }
+
+  functions->sin(args, args, 4 * n);
+
+  for (i = 0; i < n; i++) {
+    double h = (dlat[i] * dlat[i]) + (cosLat1[i] * cosLat2[i] * dlon[i] * dlon[i]);
+
+    hav[i] = MIN(MAX(h, 0.0), 1.0);
+  }
+}
+
+/**
+ * Complete distances from haversines: 2 R asin(sqrt(hav))
+ *
+ * @param hav The haversines, overwritten
+ * @param n The number of haversines
+ * @param functions The trigonometric functions
+ * @param distances The array in which to store the distances in meters
+ */
+static void nmeaDistanceComplete(double *hav, size_t n, const NmeaDistanceFunctions *functions, double *distances) {
+  size_t i;
+
+  for (i = 0; i < n; i++) {
+    hav[i] = sqrt(hav[i]);
+  }
+
+  functions->asin(hav, distances, n);
+
+  for (i = 0; i < n; i++) {
+    distances[i] *= 2.0 * (double) NMEALIB_EARTHRADIUS_M;
+  }
+}
+
+/*
+ * Public
+ */
+
+bool nmeaDistanceOneToMany(const NmeaPosition *from, const NmeaPosition *to, size_t count, double *distances,
+    NmeaDistanceMode mode) {
+  NmeaDistanceFunctions functions;
+  double hav[NMEALIB_DISTANCE_BLOCK];
+  size_t offset;
+
+  if (!from //
+      || !to //
+      || !distances) {
+    return false;
+  }
+
+  nmeaDistanceFunctionsGet(mode, &functions);
+
+  for (offset = 0; offset < count; offset += NMEALIB_DISTANCE_BLOCK) {
+    size_t n = MIN(count - offset, NMEALIB_DISTANCE_BLOCK);
+
+    nmeaDistanceHaversines(from, 0, &to[offset], n, &functions, hav);
+    nmeaDistanceComplete(hav, n, &functions, &distances[offset]);
+  }
+
+  return true;
+}
+
+double nmeaDistancePath(const NmeaPosition *points, size_t count, double *distances, NmeaDistanceMode mode) {
+  NmeaDistanceFunctions functions;
+  double hav[NMEALIB_DISTANCE_BLOCK];
+  double block[NMEALIB_DISTANCE_BLOCK];
+  double length = 0.0;
+  size_t offset;
+
+  if (!points) {
+    return NaN;
+  }
+
+  if (count < 2) {
+    return 0.0;
+  }
+
+  nmeaDistanceFunctionsGet(mode, &functions);
+
+  for (offset = 0; offset < (count - 1); offset += NMEALIB_DISTANCE_BLOCK) {
+    size_t n = MIN(count - 1 - offset, NMEALIB_DISTANCE_BLOCK);
+    double *d = distances ?
+        &distances[offset] :
+        block;
+    size_t i;
+
+    nmeaDistanceHaversines(&points[offset], 1, &points[offset + 1], n, &functions, hav);
+    nmeaDistanceComplete(hav, n, &functions, d);
+
+    for (i = 0; i < n; i++) {
+      length += d[i];
+    }
+  }
+
+  return length;
+}
+
+bool nmeaDistanceTile(const NmeaPosition *rows, size_t rowCount, const NmeaPosition *columns, size_t columnCount,
+    double *distances, NmeaDistanceMode mode) {
+  size_t row;
+
+  if (!rows //
+      || !columns //
+      || !distances) {
+    return false;
+  }
+
+  for (row = 0; row < rowCount; row++) {
+    nmeaDistanceOneToMany(&rows[row], columns, columnCount, &distances[row * columnCount], mode);
+  }
+
+  return true;
+}
+
+size_t nmeaDistanceNearest(const NmeaPosition *from, const NmeaPosition *to, size_t count, double *distance,
+    NmeaDistanceMode mode) {
+  NmeaDistanceFunctions functions;
+  double hav[NMEALIB_DISTANCE_BLOCK];
+  double best = 2.0;
+  size_t nearest = count;
+  size_t offset;
+
+  if (!from //
+      || !to) {
+    return count;
+  }
+
+  nmeaDistanceFunctionsGet(mode, &functions);
+
+  /* the haversine increases monotonically with the distance */
+  for (offset = 0; offset < count; offset += NMEALIB_DISTANCE_BLOCK) {
+    size_t n = MIN(count - offset, NMEALIB_DISTANCE_BLOCK);
+    size_t i;
+
+    nmeaDistanceHaversines(from, 0, &to[offset], n, &functions, hav);
+
+    for (i = 0; i < n; i++) {
+      if (hav[i] < best) {
+        best = hav[i];
+        nearest = offset + i;
+      }
+    }
+  }
+
+  if (distance //
+      && (nearest < count)) {
+    nmeaDistanceComplete(&best, 1, &functions, distance);
+  }
+
+  return nearest;
+}
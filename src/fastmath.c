@@ -0,0 +1,465 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/fastmath.h>
+
+#include <nmealib/util.h>
+#include <math.h>
+#include <stdbool.h>
+
+#ifndef NMEALIB_NO_SSE2
+  #if defined(__SSE2__) || defined(_M_X64)
+    #define NMEALIB_FASTMATH_SSE2
+    #include <emmintrin.h>
+  #endif
+#endif
+
+#define NMEALIB_FASTMATH_PI         (3.14159265358979323846)
+#define NMEALIB_FASTMATH_HALF_PI    (1.57079632679489661923)
+#define NMEALIB_FASTMATH_INV_TWO_PI (0.159154943091895335769)
+
+/**
+ * 2 pi, split in 3 parts for an accurate argument reduction: the first 2 parts
+ * have 30 significant bits, so that their products with a multiple below 2^23
+ * are exact
+ */
+#define NMEALIB_FASTMATH_TWO_PI_HI  (6.283185303211212)
+#define NMEALIB_FASTMATH_TWO_PI_MID (3.9683743166540886e-09)
+#define NMEALIB_FASTMATH_TWO_PI_LO  (2.068073192717642e-18)
+
+/** The number of coefficients of the sine polynomial */
+#define NMEALIB_FASTMATH_SIN_TERMS  (8u)
+
+/** The number of coefficients of the arc sine polynomial */
+#define NMEALIB_FASTMATH_ASIN_TERMS (12u)
+
+/** The number of coefficients of the arc tangent polynomial */
+#define NMEALIB_FASTMATH_ATAN_TERMS (10u)
+
+/** tan(pi/8), the bound of the reduced arc tangent argument */
+#define NMEALIB_FASTMATH_TAN_EIGHTH_PI (0.41421356237309504880)
+
+/**
+ * sin(x) = x + x^3 * P(x^2) on [-pi/2, pi/2]: P interpolates
+ * (sin(sqrt(z)) - sqrt(z)) / z^1.5 at 8 Chebyshev nodes on [0, pi^2/4]
+ */
+static const double nmealibFastSinCoefficients[NMEALIB_FASTMATH_SIN_TERMS] = {
+    -0.16666666666666666, //
+    0.008333333333333316, //
+    -0.00019841269841254974, //
+    2.7557319219163234e-06, //
+    -2.5052107616996182e-08, //
+    1.6058977312464087e-10, //
+    -7.643970296798572e-13, //
+    2.7314447669863995e-15 };
+
+/**
+ * asin(x) = x + x^3 * P(x^2) on [-0.5, 0.5]: P interpolates
+ * (asin(sqrt(z)) - sqrt(z)) / z^1.5 at 12 Chebyshev nodes on [0, 0.25]
+ */
+static const double nmealibFastAsinCoefficients[NMEALIB_FASTMATH_ASIN_TERMS] = {
+    0.1666666666666665, //
+    0.07500000000020764, //
+    0.044642857103423646, //
+    0.03038194736709848, //
+    0.02237204763174451, //
+    0.017355259955786323, //
+    0.013929652902326633, //
+    0.011875494382636922, //
+    0.0078029494773533175, //
+    0.01603551434914882, //
+    -0.010749050339697808, //
+    0.028169218060881414 };
+
+/**
+ * atan(x) = x + x^3 * P(x^2) on [-tan(pi/8), tan(pi/8)]: P interpolates
+ * (atan(sqrt(z)) - sqrt(z)) / z^1.5 at 10 Chebyshev nodes on [0, tan^2(pi/8)]
+ */
+static const double nmealibFastAtanCoefficients[NMEALIB_FASTMATH_ATAN_TERMS] = {
+    -0.3333333333333325, //
+    0.19999999999898407, //
+    -0.1428571426609662, //
+    0.11111109636534361, //
+    -0.09090852557176049, //
+    0.0769105515839315, //
+    -0.06649613695291669, //
+    0.05736332165907643, //
+    -0.04483334622272886, //
+    0.02275052699336167 };
+
+/*
+ * Scalar
+ */
+
+/**
+ * Round to the nearest integer, like nearbyint
+ *
+ * With SSE2 this is a single conversion to a 32-bit integer instead of a
+ * library call, which is why arguments beyond 2^31 turns are undefined.
+ *
+ * @param x The value
+ * @return The rounded value
+ */
+static INLINE double nmeaFastRound(double x) {
+#ifdef NMEALIB_FASTMATH_SSE2
+  return _mm_cvtsd_f64(_mm_cvtepi32_pd(_mm_cvtpd_epi32(_mm_set_sd(x))));
+#else
+  return nearbyint(x);
+#endif
+}
+
+/**
+ * Reduce an angle plus an offset to [-pi/2, pi/2], keeping its sine
+ *
+ * The offset is added after the reduction, so that it doesn't round away the
+ * low bits of large angles.
+ *
+ * @param x The angle
+ * @param quarters The offset in quarter turns, 0 or 1
+ * @return The reduced angle
+ */
+static INLINE double nmeaFastSinReduce(double x, double quarters) {
+  double k = nmeaFastRound((x * NMEALIB_FASTMATH_INV_TWO_PI) + (quarters * 0.25));
+  double r = ((x - (k * NMEALIB_FASTMATH_TWO_PI_HI)) - (k * NMEALIB_FASTMATH_TWO_PI_MID))
+      - (k * NMEALIB_FASTMATH_TWO_PI_LO);
+
+  r += quarters * NMEALIB_FASTMATH_HALF_PI;
+
+  /* sin(r) = sin(pi - r) = sin(-pi - r) */
+  r = MIN(r, NMEALIB_FASTMATH_PI - r);
+  r = MAX(r, -NMEALIB_FASTMATH_PI - r);
+
+  return r;
+}
+
+/**
+ * Evaluate a pair of polynomial terms: c[i] + c[i+1] * z
+ *
+ * @param c The coefficients
+ * @param i The index of the first term
+ * @param z The argument
+ * @return The value
+ */
+static INLINE double nmeaFastPair(const double *c, size_t i, double z) {
+  return c[i] + (c[i + 1] * z);
+}
+
+/*
+ * The polynomials are evaluated with Estrin's scheme, in pairs of terms and
+ * powers of z, which keeps their dependency chains short.
+ */
+
+/**
+ * Evaluate sin(x) = x + x^3 * P(x^2) on [-pi/2, pi/2]
+ *
+ * @param x The argument
+ * @return The value
+ */
+static INLINE double nmeaFastSinPolynomial(double x) {
+  const double *c = nmealibFastSinCoefficients;
+  double z = x * x;
+  double z2 = z * z;
+  double z4 = z2 * z2;
+  double p = (nmeaFastPair(c, 0, z) + (z2 * nmeaFastPair(c, 2, z))) //
+      + (z4 * (nmeaFastPair(c, 4, z) + (z2 * nmeaFastPair(c, 6, z))));
+
+  return x + (x * z * p);
+}
+
+/**
+ * Evaluate asin(x) = x + x^3 * P(x^2) on [-0.5, 0.5]
+ *
+ * @param x The argument
+ * @return The value
+ */
+static INLINE double nmeaFastAsinPolynomial(double x) {
+  const double *c = nmealibFastAsinCoefficients;
+  double z = x * x;
+  double z2 = z * z;
+  double z4 = z2 * z2;
+  double z8 = z4 * z4;
+  double p = (nmeaFastPair(c, 0, z) + (z2 * nmeaFastPair(c, 2, z))) //
+      + (z4 * (nmeaFastPair(c, 4, z) + (z2 * nmeaFastPair(c, 6, z)))) //
+      + (z8 * (nmeaFastPair(c, 8, z) + (z2 * nmeaFastPair(c, 10, z))));
+
+  return x + (x * z * p);
+}
+
+/**
+ * Evaluate atan(x) = x + x^3 * P(x^2) on [-tan(pi/8), tan(pi/8)]
+ *
+ * @param x The argument
+ * @return The value
+ */
+static INLINE double nmeaFastAtanPolynomial(double x) {
+  const double *c = nmealibFastAtanCoefficients;
+  double z = x * x;
+  double z2 = z * z;
+  double z4 = z2 * z2;
+  double z8 = z4 * z4;
+  double p = (nmeaFastPair(c, 0, z) + (z2 * nmeaFastPair(c, 2, z))) //
+      + (z4 * (nmeaFastPair(c, 4, z) + (z2 * nmeaFastPair(c, 6, z)))) //
+      + (z8 * nmeaFastPair(c, 8, z));
+
+  return x + (x * z * p);
+}
+
+double nmeaFastSin(double x) {
+  return nmeaFastSinPolynomial(nmeaFastSinReduce(x, 0.0));
+}
+
+double nmeaFastCos(double x) {
+  /* cos(x) = sin(x + pi/2) */
+  return nmeaFastSinPolynomial(nmeaFastSinReduce(x, 1.0));
+}
+
+void nmeaFastSinCos(double x, double *s, double *c) {
+  double k = nmeaFastRound(x * NMEALIB_FASTMATH_INV_TWO_PI);
+  double r = ((x - (k * NMEALIB_FASTMATH_TWO_PI_HI)) - (k * NMEALIB_FASTMATH_TWO_PI_MID))
+      - (k * NMEALIB_FASTMATH_TWO_PI_LO);
+
+  /* r is in [-pi, pi]: cos(r) = sin(pi/2 - |r|), sin(r) = sin(pi - r) = sin(-pi - r) */
+  *c = nmeaFastSinPolynomial(NMEALIB_FASTMATH_HALF_PI - fabs(r));
+  r = MIN(r, NMEALIB_FASTMATH_PI - r);
+  r = MAX(r, -NMEALIB_FASTMATH_PI - r);
+  *s = nmeaFastSinPolynomial(r);
+}
+
+double nmeaFastAsin(double x) {
+  double a = fabs(x);
+  bool big = a > 0.5;
+  double t = big ?
+      sqrt((1.0 - a) * 0.5) :
+      a;
+  double p = nmeaFastAsinPolynomial(t);
+
+  if (big) {
+    p = NMEALIB_FASTMATH_HALF_PI - (2.0 * p);
+  }
+
+  return copysign(p, x);
+}
+
+double nmeaFastAtan2(double y, double x) {
+  double ax = fabs(x);
+  double ay = fabs(y);
+  double hi = MAX(ax, ay);
+  double t = (hi > 0.0) ?
+      (MIN(ax, ay) / hi) :
+      0.0;
+  bool big = t > NMEALIB_FASTMATH_TAN_EIGHTH_PI;
+  double a;
+
+  if (isnan(x) //
+      || isnan(y)) {
+    return x + y;
+  }
+
+  /* atan(t) = pi/4 + atan((t - 1) / (t + 1)) */
+  a = big ?
+      ((NMEALIB_FASTMATH_PI / 4.0) + nmeaFastAtanPolynomial((t - 1.0) / (t + 1.0))) :
+      nmeaFastAtanPolynomial(t);
+
+  if (ay > ax) {
+    a = NMEALIB_FASTMATH_HALF_PI - a;
+  }
+  if (signbit(x)) {
+    a = NMEALIB_FASTMATH_PI - a;
+  }
+
+  return copysign(a, y);
+}
+
+/*
+ * SSE2
+ */
+
+#ifdef NMEALIB_FASTMATH_SSE2
+
+/**
+ * Evaluate a pair of polynomial terms on 2 values: c[i] + c[i+1] * z
+ *
+ * @param c The coefficients
+ * @param i The index of the first term
+ * @param z The arguments
+ * @return The values
+ */
+static INLINE __m128d nmeaFastPair2(const double *c, size_t i, __m128d z) {
+  return _mm_add_pd(_mm_set1_pd(c[i]), _mm_mul_pd(_mm_set1_pd(c[i + 1]), z));
+}
+
+/**
+ * Evaluate a + b * c on 2 values
+ *
+ * @param a The addends
+ * @param b The multipliers
+ * @param c The multiplicands
+ * @return The values
+ */
+static INLINE __m128d nmeaFastMulAdd2(__m128d a, __m128d b, __m128d c) {
+  return _mm_add_pd(a, _mm_mul_pd(b, c));
+}
+
+/**
+ * Evaluate sin(x) = x + x^3 * P(x^2) on [-pi/2, pi/2] on 2 values
+ *
+ * @param x The arguments
+ * @return The values
+ */
+static INLINE __m128d nmeaFastSinPolynomial2(__m128d x) {
+  const double *c = nmealibFastSinCoefficients;
+  __m128d z = _mm_mul_pd(x, x);
+  __m128d z2 = _mm_mul_pd(z, z);
+  __m128d z4 = _mm_mul_pd(z2, z2);
+  __m128d p = nmeaFastMulAdd2( //
+      nmeaFastMulAdd2(nmeaFastPair2(c, 0, z), z2, nmeaFastPair2(c, 2, z)), //
+      z4, //
+      nmeaFastMulAdd2(nmeaFastPair2(c, 4, z), z2, nmeaFastPair2(c, 6, z)));
+
+  return nmeaFastMulAdd2(x, _mm_mul_pd(x, z), p);
+}
+
+/**
+ * Evaluate asin(x) = x + x^3 * P(x^2) on [-0.5, 0.5] on 2 values
+ *
+ * @param x The arguments
+ * @return The values
+ */
+static INLINE __m128d nmeaFastAsinPolynomial2(__m128d x) {
+  const double *c = nmealibFastAsinCoefficients;
+  __m128d z = _mm_mul_pd(x, x);
+  __m128d z2 = _mm_mul_pd(z, z);
+  __m128d z4 = _mm_mul_pd(z2, z2);
+  __m128d z8 = _mm_mul_pd(z4, z4);
+  __m128d p = _mm_add_pd( //
+      nmeaFastMulAdd2( //
+          nmeaFastMulAdd2(nmeaFastPair2(c, 0, z), z2, nmeaFastPair2(c, 2, z)), //
+          z4, //
+          nmeaFastMulAdd2(nmeaFastPair2(c, 4, z), z2, nmeaFastPair2(c, 6, z))), //
+      _mm_mul_pd(z8, nmeaFastMulAdd2(nmeaFastPair2(c, 8, z), z2, nmeaFastPair2(c, 10, z))));
+
+  return nmeaFastMulAdd2(x, _mm_mul_pd(x, z), p);
+}
+
+/**
+ * Sine of 2 angles plus an offset
+ *
+ * @param x The angles
+ * @param quarters The offset in quarter turns, 0 or 1
+ * @return The sines
+ */
+static INLINE __m128d nmeaFastSin2(__m128d x, double quarters) {
+  /* rounds to nearest, like nearbyint */
+  __m128d k = _mm_cvtepi32_pd(_mm_cvtpd_epi32(_mm_add_pd( //
+      _mm_mul_pd(x, _mm_set1_pd(NMEALIB_FASTMATH_INV_TWO_PI)), //
+      _mm_set1_pd(quarters * 0.25))));
+  __m128d r = _mm_sub_pd( //
+      _mm_sub_pd( //
+          _mm_sub_pd(x, _mm_mul_pd(k, _mm_set1_pd(NMEALIB_FASTMATH_TWO_PI_HI))), //
+          _mm_mul_pd(k, _mm_set1_pd(NMEALIB_FASTMATH_TWO_PI_MID))), //
+      _mm_mul_pd(k, _mm_set1_pd(NMEALIB_FASTMATH_TWO_PI_LO)));
+
+  r = _mm_add_pd(r, _mm_set1_pd(quarters * NMEALIB_FASTMATH_HALF_PI));
+
+  r = _mm_min_pd(r, _mm_sub_pd(_mm_set1_pd(NMEALIB_FASTMATH_PI), r));
+  r = _mm_max_pd(r, _mm_sub_pd(_mm_set1_pd(-NMEALIB_FASTMATH_PI), r));
+
+  return nmeaFastSinPolynomial2(r);
+}
+
+/**
+ * Arc sine of 2 values
+ *
+ * @param x The values
+ * @return The arc sines
+ */
+static INLINE __m128d nmeaFastAsin2(__m128d x) {
+  __m128d sign = _mm_set1_pd(-0.0);
+  __m128d a = _mm_andnot_pd(sign, x);
+  __m128d big = _mm_cmpgt_pd(a, _mm_set1_pd(0.5));
+  __m128d reduced = _mm_sqrt_pd(_mm_mul_pd(_mm_sub_pd(_mm_set1_pd(1.0), a), _mm_set1_pd(0.5)));
+  __m128d t = _mm_or_pd(_mm_and_pd(big, reduced), _mm_andnot_pd(big, a));
+  __m128d p = nmeaFastAsinPolynomial2(t);
+  __m128d q = _mm_sub_pd(_mm_set1_pd(NMEALIB_FASTMATH_HALF_PI), _mm_add_pd(p, p));
+
+  p = _mm_or_pd(_mm_and_pd(big, q), _mm_andnot_pd(big, p));
+
+  return _mm_or_pd(p, _mm_and_pd(sign, x));
+}
+
+#endif /* NMEALIB_FASTMATH_SSE2 */
+
+/*
+ * Arrays
+ */
+
+void nmeaFastSinArray(const double *x, double *y, size_t count) {
+  size_t i = 0;
+
+  if (!x //
+      || !y) {
+    return;
+  }
+
+#ifdef NMEALIB_FASTMATH_SSE2
+  for (; (i + 2) <= count; i += 2) {
+    _mm_storeu_pd(&y[i], nmeaFastSin2(_mm_loadu_pd(&x[i]), 0.0));
+  }
+#endif
+
+  for (; i < count; i++) {
+    y[i] = nmeaFastSin(x[i]);
+  }
+}
+
+void nmeaFastCosArray(const double *x, double *y, size_t count) {
+  size_t i = 0;
+
+  if (!x //
+      || !y) {
+    return;
+  }
+
+#ifdef NMEALIB_FASTMATH_SSE2
+  for (; (i + 2) <= count; i += 2) {
+    _mm_storeu_pd(&y[i], nmeaFastSin2(_mm_loadu_pd(&x[i]), 1.0));
+  }
+#endif
+
+  for (; i < count; i++) {
+    y[i] = nmeaFastCos(x[i]);
+  }
+}
+
+void nmeaFastAsinArray(const double *x, double *y, size_t count) {
+  size_t i = 0;
+
+  if (!x //
+      || !y) {
+    return;
+  }
+
+#ifdef NMEALIB_FASTMATH_SSE2
+  for (; (i + 2) <= count; i += 2) {
+    _mm_storeu_pd(&y[i], nmeaFastAsin2(_mm_loadu_pd(&x[i])));
+  }
+#endif
+
+  for (; i < count; i++) {
+    y[i] = nmeaFastAsin(x[i]);
+  }
+}
@@ -0,0 +1,411 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/fleet.h>
+
+#include <nmealib/nmath.h>
+#include <nmealib/random.h>
+#include <nmealib/util.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** The number of fixes after which a throttled shard checks its rate */
+#define NMEALIB_FLEET_THROTTLE_INTERVAL (64u)
+
+/** The maximum distance (in degrees) of the initial position of a unit from the default position */
+#define NMEALIB_FLEET_SCATTER_DEGREES (0.5)
+
+/**
+ * A shard of a fleet: a range of units that is simulated by one worker thread
+ */
+typedef struct _NmeaFleetShard {
+    NmeaFleet     *fleet;     /**< The fleet                                   */
+    size_t         index;     /**< The index of the shard                      */
+    size_t         first;     /**< The first unit of the shard                 */
+    size_t         count;     /**< The number of units of the shard            */
+    NmeaInfo      *infos;     /**< The info structures of the units            */
+    NmeaGenerator *nodes;     /**< The pool of generator nodes of the units    */
+    NmeaRandom     random;    /**< The random number generator                 */
+    char          *buffer;    /**< The output buffer                           */
+    size_t         length;    /**< The length of the output buffer contents    */
+    double         rate;      /**< The target rate in fixes per second, or 0   */
+    size_t         ticks;     /**< The number of ticks of the current run      */
+    uint64_t       fixes;     /**< The number of fixes                         */
+    uint64_t       bytes;     /**< The number of generated bytes               */
+    uint64_t       flushes;   /**< The number of output callback invocations   */
+    pthread_t      thread;    /**< The worker thread                           */
+} NmeaFleetShard;
+
+struct _NmeaFleet {
+    NmeaFleetConfig   config;  /**< The configuration                            */
+    size_t            nodes;   /**< The number of generator nodes per unit       */
+    size_t            shards;  /**< The number of shards                         */
+    NmeaFleetShard  **shard;   /**< The shards, allocated separately             */
+    double            seconds; /**< The wall-clock time spent running            */
+};
+
+/*
+ * Helpers
+ */
+
+/**
+ * @return The monotonic time in seconds
+ */
+static double nmeaFleetNow(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + ((double) ts.tv_nsec / 1E9);
+}
+
+/**
+ * Sleep until a monotonic time
+ *
+ * @param until The monotonic time in seconds
+ */
+static void nmeaFleetSleepUntil(double until) {
+  double delay = until - nmeaFleetNow();
+  struct timespec ts;
+
+  if (delay <= 0.0) {
+    return;
+  }
+
+  ts.tv_sec = (time_t) delay;
+  ts.tv_nsec = (long) ((delay - (double) ts.tv_sec) * 1E9);
+  nanosleep(&ts, NULL);
+}
+
+/**
+ * Hand the output buffer of a shard to the output callback
+ *
+ * @param shard The shard
+ */
+static void nmeaFleetFlush(NmeaFleetShard *shard) {
+  const NmeaFleetConfig *config = &shard->fleet->config;
+
+  if (!shard->length) {
+    return;
+  }
+
+  if (config->output) {
+    config->output(config->userData, shard->index, shard->buffer, shard->length);
+  }
+
+  shard->flushes++;
+  shard->length = 0;
+}
+
+/**
+ * Generate the sentences of one fix of a unit into the output buffer of its shard
+ *
+ * @param shard The shard
+ * @param info The info structure of the unit
+ */
+static void nmeaFleetEmit(NmeaFleetShard *shard, const NmeaInfo *info) {
+  size_t bufferSize = shard->fleet->config.bufferSize;
+  NmeaSentence mask = shard->fleet->config.mask;
+  size_t available = bufferSize - shard->length;
+  size_t len = nmeaSentenceFromInfoFixed(&shard->buffer[shard->length], available, info, mask);
+
+  if (len >= available) {
+    nmeaFleetFlush(shard);
+
+    len = nmeaSentenceFromInfoFixed(shard->buffer, bufferSize, info, mask);
+    if (len >= bufferSize) {
+      /* only the complete sentences that fit were kept */
+      len = strlen(shard->buffer);
+    }
+  }
+
+  shard->length += len;
+  shard->bytes += len;
+}
+
+/**
+ * The worker thread of a shard
+ *
+ * @param arg The shard
+ * @return NULL
+ */
+static void *nmeaFleetWorker(void *arg) {
+  NmeaFleetShard *shard = arg;
+  size_t nodes = shard->fleet->nodes;
+  double start = nmeaFleetNow();
+  uint64_t fixes = 0;
+  size_t tick;
+  size_t unit;
+
+  for (tick = 0; tick < shard->ticks; tick++) {
+    for (unit = 0; unit < shard->count; unit++) {
+      NmeaInfo *info = &shard->infos[unit];
+
+      nmeaGeneratorInvoke(&shard->nodes[unit * nodes], info);
+      nmeaFleetEmit(shard, info);
+      fixes++;
+
+      if (shard->rate > 0.0 //
+          && !(fixes % NMEALIB_FLEET_THROTTLE_INTERVAL)) {
+        nmeaFleetSleepUntil(start + ((double) fixes / shard->rate));
+      }
+    }
+  }
+
+  nmeaFleetFlush(shard);
+  shard->fixes += fixes;
+
+  return NULL;
+}
+
+/**
+ * Create a shard and its units
+ *
+ * @param fleet The fleet
+ * @param index The index of the shard
+ * @return The shard, or NULL on failure
+ */
+static NmeaFleetShard *nmeaFleetShardCreate(NmeaFleet *fleet, size_t index) {
+  const NmeaFleetConfig *config = &fleet->config;
+  NmeaFleetShard *shard;
+  size_t last;
+  size_t unit;
+  size_t i;
+
+  shard = calloc(1, sizeof(*shard));
+  if (!shard) {
+    /* can't be covered in a test */
+    return NULL;
+  }
+
+  shard->fleet = fleet;
+  shard->index = index;
+  shard->first = (index * config->units) / fleet->shards;
+  last = ((index + 1) * config->units) / fleet->shards;
+  shard->count = last - shard->first;
+
+  /* every shard draws from its own stream of the seed */
+  nmeaRandomSeed(&shard->random, config->seed);
+  for (i = 0; i < index; i++) {
+    nmeaRandomJump(&shard->random);
+  }
+
+  shard->rate = (config->rate * (double) shard->count) / (double) config->units;
+
+  shard->infos = calloc(shard->count, sizeof(shard->infos[0]));
+  shard->nodes = calloc(shard->count * fleet->nodes, sizeof(shard->nodes[0]));
+  shard->buffer = malloc(config->bufferSize);
+  if (!shard->infos //
+      || !shard->nodes //
+      || !shard->buffer) {
+    /* can't be covered in a test */
+    free(shard->infos);
+    free(shard->nodes);
+    free(shard->buffer);
+    free(shard);
+    return NULL;
+  }
+
+  for (unit = 0; unit < shard->count; unit++) {
+    NmeaInfo *info = &shard->infos[unit];
+    NmeaGenerator *gen;
+    NmeaPosition pos;
+
+    nmeaInfoClear(info);
+    gen = nmeaGeneratorCreateIn(&shard->nodes[unit * fleet->nodes], fleet->nodes, config->type, info);
+    nmeaGeneratorSetRandom(gen, &shard->random);
+    nmeaGeneratorSetMathMode(gen, config->mathMode);
+
+    nmeaMathInfoToPosition(info, &pos);
+    pos.lat += nmeaMathDegreeToRadian(
+        nmeaRandomDouble(&shard->random, -NMEALIB_FLEET_SCATTER_DEGREES, NMEALIB_FLEET_SCATTER_DEGREES));
+    pos.lon += nmeaMathDegreeToRadian(
+        nmeaRandomDouble(&shard->random, -NMEALIB_FLEET_SCATTER_DEGREES, NMEALIB_FLEET_SCATTER_DEGREES));
+    nmeaMathPositionToInfo(&pos, info);
+  }
+
+  return shard;
+}
+
+/**
+ * Destroy a shard
+ *
+ * @param shard The shard
+ */
+static void nmeaFleetShardDestroy(NmeaFleetShard *shard) {
+  if (!shard) {
+    return;
+  }
+
+  free(shard->infos);
+  free(shard->nodes);
+  free(shard->buffer);
+  free(shard);
+}
+
+/*
+ * Public
+ */
+
+NmeaFleet *nmeaFleetCreate(const NmeaFleetConfig *config) {
+  NmeaFleet *fleet;
+  size_t nodes;
+  size_t i;
+
+  if (!config //
+      || !config->units //
+      || !config->mask //
+      || (config->rate < 0.0) //
+      || (config->bufferSize && (config->bufferSize < NMEALIB_FLEET_BUFFER_SIZE_MIN))) {
+    return NULL;
+  }
+
+  nodes = nmeaGeneratorNodes(config->type);
+  if (!nodes) {
+    return NULL;
+  }
+
+  fleet = calloc(1, sizeof(*fleet));
+  if (!fleet) {
+    /* can't be covered in a test */
+    return NULL;
+  }
+
+  fleet->config = *config;
+  if (!fleet->config.bufferSize) {
+    fleet->config.bufferSize = NMEALIB_FLEET_BUFFER_SIZE_DEFAULT;
+  }
+
+  fleet->nodes = nodes;
+  fleet->shards = config->threads ?
+      MIN(config->threads, config->units) :
+      1;
+
+  fleet->shard = calloc(fleet->shards, sizeof(fleet->shard[0]));
+  if (!fleet->shard) {
+    /* can't be covered in a test */
+    free(fleet);
+    return NULL;
+  }
+
+  for (i = 0; i < fleet->shards; i++) {
+    fleet->shard[i] = nmeaFleetShardCreate(fleet, i);
+    if (!fleet->shard[i]) {
+      /* can't be covered in a test */
+      nmeaFleetDestroy(fleet);
+      return NULL;
+    }
+  }
+
+  return fleet;
+}
+
+void nmeaFleetDestroy(NmeaFleet *fleet) {
+  size_t i;
+
+  if (!fleet) {
+    return;
+  }
+
+  for (i = 0; i < fleet->shards; i++) {
+    nmeaFleetShardDestroy(fleet->shard[i]);
+  }
+
+  free(fleet->shard);
+  free(fleet);
+}
+
+bool nmeaFleetRun(NmeaFleet *fleet, size_t ticks) {
+  size_t started = 0;
+  double start;
+  size_t i;
+
+  if (!fleet) {
+    return false;
+  }
+
+  start = nmeaFleetNow();
+
+  for (i = 0; i < fleet->shards; i++) {
+    NmeaFleetShard *shard = fleet->shard[i];
+
+    shard->ticks = ticks;
+    if (pthread_create(&shard->thread, NULL, nmeaFleetWorker, shard)) {
+      /* can't be covered in a test */
+      break;
+    }
+
+    started++;
+  }
+
+  for (i = 0; i < started; i++) {
+    pthread_join(fleet->shard[i]->thread, NULL);
+  }
+
+  fleet->seconds += nmeaFleetNow() - start;
+
+  return started == fleet->shards;
+}
+
+void nmeaFleetMetrics(const NmeaFleet *fleet, NmeaFleetMetrics *metrics) {
+  size_t i;
+
+  if (!metrics) {
+    return;
+  }
+
+  memset(metrics, 0, sizeof(*metrics));
+
+  if (!fleet) {
+    return;
+  }
+
+  for (i = 0; i < fleet->shards; i++) {
+    const NmeaFleetShard *shard = fleet->shard[i];
+
+    metrics->fixes += shard->fixes;
+    metrics->bytes += shard->bytes;
+    metrics->flushes += shard->flushes;
+  }
+
+  metrics->seconds = fleet->seconds;
+  if (metrics->seconds > 0.0) {
+    metrics->fixesPerSecond = (double) metrics->fixes / metrics->seconds;
+    metrics->bytesPerSecond = (double) metrics->bytes / metrics->seconds;
+  }
+}
+
+const NmeaInfo *nmeaFleetUnitInfo(const NmeaFleet *fleet, size_t unit) {
+  size_t i;
+
+  if (!fleet //
+      || (unit >= fleet->config.units)) {
+    return NULL;
+  }
+
+  for (i = 0; i < fleet->shards; i++) {
+    const NmeaFleetShard *shard = fleet->shard[i];
+
+    if (unit < (shard->first + shard->count)) {
+      return &shard->infos[unit - shard->first];
+    }
+  }
+
+  /* can't be covered in a test */
+  return NULL;
+}
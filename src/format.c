@@ -0,0 +1,451 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/format.h>
+
+#include <nmealib/util.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/** The size of the scratch buffer, larger than any formatted number */
+#define NMEALIB_FORMAT_BUFFER_SIZE (64u)
+
+/** The width from which on numbers are formatted by snprintf */
+#define NMEALIB_FORMAT_WIDTH_MAX (NMEALIB_FORMAT_BUFFER_SIZE >> 1)
+
+/** The maximum precision that is formatted without snprintf */
+#define NMEALIB_FORMAT_PRECISION_MAX (4u)
+
+/** The biased exponent of 2^48, numbers from there on are formatted by snprintf */
+#define NMEALIB_FORMAT_EXPONENT_MAX (1023u + 48u)
+
+static const uint64_t nmeaFormatPow5[NMEALIB_FORMAT_PRECISION_MAX + 1] = {
+    1,
+    5,
+    25,
+    125,
+    625 };
+
+static const uint64_t nmeaFormatPow10[NMEALIB_FORMAT_PRECISION_MAX + 1] = {
+    1,
+    10,
+    100,
+    1000,
+    10000 };
+
+/** The hexadecimal digits of the checksum */
+static const char nmeaFormatHex[16] = {
+    '0',
+    '1',
+    '2',
+    '3',
+    '4',
+    '5',
+    '6',
+    '7',
+    '8',
+    '9',
+    'A',
+    'B',
+    'C',
+    'D',
+    'E',
+    'F' };
+
+/**
+ * Copy a formatted value into a buffer with snprintf semantics
+ *
+ * @param s The buffer
+ * @param sz The size of the buffer
+ * @param value The formatted value
+ * @param len The length of the formatted value
+ * @return The length of the formatted value
+ */
+static INLINE int nmeaFormatCopy(char *s, size_t sz, const char *value, size_t len) {
+  if (sz) {
+    size_t n = (len < sz) ?
+        len :
+        (sz - 1);
+
+    memcpy(s, value, n);
+    s[n] = '\0';
+  }
+
+  return (int) len;
+}
+
+/**
+ * Write the decimal digits of a value backwards
+ *
+ * @param end The position just beyond the last digit
+ * @param v The value
+ * @return The position of the first digit
+ */
+static INLINE char *nmeaFormatDigits(char *end, uint64_t v) {
+  do {
+    *--end = (char) ('0' + (v % 10));
+    v /= 10;
+  } while (v);
+
+  return end;
+}
+
+/**
+ * Format an unsigned integer backwards
+ *
+ * @param end The position just beyond the last character
+ * @param v The value
+ * @param width The minimum width, zero-padded, must be smaller than
+ * NMEALIB_FORMAT_WIDTH_MAX
+ * @return The position of the first character
+ */
+static INLINE char *nmeaFormatRenderUnsigned(char *end, unsigned long v, unsigned int width) {
+  char *p = nmeaFormatDigits(end, v);
+
+  while ((size_t) (end - p) < width) {
+    *--p = '0';
+  }
+
+  return p;
+}
+
+/**
+ * Format a signed integer backwards
+ *
+ * @param end The position just beyond the last character
+ * @param v The value
+ * @param width The minimum width (including the sign), zero-padded, must be
+ * smaller than NMEALIB_FORMAT_WIDTH_MAX
+ * @return The position of the first character
+ */
+static INLINE char *nmeaFormatRenderInt(char *end, long v, unsigned int width) {
+  char *p;
+  size_t digits;
+
+  p = nmeaFormatDigits(end, (v < 0) ?
+      (0 - (uint64_t) v) :
+      (uint64_t) v);
+
+  digits = (v < 0) ?
+      (width ? (width - 1) : 0) :
+      width;
+  while ((size_t) (end - p) < digits) {
+    *--p = '0';
+  }
+
+  if (v < 0) {
+    *--p = '-';
+  }
+
+  return p;
+}
+
+/**
+ * Determine whether a floating point number can be formatted without snprintf
+ *
+ * @param v The value
+ * @param width The minimum width
+ * @param precision The number of digits after the decimal point
+ * @return True when nmeaFormatRenderDouble can format the number
+ */
+static INLINE bool nmeaFormatDoubleIsFast(double v, unsigned int width, unsigned int precision) {
+  uint64_t bits;
+
+  memcpy(&bits, &v, sizeof(bits));
+
+  return (precision <= NMEALIB_FORMAT_PRECISION_MAX) //
+      && (((bits >> 52) & 0x7ff) < NMEALIB_FORMAT_EXPONENT_MAX) //
+      && (width < NMEALIB_FORMAT_WIDTH_MAX);
+}
+
+/**
+ * Format a floating point number backwards
+ *
+ * @param end The position just beyond the last character
+ * @param v The value, nmeaFormatDoubleIsFast must be true for it
+ * @param width The minimum width (including the sign and the decimal point),
+ * zero-padded
+ * @param precision The number of digits after the decimal point
+ * @return The position of the first character
+ */
+static char *nmeaFormatRenderDouble(char *end, double v, unsigned int width, unsigned int precision) {
+  char *p = end;
+  uint64_t bits;
+  uint64_t mantissa;
+  unsigned int exponent;
+  unsigned int shift;
+  bool negative;
+  uint64_t n;
+  uint64_t q;
+  uint64_t fraction;
+  size_t digits;
+  unsigned int i;
+
+  memcpy(&bits, &v, sizeof(bits));
+  exponent = (unsigned int) ((bits >> 52) & 0x7ff);
+  negative = (bits >> 63) != 0;
+  mantissa = bits & ((1ULL << 52) - 1);
+
+  /*
+   * v = mantissa * 2^-(1075 - exponent), so
+   * v * 10^precision = mantissa * 5^precision * 2^-(1075 - exponent - precision)
+   *
+   * mantissa * 5^precision fits in 63 bits and the shift is at least 1
+   * because the exponent is limited.
+   */
+  if (exponent) {
+    mantissa |= 1ULL << 52;
+    shift = 1075 - exponent - precision;
+  } else {
+    /* subnormal */
+    shift = 1074 - precision;
+  }
+
+  n = mantissa * nmeaFormatPow5[precision];
+
+  if (shift >= 64) {
+    /* less than half */
+    q = 0;
+  } else {
+    uint64_t remainder = n & ((1ULL << shift) - 1);
+    uint64_t half = 1ULL << (shift - 1);
+
+    q = n >> shift;
+    if ((remainder > half) //
+        || ((remainder == half) && (q & 1))) {
+      q++;
+    }
+  }
+
+  fraction = q % nmeaFormatPow10[precision];
+  q /= nmeaFormatPow10[precision];
+
+  if (precision) {
+    for (i = 0; i < precision; i++) {
+      *--p = (char) ('0' + (fraction % 10));
+      fraction /= 10;
+    }
+    *--p = '.';
+  }
+
+  p = nmeaFormatDigits(p, q);
+
+  digits = negative ?
+      (width ? (width - 1) : 0) :
+      width;
+  while ((size_t) (end - p) < digits) {
+    *--p = '0';
+  }
+
+  if (negative) {
+    *--p = '-';
+  }
+
+  return p;
+}
+
+/*
+ * snprintf replacements
+ */
+
+int nmeaFormatString(char *s, size_t sz, const char *str) {
+  if (!str) {
+    return 0;
+  }
+
+  return nmeaFormatCopy(s, sz, str, strlen(str));
+}
+
+int nmeaFormatChar(char *s, size_t sz, char c) {
+  return nmeaFormatCopy(s, sz, &c, 1);
+}
+
+int nmeaFormatUnsigned(char *s, size_t sz, unsigned long v, unsigned int width) {
+  char buffer[NMEALIB_FORMAT_BUFFER_SIZE];
+  char *end = &buffer[sizeof(buffer)];
+  char *p;
+
+  if (width >= NMEALIB_FORMAT_WIDTH_MAX) {
+    return snprintf(s, sz, "%0*lu", (int) width, v);
+  }
+
+  p = nmeaFormatRenderUnsigned(end, v, width);
+  return nmeaFormatCopy(s, sz, p, (size_t) (end - p));
+}
+
+int nmeaFormatInt(char *s, size_t sz, long v, unsigned int width) {
+  char buffer[NMEALIB_FORMAT_BUFFER_SIZE];
+  char *end = &buffer[sizeof(buffer)];
+  char *p;
+
+  if (width >= NMEALIB_FORMAT_WIDTH_MAX) {
+    return snprintf(s, sz, "%0*ld", (int) width, v);
+  }
+
+  p = nmeaFormatRenderInt(end, v, width);
+  return nmeaFormatCopy(s, sz, p, (size_t) (end - p));
+}
+
+int nmeaFormatDouble(char *s, size_t sz, double v, unsigned int width, unsigned int precision) {
+  char buffer[NMEALIB_FORMAT_BUFFER_SIZE];
+  char *end = &buffer[sizeof(buffer)];
+  char *p;
+
+  if (!nmeaFormatDoubleIsFast(v, width, precision)) {
+    return snprintf(s, sz, "%0*.*f", (int) width, (int) precision, v);
+  }
+
+  p = nmeaFormatRenderDouble(end, v, width, precision);
+  return nmeaFormatCopy(s, sz, p, (size_t) (end - p));
+}
+
+/*
+ * Formatter
+ */
+
+/**
+ * Append characters to the output of a formatter and fold them into the
+ * checksum
+ *
+ * @param f The formatter
+ * @param value The characters
+ * @param len The number of characters
+ */
+static INLINE void nmeaFormatterAppend(NmeaFormatter *f, const char *value, size_t len) {
+  size_t i;
+
+  for (i = 0; i < len; i++) {
+    f->checksum ^= (unsigned char) value[i];
+  }
+
+  f->length += (size_t) nmeaFormatCopy(nmeaFormatterDst(f), nmeaFormatterAvailable(f), value, len);
+}
+
+/**
+ * Account for characters that were written (by snprintf) at the end of the
+ * output of a formatter and fold them into the checksum
+ *
+ * @param f The formatter
+ * @param len The return value of snprintf
+ */
+static void nmeaFormatterAdvance(NmeaFormatter *f, int len) {
+  size_t written;
+  size_t i;
+  const char *value = nmeaFormatterDst(f);
+
+  if (len <= 0) {
+    return;
+  }
+
+  written = MIN((size_t) len, nmeaFormatterAvailable(f) ? (nmeaFormatterAvailable(f) - 1) : 0);
+  for (i = 0; i < written; i++) {
+    f->checksum ^= (unsigned char) value[i];
+  }
+
+  f->length += (size_t) len;
+}
+
+void nmeaFormatterInit(NmeaFormatter *f, char *s, size_t sz) {
+  if (!f) {
+    return;
+  }
+
+  f->s = s;
+  f->sz = s ?
+      sz :
+      0;
+  f->length = 0;
+
+  /* the start-of-line character is not part of the checksum, this cancels it out */
+  f->checksum = '$';
+
+  if (f->sz) {
+    *s = '\0';
+  }
+}
+
+void nmeaFormatterString(NmeaFormatter *f, const char *str) {
+  if (!str) {
+    return;
+  }
+
+  nmeaFormatterAppend(f, str, strlen(str));
+}
+
+void nmeaFormatterChar(NmeaFormatter *f, char c) {
+  nmeaFormatterAppend(f, &c, 1);
+}
+
+void nmeaFormatterUnsigned(NmeaFormatter *f, unsigned long v, unsigned int width) {
+  char buffer[NMEALIB_FORMAT_BUFFER_SIZE];
+  char *end = &buffer[sizeof(buffer)];
+  char *p;
+
+  if (width >= NMEALIB_FORMAT_WIDTH_MAX) {
+    nmeaFormatterAdvance(f, snprintf(nmeaFormatterDst(f), nmeaFormatterAvailable(f), "%0*lu", (int) width, v));
+    return;
+  }
+
+  p = nmeaFormatRenderUnsigned(end, v, width);
+  nmeaFormatterAppend(f, p, (size_t) (end - p));
+}
+
+void nmeaFormatterInt(NmeaFormatter *f, long v, unsigned int width) {
+  char buffer[NMEALIB_FORMAT_BUFFER_SIZE];
+  char *end = &buffer[sizeof(buffer)];
+  char *p;
+
+  if (width >= NMEALIB_FORMAT_WIDTH_MAX) {
+    nmeaFormatterAdvance(f, snprintf(nmeaFormatterDst(f), nmeaFormatterAvailable(f), "%0*ld", (int) width, v));
+    return;
+  }
+
+  p = nmeaFormatRenderInt(end, v, width);
+  nmeaFormatterAppend(f, p, (size_t) (end - p));
+}
+
+void nmeaFormatterDouble(NmeaFormatter *f, double v, unsigned int width, unsigned int precision) {
+  char buffer[NMEALIB_FORMAT_BUFFER_SIZE];
+  char *end = &buffer[sizeof(buffer)];
+  char *p;
+
+  if (!nmeaFormatDoubleIsFast(v, width, precision)) {
+    nmeaFormatterAdvance(f,
+        snprintf(nmeaFormatterDst(f), nmeaFormatterAvailable(f), "%0*.*f", (int) width, (int) precision, v));
+    return;
+  }
+
+  p = nmeaFormatRenderDouble(end, v, width, precision);
+  nmeaFormatterAppend(f, p, (size_t) (end - p));
+}
+
+void nmeaFormatterChecksum(NmeaFormatter *f) {
+  char trailer[NMEALIB_CHECKSUM_LENGTH];
+
+  nmeaFormatChecksum(trailer, f->checksum);
+  f->length += (size_t) nmeaFormatCopy(nmeaFormatterDst(f), nmeaFormatterAvailable(f), trailer, sizeof(trailer));
+}
+
+void nmeaFormatChecksum(char *trailer, unsigned int checksum) {
+  trailer[0] = '*';
+  trailer[1] = nmeaFormatHex[(checksum >> 4) & 0xf];
+  trailer[2] = nmeaFormatHex[checksum & 0xf];
+  trailer[3] = '\r';
+  trailer[4] = '\n';
+}
@@ -0,0 +1,673 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/frame.h>
+
+#include <nmealib/fastmath.h>
+#include <nmealib/nmath.h>
+#include <nmealib/util.h>
+#include <math.h>
+
+/*
+ * Ellipsoid, WGS84
+ */
+
+/** The semi-major axis */
+#define NMEALIB_FRAME_A   ((double) NMEALIB_EARTHRADIUS_M)
+
+/** The flattening */
+#define NMEALIB_FRAME_F   (NMEALIB_EARTH_FLATTENING)
+
+/** The semi-minor axis */
+#define NMEALIB_FRAME_B   (NMEALIB_FRAME_A * (1.0 - NMEALIB_FRAME_F))
+
+/** The first eccentricity squared */
+#define NMEALIB_FRAME_E2  (NMEALIB_FRAME_F * (2.0 - NMEALIB_FRAME_F))
+
+/** The second eccentricity squared */
+#define NMEALIB_FRAME_EP2 (NMEALIB_FRAME_E2 / (1.0 - NMEALIB_FRAME_E2))
+
+/** The third flattening */
+#define NMEALIB_FRAME_N   (NMEALIB_FRAME_F / (2.0 - NMEALIB_FRAME_F))
+
+/** The number of terms of the UTM series */
+#define NMEALIB_FRAME_ORDER (6u)
+
+/**
+ * The coefficients of a sine series: c[1] sin(2x) + ... + c[n] sin(2nx), c[0]
+ * is unused
+ */
+typedef double NmeaFrameSeries[NMEALIB_FRAME_ORDER + 1];
+
+/**
+ * A function over an array
+ *
+ * @param x The arguments
+ * @param y The array in which to store the values, may be x
+ * @param count The number of arguments
+ */
+typedef void (*NmeaFrameArrayFunction)(const double *x, double *y, size_t count);
+
+/**
+ * The constants of the UTM projection
+ */
+typedef struct _NmeaFrameUtm {
+    double          scale;    /**< The scale factor times the rectifying radius             */
+    double          lon0;     /**< The longitude of the central meridian                    */
+    double          northing; /**< The false northing                                       */
+    NmeaFrameSeries alpha;    /**< Conformal latitude to rectifying latitude                */
+    NmeaFrameSeries beta;     /**< Rectifying latitude to conformal latitude                */
+    NmeaFrameSeries delta;    /**< Conformal latitude to geodetic latitude                  */
+} NmeaFrameUtm;
+
+/** Heights of 0, for when no heights are given */
+static const double nmeaFrameZeros[NMEALIB_FRAME_BLOCK] = { 0.0 };
+
+/*
+ * Helpers
+ */
+
+static void nmeaFrameSinExact(const double *x, double *y, size_t count) {
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    y[i] = sin(x[i]);
+  }
+}
+
+/**
+ * Get the sine function of an accuracy mode
+ *
+ * @param mode The accuracy mode
+ * @return The sine function
+ */
+static NmeaFrameArrayFunction nmeaFrameSin(NmeaFrameMode mode) {
+  switch (mode) {
+    case NMEALIB_FRAME_FAST:
+      return nmeaFastSinArray;
+
+    case NMEALIB_FRAME_EXACT:
+    default:
+      return nmeaFrameSinExact;
+  }
+}
+
+/**
+ * Convert a block of geodetic coordinates to ECEF coordinates
+ *
+ * The cosines are computed as sines, so that a block takes a single pass of
+ * the sine function over 4 arrays.
+ *
+ * @param lat The latitudes
+ * @param lon The longitudes
+ * @param height The heights
+ * @param n The number of coordinates, at most NMEALIB_FRAME_BLOCK
+ * @param sine The sine function
+ * @param x The array in which to store the X coordinates
+ * @param y The array in which to store the Y coordinates
+ * @param z The array in which to store the Z coordinates
+ */
+static void nmeaFrameEcefBlock(const double *lat, const double *lon, const double *height, size_t n,
+    NmeaFrameArrayFunction sine, double *x, double *y, double *z) {
+  double args[4 * NMEALIB_FRAME_BLOCK];
+  double *sinLat = args;
+  double *cosLat = &args[n];
+  double *sinLon = &args[2 * n];
+  double *cosLon = &args[3 * n];
+  size_t i;
+
+  for (i = 0; i < n; i++) {
+    sinLat[i] = lat[i];
+    cosLat[i] = lat[i] + (NMEALIB_PI / 2.0);
+    sinLon[i] = lon[i];
+    cosLon[i] = lon[i] + (NMEALIB_PI / 2.0);
+  }
+
+  sine(args, args, 4 * n);
+
+  for (i = 0; i < n; i++) {
+    double nu = NMEALIB_FRAME_A / sqrt(1.0 - (NMEALIB_FRAME_E2 * sinLat[i] * sinLat[i]));
+    double r = (nu + height[i]) * cosLat[i];
+
+    x[i] = r * cosLon[i];
+    y[i] = r * sinLon[i];
+    z[i] = ((nu * (1.0 - NMEALIB_FRAME_E2)) + height[i]) * sinLat[i];
+  }
+}
+
+/**
+ * Convert ECEF coordinates to geodetic coordinates, with the closed form of
+ * Heikkinen
+ *
+ * @param x The X coordinate
+ * @param y The Y coordinate
+ * @param z The Z coordinate
+ * @param lat The location in which to store the latitude
+ * @param lon The location in which to store the longitude
+ * @param height The location in which to store the height
+ */
+static INLINE void nmeaFrameGeodetic(double x, double y, double z, double *lat, double *lon, double *height) {
+  static const double b2 = NMEALIB_FRAME_B * NMEALIB_FRAME_B;
+  static const double e4 = NMEALIB_FRAME_E2 * NMEALIB_FRAME_E2;
+  double p2 = (x * x) + (y * y);
+  double p = sqrt(p2);
+  double z2 = z * z;
+  double f = 54.0 * b2 * z2;
+  double g = p2 + ((1.0 - NMEALIB_FRAME_E2) * z2) - (NMEALIB_FRAME_E2 * ((NMEALIB_FRAME_A * NMEALIB_FRAME_A) - b2));
+  double c = (e4 * f * p2) / (g * g * g);
+  double s = cbrt(1.0 + c + sqrt((c * c) + (2.0 * c)));
+  double k = s + 1.0 + (1.0 / s);
+  double pk = f / (3.0 * k * k * g * g);
+  double q = sqrt(1.0 + (2.0 * e4 * pk));
+  double r2 = ((NMEALIB_FRAME_A * NMEALIB_FRAME_A * 0.5) * (1.0 + (1.0 / q))) //
+      - ((pk * (1.0 - NMEALIB_FRAME_E2) * z2) / (q * (1.0 + q))) //
+      - (pk * p2 * 0.5);
+  double r0 = sqrt(MAX(r2, 0.0)) - ((pk * NMEALIB_FRAME_E2 * p) / (1.0 + q));
+  double t = p - (NMEALIB_FRAME_E2 * r0);
+  double u = sqrt((t * t) + z2);
+  double v = sqrt((t * t) + ((1.0 - NMEALIB_FRAME_E2) * z2));
+  double bav = b2 / (NMEALIB_FRAME_A * v);
+
+  *lat = atan2(z + (NMEALIB_FRAME_EP2 * bav * z), p);
+  *lon = atan2(y, x);
+  *height = u * (1.0 - bav);
+}
+
+/**
+ * Evaluate a sine series of a complex argument z = x + iy with Clenshaw
+ * summation: c[1] sin(2z) + ... + c[n] sin(2nz)
+ *
+ * @param sin2x The sine of 2x
+ * @param cos2x The cosine of 2x
+ * @param exp2y The exponential of 2y
+ * @param series The coefficients
+ * @param re The location in which to store the real part of the sum
+ * @param im The location in which to store the imaginary part of the sum
+ */
+static INLINE void nmeaFrameSeriesSum(double sin2x, double cos2x, double exp2y, const NmeaFrameSeries series,
+    double *re, double *im) {
+  double cosh2y = (exp2y + (1.0 / exp2y)) * 0.5;
+  double sinh2y = (exp2y - (1.0 / exp2y)) * 0.5;
+  double ar = 2.0 * cos2x * cosh2y;
+  double ai = -2.0 * sin2x * sinh2y;
+  double b1r = 0.0;
+  double b1i = 0.0;
+  double b2r = 0.0;
+  double b2i = 0.0;
+  size_t l = NMEALIB_FRAME_ORDER;
+
+  /* b = c[l] + 2 cos(2z) b1 - b2 */
+  while (l) {
+    double br = series[l] + ((ar * b1r) - (ai * b1i)) - b2r;
+    double bi = ((ar * b1i) + (ai * b1r)) - b2i;
+
+    b2r = b1r;
+    b2i = b1i;
+    b1r = br;
+    b1i = bi;
+    l--;
+  }
+
+  /* sin(2z) b1 */
+  *re = (sin2x * cosh2y * b1r) - (cos2x * sinh2y * b1i);
+  *im = (sin2x * cosh2y * b1i) + (cos2x * sinh2y * b1r);
+}
+
+/**
+ * Get the constants of the UTM projection of a zone
+ *
+ * The series are those of Karney (2011), of order 6 in the third flattening.
+ *
+ * @param zone The zone
+ * @param south True for the southern hemisphere
+ * @param utm The structure in which to store the constants
+ * @return True on success, false when the zone is invalid
+ */
+static bool nmeaFrameUtmGet(unsigned int zone, bool south, NmeaFrameUtm *utm) {
+  double n = NMEALIB_FRAME_N;
+  double n2 = n * n;
+  double n3 = n2 * n;
+  double n4 = n3 * n;
+  double n5 = n4 * n;
+  double n6 = n5 * n;
+
+  if ((zone < 1) //
+      || (zone > 60)) {
+    return false;
+  }
+
+  utm->scale = NMEALIB_UTM_SCALE * (NMEALIB_FRAME_A / (1.0 + n)) * (1.0 + (n2 / 4.0) + (n4 / 64.0) + (n6 / 256.0));
+  utm->lon0 = nmeaMathDegreeToRadian((6.0 * (double) zone) - 183.0);
+  utm->northing = south ?
+      NMEALIB_UTM_NORTHING_SOUTH :
+      0.0;
+
+  utm->alpha[0] = 0.0;
+  utm->alpha[1] = (n / 2.0) - ((2.0 * n2) / 3.0) + ((5.0 * n3) / 16.0) + ((41.0 * n4) / 180.0)
+      - ((127.0 * n5) / 288.0) + ((7891.0 * n6) / 37800.0);
+  utm->alpha[2] = ((13.0 * n2) / 48.0) - ((3.0 * n3) / 5.0) + ((557.0 * n4) / 1440.0) + ((281.0 * n5) / 630.0)
+      - ((1983433.0 * n6) / 1935360.0);
+  utm->alpha[3] = ((61.0 * n3) / 240.0) - ((103.0 * n4) / 140.0) + ((15061.0 * n5) / 26880.0)
+      + ((167603.0 * n6) / 181440.0);
+  utm->alpha[4] = ((49561.0 * n4) / 161280.0) - ((179.0 * n5) / 168.0) + ((6601661.0 * n6) / 7257600.0);
+  utm->alpha[5] = ((34729.0 * n5) / 80640.0) - ((3418889.0 * n6) / 1995840.0);
+  utm->alpha[6] = (212378941.0 * n6) / 319334400.0;
+
+  utm->beta[0] = 0.0;
+  utm->beta[1] = (n / 2.0) - ((2.0 * n2) / 3.0) + ((37.0 * n3) / 96.0) - (n4 / 360.0) - ((81.0 * n5) / 512.0)
+      + ((96199.0 * n6) / 604800.0);
+  utm->beta[2] = (n2 / 48.0) + (n3 / 15.0) - ((437.0 * n4) / 1440.0) + ((46.0 * n5) / 105.0)
+      - ((1118711.0 * n6) / 3870720.0);
+  utm->beta[3] = ((17.0 * n3) / 480.0) - ((37.0 * n4) / 840.0) - ((209.0 * n5) / 4480.0) + ((5569.0 * n6) / 90720.0);
+  utm->beta[4] = ((4397.0 * n4) / 161280.0) - ((11.0 * n5) / 504.0) - ((830251.0 * n6) / 7257600.0);
+  utm->beta[5] = ((4583.0 * n5) / 161280.0) - ((108847.0 * n6) / 3991680.0);
+  utm->beta[6] = (20648693.0 * n6) / 638668800.0;
+
+  utm->delta[0] = 0.0;
+  utm->delta[1] = (2.0 * n) - ((2.0 * n2) / 3.0) - (2.0 * n3) + ((116.0 * n4) / 45.0) + ((26.0 * n5) / 45.0)
+      - ((2854.0 * n6) / 675.0);
+  utm->delta[2] = ((7.0 * n2) / 3.0) - ((8.0 * n3) / 5.0) - ((227.0 * n4) / 45.0) + ((2704.0 * n5) / 315.0)
+      + ((2323.0 * n6) / 945.0);
+  utm->delta[3] = ((56.0 * n3) / 15.0) - ((136.0 * n4) / 35.0) - ((1262.0 * n5) / 105.0) + ((73814.0 * n6) / 2835.0);
+  utm->delta[4] = ((4279.0 * n4) / 630.0) - ((332.0 * n5) / 35.0) - ((399572.0 * n6) / 14175.0);
+  utm->delta[5] = ((4174.0 * n5) / 315.0) - ((144838.0 * n6) / 6237.0);
+  utm->delta[6] = (601676.0 * n6) / 22275.0;
+
+  return true;
+}
+
+/*
+ * Public
+ */
+
+bool nmeaFrameOriginInit(NmeaFrameOrigin *origin, const NmeaPosition *position, double height) {
+  if (!origin //
+      || !position) {
+    return false;
+  }
+
+  origin->position = *position;
+  origin->height = height;
+  origin->sinLat = sin(position->lat);
+  origin->cosLat = cos(position->lat);
+  origin->sinLon = sin(position->lon);
+  origin->cosLon = cos(position->lon);
+  nmeaFrameEcefBlock(&position->lat, &position->lon, &height, 1, nmeaFrameSinExact, &origin->x, &origin->y,
+      &origin->z);
+
+  return true;
+}
+
+bool nmeaFrameSplitPositions(const NmeaPosition *positions, size_t count, double *lat, double *lon) {
+  size_t i;
+
+  if (!positions //
+      || !lat //
+      || !lon) {
+    return false;
+  }
+
+  for (i = 0; i < count; i++) {
+    lat[i] = positions[i].lat;
+    lon[i] = positions[i].lon;
+  }
+
+  return true;
+}
+
+bool nmeaFrameSplitRecords(const NmeaRecord *records, size_t count, double *lat, double *lon, double *height) {
+  size_t i;
+
+  if (!records //
+      || !lat //
+      || !lon) {
+    return false;
+  }
+
+  for (i = 0; i < count; i++) {
+    lat[i] = records[i].latitude * NMEALIB_DEGREE_TO_RADIAN;
+    lon[i] = records[i].longitude * NMEALIB_DEGREE_TO_RADIAN;
+  }
+
+  if (height) {
+    for (i = 0; i < count; i++) {
+      height[i] = nmeaInfoIsPresentAll(records[i].present, NMEALIB_PRESENT_ELV) ?
+          (double) records[i].elevation :
+          0.0;
+    }
+  }
+
+  return true;
+}
+
+bool nmeaFrameGeodeticToEcef(const double *lat, const double *lon, const double *height, size_t count, double *x,
+    double *y, double *z, NmeaFrameMode mode) {
+  NmeaFrameArrayFunction sine = nmeaFrameSin(mode);
+  size_t offset;
+
+  if (!lat //
+      || !lon //
+      || !x //
+      || !y //
+      || !z) {
+    return false;
+  }
+
+  for (offset = 0; offset < count; offset += NMEALIB_FRAME_BLOCK) {
+    size_t n = MIN(count - offset, NMEALIB_FRAME_BLOCK);
+    const double *h = height ?
+        &height[offset] :
+        nmeaFrameZeros;
+
+    nmeaFrameEcefBlock(&lat[offset], &lon[offset], h, n, sine, &x[offset], &y[offset], &z[offset]);
+  }
+
+  return true;
+}
+
+bool nmeaFrameEcefToGeodetic(const double *x, const double *y, const double *z, size_t count, double *lat,
+    double *lon, double *height) {
+  double scratch;
+  size_t i;
+
+  if (!x //
+      || !y //
+      || !z //
+      || !lat //
+      || !lon) {
+    return false;
+  }
+
+  if (height) {
+    for (i = 0; i < count; i++) {
+      nmeaFrameGeodetic(x[i], y[i], z[i], &lat[i], &lon[i], &height[i]);
+    }
+  } else {
+    for (i = 0; i < count; i++) {
+      nmeaFrameGeodetic(x[i], y[i], z[i], &lat[i], &lon[i], &scratch);
+    }
+  }
+
+  return true;
+}
+
+bool nmeaFrameGeodeticToEnu(const NmeaFrameOrigin *origin, const double *lat, const double *lon,
+    const double *height, size_t count, double *east, double *north, double *up, NmeaFrameMode mode) {
+  NmeaFrameArrayFunction sine = nmeaFrameSin(mode);
+  double x[NMEALIB_FRAME_BLOCK];
+  double y[NMEALIB_FRAME_BLOCK];
+  double z[NMEALIB_FRAME_BLOCK];
+  double scratch[NMEALIB_FRAME_BLOCK];
+  size_t offset;
+
+  if (!origin //
+      || !lat //
+      || !lon //
+      || !east //
+      || !north) {
+    return false;
+  }
+
+  for (offset = 0; offset < count; offset += NMEALIB_FRAME_BLOCK) {
+    size_t n = MIN(count - offset, NMEALIB_FRAME_BLOCK);
+    const double *h = height ?
+        &height[offset] :
+        nmeaFrameZeros;
+    double *e = &east[offset];
+    double *nn = &north[offset];
+    double *u = up ?
+        &up[offset] :
+        scratch;
+    size_t i;
+
+    nmeaFrameEcefBlock(&lat[offset], &lon[offset], h, n, sine, x, y, z);
+
+    for (i = 0; i < n; i++) {
+      double dx = x[i] - origin->x;
+      double dy = y[i] - origin->y;
+      double dz = z[i] - origin->z;
+      double t = (origin->cosLon * dx) + (origin->sinLon * dy);
+
+      e[i] = (origin->cosLon * dy) - (origin->sinLon * dx);
+      nn[i] = (origin->cosLat * dz) - (origin->sinLat * t);
+      u[i] = (origin->cosLat * t) + (origin->sinLat * dz);
+    }
+  }
+
+  return true;
+}
+
+bool nmeaFrameEnuToGeodetic(const NmeaFrameOrigin *origin, const double *east, const double *north,
+    const double *up, size_t count, double *lat, double *lon, double *height) {
+  double x[NMEALIB_FRAME_BLOCK];
+  double y[NMEALIB_FRAME_BLOCK];
+  double z[NMEALIB_FRAME_BLOCK];
+  size_t offset;
+
+  if (!origin //
+      || !east //
+      || !north //
+      || !lat //
+      || !lon) {
+    return false;
+  }
+
+  for (offset = 0; offset < count; offset += NMEALIB_FRAME_BLOCK) {
+    size_t n = MIN(count - offset, NMEALIB_FRAME_BLOCK);
+    const double *e = &east[offset];
+    const double *nn = &north[offset];
+    const double *u = up ?
+        &up[offset] :
+        nmeaFrameZeros;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+      double t = (origin->cosLat * u[i]) - (origin->sinLat * nn[i]);
+
+      x[i] = origin->x + (origin->cosLon * t) - (origin->sinLon * e[i]);
+      y[i] = origin->y + (origin->sinLon * t) + (origin->cosLon * e[i]);
+      z[i] = origin->z + (origin->cosLat * nn[i]) + (origin->sinLat * u[i]);
+    }
+
+    nmeaFrameEcefToGeodetic(x, y, z, n, &lat[offset], &lon[offset], height ?
+        &height[offset] :
+        NULL);
+  }
+
+  return true;
+}
+
+unsigned int nmeaFrameUtmZone(const NmeaPosition *position) {
+  double lat;
+  double lon;
+  double zone;
+
+  if (!position //
+      || !isfinite(position->lat) //
+      || !isfinite(position->lon)) {
+    return 0;
+  }
+
+  lat = nmeaMathRadianToDegree(position->lat);
+  lon = nmeaMathRadianToDegree(remainder(position->lon, 2.0 * NMEALIB_PI));
+
+  /* southern Norway */
+  if ((lat >= 56.0) //
+      && (lat < 64.0) //
+      && (lon >= 3.0) //
+      && (lon < 12.0)) {
+    return 32;
+  }
+
+  /* Svalbard: the odd zones 31 to 37 */
+  if ((lat >= 72.0) //
+      && (lon >= 0.0) //
+      && (lon < 42.0)) {
+    zone = floor((lon + 3.0) / 12.0);
+    return 31 + (2 * (unsigned int) zone);
+  }
+
+  zone = floor((lon + 180.0) / 6.0);
+  return 1 + (unsigned int) MIN(MAX(zone, 0.0), 59.0);
+}
+
+bool nmeaFrameGeodeticToUtm(unsigned int zone, bool south, const double *lat, const double *lon, size_t count,
+    double *easting, double *northing, NmeaFrameMode mode) {
+  double e = sqrt(NMEALIB_FRAME_E2);
+  NmeaFrameArrayFunction sine = nmeaFrameSin(mode);
+  NmeaFrameUtm utm;
+  double args[3 * NMEALIB_FRAME_BLOCK];
+  double exp2eta[NMEALIB_FRAME_BLOCK];
+  double xi[NMEALIB_FRAME_BLOCK];
+  double eta[NMEALIB_FRAME_BLOCK];
+  size_t offset;
+
+  if (!lat //
+      || !lon //
+      || !easting //
+      || !northing //
+      || !nmeaFrameUtmGet(zone, south, &utm)) {
+    return false;
+  }
+
+  for (offset = 0; offset < count; offset += NMEALIB_FRAME_BLOCK) {
+    size_t n = MIN(count - offset, NMEALIB_FRAME_BLOCK);
+    double *sinLat = args;
+    double *sinLon = &args[n];
+    double *cosLon = &args[2 * n];
+    double *sin2xi = args;
+    double *cos2xi = &args[n];
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+      double l = remainder(lon[offset + i] - utm.lon0, 2.0 * NMEALIB_PI);
+
+      sinLat[i] = lat[offset + i];
+      sinLon[i] = l;
+      cosLon[i] = l + (NMEALIB_PI / 2.0);
+    }
+
+    sine(args, args, 3 * n);
+
+    /* the conformal latitude, then the spherical transverse Mercator projection */
+    for (i = 0; i < n; i++) {
+      double s = sinLat[i];
+      double tau = sinh(atanh(s) - (e * atanh(e * s)));
+
+      xi[i] = atan2(tau, cosLon[i]);
+      eta[i] = atanh(sinLon[i] / sqrt(1.0 + (tau * tau)));
+    }
+
+    for (i = 0; i < n; i++) {
+      exp2eta[i] = exp(2.0 * eta[i]);
+      sin2xi[i] = 2.0 * xi[i];
+      cos2xi[i] = (2.0 * xi[i]) + (NMEALIB_PI / 2.0);
+    }
+
+    sine(args, args, 2 * n);
+
+    /* the rectifying latitude */
+    for (i = 0; i < n; i++) {
+      double re;
+      double im;
+
+      nmeaFrameSeriesSum(sin2xi[i], cos2xi[i], exp2eta[i], utm.alpha, &re, &im);
+      easting[offset + i] = NMEALIB_UTM_EASTING + (utm.scale * (eta[i] + im));
+      northing[offset + i] = utm.northing + (utm.scale * (xi[i] + re));
+    }
+  }
+
+  return true;
+}
+
+bool nmeaFrameUtmToGeodetic(unsigned int zone, bool south, const double *easting, const double *northing,
+    size_t count, double *lat, double *lon, NmeaFrameMode mode) {
+  NmeaFrameArrayFunction sine = nmeaFrameSin(mode);
+  NmeaFrameUtm utm;
+  double args[2 * NMEALIB_FRAME_BLOCK];
+  double exp2eta[NMEALIB_FRAME_BLOCK];
+  double expEta[NMEALIB_FRAME_BLOCK];
+  double xi[NMEALIB_FRAME_BLOCK];
+  double eta[NMEALIB_FRAME_BLOCK];
+  size_t offset;
+
+  if (!easting //
+      || !northing //
+      || !lat //
+      || !lon //
+      || !nmeaFrameUtmGet(zone, south, &utm)) {
+    return false;
+  }
+
+  for (offset = 0; offset < count; offset += NMEALIB_FRAME_BLOCK) {
+    size_t n = MIN(count - offset, NMEALIB_FRAME_BLOCK);
+    double *sinXi = args;
+    double *cosXi = &args[n];
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+      xi[i] = (northing[offset + i] - utm.northing) / utm.scale;
+      eta[i] = (easting[offset + i] - NMEALIB_UTM_EASTING) / utm.scale;
+      exp2eta[i] = exp(2.0 * eta[i]);
+      sinXi[i] = 2.0 * xi[i];
+      cosXi[i] = (2.0 * xi[i]) + (NMEALIB_PI / 2.0);
+    }
+
+    sine(args, args, 2 * n);
+
+    /* the spherical transverse Mercator projection */
+    for (i = 0; i < n; i++) {
+      double re;
+      double im;
+
+      nmeaFrameSeriesSum(sinXi[i], cosXi[i], exp2eta[i], utm.beta, &re, &im);
+      xi[i] -= re;
+      eta[i] -= im;
+      expEta[i] = exp(eta[i]);
+      sinXi[i] = xi[i];
+      cosXi[i] = xi[i] + (NMEALIB_PI / 2.0);
+    }
+
+    sine(args, args, 2 * n);
+
+    /* the conformal latitude, then the geodetic latitude */
+    for (i = 0; i < n; i++) {
+      double coshEta = (expEta[i] + (1.0 / expEta[i])) * 0.5;
+      double sinhEta = (expEta[i] - (1.0 / expEta[i])) * 0.5;
+      double r = sqrt((sinhEta * sinhEta) + (cosXi[i] * cosXi[i]));
+      double sinChi = sinXi[i] / coshEta;
+      double cosChi = r / coshEta;
+      double b1 = 0.0;
+      double b2 = 0.0;
+      double twoCos2Chi = 2.0 * (cosChi - sinChi) * (cosChi + sinChi);
+      size_t l = NMEALIB_FRAME_ORDER;
+
+      while (l) {
+        double b = utm.delta[l] + (twoCos2Chi * b1) - b2;
+
+        b2 = b1;
+        b1 = b;
+        l--;
+      }
+
+      lat[offset + i] = atan2(sinXi[i], r) + (2.0 * sinChi * cosChi * b1);
+      lon[offset + i] = remainder(utm.lon0 + atan2(sinhEta, cosXi[i]), 2.0 * NMEALIB_PI);
+    }
+  }
+
+  return true;
+}
@@ -19,6 +19,7 @@
 
 #include <nmealib/context.h>
 #include <nmealib/nmath.h>
+#include <nmealib/random.h>
 #include <nmealib/sentence.h>
 #include <math.h>
 #include <stdlib.h>
@@ -41,6 +42,37 @@ bool nmeaGeneratorResetRotate(NmeaGenerator *gen, NmeaInfo *info);
 bool nmeaGeneratorInitRandomMove(NmeaGenerator *gen, NmeaInfo *info);
 bool nmeaGeneratorInvokeRandomMove(NmeaGenerator *gen, NmeaInfo *info);
 
+/*
+ * Helpers
+ */
+
+/** The number of random numbers the NOISE generator uses per invocation */
+#define NMEALIB_GENERATOR_NOISE_RANDOMS (15u + (4u * NMEALIB_MAX_SATELLITES))
+
+/**
+ * Get the random number generator of a generator
+ *
+ * @param gen The generator
+ * @return The random number generator of the generator, or the one of the thread
+ */
+static INLINE NmeaRandom *nmeaGeneratorRandom(const NmeaGenerator *gen) {
+  return (gen && gen->random) ?
+      gen->random :
+      nmeaRandomThreadState();
+}
+
+/**
+ * Scale a random number in [0, 1) into a range
+ *
+ * @param u The random number
+ * @param min The minimum value of the range
+ * @param max The maximum value of the range
+ * @return The scaled random number
+ */
+static INLINE double nmeaGeneratorScale(double u, double min, double max) {
+  return min + (u * (max - min));
+}
+
 /*
  * NOISE generator
  */
@@ -54,29 +86,33 @@ bool nmeaGeneratorInvokeRandomMove(NmeaGenerator *gen, NmeaInfo *info);
  * @param info The info structure to use during generation
  * @return True on success
  */
-bool nmeaGeneratorInvokeNoise(NmeaGenerator *gen __attribute__ ((unused)), NmeaInfo *info) {
+bool nmeaGeneratorInvokeNoise(NmeaGenerator *gen, NmeaInfo *info) {
+  double randoms[NMEALIB_GENERATOR_NOISE_RANDOMS];
+  const double *u = randoms;
   size_t i;
-  size_t inUseCount;
+  bool inUse;
 
   if (!info) {
     return false;
   }
 
-  info->sig = (int) lrint(nmeaRandom(NMEALIB_SIG_FIX, NMEALIB_SIG_SENSITIVE));
-  info->fix = (int) lrint(nmeaRandom(NMEALIB_FIX_2D, NMEALIB_FIX_3D));
-  info->pdop = nmeaRandom(0.0, 9.0);
-  info->hdop = nmeaRandom(0.0, 9.0);
-  info->vdop = nmeaRandom(0.0, 9.0);
-  info->latitude = nmeaRandom(0.0, 100.0);
-  info->longitude = nmeaRandom(0.0, 100.0);
-  info->elevation = nmeaRandom(-100.0, 100.0);
-  info->height = nmeaRandom(-100.0, 100.0);
-  info->speed = nmeaRandom(0.0, 100.0);
-  info->track = nmeaRandom(0.0, 360.0);
-  info->mtrack = nmeaRandom(0.0, 360.0);
-  info->magvar = nmeaRandom(0.0, 360.0);
-  info->dgpsAge = nmeaRandom(0.0, 100.0);
-  info->dgpsSid = (unsigned int) lrint(nmeaRandom(0.0, 100.0));
+  nmeaRandomFill(nmeaGeneratorRandom(gen), randoms, NMEALIB_GENERATOR_NOISE_RANDOMS, 0.0, 1.0);
+
+  info->sig = (int) lrint(nmeaGeneratorScale(*u++, NMEALIB_SIG_FIX, NMEALIB_SIG_SENSITIVE));
+  info->fix = (int) lrint(nmeaGeneratorScale(*u++, NMEALIB_FIX_2D, NMEALIB_FIX_3D));
+  info->pdop = nmeaGeneratorScale(*u++, 0.0, 9.0);
+  info->hdop = nmeaGeneratorScale(*u++, 0.0, 9.0);
+  info->vdop = nmeaGeneratorScale(*u++, 0.0, 9.0);
+  info->latitude = nmeaGeneratorScale(*u++, 0.0, 100.0);
+  info->longitude = nmeaGeneratorScale(*u++, 0.0, 100.0);
+  info->elevation = nmeaGeneratorScale(*u++, -100.0, 100.0);
+  info->height = nmeaGeneratorScale(*u++, -100.0, 100.0);
+  info->speed = nmeaGeneratorScale(*u++, 0.0, 100.0);
+  info->track = nmeaGeneratorScale(*u++, 0.0, 360.0);
+  info->mtrack = nmeaGeneratorScale(*u++, 0.0, 360.0);
+  info->magvar = nmeaGeneratorScale(*u++, 0.0, 360.0);
+  info->dgpsAge = nmeaGeneratorScale(*u++, 0.0, 100.0);
+  info->dgpsSid = (unsigned int) lrint(nmeaGeneratorScale(*u++, 0.0, 100.0));
 
   nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_SIG);
   nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_FIX);
@@ -98,21 +134,21 @@ bool nmeaGeneratorInvokeNoise(NmeaGenerator *gen __attribute__ ((unused)), NmeaI
   info->satellites.inViewCount = 0;
 
   for (i = 0; i < NMEALIB_MAX_SATELLITES; i++) {
-    inUseCount = (size_t) labs(lrint(nmeaRandom(0.0, 3.0)));
+    inUse = lrint(nmeaGeneratorScale(*u++, 0.0, 3.0)) != 0;
 
-    info->satellites.inUse[i] = inUseCount ?
+    info->satellites.inUse[i] = inUse ?
         (unsigned int) i :
         0;
-    if (inUseCount) {
+    if (inUse) {
       info->satellites.inUseCount++;
     }
 
     info->satellites.inView[i].prn = (unsigned int) i;
-    info->satellites.inView[i].elevation = (int) lrint(nmeaRandom(0.0, 90.0));
-    info->satellites.inView[i].azimuth = (unsigned int) lrint(nmeaRandom(0.0, 359.0));
-    info->satellites.inView[i].snr = inUseCount ?
-        (unsigned int) lrint(nmeaRandom(40.0, 99.0)) :
-        (unsigned int) lrint(nmeaRandom(0.0, 40.0));
+    info->satellites.inView[i].elevation = (int) lrint(nmeaGeneratorScale(*u++, 0.0, 90.0));
+    info->satellites.inView[i].azimuth = (unsigned int) lrint(nmeaGeneratorScale(*u++, 0.0, 359.0));
+    info->satellites.inView[i].snr = inUse ?
+        (unsigned int) lrint(nmeaGeneratorScale(*u++, 40.0, 99.0)) :
+        (unsigned int) lrint(nmeaGeneratorScale(*u++, 0.0, 40.0));
     if (info->satellites.inView[i].snr) {
       info->satellites.inViewCount++;
     }
@@ -373,16 +409,17 @@ bool nmeaGeneratorInitRandomMove(NmeaGenerator *gen __attribute__ ((unused)), Nm
  * @param info The info structure to use during generation
  * @return True on success
  */
-bool nmeaGeneratorInvokeRandomMove(NmeaGenerator *gen __attribute__ ((unused)), NmeaInfo *info) {
+bool nmeaGeneratorInvokeRandomMove(NmeaGenerator *gen, NmeaInfo *info) {
+  NmeaRandom *random = nmeaGeneratorRandom(gen);
   NmeaPosition pos;
 
   if (!info) {
     return false;
   }
 
-  info->track += nmeaRandom(-10.0, 10.0);
-  info->mtrack += nmeaRandom(-10.0, 10.0);
-  info->speed += nmeaRandom(-2.0, 3.0);
+  info->track += nmeaRandomDouble(random, -10.0, 10.0);
+  info->mtrack += nmeaRandomDouble(random, -10.0, 10.0);
+  info->speed += nmeaRandomDouble(random, -2.0, 3.0);
 
   if (info->track < 0.0) {
     info->track = 360.0 + info->track;
@@ -407,7 +444,9 @@ bool nmeaGeneratorInvokeRandomMove(NmeaGenerator *gen __attribute__ ((unused)),
 
 
   nmeaMathInfoToPosition(info, &pos);
-  nmeaMathMoveFlat(&pos, &pos, info->track, info->speed / 3600.0);
+  nmeaMathMoveFlatMode(&pos, &pos, info->track, info->speed / 3600.0, gen ?
+      gen->mathMode :
+      NMEALIB_MATH_EXACT);
   nmeaMathPositionToInfo(&pos, info);
 
   info->magvar = info->track;
@@ -464,19 +503,14 @@ bool nmeaGeneratorInit(NmeaGenerator *gen, NmeaInfo *info) {
   return r;
 }
 
-NmeaGenerator *nmeaGeneratorCreate(NmeaGeneratorType type, NmeaInfo *info) {
-  NmeaGenerator *gen = 0;
-
-  if (!info) {
-    return NULL;
-  }
-
-  gen = calloc(1, sizeof(NmeaGenerator));
-  if (!gen) {
-    /* can't be covered in a test */
-    return NULL;
-  }
-
+/**
+ * Set the functions of a generator node
+ *
+ * @param gen The generator node
+ * @param type The type of the generator
+ * @return True on success
+ */
+static bool nmeaGeneratorSetup(NmeaGenerator *gen, NmeaGeneratorType type) {
   switch (type) {
     case NMEALIB_GENERATOR_NOISE:
       gen->invoke = nmeaGeneratorInvokeNoise;
@@ -494,10 +528,6 @@ NmeaGenerator *nmeaGeneratorCreate(NmeaGeneratorType type, NmeaInfo *info) {
       gen->init = nmeaGeneratorInitRotate;
       gen->invoke = nmeaGeneratorInvokeRotate;
       gen->reset = nmeaGeneratorResetRotate;
-
-      if (type == NMEALIB_GENERATOR_ROTATE) {
-        nmeaGeneratorAppend(gen, nmeaGeneratorCreate(NMEALIB_GENERATOR_POS_RANDMOVE, info));
-      }
       break;
 
     case NMEALIB_GENERATOR_POS_RANDMOVE:
@@ -506,15 +536,79 @@ NmeaGenerator *nmeaGeneratorCreate(NmeaGeneratorType type, NmeaInfo *info) {
       break;
 
     default:
-      free(gen);
-      return NULL;
+      return false;
   };
 
+  return true;
+}
+
+NmeaGenerator *nmeaGeneratorCreate(NmeaGeneratorType type, NmeaInfo *info) {
+  NmeaGenerator *gen = 0;
+
+  if (!info) {
+    return NULL;
+  }
+
+  gen = calloc(1, sizeof(NmeaGenerator));
+  if (!gen) {
+    /* can't be covered in a test */
+    return NULL;
+  }
+
+  if (!nmeaGeneratorSetup(gen, type)) {
+    free(gen);
+    return NULL;
+  }
+
+  if (type == NMEALIB_GENERATOR_ROTATE) {
+    nmeaGeneratorAppend(gen, nmeaGeneratorCreate(NMEALIB_GENERATOR_POS_RANDMOVE, info));
+  }
+
   nmeaGeneratorInit(gen, info);
 
   return gen;
 }
 
+size_t nmeaGeneratorNodes(NmeaGeneratorType type) {
+  switch (type) {
+    case NMEALIB_GENERATOR_ROTATE:
+      return 2;
+
+    case NMEALIB_GENERATOR_NOISE:
+    case NMEALIB_GENERATOR_STATIC:
+    case NMEALIB_GENERATOR_SAT_STATIC:
+    case NMEALIB_GENERATOR_SAT_ROTATE:
+    case NMEALIB_GENERATOR_POS_RANDMOVE:
+      return 1;
+
+    default:
+      return 0;
+  }
+}
+
+NmeaGenerator *nmeaGeneratorCreateIn(NmeaGenerator *nodes, size_t count, NmeaGeneratorType type, NmeaInfo *info) {
+  size_t needed = nmeaGeneratorNodes(type);
+
+  if (!nodes //
+      || !info //
+      || !needed //
+      || (count < needed)) {
+    return NULL;
+  }
+
+  memset(nodes, 0, needed * sizeof(nodes[0]));
+  nmeaGeneratorSetup(&nodes[0], type);
+
+  if (type == NMEALIB_GENERATOR_ROTATE) {
+    nmeaGeneratorSetup(&nodes[1], NMEALIB_GENERATOR_POS_RANDMOVE);
+    nodes[0].next = &nodes[1];
+  }
+
+  nmeaGeneratorInit(nodes, info);
+
+  return nodes;
+}
+
 bool nmeaGeneratorReset(NmeaGenerator *gen, NmeaInfo *info) {
   bool r = true;
 
@@ -563,6 +657,30 @@ bool nmeaGeneratorInvoke(NmeaGenerator *gen, NmeaInfo *info) {
   return r;
 }
 
+void nmeaGeneratorSetRandom(NmeaGenerator *gen, NmeaRandom *random) {
+  NmeaGenerator *g = gen;
+
+  while (g) {
+    g->random = random;
+    g = g->next;
+    if (g == gen) {
+      break;
+    }
+  }
+}
+
+void nmeaGeneratorSetMathMode(NmeaGenerator *gen, NmeaMathMode mode) {
+  NmeaGenerator *g = gen;
+
+  while (g) {
+    g->mathMode = mode;
+    g = g->next;
+    if (g == gen) {
+      break;
+    }
+  }
+}
+
 void nmeaGeneratorAppend(NmeaGenerator *to, NmeaGenerator *gen) {
   NmeaGenerator *next;
 
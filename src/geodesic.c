@@ -0,0 +1,950 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/geodesic.h>
+
+#include <nmealib/nmath.h>
+#include <nmealib/util.h>
+#include <float.h>
+#include <math.h>
+
+/*
+ * Ellipsoid, WGS84
+ */
+
+/** The semi-major axis */
+#define NMEALIB_GEODESIC_A   ((double) NMEALIB_EARTHRADIUS_M)
+
+/** The flattening */
+#define NMEALIB_GEODESIC_F   (NMEALIB_EARTH_FLATTENING)
+
+/** 1 - f */
+#define NMEALIB_GEODESIC_F1  (1.0 - NMEALIB_GEODESIC_F)
+
+/** The semi-minor axis */
+#define NMEALIB_GEODESIC_B   (NMEALIB_GEODESIC_A * NMEALIB_GEODESIC_F1)
+
+/** The second eccentricity squared */
+#define NMEALIB_GEODESIC_EP2 ((NMEALIB_GEODESIC_F * (2.0 - NMEALIB_GEODESIC_F)) / (NMEALIB_GEODESIC_F1 * NMEALIB_GEODESIC_F1))
+
+/** The third flattening */
+#define NMEALIB_GEODESIC_N   (NMEALIB_GEODESIC_F / (2.0 - NMEALIB_GEODESIC_F))
+
+/** The number of terms of the sine series */
+#define NMEALIB_GEODESIC_ORDER (6u)
+
+/** A cosine that stands in for 0 at the poles */
+#define NMEALIB_GEODESIC_TINY  (1E-150)
+
+/** The maximum number of Newton steps of the inverse problem, before it only bisects */
+#define NMEALIB_GEODESIC_NEWTON_STEPS (16u)
+
+/** The maximum number of steps of the inverse problem */
+#define NMEALIB_GEODESIC_STEPS (96u)
+
+/** A longitude difference error of the inverse problem below which the next Newton step is the last */
+#define NMEALIB_GEODESIC_LAST_STEP (1E-8)
+
+/** A Newton step of the inverse problem below which the azimuth is rotated with Taylor series */
+#define NMEALIB_GEODESIC_SMALL_STEP (1E-4)
+
+/** The maximum number of Newton steps of the distance to arc length inversion */
+#define NMEALIB_GEODESIC_ARC_STEPS (4u)
+
+/** The convergence tolerance of the iterations */
+#define NMEALIB_GEODESIC_TOLERANCE (4.0 * DBL_EPSILON)
+
+/** The arc length below which a short line is solved on the auxiliary sphere (Karney's etol2) */
+#define NMEALIB_GEODESIC_SHORT_LINE \
+    ((0.1 * sqrt(DBL_EPSILON)) / sqrt((NMEALIB_GEODESIC_F * (1.0 - (NMEALIB_GEODESIC_F / 2.0))) / 2.0))
+
+/** The scaled latitude difference from the antipode within which the line is near the cut (Karney's tol1) */
+#define NMEALIB_GEODESIC_CUT_Y (200.0 * DBL_EPSILON)
+
+/** The scaled longitude difference beyond -1 within which the line is near the cut (Karney's xthresh) */
+#define NMEALIB_GEODESIC_CUT_X (1000.0 * sqrt(DBL_EPSILON))
+
+/**
+ * The coefficients of a sine series: c[1] sin(2x) + ... + c[n] sin(2nx), c[0]
+ * is unused
+ */
+typedef double NmeaGeodesicSeries[NMEALIB_GEODESIC_ORDER + 1];
+
+/**
+ * A geodesic between 2 positions on the auxiliary sphere, for an azimuth at
+ * the first position
+ */
+typedef struct _NmeaGeodesicArc {
+    double sinAlpha1;  /**< The sine of the azimuth at the first position             */
+    double cosAlpha1;  /**< The cosine of the azimuth at the first position           */
+    double sinAlpha2;  /**< The sine of the azimuth at the second position            */
+    double cosAlpha2;  /**< The cosine of the azimuth at the second position          */
+    double sinSigma1;  /**< The sine of the arc length from the node to the first     */
+    double cosSigma1;  /**< The cosine of the arc length from the node to the first   */
+    double sinSigma2;  /**< The sine of the arc length from the node to the second    */
+    double cosSigma2;  /**< The cosine of the arc length from the node to the second  */
+    double sigma12;    /**< The arc length between the positions                      */
+    double eps;        /**< The expansion parameter of the series                     */
+    double lambda12;   /**< The longitude difference                                  */
+    double slope;      /**< The derivative of lambda12 to the azimuth at the first    */
+} NmeaGeodesicArc;
+
+/*
+ * Helpers
+ */
+
+/**
+ * Normalise a sine and a cosine
+ *
+ * @param s The sine
+ * @param c The cosine
+ */
+static INLINE void nmeaGeodesicNormalise(double *s, double *c) {
+  double r = 1.0 / sqrt((*s * *s) + (*c * *c));
+
+  *s *= r;
+  *c *= r;
+}
+
+/**
+ * Evaluate a sine series with Clenshaw summation
+ *
+ * @param s The sine of x
+ * @param c The cosine of x
+ * @param series The coefficients
+ * @return c[1] sin(2x) + ... + c[n] sin(2nx)
+ */
+static double nmeaGeodesicSeriesSum(double s, double c, const NmeaGeodesicSeries series) {
+  double twoCos2x = 2.0 * (c - s) * (c + s);
+  double b1 = 0.0;
+  double b2 = 0.0;
+  size_t l = NMEALIB_GEODESIC_ORDER;
+
+  while (l) {
+    double b = series[l] + (twoCos2x * b1) - b2;
+
+    b2 = b1;
+    b1 = b;
+    l--;
+  }
+
+  return 2.0 * s * c * b1;
+}
+
+/**
+ * Evaluate the difference of a sine series between 2 points, with the
+ * Clenshaw summations of both interleaved
+ *
+ * @param s1 The sine of x1
+ * @param c1 The cosine of x1
+ * @param s2 The sine of x2
+ * @param c2 The cosine of x2
+ * @param series The coefficients
+ * @return The series at x2 minus the series at x1
+ */
+static double nmeaGeodesicSeriesDiff(double s1, double c1, double s2, double c2, const NmeaGeodesicSeries series) {
+  double twoCos2x1 = 2.0 * (c1 - s1) * (c1 + s1);
+  double twoCos2x2 = 2.0 * (c2 - s2) * (c2 + s2);
+  double b11 = 0.0;
+  double b21 = 0.0;
+  double b12 = 0.0;
+  double b22 = 0.0;
+  size_t l = NMEALIB_GEODESIC_ORDER;
+
+  while (l) {
+    double b1 = series[l] + (twoCos2x1 * b11) - b21;
+    double b2 = series[l] + (twoCos2x2 * b12) - b22;
+
+    b21 = b11;
+    b11 = b1;
+    b22 = b12;
+    b12 = b2;
+    l--;
+  }
+
+  return (2.0 * s2 * c2 * b12) - (2.0 * s1 * c1 * b11);
+}
+
+/**
+ * The expansion parameter of the series
+ *
+ * @param cosAlpha0 The cosine of the azimuth at the node
+ * @param k2 The location in which to store k^2
+ * @return eps
+ */
+static INLINE double nmeaGeodesicEps(double cosAlpha0, double *k2) {
+  *k2 = cosAlpha0 * cosAlpha0 * NMEALIB_GEODESIC_EP2;
+  return *k2 / ((2.0 * (1.0 + sqrt(1.0 + *k2))) + *k2);
+}
+
+/**
+ * The distance integral: s / b = A1 (sigma + sum(C1[l] sin(2 l sigma)))
+ *
+ * @param eps The expansion parameter
+ * @param c1 The location in which to store the coefficients C1
+ * @return A1
+ */
+static double nmeaGeodesicA1(double eps, NmeaGeodesicSeries c1) {
+  double e2 = eps * eps;
+  double e3 = e2 * eps;
+
+  c1[0] = 0.0;
+  c1[1] = eps * (-1.0 / 2.0 + e2 * (3.0 / 16.0 - e2 / 32.0));
+  c1[2] = e2 * (-1.0 / 16.0 + e2 * (1.0 / 32.0 - e2 * 9.0 / 2048.0));
+  c1[3] = e3 * (-1.0 / 48.0 + e2 * 3.0 / 256.0);
+  c1[4] = e2 * e2 * (-5.0 / 512.0 + e2 * 3.0 / 512.0);
+  c1[5] = e3 * e2 * (-7.0 / 1280.0);
+  c1[6] = e3 * e3 * (-7.0 / 2048.0);
+
+  return (1.0 + e2 * (1.0 / 4.0 + e2 * (1.0 / 64.0 + e2 / 256.0))) / (1.0 - eps);
+}
+
+/**
+ * The reduced length integral: A2 (sigma + sum(C2[l] sin(2 l sigma)))
+ *
+ * @param eps The expansion parameter
+ * @param c2 The location in which to store the coefficients C2
+ * @return A2
+ */
+static double nmeaGeodesicA2(double eps, NmeaGeodesicSeries c2) {
+  double e2 = eps * eps;
+  double e3 = e2 * eps;
+
+  c2[0] = 0.0;
+  c2[1] = eps * (1.0 / 2.0 + e2 * (1.0 / 16.0 + e2 / 32.0));
+  c2[2] = e2 * (3.0 / 16.0 + e2 * (1.0 / 32.0 + e2 * 35.0 / 1024.0));
+  c2[3] = e3 * (5.0 / 48.0 + e2 * 5.0 / 256.0);
+  c2[4] = e2 * e2 * (35.0 / 512.0 + e2 * 7.0 / 128.0);
+  c2[5] = e3 * e2 * (63.0 / 1280.0);
+  c2[6] = e3 * e3 * (77.0 / 2048.0);
+
+  return (1.0 - e2 * (3.0 / 4.0 + e2 * (7.0 / 64.0 + e2 * 11.0 / 256.0))) / (1.0 + eps);
+}
+
+/**
+ * The longitude integral: A3 (sigma + sum(C3[l] sin(2 l sigma)))
+ *
+ * @param eps The expansion parameter
+ * @param c3 The location in which to store the coefficients C3
+ * @return A3
+ */
+static double nmeaGeodesicA3(double eps, NmeaGeodesicSeries c3) {
+  const double n = NMEALIB_GEODESIC_N;
+  const double n2 = n * n;
+  double e2 = eps * eps;
+  double e3 = e2 * eps;
+  double e4 = e2 * e2;
+  double e5 = e4 * eps;
+
+  c3[0] = 0.0;
+  c3[1] = (eps * (1.0 - n) / 4.0) //
+      + (e2 * (1.0 - n2) / 8.0) //
+      + (e3 * (3.0 + (3.0 * n) - n2) / 64.0) //
+      + (e4 * (5.0 + (2.0 * n)) / 128.0) //
+      + (e5 * 3.0 / 128.0);
+  c3[2] = (e2 * (2.0 - (3.0 * n) + n2) / 32.0) //
+      + (e3 * (3.0 - (2.0 * n) - (3.0 * n2)) / 64.0) //
+      + (e4 * (3.0 + n) / 128.0) //
+      + (e5 * 5.0 / 256.0);
+  c3[3] = (e3 * (5.0 - (9.0 * n) + (5.0 * n2)) / 192.0) //
+      + (e4 * (9.0 - (10.0 * n)) / 384.0) //
+      + (e5 * 7.0 / 512.0);
+  c3[4] = (e4 * (7.0 - (14.0 * n)) / 512.0) //
+      + (e5 * 7.0 / 512.0);
+  c3[5] = e5 * 21.0 / 2560.0;
+  c3[6] = 0.0;
+
+  return 1.0 //
+      - (eps * (1.0 - n) / 2.0) //
+      - (e2 * (2.0 + n - (3.0 * n2)) / 8.0) //
+      - (e3 * (1.0 + (3.0 * n) + n2) / 16.0) //
+      - (e4 * (3.0 + (2.0 * n)) / 64.0) //
+      - (e5 * 3.0 / 128.0);
+}
+
+/**
+ * Compute the sine and cosine of the reduced latitude of a latitude
+ *
+ * @param lat The latitude (in radians)
+ * @param sinBeta The location in which to store the sine
+ * @param cosBeta The location in which to store the cosine, at least
+ * NMEALIB_GEODESIC_TINY
+ */
+static void nmeaGeodesicReducedLatitude(double lat, double *sinBeta, double *cosBeta) {
+  *sinBeta = NMEALIB_GEODESIC_F1 * sin(lat);
+  *cosBeta = cos(lat);
+  nmeaGeodesicNormalise(sinBeta, cosBeta);
+  *cosBeta = MAX(*cosBeta, NMEALIB_GEODESIC_TINY);
+}
+
+/**
+ * Follow a geodesic from a first to a second reduced latitude, in the
+ * canonical configuration of the inverse problem: sinBeta1 <= 0 and
+ * |sinBeta2| <= |sinBeta1|
+ *
+ * @param sinBeta1 The sine of the first reduced latitude
+ * @param cosBeta1 The cosine of the first reduced latitude
+ * @param sinBeta2 The sine of the second reduced latitude
+ * @param cosBeta2 The cosine of the second reduced latitude
+ * @param sinAlpha1 The sine of the azimuth at the first position, >= 0
+ * @param cosAlpha1 The cosine of the azimuth at the first position
+ * @param slope True to compute the derivative of the longitude difference
+ * @param arc The location in which to store the geodesic
+ */
+static void nmeaGeodesicArc(double sinBeta1, double cosBeta1, double sinBeta2, double cosBeta2, double sinAlpha1,
+    double cosAlpha1, bool slope, NmeaGeodesicArc *arc) {
+  NmeaGeodesicSeries c;
+  double sinAlpha0;
+  double cosAlpha0;
+  double sinOmega1;
+  double cosOmega1;
+  double sinOmega2;
+  double cosOmega2;
+  double omega12;
+  double k2;
+  double a3;
+
+  /* an equatorial geodesic that heads due north or south isn't equatorial */
+  if ((sinBeta1 == 0.0) //
+      && (cosAlpha1 == 0.0)) {
+    cosAlpha1 = -NMEALIB_GEODESIC_TINY;
+  }
+
+  arc->sinAlpha1 = sinAlpha1;
+  arc->cosAlpha1 = cosAlpha1;
+
+  /* Clairaut: the azimuth at the node */
+  sinAlpha0 = sinAlpha1 * cosBeta1;
+  cosAlpha0 = sqrt((cosAlpha1 * cosAlpha1) + (sinAlpha1 * sinBeta1 * sinAlpha1 * sinBeta1));
+
+  arc->sinSigma1 = sinBeta1;
+  arc->cosSigma1 = cosAlpha1 * cosBeta1;
+  sinOmega1 = sinAlpha0 * sinBeta1;
+  cosOmega1 = arc->cosSigma1;
+  nmeaGeodesicNormalise(&arc->sinSigma1, &arc->cosSigma1);
+
+  /* the geodesic reaches the second latitude heading north */
+  arc->sinAlpha2 = (cosBeta2 != cosBeta1) ?
+      sinAlpha0 / cosBeta2 :
+      sinAlpha1;
+  if ((cosBeta2 != cosBeta1) //
+      || (fabs(sinBeta2) != -sinBeta1)) {
+    double d = (cosBeta1 < -sinBeta1) ?
+        (cosBeta2 - cosBeta1) * (cosBeta1 + cosBeta2) :
+        (sinBeta1 - sinBeta2) * (sinBeta1 + sinBeta2);
+
+    /* d rounds slightly below -(cosAlpha1 cosBeta1)^2 for nearly coincident positions */
+    arc->cosAlpha2 = sqrt(MAX(0.0, (cosAlpha1 * cosBeta1 * cosAlpha1 * cosBeta1) + d)) / cosBeta2;
+  } else {
+    arc->cosAlpha2 = fabs(cosAlpha1);
+  }
+
+  arc->sinSigma2 = sinBeta2;
+  arc->cosSigma2 = arc->cosAlpha2 * cosBeta2;
+  sinOmega2 = sinAlpha0 * sinBeta2;
+  cosOmega2 = arc->cosSigma2;
+  nmeaGeodesicNormalise(&arc->sinSigma2, &arc->cosSigma2);
+
+  arc->sigma12 = atan2( //
+      MAX(0.0, (arc->cosSigma1 * arc->sinSigma2) - (arc->sinSigma1 * arc->cosSigma2)), //
+      (arc->cosSigma1 * arc->cosSigma2) + (arc->sinSigma1 * arc->sinSigma2));
+  omega12 = atan2( //
+      MAX(0.0, (cosOmega1 * sinOmega2) - (sinOmega1 * cosOmega2)), //
+      (cosOmega1 * cosOmega2) + (sinOmega1 * sinOmega2));
+
+  /* the longitude on the ellipsoid lags the one on the auxiliary sphere */
+  arc->eps = nmeaGeodesicEps(cosAlpha0, &k2);
+  a3 = nmeaGeodesicA3(arc->eps, c);
+  arc->lambda12 = omega12 - (NMEALIB_GEODESIC_F * a3 * sinAlpha0 * (arc->sigma12 //
+      + nmeaGeodesicSeriesDiff(arc->sinSigma1, arc->cosSigma1, arc->sinSigma2, arc->cosSigma2, c)));
+
+  arc->slope = 0.0;
+  if (!slope) {
+    return;
+  }
+
+  if (arc->cosAlpha2 == 0.0) {
+    arc->slope = (-2.0 * NMEALIB_GEODESIC_F1 * sqrt(1.0 + (NMEALIB_GEODESIC_EP2 * sinBeta1 * sinBeta1))) / sinBeta1;
+  } else {
+    /* the reduced length m12 / b */
+    NmeaGeodesicSeries c2;
+    double a1 = nmeaGeodesicA1(arc->eps, c);
+    double a2 = nmeaGeodesicA2(arc->eps, c2);
+    double b1 = nmeaGeodesicSeriesDiff(arc->sinSigma1, arc->cosSigma1, arc->sinSigma2, arc->cosSigma2, c);
+    double b2 = nmeaGeodesicSeriesDiff(arc->sinSigma1, arc->cosSigma1, arc->sinSigma2, arc->cosSigma2, c2);
+    double j12 = ((a1 - a2) * arc->sigma12) + ((a1 * b1) - (a2 * b2));
+    double dn1 = sqrt(1.0 + (k2 * arc->sinSigma1 * arc->sinSigma1));
+    double dn2 = sqrt(1.0 + (k2 * arc->sinSigma2 * arc->sinSigma2));
+    double m12 = (dn2 * arc->cosSigma1 * arc->sinSigma2) - (dn1 * arc->sinSigma1 * arc->cosSigma2)
+        - (arc->cosSigma1 * arc->cosSigma2 * j12);
+
+    arc->slope = (m12 * NMEALIB_GEODESIC_F1) / (arc->cosAlpha2 * cosBeta2);
+  }
+}
+
+/**
+ * The distance along a geodesic
+ *
+ * @param arc The geodesic
+ * @return The distance in meters
+ */
+static double nmeaGeodesicArcDistance(const NmeaGeodesicArc *arc) {
+  NmeaGeodesicSeries c1;
+  double a1 = nmeaGeodesicA1(arc->eps, c1);
+
+  return NMEALIB_GEODESIC_B * a1 * (arc->sigma12 //
+      + nmeaGeodesicSeriesDiff(arc->sinSigma1, arc->cosSigma1, arc->sinSigma2, arc->cosSigma2, c1));
+}
+
+/**
+ * Solve a very short line of the inverse problem, in the canonical
+ * configuration
+ *
+ * The great circle on the auxiliary sphere, with the longitude scaled at the
+ * mean latitude, is the start of the iterations, as in the InverseStart of
+ * Karney. Lines shorter than NMEALIB_GEODESIC_SHORT_LINE are solved by it:
+ * that is exact to rounding, while the longitude difference of the iterations,
+ * or the latitude difference of a meridian, would drown in rounding errors.
+ * Only the azimuths and sigma12 of the geodesic are set then.
+ *
+ * @param sinBeta1 The sine of the first reduced latitude
+ * @param cosBeta1 The cosine of the first reduced latitude
+ * @param sinBeta2 The sine of the second reduced latitude
+ * @param cosBeta2 The cosine of the second reduced latitude
+ * @param lambda12 The longitude difference, in [0, pi)
+ * @param arc The location in which to store the geodesic, or the (not
+ * normalised) estimate of the azimuth at the first position when the line
+ * isn't short
+ * @param distance The location in which to store the distance in meters
+ * @return True when the line is short and solved
+ */
+static bool nmeaGeodesicShortLine(double sinBeta1, double cosBeta1, double sinBeta2, double cosBeta2,
+    double lambda12, NmeaGeodesicArc *arc, double *distance) {
+  double sinBeta12 = (sinBeta2 * cosBeta1) - (cosBeta2 * sinBeta1);
+  double sinBeta12a = (sinBeta2 * cosBeta1) + (cosBeta2 * sinBeta1);
+  double sinBetaM2;
+  double dnM;
+  double omega12;
+  double sinOmega12;
+  double cosOmega12;
+  double sinSigma12;
+
+  sinBetaM2 = (sinBeta1 + sinBeta2) * (sinBeta1 + sinBeta2);
+  sinBetaM2 /= sinBetaM2 + ((cosBeta1 + cosBeta2) * (cosBeta1 + cosBeta2));
+  dnM = sqrt(1.0 + (NMEALIB_GEODESIC_EP2 * sinBetaM2));
+  omega12 = lambda12 / (NMEALIB_GEODESIC_F1 * dnM);
+  sinOmega12 = sin(omega12);
+  cosOmega12 = cos(omega12);
+  arc->sinAlpha1 = cosBeta2 * sinOmega12;
+  arc->cosAlpha1 = (cosOmega12 >= 0.0) ?
+      sinBeta12 + ((cosBeta2 * sinBeta1 * sinOmega12 * sinOmega12) / (1.0 + cosOmega12)) :
+      sinBeta12a - ((cosBeta2 * sinBeta1 * sinOmega12 * sinOmega12) / (1.0 - cosOmega12));
+  sinSigma12 = sqrt((arc->sinAlpha1 * arc->sinAlpha1) + (arc->cosAlpha1 * arc->cosAlpha1));
+
+  /* coincident positions are left to the meridian, which heads due north */
+  if ((sinSigma12 == 0.0) //
+      || (sinSigma12 >= NMEALIB_GEODESIC_SHORT_LINE) //
+      || (((cosBeta2 * cosBeta1) + (sinBeta2 * sinBeta1)) < 0.0)) {
+    return false;
+  }
+
+  nmeaGeodesicNormalise(&arc->sinAlpha1, &arc->cosAlpha1);
+  arc->sinAlpha2 = cosBeta1 * sinOmega12;
+  arc->cosAlpha2 = sinBeta12 - (cosBeta1 * sinBeta2 * ((cosOmega12 >= 0.0) ?
+      (sinOmega12 * sinOmega12) / (1.0 + cosOmega12) :
+      1.0 - cosOmega12));
+  nmeaGeodesicNormalise(&arc->sinAlpha2, &arc->cosAlpha2);
+  arc->sigma12 = atan2(sinSigma12, (sinBeta1 * sinBeta2) + (cosBeta1 * cosBeta2 * cosOmega12));
+
+  *distance = NMEALIB_GEODESIC_B * dnM * arc->sigma12;
+  return true;
+}
+
+/**
+ * Solve the astroid equation k^4 + 2 k^3 - (x^2 + y^2 - 1) k^2 - 2 y^2 k - y^2
+ * = 0 for its positive root, as in the Astroid of Karney
+ *
+ * @param x The scaled longitude difference from the antipode
+ * @param y The scaled latitude difference from the antipode
+ * @return k
+ */
+static double nmeaGeodesicAstroid(double x, double y) {
+  double p = x * x;
+  double q = y * y;
+  double r = (p + q - 1.0) / 6.0;
+  double s;
+  double r2;
+  double r3;
+  double disc;
+  double u;
+  double v;
+  double uv;
+  double w;
+
+  if ((q == 0.0) //
+      && (r <= 0.0)) {
+    return 0.0;
+  }
+
+  s = (p * q) / 4.0;
+  r2 = r * r;
+  r3 = r * r2;
+
+  /* the discriminant of the quadratic equation for t^3, zero on the evolute p^(1/3) + q^(1/3) = 1 */
+  disc = s * (s + (2.0 * r3));
+  u = r;
+  if (disc >= 0.0) {
+    double t3 = s + r3;
+    double t;
+
+    /* the sign of the root that maximises |t3| avoids cancellation */
+    t3 += (t3 < 0.0) ?
+        -sqrt(disc) :
+        sqrt(disc);
+    t = cbrt(t3);
+    u += t + ((t != 0.0) ?
+        r2 / t :
+        0.0);
+  } else {
+    /* t is complex, u is real: the cube root that avoids cancellation */
+    u += 2.0 * r * cos(atan2(sqrt(-disc), -(s + r3)) / 3.0);
+  }
+
+  v = sqrt((u * u) + q);
+  uv = (u < 0.0) ?
+      q / (v - u) :
+      u + v;
+  w = (uv - q) / (2.0 * v);
+
+  return uv / (sqrt(uv + (w * w)) + w);
+}
+
+/**
+ * Estimate the azimuth at the first position of a nearly antipodal line, in
+ * the canonical configuration
+ *
+ * Near the antipode the longitude difference hardly depends on the azimuth,
+ * so the spherical estimate can be far off and the Newton steps from it tiny.
+ * The antipode is scaled to the origin of the astroid problem of Karney,
+ * whose solution is a start close enough for Newton to converge.
+ *
+ * @param sinBeta1 The sine of the first reduced latitude
+ * @param cosBeta1 The cosine of the first reduced latitude
+ * @param sinBeta2 The sine of the second reduced latitude
+ * @param cosBeta2 The cosine of the second reduced latitude
+ * @param lambda12 The longitude difference, in (0, pi)
+ * @param arc The geodesic, holding the spherical estimate of the azimuth at
+ * the first position, which is replaced when the line is nearly antipodal
+ */
+static void nmeaGeodesicAntipodalStart(double sinBeta1, double cosBeta1, double sinBeta2, double cosBeta2,
+    double lambda12, NmeaGeodesicArc *arc) {
+  NmeaGeodesicSeries c;
+  double sinBeta12a = (sinBeta2 * cosBeta1) + (cosBeta2 * sinBeta1);
+  double sinLambda12;
+  double cosLambda12;
+  double sinSigma12;
+  double cosSigma12;
+  double lambdaScale;
+  double k2;
+  double x;
+  double y;
+
+  /* the astroid is within 3 n pi^2 of the antipodal longitude */
+  if ((NMEALIB_PI - lambda12) > (4.0 * NMEALIB_GEODESIC_N * NMEALIB_PI * NMEALIB_PI)) {
+    return;
+  }
+
+  /* the spherical estimate, with the longitude difference itself */
+  sinLambda12 = sin(lambda12);
+  cosLambda12 = cos(lambda12);
+  arc->sinAlpha1 = cosBeta2 * sinLambda12;
+  arc->cosAlpha1 = (cosLambda12 >= 0.0) ?
+      ((sinBeta2 * cosBeta1) - (cosBeta2 * sinBeta1))
+          + ((cosBeta2 * sinBeta1 * sinLambda12 * sinLambda12) / (1.0 + cosLambda12)) :
+      sinBeta12a - ((cosBeta2 * sinBeta1 * sinLambda12 * sinLambda12) / (1.0 - cosLambda12));
+  sinSigma12 = sqrt((arc->sinAlpha1 * arc->sinAlpha1) + (arc->cosAlpha1 * arc->cosAlpha1));
+  cosSigma12 = (sinBeta1 * sinBeta2) + (cosBeta1 * cosBeta2 * cosLambda12);
+
+  if ((cosSigma12 >= 0.0) //
+      || (sinSigma12 >= (6.0 * NMEALIB_GEODESIC_N * NMEALIB_PI * cosBeta1 * cosBeta1))) {
+    return;
+  }
+
+  /* x is the scaled longitude and y the scaled latitude difference from the antipode */
+  lambdaScale = NMEALIB_GEODESIC_F * cosBeta1 * nmeaGeodesicA3(nmeaGeodesicEps(sinBeta1, &k2), c) * NMEALIB_PI;
+  x = (lambda12 - NMEALIB_PI) / lambdaScale;
+  y = sinBeta12a / (lambdaScale * cosBeta1);
+
+  if ((y > -NMEALIB_GEODESIC_CUT_Y) //
+      && (x > (-1.0 - NMEALIB_GEODESIC_CUT_X))) {
+    /* the strip near the cut along the equator */
+    arc->sinAlpha1 = MIN(1.0, -x);
+    arc->cosAlpha1 = -sqrt(1.0 - (arc->sinAlpha1 * arc->sinAlpha1));
+  } else {
+    /* the spherical estimate from the longitude difference on the auxiliary sphere */
+    double k = nmeaGeodesicAstroid(x, y);
+    double omega12a = lambdaScale * ((-x * k) / (1.0 + k));
+    double sinOmega12 = sin(omega12a);
+    double cosOmega12 = -cos(omega12a);
+
+    arc->sinAlpha1 = cosBeta2 * sinOmega12;
+    arc->cosAlpha1 = sinBeta12a - ((cosBeta2 * sinBeta1 * sinOmega12 * sinOmega12) / (1.0 - cosOmega12));
+  }
+}
+
+/**
+ * Find the azimuth at the first position of the geodesic to a longitude
+ * difference, in the canonical configuration of the inverse problem
+ *
+ * The longitude difference increases monotonically with the azimuth, from 0
+ * (due north) to pi (due south), so the azimuth is bracketed in [0, pi].
+ * Newton steps converge quickly from the estimate, steps that leave [0, pi]
+ * bisect the bracket instead. The azimuth and the bracket are kept as sines
+ * and cosines: near pi / 2, where the longitude difference of a nearly
+ * equatorial geodesic is very sensitive to the azimuth, the cosine resolves
+ * it far better than the angle. The iterations only stop when the longitude
+ * difference is reached, or when the bracket can't shrink any further.
+ *
+ * @param sinBeta1 The sine of the first reduced latitude
+ * @param cosBeta1 The cosine of the first reduced latitude
+ * @param sinBeta2 The sine of the second reduced latitude
+ * @param cosBeta2 The cosine of the second reduced latitude
+ * @param lambda12 The longitude difference, in (0, pi)
+ * @param arc The location in which to store the geodesic, holding the (not
+ * normalised) estimate of the azimuth at the first position (see
+ * nmeaGeodesicShortLine and nmeaGeodesicAntipodalStart)
+ */
+static void nmeaGeodesicSolve(double sinBeta1, double cosBeta1, double sinBeta2, double cosBeta2, double lambda12,
+    NmeaGeodesicArc *arc) {
+  double sinLo = NMEALIB_GEODESIC_TINY;
+  double cosLo = 1.0;
+  double sinHi = NMEALIB_GEODESIC_TINY;
+  double cosHi = -1.0;
+  double sinAlpha1 = arc->sinAlpha1;
+  double cosAlpha1 = arc->cosAlpha1;
+  bool last = false;
+  size_t step;
+
+  if (sinAlpha1 > 0.0) {
+    nmeaGeodesicNormalise(&sinAlpha1, &cosAlpha1);
+  } else {
+    sinAlpha1 = 1.0;
+    cosAlpha1 = 0.0;
+  }
+
+  for (step = 0; step < NMEALIB_GEODESIC_STEPS; step++) {
+    double v;
+
+    nmeaGeodesicArc(sinBeta1, cosBeta1, sinBeta2, cosBeta2, sinAlpha1, cosAlpha1,
+        !last && (step < NMEALIB_GEODESIC_NEWTON_STEPS), arc);
+    v = arc->lambda12 - lambda12;
+    if (fabs(v) < NMEALIB_GEODESIC_TOLERANCE) {
+      break;
+    }
+
+    /* the azimuth is beyond lo when its cotangent is below the one of lo */
+    if ((v < 0.0) //
+        && ((cosAlpha1 * sinLo) < (cosLo * sinAlpha1))) {
+      sinLo = sinAlpha1;
+      cosLo = cosAlpha1;
+    } else if ((v > 0.0) //
+        && ((cosAlpha1 * sinHi) > (cosHi * sinAlpha1))) {
+      sinHi = sinAlpha1;
+      cosHi = cosAlpha1;
+    }
+    if (last) {
+      /* the error didn't vanish after all: take the slope here */
+      last = false;
+      continue;
+    }
+
+    if ((arc->slope > 0.0) //
+        && (fabs(v) < (NMEALIB_PI * arc->slope))) {
+      double d = -v / arc->slope;
+      double sinD;
+      double cosD;
+      double t;
+
+      if (fabs(d) < NMEALIB_GEODESIC_SMALL_STEP) {
+        /* the series are exact to well below DBL_EPSILON */
+        double d2 = d * d;
+
+        sinD = d * (1.0 - (d2 / 6.0) * (1.0 - (d2 / 20.0)));
+        cosD = 1.0 - (d2 / 2.0) * (1.0 - (d2 / 12.0));
+      } else {
+        sinD = sin(d);
+        cosD = cos(d);
+      }
+
+      /* rotate the azimuth, within (0, pi) when the sine stays positive */
+      t = (sinAlpha1 * cosD) + (cosAlpha1 * sinD);
+      if (t > 0.0) {
+        /* Newton converges quadratically: after a small error the azimuth is usually exact */
+        last = fabs(v) < NMEALIB_GEODESIC_LAST_STEP;
+        cosAlpha1 = (cosAlpha1 * cosD) - (sinAlpha1 * sinD);
+        sinAlpha1 = t;
+        continue;
+      }
+    }
+
+    if ((fabs(sinHi - sinLo) + fabs(cosHi - cosLo)) < NMEALIB_GEODESIC_TOLERANCE) {
+      break;
+    }
+
+    sinAlpha1 = (sinLo + sinHi) / 2.0;
+    cosAlpha1 = (cosLo + cosHi) / 2.0;
+    nmeaGeodesicNormalise(&sinAlpha1, &cosAlpha1);
+  }
+}
+
+/*
+ * Public
+ */
+
+bool nmeaGeodesicOriginInit(NmeaGeodesicOrigin *origin, const NmeaPosition *position) {
+  if (!origin //
+      || !position //
+      || isNaN(position->lat) //
+      || isNaN(position->lon)) {
+    return false;
+  }
+
+  origin->position = *position;
+  nmeaGeodesicReducedLatitude(position->lat, &origin->sinBeta, &origin->cosBeta);
+
+  return true;
+}
+
+double nmeaGeodesicInverse(const NmeaGeodesicOrigin *origin, const NmeaPosition *to, double *fromAzimuth,
+    double *toAzimuth) {
+  NmeaGeodesicArc arc;
+  double sinBeta1 = origin ?
+      origin->sinBeta :
+      0.0;
+  double cosBeta1 = origin ?
+      origin->cosBeta :
+      0.0;
+  double sinBeta2;
+  double cosBeta2;
+  double lon12;
+  double lambda12;
+  double lonSign;
+  double latSign;
+  double swapSign = 1.0;
+  double sinAlpha1;
+  double cosAlpha1;
+  double sinAlpha2;
+  double cosAlpha2;
+  double distance;
+
+  if (!origin //
+      || !to //
+      || isNaN(to->lat) //
+      || isNaN(to->lon)) {
+    return NaN;
+  }
+
+  nmeaGeodesicReducedLatitude(to->lat, &sinBeta2, &cosBeta2);
+
+  lon12 = to->lon - origin->position.lon;
+  if (fabs(lon12) > NMEALIB_PI) {
+    lon12 = remainder(lon12, 2.0 * NMEALIB_PI);
+  }
+  lonSign = (lon12 >= 0.0) ?
+      1.0 :
+      -1.0;
+  lambda12 = fabs(lon12);
+
+  /* canonical configuration: the first position is the one farthest from the equator, south of it */
+  if (fabs(sinBeta1) < fabs(sinBeta2)) {
+    double t;
+
+    swapSign = -1.0;
+    lonSign = -lonSign;
+    t = sinBeta1;
+    sinBeta1 = sinBeta2;
+    sinBeta2 = t;
+    t = cosBeta1;
+    cosBeta1 = cosBeta2;
+    cosBeta2 = t;
+  }
+  latSign = (sinBeta1 < 0.0) ?
+      1.0 :
+      -1.0;
+  sinBeta1 *= latSign;
+  sinBeta2 *= latSign;
+
+  if ((sinBeta1 == 0.0) //
+      && (lambda12 <= (NMEALIB_GEODESIC_F1 * NMEALIB_PI))) {
+    /* along the equator */
+    sinAlpha1 = 1.0;
+    cosAlpha1 = 0.0;
+    sinAlpha2 = 1.0;
+    cosAlpha2 = 0.0;
+    distance = NMEALIB_GEODESIC_A * lambda12;
+  } else {
+    if (lambda12 == NMEALIB_PI) {
+      /* along a meridian, over a pole */
+      nmeaGeodesicArc(sinBeta1, cosBeta1, sinBeta2, cosBeta2, 0.0, -1.0, false, &arc);
+      distance = nmeaGeodesicArcDistance(&arc);
+    } else if (!nmeaGeodesicShortLine(sinBeta1, cosBeta1, sinBeta2, cosBeta2, lambda12, &arc, &distance)) {
+      if ((lambda12 == 0.0) //
+          || (cosBeta1 <= NMEALIB_GEODESIC_TINY)) {
+        /* along a meridian */
+        nmeaGeodesicArc(sinBeta1, cosBeta1, sinBeta2, cosBeta2, sin(lambda12), cos(lambda12), false, &arc);
+      } else {
+        nmeaGeodesicAntipodalStart(sinBeta1, cosBeta1, sinBeta2, cosBeta2, lambda12, &arc);
+        nmeaGeodesicSolve(sinBeta1, cosBeta1, sinBeta2, cosBeta2, lambda12, &arc);
+      }
+      distance = nmeaGeodesicArcDistance(&arc);
+    }
+
+    /* the series terms of nearly coincident positions can differ by more than sigma12 */
+    distance = MAX(0.0, distance);
+    sinAlpha1 = arc.sinAlpha1;
+    cosAlpha1 = arc.cosAlpha1;
+    sinAlpha2 = arc.sinAlpha2;
+    cosAlpha2 = arc.cosAlpha2;
+  }
+
+  if (swapSign < 0.0) {
+    double t;
+
+    t = sinAlpha1;
+    sinAlpha1 = sinAlpha2;
+    sinAlpha2 = t;
+    t = cosAlpha1;
+    cosAlpha1 = cosAlpha2;
+    cosAlpha2 = t;
+  }
+
+  if (fromAzimuth) {
+    *fromAzimuth = atan2(swapSign * lonSign * sinAlpha1, swapSign * latSign * cosAlpha1);
+  }
+  if (toAzimuth) {
+    *toAzimuth = atan2(swapSign * lonSign * sinAlpha2, swapSign * latSign * cosAlpha2);
+  }
+
+  return distance;
+}
+
+bool nmeaGeodesicDistances(const NmeaGeodesicOrigin *origin, const NmeaPosition *to, size_t count,
+    double *distances) {
+  size_t i;
+
+  if (!origin //
+      || !to //
+      || !distances) {
+    return false;
+  }
+
+  for (i = 0; i < count; i++) {
+    distances[i] = nmeaGeodesicInverse(origin, &to[i], NULL, NULL);
+  }
+
+  return true;
+}
+
+bool nmeaGeodesicDirect(const NmeaGeodesicOrigin *origin, double azimuth, double distance, NmeaPosition *to,
+    double *toAzimuth) {
+  NmeaGeodesicSeries c;
+  double sinAlpha1;
+  double cosAlpha1;
+  double sinAlpha0;
+  double cosAlpha0;
+  double sinSigma1;
+  double cosSigma1;
+  double sinOmega1;
+  double cosOmega1;
+  double sinSigma2;
+  double cosSigma2;
+  double sinBeta2;
+  double cosBeta2;
+  double sigma1;
+  double sigma2;
+  double tau2;
+  double omega12;
+  double lambda12;
+  double eps;
+  double k2;
+  double a1;
+  double a3;
+  size_t step;
+
+  if (!origin //
+      || !to //
+      || isNaN(azimuth) //
+      || isNaN(distance)) {
+    return false;
+  }
+
+  sinAlpha1 = sin(azimuth);
+  cosAlpha1 = cos(azimuth);
+
+  /* Clairaut: the azimuth at the node */
+  sinAlpha0 = sinAlpha1 * origin->cosBeta;
+  cosAlpha0 = sqrt((cosAlpha1 * cosAlpha1) + (sinAlpha1 * origin->sinBeta * sinAlpha1 * origin->sinBeta));
+
+  sinSigma1 = origin->sinBeta;
+  cosSigma1 = ((origin->sinBeta != 0.0) || (cosAlpha1 != 0.0)) ?
+      origin->cosBeta * cosAlpha1 :
+      1.0;
+  sinOmega1 = sinAlpha0 * origin->sinBeta;
+  cosOmega1 = cosSigma1;
+  nmeaGeodesicNormalise(&sinSigma1, &cosSigma1);
+  sigma1 = atan2(sinSigma1, cosSigma1);
+
+  /* the arc length at which the distance integral reaches the distance */
+  eps = nmeaGeodesicEps(cosAlpha0, &k2);
+  a1 = nmeaGeodesicA1(eps, c);
+  tau2 = sigma1 + nmeaGeodesicSeriesSum(sinSigma1, cosSigma1, c) + (distance / (NMEALIB_GEODESIC_B * a1));
+  sigma2 = tau2 - nmeaGeodesicSeriesSum(sin(tau2), cos(tau2), c);
+  for (step = 0; step < NMEALIB_GEODESIC_ARC_STEPS; step++) {
+    double s = sin(sigma2);
+    double h = sigma2 + nmeaGeodesicSeriesSum(s, cos(sigma2), c) - tau2;
+
+    if (fabs(h) < NMEALIB_GEODESIC_TOLERANCE) {
+      break;
+    }
+
+    /* the derivative of the integral is the integrand */
+    sigma2 -= (h * a1) / sqrt(1.0 + (k2 * s * s));
+  }
+  sinSigma2 = sin(sigma2);
+  cosSigma2 = cos(sigma2);
+
+  sinBeta2 = cosAlpha0 * sinSigma2;
+  cosBeta2 = sqrt((sinAlpha0 * sinAlpha0) + (cosAlpha0 * cosSigma2 * cosAlpha0 * cosSigma2));
+  if (cosBeta2 == 0.0) {
+    cosBeta2 = NMEALIB_GEODESIC_TINY;
+  }
+
+  /* the longitude on the ellipsoid lags the one on the auxiliary sphere */
+  omega12 = atan2((sinAlpha0 * sinSigma2 * cosOmega1) - (cosSigma2 * sinOmega1), //
+      (cosSigma2 * cosOmega1) + (sinAlpha0 * sinSigma2 * sinOmega1));
+  a3 = nmeaGeodesicA3(eps, c);
+  lambda12 = omega12 - (NMEALIB_GEODESIC_F * a3 * sinAlpha0 * ((sigma2 - sigma1) //
+      + nmeaGeodesicSeriesDiff(sinSigma1, cosSigma1, sinSigma2, cosSigma2, c)));
+
+  to->lat = atan2(sinBeta2, NMEALIB_GEODESIC_F1 * cosBeta2);
+  to->lon = remainder(origin->position.lon + lambda12, 2.0 * NMEALIB_PI);
+  if (toAzimuth) {
+    *toAzimuth = atan2(sinAlpha0, cosAlpha0 * cosSigma2);
+  }
+
+  return true;
+}
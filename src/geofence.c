@@ -0,0 +1,1065 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/geofence.h>
+
+#include <nmealib/geodesic.h>
+#include <nmealib/nmath.h>
+#include <nmealib/util.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The marker for no value */
+#define NMEALIB_GEOFENCE_NONE (SIZE_MAX)
+
+/** The initial number of slots of a hash table, a power of 2 */
+#define NMEALIB_GEOFENCE_TABLE_SIZE (64u)
+
+/** The initial number of fences, vertices and receivers */
+#define NMEALIB_GEOFENCE_ENTRIES (16u)
+
+/** The relative difference between geodesic and spherical distances that the spherical distance can't decide */
+#define NMEALIB_GEOFENCE_ELLIPSOID_MARGIN (0.02)
+
+/**
+ * Shapes
+ */
+typedef enum _NmeaGeofenceShape {
+  NMEALIB_GEOFENCE_CIRCLE  = 0u,
+  NMEALIB_GEOFENCE_POLYGON = 1u
+} NmeaGeofenceShape;
+
+/**
+ * A fence
+ *
+ * Longitudes are stored as offsets from a reference longitude, so that
+ * fences that cross the antimeridian need no special cases.
+ */
+typedef struct _NmeaGeofence {
+    uint64_t           id;       /**< The identifier                                           */
+    NmeaGeofenceShape  shape;    /**< The shape                                                */
+    double             latMin;   /**< The southern latitude of the bounding box                */
+    double             latMax;   /**< The northern latitude of the bounding box                */
+    double             lonRef;   /**< The reference longitude, in [-pi, pi>                    */
+    double             lonMin;   /**< The western offset of the bounding box, in [-pi, pi]     */
+    double             lonMax;   /**< The eastern offset of the bounding box                   */
+    double             x;        /**< The unit vector of the center of a circle                */
+    double             y;        /**< The unit vector of the center of a circle                */
+    double             z;        /**< The unit vector of the center of a circle                */
+    double             inner;    /**< The squared chord within which a position is inside      */
+    double             outer;    /**< The squared chord beyond which a position is outside     */
+    double             radius;   /**< The radius of a circle in meters                         */
+    NmeaGeodesicOrigin origin;   /**< The center of a circle, for the ellipsoidal mode         */
+    size_t             vertex;   /**< The index of the first vertex of a polygon               */
+    size_t             vertices; /**< The number of vertices of a polygon                      */
+} NmeaGeofence;
+
+/**
+ * A hash table from 64-bit keys to indices, with open addressing and linear
+ * probing, without removal
+ */
+typedef struct _NmeaGeofenceTable {
+    uint64_t *keys;   /**< The keys of the slots                                   */
+    size_t   *values; /**< The values of the slots, NMEALIB_GEOFENCE_NONE if empty */
+    size_t    mask;   /**< The number of slots - 1                                 */
+    size_t    count;  /**< The number of used slots                                */
+} NmeaGeofenceTable;
+
+/**
+ * The state of a receiver
+ */
+typedef struct _NmeaGeofenceReceiver {
+    size_t *inside;   /**< The indices of the fences that contain the receiver, ascending */
+    size_t  count;    /**< The number of fences that contain the receiver                 */
+    size_t  capacity; /**< The size of the inside array                                   */
+} NmeaGeofenceReceiver;
+
+/**
+ * A (cell, fence) pair of the compilation
+ */
+typedef struct _NmeaGeofencePair {
+    uint64_t cell;  /**< The cell                  */
+    size_t   fence; /**< The index of the fence    */
+} NmeaGeofencePair;
+
+struct _NmeaGeofenceSet {
+    NmeaGeofenceMode      mode;              /**< The distance mode of circles                   */
+    NmeaGeofenceCallback  callback;          /**< The transition callback                        */
+    void                 *userData;          /**< The user data for the callback                 */
+    size_t                rows;              /**< The number of rows of cells                    */
+    size_t                columns;           /**< The number of columns of cells                 */
+    double                cellLat;           /**< The height of a cell (in radians)              */
+    double                cellLon;           /**< The width of a cell (in radians)               */
+    NmeaGeofence         *fences;            /**< The fences, in the order of adding             */
+    size_t                count;             /**< The number of fences                           */
+    size_t                capacity;          /**< The size of the fences array                   */
+    NmeaPosition         *vertices;          /**< The vertices of the polygons, lon as offset    */
+    size_t                vertexCount;       /**< The number of vertices                         */
+    size_t                vertexCapacity;    /**< The size of the vertices array                 */
+    bool                  compiled;          /**< True when the grid holds all fences            */
+    NmeaGeofenceTable     cells;             /**< The index in cellFences of every cell          */
+    size_t               *cellFences;        /**< Per cell: the count, then the fence indices    */
+    size_t               *globalFences;      /**< The fences that are tested for every fix       */
+    size_t                globalCount;       /**< The number of fences tested for every fix      */
+    size_t               *scratch;           /**< The fences that contain a fix                  */
+    NmeaGeofenceTable     receiverIds;       /**< The index in receivers of every receiver       */
+    NmeaGeofenceReceiver *receivers;         /**< The states of the receivers                    */
+    size_t                receiverCount;     /**< The number of receivers                        */
+    size_t                receiverCapacity;  /**< The size of the receivers array                */
+};
+
+/*
+ * Helpers
+ */
+
+/**
+ * Hash a key (the splitmix64 finaliser)
+ *
+ * @param key The key
+ * @return The hash
+ */
+static INLINE size_t nmeaGeofenceHash(uint64_t key) {
+  key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ull;
+  key = (key ^ (key >> 27)) * 0x94d049bb133111ebull;
+  return (size_t) (key ^ (key >> 31));
+}
+
+/**
+ * Allocate the slots of a hash table
+ *
+ * @param table The hash table
+ * @param size The number of slots, a power of 2
+ * @return True on success
+ */
+static bool nmeaGeofenceTableAllocate(NmeaGeofenceTable *table, size_t size) {
+  size_t i;
+
+  table->keys = malloc(size * sizeof(table->keys[0]));
+  table->values = malloc(size * sizeof(table->values[0]));
+  if (!table->keys //
+      || !table->values) {
+    /* can't be covered in a test */
+    free(table->keys);
+    free(table->values);
+    table->keys = NULL;
+    table->values = NULL;
+    return false;
+  }
+
+  for (i = 0; i < size; i++) {
+    table->values[i] = NMEALIB_GEOFENCE_NONE;
+  }
+  table->mask = size - 1;
+  table->count = 0;
+
+  return true;
+}
+
+/**
+ * Free the slots of a hash table
+ *
+ * @param table The hash table
+ */
+static void nmeaGeofenceTableFree(NmeaGeofenceTable *table) {
+  free(table->keys);
+  free(table->values);
+  memset(table, 0, sizeof(*table));
+}
+
+/**
+ * Find the slot of a key in a hash table
+ *
+ * @param table The hash table
+ * @param key The key
+ * @return The slot of the key, or the empty slot where it would be inserted
+ */
+static INLINE size_t nmeaGeofenceTableSlot(const NmeaGeofenceTable *table, uint64_t key) {
+  size_t slot = nmeaGeofenceHash(key) & table->mask;
+
+  while ((table->values[slot] != NMEALIB_GEOFENCE_NONE) //
+      && (table->keys[slot] != key)) {
+    slot = (slot + 1) & table->mask;
+  }
+
+  return slot;
+}
+
+/**
+ * Add a key to a hash table, keeping it at most half full
+ *
+ * @param table The hash table
+ * @param key The key, must not be in the table
+ * @param value The value
+ * @return True on success
+ */
+static bool nmeaGeofenceTableAdd(NmeaGeofenceTable *table, uint64_t key, size_t value) {
+  size_t slot;
+
+  if (((table->count + 1) * 2) > (table->mask + 1)) {
+    NmeaGeofenceTable grown;
+    size_t i;
+
+    if (!nmeaGeofenceTableAllocate(&grown, (table->mask + 1) * 2)) {
+      /* can't be covered in a test */
+      return false;
+    }
+
+    for (i = 0; i <= table->mask; i++) {
+      if (table->values[i] != NMEALIB_GEOFENCE_NONE) {
+        slot = nmeaGeofenceTableSlot(&grown, table->keys[i]);
+        grown.keys[slot] = table->keys[i];
+        grown.values[slot] = table->values[i];
+      }
+    }
+    grown.count = table->count;
+
+    nmeaGeofenceTableFree(table);
+    *table = grown;
+  }
+
+  slot = nmeaGeofenceTableSlot(table, key);
+  table->keys[slot] = key;
+  table->values[slot] = value;
+  table->count++;
+
+  return true;
+}
+
+/**
+ * Normalise a longitude into [-pi, pi>
+ *
+ * @param lon The longitude (in radians)
+ * @return The normalised longitude
+ */
+static INLINE double nmeaGeofenceLongitude(double lon) {
+  if ((lon >= -NMEALIB_PI) //
+      && (lon < NMEALIB_PI)) {
+    return lon;
+  }
+
+  lon -= 2.0 * NMEALIB_PI * floor((lon + NMEALIB_PI) / (2.0 * NMEALIB_PI));
+  return (lon < NMEALIB_PI) ?
+      lon :
+      -NMEALIB_PI;
+}
+
+/**
+ * The offset of a longitude from the reference longitude of a fence, in
+ * the range of the bounding box of the fence when the longitude lies in it
+ *
+ * @param fence The fence
+ * @param lon The longitude (in radians), in [-pi, pi>
+ * @return The offset (in radians)
+ */
+static INLINE double nmeaGeofenceOffset(const NmeaGeofence *fence, double lon) {
+  double d = lon - fence->lonRef;
+
+  if (d > NMEALIB_PI) {
+    d -= 2.0 * NMEALIB_PI;
+  } else if (d < -NMEALIB_PI) {
+    d += 2.0 * NMEALIB_PI;
+  }
+
+  if (d < fence->lonMin) {
+    d += 2.0 * NMEALIB_PI;
+  }
+
+  return d;
+}
+
+/**
+ * The squared chord of an angle
+ *
+ * @param angle The angle (in radians)
+ * @return The squared chord, on the unit sphere
+ */
+static INLINE double nmeaGeofenceAngleToChord2(double angle) {
+  double s;
+
+  if (angle >= NMEALIB_PI) {
+    return 4.0;
+  }
+
+  s = sin(angle / 2.0);
+  return 4.0 * s * s;
+}
+
+/**
+ * Get the row of a latitude
+ *
+ * @param set The set
+ * @param lat The latitude (in radians)
+ * @return The row
+ */
+static INLINE size_t nmeaGeofenceRow(const NmeaGeofenceSet *set, double lat) {
+  double row = floor((lat + (NMEALIB_PI / 2.0)) / set->cellLat);
+
+  return MIN((size_t) MAX(row, 0.0), set->rows - 1);
+}
+
+/**
+ * Get the column of a longitude
+ *
+ * @param set The set
+ * @param lon The longitude (in radians), in [-pi, pi>
+ * @return The column
+ */
+static INLINE size_t nmeaGeofenceColumn(const NmeaGeofenceSet *set, double lon) {
+  double column = floor((lon + NMEALIB_PI) / set->cellLon);
+
+  return MIN((size_t) MAX(column, 0.0), set->columns - 1);
+}
+
+/**
+ * Make room for one more fence
+ *
+ * @param set The set
+ * @return True on success
+ */
+static bool nmeaGeofenceReserve(NmeaGeofenceSet *set) {
+  size_t capacity;
+  NmeaGeofence *fences;
+
+  if (set->count < set->capacity) {
+    return true;
+  }
+
+  capacity = set->capacity ?
+      set->capacity * 2 :
+      NMEALIB_GEOFENCE_ENTRIES;
+  fences = realloc(set->fences, capacity * sizeof(fences[0]));
+  if (!fences) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  set->fences = fences;
+  set->capacity = capacity;
+
+  return true;
+}
+
+/**
+ * Free the compilation of a set
+ *
+ * @param set The set
+ */
+static void nmeaGeofenceUncompile(NmeaGeofenceSet *set) {
+  nmeaGeofenceTableFree(&set->cells);
+  free(set->cellFences);
+  free(set->globalFences);
+  free(set->scratch);
+  set->cellFences = NULL;
+  set->globalFences = NULL;
+  set->scratch = NULL;
+  set->globalCount = 0;
+  set->compiled = false;
+}
+
+/**
+ * Determine the cells that a fence overlaps
+ *
+ * @param set The set
+ * @param fence The fence
+ * @param rowMin The location in which to store the first row
+ * @param rowMax The location in which to store the last row
+ * @param column The location in which to store the first column
+ * @param columns The location in which to store the number of columns,
+ * wrapping around the antimeridian
+ * @return The number of cells
+ */
+static size_t nmeaGeofenceCells(const NmeaGeofenceSet *set, const NmeaGeofence *fence, size_t *rowMin,
+    size_t *rowMax, size_t *column, size_t *columns) {
+  double lonMin = fence->lonRef + fence->lonMin;
+  double first = floor((lonMin + NMEALIB_PI) / set->cellLon);
+  double last = floor((fence->lonRef + fence->lonMax + NMEALIB_PI) / set->cellLon);
+
+  *rowMin = nmeaGeofenceRow(set, fence->latMin);
+  *rowMax = nmeaGeofenceRow(set, fence->latMax);
+  *column = 0;
+  *columns = set->columns;
+
+  if ((last - first) < (double) set->columns) {
+    *column = nmeaGeofenceColumn(set, nmeaGeofenceLongitude(lonMin));
+    *columns = (size_t) (last - first) + 1;
+  }
+
+  return (*rowMax - *rowMin + 1) * *columns;
+}
+
+static int nmeaGeofencePairCompare(const void *a, const void *b) {
+  const NmeaGeofencePair *pa = (const NmeaGeofencePair *) a;
+  const NmeaGeofencePair *pb = (const NmeaGeofencePair *) b;
+
+  if (pa->cell != pb->cell) {
+    return (pa->cell < pb->cell) ?
+        -1 :
+        1;
+  }
+
+  return (pa->fence < pb->fence) ?
+      -1 :
+      (pa->fence > pb->fence);
+}
+
+/**
+ * Test whether a fence contains a position
+ *
+ * @param set The set
+ * @param fence The fence
+ * @param position The position (in radians), with a longitude in [-pi, pi>
+ * @param x The unit vector of the position
+ * @param y The unit vector of the position
+ * @param z The unit vector of the position
+ * @return True when the fence contains the position
+ */
+static bool nmeaGeofenceTest(const NmeaGeofenceSet *set, const NmeaGeofence *fence, const NmeaPosition *position,
+    double x, double y, double z) {
+  double offset;
+
+  if ((position->lat < fence->latMin) //
+      || (position->lat > fence->latMax)) {
+    return false;
+  }
+
+  offset = nmeaGeofenceOffset(fence, position->lon);
+  if (offset > fence->lonMax) {
+    return false;
+  }
+
+  if (fence->shape == NMEALIB_GEOFENCE_CIRCLE) {
+    double dx = x - fence->x;
+    double dy = y - fence->y;
+    double dz = z - fence->z;
+    double chord2 = (dx * dx) + (dy * dy) + (dz * dz);
+
+    if (chord2 <= fence->inner) {
+      return true;
+    }
+    if (chord2 > fence->outer) {
+      return false;
+    }
+
+    /* only in the ellipsoidal mode */
+    return nmeaGeodesicInverse(&fence->origin, position, NULL, NULL) <= fence->radius;
+  }
+
+  /* polygon: count the crossings of a ray towards the east */
+  {
+    const NmeaPosition *v = &set->vertices[fence->vertex];
+    size_t n = fence->vertices;
+    size_t i;
+    size_t j = n - 1;
+    bool inside = false;
+
+    for (i = 0; i < n; j = i++) {
+      if ((v[i].lat > position->lat) != (v[j].lat > position->lat)) {
+        double lon = v[i].lon + (((v[j].lon - v[i].lon) * (position->lat - v[i].lat)) / (v[j].lat - v[i].lat));
+
+        if (offset < lon) {
+          inside = !inside;
+        }
+      }
+    }
+
+    return inside;
+  }
+}
+
+/**
+ * Store a fence that contains a position
+ *
+ * @param set The set
+ * @param fence The index of the fence
+ * @param n The number of fences stored before
+ * @param inside The array in which to store the index of the fence, may be NULL
+ * @param ids The array in which to store the identifier of the fence, may be
+ * NULL
+ * @param capacity The size of the inside and ids arrays
+ */
+static INLINE void nmeaGeofenceStore(const NmeaGeofenceSet *set, size_t fence, size_t n, size_t *inside,
+    uint64_t *ids, size_t capacity) {
+  if (n >= capacity) {
+    return;
+  }
+
+  if (inside) {
+    inside[n] = fence;
+  }
+  if (ids) {
+    ids[n] = set->fences[fence].id;
+  }
+}
+
+/**
+ * Find the fences that contain a position
+ *
+ * @param set The set
+ * @param position The position (in radians)
+ * @param inside The array in which to store the indices of the fences,
+ * ascending, may be NULL
+ * @param ids The array in which to store the identifiers of the fences, may
+ * be NULL
+ * @param capacity The size of the inside and ids arrays
+ * @return The number of fences that contain the position, NMEALIB_GEOFENCE_NONE
+ * on invalid inputs
+ */
+static size_t nmeaGeofenceEvaluate(const NmeaGeofenceSet *set, const NmeaPosition *position, size_t *inside,
+    uint64_t *ids, size_t capacity) {
+  NmeaPosition p;
+  double cosLat;
+  double x;
+  double y;
+  double z;
+  const size_t *cell = NULL;
+  size_t cellCount = 0;
+  size_t count = 0;
+  size_t c = 0;
+  size_t g = 0;
+
+  if (!position //
+      || !isfinite(position->lat) //
+      || !isfinite(position->lon) //
+      || (fabs(position->lat) > (NMEALIB_PI / 2.0))) {
+    return NMEALIB_GEOFENCE_NONE;
+  }
+
+  p.lat = position->lat;
+  p.lon = nmeaGeofenceLongitude(position->lon);
+  cosLat = cos(p.lat);
+  x = cosLat * cos(p.lon);
+  y = cosLat * sin(p.lon);
+  z = sin(p.lat);
+
+  if (!set->compiled) {
+    for (c = 0; c < set->count; c++) {
+      if (nmeaGeofenceTest(set, &set->fences[c], &p, x, y, z)) {
+        nmeaGeofenceStore(set, c, count++, inside, ids, capacity);
+      }
+    }
+
+    return count;
+  }
+
+  {
+    uint64_t key = ((uint64_t) nmeaGeofenceRow(set, p.lat) * set->columns) + nmeaGeofenceColumn(set, p.lon);
+    size_t i = set->cells.values[nmeaGeofenceTableSlot(&set->cells, key)];
+
+    if (i != NMEALIB_GEOFENCE_NONE) {
+      cellCount = set->cellFences[i];
+      cell = &set->cellFences[i + 1];
+    }
+  }
+
+  /* merge the fences of the cell with the global fences, both ascending */
+  while ((c < cellCount) //
+      || (g < set->globalCount)) {
+    size_t fence;
+
+    if ((g >= set->globalCount) //
+        || ((c < cellCount) && (cell[c] < set->globalFences[g]))) {
+      fence = cell[c++];
+    } else {
+      fence = set->globalFences[g++];
+    }
+
+    if (nmeaGeofenceTest(set, &set->fences[fence], &p, x, y, z)) {
+      nmeaGeofenceStore(set, fence, count++, inside, ids, capacity);
+    }
+  }
+
+  return count;
+}
+
+/**
+ * Get the state of a receiver, creating it when needed
+ *
+ * @param set The set
+ * @param receiver The identifier of the receiver
+ * @return The state, or NULL on failure
+ */
+static NmeaGeofenceReceiver *nmeaGeofenceReceiverGet(NmeaGeofenceSet *set, uint64_t receiver) {
+  size_t i = set->receiverIds.values[nmeaGeofenceTableSlot(&set->receiverIds, receiver)];
+
+  if (i != NMEALIB_GEOFENCE_NONE) {
+    return &set->receivers[i];
+  }
+
+  if (set->receiverCount == set->receiverCapacity) {
+    size_t capacity = set->receiverCapacity ?
+        set->receiverCapacity * 2 :
+        NMEALIB_GEOFENCE_ENTRIES;
+    NmeaGeofenceReceiver *receivers = realloc(set->receivers, capacity * sizeof(receivers[0]));
+
+    if (!receivers) {
+      /* can't be covered in a test */
+      return NULL;
+    }
+
+    set->receivers = receivers;
+    set->receiverCapacity = capacity;
+  }
+
+  if (!nmeaGeofenceTableAdd(&set->receiverIds, receiver, set->receiverCount)) {
+    /* can't be covered in a test */
+    return NULL;
+  }
+
+  i = set->receiverCount++;
+  memset(&set->receivers[i], 0, sizeof(set->receivers[i]));
+
+  return &set->receivers[i];
+}
+
+/*
+ * Public
+ */
+
+NmeaGeofenceSet *nmeaGeofenceCreate(NmeaGeofenceMode mode, double cellSize, NmeaGeofenceCallback callback,
+    void *userData) {
+  NmeaGeofenceSet *set;
+  double rows;
+  double columns;
+
+  if (cellSize == 0.0) {
+    cellSize = NMEALIB_GEOFENCE_CELL_SIZE_DEFAULT;
+  }
+
+  if (((mode != NMEALIB_GEOFENCE_SPHERICAL) && (mode != NMEALIB_GEOFENCE_ELLIPSOIDAL)) //
+      || isNaN(cellSize) //
+      || (cellSize < NMEALIB_GEOFENCE_CELL_SIZE_MIN)) {
+    return NULL;
+  }
+
+  set = calloc(1, sizeof(*set));
+  if (!set) {
+    /* can't be covered in a test */
+    return NULL;
+  }
+
+  if (!nmeaGeofenceTableAllocate(&set->receiverIds, NMEALIB_GEOFENCE_TABLE_SIZE)) {
+    /* can't be covered in a test */
+    free(set);
+    return NULL;
+  }
+
+  rows = ceil((NMEALIB_PI * NMEALIB_EARTHRADIUS_M) / cellSize);
+  columns = ceil((2.0 * NMEALIB_PI * NMEALIB_EARTHRADIUS_M) / cellSize);
+  set->mode = mode;
+  set->callback = callback;
+  set->userData = userData;
+  set->rows = (size_t) rows;
+  set->columns = (size_t) columns;
+  set->cellLat = NMEALIB_PI / rows;
+  set->cellLon = (2.0 * NMEALIB_PI) / columns;
+
+  return set;
+}
+
+void nmeaGeofenceDestroy(NmeaGeofenceSet *set) {
+  size_t i;
+
+  if (!set) {
+    return;
+  }
+
+  nmeaGeofenceUncompile(set);
+  for (i = 0; i < set->receiverCount; i++) {
+    free(set->receivers[i].inside);
+  }
+  nmeaGeofenceTableFree(&set->receiverIds);
+  free(set->receivers);
+  free(set->fences);
+  free(set->vertices);
+  free(set);
+}
+
+bool nmeaGeofenceAddCircle(NmeaGeofenceSet *set, uint64_t id, const NmeaPosition *center, double radius) {
+  NmeaGeofence *fence;
+  double angle;
+  double margin;
+  double cosLat;
+  double dLon = 2.0 * NMEALIB_PI;
+
+  if (!set //
+      || !center //
+      || !isfinite(center->lat) //
+      || !isfinite(center->lon) //
+      || (fabs(center->lat) > (NMEALIB_PI / 2.0)) //
+      || !isfinite(radius) //
+      || (radius < 0.0) //
+      || !nmeaGeofenceReserve(set)) {
+    return false;
+  }
+
+  nmeaGeofenceUncompile(set);
+
+  fence = &set->fences[set->count];
+  memset(fence, 0, sizeof(*fence));
+  fence->id = id;
+  fence->shape = NMEALIB_GEOFENCE_CIRCLE;
+  fence->radius = radius;
+  fence->lonRef = nmeaGeofenceLongitude(center->lon);
+
+  cosLat = cos(center->lat);
+  fence->x = cosLat * cos(fence->lonRef);
+  fence->y = cosLat * sin(fence->lonRef);
+  fence->z = sin(center->lat);
+
+  angle = radius / NMEALIB_EARTHRADIUS_M;
+  if (set->mode == NMEALIB_GEOFENCE_ELLIPSOIDAL) {
+    NmeaPosition c;
+
+    c.lat = center->lat;
+    c.lon = fence->lonRef;
+    nmeaGeodesicOriginInit(&fence->origin, &c);
+    fence->inner = nmeaGeofenceAngleToChord2(angle / (1.0 + NMEALIB_GEOFENCE_ELLIPSOID_MARGIN));
+    margin = angle / (1.0 - NMEALIB_GEOFENCE_ELLIPSOID_MARGIN);
+    fence->outer = nmeaGeofenceAngleToChord2(margin);
+  } else {
+    fence->inner = nmeaGeofenceAngleToChord2(angle);
+    fence->outer = fence->inner;
+    margin = angle;
+  }
+
+  /* the bounding box, of all longitudes when the circle holds a pole */
+  fence->latMin = MAX(center->lat - margin, -NMEALIB_PI / 2.0);
+  fence->latMax = MIN(center->lat + margin, NMEALIB_PI / 2.0);
+  if (((fabs(center->lat) + margin) < (NMEALIB_PI / 2.0)) //
+      && (sin(margin) < cosLat)) {
+    dLon = asin(sin(margin) / cosLat);
+  }
+  if (dLon < NMEALIB_PI) {
+    fence->lonMin = -dLon;
+    fence->lonMax = dLon;
+  } else {
+    fence->lonMin = -NMEALIB_PI;
+    fence->lonMax = NMEALIB_PI;
+  }
+
+  set->count++;
+  return true;
+}
+
+bool nmeaGeofenceAddPolygon(NmeaGeofenceSet *set, uint64_t id, const NmeaPosition *vertices, size_t count) {
+  NmeaGeofence *fence;
+  NmeaPosition *v;
+  double lon;
+  size_t i;
+
+  if (!set //
+      || !vertices //
+      || (count < 3) //
+      || !nmeaGeofenceReserve(set)) {
+    return false;
+  }
+
+  for (i = 0; i < count; i++) {
+    if (!isfinite(vertices[i].lat) //
+        || !isfinite(vertices[i].lon) //
+        || (fabs(vertices[i].lat) > (NMEALIB_PI / 2.0))) {
+      return false;
+    }
+  }
+
+  if ((set->vertexCount + count) > set->vertexCapacity) {
+    size_t capacity = MAX(set->vertexCapacity * 2, set->vertexCount + count);
+
+    v = realloc(set->vertices, capacity * sizeof(v[0]));
+    if (!v) {
+      /* can't be covered in a test */
+      return false;
+    }
+
+    set->vertices = v;
+    set->vertexCapacity = capacity;
+  }
+
+  fence = &set->fences[set->count];
+  memset(fence, 0, sizeof(*fence));
+  fence->id = id;
+  fence->shape = NMEALIB_GEOFENCE_POLYGON;
+  fence->lonRef = nmeaGeofenceLongitude(vertices[0].lon);
+  fence->vertex = set->vertexCount;
+  fence->vertices = count;
+  fence->latMin = vertices[0].lat;
+  fence->latMax = vertices[0].lat;
+
+  /* unwrap the longitudes: every edge spans less than half the globe */
+  v = &set->vertices[set->vertexCount];
+  v[0].lat = vertices[0].lat;
+  v[0].lon = 0.0;
+  for (i = 1; i < count; i++) {
+    v[i].lat = vertices[i].lat;
+    v[i].lon = v[i - 1].lon + remainder(vertices[i].lon - vertices[i - 1].lon, 2.0 * NMEALIB_PI);
+    fence->latMin = MIN(fence->latMin, v[i].lat);
+    fence->latMax = MAX(fence->latMax, v[i].lat);
+  }
+
+  /* a polygon that winds around a pole doesn't close */
+  lon = v[count - 1].lon + remainder(vertices[0].lon - vertices[count - 1].lon, 2.0 * NMEALIB_PI);
+  if (fabs(lon) > 1E-9) {
+    return false;
+  }
+
+  fence->lonMin = 0.0;
+  fence->lonMax = 0.0;
+  for (i = 1; i < count; i++) {
+    fence->lonMin = MIN(fence->lonMin, v[i].lon);
+    fence->lonMax = MAX(fence->lonMax, v[i].lon);
+  }
+  if ((fence->lonMax - fence->lonMin) >= (2.0 * NMEALIB_PI)) {
+    return false;
+  }
+
+  /* keep the western offset in [-pi, pi] */
+  if (fence->lonMin < -NMEALIB_PI) {
+    double shift = 2.0 * NMEALIB_PI * ceil((-NMEALIB_PI - fence->lonMin) / (2.0 * NMEALIB_PI));
+
+    fence->lonMin += shift;
+    fence->lonMax += shift;
+    for (i = 0; i < count; i++) {
+      v[i].lon += shift;
+    }
+  }
+
+  nmeaGeofenceUncompile(set);
+  set->vertexCount += count;
+  set->count++;
+  return true;
+}
+
+size_t nmeaGeofenceCount(const NmeaGeofenceSet *set) {
+  return set ?
+      set->count :
+      0;
+}
+
+bool nmeaGeofenceCompile(NmeaGeofenceSet *set) {
+  NmeaGeofencePair *pairs = NULL;
+  size_t pairCount = 0;
+  size_t pairCapacity = 0;
+  size_t cellCount = 0;
+  size_t i;
+  size_t p;
+
+  if (!set) {
+    return false;
+  }
+
+  if (set->compiled) {
+    return true;
+  }
+
+  nmeaGeofenceUncompile(set);
+
+  set->scratch = malloc(MAX(set->count, 1) * sizeof(set->scratch[0]));
+  set->globalFences = malloc(MAX(set->count, 1) * sizeof(set->globalFences[0]));
+  if (!set->scratch //
+      || !set->globalFences) {
+    /* can't be covered in a test */
+    nmeaGeofenceUncompile(set);
+    return false;
+  }
+
+  /* the (cell, fence) pairs, sorted by cell and then fence */
+  for (i = 0; i < set->count; i++) {
+    size_t rowMin;
+    size_t rowMax;
+    size_t column;
+    size_t columns;
+    size_t cells = nmeaGeofenceCells(set, &set->fences[i], &rowMin, &rowMax, &column, &columns);
+    size_t row;
+
+    if (cells > NMEALIB_GEOFENCE_CELLS_MAX) {
+      set->globalFences[set->globalCount++] = i;
+      continue;
+    }
+
+    if ((pairCount + cells) > pairCapacity) {
+      size_t capacity = MAX(pairCapacity * 2, pairCount + cells);
+      NmeaGeofencePair *grown = realloc(pairs, capacity * sizeof(grown[0]));
+
+      if (!grown) {
+        /* can't be covered in a test */
+        free(pairs);
+        nmeaGeofenceUncompile(set);
+        return false;
+      }
+
+      pairs = grown;
+      pairCapacity = capacity;
+    }
+
+    for (row = rowMin; row <= rowMax; row++) {
+      size_t col = column;
+      size_t n;
+
+      for (n = 0; n < columns; n++) {
+        pairs[pairCount].cell = ((uint64_t) row * set->columns) + col;
+        pairs[pairCount].fence = i;
+        pairCount++;
+
+        col++;
+        if (col >= set->columns) {
+          col = 0;
+        }
+      }
+    }
+  }
+
+  if (pairCount) {
+    qsort(pairs, pairCount, sizeof(pairs[0]), nmeaGeofencePairCompare);
+  }
+
+  for (p = 0; p < pairCount; p++) {
+    if (!p //
+        || (pairs[p].cell != pairs[p - 1].cell)) {
+      cellCount++;
+    }
+  }
+
+  /* per cell: the number of fences, then the fences */
+  set->cellFences = malloc(MAX(cellCount + pairCount, 1) * sizeof(set->cellFences[0]));
+  if (!set->cellFences //
+      || !nmeaGeofenceTableAllocate(&set->cells, NMEALIB_GEOFENCE_TABLE_SIZE)) {
+    /* can't be covered in a test */
+    free(pairs);
+    nmeaGeofenceUncompile(set);
+    return false;
+  }
+
+  i = 0;
+  for (p = 0; p < pairCount; p++) {
+    if (!p //
+        || (pairs[p].cell != pairs[p - 1].cell)) {
+      if (!nmeaGeofenceTableAdd(&set->cells, pairs[p].cell, i)) {
+        /* can't be covered in a test */
+        free(pairs);
+        nmeaGeofenceUncompile(set);
+        return false;
+      }
+
+      set->cellFences[i] = 0;
+      cellCount = i++;
+    }
+
+    set->cellFences[cellCount]++;
+    set->cellFences[i++] = pairs[p].fence;
+  }
+
+  free(pairs);
+  set->compiled = true;
+
+  return true;
+}
+
+size_t nmeaGeofenceContains(const NmeaGeofenceSet *set, const NmeaPosition *position, uint64_t *fences,
+    size_t capacity) {
+  size_t count;
+
+  if (!set //
+      || (!fences && capacity)) {
+    return 0;
+  }
+
+  count = nmeaGeofenceEvaluate(set, position, NULL, fences, capacity);
+  return (count != NMEALIB_GEOFENCE_NONE) ?
+      count :
+      0;
+}
+
+bool nmeaGeofenceUpdate(NmeaGeofenceSet *set, uint64_t receiver, const NmeaPosition *position) {
+  NmeaGeofenceReceiver *state;
+  size_t count;
+  size_t i;
+  size_t j;
+
+  if (!set //
+      || !nmeaGeofenceCompile(set)) {
+    return false;
+  }
+
+  count = nmeaGeofenceEvaluate(set, position, set->scratch, NULL, set->count);
+  if (count == NMEALIB_GEOFENCE_NONE) {
+    return false;
+  }
+
+  state = nmeaGeofenceReceiverGet(set, receiver);
+  if (!state) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  if (count > state->capacity) {
+    size_t *inside = realloc(state->inside, count * sizeof(inside[0]));
+
+    if (!inside) {
+      /* can't be covered in a test */
+      return false;
+    }
+
+    state->inside = inside;
+    state->capacity = count;
+  }
+
+  if (set->callback) {
+    /* exits: in the previous fences, not in the current ones */
+    for (i = 0, j = 0; i < state->count; i++) {
+      while ((j < count) //
+          && (set->scratch[j] < state->inside[i])) {
+        j++;
+      }
+      if ((j >= count) //
+          || (set->scratch[j] != state->inside[i])) {
+        set->callback(set->userData, receiver, set->fences[state->inside[i]].id, NMEALIB_GEOFENCE_EXIT);
+      }
+    }
+
+    /* enters: in the current fences, not in the previous ones */
+    for (i = 0, j = 0; i < count; i++) {
+      while ((j < state->count) //
+          && (state->inside[j] < set->scratch[i])) {
+        j++;
+      }
+      if ((j >= state->count) //
+          || (state->inside[j] != set->scratch[i])) {
+        set->callback(set->userData, receiver, set->fences[set->scratch[i]].id, NMEALIB_GEOFENCE_ENTER);
+      }
+    }
+  }
+
+  if (count) {
+    memcpy(state->inside, set->scratch, count * sizeof(state->inside[0]));
+  }
+  state->count = count;
+
+  return true;
+}
+
+bool nmeaGeofenceUpdateInfo(NmeaGeofenceSet *set, uint64_t receiver, const NmeaInfo *info) {
+  NmeaPosition position;
+
+  if (!info //
+      || !nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON)) {
+    return false;
+  }
+
+  nmeaMathInfoToPosition(info, &position);
+  return nmeaGeofenceUpdate(set, receiver, &position);
+}
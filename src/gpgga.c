@@ -18,16 +18,21 @@
 #include <nmealib/gpgga.h>
 
 #include <nmealib/context.h>
+#include <nmealib/format.h>
 #include <nmealib/sentence.h>
 #include <nmealib/util.h>
 #include <nmealib/validate.h>
 #include <limits.h>
 #include <math.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 bool nmeaGPGGAParse(const char *s, const size_t sz, NmeaGPGGA *pack) {
+  return nmeaGPGGAParsePolicy(s, sz, pack, NMEALIB_VALIDATION_STRICT);
+}
+
+bool nmeaGPGGAParsePolicy(const char *s, const size_t sz, NmeaGPGGA *pack, NmeaValidationPolicy policy) {
+  bool strict = (policy == NMEALIB_VALIDATION_STRICT);
   size_t tokenCount;
   char timeBuf[16];
 
@@ -81,7 +86,8 @@ bool nmeaGPGGAParse(const char *s, const size_t sz, NmeaGPGGA *pack) {
 
   if (*timeBuf) {
     if (!nmeaTimeParseTime(timeBuf, &pack->utc) //
-        || !nmeaValidateTime(&pack->utc, NMEALIB_GPGGA_PREFIX, s)) {
+        || (strict //
+            && !nmeaValidateTime(&pack->utc, NMEALIB_GPGGA_PREFIX, s))) {
       goto err;
     }
 
@@ -91,7 +97,8 @@ bool nmeaGPGGAParse(const char *s, const size_t sz, NmeaGPGGA *pack) {
   }
 
   if (!isNaN(pack->latitude)) {
-    if (!nmeaValidateNSEW(pack->latitudeNS, true, NMEALIB_GPGGA_PREFIX, s)) {
+    if (strict //
+        && !nmeaValidateNSEW(pack->latitudeNS, true, NMEALIB_GPGGA_PREFIX, s)) {
       goto err;
     }
 
@@ -102,7 +109,8 @@ bool nmeaGPGGAParse(const char *s, const size_t sz, NmeaGPGGA *pack) {
   }
 
   if (!isNaN(pack->longitude)) {
-    if (!nmeaValidateNSEW(pack->longitudeEW, false, NMEALIB_GPGGA_PREFIX, s)) {
+    if (strict //
+        && !nmeaValidateNSEW(pack->longitudeEW, false, NMEALIB_GPGGA_PREFIX, s)) {
       goto err;
     }
 
@@ -113,7 +121,8 @@ bool nmeaGPGGAParse(const char *s, const size_t sz, NmeaGPGGA *pack) {
   }
 
   if (pack->sig != INT_MAX) {
-    if (!nmeaValidateSignal(pack->sig, NMEALIB_GPGGA_PREFIX, s)) {
+    if (strict //
+        && !nmeaValidateSignal(pack->sig, NMEALIB_GPGGA_PREFIX, s)) {
       goto err;
     }
 
@@ -135,7 +144,8 @@ bool nmeaGPGGAParse(const char *s, const size_t sz, NmeaGPGGA *pack) {
   }
 
   if (!isNaN(pack->elevation)) {
-    if (pack->elevationM != 'M') {
+    if (strict //
+        && (pack->elevationM != 'M')) {
       nmeaContextError(NMEALIB_GPGGA_PREFIX " parse error: invalid elevation unit '%c' in '%s'", pack->elevationM, s);
       goto err;
     }
@@ -147,7 +157,8 @@ bool nmeaGPGGAParse(const char *s, const size_t sz, NmeaGPGGA *pack) {
   }
 
   if (!isNaN(pack->height)) {
-    if (pack->heightM != 'M') {
+    if (strict //
+        && (pack->heightM != 'M')) {
       nmeaContextError(NMEALIB_GPGGA_PREFIX " parse error: invalid height unit '%c' in '%s'", pack->heightM, s);
       goto err;
     }
@@ -318,111 +329,155 @@ void nmeaGPGGAFromInfo(const NmeaInfo *info, NmeaGPGGA *pack) {
   }
 }
 
-size_t nmeaGPGGAGenerate(char *s, const size_t sz, const NmeaGPGGA *pack) {
-
-#define dst       (&s[chars])
-#define available ((sz <= (size_t) chars) ? 0 : (sz - (size_t) chars))
-
-  int chars = 0;
-
-  if (!s //
+void nmeaGPGGAGenerateField(NmeaFormatter *out, const NmeaGPGGA *pack, const NmeaGPGGAField field) {
+  if (!out //
       || !pack) {
-    return 0;
-  }
-
-  chars += snprintf(dst, available, "$" NMEALIB_GPGGA_PREFIX);
-
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_UTCTIME)) {
-    chars += snprintf(dst, available, //
-        ",%02u%02u%02u.%02u", //
-        pack->utc.hour, //
-        pack->utc.min, //
-        pack->utc.sec, //
-        pack->utc.hsec);
-  } else {
-    chars += snprintf(dst, available, ",");
-  }
-
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_LAT)) {
-    chars += snprintf(dst, available, ",%09.4f", pack->latitude);
-    if (pack->latitudeNS) {
-      chars += snprintf(dst, available, ",%c", pack->latitudeNS);
-    } else {
-      chars += snprintf(dst, available, ",");
-    }
-  } else {
-    chars += snprintf(dst, available, ",,");
-  }
-
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_LON)) {
-    chars += snprintf(dst, available, ",%010.4f", pack->longitude);
-    if (pack->longitudeEW) {
-      chars += snprintf(dst, available, ",%c", pack->longitudeEW);
-    } else {
-      chars += snprintf(dst, available, ",");
-    }
-  } else {
-    chars += snprintf(dst, available, ",,");
-  }
-
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_SIG)) {
-    chars += snprintf(dst, available, ",%d", pack->sig);
-  } else {
-    chars += snprintf(dst, available, ",");
-  }
-
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_SATINVIEWCOUNT)) {
-    chars += snprintf(dst, available, ",%02u", pack->inViewCount);
-  } else {
-    chars += snprintf(dst, available, ",");
+    return;
   }
 
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_HDOP)) {
-    chars += snprintf(dst, available, ",%03.1f", pack->hdop);
-  } else {
-    chars += snprintf(dst, available, ",");
+  switch (field) {
+    case NMEALIB_GPGGA_FIELD_UTC:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_UTCTIME)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterUnsigned(out, pack->utc.hour, 2);
+        nmeaFormatterUnsigned(out, pack->utc.min, 2);
+        nmeaFormatterUnsigned(out, pack->utc.sec, 2);
+        nmeaFormatterChar(out, '.');
+        nmeaFormatterUnsigned(out, pack->utc.hsec, 2);
+      } else {
+        nmeaFormatterChar(out, ',');
+      }
+      break;
+
+    case NMEALIB_GPGGA_FIELD_LAT:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_LAT)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterDouble(out, pack->latitude, 9, 4);
+        if (pack->latitudeNS) {
+          nmeaFormatterChar(out, ',');
+          nmeaFormatterChar(out, pack->latitudeNS);
+        } else {
+          nmeaFormatterChar(out, ',');
+        }
+      } else {
+        nmeaFormatterString(out, ",,");
+      }
+      break;
+
+    case NMEALIB_GPGGA_FIELD_LON:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_LON)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterDouble(out, pack->longitude, 10, 4);
+        if (pack->longitudeEW) {
+          nmeaFormatterChar(out, ',');
+          nmeaFormatterChar(out, pack->longitudeEW);
+        } else {
+          nmeaFormatterChar(out, ',');
+        }
+      } else {
+        nmeaFormatterString(out, ",,");
+      }
+      break;
+
+    case NMEALIB_GPGGA_FIELD_SIG:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_SIG)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterInt(out, pack->sig, 0);
+      } else {
+        nmeaFormatterChar(out, ',');
+      }
+      break;
+
+    case NMEALIB_GPGGA_FIELD_SATS:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_SATINVIEWCOUNT)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterUnsigned(out, pack->inViewCount, 2);
+      } else {
+        nmeaFormatterChar(out, ',');
+      }
+      break;
+
+    case NMEALIB_GPGGA_FIELD_HDOP:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_HDOP)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterDouble(out, pack->hdop, 3, 1);
+      } else {
+        nmeaFormatterChar(out, ',');
+      }
+      break;
+
+    case NMEALIB_GPGGA_FIELD_ELV:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_ELV)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterDouble(out, pack->elevation, 3, 1);
+        if (pack->elevationM) {
+          nmeaFormatterChar(out, ',');
+          nmeaFormatterChar(out, pack->elevationM);
+        } else {
+          nmeaFormatterChar(out, ',');
+        }
+      } else {
+        nmeaFormatterString(out, ",,");
+      }
+      break;
+
+    case NMEALIB_GPGGA_FIELD_HEIGHT:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_HEIGHT)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterDouble(out, pack->height, 3, 1);
+        if (pack->heightM) {
+          nmeaFormatterChar(out, ',');
+          nmeaFormatterChar(out, pack->heightM);
+        } else {
+          nmeaFormatterChar(out, ',');
+        }
+      } else {
+        nmeaFormatterString(out, ",,");
+      }
+      break;
+
+    case NMEALIB_GPGGA_FIELD_DGPSAGE:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_DGPSAGE)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterDouble(out, pack->dgpsAge, 3, 1);
+      } else {
+        nmeaFormatterChar(out, ',');
+      }
+      break;
+
+    case NMEALIB_GPGGA_FIELD_DGPSSID:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_DGPSSID)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterUnsigned(out, pack->dgpsSid, 0);
+      } else {
+        nmeaFormatterChar(out, ',');
+      }
+      break;
+
+    case NMEALIB_GPGGA_FIELD_COUNT:
+    default:
+      break;
   }
+}
 
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_ELV)) {
-    chars += snprintf(dst, available, ",%03.1f", pack->elevation);
-    if (pack->elevationM) {
-      chars += snprintf(dst, available, ",%c", pack->elevationM);
-    } else {
-      chars += snprintf(dst, available, ",");
-    }
-  } else {
-    chars += snprintf(dst, available, ",,");
-  }
+size_t nmeaGPGGAGenerate(char *s, const size_t sz, const NmeaGPGGA *pack) {
+  NmeaFormatter out;
+  unsigned int field;
 
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_HEIGHT)) {
-    chars += snprintf(dst, available, ",%03.1f", pack->height);
-    if (pack->heightM) {
-      chars += snprintf(dst, available, ",%c", pack->heightM);
-    } else {
-      chars += snprintf(dst, available, ",");
-    }
-  } else {
-    chars += snprintf(dst, available, ",,");
+  if (!s //
+      || !pack) {
+    return 0;
   }
 
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_DGPSAGE)) {
-    chars += snprintf(dst, available, ",%03.1f", pack->dgpsAge);
-  } else {
-    chars += snprintf(dst, available, ",");
-  }
+  nmeaFormatterInit(&out, s, sz);
+  nmeaFormatterString(&out, "$" NMEALIB_GPGGA_PREFIX);
 
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_DGPSSID)) {
-    chars += snprintf(dst, available, ",%u", pack->dgpsSid);
-  } else {
-    chars += snprintf(dst, available, ",");
+  for (field = 0; field < NMEALIB_GPGGA_FIELD_COUNT; field++) {
+    nmeaGPGGAGenerateField(&out, pack, (NmeaGPGGAField) field);
   }
 
   /* checksum */
-  chars += nmeaAppendChecksum(s, sz, (size_t) chars);
-
-  return (size_t) chars;
-
-#undef available
-#undef dst
+  nmeaFormatterChecksum(&out);
 
+  return out.length;
 }
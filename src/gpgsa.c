@@ -18,16 +18,21 @@
 #include <nmealib/gpgsa.h>
 
 #include <nmealib/context.h>
+#include <nmealib/format.h>
 #include <nmealib/sentence.h>
 #include <nmealib/util.h>
 #include <nmealib/validate.h>
 #include <limits.h>
 #include <math.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 bool nmeaGPGSAParse(const char *s, const size_t sz, NmeaGPGSA *pack) {
+  return nmeaGPGSAParsePolicy(s, sz, pack, NMEALIB_VALIDATION_STRICT);
+}
+
+bool nmeaGPGSAParsePolicy(const char *s, const size_t sz, NmeaGPGSA *pack, NmeaValidationPolicy policy) {
+  bool strict = (policy == NMEALIB_VALIDATION_STRICT);
   size_t tokenCount;
   size_t i;
   bool noPrns;
@@ -80,7 +85,8 @@ bool nmeaGPGSAParse(const char *s, const size_t sz, NmeaGPGSA *pack) {
   /* determine which fields are present and validate them */
 
   if (pack->sig) {
-    if ((pack->sig != 'A') //
+    if (strict //
+        && (pack->sig != 'A') //
         && (pack->sig != 'M')) {
       nmeaContextError(NMEALIB_GPGSA_PREFIX " parse error: invalid selection mode '%c' in '%s'", pack->sig, s);
       goto err;
@@ -92,7 +98,8 @@ bool nmeaGPGSAParse(const char *s, const size_t sz, NmeaGPGSA *pack) {
   }
 
   if (pack->fix != INT_MAX) {
-    if (!nmeaValidateFix(pack->fix, NMEALIB_GPGSA_PREFIX, s)) {
+    if (strict //
+        && !nmeaValidateFix(pack->fix, NMEALIB_GPGSA_PREFIX, s)) {
       goto err;
     }
 
@@ -253,11 +260,7 @@ void nmeaGPGSAFromInfo(const NmeaInfo *info, NmeaGPGSA *pack) {
 }
 
 size_t nmeaGPGSAGenerate(char *s, const size_t sz, const NmeaGPGSA *pack) {
-
-#define dst       (&s[chars])
-#define available ((sz <= (size_t) chars) ? 0 : (sz - (size_t) chars))
-
-  int chars = 0;
+  NmeaFormatter out;
   bool satInUse;
   size_t i;
 
@@ -266,55 +269,58 @@ size_t nmeaGPGSAGenerate(char *s, const size_t sz, const NmeaGPGSA *pack) {
     return 0;
   }
 
-  chars += snprintf(dst, available, "$" NMEALIB_GPGSA_PREFIX);
+  nmeaFormatterInit(&out, s, sz);
+  nmeaFormatterString(&out, "$" NMEALIB_GPGSA_PREFIX);
 
   if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_SIG) //
       && pack->sig) {
-    chars += snprintf(dst, available, ",%c", pack->sig);
+    nmeaFormatterChar(&out, ',');
+    nmeaFormatterChar(&out, pack->sig);
   } else {
-    chars += snprintf(dst, available, ",");
+    nmeaFormatterChar(&out, ',');
   }
 
   if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_FIX)) {
-    chars += snprintf(dst, available, ",%d", pack->fix);
+    nmeaFormatterChar(&out, ',');
+    nmeaFormatterInt(&out, pack->fix, 0);
   } else {
-    chars += snprintf(dst, available, ",");
+    nmeaFormatterChar(&out, ',');
   }
 
   satInUse = nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_SATINUSE);
   for (i = 0; i < NMEALIB_GPGSA_SATS_IN_SENTENCE; i++) {
     unsigned int prn = pack->prn[i];
     if (satInUse && prn) {
-      chars += snprintf(dst, available, ",%d", prn);
+      nmeaFormatterChar(&out, ',');
+      nmeaFormatterInt(&out, (int) prn, 0);
     } else {
-      chars += snprintf(dst, available, ",");
+      nmeaFormatterChar(&out, ',');
     }
   }
 
   if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_PDOP)) {
-    chars += snprintf(dst, available, ",%03.1f", pack->pdop);
+    nmeaFormatterChar(&out, ',');
+    nmeaFormatterDouble(&out, pack->pdop, 3, 1);
   } else {
-    chars += snprintf(dst, available, ",");
+    nmeaFormatterChar(&out, ',');
   }
 
   if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_HDOP)) {
-    chars += snprintf(dst, available, ",%03.1f", pack->hdop);
+    nmeaFormatterChar(&out, ',');
+    nmeaFormatterDouble(&out, pack->hdop, 3, 1);
   } else {
-    chars += snprintf(dst, available, ",");
+    nmeaFormatterChar(&out, ',');
   }
 
   if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_VDOP)) {
-    chars += snprintf(dst, available, ",%03.1f", pack->vdop);
+    nmeaFormatterChar(&out, ',');
+    nmeaFormatterDouble(&out, pack->vdop, 3, 1);
   } else {
-    chars += snprintf(dst, available, ",");
+    nmeaFormatterChar(&out, ',');
   }
 
   /* checksum */
-  chars += nmeaAppendChecksum(s, sz, (size_t) chars);
-
-  return (size_t) chars;
-
-#undef available
-#undef dst
+  nmeaFormatterChecksum(&out);
 
+  return out.length;
 }
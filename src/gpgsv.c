@@ -18,10 +18,10 @@
 #include <nmealib/gpgsv.h>
 
 #include <nmealib/context.h>
+#include <nmealib/format.h>
 #include <nmealib/sentence.h>
 #include <nmealib/validate.h>
 #include <limits.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -42,6 +42,10 @@ size_t nmeaGPGSVsatellitesToSentencesCount(const size_t satellites) {
 }
 
 bool nmeaGPGSVParse(const char *s, const size_t sz, NmeaGPGSV *pack) {
+  return nmeaGPGSVParsePolicy(s, sz, pack, NMEALIB_VALIDATION_STRICT);
+}
+
+bool nmeaGPGSVParsePolicy(const char *s, const size_t sz, NmeaGPGSV *pack, NmeaValidationPolicy policy) {
 
 #define sat0 pack->inView[0]
 #define sat1 pack->inView[1]
@@ -52,6 +56,7 @@ bool nmeaGPGSVParse(const char *s, const size_t sz, NmeaGPGSV *pack) {
   size_t tokenCountExpected;
   size_t satellitesInSentence;
   size_t i;
+  bool strict = (policy == NMEALIB_VALIDATION_STRICT);
 
   if (!pack) {
     return false;
@@ -149,7 +154,8 @@ bool nmeaGPGSVParse(const char *s, const size_t sz, NmeaGPGSV *pack) {
   /* validate all satellites */
   for (i = 0; i < NMEALIB_GPGSV_MAX_SATS_PER_SENTENCE; i++) {
     NmeaSatellite *sat = &pack->inView[i];
-    if (!nmeaValidateSatellite(sat, NMEALIB_GPGSV_PREFIX, s)) {
+    if (strict //
+        && !nmeaValidateSatellite(sat, NMEALIB_GPGSV_PREFIX, s)) {
       goto err;
     }
   }
@@ -292,11 +298,7 @@ void nmeaGPGSVFromInfo(const NmeaInfo *info, NmeaGPGSV *pack, size_t sentence) {
 }
 
 size_t nmeaGPGSVGenerate(char *s, const size_t sz, const NmeaGPGSV *pack) {
-
-#define dst       (&s[chars])
-#define available ((sz <= (size_t) chars) ? 0 : (sz - (size_t) chars))
-
-  int chars = 0;
+  NmeaFormatter out;
   size_t inViewCount = 0;
   size_t sentenceCount = 1;
   size_t sentence = 1;
@@ -308,6 +310,7 @@ size_t nmeaGPGSVGenerate(char *s, const size_t sz, const NmeaGPGSV *pack) {
     return 0;
   }
 
+  nmeaFormatterInit(&out, s, sz);
   if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_SATINVIEWCOUNT)) {
     inViewCount = pack->inViewCount;
     sentenceCount = pack->sentenceCount;
@@ -317,11 +320,12 @@ size_t nmeaGPGSVGenerate(char *s, const size_t sz, const NmeaGPGSV *pack) {
     sentence = pack->sentence;
   }
 
-  chars += snprintf(dst, available, //
-      "$" NMEALIB_GPGSV_PREFIX ",%lu,%lu,%lu", //
-      (long unsigned) sentenceCount, //
-      (long unsigned) sentence, //
-      (long unsigned) inViewCount);
+  nmeaFormatterString(&out, "$" NMEALIB_GPGSV_PREFIX ",");
+  nmeaFormatterUnsigned(&out, sentenceCount, 0);
+  nmeaFormatterChar(&out, ',');
+  nmeaFormatterUnsigned(&out, sentence, 0);
+  nmeaFormatterChar(&out, ',');
+  nmeaFormatterUnsigned(&out, inViewCount, 0);
 
   if (pack->sentence != pack->sentenceCount) {
     satellitesInSentence = NMEALIB_GPGSV_MAX_SATS_PER_SENTENCE;
@@ -333,19 +337,22 @@ size_t nmeaGPGSVGenerate(char *s, const size_t sz, const NmeaGPGSV *pack) {
     for (i = 0; i < satellitesInSentence; i++) {
       const NmeaSatellite *sat = &pack->inView[i];
       if (sat->prn) {
-        chars += snprintf(dst, available, ",%u,%d,%u,%u", sat->prn, sat->elevation, sat->azimuth, sat->snr);
+        nmeaFormatterChar(&out, ',');
+        nmeaFormatterUnsigned(&out, sat->prn, 0);
+        nmeaFormatterChar(&out, ',');
+        nmeaFormatterInt(&out, sat->elevation, 0);
+        nmeaFormatterChar(&out, ',');
+        nmeaFormatterUnsigned(&out, sat->azimuth, 0);
+        nmeaFormatterChar(&out, ',');
+        nmeaFormatterUnsigned(&out, sat->snr, 0);
       } else {
-        chars += snprintf(dst, available, ",,,,");
+        nmeaFormatterString(&out, ",,,,");
       }
     }
   }
 
   /* checksum */
-  chars += nmeaAppendChecksum(s, sz, (size_t) chars);
-
-  return (size_t) chars;
-
-#undef available
-#undef dst
+  nmeaFormatterChecksum(&out);
 
+  return out.length;
 }
@@ -18,15 +18,20 @@
 #include <nmealib/gprmc.h>
 
 #include <nmealib/context.h>
+#include <nmealib/format.h>
 #include <nmealib/nmath.h>
 #include <nmealib/sentence.h>
 #include <nmealib/util.h>
 #include <nmealib/validate.h>
 #include <math.h>
-#include <stdio.h>
 #include <string.h>
 
 bool nmeaGPRMCParse(const char *s, const size_t sz, NmeaGPRMC *pack) {
+  return nmeaGPRMCParsePolicy(s, sz, pack, NMEALIB_VALIDATION_STRICT);
+}
+
+bool nmeaGPRMCParsePolicy(const char *s, const size_t sz, NmeaGPRMC *pack, NmeaValidationPolicy policy) {
+  bool strict = (policy == NMEALIB_VALIDATION_STRICT);
   size_t tokenCount;
   char timeBuf[16];
   char dateBuf[16];
@@ -80,7 +85,8 @@ bool nmeaGPRMCParse(const char *s, const size_t sz, NmeaGPRMC *pack) {
 
   if (*timeBuf) {
     if (!nmeaTimeParseTime(timeBuf, &pack->utc) //
-        || !nmeaValidateTime(&pack->utc, NMEALIB_GPRMC_PREFIX, s)) {
+        || (strict //
+            && !nmeaValidateTime(&pack->utc, NMEALIB_GPRMC_PREFIX, s))) {
       goto err;
     }
 
@@ -92,7 +98,8 @@ bool nmeaGPRMCParse(const char *s, const size_t sz, NmeaGPRMC *pack) {
     pack->utc.hsec = 0;
   }
 
-  if (pack->sigSelection //
+  if (strict //
+      && pack->sigSelection //
       && (pack->sigSelection != 'A') //
       && (pack->sigSelection != 'V')) {
     nmeaContextError(NMEALIB_GPRMC_PREFIX " parse error: invalid status '%c' in '%s'", pack->sigSelection, s);
@@ -112,7 +119,8 @@ bool nmeaGPRMCParse(const char *s, const size_t sz, NmeaGPRMC *pack) {
     /* with mode */
     if (pack->sigSelection //
         && pack->sig) {
-      if (!nmeaValidateMode(pack->sig, NMEALIB_GPRMC_PREFIX, s)) {
+      if (strict //
+          && !nmeaValidateMode(pack->sig, NMEALIB_GPRMC_PREFIX, s)) {
         goto err;
       }
 
@@ -124,7 +132,8 @@ bool nmeaGPRMCParse(const char *s, const size_t sz, NmeaGPRMC *pack) {
   }
 
   if (!isNaN(pack->latitude)) {
-    if (!nmeaValidateNSEW(pack->latitudeNS, true, NMEALIB_GPRMC_PREFIX, s)) {
+    if (strict //
+        && !nmeaValidateNSEW(pack->latitudeNS, true, NMEALIB_GPRMC_PREFIX, s)) {
       goto err;
     }
 
@@ -135,7 +144,8 @@ bool nmeaGPRMCParse(const char *s, const size_t sz, NmeaGPRMC *pack) {
   }
 
   if (!isNaN(pack->longitude)) {
-    if (!nmeaValidateNSEW(pack->longitudeEW, false, NMEALIB_GPRMC_PREFIX, s)) {
+    if (strict //
+        && !nmeaValidateNSEW(pack->longitudeEW, false, NMEALIB_GPRMC_PREFIX, s)) {
       goto err;
     }
 
@@ -159,7 +169,8 @@ bool nmeaGPRMCParse(const char *s, const size_t sz, NmeaGPRMC *pack) {
 
   if (*dateBuf) {
     if (!nmeaTimeParseDate(dateBuf, &pack->utc) //
-        || !nmeaValidateDate(&pack->utc, NMEALIB_GPRMC_PREFIX, s)) {
+        || (strict //
+            && !nmeaValidateDate(&pack->utc, NMEALIB_GPRMC_PREFIX, s))) {
       goto err;
     }
 
@@ -171,7 +182,8 @@ bool nmeaGPRMCParse(const char *s, const size_t sz, NmeaGPRMC *pack) {
   }
 
   if (!isNaN(pack->magvar)) {
-    if (!nmeaValidateNSEW(pack->magvarEW, false, NMEALIB_GPRMC_PREFIX, s)) {
+    if (strict //
+        && !nmeaValidateNSEW(pack->magvarEW, false, NMEALIB_GPRMC_PREFIX, s)) {
       goto err;
     }
 
@@ -335,108 +347,146 @@ void nmeaGPRMCFromInfo(const NmeaInfo *info, NmeaGPRMC *pack) {
   }
 }
 
-size_t nmeaGPRMCGenerate(char *s, const size_t sz, const NmeaGPRMC *pack) {
-
-#define dst       (&s[chars])
-#define available ((sz <= (size_t) chars) ? 0 : (sz - (size_t) chars))
-
-  int chars = 0;
-
-  if (!s //
+void nmeaGPRMCGenerateField(NmeaFormatter *out, const NmeaGPRMC *pack, const NmeaGPRMCField field) {
+  if (!out //
       || !pack) {
-    return 0;
+    return;
   }
 
-  chars += snprintf(dst, available, "$" NMEALIB_GPRMC_PREFIX);
-
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_UTCTIME)) {
-    chars += snprintf(dst, available, //
-        ",%02u%02u%02u.%02u", //
-        pack->utc.hour, //
-        pack->utc.min, //
-        pack->utc.sec, //
-        pack->utc.hsec);
-  } else {
-    chars += snprintf(dst, available, ",");
-  }
+  switch (field) {
+    case NMEALIB_GPRMC_FIELD_UTC:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_UTCTIME)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterUnsigned(out, pack->utc.hour, 2);
+        nmeaFormatterUnsigned(out, pack->utc.min, 2);
+        nmeaFormatterUnsigned(out, pack->utc.sec, 2);
+        nmeaFormatterChar(out, '.');
+        nmeaFormatterUnsigned(out, pack->utc.hsec, 2);
+      } else {
+        nmeaFormatterChar(out, ',');
+      }
+      break;
 
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_SIG) //
-      && pack->sigSelection) {
-    chars += snprintf(dst, available, ",%c", pack->sigSelection);
-  } else {
-    chars += snprintf(dst, available, ",");
-  }
+    case NMEALIB_GPRMC_FIELD_SIGSELECTION:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_SIG) //
+          && pack->sigSelection) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterChar(out, pack->sigSelection);
+      } else {
+        nmeaFormatterChar(out, ',');
+      }
+      break;
+
+    case NMEALIB_GPRMC_FIELD_LAT:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_LAT)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterDouble(out, pack->latitude, 9, 4);
+        if (pack->latitudeNS) {
+          nmeaFormatterChar(out, ',');
+          nmeaFormatterChar(out, pack->latitudeNS);
+        } else {
+          nmeaFormatterChar(out, ',');
+        }
+      } else {
+        nmeaFormatterString(out, ",,");
+      }
+      break;
+
+    case NMEALIB_GPRMC_FIELD_LON:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_LON)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterDouble(out, pack->longitude, 10, 4);
+        if (pack->longitudeEW) {
+          nmeaFormatterChar(out, ',');
+          nmeaFormatterChar(out, pack->longitudeEW);
+        } else {
+          nmeaFormatterChar(out, ',');
+        }
+      } else {
+        nmeaFormatterString(out, ",,");
+      }
+      break;
 
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_LAT)) {
-    chars += snprintf(dst, available, ",%09.4f", pack->latitude);
-    if (pack->latitudeNS) {
-      chars += snprintf(dst, available, ",%c", pack->latitudeNS);
-    } else {
-      chars += snprintf(dst, available, ",");
-    }
-  } else {
-    chars += snprintf(dst, available, ",,");
-  }
+    case NMEALIB_GPRMC_FIELD_SPEED:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_SPEED)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterDouble(out, pack->speed, 3, 1);
+      } else {
+        nmeaFormatterChar(out, ',');
+      }
+      break;
 
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_LON)) {
-    chars += snprintf(dst, available, ",%010.4f", pack->longitude);
-    if (pack->longitudeEW) {
-      chars += snprintf(dst, available, ",%c", pack->longitudeEW);
-    } else {
-      chars += snprintf(dst, available, ",");
-    }
-  } else {
-    chars += snprintf(dst, available, ",,");
-  }
+    case NMEALIB_GPRMC_FIELD_TRACK:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_TRACK)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterDouble(out, pack->track, 3, 1);
+      } else {
+        nmeaFormatterChar(out, ',');
+      }
+      break;
+
+    case NMEALIB_GPRMC_FIELD_DATE:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_UTCDATE)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterUnsigned(out, pack->utc.day, 2);
+        nmeaFormatterUnsigned(out, pack->utc.mon, 2);
+        nmeaFormatterUnsigned(out, pack->utc.year % 100, 2);
+      } else {
+        nmeaFormatterChar(out, ',');
+      }
+      break;
+
+    case NMEALIB_GPRMC_FIELD_MAGVAR:
+      if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_MAGVAR)) {
+        nmeaFormatterChar(out, ',');
+        nmeaFormatterDouble(out, pack->magvar, 3, 1);
+        if (pack->magvarEW) {
+          nmeaFormatterChar(out, ',');
+          nmeaFormatterChar(out, pack->magvarEW);
+        } else {
+          nmeaFormatterChar(out, ',');
+        }
+      } else {
+        nmeaFormatterString(out, ",,");
+      }
+      break;
+
+    case NMEALIB_GPRMC_FIELD_SIG:
+      if (pack->v23) {
+        if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_SIG) //
+            && pack->sig) {
+          nmeaFormatterChar(out, ',');
+          nmeaFormatterChar(out, pack->sig);
+        } else {
+          nmeaFormatterChar(out, ',');
+        }
+      }
+      break;
 
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_SPEED)) {
-    chars += snprintf(dst, available, ",%03.1f", pack->speed);
-  } else {
-    chars += snprintf(dst, available, ",");
+    case NMEALIB_GPRMC_FIELD_COUNT:
+    default:
+      break;
   }
+}
 
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_TRACK)) {
-    chars += snprintf(dst, available, ",%03.1f", pack->track);
-  } else {
-    chars += snprintf(dst, available, ",");
-  }
+size_t nmeaGPRMCGenerate(char *s, const size_t sz, const NmeaGPRMC *pack) {
+  NmeaFormatter out;
+  unsigned int field;
 
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_UTCDATE)) {
-    chars += snprintf(dst, available, //
-        ",%02u%02u%02u", //
-        pack->utc.day, //
-        pack->utc.mon, //
-        pack->utc.year % 100);
-  } else {
-    chars += snprintf(dst, available, ",");
+  if (!s //
+      || !pack) {
+    return 0;
   }
 
-  if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_MAGVAR)) {
-    chars += snprintf(dst, available, ",%03.1f", pack->magvar);
-    if (pack->magvarEW) {
-      chars += snprintf(dst, available, ",%c", pack->magvarEW);
-    } else {
-      chars += snprintf(dst, available, ",");
-    }
-  } else {
-    chars += snprintf(dst, available, ",,");
-  }
+  nmeaFormatterInit(&out, s, sz);
+  nmeaFormatterString(&out, "$" NMEALIB_GPRMC_PREFIX);
 
-  if (pack->v23) {
-    if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_SIG) //
-        && pack->sig) {
-      chars += snprintf(dst, available, ",%c", pack->sig);
-    } else {
-      chars += snprintf(dst, available, ",");
-    }
+  for (field = 0; field < NMEALIB_GPRMC_FIELD_COUNT; field++) {
+    nmeaGPRMCGenerateField(&out, pack, (NmeaGPRMCField) field);
   }
 
   /* checksum */
-  chars += nmeaAppendChecksum(s, sz, (size_t) chars);
-
-  return (size_t) chars;
-
-#undef available
-#undef dst
+  nmeaFormatterChecksum(&out);
 
+  return out.length;
 }
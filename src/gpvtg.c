@@ -18,14 +18,19 @@
 #include <nmealib/gpvtg.h>
 
 #include <nmealib/context.h>
+#include <nmealib/format.h>
 #include <nmealib/nmath.h>
 #include <nmealib/sentence.h>
 #include <nmealib/util.h>
 #include <math.h>
-#include <stdio.h>
 #include <string.h>
 
 bool nmeaGPVTGParse(const char *s, const size_t sz, NmeaGPVTG *pack) {
+  return nmeaGPVTGParsePolicy(s, sz, pack, NMEALIB_VALIDATION_STRICT);
+}
+
+bool nmeaGPVTGParsePolicy(const char *s, const size_t sz, NmeaGPVTG *pack, NmeaValidationPolicy policy) {
+  bool strict = (policy == NMEALIB_VALIDATION_STRICT);
   size_t tokenCount;
   bool speedK = false;
   bool speedN = false;
@@ -67,7 +72,8 @@ bool nmeaGPVTGParse(const char *s, const size_t sz, NmeaGPVTG *pack) {
   /* determine which fields are present and validate them */
 
   if (!isNaN(pack->track)) {
-    if (pack->trackT != 'T') {
+    if (strict //
+        && (pack->trackT != 'T')) {
       nmeaContextError(NMEALIB_GPVTG_PREFIX " parse error: invalid track unit, got '%c', expected 'T'", pack->trackT);
       goto err;
     }
@@ -79,7 +85,8 @@ bool nmeaGPVTGParse(const char *s, const size_t sz, NmeaGPVTG *pack) {
   }
 
   if (!isNaN(pack->mtrack)) {
-    if (pack->mtrackM != 'M') {
+    if (strict //
+        && (pack->mtrackM != 'M')) {
       nmeaContextError(NMEALIB_GPVTG_PREFIX " parse error: invalid mtrack unit, got '%c', expected 'M'",
           pack->mtrackM);
       goto err;
@@ -92,7 +99,8 @@ bool nmeaGPVTGParse(const char *s, const size_t sz, NmeaGPVTG *pack) {
   }
 
   if (!isNaN(pack->spn)) {
-    if (pack->spnN != 'N') {
+    if (strict //
+        && (pack->spnN != 'N')) {
       nmeaContextError(NMEALIB_GPVTG_PREFIX " parse error: invalid knots speed unit, got '%c', expected 'N'",
           pack->spnN);
       goto err;
@@ -106,7 +114,8 @@ bool nmeaGPVTGParse(const char *s, const size_t sz, NmeaGPVTG *pack) {
   }
 
   if (!isNaN(pack->spk)) {
-    if (pack->spkK != 'K') {
+    if (strict //
+        && (pack->spkK != 'K')) {
       nmeaContextError(NMEALIB_GPVTG_PREFIX " parse error: invalid kph speed unit, got '%c', expected 'K'",
           pack->spkK);
       goto err;
@@ -194,65 +203,66 @@ void nmeaGPVTGFromInfo(const NmeaInfo *info, NmeaGPVTG *pack) {
 }
 
 size_t nmeaGPVTGGenerate(char *s, const size_t sz, const NmeaGPVTG *pack) {
-
-#define dst       (&s[chars])
-#define available ((sz <= (size_t) chars) ? 0 : (sz - (size_t) chars))
-
-  int chars = 0;
+  NmeaFormatter out;
 
   if (!s //
       || !pack) {
     return 0;
   }
 
-  chars += snprintf(dst, available, "$" NMEALIB_GPVTG_PREFIX);
+  nmeaFormatterInit(&out, s, sz);
+  nmeaFormatterString(&out, "$" NMEALIB_GPVTG_PREFIX);
 
   if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_TRACK)) {
-    chars += snprintf(dst, available, ",%03.1f", pack->track);
+    nmeaFormatterChar(&out, ',');
+    nmeaFormatterDouble(&out, pack->track, 3, 1);
     if (pack->trackT) {
-      chars += snprintf(dst, available, ",%c", pack->trackT);
+      nmeaFormatterChar(&out, ',');
+      nmeaFormatterChar(&out, pack->trackT);
     } else {
-      chars += snprintf(dst, available, ",");
+      nmeaFormatterChar(&out, ',');
     }
   } else {
-    chars += snprintf(dst, available, ",,");
+    nmeaFormatterString(&out, ",,");
   }
 
   if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_MTRACK)) {
-    chars += snprintf(dst, available, ",%03.1f", pack->mtrack);
+    nmeaFormatterChar(&out, ',');
+    nmeaFormatterDouble(&out, pack->mtrack, 3, 1);
     if (pack->mtrackM) {
-      chars += snprintf(dst, available, ",%c", pack->mtrackM);
+      nmeaFormatterChar(&out, ',');
+      nmeaFormatterChar(&out, pack->mtrackM);
     } else {
-      chars += snprintf(dst, available, ",");
+      nmeaFormatterChar(&out, ',');
     }
   } else {
-    chars += snprintf(dst, available, ",,");
+    nmeaFormatterString(&out, ",,");
   }
 
   if (nmeaInfoIsPresentAll(pack->present, NMEALIB_PRESENT_SPEED)) {
-    chars += snprintf(dst, available, ",%03.1f", pack->spn);
+    nmeaFormatterChar(&out, ',');
+    nmeaFormatterDouble(&out, pack->spn, 3, 1);
     if (pack->spnN) {
-      chars += snprintf(dst, available, ",%c", pack->spnN);
+      nmeaFormatterChar(&out, ',');
+      nmeaFormatterChar(&out, pack->spnN);
     } else {
-      chars += snprintf(dst, available, ",");
+      nmeaFormatterChar(&out, ',');
     }
 
-    chars += snprintf(dst, available, ",%03.1f", pack->spk);
+    nmeaFormatterChar(&out, ',');
+    nmeaFormatterDouble(&out, pack->spk, 3, 1);
     if (pack->spkK) {
-      chars += snprintf(dst, available, ",%c", pack->spkK);
+      nmeaFormatterChar(&out, ',');
+      nmeaFormatterChar(&out, pack->spkK);
     } else {
-      chars += snprintf(dst, available, ",");
+      nmeaFormatterChar(&out, ',');
     }
   } else {
-    chars += snprintf(dst, available, ",,,,");
+    nmeaFormatterString(&out, ",,,,");
   }
 
   /* checksum */
-  chars += nmeaAppendChecksum(s, sz, (size_t) chars);
-
-  return (size_t) chars;
-
-#undef available
-#undef dst
+  nmeaFormatterChecksum(&out);
 
+  return out.length;
 }
@@ -0,0 +1,237 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/history.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Get a record from a history by index without range checking
+ *
+ * @param history The history
+ * @param index The index of the record, 0 being the oldest record
+ * @return The record
+ */
+static INLINE NmeaRecord *nmeaHistoryAt(const NmeaHistory *history, size_t index) {
+  size_t i = history->head + index;
+
+  if (i >= history->capacity) {
+    i -= history->capacity;
+  }
+
+  return &history->records[i];
+}
+
+/**
+ * Drop the records that are older than the maximum age
+ *
+ * @param history The history
+ */
+static void nmeaHistoryExpire(NmeaHistory *history) {
+  int64_t oldest;
+
+  if (!history->maxAge //
+      || !history->count) {
+    return;
+  }
+
+  oldest = nmeaHistoryAt(history, history->count - 1)->time - history->maxAge;
+
+  while (history->count //
+      && (nmeaHistoryAt(history, 0)->time < oldest)) {
+    history->head++;
+    if (history->head >= history->capacity) {
+      history->head = 0;
+    }
+    history->count--;
+  }
+}
+
+bool nmeaHistoryInit(NmeaHistory *history, size_t capacity, int64_t maxAge) {
+  if (!history //
+      || !capacity //
+      || (maxAge < 0)) {
+    return false;
+  }
+
+  memset(history, 0, sizeof(*history));
+
+  history->records = malloc(capacity * sizeof(history->records[0]));
+  if (!history->records) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  history->capacity = capacity;
+  history->maxAge = maxAge;
+
+  return true;
+}
+
+void nmeaHistoryDestroy(NmeaHistory *history) {
+  if (!history) {
+    return;
+  }
+
+  free(history->records);
+  memset(history, 0, sizeof(*history));
+}
+
+void nmeaHistoryClear(NmeaHistory *history) {
+  if (!history) {
+    return;
+  }
+
+  history->head = 0;
+  history->count = 0;
+}
+
+bool nmeaHistoryAdd(NmeaHistory *history, const NmeaRecord *record) {
+  NmeaRecord *newest;
+
+  if (!history //
+      || !history->records //
+      || !record) {
+    return false;
+  }
+
+  if (history->count) {
+    newest = nmeaHistoryAt(history, history->count - 1);
+
+    if (record->time < newest->time) {
+      return false;
+    }
+
+    if (record->time == newest->time) {
+      *newest = *record;
+      return true;
+    }
+  }
+
+  if (history->count == history->capacity) {
+    /* drop the oldest record */
+    history->head++;
+    if (history->head >= history->capacity) {
+      history->head = 0;
+    }
+    history->count--;
+  }
+
+  *nmeaHistoryAt(history, history->count) = *record;
+  history->count++;
+
+  nmeaHistoryExpire(history);
+
+  return true;
+}
+
+bool nmeaHistoryAddInfo(NmeaHistory *history, const NmeaInfo *info) {
+  NmeaRecord record;
+
+  if (!nmeaRecordFromInfo(info, &record)) {
+    return false;
+  }
+
+  return nmeaHistoryAdd(history, &record);
+}
+
+const NmeaRecord *nmeaHistoryGet(const NmeaHistory *history, size_t index) {
+  if (!history //
+      || (index >= history->count)) {
+    return NULL;
+  }
+
+  return nmeaHistoryAt(history, index);
+}
+
+size_t nmeaHistoryFind(const NmeaHistory *history, int64_t time) {
+  size_t low = 0;
+  size_t high;
+
+  if (!history) {
+    return 0;
+  }
+
+  high = history->count;
+
+  while (low < high) {
+    size_t middle = low + ((high - low) >> 1);
+
+    if (nmeaHistoryAt(history, middle)->time < time) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  return low;
+}
+
+size_t nmeaHistoryRange(const NmeaHistory *history, int64_t from, int64_t to, size_t *first) {
+  size_t start;
+  size_t end;
+
+  if (first) {
+    *first = 0;
+  }
+
+  if (!history //
+      || !history->count //
+      || (from > to)) {
+    return 0;
+  }
+
+  start = nmeaHistoryFind(history, from);
+  end = (to == INT64_MAX) ?
+      history->count :
+      nmeaHistoryFind(history, to + 1);
+
+  if (first) {
+    *first = start;
+  }
+
+  return end - start;
+}
+
+bool nmeaHistoryInterpolate(const NmeaHistory *history, int64_t time, NmeaRecord *record) {
+  size_t index;
+  const NmeaRecord *later;
+
+  if (!history //
+      || !history->count //
+      || !record) {
+    return false;
+  }
+
+  index = nmeaHistoryFind(history, time);
+  if (index >= history->count) {
+    return false;
+  }
+
+  later = nmeaHistoryAt(history, index);
+  if (later->time == time) {
+    *record = *later;
+    return true;
+  }
+
+  if (!index) {
+    return false;
+  }
+
+  return nmeaRecordInterpolate(nmeaHistoryAt(history, index - 1), later, time, record);
+}
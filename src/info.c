@@ -215,6 +215,92 @@ void nmeaTimeSet(NmeaTime *utc, uint32_t *present, struct timeval *timeval) {
   }
 }
 
+/** The number of nanoseconds in a second */
+#define NMEALIB_NS_PER_SECOND (1000000000LL)
+
+/** The number of nanoseconds in a hundredth part of a second */
+#define NMEALIB_NS_PER_HSEC   (10000000LL)
+
+/** The number of seconds in a day */
+#define NMEALIB_SECONDS_PER_DAY (86400LL)
+
+int64_t nmeaTimeToEpochNs(const NmeaTime *t) {
+  int64_t year;
+  int64_t era;
+  int64_t yearOfEra;
+  int64_t dayOfYear;
+  int64_t dayOfEra;
+  int64_t days;
+  int64_t seconds;
+
+  if (!t) {
+    return 0;
+  }
+
+  /* days since the epoch, proleptic Gregorian calendar with March as the first month */
+  year = (int64_t) t->year - ((t->mon <= 2) ? 1 : 0);
+  era = ((year >= 0) ? year : (year - 399)) / 400;
+  yearOfEra = year - (era * 400);
+  dayOfYear = ((153 * ((int64_t) t->mon + ((t->mon > 2) ? -3 : 9)) + 2) / 5) + (int64_t) t->day - 1;
+  dayOfEra = (yearOfEra * 365) + (yearOfEra / 4) - (yearOfEra / 100) + dayOfYear;
+  days = (era * 146097) + dayOfEra - 719468;
+
+  seconds = (days * NMEALIB_SECONDS_PER_DAY) //
+      + ((int64_t) t->hour * 3600) //
+      + ((int64_t) t->min * 60) //
+      + (int64_t) t->sec;
+
+  return (seconds * NMEALIB_NS_PER_SECOND) + ((int64_t) t->hsec * NMEALIB_NS_PER_HSEC);
+}
+
+void nmeaTimeFromEpochNs(int64_t ns, NmeaTime *t) {
+  int64_t seconds;
+  int64_t subSeconds;
+  int64_t days;
+  int64_t secondOfDay;
+  int64_t era;
+  int64_t dayOfEra;
+  int64_t yearOfEra;
+  int64_t dayOfYear;
+  int64_t monthIndex;
+  int64_t year;
+
+  if (!t) {
+    return;
+  }
+
+  seconds = ns / NMEALIB_NS_PER_SECOND;
+  subSeconds = ns % NMEALIB_NS_PER_SECOND;
+  if (subSeconds < 0) {
+    subSeconds += NMEALIB_NS_PER_SECOND;
+    seconds--;
+  }
+
+  days = seconds / NMEALIB_SECONDS_PER_DAY;
+  secondOfDay = seconds % NMEALIB_SECONDS_PER_DAY;
+  if (secondOfDay < 0) {
+    secondOfDay += NMEALIB_SECONDS_PER_DAY;
+    days--;
+  }
+
+  /* civil date from days since the epoch, the inverse of nmeaTimeToEpochNs */
+  days += 719468;
+  era = ((days >= 0) ? days : (days - 146096)) / 146097;
+  dayOfEra = days - (era * 146097);
+  yearOfEra = (dayOfEra - (dayOfEra / 1460) + (dayOfEra / 36524) - (dayOfEra / 146096)) / 365;
+  dayOfYear = dayOfEra - ((365 * yearOfEra) + (yearOfEra / 4) - (yearOfEra / 100));
+  monthIndex = ((5 * dayOfYear) + 2) / 153;
+  year = yearOfEra + (era * 400);
+
+  t->day = (unsigned int) (dayOfYear - (((153 * monthIndex) + 2) / 5) + 1);
+  t->mon = (unsigned int) ((monthIndex < 10) ? (monthIndex + 3) : (monthIndex - 9));
+  t->year = (unsigned int) (year + ((t->mon <= 2) ? 1 : 0));
+  t->hour = (unsigned int) (secondOfDay / 3600);
+  t->min = (unsigned int) ((secondOfDay % 3600) / 60);
+  t->sec = (unsigned int) (secondOfDay % 60);
+  t->hsec = (unsigned int) (subSeconds / NMEALIB_NS_PER_HSEC);
+}
+
 void nmeaInfoClear(NmeaInfo *info) {
   if (!info) {
     return;
@@ -0,0 +1,443 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* for posix_openpt, ptsname_r and cfmakeraw */
+#define _GNU_SOURCE
+
+#include <nmealib/loadgen.h>
+
+#include <nmealib/util.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/** The number of nanoseconds in a second */
+#define NMEALIB_LOADGEN_NS_PER_SECOND (1000000000ll)
+
+/** The number of bits a byte occupies on a serial line: start bit, 8 data bits, stop bit */
+#define NMEALIB_LOADGEN_BITS_PER_BYTE (10ll)
+
+/** The deadline of a run without a duration */
+#define NMEALIB_LOADGEN_NO_DEADLINE (INT64_MAX)
+
+/*
+ * Helpers
+ */
+
+/**
+ * @return The monotonic time in ns
+ */
+static int64_t nmeaLoadGenNow(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((int64_t) ts.tv_sec * NMEALIB_LOADGEN_NS_PER_SECOND) + (int64_t) ts.tv_nsec;
+}
+
+/**
+ * Sleep until a monotonic time
+ *
+ * @param until The monotonic time in ns
+ */
+static void nmeaLoadGenSleepUntil(int64_t until) {
+  struct timespec ts;
+
+  if (until <= nmeaLoadGenNow()) {
+    return;
+  }
+
+  ts.tv_sec = (time_t) (until / NMEALIB_LOADGEN_NS_PER_SECOND);
+  ts.tv_nsec = (long) (until % NMEALIB_LOADGEN_NS_PER_SECOND);
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    /* interrupted, sleep again */
+  }
+}
+
+/**
+ * Make a file descriptor non-blocking
+ *
+ * @param fd The file descriptor
+ * @return True on success
+ */
+static bool nmeaLoadGenNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL);
+
+  return (flags != -1) //
+      && (fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1);
+}
+
+/**
+ * Use a file descriptor as output
+ *
+ * @param loadgen The load generator
+ * @param fd The file descriptor
+ * @param own True when the load generator closes the file descriptor
+ * @return True on success
+ */
+static bool nmeaLoadGenSetFd(NmeaLoadGen *loadgen, int fd, bool own) {
+  if (!nmeaLoadGenNonBlocking(fd)) {
+    if (own) {
+      close(fd);
+    }
+    return false;
+  }
+
+  loadgen->fd = fd;
+  loadgen->ownFd = own;
+
+  return true;
+}
+
+/**
+ * Write a sentence completely, waiting for the output when it is full
+ *
+ * @param loadgen The load generator
+ * @param s The sentence
+ * @param len The length of the sentence
+ * @param deadline The monotonic time (in ns) after which to stop waiting
+ * @return True on success, false on a write error or when the deadline passed
+ */
+static bool nmeaLoadGenWrite(NmeaLoadGen *loadgen, const char *s, size_t len, int64_t deadline) {
+  while (len) {
+    ssize_t r = write(loadgen->fd, s, len);
+    struct pollfd pfd;
+    int64_t blocked;
+    int timeout;
+
+    if (r > 0) {
+      s += r;
+      len -= (size_t) r;
+      continue;
+    }
+
+    if ((r < 0) //
+        && (errno == EINTR)) {
+      continue;
+    }
+
+    if ((r < 0) //
+        && (errno != EAGAIN) //
+        && (errno != EWOULDBLOCK)) {
+      return false;
+    }
+
+    /* backpressure */
+    loadgen->metrics.blocked++;
+    blocked = nmeaLoadGenNow();
+    if (blocked >= deadline) {
+      return false;
+    }
+
+    timeout = (deadline == NMEALIB_LOADGEN_NO_DEADLINE) ?
+        -1 :
+        (int) MIN(((deadline - blocked) / 1000000) + 1, (int64_t) 1000);
+
+    pfd.fd = loadgen->fd;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
+    poll(&pfd, 1, timeout);
+
+    loadgen->metrics.blockedSeconds += (double) (nmeaLoadGenNow() - blocked) / (double) NMEALIB_LOADGEN_NS_PER_SECOND;
+
+    if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*
+ * Public
+ */
+
+bool nmeaLoadGenInit(NmeaLoadGen *loadgen, const NmeaLoadGenConfig *config) {
+  if (!loadgen) {
+    return false;
+  }
+
+  memset(loadgen, 0, sizeof(*loadgen));
+  loadgen->fd = -1;
+  loadgen->ptySlave = -1;
+
+  if (!config //
+      || !config->mask //
+      || (config->sentencesPerSecond < 0.0) //
+      || (config->bytesPerSecond < 0.0)) {
+    return false;
+  }
+
+  loadgen->config = *config;
+  if (!loadgen->config.burstFixes) {
+    loadgen->config.burstFixes = 1;
+  }
+
+  nmeaInfoClear(&loadgen->info);
+  loadgen->gen = nmeaGeneratorCreate(config->type, &loadgen->info);
+  if (!loadgen->gen) {
+    return false;
+  }
+
+  nmeaRandomSeed(&loadgen->random, config->seed);
+  nmeaGeneratorSetRandom(loadgen->gen, &loadgen->random);
+
+  return true;
+}
+
+void nmeaLoadGenDestroy(NmeaLoadGen *loadgen) {
+  if (!loadgen) {
+    return;
+  }
+
+  if (loadgen->ownFd //
+      && (loadgen->fd != -1)) {
+    close(loadgen->fd);
+  }
+
+  if (loadgen->ptySlave != -1) {
+    close(loadgen->ptySlave);
+  }
+
+  nmeaGeneratorDestroy(loadgen->gen);
+  free(loadgen->buf.buffer);
+
+  memset(loadgen, 0, sizeof(*loadgen));
+  loadgen->fd = -1;
+  loadgen->ptySlave = -1;
+}
+
+bool nmeaLoadGenOpenFd(NmeaLoadGen *loadgen, int fd) {
+  if (!loadgen //
+      || (loadgen->fd != -1) //
+      || (fd < 0)) {
+    return false;
+  }
+
+  return nmeaLoadGenSetFd(loadgen, fd, false);
+}
+
+bool nmeaLoadGenOpenPath(NmeaLoadGen *loadgen, const char *path) {
+  int fd;
+
+  if (!loadgen //
+      || (loadgen->fd != -1) //
+      || !path) {
+    return false;
+  }
+
+  fd = open(path, O_WRONLY | O_NOCTTY | O_CLOEXEC);
+  if (fd == -1) {
+    return false;
+  }
+
+  return nmeaLoadGenSetFd(loadgen, fd, true);
+}
+
+bool nmeaLoadGenOpenUnix(NmeaLoadGen *loadgen, const char *path) {
+  struct sockaddr_un addr;
+  int fd;
+
+  if (!loadgen //
+      || (loadgen->fd != -1) //
+      || !path //
+      || (strlen(path) >= sizeof(addr.sun_path))) {
+    return false;
+  }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd == -1) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
+    close(fd);
+    return false;
+  }
+
+  return nmeaLoadGenSetFd(loadgen, fd, true);
+}
+
+bool nmeaLoadGenOpenPty(NmeaLoadGen *loadgen) {
+  struct termios tio;
+  int master;
+  int slave;
+
+  if (!loadgen //
+      || (loadgen->fd != -1)) {
+    return false;
+  }
+
+  master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master == -1) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  if (grantpt(master) //
+      || unlockpt(master) //
+      || ptsname_r(master, loadgen->ptyName, sizeof(loadgen->ptyName))) {
+    /* can't be covered in a test */
+    close(master);
+    return false;
+  }
+
+  /* keep the slave open so that writes don't fail before the reader opened it */
+  slave = open(loadgen->ptyName, O_RDWR | O_NOCTTY | O_CLOEXEC);
+  if (slave == -1) {
+    /* can't be covered in a test */
+    close(master);
+    return false;
+  }
+
+  if (!tcgetattr(slave, &tio)) {
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+  }
+
+  loadgen->ptySlave = slave;
+
+  return nmeaLoadGenSetFd(loadgen, master, true);
+}
+
+bool nmeaLoadGenRun(NmeaLoadGen *loadgen, double seconds, uint64_t sentences) {
+  const NmeaLoadGenConfig *config;
+  int64_t start;
+  int64_t deadline;
+  int64_t burstDue;
+  int64_t lineFree;
+  uint64_t written = 0;
+  bool r = true;
+
+  if (!loadgen //
+      || (loadgen->fd == -1) //
+      || (seconds < 0.0) //
+      || ((seconds <= 0.0) && !sentences)) {
+    return false;
+  }
+
+  config = &loadgen->config;
+  start = nmeaLoadGenNow();
+  deadline = (seconds > 0.0) ?
+      start + (int64_t) (seconds * (double) NMEALIB_LOADGEN_NS_PER_SECOND) :
+      NMEALIB_LOADGEN_NO_DEADLINE;
+  burstDue = start;
+  lineFree = start;
+
+  while (r //
+      && (!sentences || (written < sentences))) {
+    uint64_t burstSentences = 0;
+    uint64_t burstBytes = 0;
+    double cost = 0.0;
+    size_t fix;
+
+    /* a run with a duration lasts for the duration, also when the rate is low */
+    nmeaLoadGenSleepUntil(MIN(burstDue, deadline));
+    if (nmeaLoadGenNow() >= deadline) {
+      break;
+    }
+
+    for (fix = 0; r && (fix < config->burstFixes); fix++) {
+      size_t length;
+      size_t offset = 0;
+
+      nmeaGeneratorInvoke(loadgen->gen, &loadgen->info);
+      length = nmeaSentenceFromInfo(&loadgen->buf, &loadgen->info, config->mask);
+      loadgen->metrics.fixes++;
+
+      while (r //
+          && (offset < length) //
+          && (!sentences || (written < sentences))) {
+        const char *s = &loadgen->buf.buffer[offset];
+        const char *eol = memchr(s, '\n', length - offset);
+        size_t len = eol ?
+            (size_t) (eol - s) + 1 :
+            length - offset;
+
+        if (config->baud) {
+          nmeaLoadGenSleepUntil(lineFree);
+        }
+
+        if (nmeaLoadGenNow() >= deadline) {
+          break;
+        }
+
+        r = nmeaLoadGenWrite(loadgen, s, len, deadline);
+        if (!r) {
+          /* a passed deadline is not an error */
+          r = nmeaLoadGenNow() >= deadline;
+          break;
+        }
+
+        if (config->baud) {
+          lineFree = MAX(lineFree, nmeaLoadGenNow())
+              + (((int64_t) len * NMEALIB_LOADGEN_BITS_PER_BYTE * NMEALIB_LOADGEN_NS_PER_SECOND) / config->baud);
+        }
+
+        offset += len;
+        written++;
+        burstSentences++;
+        burstBytes += len;
+        loadgen->metrics.sentences++;
+        loadgen->metrics.bytes += len;
+      }
+    }
+
+    loadgen->metrics.bursts++;
+
+    if (config->sentencesPerSecond > 0.0) {
+      cost = MAX(cost, (double) burstSentences / config->sentencesPerSecond);
+    }
+    if (config->bytesPerSecond > 0.0) {
+      cost = MAX(cost, (double) burstBytes / config->bytesPerSecond);
+    }
+    burstDue += (int64_t) (cost * (double) NMEALIB_LOADGEN_NS_PER_SECOND);
+  }
+
+  loadgen->metrics.seconds += (double) (nmeaLoadGenNow() - start) / (double) NMEALIB_LOADGEN_NS_PER_SECOND;
+
+  return r;
+}
+
+void nmeaLoadGenMetrics(const NmeaLoadGen *loadgen, NmeaLoadGenMetrics *metrics) {
+  if (!metrics) {
+    return;
+  }
+
+  memset(metrics, 0, sizeof(*metrics));
+
+  if (!loadgen) {
+    return;
+  }
+
+  *metrics = loadgen->metrics;
+  if (metrics->seconds > 0.0) {
+    metrics->sentencesPerSecond = (double) metrics->sentences / metrics->seconds;
+    metrics->bytesPerSecond = (double) metrics->bytes / metrics->seconds;
+  }
+}
@@ -17,6 +17,7 @@
 
 #include <nmealib/nmath.h>
 
+#include <nmealib/fastmath.h>
 #include <nmealib/util.h>
 #include <math.h>
 
@@ -228,7 +229,19 @@ double nmeaMathDistanceEllipsoid(const NmeaPosition *from, const NmeaPosition *t
 }
 
 bool nmeaMathMoveFlat(const NmeaPosition *from, NmeaPosition *to, double azimuth, double distance) {
+  return nmeaMathMoveFlatMode(from, to, azimuth, distance, NMEALIB_MATH_EXACT);
+}
+
+bool nmeaMathMoveFlatMode(const NmeaPosition *from, NmeaPosition *to, double azimuth, double distance,
+    NmeaMathMode mode) {
   NmeaPosition pos;
+  double sinLat;
+  double cosLat;
+  double sinDistance;
+  double cosDistance;
+  double sinAzimuth;
+  double cosAzimuth;
+  double sinLat2;
 
   if (!from //
       || !to) {
@@ -246,8 +259,25 @@ bool nmeaMathMoveFlat(const NmeaPosition *from, NmeaPosition *to, double azimuth
   distance /= NMEALIB_EARTHRADIUS_KM; /* Angular distance covered on earth's surface */
   azimuth = nmeaMathDegreeToRadian(azimuth);
 
-  to->lat = asin(sin(pos.lat) * cos(distance) + cos(pos.lat) * sin(distance) * cos(azimuth));
-  to->lon = pos.lon + atan2(sin(azimuth) * sin(distance) * cos(pos.lat), cos(distance) - sin(pos.lat) * sin(to->lat));
+  switch (mode) {
+    case NMEALIB_MATH_FAST:
+      nmeaFastSinCos(pos.lat, &sinLat, &cosLat);
+      nmeaFastSinCos(distance, &sinDistance, &cosDistance);
+      nmeaFastSinCos(azimuth, &sinAzimuth, &cosAzimuth);
+      sinLat2 = (sinLat * cosDistance) + (cosLat * sinDistance * cosAzimuth);
+      sinLat2 = MAX(-1.0, MIN(sinLat2, 1.0));
+
+      /* sin(to->lat) is sinLat2 */
+      to->lat = nmeaFastAsin(sinLat2);
+      to->lon = pos.lon + nmeaFastAtan2(sinAzimuth * sinDistance * cosLat, cosDistance - (sinLat * sinLat2));
+      break;
+
+    case NMEALIB_MATH_EXACT:
+    default:
+      to->lat = asin(sin(pos.lat) * cos(distance) + cos(pos.lat) * sin(distance) * cos(azimuth));
+      to->lon = pos.lon + atan2(sin(azimuth) * sin(distance) * cos(pos.lat), cos(distance) - sin(pos.lat) * sin(to->lat));
+      break;
+  }
 
   return true;
 }
@@ -76,6 +76,7 @@ bool nmeaParserInit(NmeaParser *parser, size_t sz) {
   }
 
   parser->bufferSize = !sz ? NMEALIB_PARSER_SENTENCE_SIZE : sz;
+  parser->validation = NMEALIB_VALIDATION_STRICT;
   parser->buffer = malloc(parser->bufferSize);
   if (!parser->buffer) {
     /* can't be covered in a test */
@@ -139,7 +140,8 @@ bool nmeaParserProcessCharacter(NmeaParser *parser, const char *c) {
       } else if (*c == NMEALIB_PARSER_EOL_CHAR_1) {
         parser->sentence.state = NMEALIB_SENTENCE_STATE_READ_EOL;
         parser->sentence.eolCharactersCount = 1;
-      } else if (nmeaValidateIsInvalidCharacter(*c)) {
+      } else if ((parser->validation != NMEALIB_VALIDATION_TRUSTED) //
+          && nmeaValidateIsInvalidCharacter(*c)) {
         nmeaParserReset(parser, NMEALIB_SENTENCE_STATE_SKIP_UNTIL_START);
         return false;
       } else {
@@ -222,7 +224,7 @@ size_t nmeaParserParse(NmeaParser *parser, const char *s, size_t sz, NmeaInfo *i
   for (charIndex = 0; charIndex < sz; charIndex++) {
     bool sentence_read_successfully = nmeaParserProcessCharacter(parser, &s[charIndex]);
     if (sentence_read_successfully) {
-      if (nmeaSentenceToInfo(parser->buffer, parser->bufferLength, info)) {
+      if (nmeaSentenceToInfoPolicy(parser->buffer, parser->bufferLength, info, parser->validation)) {
         sentences_count++;
       }
     }
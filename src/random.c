@@ -0,0 +1,198 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/random.h>
+
+#include <nmealib/util.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#ifndef WIN32
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+#ifdef _MSC_VER
+# define NMEALIB_THREAD_LOCAL __declspec(thread)
+#else
+# define NMEALIB_THREAD_LOCAL __thread
+#endif
+
+/** The number of raw numbers that nmeaRandomFill generates per block */
+#define NMEALIB_RANDOM_FILL_BLOCK (64u)
+
+/** The scale that converts the upper 53 bits of a raw number into [0, 1) */
+#define NMEALIB_RANDOM_DOUBLE_SCALE (1.0 / 9007199254740992.0)
+
+/** The state of the thread */
+static NMEALIB_THREAD_LOCAL NmeaRandom nmeaRandomThread;
+
+/** True when the state of the thread is seeded */
+static NMEALIB_THREAD_LOCAL bool nmeaRandomThreadSeeded;
+
+/**
+ * Rotate left
+ *
+ * @param x The value
+ * @param k The number of bits
+ * @return The rotated value
+ */
+static INLINE uint64_t nmeaRandomRotl(const uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * Get the next number of a splitmix64 sequence
+ *
+ * @param x The state of the sequence
+ * @return The next number
+ */
+static uint64_t nmeaRandomSplitMix(uint64_t *x) {
+  uint64_t z = (*x += 0x9e3779b97f4a7c15ull);
+
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+void nmeaRandomSeed(NmeaRandom *random, uint64_t seed) {
+  size_t i;
+
+  if (!random) {
+    return;
+  }
+
+  for (i = 0; i < 4; i++) {
+    random->s[i] = nmeaRandomSplitMix(&seed);
+  }
+}
+
+void nmeaRandomSeedEntropy(NmeaRandom *random) {
+  uint64_t seed = 0;
+
+  if (!random) {
+    return;
+  }
+
+#ifndef WIN32
+  {
+    int randomFile = open("/dev/urandom", O_RDONLY);
+
+    if (randomFile != -1) {
+      if (read(randomFile, &seed, sizeof(seed)) != sizeof(seed)) {
+        /* can't be covered in a test */
+        seed = 0;
+      }
+      close(randomFile);
+    }
+  }
+#endif
+
+  /* mix in the time and the address of the state, which differs per thread */
+  seed ^= (uint64_t) time(NULL) ^ ((uint64_t) clock() << 32) ^ (uint64_t) (uintptr_t) random;
+
+  nmeaRandomSeed(random, seed);
+}
+
+void nmeaRandomJump(NmeaRandom *random) {
+  static const uint64_t jump[] = {
+      0x180ec6d33cfd0abaull,
+      0xd5a61266f0c9392cull,
+      0xa9582618e03fc9aaull,
+      0x39abdc4529b1661cull };
+  uint64_t s[4] = {
+      0,
+      0,
+      0,
+      0 };
+  size_t i;
+  int b;
+
+  if (!random) {
+    return;
+  }
+
+  for (i = 0; i < (sizeof(jump) / sizeof(jump[0])); i++) {
+    for (b = 0; b < 64; b++) {
+      if (jump[i] & ((uint64_t) 1 << b)) {
+        s[0] ^= random->s[0];
+        s[1] ^= random->s[1];
+        s[2] ^= random->s[2];
+        s[3] ^= random->s[3];
+      }
+      nmeaRandomNext(random);
+    }
+  }
+
+  memcpy(random->s, s, sizeof(s));
+}
+
+uint64_t nmeaRandomNext(NmeaRandom *random) {
+  uint64_t *s = random->s;
+  uint64_t result = nmeaRandomRotl(s[1] * 5, 7) * 9;
+  uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = nmeaRandomRotl(s[3], 45);
+
+  return result;
+}
+
+double nmeaRandomDouble(NmeaRandom *random, const double min, const double max) {
+  return min + ((max - min) * ((double) (nmeaRandomNext(random) >> 11) * NMEALIB_RANDOM_DOUBLE_SCALE));
+}
+
+void nmeaRandomFill(NmeaRandom *random, double *values, size_t count, const double min, const double max) {
+  uint64_t raw[NMEALIB_RANDOM_FILL_BLOCK];
+  double scale = (max - min) * NMEALIB_RANDOM_DOUBLE_SCALE;
+
+  if (!random //
+      || !values) {
+    return;
+  }
+
+  while (count) {
+    size_t block = MIN(count, NMEALIB_RANDOM_FILL_BLOCK);
+    size_t i;
+
+    /* the generator is sequential... */
+    for (i = 0; i < block; i++) {
+      raw[i] = nmeaRandomNext(random) >> 11;
+    }
+
+    /* ...the conversion is not */
+    for (i = 0; i < block; i++) {
+      values[i] = min + ((double) raw[i] * scale);
+    }
+
+    values += block;
+    count -= block;
+  }
+}
+
+NmeaRandom *nmeaRandomThreadState(void) {
+  if (!nmeaRandomThreadSeeded) {
+    nmeaRandomSeedEntropy(&nmeaRandomThread);
+    nmeaRandomThreadSeeded = true;
+  }
+
+  return &nmeaRandomThread;
+}
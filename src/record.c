@@ -0,0 +1,299 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/record.h>
+
+#include <nmealib/nmath.h>
+#include <string.h>
+
+bool nmeaRecordFromInfo(const NmeaInfo *info, NmeaRecord *record) {
+  if (!info //
+      || !record) {
+    return false;
+  }
+
+  memset(record, 0, sizeof(*record));
+
+  if (!nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME)) {
+    return false;
+  }
+
+  record->time = nmeaTimeToEpochNs(&info->utc);
+  record->present = info->present & NMEALIB_RECORD_PRESENT_MASK;
+
+  if (nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_SIG)) {
+    record->sig = (uint8_t) info->sig;
+  }
+
+  if (nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_FIX)) {
+    record->fix = (uint8_t) info->fix;
+  }
+
+  if (nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_PDOP)) {
+    record->pdop = (float) (info->metric ?
+        nmeaMathMetersToDop(info->pdop) :
+        info->pdop);
+  }
+
+  if (nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_HDOP)) {
+    record->hdop = (float) (info->metric ?
+        nmeaMathMetersToDop(info->hdop) :
+        info->hdop);
+  }
+
+  if (nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_VDOP)) {
+    record->vdop = (float) (info->metric ?
+        nmeaMathMetersToDop(info->vdop) :
+        info->vdop);
+  }
+
+  if (nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_LAT)) {
+    record->latitude = info->metric ?
+        info->latitude :
+        nmeaMathNdegToDegree(info->latitude);
+  }
+
+  if (nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_LON)) {
+    record->longitude = info->metric ?
+        info->longitude :
+        nmeaMathNdegToDegree(info->longitude);
+  }
+
+  if (nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_ELV)) {
+    record->elevation = (float) info->elevation;
+  }
+
+  if (nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_SPEED)) {
+    record->speed = (float) info->speed;
+  }
+
+  if (nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_TRACK)) {
+    record->track = (float) info->track;
+  }
+
+  return true;
+}
+
+void nmeaRecordToInfo(const NmeaRecord *record, NmeaInfo *info) {
+  if (!record //
+      || !info) {
+    return;
+  }
+
+  if (nmeaInfoIsPresentAny(record->present, NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME)) {
+    NmeaTime utc;
+
+    nmeaTimeFromEpochNs(record->time, &utc);
+
+    if (nmeaInfoIsPresentAll(record->present, NMEALIB_PRESENT_UTCDATE)) {
+      info->utc.year = utc.year;
+      info->utc.mon = utc.mon;
+      info->utc.day = utc.day;
+      nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_UTCDATE);
+    }
+
+    if (nmeaInfoIsPresentAll(record->present, NMEALIB_PRESENT_UTCTIME)) {
+      info->utc.hour = utc.hour;
+      info->utc.min = utc.min;
+      info->utc.sec = utc.sec;
+      info->utc.hsec = utc.hsec;
+      nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_UTCTIME);
+    }
+  }
+
+  if (nmeaInfoIsPresentAll(record->present, NMEALIB_PRESENT_SIG)) {
+    info->sig = (NmeaSignal) record->sig;
+    nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_SIG);
+  }
+
+  if (nmeaInfoIsPresentAll(record->present, NMEALIB_PRESENT_FIX)) {
+    info->fix = (NmeaFix) record->fix;
+    nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_FIX);
+  }
+
+  if (nmeaInfoIsPresentAll(record->present, NMEALIB_PRESENT_PDOP)) {
+    info->pdop = info->metric ?
+        nmeaMathDopToMeters((double) record->pdop) :
+        (double) record->pdop;
+    nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_PDOP);
+  }
+
+  if (nmeaInfoIsPresentAll(record->present, NMEALIB_PRESENT_HDOP)) {
+    info->hdop = info->metric ?
+        nmeaMathDopToMeters((double) record->hdop) :
+        (double) record->hdop;
+    nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_HDOP);
+  }
+
+  if (nmeaInfoIsPresentAll(record->present, NMEALIB_PRESENT_VDOP)) {
+    info->vdop = info->metric ?
+        nmeaMathDopToMeters((double) record->vdop) :
+        (double) record->vdop;
+    nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_VDOP);
+  }
+
+  if (nmeaInfoIsPresentAll(record->present, NMEALIB_PRESENT_LAT)) {
+    info->latitude = info->metric ?
+        record->latitude :
+        nmeaMathDegreeToNdeg(record->latitude);
+    nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_LAT);
+  }
+
+  if (nmeaInfoIsPresentAll(record->present, NMEALIB_PRESENT_LON)) {
+    info->longitude = info->metric ?
+        record->longitude :
+        nmeaMathDegreeToNdeg(record->longitude);
+    nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_LON);
+  }
+
+  if (nmeaInfoIsPresentAll(record->present, NMEALIB_PRESENT_ELV)) {
+    info->elevation = (double) record->elevation;
+    nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_ELV);
+  }
+
+  if (nmeaInfoIsPresentAll(record->present, NMEALIB_PRESENT_SPEED)) {
+    info->speed = (double) record->speed;
+    nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_SPEED);
+  }
+
+  if (nmeaInfoIsPresentAll(record->present, NMEALIB_PRESENT_TRACK)) {
+    info->track = (double) record->track;
+    nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_TRACK);
+  }
+}
+
+/**
+ * Linearly interpolate between two floats
+ *
+ * @param from The value at weight 0
+ * @param to The value at weight 1
+ * @param weight The weight, in [0, 1]
+ * @return The interpolated value
+ */
+static float nmeaRecordLerp(float from, float to, double weight) {
+  return (float) ((double) from + (((double) to - (double) from) * weight));
+}
+
+/**
+ * Interpolate between two angles (in degrees) along the shortest arc
+ *
+ * @param from The angle at weight 0
+ * @param to The angle at weight 1
+ * @param weight The weight, in [0, 1]
+ * @param range The range of the result: 360.0 results in [0, 360>, 180.0
+ * results in [-180, 180>
+ * @return The interpolated angle
+ */
+static double nmeaRecordLerpAngle(double from, double to, double weight, double range) {
+  double delta = to - from;
+  double r;
+
+  if (delta > 180.0) {
+    delta -= 360.0;
+  } else if (delta < -180.0) {
+    delta += 360.0;
+  }
+
+  r = from + (delta * weight);
+
+  if (range < 360.0) {
+    if (r >= 180.0) {
+      r -= 360.0;
+    } else if (r < -180.0) {
+      r += 360.0;
+    }
+  } else {
+    if (r >= 360.0) {
+      r -= 360.0;
+    } else if (r < 0.0) {
+      r += 360.0;
+    }
+  }
+
+  return r;
+}
+
+bool nmeaRecordInterpolate(const NmeaRecord *from, const NmeaRecord *to, int64_t time, NmeaRecord *record) {
+  const NmeaRecord *nearest;
+  double weight;
+  uint32_t present;
+
+  if (!from //
+      || !to //
+      || !record //
+      || (time < from->time) //
+      || (time > to->time)) {
+    return false;
+  }
+
+  if (time == from->time) {
+    *record = *from;
+    return true;
+  }
+
+  if (time == to->time) {
+    *record = *to;
+    return true;
+  }
+
+  weight = (double) (time - from->time) / (double) (to->time - from->time);
+  nearest = (weight < 0.5) ?
+      from :
+      to;
+  present = from->present & to->present;
+
+  memset(record, 0, sizeof(*record));
+  record->time = time;
+  record->present = present & ~(uint32_t) (NMEALIB_PRESENT_SIG | NMEALIB_PRESENT_FIX);
+  record->present |= nearest->present & (uint32_t) (NMEALIB_PRESENT_SIG | NMEALIB_PRESENT_FIX);
+  record->sig = nearest->sig;
+  record->fix = nearest->fix;
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_LAT)) {
+    record->latitude = from->latitude + ((to->latitude - from->latitude) * weight);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_LON)) {
+    record->longitude = nmeaRecordLerpAngle(from->longitude, to->longitude, weight, 180.0);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_ELV)) {
+    record->elevation = nmeaRecordLerp(from->elevation, to->elevation, weight);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_SPEED)) {
+    record->speed = nmeaRecordLerp(from->speed, to->speed, weight);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_TRACK)) {
+    record->track = (float) nmeaRecordLerpAngle((double) from->track, (double) to->track, weight, 360.0);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_PDOP)) {
+    record->pdop = nmeaRecordLerp(from->pdop, to->pdop, weight);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_HDOP)) {
+    record->hdop = nmeaRecordLerp(from->hdop, to->hdop, weight);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_VDOP)) {
+    record->vdop = nmeaRecordLerp(from->vdop, to->vdop, weight);
+  }
+
+  return true;
+}
@@ -0,0 +1,484 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/render.h>
+
+#include <nmealib/format.h>
+#include <nmealib/util.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The offset and size of a pack member */
+#define NMEALIB_RENDER_MEMBER(type, member) offsetof(type, member), sizeof(((type *) NULL)->member)
+
+/** The size of the time part (hour to hsec) of a NmeaTime structure */
+#define NMEALIB_RENDER_TIME_SIZE (offsetof(NmeaTime, hsec) + sizeof(unsigned int) - offsetof(NmeaTime, hour))
+
+/** The size of the date part (year to day) of a NmeaTime structure */
+#define NMEALIB_RENDER_DATE_SIZE (offsetof(NmeaTime, day) + sizeof(unsigned int) - offsetof(NmeaTime, year))
+
+/**
+ * Description of a field of a sentence that is cached per field: the presence
+ * bits and the (at most 2) pack members from which the field is rendered
+ */
+typedef struct _NmeaRenderFieldInfo {
+  uint32_t present;
+  size_t offset;
+  size_t size;
+  size_t offset2;
+  size_t size2;
+} NmeaRenderFieldInfo;
+
+/** Renders a single field of a pack */
+typedef void (*NmeaRenderFieldGenerator)(NmeaFormatter *out, const void *pack, unsigned int field);
+
+static const NmeaRenderFieldInfo nmeaRenderGPGGAFields[NMEALIB_GPGGA_FIELD_COUNT] = {
+    { NMEALIB_PRESENT_UTCTIME, offsetof(NmeaGPGGA, utc.hour), NMEALIB_RENDER_TIME_SIZE, 0, 0 },
+    { NMEALIB_PRESENT_LAT, NMEALIB_RENDER_MEMBER(NmeaGPGGA, latitude), NMEALIB_RENDER_MEMBER(NmeaGPGGA, latitudeNS) },
+    { NMEALIB_PRESENT_LON, NMEALIB_RENDER_MEMBER(NmeaGPGGA, longitude), NMEALIB_RENDER_MEMBER(NmeaGPGGA, longitudeEW) },
+    { NMEALIB_PRESENT_SIG, NMEALIB_RENDER_MEMBER(NmeaGPGGA, sig), 0, 0 },
+    { NMEALIB_PRESENT_SATINVIEWCOUNT, NMEALIB_RENDER_MEMBER(NmeaGPGGA, inViewCount), 0, 0 },
+    { NMEALIB_PRESENT_HDOP, NMEALIB_RENDER_MEMBER(NmeaGPGGA, hdop), 0, 0 },
+    { NMEALIB_PRESENT_ELV, NMEALIB_RENDER_MEMBER(NmeaGPGGA, elevation), NMEALIB_RENDER_MEMBER(NmeaGPGGA, elevationM) },
+    { NMEALIB_PRESENT_HEIGHT, NMEALIB_RENDER_MEMBER(NmeaGPGGA, height), NMEALIB_RENDER_MEMBER(NmeaGPGGA, heightM) },
+    { NMEALIB_PRESENT_DGPSAGE, NMEALIB_RENDER_MEMBER(NmeaGPGGA, dgpsAge), 0, 0 },
+    { NMEALIB_PRESENT_DGPSSID, NMEALIB_RENDER_MEMBER(NmeaGPGGA, dgpsSid), 0, 0 } };
+
+static const NmeaRenderFieldInfo nmeaRenderGPRMCFields[NMEALIB_GPRMC_FIELD_COUNT] = {
+    { NMEALIB_PRESENT_UTCTIME, offsetof(NmeaGPRMC, utc.hour), NMEALIB_RENDER_TIME_SIZE, 0, 0 },
+    { NMEALIB_PRESENT_SIG, NMEALIB_RENDER_MEMBER(NmeaGPRMC, sigSelection), 0, 0 },
+    { NMEALIB_PRESENT_LAT, NMEALIB_RENDER_MEMBER(NmeaGPRMC, latitude), NMEALIB_RENDER_MEMBER(NmeaGPRMC, latitudeNS) },
+    { NMEALIB_PRESENT_LON, NMEALIB_RENDER_MEMBER(NmeaGPRMC, longitude), NMEALIB_RENDER_MEMBER(NmeaGPRMC, longitudeEW) },
+    { NMEALIB_PRESENT_SPEED, NMEALIB_RENDER_MEMBER(NmeaGPRMC, speed), 0, 0 },
+    { NMEALIB_PRESENT_TRACK, NMEALIB_RENDER_MEMBER(NmeaGPRMC, track), 0, 0 },
+    { NMEALIB_PRESENT_UTCDATE, offsetof(NmeaGPRMC, utc.year), NMEALIB_RENDER_DATE_SIZE, 0, 0 },
+    { NMEALIB_PRESENT_MAGVAR, NMEALIB_RENDER_MEMBER(NmeaGPRMC, magvar), NMEALIB_RENDER_MEMBER(NmeaGPRMC, magvarEW) },
+    { NMEALIB_PRESENT_SIG, NMEALIB_RENDER_MEMBER(NmeaGPRMC, sig), NMEALIB_RENDER_MEMBER(NmeaGPRMC, v23) } };
+
+static void nmeaRenderGPGGAField(NmeaFormatter *out, const void *pack, unsigned int field) {
+  nmeaGPGGAGenerateField(out, pack, (NmeaGPGGAField) field);
+}
+
+static void nmeaRenderGPRMCField(NmeaFormatter *out, const void *pack, unsigned int field) {
+  nmeaGPRMCGenerateField(out, pack, (NmeaGPRMCField) field);
+}
+
+/*
+ * Output
+ */
+
+/**
+ * Round a size up to a multiple of the buffer chunk size
+ *
+ * @param sz The size
+ * @return The rounded size
+ */
+static INLINE size_t nmeaRenderChunkSize(size_t sz) {
+  return (sz + NMEALIB_BUFFER_CHUNK_SIZE - 1) & ~(NMEALIB_BUFFER_CHUNK_SIZE - 1);
+}
+
+/**
+ * Make sure that a buffer is at least of a size
+ *
+ * @param buf The buffer
+ * @param sz The size
+ * @return True on success
+ */
+static bool nmeaRenderReserve(NmeaMallocedBuffer *buf, size_t sz) {
+  size_t newSize;
+  char *s;
+
+  if (buf->bufferSize >= sz) {
+    return true;
+  }
+
+  newSize = nmeaRenderChunkSize(sz);
+  s = realloc(buf->buffer, newSize);
+  if (!s) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  buf->buffer = s;
+  buf->bufferSize = newSize;
+
+  return true;
+}
+
+/**
+ * Append text to the output
+ *
+ * @param buf The output buffer
+ * @param chars The length of the output, updated
+ * @param text The text
+ * @param len The length of the text
+ * @return True on success
+ */
+static bool nmeaRenderAppend(NmeaMallocedBuffer *buf, size_t *chars, const char *text, size_t len) {
+  if (!nmeaRenderReserve(buf, *chars + len + 1)) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  memcpy(&buf->buffer[*chars], text, len);
+  *chars += len;
+  buf->buffer[*chars] = '\0';
+
+  return true;
+}
+
+/**
+ * Generate a sentence that can't be cached directly into the output
+ *
+ * @param buf The output buffer
+ * @param chars The length of the output, updated
+ * @param info The NmeaInfo structure
+ * @param sentence The sentence type
+ * @param index The index of the sentence within its type
+ * @return True on success
+ */
+static bool nmeaRenderUncached(NmeaMallocedBuffer *buf, size_t *chars, const NmeaInfo *info, NmeaSentence sentence,
+    size_t index) {
+  size_t len = nmeaSentenceGenerate(&buf->buffer[*chars], buf->bufferSize - *chars, info, sentence, index);
+
+  if (len >= (buf->bufferSize - *chars)) {
+    if (!nmeaRenderReserve(buf, *chars + len + 1)) {
+      /* can't be covered in a test */
+      return false;
+    }
+
+    len = nmeaSentenceGenerate(&buf->buffer[*chars], buf->bufferSize - *chars, info, sentence, index);
+  }
+
+  *chars += len;
+
+  return true;
+}
+
+/*
+ * Caches
+ */
+
+/**
+ * Determine whether a field changed between two packs
+ *
+ * @param fieldInfo The field description
+ * @param oldPresent The presence bits of the old pack
+ * @param oldPack The old pack
+ * @param newPresent The presence bits of the new pack
+ * @param newPack The new pack
+ * @return True when the field changed
+ */
+static bool nmeaRenderFieldChanged(const NmeaRenderFieldInfo *fieldInfo, uint32_t oldPresent, const void *oldPack,
+    uint32_t newPresent, const void *newPack) {
+  const char *o = oldPack;
+  const char *n = newPack;
+
+  return ((oldPresent ^ newPresent) & fieldInfo->present) //
+      || memcmp(&o[fieldInfo->offset], &n[fieldInfo->offset], fieldInfo->size) //
+      || (fieldInfo->size2 && memcmp(&o[fieldInfo->offset2], &n[fieldInfo->offset2], fieldInfo->size2));
+}
+
+/**
+ * Render a field into its cache
+ *
+ * @param field The field cache
+ * @param generator The field generator
+ * @param pack The pack
+ * @param index The index of the field
+ * @return True when the field fits in its cache
+ */
+static bool nmeaRenderField(NmeaRenderField *field, NmeaRenderFieldGenerator generator, const void *pack,
+    unsigned int index) {
+  NmeaFormatter out;
+
+  nmeaFormatterInit(&out, field->text, sizeof(field->text));
+  generator(&out, pack, index);
+
+  if (out.length >= sizeof(field->text)) {
+    return false;
+  }
+
+  field->length = out.length;
+
+  /* the formatter cancels out the start-of-line character, which isn't there */
+  field->checksum = (unsigned char) (out.checksum ^ '$');
+
+  return true;
+}
+
+/**
+ * Assemble a sentence from its prefix and its cached fields
+ *
+ * @param cache The sentence cache
+ * @param prefix The prefix, including the start-of-line character
+ * @param count The number of fields
+ * @return True when the sentence fits in its cache
+ */
+static bool nmeaRenderAssemble(NmeaRenderSentence *cache, const char *prefix, size_t count) {
+  size_t length = strlen(prefix);
+  unsigned char checksum = 0;
+  size_t i;
+
+  for (i = 1; i < length; i++) {
+    checksum ^= (unsigned char) prefix[i];
+  }
+
+  for (i = 0; i < count; i++) {
+    length += cache->fields[i].length;
+  }
+
+  if ((length + NMEALIB_CHECKSUM_LENGTH) >= sizeof(cache->text)) {
+    return false;
+  }
+
+  length = strlen(prefix);
+  memcpy(cache->text, prefix, length);
+
+  for (i = 0; i < count; i++) {
+    NmeaRenderField *field = &cache->fields[i];
+
+    field->offset = length;
+    memcpy(&cache->text[length], field->text, field->length);
+    length += field->length;
+    checksum ^= field->checksum;
+  }
+
+  cache->checksum = checksum;
+  cache->length = length + NMEALIB_CHECKSUM_LENGTH;
+
+  return true;
+}
+
+/**
+ * Update a sentence that is cached per field
+ *
+ * @param render The render cache
+ * @param cache The sentence cache
+ * @param prefix The prefix, including the start-of-line character
+ * @param fieldInfos The descriptions of the fields
+ * @param count The number of fields
+ * @param generator The field generator
+ * @param oldPresent The presence bits of the cached pack
+ * @param oldPack The cached pack
+ * @param newPresent The presence bits of the new pack
+ * @param newPack The new pack
+ * @return True when the cached sentence is valid
+ */
+static bool nmeaRenderFields(NmeaRender *render, NmeaRenderSentence *cache, const char *prefix,
+    const NmeaRenderFieldInfo *fieldInfos, size_t count, NmeaRenderFieldGenerator generator, uint32_t oldPresent,
+    const void *oldPack, uint32_t newPresent, const void *newPack) {
+  bool rebuild = !cache->valid;
+  bool changed = false;
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    NmeaRenderField field;
+
+    if (cache->valid //
+        && !nmeaRenderFieldChanged(&fieldInfos[i], oldPresent, oldPack, newPresent, newPack)) {
+      continue;
+    }
+
+    if (!nmeaRenderField(&field, generator, newPack, (unsigned int) i)) {
+      cache->valid = false;
+      return false;
+    }
+
+    render->fieldsRendered++;
+    changed = true;
+
+    if (!rebuild) {
+      NmeaRenderField *cached = &cache->fields[i];
+
+      if (field.length == cached->length) {
+        /* patch the sentence and its checksum in place */
+        memcpy(&cache->text[cached->offset], field.text, field.length);
+        cache->checksum ^= (unsigned char) (cached->checksum ^ field.checksum);
+        field.offset = cached->offset;
+      } else {
+        rebuild = true;
+      }
+    }
+
+    cache->fields[i] = field;
+  }
+
+  if (!changed) {
+    render->sentencesReused++;
+    return true;
+  }
+
+  render->sentencesRendered++;
+
+  if (rebuild //
+      && !nmeaRenderAssemble(cache, prefix, count)) {
+    cache->valid = false;
+    return false;
+  }
+
+  nmeaFormatChecksum(&cache->text[cache->length - NMEALIB_CHECKSUM_LENGTH], cache->checksum);
+  cache->valid = true;
+
+  return true;
+}
+
+/**
+ * Update a sentence that is cached as a whole
+ *
+ * @param render The render cache
+ * @param cache The sentence cache
+ * @param cachedPack The cached pack, updated
+ * @param pack The new pack
+ * @param packSize The size of the packs
+ * @param info The NmeaInfo structure
+ * @param sentence The sentence type
+ * @param index The index of the sentence within its type
+ * @return True when the cached sentence is valid
+ */
+static bool nmeaRenderSentence(NmeaRender *render, NmeaRenderSentence *cache, void *cachedPack, const void *pack,
+    size_t packSize, const NmeaInfo *info, NmeaSentence sentence, size_t index) {
+  if (cache->valid //
+      && !memcmp(cachedPack, pack, packSize)) {
+    render->sentencesReused++;
+    return true;
+  }
+
+  render->sentencesRendered++;
+  memcpy(cachedPack, pack, packSize);
+
+  cache->length = nmeaSentenceGenerate(cache->text, sizeof(cache->text), info, sentence, index);
+  cache->valid = cache->length < sizeof(cache->text);
+
+  return cache->valid;
+}
+
+/*
+ * Public
+ */
+
+void nmeaRenderInit(NmeaRender *render) {
+  if (!render) {
+    return;
+  }
+
+  memset(render, 0, sizeof(*render));
+}
+
+size_t nmeaRenderFromInfo(NmeaRender *render, NmeaMallocedBuffer *buf, const NmeaInfo *info, const NmeaSentence mask) {
+  NmeaSentence sentence;
+  size_t chars = 0;
+
+  if (!render //
+      || !buf //
+      || (!buf->buffer && buf->bufferSize) //
+      || (buf->buffer && !buf->bufferSize) //
+      || !info //
+      || !mask) {
+    return 0;
+  }
+
+  if (!nmeaRenderReserve(buf, nmeaSentenceFromInfoSize(info, mask))) {
+    /* can't be covered in a test */
+    return 0;
+  }
+
+  *buf->buffer = '\0';
+
+  for (sentence = NMEALIB_SENTENCE_GPGGA; sentence <= NMEALIB_SENTENCE_LAST; sentence = (NmeaSentence) (sentence << 1)) {
+    size_t count;
+    size_t index;
+
+    if (!(mask & sentence)) {
+      continue;
+    }
+
+    count = nmeaSentenceCount(info, sentence);
+    for (index = 0; index < count; index++) {
+      NmeaRenderSentence *cache = NULL;
+      bool cached = false;
+
+      switch (sentence) {
+        case NMEALIB_SENTENCE_GPGGA: {
+          NmeaGPGGA pack;
+          nmeaGPGGAFromInfo(info, &pack);
+          cache = &render->gpggaText;
+          cached = nmeaRenderFields(render, cache, "$" NMEALIB_GPGGA_PREFIX, nmeaRenderGPGGAFields,
+              NMEALIB_GPGGA_FIELD_COUNT, nmeaRenderGPGGAField, render->gpgga.present, &render->gpgga, pack.present,
+              &pack);
+          render->gpgga = pack;
+          break;
+        }
+
+        case NMEALIB_SENTENCE_GPGSA: {
+          NmeaGPGSA pack;
+          nmeaGPGSAFromInfo(info, &pack);
+          cache = &render->gpgsaText;
+          cached = nmeaRenderSentence(render, cache, &render->gpgsa, &pack, sizeof(pack), info, sentence, index);
+          break;
+        }
+
+        case NMEALIB_SENTENCE_GPGSV: {
+          NmeaGPGSV pack;
+          nmeaGPGSVFromInfo(info, &pack, index);
+          cache = &render->gpgsvText[index];
+          cached = nmeaRenderSentence(render, cache, &render->gpgsv[index], &pack, sizeof(pack), info, sentence,
+              index);
+          break;
+        }
+
+        case NMEALIB_SENTENCE_GPRMC: {
+          NmeaGPRMC pack;
+          nmeaGPRMCFromInfo(info, &pack);
+          cache = &render->gprmcText;
+          cached = nmeaRenderFields(render, cache, "$" NMEALIB_GPRMC_PREFIX, nmeaRenderGPRMCFields,
+              NMEALIB_GPRMC_FIELD_COUNT, nmeaRenderGPRMCField, render->gprmc.present, &render->gprmc, pack.present,
+              &pack);
+          render->gprmc = pack;
+          break;
+        }
+
+        case NMEALIB_SENTENCE_GPVTG: {
+          NmeaGPVTG pack;
+          nmeaGPVTGFromInfo(info, &pack);
+          cache = &render->gpvtgText;
+          cached = nmeaRenderSentence(render, cache, &render->gpvtg, &pack, sizeof(pack), info, sentence, index);
+          break;
+        }
+
+        case NMEALIB_SENTENCE_GPNON:
+        default:
+          break;
+      }
+
+      if (cached) {
+        if (!nmeaRenderAppend(buf, &chars, cache->text, cache->length)) {
+          /* can't be covered in a test */
+          return 0;
+        }
+      } else if (cache) {
+        if (!nmeaRenderUncached(buf, &chars, info, sentence, index)) {
+          /* can't be covered in a test */
+          return 0;
+        }
+      }
+    }
+  }
+
+  return chars;
+}
@@ -0,0 +1,411 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/replay.h>
+
+#include <nmealib/info.h>
+#include <nmealib/sentence.h>
+#include <nmealib/util.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** The number of nanoseconds in a second */
+#define NMEALIB_REPLAY_NS_PER_SECOND (1000000000ll)
+
+/** The number of nanoseconds in a day */
+#define NMEALIB_REPLAY_NS_PER_DAY (86400ll * NMEALIB_REPLAY_NS_PER_SECOND)
+
+/*
+ * Helpers
+ */
+
+/**
+ * @return The monotonic time in ns
+ */
+static int64_t nmeaReplayNow(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((int64_t) ts.tv_sec * NMEALIB_REPLAY_NS_PER_SECOND) + (int64_t) ts.tv_nsec;
+}
+
+/**
+ * Wait until a monotonic time: sleep until just before it, then spin
+ *
+ * @param until The monotonic time in ns
+ * @return The monotonic time in ns after waiting
+ */
+static int64_t nmeaReplayWaitUntil(int64_t until) {
+  int64_t now = nmeaReplayNow();
+
+  if ((until - now) > NMEALIB_REPLAY_SPIN_NS) {
+    struct timespec ts;
+    int64_t wake = until - NMEALIB_REPLAY_SPIN_NS;
+
+    ts.tv_sec = (time_t) (wake / NMEALIB_REPLAY_NS_PER_SECOND);
+    ts.tv_nsec = (long) (wake % NMEALIB_REPLAY_NS_PER_SECOND);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+    now = nmeaReplayNow();
+  }
+
+  while (now < until) {
+    now = nmeaReplayNow();
+  }
+
+  return now;
+}
+
+/**
+ * Get the UTC time of day of a sentence that carries one
+ *
+ * @param s The sentence
+ * @param sz The length of the sentence
+ * @param time The location in which to store the time of day in ns
+ * @return True when the sentence carries a valid time
+ */
+static bool nmeaReplaySentenceTime(const char *s, size_t sz, int64_t *time) {
+  NmeaSentence sentence = nmeaSentenceFromPrefix(s, sz);
+  char field[16];
+  NmeaTime utc;
+  const char *start;
+  const char *end;
+  size_t len;
+
+  if ((sentence != NMEALIB_SENTENCE_GPGGA) //
+      && (sentence != NMEALIB_SENTENCE_GPRMC)) {
+    return false;
+  }
+
+  /* the time is the first field of both sentences */
+  start = memchr(s, ',', sz);
+  if (!start) {
+    return false;
+  }
+  start++;
+
+  end = memchr(start, ',', sz - (size_t) (start - s));
+  if (!end) {
+    return false;
+  }
+
+  len = (size_t) (end - start);
+  if (!len //
+      || (len >= sizeof(field))) {
+    return false;
+  }
+
+  memcpy(field, start, len);
+  field[len] = '\0';
+
+  memset(&utc, 0, sizeof(utc));
+  if (!nmeaTimeParseTime(field, &utc)) {
+    return false;
+  }
+
+  *time = ((((((int64_t) utc.hour * 60) + utc.min) * 60) + utc.sec) * NMEALIB_REPLAY_NS_PER_SECOND)
+      + ((int64_t) utc.hsec * (NMEALIB_REPLAY_NS_PER_SECOND / 100));
+
+  return true;
+}
+
+/**
+ * Index the sentences of the log of a replay
+ *
+ * @param replay The replay
+ * @return True when the log holds sentences
+ */
+static bool nmeaReplayIndex(NmeaReplay *replay) {
+  const char *log = replay->log;
+  size_t capacity = 0;
+  size_t offset = 0;
+  size_t fixes = 0;
+  int64_t first = 0;
+  int64_t previous = 0;
+  int64_t days = 0;
+  int64_t time = 0;
+
+  while (offset < replay->logSize) {
+    const char *eol = memchr(&log[offset], '\n', replay->logSize - offset);
+    size_t length = eol ?
+        (size_t) (eol - &log[offset]) + 1 :
+        replay->logSize - offset;
+    int64_t utc;
+
+    if (log[offset] != '$') {
+      offset += length;
+      continue;
+    }
+
+    if (nmeaReplaySentenceTime(&log[offset], length, &utc)) {
+      if (!fixes) {
+        first = utc;
+        previous = utc;
+      } else if ((previous - utc) > (NMEALIB_REPLAY_NS_PER_DAY / 2)) {
+        /* wrapped past midnight */
+        days++;
+      }
+
+      if (!fixes || (utc != previous)) {
+        fixes++;
+      }
+
+      previous = utc;
+      time = (utc + (days * NMEALIB_REPLAY_NS_PER_DAY)) - first;
+    }
+
+    if (replay->count >= capacity) {
+      NmeaReplaySentence *sentences;
+
+      capacity = capacity ?
+          (capacity * 2) :
+          256;
+      sentences = realloc(replay->sentences, capacity * sizeof(sentences[0]));
+      if (!sentences) {
+        /* can't be covered in a test */
+        return false;
+      }
+      replay->sentences = sentences;
+    }
+
+    replay->sentences[replay->count].offset = offset;
+    replay->sentences[replay->count].length = length;
+    replay->sentences[replay->count].time = time;
+    replay->count++;
+
+    offset += length;
+  }
+
+  if (!replay->count) {
+    return false;
+  }
+
+  /* the next loop starts one average fix interval after the last fix */
+  replay->period = (fixes > 1) ?
+      time + (time / (int64_t) (fixes - 1)) :
+      NMEALIB_REPLAY_NS_PER_SECOND;
+
+  return true;
+}
+
+/*
+ * Public
+ */
+
+bool nmeaReplayInit(NmeaReplay *replay, const char *log, size_t size) {
+  if (!replay) {
+    return false;
+  }
+
+  memset(replay, 0, sizeof(*replay));
+
+  if (!log //
+      || !size) {
+    return false;
+  }
+
+  replay->log = malloc(size);
+  if (!replay->log) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  memcpy(replay->log, log, size);
+  replay->logSize = size;
+
+  if (!nmeaReplayIndex(replay)) {
+    nmeaReplayDestroy(replay);
+    return false;
+  }
+
+  nmeaReplayStart(replay, 1.0, false);
+
+  return true;
+}
+
+bool nmeaReplayOpen(NmeaReplay *replay, const char *path) {
+  FILE *file;
+  char *log;
+  long size;
+  bool r;
+
+  if (!replay) {
+    return false;
+  }
+
+  memset(replay, 0, sizeof(*replay));
+
+  if (!path) {
+    return false;
+  }
+
+  file = fopen(path, "rb");
+  if (!file) {
+    return false;
+  }
+
+  if (fseek(file, 0, SEEK_END) //
+      || ((size = ftell(file)) <= 0) //
+      || fseek(file, 0, SEEK_SET)) {
+    fclose(file);
+    return false;
+  }
+
+  log = malloc((size_t) size);
+  if (!log) {
+    /* can't be covered in a test */
+    fclose(file);
+    return false;
+  }
+
+  r = fread(log, 1, (size_t) size, file) == (size_t) size;
+  fclose(file);
+
+  r = r && nmeaReplayInit(replay, log, (size_t) size);
+  free(log);
+
+  return r;
+}
+
+void nmeaReplayDestroy(NmeaReplay *replay) {
+  if (!replay) {
+    return;
+  }
+
+  free(replay->log);
+  free(replay->sentences);
+  memset(replay, 0, sizeof(*replay));
+}
+
+void nmeaReplayStart(NmeaReplay *replay, double speed, bool loop) {
+  if (!replay) {
+    return;
+  }
+
+  replay->speed = (speed > 0.0) ?
+      speed :
+      0.0;
+  replay->loop = loop;
+  replay->index = 0;
+  replay->loopTime = 0;
+  replay->start = nmeaReplayNow();
+  replay->last = replay->start;
+  replay->lastDue = replay->start;
+  replay->maxLate = 0;
+  replay->streamed = 0;
+  replay->bytes = 0;
+  replay->loops = 0;
+}
+
+size_t nmeaReplayNext(NmeaReplay *replay, const char **s) {
+  const NmeaReplaySentence *sentence;
+  int64_t now;
+
+  if (!replay //
+      || !replay->count //
+      || !s) {
+    return 0;
+  }
+
+  if (replay->index >= replay->count) {
+    if (!replay->loop) {
+      return 0;
+    }
+
+    replay->index = 0;
+    replay->loopTime += replay->period;
+    replay->loops++;
+  }
+
+  sentence = &replay->sentences[replay->index];
+
+  if (replay->speed > 0.0) {
+    int64_t due = replay->start + (int64_t) ((double) (replay->loopTime + sentence->time) / replay->speed);
+
+    now = nmeaReplayWaitUntil(due);
+    replay->maxLate = MAX(replay->maxLate, now - due);
+    replay->lastDue = due;
+  } else {
+    now = nmeaReplayNow();
+    replay->lastDue = now;
+  }
+
+  replay->last = now;
+  replay->index++;
+  replay->streamed++;
+  replay->bytes += sentence->length;
+
+  *s = &replay->log[sentence->offset];
+  return sentence->length;
+}
+
+size_t nmeaReplayRun(NmeaReplay *replay, NmeaReplayOutput output, void *userData, size_t max) {
+  size_t streamed = 0;
+
+  if (!replay //
+      || !output) {
+    return 0;
+  }
+
+  while (!max || (streamed < max)) {
+    const char *s;
+    size_t len = nmeaReplayNext(replay, &s);
+
+    if (!len) {
+      break;
+    }
+
+    streamed++;
+
+    if (!output(userData, s, len)) {
+      break;
+    }
+  }
+
+  return streamed;
+}
+
+void nmeaReplayMetrics(const NmeaReplay *replay, NmeaReplayMetrics *metrics) {
+  double scheduled;
+
+  if (!metrics) {
+    return;
+  }
+
+  memset(metrics, 0, sizeof(*metrics));
+
+  if (!replay) {
+    return;
+  }
+
+  metrics->sentences = replay->streamed;
+  metrics->bytes = replay->bytes;
+  metrics->loops = replay->loops;
+  metrics->seconds = (double) (replay->last - replay->start) / (double) NMEALIB_REPLAY_NS_PER_SECOND;
+  metrics->maxLateSeconds = (double) replay->maxLate / (double) NMEALIB_REPLAY_NS_PER_SECOND;
+
+  if (metrics->seconds > 0.0) {
+    metrics->sentencesPerSecond = (double) replay->streamed / metrics->seconds;
+  }
+
+  scheduled = (double) (replay->lastDue - replay->start) / (double) NMEALIB_REPLAY_NS_PER_SECOND;
+  if ((replay->speed > 0.0) //
+      && (scheduled > 0.0)) {
+    metrics->targetSentencesPerSecond = (double) replay->streamed / scheduled;
+  }
+}
@@ -0,0 +1,202 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/scatter.h>
+
+#include <nmealib/util.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Round a size up to a multiple of the buffer chunk size
+ *
+ * @param sz The size
+ * @return The rounded size
+ */
+static INLINE size_t nmeaScatterChunkSize(size_t sz) {
+  return (sz + NMEALIB_BUFFER_CHUNK_SIZE - 1) & ~(NMEALIB_BUFFER_CHUNK_SIZE - 1);
+}
+
+/**
+ * Make sure that the arena of a scatter is at least of a size
+ *
+ * @param scatter The scatter
+ * @param sz The size
+ * @return True on success
+ */
+static bool nmeaScatterReserveArena(NmeaScatter *scatter, size_t sz) {
+  size_t newSize;
+  char *arena;
+
+  if (scatter->arenaSize >= sz) {
+    return true;
+  }
+
+  newSize = nmeaScatterChunkSize(sz);
+  arena = realloc(scatter->arena, newSize);
+  if (!arena) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  scatter->arena = arena;
+  scatter->arenaSize = newSize;
+
+  return true;
+}
+
+/**
+ * Make sure that a scatter can hold a number of sentences
+ *
+ * @param scatter The scatter
+ * @param count The number of sentences
+ * @return True on success
+ */
+static bool nmeaScatterReserveSentences(NmeaScatter *scatter, size_t count) {
+  struct iovec *iov;
+  NmeaSentence *sentences;
+
+  if (scatter->capacity >= count) {
+    return true;
+  }
+
+  iov = realloc(scatter->iov, count * sizeof(scatter->iov[0]));
+  if (!iov) {
+    /* can't be covered in a test */
+    return false;
+  }
+  scatter->iov = iov;
+
+  sentences = realloc(scatter->sentences, count * sizeof(scatter->sentences[0]));
+  if (!sentences) {
+    /* can't be covered in a test */
+    return false;
+  }
+  scatter->sentences = sentences;
+
+  scatter->capacity = count;
+
+  return true;
+}
+
+void nmeaScatterInit(NmeaScatter *scatter) {
+  if (!scatter) {
+    return;
+  }
+
+  memset(scatter, 0, sizeof(*scatter));
+}
+
+void nmeaScatterDestroy(NmeaScatter *scatter) {
+  if (!scatter) {
+    return;
+  }
+
+  free(scatter->arena);
+  free(scatter->iov);
+  free(scatter->sentences);
+  memset(scatter, 0, sizeof(*scatter));
+}
+
+size_t nmeaScatterFromInfo(NmeaScatter *scatter, const NmeaInfo *info, const NmeaSentence mask) {
+  NmeaSentence sentence;
+  size_t count = 0;
+  size_t length = 0;
+  size_t i;
+
+  if (!scatter //
+      || !info) {
+    return 0;
+  }
+
+  scatter->count = 0;
+  scatter->length = 0;
+
+  for (sentence = NMEALIB_SENTENCE_GPGGA; sentence <= NMEALIB_SENTENCE_LAST; sentence = (NmeaSentence) (sentence << 1)) {
+    if (mask & sentence) {
+      count += nmeaSentenceCount(info, sentence);
+    }
+  }
+
+  if (!count //
+      || !nmeaScatterReserveSentences(scatter, count) //
+      || !nmeaScatterReserveArena(scatter, nmeaSentenceFromInfoSize(info, mask))) {
+    return 0;
+  }
+
+  count = 0;
+
+  for (sentence = NMEALIB_SENTENCE_GPGGA; sentence <= NMEALIB_SENTENCE_LAST; sentence = (NmeaSentence) (sentence << 1)) {
+    size_t sentences;
+    size_t index;
+
+    if (!(mask & sentence)) {
+      continue;
+    }
+
+    sentences = nmeaSentenceCount(info, sentence);
+    for (index = 0; index < sentences; index++) {
+      size_t len = nmeaSentenceGenerate(&scatter->arena[length], scatter->arenaSize - length, info, sentence, index);
+
+      if (len >= (scatter->arenaSize - length)) {
+        /* the sentence exceeds the maximum length, grow the arena and generate it once more */
+        if (!nmeaScatterReserveArena(scatter, scatter->arenaSize + len + 1)) {
+          /* can't be covered in a test */
+          return 0;
+        }
+
+        len = nmeaSentenceGenerate(&scatter->arena[length], scatter->arenaSize - length, info, sentence, index);
+      }
+
+      scatter->iov[count].iov_len = len;
+      scatter->sentences[count] = sentence;
+
+      length += len;
+      count++;
+    }
+  }
+
+  /* the arena could have moved while generating, so only now point into it */
+  length = 0;
+  for (i = 0; i < count; i++) {
+    scatter->iov[i].iov_base = &scatter->arena[length];
+    length += scatter->iov[i].iov_len;
+  }
+
+  scatter->count = count;
+  scatter->length = length;
+
+  return count;
+}
+
+size_t nmeaScatterSelect(const NmeaScatter *scatter, const NmeaSentence mask, struct iovec *iov, size_t iovcnt) {
+  size_t selected = 0;
+  size_t i;
+
+  if (!scatter //
+      || !iov) {
+    return 0;
+  }
+
+  for (i = 0; (i < scatter->count) && (selected < iovcnt); i++) {
+    if (mask & scatter->sentences[i]) {
+      iov[selected++] = scatter->iov[i];
+    }
+  }
+
+  return selected;
+}
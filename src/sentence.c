@@ -51,10 +51,14 @@ NmeaSentence nmeaSentenceFromPrefix(const char *s, const size_t sz) {
 }
 
 bool nmeaSentenceToInfo(const char *s, const size_t sz, NmeaInfo *info) {
+  return nmeaSentenceToInfoPolicy(s, sz, info, NMEALIB_VALIDATION_STRICT);
+}
+
+bool nmeaSentenceToInfoPolicy(const char *s, const size_t sz, NmeaInfo *info, NmeaValidationPolicy policy) {
   switch (nmeaSentenceFromPrefix(s, sz)) {
     case NMEALIB_SENTENCE_GPGGA: {
       NmeaGPGGA gpgga;
-      if (nmeaGPGGAParse(s, sz, &gpgga)) {
+      if (nmeaGPGGAParsePolicy(s, sz, &gpgga, policy)) {
         nmeaGPGGAToInfo(&gpgga, info);
         return true;
       }
@@ -64,7 +68,7 @@ bool nmeaSentenceToInfo(const char *s, const size_t sz, NmeaInfo *info) {
 
     case NMEALIB_SENTENCE_GPGSA: {
       NmeaGPGSA gpgsa;
-      if (nmeaGPGSAParse(s, sz, &gpgsa)) {
+      if (nmeaGPGSAParsePolicy(s, sz, &gpgsa, policy)) {
         nmeaGPGSAToInfo(&gpgsa, info);
         return true;
       }
@@ -74,7 +78,7 @@ bool nmeaSentenceToInfo(const char *s, const size_t sz, NmeaInfo *info) {
 
     case NMEALIB_SENTENCE_GPGSV: {
       NmeaGPGSV gpgsv;
-      if (nmeaGPGSVParse(s, sz, &gpgsv)) {
+      if (nmeaGPGSVParsePolicy(s, sz, &gpgsv, policy)) {
         nmeaGPGSVToInfo(&gpgsv, info);
         return true;
       }
@@ -84,7 +88,7 @@ bool nmeaSentenceToInfo(const char *s, const size_t sz, NmeaInfo *info) {
 
     case NMEALIB_SENTENCE_GPRMC: {
       NmeaGPRMC gprmc;
-      if (nmeaGPRMCParse(s, sz, &gprmc)) {
+      if (nmeaGPRMCParsePolicy(s, sz, &gprmc, policy)) {
         nmeaGPRMCToInfo(&gprmc, info);
         return true;
       }
@@ -94,7 +98,7 @@ bool nmeaSentenceToInfo(const char *s, const size_t sz, NmeaInfo *info) {
 
     case NMEALIB_SENTENCE_GPVTG: {
       NmeaGPVTG gpvtg;
-      if (nmeaGPVTGParse(s, sz, &gpvtg)) {
+      if (nmeaGPVTGParsePolicy(s, sz, &gpvtg, policy)) {
         nmeaGPVTGToInfo(&gpvtg, info);
         return true;
       }
@@ -108,103 +112,212 @@ bool nmeaSentenceToInfo(const char *s, const size_t sz, NmeaInfo *info) {
   }
 }
 
-size_t nmeaSentenceFromInfo(NmeaMallocedBuffer *buf, const NmeaInfo *info, const NmeaSentence mask) {
-
-#define dst       (&s[chars])
-#define available ((sz <= (size_t) chars) ? 0 : (sz - (size_t) chars))
-
-#define generateSentence(expression) { \
-  size_t addedChars = expression; \
-  while (addedChars >= available) { \
-    sz += NMEALIB_BUFFER_CHUNK_SIZE; \
-    s = realloc(s, sz); \
-    if (!s) { \
-      return 0; \
-    } \
-    addedChars = expression; \
-  } \
-  chars += addedChars; \
-}
-
-  char *s;
-  size_t sz;
-  size_t chars;
-  NmeaSentence msk;
-
-  if (!buf //
-      || (!buf->buffer && buf->bufferSize) //
-      || (buf->buffer && !buf->bufferSize) //
-      || !info //
-      || !mask) {
+size_t nmeaSentenceCount(const NmeaInfo *info, const NmeaSentence sentence) {
+  if (!info) {
     return 0;
   }
 
-  sz = buf->bufferSize;
-  s = buf->buffer;
+  switch (sentence) {
+    case NMEALIB_SENTENCE_GPGGA:
+    case NMEALIB_SENTENCE_GPGSA:
+    case NMEALIB_SENTENCE_GPRMC:
+    case NMEALIB_SENTENCE_GPVTG:
+      return 1;
 
-  if (!s) {
-    sz = NMEALIB_BUFFER_CHUNK_SIZE;
-    s = malloc(sz);
-    if (!s) {
-      /* can't be covered in a test */
-      return 0;
+    case NMEALIB_SENTENCE_GPGSV: {
+      size_t satCount = nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_SATINVIEWCOUNT) ?
+          info->satellites.inViewCount :
+          0;
+
+      return nmeaGPGSVsatellitesToSentencesCount(satCount);
     }
-  }
 
-  *s = '\0';
+    case NMEALIB_SENTENCE_GPNON:
+    default:
+      return 0;
+  }
+}
 
-  chars = 0;
-  msk = mask;
+size_t nmeaSentenceGenerate(char *s, const size_t sz, const NmeaInfo *info, const NmeaSentence sentence,
+    const size_t index) {
+  if (!s //
+      || !info) {
+    return 0;
+  }
 
-  while (msk) {
-    if (msk & NMEALIB_SENTENCE_GPGGA) {
+  switch (sentence) {
+    case NMEALIB_SENTENCE_GPGGA: {
       NmeaGPGGA pack;
       nmeaGPGGAFromInfo(info, &pack);
-      generateSentence(nmeaGPGGAGenerate(dst, available, &pack));
-      msk &= (NmeaSentence) ~NMEALIB_SENTENCE_GPGGA;
-    } else if (msk & NMEALIB_SENTENCE_GPGSA) {
+      return nmeaGPGGAGenerate(s, sz, &pack);
+    }
+
+    case NMEALIB_SENTENCE_GPGSA: {
       NmeaGPGSA pack;
       nmeaGPGSAFromInfo(info, &pack);
-      generateSentence(nmeaGPGSAGenerate(dst, available, &pack));
-      msk &= (NmeaSentence) ~NMEALIB_SENTENCE_GPGSA;
-    } else if (msk & NMEALIB_SENTENCE_GPGSV) {
-      size_t satCount = nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_SATINVIEWCOUNT) ?
-          info->satellites.inViewCount :
-          0;
+      return nmeaGPGSAGenerate(s, sz, &pack);
+    }
+
+    case NMEALIB_SENTENCE_GPGSV: {
       NmeaGPGSV pack;
-      size_t sentence;
-      size_t sentences = nmeaGPGSVsatellitesToSentencesCount(satCount);
+      nmeaGPGSVFromInfo(info, &pack, index);
+      return nmeaGPGSVGenerate(s, sz, &pack);
+    }
 
-      for (sentence = 0; sentence < sentences; sentence++) {
-        nmeaGPGSVFromInfo(info, &pack, sentence);
-        generateSentence(nmeaGPGSVGenerate(dst, available, &pack));
-      }
-      msk &= (NmeaSentence) ~NMEALIB_SENTENCE_GPGSV;
-    } else if (msk & NMEALIB_SENTENCE_GPRMC) {
+    case NMEALIB_SENTENCE_GPRMC: {
       NmeaGPRMC pack;
       nmeaGPRMCFromInfo(info, &pack);
-      generateSentence(nmeaGPRMCGenerate(dst, available, &pack));
-      msk &= (NmeaSentence) ~NMEALIB_SENTENCE_GPRMC;
-    } else if (msk & NMEALIB_SENTENCE_GPVTG) {
+      return nmeaGPRMCGenerate(s, sz, &pack);
+    }
+
+    case NMEALIB_SENTENCE_GPVTG: {
       NmeaGPVTG pack;
       nmeaGPVTGFromInfo(info, &pack);
-      generateSentence(nmeaGPVTGGenerate(dst, available, &pack));
-      msk &= (NmeaSentence) ~NMEALIB_SENTENCE_GPVTG;
-    } else {
-      /* no more known sentences to process */
-      break;
+      return nmeaGPVTGGenerate(s, sz, &pack);
+    }
+
+    case NMEALIB_SENTENCE_GPNON:
+    default:
+      return 0;
+  }
+}
+
+size_t nmeaSentenceFromInfoSize(const NmeaInfo *info, const NmeaSentence mask) {
+  size_t sentences = 0;
+  NmeaSentence sentence;
+
+  if (!info) {
+    return 0;
+  }
+
+  for (sentence = NMEALIB_SENTENCE_GPGGA; sentence <= NMEALIB_SENTENCE_LAST; sentence = (NmeaSentence) (sentence << 1)) {
+    if (mask & sentence) {
+      sentences += nmeaSentenceCount(info, sentence);
     }
   }
 
-  s[chars] = '\0';
+  return (sentences * NMEALIB_SENTENCE_MAX_LENGTH) + 1;
+}
+
+size_t nmeaSentenceFromInfoFixed(char *s, const size_t sz, const NmeaInfo *info, const NmeaSentence mask) {
+
+#define dst       (&s[written])
+#define available ((truncated || (sz <= written)) ? 0 : (sz - written))
+
+  char empty[1];
+  size_t chars = 0;
+  size_t written = 0;
+  bool truncated = false;
+  NmeaSentence sentence;
+
+  if ((!s && sz) //
+      || !info) {
+    return 0;
+  }
+
+  if (!s) {
+    /* only determine the length: the generators need a (never written) buffer */
+    s = empty;
+  }
+
+  if (sz) {
+    *s = '\0';
+  }
 
-  buf->buffer = s;
-  buf->bufferSize = sz;
+  for (sentence = NMEALIB_SENTENCE_GPGGA; sentence <= NMEALIB_SENTENCE_LAST; sentence = (NmeaSentence) (sentence << 1)) {
+    size_t count;
+    size_t index;
+
+    if (!(mask & sentence)) {
+      continue;
+    }
+
+    count = nmeaSentenceCount(info, sentence);
+    for (index = 0; index < count; index++) {
+      size_t addedChars = nmeaSentenceGenerate(dst, available, info, sentence, index);
+
+      if (!truncated) {
+        if (addedChars < available) {
+          written += addedChars;
+        } else {
+          truncated = true;
+          if (sz) {
+            s[written] = '\0';
+          }
+        }
+      }
+
+      chars += addedChars;
+    }
+  }
 
   return chars;
 
-#undef generateSentence
 #undef available
 #undef dst
 
 }
+
+/**
+ * Round a size up to a multiple of the buffer chunk size
+ *
+ * @param sz The size
+ * @return The rounded size
+ */
+static INLINE size_t nmeaSentenceChunkSize(size_t sz) {
+  return (sz + NMEALIB_BUFFER_CHUNK_SIZE - 1) & ~(NMEALIB_BUFFER_CHUNK_SIZE - 1);
+}
+
+size_t nmeaSentenceFromInfo(NmeaMallocedBuffer *buf, const NmeaInfo *info, const NmeaSentence mask) {
+  char *s;
+  size_t sz;
+  size_t needed;
+  size_t chars;
+
+  if (!buf //
+      || (!buf->buffer && buf->bufferSize) //
+      || (buf->buffer && !buf->bufferSize) //
+      || !info //
+      || !mask) {
+    return 0;
+  }
+
+  sz = buf->bufferSize;
+  s = buf->buffer;
+
+  needed = nmeaSentenceFromInfoSize(info, mask);
+  if (!s //
+      || (sz < needed)) {
+    size_t newSz = nmeaSentenceChunkSize(needed);
+    char *newS = realloc(s, newSz);
+    if (!newS) {
+      /* can't be covered in a test */
+      return 0;
+    }
+
+    s = newS;
+    sz = newSz;
+    buf->buffer = s;
+    buf->bufferSize = sz;
+  }
+
+  chars = nmeaSentenceFromInfoFixed(s, sz, info, mask);
+  if (chars >= sz) {
+    /* a sentence exceeded the maximum length, generate once more in a buffer of the exact size */
+    size_t newSz = nmeaSentenceChunkSize(chars + 1);
+    char *newS = realloc(s, newSz);
+    if (!newS) {
+      /* can't be covered in a test */
+      return 0;
+    }
+
+    s = newS;
+    sz = newSz;
+    buf->buffer = s;
+    buf->bufferSize = sz;
+
+    chars = nmeaSentenceFromInfoFixed(s, sz, info, mask);
+  }
+
+  return chars;
+}
@@ -0,0 +1,623 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/serialize.h>
+
+#include <string.h>
+
+/** The flag that signals metric units */
+#define NMEALIB_SERIALIZE_FLAG_METRIC (1u << 0)
+
+/** The fields that are encoded as a varint */
+#define NMEALIB_SERIALIZE_VARINTS ( \
+    NMEALIB_PRESENT_SMASK | \
+    NMEALIB_PRESENT_SATINUSECOUNT | \
+    NMEALIB_PRESENT_SATINVIEWCOUNT | \
+    NMEALIB_PRESENT_DGPSSID)
+
+/** The fields that are encoded as a double */
+#define NMEALIB_SERIALIZE_DOUBLES ( \
+    NMEALIB_PRESENT_PDOP | \
+    NMEALIB_PRESENT_HDOP | \
+    NMEALIB_PRESENT_VDOP | \
+    NMEALIB_PRESENT_LAT | \
+    NMEALIB_PRESENT_LON | \
+    NMEALIB_PRESENT_ELV | \
+    NMEALIB_PRESENT_SPEED | \
+    NMEALIB_PRESENT_TRACK | \
+    NMEALIB_PRESENT_MTRACK | \
+    NMEALIB_PRESENT_MAGVAR | \
+    NMEALIB_PRESENT_HEIGHT | \
+    NMEALIB_PRESENT_DGPSAGE)
+
+/*
+ * Writer
+ */
+
+typedef struct _NmeaSerializeWriter {
+  uint8_t *buffer;
+  size_t size;
+  size_t pos;
+} NmeaSerializeWriter;
+
+static INLINE void nmeaSerializePutU8(NmeaSerializeWriter *w, uint8_t v) {
+  if (w->pos < w->size) {
+    w->buffer[w->pos] = v;
+  }
+  w->pos++;
+}
+
+static void nmeaSerializePutU16(NmeaSerializeWriter *w, uint16_t v) {
+  nmeaSerializePutU8(w, (uint8_t) v);
+  nmeaSerializePutU8(w, (uint8_t) (v >> 8));
+}
+
+static void nmeaSerializePutVarint(NmeaSerializeWriter *w, uint32_t v) {
+  while (v >= 0x80) {
+    nmeaSerializePutU8(w, (uint8_t) (v | 0x80));
+    v >>= 7;
+  }
+  nmeaSerializePutU8(w, (uint8_t) v);
+}
+
+static void nmeaSerializePutDouble(NmeaSerializeWriter *w, double v) {
+  uint64_t u;
+  size_t i;
+
+  memcpy(&u, &v, sizeof(u));
+  for (i = 0; i < sizeof(u); i++) {
+    nmeaSerializePutU8(w, (uint8_t) u);
+    u >>= 8;
+  }
+}
+
+static INLINE uint32_t nmeaSerializeZigZag(int v) {
+  return ((uint32_t) v << 1) ^ (0 - (uint32_t) (v < 0));
+}
+
+static INLINE int nmeaSerializeUnZigZag(uint32_t v) {
+  return (int) ((v >> 1) ^ (0 - (v & 1)));
+}
+
+/*
+ * Reader
+ */
+
+typedef struct _NmeaSerializeReader {
+  const uint8_t *buffer;
+  size_t size;
+  size_t pos;
+  bool error;
+} NmeaSerializeReader;
+
+static INLINE uint8_t nmeaSerializeGetU8(NmeaSerializeReader *r) {
+  if (r->pos >= r->size) {
+    r->error = true;
+    return 0;
+  }
+
+  return r->buffer[r->pos++];
+}
+
+static uint16_t nmeaSerializeGetU16(NmeaSerializeReader *r) {
+  uint16_t v = nmeaSerializeGetU8(r);
+
+  return (uint16_t) (v | (nmeaSerializeGetU8(r) << 8));
+}
+
+static uint32_t nmeaSerializeGetVarint(NmeaSerializeReader *r) {
+  uint32_t v = 0;
+  unsigned int shift = 0;
+
+  for (;;) {
+    uint8_t c = nmeaSerializeGetU8(r);
+
+    if (r->error //
+        || (shift > 28) //
+        || ((shift == 28) && (c > 0x0f))) {
+      /* more than 32 bits */
+      r->error = true;
+      return 0;
+    }
+
+    v |= (uint32_t) (c & 0x7f) << shift;
+    if (!(c & 0x80)) {
+      return v;
+    }
+
+    shift += 7;
+  }
+}
+
+static double nmeaSerializeGetDouble(NmeaSerializeReader *r) {
+  uint64_t u = 0;
+  double v;
+  unsigned int i;
+
+  for (i = 0; i < sizeof(u); i++) {
+    u |= (uint64_t) nmeaSerializeGetU8(r) << (i * 8);
+  }
+
+  memcpy(&v, &u, sizeof(v));
+  return v;
+}
+
+/**
+ * Set up a reader at the position of a field in a view
+ *
+ * @param view The view
+ * @param field The field
+ * @param r The reader
+ * @return True when the field is present in the view
+ */
+static bool nmeaSerializeViewField(const NmeaSerializeView *view, NmeaPresence field, NmeaSerializeReader *r) {
+  unsigned int i = 0;
+
+  if (!view //
+      || !view->buffer //
+      || !field //
+      || (field & (field - 1)) //
+      || !nmeaInfoIsPresentAll(view->present, field)) {
+    return false;
+  }
+
+  while (!((uint32_t) field & (1u << i))) {
+    i++;
+  }
+
+  r->buffer = view->buffer;
+  r->size = view->length;
+  r->pos = view->offsets[i];
+  r->error = false;
+  return true;
+}
+
+/*
+ * Encoding
+ */
+
+size_t nmeaSerializeInfo(const NmeaInfo *info, uint8_t *buffer, size_t size) {
+  NmeaSerializeWriter w;
+  uint32_t present;
+  size_t i;
+
+  if (!info //
+      || (!buffer && size)) {
+    return 0;
+  }
+
+  w.buffer = buffer;
+  w.size = size;
+  w.pos = 0;
+
+  present = info->present & NMEALIB_INFO_PRESENT_MASK;
+
+  nmeaSerializePutU8(&w, NMEALIB_SERIALIZE_MAGIC);
+  nmeaSerializePutU8(&w, NMEALIB_SERIALIZE_VERSION);
+  nmeaSerializePutU8(&w, info->metric ?
+      NMEALIB_SERIALIZE_FLAG_METRIC :
+      0);
+  nmeaSerializePutU16(&w, 0); /* length, patched below */
+  nmeaSerializePutVarint(&w, present);
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_SMASK)) {
+    nmeaSerializePutVarint(&w, info->smask);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_UTCDATE)) {
+    nmeaSerializePutU16(&w, (uint16_t) info->utc.year);
+    nmeaSerializePutU8(&w, (uint8_t) info->utc.mon);
+    nmeaSerializePutU8(&w, (uint8_t) info->utc.day);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_UTCTIME)) {
+    nmeaSerializePutU8(&w, (uint8_t) info->utc.hour);
+    nmeaSerializePutU8(&w, (uint8_t) info->utc.min);
+    nmeaSerializePutU8(&w, (uint8_t) info->utc.sec);
+    nmeaSerializePutU8(&w, (uint8_t) info->utc.hsec);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_SIG)) {
+    nmeaSerializePutU8(&w, (uint8_t) info->sig);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_FIX)) {
+    nmeaSerializePutU8(&w, (uint8_t) info->fix);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_PDOP)) {
+    nmeaSerializePutDouble(&w, info->pdop);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_HDOP)) {
+    nmeaSerializePutDouble(&w, info->hdop);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_VDOP)) {
+    nmeaSerializePutDouble(&w, info->vdop);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_LAT)) {
+    nmeaSerializePutDouble(&w, info->latitude);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_LON)) {
+    nmeaSerializePutDouble(&w, info->longitude);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_ELV)) {
+    nmeaSerializePutDouble(&w, info->elevation);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_SPEED)) {
+    nmeaSerializePutDouble(&w, info->speed);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_TRACK)) {
+    nmeaSerializePutDouble(&w, info->track);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_MTRACK)) {
+    nmeaSerializePutDouble(&w, info->mtrack);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_MAGVAR)) {
+    nmeaSerializePutDouble(&w, info->magvar);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_SATINUSECOUNT)) {
+    nmeaSerializePutVarint(&w, info->satellites.inUseCount);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_SATINUSE)) {
+    uint8_t count = 0;
+
+    for (i = 0; i < NMEALIB_MAX_SATELLITES; i++) {
+      if (info->satellites.inUse[i]) {
+        count++;
+      }
+    }
+
+    nmeaSerializePutU8(&w, count);
+    for (i = 0; i < NMEALIB_MAX_SATELLITES; i++) {
+      if (info->satellites.inUse[i]) {
+        nmeaSerializePutU8(&w, (uint8_t) i);
+        nmeaSerializePutVarint(&w, info->satellites.inUse[i]);
+      }
+    }
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_SATINVIEWCOUNT)) {
+    nmeaSerializePutVarint(&w, info->satellites.inViewCount);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_SATINVIEW)) {
+    static const NmeaSatellite empty = {
+        0,
+        0,
+        0,
+        0 };
+    uint8_t count = 0;
+
+    for (i = 0; i < NMEALIB_MAX_SATELLITES; i++) {
+      if (memcmp(&info->satellites.inView[i], &empty, sizeof(empty))) {
+        count++;
+      }
+    }
+
+    nmeaSerializePutU8(&w, count);
+    for (i = 0; i < NMEALIB_MAX_SATELLITES; i++) {
+      const NmeaSatellite *satellite = &info->satellites.inView[i];
+
+      if (memcmp(satellite, &empty, sizeof(empty))) {
+        nmeaSerializePutU8(&w, (uint8_t) i);
+        nmeaSerializePutVarint(&w, satellite->prn);
+        nmeaSerializePutVarint(&w, nmeaSerializeZigZag(satellite->elevation));
+        nmeaSerializePutVarint(&w, satellite->azimuth);
+        nmeaSerializePutVarint(&w, satellite->snr);
+      }
+    }
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_HEIGHT)) {
+    nmeaSerializePutDouble(&w, info->height);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_DGPSAGE)) {
+    nmeaSerializePutDouble(&w, info->dgpsAge);
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_DGPSSID)) {
+    nmeaSerializePutVarint(&w, info->dgpsSid);
+  }
+
+  if (w.pos <= w.size) {
+    w.buffer[3] = (uint8_t) w.pos;
+    w.buffer[4] = (uint8_t) (w.pos >> 8);
+  }
+
+  return w.pos;
+}
+
+/*
+ * Decoding
+ */
+
+size_t nmeaSerializeViewInit(NmeaSerializeView *view, const uint8_t *buffer, size_t size) {
+  NmeaSerializeReader r;
+  size_t length;
+  uint8_t flags;
+  uint32_t present;
+  unsigned int i;
+
+  if (!view //
+      || !buffer) {
+    return 0;
+  }
+
+  memset(view, 0, sizeof(*view));
+
+  r.buffer = buffer;
+  r.size = size;
+  r.pos = 0;
+  r.error = false;
+
+  if ((nmeaSerializeGetU8(&r) != NMEALIB_SERIALIZE_MAGIC) //
+      || (nmeaSerializeGetU8(&r) != NMEALIB_SERIALIZE_VERSION)) {
+    return 0;
+  }
+
+  flags = nmeaSerializeGetU8(&r);
+  length = nmeaSerializeGetU16(&r);
+  if (r.error //
+      || (flags & ~NMEALIB_SERIALIZE_FLAG_METRIC) //
+      || (length > size)) {
+    return 0;
+  }
+
+  /* do not read beyond the frame */
+  r.size = length;
+
+  present = nmeaSerializeGetVarint(&r);
+  if (r.error //
+      || (present & ~(uint32_t) NMEALIB_INFO_PRESENT_MASK)) {
+    return 0;
+  }
+
+  for (i = 0; i < NMEALIB_SERIALIZE_FIELDS; i++) {
+    uint32_t field = 1u << i;
+
+    if (!(present & field)) {
+      continue;
+    }
+
+    view->offsets[i] = (uint16_t) r.pos;
+
+    if (field & NMEALIB_SERIALIZE_VARINTS) {
+      nmeaSerializeGetVarint(&r);
+    } else if (field & NMEALIB_SERIALIZE_DOUBLES) {
+      r.pos += 8;
+    } else if ((field == NMEALIB_PRESENT_UTCDATE) //
+        || (field == NMEALIB_PRESENT_UTCTIME)) {
+      r.pos += 4;
+    } else if ((field == NMEALIB_PRESENT_SIG) //
+        || (field == NMEALIB_PRESENT_FIX)) {
+      r.pos += 1;
+    } else {
+      /* satellites */
+      uint8_t count = nmeaSerializeGetU8(&r);
+      size_t values = (field == NMEALIB_PRESENT_SATINUSE) ?
+          1 :
+          4;
+      size_t j;
+      size_t k;
+
+      for (j = 0; !r.error && (j < count); j++) {
+        if (nmeaSerializeGetU8(&r) >= NMEALIB_MAX_SATELLITES) {
+          return 0;
+        }
+
+        for (k = 0; k < values; k++) {
+          nmeaSerializeGetVarint(&r);
+        }
+      }
+    }
+
+    if (r.error //
+        || (r.pos > length)) {
+      return 0;
+    }
+  }
+
+  if (r.pos != length) {
+    return 0;
+  }
+
+  view->buffer = buffer;
+  view->length = length;
+  view->metric = (flags & NMEALIB_SERIALIZE_FLAG_METRIC) != 0;
+  view->present = present;
+
+  return length;
+}
+
+bool nmeaSerializeViewGetUnsigned(const NmeaSerializeView *view, NmeaPresence field, uint32_t *value) {
+  NmeaSerializeReader r;
+
+  if (!value //
+      || !nmeaSerializeViewField(view, field, &r)) {
+    return false;
+  }
+
+  if (field & NMEALIB_SERIALIZE_VARINTS) {
+    *value = nmeaSerializeGetVarint(&r);
+    return true;
+  }
+
+  if ((field == NMEALIB_PRESENT_SIG) //
+      || (field == NMEALIB_PRESENT_FIX)) {
+    *value = nmeaSerializeGetU8(&r);
+    return true;
+  }
+
+  return false;
+}
+
+bool nmeaSerializeViewGetDouble(const NmeaSerializeView *view, NmeaPresence field, double *value) {
+  NmeaSerializeReader r;
+
+  if (!value //
+      || !(field & NMEALIB_SERIALIZE_DOUBLES) //
+      || !nmeaSerializeViewField(view, field, &r)) {
+    return false;
+  }
+
+  *value = nmeaSerializeGetDouble(&r);
+  return true;
+}
+
+bool nmeaSerializeViewGetTime(const NmeaSerializeView *view, NmeaTime *utc) {
+  NmeaSerializeReader r;
+  bool found = false;
+
+  if (!utc) {
+    return false;
+  }
+
+  if (nmeaSerializeViewField(view, NMEALIB_PRESENT_UTCDATE, &r)) {
+    utc->year = nmeaSerializeGetU16(&r);
+    utc->mon = nmeaSerializeGetU8(&r);
+    utc->day = nmeaSerializeGetU8(&r);
+    found = true;
+  }
+
+  if (nmeaSerializeViewField(view, NMEALIB_PRESENT_UTCTIME, &r)) {
+    utc->hour = nmeaSerializeGetU8(&r);
+    utc->min = nmeaSerializeGetU8(&r);
+    utc->sec = nmeaSerializeGetU8(&r);
+    utc->hsec = nmeaSerializeGetU8(&r);
+    found = true;
+  }
+
+  return found;
+}
+
+bool nmeaSerializeViewGetSatellites(const NmeaSerializeView *view, NmeaSatellites *satellites) {
+  NmeaSerializeReader r;
+  bool found = false;
+  uint32_t count;
+  uint8_t i;
+
+  if (!satellites) {
+    return false;
+  }
+
+  if (nmeaSerializeViewGetUnsigned(view, NMEALIB_PRESENT_SATINUSECOUNT, &count)) {
+    satellites->inUseCount = count;
+    found = true;
+  }
+
+  if (nmeaSerializeViewField(view, NMEALIB_PRESENT_SATINUSE, &r)) {
+    memset(satellites->inUse, 0, sizeof(satellites->inUse));
+
+    count = nmeaSerializeGetU8(&r);
+    for (i = 0; i < count; i++) {
+      uint8_t slot = nmeaSerializeGetU8(&r);
+
+      satellites->inUse[slot] = nmeaSerializeGetVarint(&r);
+    }
+
+    found = true;
+  }
+
+  if (nmeaSerializeViewGetUnsigned(view, NMEALIB_PRESENT_SATINVIEWCOUNT, &count)) {
+    satellites->inViewCount = count;
+    found = true;
+  }
+
+  if (nmeaSerializeViewField(view, NMEALIB_PRESENT_SATINVIEW, &r)) {
+    memset(satellites->inView, 0, sizeof(satellites->inView));
+
+    count = nmeaSerializeGetU8(&r);
+    for (i = 0; i < count; i++) {
+      NmeaSatellite *satellite = &satellites->inView[nmeaSerializeGetU8(&r)];
+
+      satellite->prn = nmeaSerializeGetVarint(&r);
+      satellite->elevation = nmeaSerializeUnZigZag(nmeaSerializeGetVarint(&r));
+      satellite->azimuth = nmeaSerializeGetVarint(&r);
+      satellite->snr = nmeaSerializeGetVarint(&r);
+    }
+
+    found = true;
+  }
+
+  return found;
+}
+
+size_t nmeaDeserializeInfo(const uint8_t *buffer, size_t size, NmeaInfo *info) {
+  NmeaSerializeView view;
+  size_t length;
+  uint32_t v;
+
+  if (!info) {
+    return 0;
+  }
+
+  length = nmeaSerializeViewInit(&view, buffer, size);
+  if (!length) {
+    return 0;
+  }
+
+  memset(info, 0, sizeof(*info));
+  info->present = view.present;
+  info->metric = view.metric;
+
+  if (nmeaSerializeViewGetUnsigned(&view, NMEALIB_PRESENT_SMASK, &v)) {
+    info->smask = v;
+  }
+
+  nmeaSerializeViewGetTime(&view, &info->utc);
+
+  if (nmeaSerializeViewGetUnsigned(&view, NMEALIB_PRESENT_SIG, &v)) {
+    info->sig = (NmeaSignal) v;
+  }
+
+  if (nmeaSerializeViewGetUnsigned(&view, NMEALIB_PRESENT_FIX, &v)) {
+    info->fix = (NmeaFix) v;
+  }
+
+  nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_PDOP, &info->pdop);
+  nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_HDOP, &info->hdop);
+  nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_VDOP, &info->vdop);
+  nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_LAT, &info->latitude);
+  nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_LON, &info->longitude);
+  nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_ELV, &info->elevation);
+  nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_HEIGHT, &info->height);
+  nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_SPEED, &info->speed);
+  nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_TRACK, &info->track);
+  nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_MTRACK, &info->mtrack);
+  nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_MAGVAR, &info->magvar);
+  nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_DGPSAGE, &info->dgpsAge);
+
+  if (nmeaSerializeViewGetUnsigned(&view, NMEALIB_PRESENT_DGPSSID, &v)) {
+    info->dgpsSid = v;
+  }
+
+  nmeaSerializeViewGetSatellites(&view, &info->satellites);
+
+  return length;
+}
@@ -0,0 +1,228 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/simplify.h>
+
+#include <nmealib/nmath.h>
+#include <nmealib/util.h>
+#include <math.h>
+#include <string.h>
+
+/*
+ * Helpers
+ */
+
+/**
+ * Get the position of a record
+ *
+ * @param record The record
+ * @param position The location in which to store the position (in radians)
+ */
+static INLINE void nmeaSimplifierPosition(const NmeaRecord *record, NmeaPosition *position) {
+  position->lat = nmeaMathDegreeToRadian(record->latitude);
+  position->lon = nmeaMathDegreeToRadian(record->longitude);
+}
+
+/**
+ * Keep a record: make it the anchor and open a new window
+ *
+ * @param simplifier The simplifier
+ * @param record The record
+ */
+static void nmeaSimplifierAnchor(NmeaSimplifier *simplifier, const NmeaRecord *record) {
+  NmeaPosition position;
+
+  nmeaSimplifierPosition(record, &position);
+  nmeaGeodesicOriginInit(&simplifier->anchor, &position);
+  simplifier->sinLat = sin(position.lat);
+  simplifier->cosLat = cos(position.lat);
+
+  simplifier->anchored = true;
+  simplifier->pending = false;
+  simplifier->constrained = false;
+  simplifier->distanceMax = 0.0;
+  simplifier->kept++;
+}
+
+/**
+ * Measure a record from the anchor
+ *
+ * The spherical distance is a haversine, which (unlike the cosine rule of
+ * nmeaMathDistance) stays accurate at the distances of consecutive fixes.
+ *
+ * @param simplifier The simplifier
+ * @param record The record
+ * @param azimuth The location in which to store the azimuth at the anchor
+ * (in radians)
+ * @return The distance in meters
+ */
+static double nmeaSimplifierMeasure(const NmeaSimplifier *simplifier, const NmeaRecord *record, double *azimuth) {
+  NmeaPosition position;
+  double sinLat;
+  double cosLat;
+  double dLon;
+  double sinHalfLat;
+  double sinHalfLon;
+  double h;
+
+  nmeaSimplifierPosition(record, &position);
+
+  if (simplifier->mode == NMEALIB_SIMPLIFY_ELLIPSOIDAL) {
+    return nmeaGeodesicInverse(&simplifier->anchor, &position, azimuth, NULL);
+  }
+
+  sinLat = sin(position.lat);
+  cosLat = cos(position.lat);
+  dLon = position.lon - simplifier->anchor.position.lon;
+  sinHalfLat = sin((position.lat - simplifier->anchor.position.lat) / 2.0);
+  sinHalfLon = sin(dLon / 2.0);
+  h = (sinHalfLat * sinHalfLat) + (simplifier->cosLat * cosLat * sinHalfLon * sinHalfLon);
+
+  *azimuth = atan2(sin(dLon) * cosLat, (simplifier->cosLat * sinLat) - (simplifier->sinLat * cosLat * cos(dLon)));
+  return 2.0 * NMEALIB_EARTHRADIUS_M * asin(MIN(sqrt(h), 1.0));
+}
+
+/**
+ * Extend the window of a simplifier with a record
+ *
+ * The window can be closed at the record when all records in the window lie
+ * within the tolerance of the line from the anchor to the record (its
+ * azimuth is in the range of directions), and not more than the tolerance
+ * beyond the record.
+ *
+ * @param simplifier The simplifier
+ * @param record The record
+ * @return True when the record was added to the window, false when the
+ * window can not be closed at the record
+ */
+static bool nmeaSimplifierExtend(NmeaSimplifier *simplifier, const NmeaRecord *record) {
+  double azimuth = 0.0;
+  double distance = nmeaSimplifierMeasure(simplifier, record, &azimuth);
+  double offset;
+  double width;
+
+  if (!simplifier->constrained) {
+    /* all records in the window lie within the tolerance of the anchor */
+    if (distance > simplifier->tolerance) {
+      width = asin(simplifier->tolerance / distance);
+      simplifier->constrained = true;
+      simplifier->reference = azimuth;
+      simplifier->low = -width;
+      simplifier->high = width;
+    }
+
+    simplifier->distanceMax = MAX(simplifier->distanceMax, distance);
+    return true;
+  }
+
+  if ((distance <= simplifier->tolerance) //
+      || (distance < (simplifier->distanceMax - simplifier->tolerance))) {
+    return false;
+  }
+
+  offset = remainder(azimuth - simplifier->reference, 2.0 * NMEALIB_PI);
+  if ((offset < simplifier->low) //
+      || (offset > simplifier->high)) {
+    return false;
+  }
+
+  width = asin(simplifier->tolerance / distance);
+  simplifier->low = MAX(simplifier->low, offset - width);
+  simplifier->high = MIN(simplifier->high, offset + width);
+  simplifier->distanceMax = MAX(simplifier->distanceMax, distance);
+
+  return true;
+}
+
+/*
+ * Public
+ */
+
+bool nmeaSimplifierInit(NmeaSimplifier *simplifier, NmeaSimplifyMode mode, double tolerance) {
+  if (!simplifier //
+      || ((mode != NMEALIB_SIMPLIFY_SPHERICAL) //
+          && (mode != NMEALIB_SIMPLIFY_ELLIPSOIDAL)) //
+      || !isfinite(tolerance) //
+      || (tolerance <= 0.0)) {
+    return false;
+  }
+
+  memset(simplifier, 0, sizeof(*simplifier));
+  simplifier->mode = mode;
+  simplifier->tolerance = tolerance;
+
+  return true;
+}
+
+bool nmeaSimplifierAdd(NmeaSimplifier *simplifier, const NmeaRecord *record, NmeaRecord *kept) {
+  if (!simplifier //
+      || !record //
+      || !kept //
+      || !nmeaInfoIsPresentAll(record->present, NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON) //
+      || !isfinite(record->latitude) //
+      || !isfinite(record->longitude) //
+      || (fabs(record->latitude) > 90.0)) {
+    return false;
+  }
+
+  simplifier->added++;
+
+  if (!simplifier->anchored) {
+    nmeaSimplifierAnchor(simplifier, record);
+    *kept = *record;
+    return true;
+  }
+
+  if (nmeaSimplifierExtend(simplifier, record)) {
+    simplifier->candidate = *record;
+    simplifier->pending = true;
+    return false;
+  }
+
+  /* close the window at the candidate, the record opens the next window */
+  *kept = simplifier->candidate;
+  nmeaSimplifierAnchor(simplifier, &simplifier->candidate);
+  nmeaSimplifierExtend(simplifier, record);
+  simplifier->candidate = *record;
+  simplifier->pending = true;
+
+  return true;
+}
+
+bool nmeaSimplifierAddInfo(NmeaSimplifier *simplifier, const NmeaInfo *info, NmeaRecord *kept) {
+  NmeaRecord record;
+
+  if (!info //
+      || !nmeaRecordFromInfo(info, &record)) {
+    return false;
+  }
+
+  return nmeaSimplifierAdd(simplifier, &record, kept);
+}
+
+bool nmeaSimplifierFlush(NmeaSimplifier *simplifier, NmeaRecord *kept) {
+  if (!simplifier //
+      || !kept //
+      || !simplifier->pending) {
+    return false;
+  }
+
+  *kept = simplifier->candidate;
+  nmeaSimplifierAnchor(simplifier, &simplifier->candidate);
+
+  return true;
+}
@@ -0,0 +1,1237 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/spatial.h>
+
+#include <nmealib/nmath.h>
+#include <nmealib/util.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The marker for no entry */
+#define NMEALIB_SPATIAL_NONE (SIZE_MAX)
+
+/** The initial number of slots of a hash table, a power of 2 */
+#define NMEALIB_SPATIAL_TABLE_SIZE (64u)
+
+/** The initial number of entries and buckets */
+#define NMEALIB_SPATIAL_ENTRIES (64u)
+
+/** The initial number of units of a bucket */
+#define NMEALIB_SPATIAL_ITEMS (4u)
+
+/**
+ * A hash table from 64-bit keys to entry indices, with open addressing and
+ * linear probing
+ */
+typedef struct _NmeaSpatialTable {
+    uint64_t *keys;   /**< The keys of the slots                                  */
+    size_t   *values; /**< The values of the slots, NMEALIB_SPATIAL_NONE if empty */
+    size_t    mask;   /**< The number of slots - 1                                */
+    size_t    count;  /**< The number of used slots                               */
+} NmeaSpatialTable;
+
+/**
+ * A unit in a cell
+ */
+typedef struct _NmeaSpatialItem {
+    double       x;        /**< The unit vector, towards lat 0, lon 0            */
+    double       y;        /**< The unit vector, towards lat 0, lon pi/2         */
+    double       z;        /**< The unit vector, towards the north pole          */
+    NmeaPosition position; /**< The position, with a longitude in [-pi, pi>      */
+    uint64_t     id;       /**< The identifier of the unit                       */
+    size_t       entry;    /**< The index of the entry of the unit               */
+} NmeaSpatialItem;
+
+/**
+ * The units in a cell, contiguous so that a query scans them sequentially
+ */
+typedef struct _NmeaSpatialBucket {
+    NmeaSpatialItem *items;    /**< The units                                     */
+    size_t           count;    /**< The number of units                           */
+    size_t           capacity; /**< The size of the items array                   */
+    uint64_t         cell;     /**< The cell                                      */
+} NmeaSpatialBucket;
+
+/**
+ * The location of a unit
+ */
+typedef struct _NmeaSpatialEntry {
+    size_t bucket; /**< The bucket of the unit                                   */
+    size_t slot;   /**< The index of the unit in its bucket                      */
+} NmeaSpatialEntry;
+
+struct _NmeaSpatial {
+    size_t             rows;           /**< The number of rows of cells               */
+    size_t             columns;        /**< The number of columns of cells            */
+    double             cellLat;        /**< The height of a cell (in radians)         */
+    double             cellLon;        /**< The width of a cell (in radians)          */
+    NmeaSpatialEntry  *entries;        /**< The units                                 */
+    size_t             count;          /**< The number of units                       */
+    size_t             capacity;       /**< The size of the entries array             */
+    NmeaSpatialBucket *buckets;        /**< The buckets, used and free                */
+    size_t            *unused;         /**< The indices of the free buckets           */
+    size_t             bucketCount;    /**< The number of buckets, used and free      */
+    size_t             unusedCount;    /**< The number of free buckets                */
+    size_t             bucketCapacity; /**< The size of the buckets and unused arrays */
+    NmeaSpatialTable   ids;            /**< The entry indices by unit identifier      */
+    NmeaSpatialTable   cells;          /**< The bucket indices by cell                */
+};
+
+/**
+ * A query
+ */
+typedef struct _NmeaSpatialQuery {
+    double             x;        /**< The unit vector of the center               */
+    double             y;        /**< The unit vector of the center               */
+    double             z;        /**< The unit vector of the center               */
+    double             limit;    /**< The maximum squared chord                   */
+    double             latMin;   /**< The southern latitude of the box            */
+    double             latMax;   /**< The northern latitude of the box            */
+    double             lonMin;   /**< The western longitude of the box            */
+    double             lonMax;   /**< The eastern longitude of the box            */
+    NmeaSpatialResult *results;  /**< The results                                 */
+    uint64_t          *ids;      /**< The results of a box query                  */
+    size_t             capacity; /**< The size of the results array               */
+    size_t             count;    /**< The number of matching units                */
+} NmeaSpatialQuery;
+
+/**
+ * Test a unit in a query, and add it to the results when it matches
+ *
+ * @param item The unit
+ * @param query The query
+ */
+typedef void (*NmeaSpatialVisit)(const NmeaSpatialItem *item, NmeaSpatialQuery *query);
+
+/*
+ * Helpers
+ */
+
+/**
+ * Hash a key (the splitmix64 finaliser)
+ *
+ * @param key The key
+ * @return The hash
+ */
+static INLINE size_t nmeaSpatialHash(uint64_t key) {
+  key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ull;
+  key = (key ^ (key >> 27)) * 0x94d049bb133111ebull;
+  return (size_t) (key ^ (key >> 31));
+}
+
+/**
+ * Allocate the slots of a hash table
+ *
+ * @param table The hash table
+ * @param size The number of slots, a power of 2
+ * @return True on success
+ */
+static bool nmeaSpatialTableAllocate(NmeaSpatialTable *table, size_t size) {
+  size_t i;
+
+  table->keys = malloc(size * sizeof(table->keys[0]));
+  table->values = malloc(size * sizeof(table->values[0]));
+  if (!table->keys //
+      || !table->values) {
+    /* can't be covered in a test */
+    free(table->keys);
+    free(table->values);
+    return false;
+  }
+
+  for (i = 0; i < size; i++) {
+    table->values[i] = NMEALIB_SPATIAL_NONE;
+  }
+  table->mask = size - 1;
+  table->count = 0;
+
+  return true;
+}
+
+/**
+ * Find the slot of a key in a hash table
+ *
+ * @param table The hash table
+ * @param key The key
+ * @return The slot of the key, or the empty slot where it would be inserted
+ */
+static INLINE size_t nmeaSpatialTableSlot(const NmeaSpatialTable *table, uint64_t key) {
+  size_t slot = nmeaSpatialHash(key) & table->mask;
+
+  while ((table->values[slot] != NMEALIB_SPATIAL_NONE) //
+      && (table->keys[slot] != key)) {
+    slot = (slot + 1) & table->mask;
+  }
+
+  return slot;
+}
+
+/**
+ * Get the value of a key in a hash table
+ *
+ * @param table The hash table
+ * @param key The key
+ * @return The value, or NMEALIB_SPATIAL_NONE when the key is not in the table
+ */
+static INLINE size_t nmeaSpatialTableGet(const NmeaSpatialTable *table, uint64_t key) {
+  return table->values[nmeaSpatialTableSlot(table, key)];
+}
+
+/**
+ * Make room in a hash table for one more key, keeping it at most half full
+ *
+ * @param table The hash table
+ * @return True on success
+ */
+static bool nmeaSpatialTableReserve(NmeaSpatialTable *table) {
+  NmeaSpatialTable grown;
+  size_t i;
+
+  if (((table->count + 1) * 2) <= (table->mask + 1)) {
+    return true;
+  }
+
+  if (!nmeaSpatialTableAllocate(&grown, (table->mask + 1) * 2)) {
+    return false;
+  }
+
+  for (i = 0; i <= table->mask; i++) {
+    if (table->values[i] != NMEALIB_SPATIAL_NONE) {
+      size_t slot = nmeaSpatialTableSlot(&grown, table->keys[i]);
+
+      grown.keys[slot] = table->keys[i];
+      grown.values[slot] = table->values[i];
+    }
+  }
+  grown.count = table->count;
+
+  free(table->keys);
+  free(table->values);
+  *table = grown;
+
+  return true;
+}
+
+/**
+ * Set the value of a key in a hash table
+ *
+ * Never fails for a key that is in the table, or after nmeaSpatialTableReserve.
+ *
+ * @param table The hash table
+ * @param key The key
+ * @param value The value
+ * @return True on success
+ */
+static bool nmeaSpatialTableSet(NmeaSpatialTable *table, uint64_t key, size_t value) {
+  size_t slot = nmeaSpatialTableSlot(table, key);
+
+  if (table->values[slot] == NMEALIB_SPATIAL_NONE) {
+    if (!nmeaSpatialTableReserve(table)) {
+      return false;
+    }
+
+    slot = nmeaSpatialTableSlot(table, key);
+    table->keys[slot] = key;
+    table->count++;
+  }
+
+  table->values[slot] = value;
+  return true;
+}
+
+/**
+ * Remove a key from a hash table, shifting back the keys that probed past it
+ *
+ * @param table The hash table
+ * @param key The key, must be in the table
+ */
+static void nmeaSpatialTableRemove(NmeaSpatialTable *table, uint64_t key) {
+  size_t hole = nmeaSpatialTableSlot(table, key);
+  size_t slot = hole;
+
+  table->values[hole] = NMEALIB_SPATIAL_NONE;
+  table->count--;
+
+  for (;;) {
+    size_t home;
+
+    slot = (slot + 1) & table->mask;
+    if (table->values[slot] == NMEALIB_SPATIAL_NONE) {
+      return;
+    }
+
+    /* a key can move into the hole when the hole lies between its home slot and its slot */
+    home = nmeaSpatialHash(table->keys[slot]) & table->mask;
+    if (((slot - home) & table->mask) >= ((slot - hole) & table->mask)) {
+      table->keys[hole] = table->keys[slot];
+      table->values[hole] = table->values[slot];
+      table->values[slot] = NMEALIB_SPATIAL_NONE;
+      hole = slot;
+    }
+  }
+}
+
+/**
+ * Normalise a longitude into [-pi, pi>
+ *
+ * @param lon The longitude (in radians)
+ * @return The normalised longitude
+ */
+static INLINE double nmeaSpatialLongitude(double lon) {
+  if ((lon >= -NMEALIB_PI) //
+      && (lon < NMEALIB_PI)) {
+    return lon;
+  }
+
+  lon -= 2.0 * NMEALIB_PI * floor((lon + NMEALIB_PI) / (2.0 * NMEALIB_PI));
+  return (lon < NMEALIB_PI) ?
+      lon :
+      -NMEALIB_PI;
+}
+
+/**
+ * Get the row of a latitude
+ *
+ * @param index The spatial index
+ * @param lat The latitude (in radians), in [-pi/2, pi/2]
+ * @return The row
+ */
+static INLINE size_t nmeaSpatialRow(const NmeaSpatial *index, double lat) {
+  double row = floor((lat + (NMEALIB_PI / 2.0)) / index->cellLat);
+
+  return MIN((size_t) MAX(row, 0.0), index->rows - 1);
+}
+
+/**
+ * Get the column of a longitude
+ *
+ * @param index The spatial index
+ * @param lon The longitude (in radians), in [-pi, pi>
+ * @return The column
+ */
+static INLINE size_t nmeaSpatialColumn(const NmeaSpatial *index, double lon) {
+  double column = floor((lon + NMEALIB_PI) / index->cellLon);
+
+  return MIN((size_t) MAX(column, 0.0), index->columns - 1);
+}
+
+/**
+ * Get the cell of a row and column
+ *
+ * @param index The spatial index
+ * @param row The row
+ * @param column The column
+ * @return The cell
+ */
+static INLINE uint64_t nmeaSpatialCell(const NmeaSpatial *index, size_t row, size_t column) {
+  return ((uint64_t) row * index->columns) + column;
+}
+
+/**
+ * Compute the unit vector of a position
+ *
+ * @param position The position (in radians)
+ * @param x The location in which to store the x component
+ * @param y The location in which to store the y component
+ * @param z The location in which to store the z component
+ */
+static void nmeaSpatialVector(const NmeaPosition *position, double *x, double *y, double *z) {
+  double cosLat = cos(position->lat);
+
+  *x = cosLat * cos(position->lon);
+  *y = cosLat * sin(position->lon);
+  *z = sin(position->lat);
+}
+
+/**
+ * The squared chord between a unit and the center of a query
+ *
+ * @param item The unit
+ * @param query The query
+ * @return The squared chord, on the unit sphere
+ */
+static INLINE double nmeaSpatialChord2(const NmeaSpatialItem *item, const NmeaSpatialQuery *query) {
+  double dx = item->x - query->x;
+  double dy = item->y - query->y;
+  double dz = item->z - query->z;
+
+  return (dx * dx) + (dy * dy) + (dz * dz);
+}
+
+/**
+ * The squared chord of an angle
+ *
+ * @param angle The angle (in radians)
+ * @return The squared chord, on the unit sphere
+ */
+static INLINE double nmeaSpatialAngleToChord2(double angle) {
+  double s;
+
+  if (angle >= NMEALIB_PI) {
+    return 4.0;
+  }
+
+  s = sin(angle / 2.0);
+  return 4.0 * s * s;
+}
+
+/**
+ * The distance of a squared chord
+ *
+ * @param chord2 The squared chord, on the unit sphere
+ * @return The distance in meters
+ */
+static INLINE double nmeaSpatialChord2ToDistance(double chord2) {
+  return 2.0 * NMEALIB_EARTHRADIUS_M * asin(MIN(sqrt(chord2) / 2.0, 1.0));
+}
+
+/**
+ * Get the bucket of a cell, optionally creating it
+ *
+ * @param index The spatial index
+ * @param cell The cell
+ * @param create True to create the bucket when the cell has none
+ * @return The index of the bucket, or NMEALIB_SPATIAL_NONE when the cell has
+ * none or on failure
+ */
+static size_t nmeaSpatialBucketGet(NmeaSpatial *index, uint64_t cell, bool create) {
+  size_t b = nmeaSpatialTableGet(&index->cells, cell);
+
+  if ((b != NMEALIB_SPATIAL_NONE) //
+      || !create) {
+    return b;
+  }
+
+  if (!nmeaSpatialTableReserve(&index->cells)) {
+    /* can't be covered in a test */
+    return NMEALIB_SPATIAL_NONE;
+  }
+
+  if (index->unusedCount) {
+    b = index->unused[--index->unusedCount];
+  } else {
+    if (index->bucketCount == index->bucketCapacity) {
+      size_t capacity = index->bucketCapacity * 2;
+      NmeaSpatialBucket *buckets = realloc(index->buckets, capacity * sizeof(buckets[0]));
+      size_t *unused;
+
+      if (!buckets) {
+        /* can't be covered in a test */
+        return NMEALIB_SPATIAL_NONE;
+      }
+      index->buckets = buckets;
+
+      unused = realloc(index->unused, capacity * sizeof(unused[0]));
+      if (!unused) {
+        /* can't be covered in a test */
+        return NMEALIB_SPATIAL_NONE;
+      }
+      index->unused = unused;
+      index->bucketCapacity = capacity;
+    }
+
+    b = index->bucketCount++;
+    memset(&index->buckets[b], 0, sizeof(index->buckets[b]));
+  }
+
+  index->buckets[b].cell = cell;
+  index->buckets[b].count = 0;
+  nmeaSpatialTableSet(&index->cells, cell, b);
+
+  return b;
+}
+
+/**
+ * Release an empty bucket
+ *
+ * @param index The spatial index
+ * @param b The index of the bucket
+ */
+static void nmeaSpatialBucketRelease(NmeaSpatial *index, size_t b) {
+  nmeaSpatialTableRemove(&index->cells, index->buckets[b].cell);
+  index->unused[index->unusedCount++] = b;
+}
+
+/**
+ * Make room in a bucket for one more unit
+ *
+ * @param bucket The bucket
+ * @return True on success
+ */
+static bool nmeaSpatialBucketReserve(NmeaSpatialBucket *bucket) {
+  size_t capacity;
+  NmeaSpatialItem *items;
+
+  if (bucket->count < bucket->capacity) {
+    return true;
+  }
+
+  capacity = bucket->capacity ?
+      bucket->capacity * 2 :
+      NMEALIB_SPATIAL_ITEMS;
+  items = realloc(bucket->items, capacity * sizeof(items[0]));
+  if (!items) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  bucket->items = items;
+  bucket->capacity = capacity;
+
+  return true;
+}
+
+/**
+ * Append a unit to a bucket, which must have room for it
+ *
+ * @param index The spatial index
+ * @param b The index of the bucket
+ * @param item The unit
+ */
+static void nmeaSpatialItemAppend(NmeaSpatial *index, size_t b, const NmeaSpatialItem *item) {
+  NmeaSpatialBucket *bucket = &index->buckets[b];
+  NmeaSpatialEntry *entry = &index->entries[item->entry];
+
+  entry->bucket = b;
+  entry->slot = bucket->count;
+  bucket->items[bucket->count++] = *item;
+}
+
+/**
+ * Remove a unit from its bucket, releasing the bucket when it becomes empty
+ *
+ * @param index The spatial index
+ * @param entry The entry of the unit
+ */
+static void nmeaSpatialItemRemove(NmeaSpatial *index, const NmeaSpatialEntry *entry) {
+  NmeaSpatialBucket *bucket = &index->buckets[entry->bucket];
+
+  /* move the last unit of the bucket into the hole */
+  bucket->count--;
+  if (entry->slot != bucket->count) {
+    bucket->items[entry->slot] = bucket->items[bucket->count];
+    index->entries[bucket->items[entry->slot].entry].slot = entry->slot;
+  }
+
+  if (!bucket->count) {
+    nmeaSpatialBucketRelease(index, entry->bucket);
+  }
+}
+
+/**
+ * Visit all units
+ *
+ * @param index The spatial index
+ * @param visit The visitor
+ * @param query The query
+ */
+static void nmeaSpatialVisitAll(const NmeaSpatial *index, NmeaSpatialVisit visit, NmeaSpatialQuery *query) {
+  size_t b;
+
+  for (b = 0; b < index->bucketCount; b++) {
+    const NmeaSpatialBucket *bucket = &index->buckets[b];
+    size_t i;
+
+    for (i = 0; i < bucket->count; i++) {
+      visit(&bucket->items[i], query);
+    }
+  }
+}
+
+/**
+ * Visit the units in consecutive cells of a row
+ *
+ * @param index The spatial index
+ * @param row The row
+ * @param column The first column
+ * @param columns The number of columns, wrapping around the antimeridian
+ * @param visit The visitor
+ * @param query The query
+ */
+static void nmeaSpatialVisitCells(const NmeaSpatial *index, size_t row, size_t column, size_t columns,
+    NmeaSpatialVisit visit, NmeaSpatialQuery *query) {
+  size_t n;
+
+  for (n = 0; n < columns; n++) {
+    size_t b = nmeaSpatialTableGet(&index->cells, nmeaSpatialCell(index, row, column));
+
+    if (b != NMEALIB_SPATIAL_NONE) {
+      const NmeaSpatialBucket *bucket = &index->buckets[b];
+      size_t i;
+
+      for (i = 0; i < bucket->count; i++) {
+        visit(&bucket->items[i], query);
+      }
+    }
+
+    column++;
+    if (column >= index->columns) {
+      column = 0;
+    }
+  }
+}
+
+/**
+ * Visit the units in the cells of a range of rows and longitudes
+ *
+ * Visits all units instead when that is cheaper.
+ *
+ * @param index The spatial index
+ * @param latMin The southern latitude (in radians)
+ * @param latMax The northern latitude (in radians)
+ * @param lonMin The western longitude (in radians), not normalised
+ * @param lonMax The eastern longitude (in radians), not normalised, or larger
+ * than lonMin + 2 pi for all longitudes
+ * @param visit The visitor
+ * @param query The query
+ */
+static void nmeaSpatialVisitRange(const NmeaSpatial *index, double latMin, double latMax, double lonMin,
+    double lonMax, NmeaSpatialVisit visit, NmeaSpatialQuery *query) {
+  size_t rowMin = nmeaSpatialRow(index, MAX(latMin, -NMEALIB_PI / 2.0));
+  size_t rowMax = nmeaSpatialRow(index, MIN(latMax, NMEALIB_PI / 2.0));
+  size_t column = 0;
+  size_t columns = index->columns;
+  size_t row;
+
+  if ((lonMax - lonMin) < (2.0 * NMEALIB_PI)) {
+    double first = floor((lonMin + NMEALIB_PI) / index->cellLon);
+    double last = floor((lonMax + NMEALIB_PI) / index->cellLon);
+
+    if ((last - first) < (double) index->columns) {
+      column = nmeaSpatialColumn(index, nmeaSpatialLongitude(lonMin));
+      columns = (size_t) (last - first) + 1;
+    }
+  }
+
+  if (((rowMax - rowMin + 1) * columns) > index->count) {
+    nmeaSpatialVisitAll(index, visit, query);
+    return;
+  }
+
+  for (row = rowMin; row <= rowMax; row++) {
+    nmeaSpatialVisitCells(index, row, column, columns, visit, query);
+  }
+}
+
+/**
+ * Restore the max-heap property of a heap of results, from its top down
+ *
+ * @param heap The heap, ordered by the distance field
+ * @param count The number of results in the heap
+ */
+static void nmeaSpatialHeapDown(NmeaSpatialResult *heap, size_t count) {
+  NmeaSpatialResult top = heap[0];
+  size_t i = 0;
+
+  for (;;) {
+    size_t child = (2 * i) + 1;
+
+    if (child >= count) {
+      break;
+    }
+    if (((child + 1) < count) //
+        && (heap[child + 1].distance > heap[child].distance)) {
+      child++;
+    }
+    if (heap[child].distance <= top.distance) {
+      break;
+    }
+
+    heap[i] = heap[child];
+    i = child;
+  }
+
+  heap[i] = top;
+}
+
+static void nmeaSpatialVisitNearest(const NmeaSpatialItem *item, NmeaSpatialQuery *query) {
+  double chord2 = nmeaSpatialChord2(item, query);
+  NmeaSpatialResult *heap = query->results;
+
+  if (query->count < query->capacity) {
+    /* sift up */
+    size_t i = query->count++;
+
+    while (i) {
+      size_t parent = (i - 1) / 2;
+
+      if (heap[parent].distance >= chord2) {
+        break;
+      }
+
+      heap[i] = heap[parent];
+      i = parent;
+    }
+
+    heap[i].id = item->id;
+    heap[i].distance = chord2;
+  } else if (chord2 < heap[0].distance) {
+    heap[0].id = item->id;
+    heap[0].distance = chord2;
+    nmeaSpatialHeapDown(heap, query->count);
+  }
+}
+
+static void nmeaSpatialVisitRadius(const NmeaSpatialItem *item, NmeaSpatialQuery *query) {
+  double chord2 = nmeaSpatialChord2(item, query);
+
+  if (chord2 > query->limit) {
+    return;
+  }
+
+  if (query->count < query->capacity) {
+    query->results[query->count].id = item->id;
+    query->results[query->count].distance = nmeaSpatialChord2ToDistance(chord2);
+  }
+  query->count++;
+}
+
+static void nmeaSpatialVisitBox(const NmeaSpatialItem *item, NmeaSpatialQuery *query) {
+  double lat = item->position.lat;
+  double lon = item->position.lon;
+
+  if ((lat < query->latMin) //
+      || (lat > query->latMax)) {
+    return;
+  }
+
+  if ((query->lonMin <= query->lonMax) ?
+      ((lon < query->lonMin) || (lon > query->lonMax)) :
+      ((lon < query->lonMin) && (lon > query->lonMax))) {
+    return;
+  }
+
+  if (query->count < query->capacity) {
+    query->ids[query->count] = item->id;
+  }
+  query->count++;
+}
+
+/**
+ * Visit the new cells of a ring around a cell
+ *
+ * Ring r holds the cells that are r rows or columns away from the center
+ * cell, rings 0 to r - 1 are already visited.
+ *
+ * @param index The spatial index
+ * @param row The row of the center cell
+ * @param column The column of the center cell
+ * @param r The ring, at least 1
+ * @param visit The visitor
+ * @param query The query
+ * @return The number of visited cells
+ */
+static size_t nmeaSpatialVisitRing(const NmeaSpatial *index, size_t row, size_t column, size_t r,
+    NmeaSpatialVisit visit, NmeaSpatialQuery *query) {
+  size_t columns = index->columns;
+  bool full = ((2 * r) + 1) >= columns;
+  bool previousFull = ((2 * r) - 1) >= columns;
+  size_t rowMin = (r <= row) ?
+      row - r :
+      0;
+  size_t rowMax = MIN(row + r, index->rows - 1);
+  size_t west = (column + columns - (r % columns)) % columns;
+  size_t east = (column + r) % columns;
+  size_t visited = 0;
+  size_t i;
+
+  for (i = rowMin; i <= rowMax; i++) {
+    if ((i + r == row) //
+        || (i == row + r)) {
+      /* a new row */
+      if (full) {
+        nmeaSpatialVisitCells(index, i, 0, columns, visit, query);
+        visited += columns;
+      } else {
+        nmeaSpatialVisitCells(index, i, west, (2 * r) + 1, visit, query);
+        visited += (2 * r) + 1;
+      }
+    } else if (previousFull) {
+      /* all columns are already visited */
+    } else if (full) {
+      nmeaSpatialVisitCells(index, i, east, columns - (2 * r) + 1, visit, query);
+      visited += columns - (2 * r) + 1;
+    } else {
+      nmeaSpatialVisitCells(index, i, west, 1, visit, query);
+      nmeaSpatialVisitCells(index, i, east, 1, visit, query);
+      visited += 2;
+    }
+  }
+
+  return visited;
+}
+
+/**
+ * The minimum angular distance from a position to the cells outside a ring
+ *
+ * @param index The spatial index
+ * @param center The position (in radians), with a normalised longitude
+ * @param row The row of the cell of the position
+ * @param column The column of the cell of the position
+ * @param r The ring
+ * @return The angular distance (in radians), larger than pi when the ring
+ * covers all cells
+ */
+static double nmeaSpatialRingBound(const NmeaSpatial *index, const NmeaPosition *center, size_t row, size_t column,
+    size_t r) {
+  double bound = 2.0 * NMEALIB_PI;
+
+  if (r < row) {
+    bound = MIN(bound, center->lat - ((((double) (row - r)) * index->cellLat) - (NMEALIB_PI / 2.0)));
+  }
+  if ((row + r) < (index->rows - 1)) {
+    bound = MIN(bound, ((((double) (row + r + 1)) * index->cellLat) - (NMEALIB_PI / 2.0)) - center->lat);
+  }
+  if (((2 * r) + 1) < index->columns) {
+    /* the distance to the nearest meridian of the edges of the ring */
+    double lon = center->lon + NMEALIB_PI;
+    double a = MIN(lon - (((double) column - (double) r) * index->cellLon),
+        (((double) column + (double) r + 1.0) * index->cellLon) - lon);
+
+    bound = MIN(bound, asin(cos(center->lat) * sin(MIN(MAX(a, 0.0), NMEALIB_PI / 2.0))));
+  }
+
+  return bound;
+}
+
+/**
+ * Sort a max-heap of results ascending
+ *
+ * @param heap The heap, ordered by the distance field
+ * @param count The number of results in the heap
+ */
+static void nmeaSpatialHeapSort(NmeaSpatialResult *heap, size_t count) {
+  while (count > 1) {
+    NmeaSpatialResult t = heap[0];
+
+    count--;
+    heap[0] = heap[count];
+    heap[count] = t;
+    nmeaSpatialHeapDown(heap, count);
+  }
+}
+
+/*
+ * Public
+ */
+
+NmeaSpatial *nmeaSpatialCreate(double cellSize) {
+  NmeaSpatial *index;
+  double rows;
+  double columns;
+
+  if (cellSize == 0.0) {
+    cellSize = NMEALIB_SPATIAL_CELL_SIZE_DEFAULT;
+  }
+
+  if (isNaN(cellSize) //
+      || (cellSize < NMEALIB_SPATIAL_CELL_SIZE_MIN)) {
+    return NULL;
+  }
+
+  index = calloc(1, sizeof(*index));
+  if (!index) {
+    /* can't be covered in a test */
+    return NULL;
+  }
+
+  rows = ceil((NMEALIB_PI * NMEALIB_EARTHRADIUS_M) / cellSize);
+  columns = ceil((2.0 * NMEALIB_PI * NMEALIB_EARTHRADIUS_M) / cellSize);
+  index->rows = (size_t) rows;
+  index->columns = (size_t) columns;
+  index->cellLat = NMEALIB_PI / rows;
+  index->cellLon = (2.0 * NMEALIB_PI) / columns;
+
+  index->entries = malloc(NMEALIB_SPATIAL_ENTRIES * sizeof(index->entries[0]));
+  index->buckets = malloc(NMEALIB_SPATIAL_ENTRIES * sizeof(index->buckets[0]));
+  index->unused = malloc(NMEALIB_SPATIAL_ENTRIES * sizeof(index->unused[0]));
+  if (!index->entries //
+      || !index->buckets //
+      || !index->unused //
+      || !nmeaSpatialTableAllocate(&index->ids, NMEALIB_SPATIAL_TABLE_SIZE)) {
+    /* can't be covered in a test */
+    free(index->entries);
+    free(index->buckets);
+    free(index->unused);
+    free(index);
+    return NULL;
+  }
+  if (!nmeaSpatialTableAllocate(&index->cells, NMEALIB_SPATIAL_TABLE_SIZE)) {
+    /* can't be covered in a test */
+    free(index->ids.keys);
+    free(index->ids.values);
+    free(index->entries);
+    free(index->buckets);
+    free(index->unused);
+    free(index);
+    return NULL;
+  }
+  index->capacity = NMEALIB_SPATIAL_ENTRIES;
+  index->bucketCapacity = NMEALIB_SPATIAL_ENTRIES;
+
+  return index;
+}
+
+void nmeaSpatialDestroy(NmeaSpatial *index) {
+  size_t b;
+
+  if (!index) {
+    return;
+  }
+
+  for (b = 0; b < index->bucketCount; b++) {
+    free(index->buckets[b].items);
+  }
+
+  free(index->ids.keys);
+  free(index->ids.values);
+  free(index->cells.keys);
+  free(index->cells.values);
+  free(index->entries);
+  free(index->buckets);
+  free(index->unused);
+  free(index);
+}
+
+void nmeaSpatialClear(NmeaSpatial *index) {
+  size_t i;
+
+  if (!index) {
+    return;
+  }
+
+  for (i = 0; i <= index->ids.mask; i++) {
+    index->ids.values[i] = NMEALIB_SPATIAL_NONE;
+  }
+  index->ids.count = 0;
+
+  for (i = 0; i <= index->cells.mask; i++) {
+    index->cells.values[i] = NMEALIB_SPATIAL_NONE;
+  }
+  index->cells.count = 0;
+
+  /* keep the buckets and their memory for reuse */
+  for (i = 0; i < index->bucketCount; i++) {
+    index->buckets[i].count = 0;
+    index->unused[i] = i;
+  }
+  index->unusedCount = index->bucketCount;
+
+  index->count = 0;
+}
+
+size_t nmeaSpatialCount(const NmeaSpatial *index) {
+  return index ?
+      index->count :
+      0;
+}
+
+bool nmeaSpatialUpdate(NmeaSpatial *index, uint64_t id, const NmeaPosition *position) {
+  NmeaSpatialItem item;
+  uint64_t cell;
+  size_t b;
+  size_t i;
+
+  if (!index //
+      || !position //
+      || !isfinite(position->lat) //
+      || !isfinite(position->lon) //
+      || (fabs(position->lat) > (NMEALIB_PI / 2.0))) {
+    return false;
+  }
+
+  item.position.lat = position->lat;
+  item.position.lon = nmeaSpatialLongitude(position->lon);
+  nmeaSpatialVector(&item.position, &item.x, &item.y, &item.z);
+  item.id = id;
+  cell = nmeaSpatialCell(index, nmeaSpatialRow(index, item.position.lat),
+      nmeaSpatialColumn(index, item.position.lon));
+
+  i = nmeaSpatialTableGet(&index->ids, id);
+  if (i != NMEALIB_SPATIAL_NONE) {
+    NmeaSpatialEntry *entry = &index->entries[i];
+    NmeaSpatialBucket *bucket = &index->buckets[entry->bucket];
+
+    item.entry = i;
+    if (bucket->cell == cell) {
+      bucket->items[entry->slot] = item;
+      return true;
+    }
+
+    /* move to another cell */
+    b = nmeaSpatialBucketGet(index, cell, true);
+    if ((b == NMEALIB_SPATIAL_NONE) //
+        || !nmeaSpatialBucketReserve(&index->buckets[b])) {
+      /* can't be covered in a test */
+      if ((b != NMEALIB_SPATIAL_NONE) //
+          && !index->buckets[b].count) {
+        nmeaSpatialBucketRelease(index, b);
+      }
+      return false;
+    }
+
+    nmeaSpatialItemRemove(index, entry);
+    nmeaSpatialItemAppend(index, b, &item);
+    return true;
+  }
+
+  /* a new unit */
+  if (index->count == index->capacity) {
+    size_t capacity = index->capacity * 2;
+    NmeaSpatialEntry *entries = realloc(index->entries, capacity * sizeof(entries[0]));
+
+    if (!entries) {
+      /* can't be covered in a test */
+      return false;
+    }
+
+    index->entries = entries;
+    index->capacity = capacity;
+  }
+
+  b = nmeaSpatialBucketGet(index, cell, true);
+  if ((b == NMEALIB_SPATIAL_NONE) //
+      || !nmeaSpatialBucketReserve(&index->buckets[b]) //
+      || !nmeaSpatialTableSet(&index->ids, id, index->count)) {
+    /* can't be covered in a test */
+    if ((b != NMEALIB_SPATIAL_NONE) //
+        && !index->buckets[b].count) {
+      nmeaSpatialBucketRelease(index, b);
+    }
+    return false;
+  }
+
+  item.entry = index->count++;
+  nmeaSpatialItemAppend(index, b, &item);
+
+  return true;
+}
+
+bool nmeaSpatialUpdateInfo(NmeaSpatial *index, uint64_t id, const NmeaInfo *info) {
+  NmeaPosition position;
+
+  if (!info //
+      || !nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON)) {
+    return false;
+  }
+
+  nmeaMathInfoToPosition(info, &position);
+  return nmeaSpatialUpdate(index, id, &position);
+}
+
+bool nmeaSpatialRemove(NmeaSpatial *index, uint64_t id) {
+  size_t i;
+  size_t last;
+
+  if (!index) {
+    return false;
+  }
+
+  i = nmeaSpatialTableGet(&index->ids, id);
+  if (i == NMEALIB_SPATIAL_NONE) {
+    return false;
+  }
+
+  nmeaSpatialItemRemove(index, &index->entries[i]);
+  nmeaSpatialTableRemove(&index->ids, id);
+
+  /* move the last entry into the hole */
+  last = index->count - 1;
+  if (i != last) {
+    NmeaSpatialEntry *entry = &index->entries[i];
+    NmeaSpatialItem *item;
+
+    *entry = index->entries[last];
+    item = &index->buckets[entry->bucket].items[entry->slot];
+    item->entry = i;
+    nmeaSpatialTableSet(&index->ids, item->id, i);
+  }
+  index->count--;
+
+  return true;
+}
+
+bool nmeaSpatialGet(const NmeaSpatial *index, uint64_t id, NmeaPosition *position) {
+  const NmeaSpatialEntry *entry;
+  size_t i;
+
+  if (!index) {
+    return false;
+  }
+
+  i = nmeaSpatialTableGet(&index->ids, id);
+  if (i == NMEALIB_SPATIAL_NONE) {
+    return false;
+  }
+
+  entry = &index->entries[i];
+  if (position) {
+    *position = index->buckets[entry->bucket].items[entry->slot].position;
+  }
+
+  return true;
+}
+
+size_t nmeaSpatialNearest(const NmeaSpatial *index, const NmeaPosition *center, NmeaSpatialResult *results,
+    size_t k) {
+  NmeaSpatialQuery query;
+  NmeaPosition c;
+  size_t row;
+  size_t column;
+  size_t visited = 1;
+  size_t r = 0;
+  size_t i;
+
+  if (!index //
+      || !center //
+      || !results //
+      || !k //
+      || isNaN(center->lat) //
+      || isNaN(center->lon)) {
+    return 0;
+  }
+
+  memset(&query, 0, sizeof(query));
+  c.lat = MIN(MAX(center->lat, -NMEALIB_PI / 2.0), NMEALIB_PI / 2.0);
+  c.lon = nmeaSpatialLongitude(center->lon);
+  nmeaSpatialVector(&c, &query.x, &query.y, &query.z);
+  query.results = results;
+  query.capacity = k;
+
+  row = nmeaSpatialRow(index, c.lat);
+  column = nmeaSpatialColumn(index, c.lon);
+  nmeaSpatialVisitCells(index, row, column, 1, nmeaSpatialVisitNearest, &query);
+
+  /* search rings of cells until no unvisited cell can hold a nearer unit */
+  for (;;) {
+    double bound = nmeaSpatialRingBound(index, &c, row, column, r);
+
+    if (bound > NMEALIB_PI) {
+      break;
+    }
+
+    if ((query.count == k) //
+        && (results[0].distance <= nmeaSpatialAngleToChord2(bound))) {
+      break;
+    }
+
+    if (visited > index->count) {
+      /* scanning all units is cheaper than visiting more cells */
+      query.count = 0;
+      nmeaSpatialVisitAll(index, nmeaSpatialVisitNearest, &query);
+      break;
+    }
+
+    r++;
+    visited += nmeaSpatialVisitRing(index, row, column, r, nmeaSpatialVisitNearest, &query);
+  }
+
+  nmeaSpatialHeapSort(results, query.count);
+  for (i = 0; i < query.count; i++) {
+    results[i].distance = nmeaSpatialChord2ToDistance(results[i].distance);
+  }
+
+  return query.count;
+}
+
+size_t nmeaSpatialRadius(const NmeaSpatial *index, const NmeaPosition *center, double radius,
+    NmeaSpatialResult *results, size_t capacity) {
+  NmeaSpatialQuery query;
+  NmeaPosition c;
+  double angle;
+  double dLon = 2.0 * NMEALIB_PI;
+  double s;
+
+  if (!index //
+      || !center //
+      || (!results && capacity) //
+      || isNaN(center->lat) //
+      || isNaN(center->lon) //
+      || isNaN(radius) //
+      || (radius < 0.0)) {
+    return 0;
+  }
+
+  memset(&query, 0, sizeof(query));
+  c.lat = MIN(MAX(center->lat, -NMEALIB_PI / 2.0), NMEALIB_PI / 2.0);
+  c.lon = nmeaSpatialLongitude(center->lon);
+  nmeaSpatialVector(&c, &query.x, &query.y, &query.z);
+  angle = radius / NMEALIB_EARTHRADIUS_M;
+  query.limit = nmeaSpatialAngleToChord2(angle);
+  query.results = results;
+  query.capacity = capacity;
+
+  if (angle >= NMEALIB_PI) {
+    nmeaSpatialVisitAll(index, nmeaSpatialVisitRadius, &query);
+    return query.count;
+  }
+
+  /* the longitude range of the circle, when it doesn't hold a pole */
+  s = sin(angle);
+  if (((fabs(c.lat) + angle) < (NMEALIB_PI / 2.0)) //
+      && (s < cos(c.lat))) {
+    dLon = asin(s / cos(c.lat));
+  }
+
+  nmeaSpatialVisitRange(index, c.lat - angle, c.lat + angle, c.lon - dLon, c.lon + dLon, nmeaSpatialVisitRadius,
+      &query);
+
+  return query.count;
+}
+
+size_t nmeaSpatialBox(const NmeaSpatial *index, const NmeaPosition *southWest, const NmeaPosition *northEast,
+    uint64_t *ids, size_t capacity) {
+  NmeaSpatialQuery query;
+  double lonMax;
+
+  if (!index //
+      || !southWest //
+      || !northEast //
+      || (!ids && capacity) //
+      || isNaN(southWest->lat) //
+      || isNaN(southWest->lon) //
+      || isNaN(northEast->lat) //
+      || isNaN(northEast->lon) //
+      || (southWest->lat > northEast->lat)) {
+    return 0;
+  }
+
+  memset(&query, 0, sizeof(query));
+  query.latMin = southWest->lat;
+  query.latMax = northEast->lat;
+  query.ids = ids;
+  query.capacity = capacity;
+
+  if ((northEast->lon - southWest->lon) >= (2.0 * NMEALIB_PI)) {
+    query.lonMin = -NMEALIB_PI;
+    query.lonMax = NMEALIB_PI;
+  } else {
+    query.lonMin = nmeaSpatialLongitude(southWest->lon);
+    query.lonMax = nmeaSpatialLongitude(northEast->lon);
+  }
+
+  lonMax = query.lonMax;
+  if (lonMax < query.lonMin) {
+    lonMax += 2.0 * NMEALIB_PI;
+  }
+
+  nmeaSpatialVisitRange(index, query.latMin, query.latMax, query.lonMin, lonMax, nmeaSpatialVisitBox, &query);
+
+  return query.count;
+}
@@ -0,0 +1,548 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/stats.h>
+
+#include <nmealib/nmath.h>
+#include <nmealib/util.h>
+#include <math.h>
+#include <string.h>
+
+/** The semi-major axis of WGS84 */
+#define NMEALIB_STATS_A  ((double) NMEALIB_EARTHRADIUS_M)
+
+/** The first eccentricity squared of WGS84 */
+#define NMEALIB_STATS_E2 (NMEALIB_EARTH_FLATTENING * (2.0 - NMEALIB_EARTH_FLATTENING))
+
+/** The CEP of a bivariate normal distribution per sum of principal standard deviations */
+#define NMEALIB_STATS_CEP (0.5887)
+
+/*
+ * Helpers
+ */
+
+/**
+ * The index of the bucket of a value in a quantile sketch
+ *
+ * @param value The value, at least NMEALIB_SKETCH_MIN
+ * @return The index of the bucket, the last bucket for values above
+ * NMEALIB_SKETCH_MAX
+ */
+static INLINE size_t nmeaSketchBucket(double value) {
+  double bucket = floor(log(value / NMEALIB_SKETCH_MIN) / log(NMEALIB_SKETCH_GAMMA));
+
+  return (bucket < (double) (NMEALIB_SKETCH_BUCKETS - 1)) ?
+      (size_t) bucket :
+      (NMEALIB_SKETCH_BUCKETS - 1);
+}
+
+/**
+ * Get a DOP of a NmeaInfo structure as a plain DOP
+ *
+ * @param info The NmeaInfo structure
+ * @param dop The DOP, in the units of the NmeaInfo structure
+ * @return The plain DOP, NaN when it is not positive (and thus not known)
+ */
+static INLINE double nmeaStatsDop(const NmeaInfo *info, double dop) {
+  if (!(dop > 0.0)) {
+    return NaN;
+  }
+
+  return info->metric ?
+      nmeaMathMetersToDop(dop) :
+      dop;
+}
+
+/**
+ * Set the reference position of the frame of an accumulator
+ *
+ * @param stats The accumulator
+ * @param position The reference position (in radians)
+ */
+static void nmeaStatsReference(NmeaStats *stats, const NmeaPosition *position) {
+  double sinLat = sin(position->lat);
+  double w = 1.0 - (NMEALIB_STATS_E2 * sinLat * sinLat);
+  double n = NMEALIB_STATS_A / sqrt(w);
+
+  stats->referenced = true;
+  stats->reference = *position;
+  stats->eastScale = n * cos(position->lat);
+  stats->northScale = (n * (1.0 - NMEALIB_STATS_E2)) / w;
+}
+
+/**
+ * Get the offsets of a position in the frame of an accumulator
+ *
+ * @param stats The accumulator
+ * @param position The position (in radians)
+ * @param east The location in which to store the east offset, in meters
+ * @param north The location in which to store the north offset, in meters
+ */
+static INLINE void nmeaStatsOffsets(const NmeaStats *stats, const NmeaPosition *position, double *east,
+    double *north) {
+  *east = remainder(position->lon - stats->reference.lon, 2.0 * NMEALIB_PI) * stats->eastScale;
+  *north = (position->lat - stats->reference.lat) * stats->northScale;
+}
+
+/**
+ * Add a position to the moments of an accumulator
+ *
+ * @param stats The accumulator
+ * @param position The position (in radians)
+ */
+static void nmeaStatsAddPosition(NmeaStats *stats, const NmeaPosition *position) {
+  double east;
+  double north;
+  double dEast;
+  double dNorth;
+
+  if (!stats->referenced) {
+    nmeaStatsReference(stats, position);
+  }
+
+  nmeaStatsOffsets(stats, position, &east, &north);
+
+  stats->positions++;
+  dEast = east - stats->east;
+  dNorth = north - stats->north;
+  stats->east += dEast / (double) stats->positions;
+  stats->north += dNorth / (double) stats->positions;
+  stats->m2East += dEast * (east - stats->east);
+  stats->m2North += dNorth * (north - stats->north);
+  stats->cEastNorth += dEast * (north - stats->north);
+}
+
+/**
+ * Get the contributions of a NmeaInfo structure to an accumulator
+ *
+ * An epoch has a fix when its fix is 2D or 3D, or (without a fix) when its
+ * signal is valid.
+ *
+ * @param epoch The location in which to store the contributions
+ * @param info The NmeaInfo structure
+ */
+static void nmeaStatsEpochFromInfo(NmeaStatsEpoch *epoch, const NmeaInfo *info) {
+  size_t i;
+
+  epoch->timed = nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME);
+  epoch->time = epoch->timed ?
+      nmeaTimeToEpochNs(&info->utc) :
+      0;
+
+  epoch->fix = nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_FIX) ?
+      (info->fix >= NMEALIB_FIX_2D) :
+      (nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_SIG) //
+          && (info->sig != NMEALIB_SIG_INVALID));
+
+  epoch->positioned = false;
+  if (epoch->fix //
+      && nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON)) {
+    epoch->position.lat = info->metric ?
+        nmeaMathDegreeToRadian(info->latitude) :
+        nmeaMathNdegToRadian(info->latitude);
+    epoch->position.lon = info->metric ?
+        nmeaMathDegreeToRadian(info->longitude) :
+        nmeaMathNdegToRadian(info->longitude);
+    epoch->positioned = isfinite(epoch->position.lat) //
+        && isfinite(epoch->position.lon);
+  }
+
+  epoch->elevated = epoch->fix //
+      && nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_ELV) //
+      && (!nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_FIX) //
+          || (info->fix == NMEALIB_FIX_3D)) //
+      && isfinite(info->elevation);
+  epoch->elevation = info->elevation;
+
+  epoch->hdop = nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_HDOP) ?
+      nmeaStatsDop(info, info->hdop) :
+      NaN;
+  epoch->pdop = nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_PDOP) ?
+      nmeaStatsDop(info, info->pdop) :
+      NaN;
+  epoch->vdop = nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_VDOP) ?
+      nmeaStatsDop(info, info->vdop) :
+      NaN;
+
+  epoch->snrs = 0;
+  if (nmeaInfoIsPresentAll(info->present, NMEALIB_PRESENT_SATINVIEW)) {
+    for (i = 0; i < NMEALIB_MAX_SATELLITES; i++) {
+      const NmeaSatellite *satellite = &info->satellites.inView[i];
+
+      if (satellite->prn //
+          && satellite->snr) {
+        epoch->snr[epoch->snrs++] = satellite->snr;
+      }
+    }
+  }
+}
+
+/**
+ * Add an epoch to an accumulator
+ *
+ * @param stats The accumulator
+ * @param epoch The contributions of the epoch
+ */
+static void nmeaStatsAddEpoch(NmeaStats *stats, const NmeaStatsEpoch *epoch) {
+  size_t i;
+
+  if (epoch->timed) {
+    stats->timeFirst = stats->timed ?
+        MIN(stats->timeFirst, epoch->time) :
+        epoch->time;
+    stats->timeLast = stats->timed ?
+        MAX(stats->timeLast, epoch->time) :
+        epoch->time;
+    stats->timed++;
+  }
+
+  stats->epochs++;
+  if (epoch->fix) {
+    stats->fixes++;
+  }
+
+  if (epoch->positioned) {
+    nmeaStatsAddPosition(stats, &epoch->position);
+  }
+
+  if (epoch->elevated) {
+    double delta = epoch->elevation - stats->elevation;
+
+    stats->elevations++;
+    stats->elevation += delta / (double) stats->elevations;
+    stats->m2Elevation += delta * (epoch->elevation - stats->elevation);
+  }
+
+  nmeaSketchAdd(&stats->hdop, epoch->hdop);
+  nmeaSketchAdd(&stats->pdop, epoch->pdop);
+  nmeaSketchAdd(&stats->vdop, epoch->vdop);
+  for (i = 0; i < epoch->snrs; i++) {
+    nmeaSketchAdd(&stats->snr, epoch->snr[i]);
+  }
+}
+
+/**
+ * Combine the moments of 2 sets of values (Chan et al.)
+ *
+ * @param n The number of values of the first set
+ * @param mean The mean of the first set, replaced by the combined mean
+ * @param m2 The sum of squared deviations of the first set, replaced by the
+ * combined sum, may be NULL
+ * @param otherN The number of values of the second set
+ * @param otherMean The mean of the second set
+ * @param otherM2 The sum of squared deviations of the second set
+ * @return The difference of the means, weighted for the co-moments
+ */
+static double nmeaStatsCombine(uint64_t n, double *mean, double *m2, uint64_t otherN, double otherMean,
+    double otherM2) {
+  double total = (double) (n + otherN);
+  double delta = otherMean - *mean;
+
+  *mean += (delta * (double) otherN) / total;
+  if (m2) {
+    *m2 += otherM2 + ((delta * delta * (double) n * (double) otherN) / total);
+  }
+
+  return delta * sqrt(((double) n * (double) otherN) / total);
+}
+
+/*
+ * Public
+ */
+
+void nmeaSketchClear(NmeaSketch *sketch) {
+  if (!sketch) {
+    return;
+  }
+
+  memset(sketch, 0, sizeof(*sketch));
+  sketch->min = INFINITY;
+  sketch->max = -INFINITY;
+}
+
+void nmeaSketchAdd(NmeaSketch *sketch, double value) {
+  if (!sketch //
+      || !isfinite(value) //
+      || (value < 0.0)) {
+    return;
+  }
+
+  sketch->count++;
+  sketch->min = MIN(sketch->min, value);
+  sketch->max = MAX(sketch->max, value);
+
+  if (value < NMEALIB_SKETCH_MIN) {
+    sketch->low++;
+  } else {
+    sketch->buckets[nmeaSketchBucket(value)]++;
+  }
+}
+
+void nmeaSketchMerge(NmeaSketch *sketch, const NmeaSketch *other) {
+  size_t i;
+
+  if (!sketch //
+      || !other) {
+    return;
+  }
+
+  sketch->count += other->count;
+  sketch->low += other->low;
+  sketch->min = MIN(sketch->min, other->min);
+  sketch->max = MAX(sketch->max, other->max);
+  for (i = 0; i < NMEALIB_SKETCH_BUCKETS; i++) {
+    sketch->buckets[i] += other->buckets[i];
+  }
+}
+
+double nmeaSketchQuantile(const NmeaSketch *sketch, double q) {
+  double rank;
+  double seen;
+  double estimate;
+  size_t i;
+
+  if (!sketch //
+      || !sketch->count //
+      || !(q >= 0.0) //
+      || (q > 1.0)) {
+    return NaN;
+  }
+
+  /* the value of the given rank (counting from 0) */
+  rank = q * (double) (sketch->count - 1);
+
+  /* the extremes are known exactly */
+  seen = (double) sketch->low;
+  if ((rank < seen) //
+      || (rank <= 0.0)) {
+    return sketch->min;
+  }
+  if (rank >= (double) (sketch->count - 1)) {
+    return sketch->max;
+  }
+
+  for (i = 0; i < (NMEALIB_SKETCH_BUCKETS - 1); i++) {
+    seen += (double) sketch->buckets[i];
+    if (rank < seen) {
+      break;
+    }
+  }
+
+  /* the value with the smallest relative error to all values of the bucket */
+  estimate = (NMEALIB_SKETCH_MIN * pow(NMEALIB_SKETCH_GAMMA, (double) i) * 2.0 * NMEALIB_SKETCH_GAMMA)
+      / (1.0 + NMEALIB_SKETCH_GAMMA);
+
+  return MAX(sketch->min, MIN(estimate, sketch->max));
+}
+
+void nmeaStatsClear(NmeaStats *stats) {
+  if (!stats) {
+    return;
+  }
+
+  memset(stats, 0, sizeof(*stats));
+  nmeaSketchClear(&stats->hdop);
+  nmeaSketchClear(&stats->pdop);
+  nmeaSketchClear(&stats->vdop);
+  nmeaSketchClear(&stats->snr);
+}
+
+bool nmeaStatsAddInfo(NmeaStats *stats, const NmeaInfo *info) {
+  NmeaStatsEpoch epoch;
+
+  if (!stats //
+      || !info) {
+    return false;
+  }
+
+  nmeaStatsEpochFromInfo(&epoch, info);
+
+  /* a new version of the last epoch */
+  if (stats->pending //
+      && stats->epoch.timed //
+      && epoch.timed //
+      && (epoch.time == stats->epoch.time)) {
+    stats->epoch = epoch;
+    return false;
+  }
+
+  nmeaStatsFlush(stats);
+  stats->epoch = epoch;
+  stats->pending = true;
+
+  return true;
+}
+
+void nmeaStatsFlush(NmeaStats *stats) {
+  if (!stats //
+      || !stats->pending) {
+    return;
+  }
+
+  nmeaStatsAddEpoch(stats, &stats->epoch);
+  stats->pending = false;
+}
+
+void nmeaStatsMerge(NmeaStats *stats, const NmeaStats *other) {
+  if (!stats //
+      || !other //
+      || (stats == other)) {
+    return;
+  }
+
+  if (other->timed) {
+    stats->timeFirst = stats->timed ?
+        MIN(stats->timeFirst, other->timeFirst) :
+        other->timeFirst;
+    stats->timeLast = stats->timed ?
+        MAX(stats->timeLast, other->timeLast) :
+        other->timeLast;
+    stats->timed += other->timed;
+  }
+  stats->epochs += other->epochs;
+  stats->fixes += other->fixes;
+
+  if (other->positions) {
+    if (!stats->positions) {
+      stats->referenced = other->referenced;
+      stats->reference = other->reference;
+      stats->eastScale = other->eastScale;
+      stats->northScale = other->northScale;
+      stats->positions = other->positions;
+      stats->east = other->east;
+      stats->north = other->north;
+      stats->m2East = other->m2East;
+      stats->m2North = other->m2North;
+      stats->cEastNorth = other->cEastNorth;
+    } else {
+      NmeaPosition mean;
+      double east;
+      double north;
+      double dEast;
+      double dNorth;
+
+      /* the mean of the other accumulator in this frame */
+      nmeaStatsMean(other, &mean);
+      nmeaStatsOffsets(stats, &mean, &east, &north);
+
+      dEast = nmeaStatsCombine(stats->positions, &stats->east, &stats->m2East, other->positions, east,
+          other->m2East);
+      dNorth = nmeaStatsCombine(stats->positions, &stats->north, &stats->m2North, other->positions, north,
+          other->m2North);
+      stats->cEastNorth += other->cEastNorth + (dEast * dNorth);
+      stats->positions += other->positions;
+    }
+  }
+
+  if (other->elevations) {
+    nmeaStatsCombine(stats->elevations, &stats->elevation, &stats->m2Elevation, other->elevations,
+        other->elevation, other->m2Elevation);
+    stats->elevations += other->elevations;
+  }
+
+  nmeaSketchMerge(&stats->hdop, &other->hdop);
+  nmeaSketchMerge(&stats->pdop, &other->pdop);
+  nmeaSketchMerge(&stats->vdop, &other->vdop);
+  nmeaSketchMerge(&stats->snr, &other->snr);
+
+  if (other->pending) {
+    nmeaStatsAddEpoch(stats, &other->epoch);
+  }
+}
+
+bool nmeaStatsMean(const NmeaStats *stats, NmeaPosition *mean) {
+  if (!stats //
+      || !mean //
+      || !stats->positions) {
+    return false;
+  }
+
+  mean->lat = stats->reference.lat + (stats->north / stats->northScale);
+  mean->lon = stats->reference.lon + (stats->east / stats->eastScale);
+
+  return true;
+}
+
+bool nmeaStatsCovariance(const NmeaStats *stats, double *east, double *north, double *eastNorth) {
+  double n;
+
+  if (!stats //
+      || (stats->positions < 2)) {
+    return false;
+  }
+
+  n = (double) (stats->positions - 1);
+  if (east) {
+    *east = stats->m2East / n;
+  }
+  if (north) {
+    *north = stats->m2North / n;
+  }
+  if (eastNorth) {
+    *eastNorth = stats->cEastNorth / n;
+  }
+
+  return true;
+}
+
+double nmeaStatsCep(const NmeaStats *stats) {
+  double east;
+  double north;
+  double eastNorth;
+  double half;
+  double root;
+
+  if (!nmeaStatsCovariance(stats, &east, &north, &eastNorth)) {
+    return NaN;
+  }
+
+  /* the eigenvalues of the covariance matrix */
+  half = (east + north) / 2.0;
+  root = sqrt((((east - north) / 2.0) * ((east - north) / 2.0)) + (eastNorth * eastNorth));
+
+  return NMEALIB_STATS_CEP * (sqrt(half + root) + sqrt(MAX(half - root, 0.0)));
+}
+
+double nmeaStatsDrms2(const NmeaStats *stats) {
+  double east;
+  double north;
+
+  if (!nmeaStatsCovariance(stats, &east, &north, NULL)) {
+    return NaN;
+  }
+
+  return 2.0 * sqrt(east + north);
+}
+
+double nmeaStatsFixRate(const NmeaStats *stats) {
+  if (!stats //
+      || !stats->epochs) {
+    return NaN;
+  }
+
+  return (double) stats->fixes / (double) stats->epochs;
+}
+
+double nmeaStatsEpochRate(const NmeaStats *stats) {
+  if (!stats //
+      || (stats->timed < 2) //
+      || (stats->timeLast <= stats->timeFirst)) {
+    return NaN;
+  }
+
+  return ((double) (stats->timed - 1) * 1E9) / (double) (stats->timeLast - stats->timeFirst);
+}
@@ -0,0 +1,602 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/track.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The columns of a block */
+typedef enum _NmeaTrackColumnId {
+  NMEALIB_TRACK_COLUMN_TIME = 0,
+  NMEALIB_TRACK_COLUMN_PRESENT = 1,
+  NMEALIB_TRACK_COLUMN_SIGFIX = 2,
+  NMEALIB_TRACK_COLUMN_LAT = 3,
+  NMEALIB_TRACK_COLUMN_LON = 4,
+  NMEALIB_TRACK_COLUMN_ELV = 5,
+  NMEALIB_TRACK_COLUMN_SPEED = 6,
+  NMEALIB_TRACK_COLUMN_TRACK = 7,
+  NMEALIB_TRACK_COLUMN_HDOP = 8
+} NmeaTrackColumnId;
+
+/** The scale of latitude and longitude */
+#define NMEALIB_TRACK_SCALE_DEGREES (1E7)
+
+/** The scale of elevation, speed, track and hdop */
+#define NMEALIB_TRACK_SCALE_HUNDREDTHS (1E2)
+
+/** The maximum length of a varint */
+#define NMEALIB_TRACK_VARINT_MAX (10u)
+
+/*
+ * Encoding
+ */
+
+/** Map a signed value onto an unsigned value, small magnitudes first */
+static INLINE uint64_t nmeaTrackZigZag(int64_t v) {
+  return ((uint64_t) v << 1) ^ (0 - (uint64_t) (v < 0));
+}
+
+/** Reverse nmeaTrackZigZag */
+static INLINE int64_t nmeaTrackUnZigZag(uint64_t v) {
+  return (int64_t) ((v >> 1) ^ (0 - (v & 1)));
+}
+
+/** Determine the difference between two values, wrapping on overflow */
+static INLINE int64_t nmeaTrackDelta(int64_t v, int64_t previous) {
+  return (int64_t) ((uint64_t) v - (uint64_t) previous);
+}
+
+/** Reverse nmeaTrackDelta */
+static INLINE int64_t nmeaTrackUnDelta(int64_t delta, int64_t previous) {
+  return (int64_t) ((uint64_t) previous + (uint64_t) delta);
+}
+
+/** Convert a value to fixed-point */
+static INLINE int64_t nmeaTrackToFixed(double v, double scale) {
+  return (int64_t) llround(v * scale);
+}
+
+/**
+ * Append a varint to a column
+ *
+ * @param column The column
+ * @param v The value
+ * @return True on success, false when out of memory
+ */
+static bool nmeaTrackPutVarint(NmeaTrackColumn *column, uint64_t v) {
+  if ((column->size + NMEALIB_TRACK_VARINT_MAX) > column->capacity) {
+    size_t capacity = column->capacity ?
+        (column->capacity << 1) :
+        (NMEALIB_TRACK_BLOCK_SIZE >> 2);
+    uint8_t *data = realloc(column->data, capacity);
+    if (!data) {
+      /* can't be covered in a test */
+      return false;
+    }
+
+    column->data = data;
+    column->capacity = capacity;
+  }
+
+  while (v >= 0x80) {
+    column->data[column->size++] = (uint8_t) (v | 0x80);
+    v >>= 7;
+  }
+  column->data[column->size++] = (uint8_t) v;
+
+  return true;
+}
+
+/**
+ * Read a varint from a column
+ *
+ * @param column The column
+ * @param offset The offset in the column, updated
+ * @return The value
+ */
+static uint64_t nmeaTrackGetVarint(const NmeaTrackColumn *column, size_t *offset) {
+  uint64_t v = 0;
+  unsigned int shift = 0;
+  size_t i = *offset;
+
+  while ((i < column->size) //
+      && (shift < 64)) {
+    uint8_t c = column->data[i++];
+
+    v |= (uint64_t) (c & 0x7f) << shift;
+    if (!(c & 0x80)) {
+      break;
+    }
+
+    shift += 7;
+  }
+
+  *offset = i;
+  return v;
+}
+
+/**
+ * Append a delta encoded value to a column
+ *
+ * @param track The track
+ * @param column The column id
+ * @param v The value
+ * @return True on success, false when out of memory
+ */
+static bool nmeaTrackPutDelta(NmeaTrack *track, NmeaTrackColumnId column, int64_t v) {
+  NmeaTrackBlock *block = &track->blocks[track->blockCount - 1];
+
+  if (!nmeaTrackPutVarint(&block->columns[column], nmeaTrackZigZag(nmeaTrackDelta(v, track->values[column])))) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  track->values[column] = v;
+  return true;
+}
+
+/**
+ * Read a delta encoded value from a column
+ *
+ * @param iterator The iterator
+ * @param block The block
+ * @param column The column id
+ * @return The value
+ */
+static int64_t nmeaTrackGetDelta(NmeaTrackIterator *iterator, const NmeaTrackBlock *block, NmeaTrackColumnId column) {
+  int64_t delta = nmeaTrackUnZigZag(nmeaTrackGetVarint(&block->columns[column], &iterator->offsets[column]));
+
+  iterator->values[column] = nmeaTrackUnDelta(delta, iterator->values[column]);
+  return iterator->values[column];
+}
+
+/**
+ * Read a delta encoded value in hundredths from a column
+ *
+ * @param iterator The iterator
+ * @param block The block
+ * @param column The column id
+ * @return The value
+ */
+static float nmeaTrackGetHundredths(NmeaTrackIterator *iterator, const NmeaTrackBlock *block,
+    NmeaTrackColumnId column) {
+  int64_t v = nmeaTrackGetDelta(iterator, block, column);
+
+  return (float) ((double) v / NMEALIB_TRACK_SCALE_HUNDREDTHS);
+}
+
+/*
+ * Blocks
+ */
+
+/**
+ * Shrink the columns of a full block to their size
+ *
+ * @param block The block
+ */
+static void nmeaTrackBlockSeal(NmeaTrackBlock *block) {
+  size_t i;
+
+  for (i = 0; i < NMEALIB_TRACK_COLUMNS; i++) {
+    NmeaTrackColumn *column = &block->columns[i];
+
+    if (column->size //
+        && (column->size < column->capacity)) {
+      uint8_t *data = realloc(column->data, column->size);
+      if (data) {
+        column->data = data;
+        column->capacity = column->size;
+      }
+    }
+  }
+}
+
+/**
+ * Open a new block for appends
+ *
+ * @param track The track
+ * @return True on success, false when out of memory
+ */
+static bool nmeaTrackBlockOpen(NmeaTrack *track) {
+  if (track->blockCount == track->blockCapacity) {
+    size_t capacity = track->blockCapacity ?
+        (track->blockCapacity << 1) :
+        16;
+    NmeaTrackBlock *blocks = realloc(track->blocks, capacity * sizeof(*blocks));
+    if (!blocks) {
+      /* can't be covered in a test */
+      return false;
+    }
+
+    track->blocks = blocks;
+    track->blockCapacity = capacity;
+  }
+
+  if (track->blockCount) {
+    nmeaTrackBlockSeal(&track->blocks[track->blockCount - 1]);
+  }
+
+  memset(&track->blocks[track->blockCount], 0, sizeof(track->blocks[0]));
+  track->blockCount++;
+
+  /* every block is independently decodable */
+  memset(track->values, 0, sizeof(track->values));
+  track->delta = 0;
+
+  return true;
+}
+
+/*
+ * Track
+ */
+
+void nmeaTrackInit(NmeaTrack *track) {
+  if (!track) {
+    return;
+  }
+
+  memset(track, 0, sizeof(*track));
+}
+
+void nmeaTrackDestroy(NmeaTrack *track) {
+  size_t i;
+  size_t j;
+
+  if (!track) {
+    return;
+  }
+
+  for (i = 0; i < track->blockCount; i++) {
+    for (j = 0; j < NMEALIB_TRACK_COLUMNS; j++) {
+      free(track->blocks[i].columns[j].data);
+    }
+  }
+
+  free(track->blocks);
+  memset(track, 0, sizeof(*track));
+}
+
+bool nmeaTrackAppend(NmeaTrack *track, const NmeaRecord *record) {
+  NmeaTrackBlock *block;
+  uint32_t present;
+  int64_t delta;
+
+  if (!track //
+      || !record) {
+    return false;
+  }
+
+  if (track->count //
+      && (record->time < track->blocks[track->blockCount - 1].timeMax)) {
+    return false;
+  }
+
+  if (!track->blockCount //
+      || (track->blocks[track->blockCount - 1].count >= NMEALIB_TRACK_BLOCK_SIZE)) {
+    if (!nmeaTrackBlockOpen(track)) {
+      /* can't be covered in a test */
+      return false;
+    }
+  }
+
+  block = &track->blocks[track->blockCount - 1];
+  present = record->present & NMEALIB_TRACK_PRESENT_MASK;
+
+  /* time: delta-of-delta */
+  delta = nmeaTrackDelta(record->time, track->values[NMEALIB_TRACK_COLUMN_TIME]);
+  if (!nmeaTrackPutVarint(&block->columns[NMEALIB_TRACK_COLUMN_TIME],
+      nmeaTrackZigZag(nmeaTrackDelta(delta, track->delta)))) {
+    /* can't be covered in a test */
+    return false;
+  }
+  track->values[NMEALIB_TRACK_COLUMN_TIME] = record->time;
+  track->delta = delta;
+
+  /* present: XOR with the previous record */
+  if (!nmeaTrackPutVarint(&block->columns[NMEALIB_TRACK_COLUMN_PRESENT],
+      present ^ (uint64_t) track->values[NMEALIB_TRACK_COLUMN_PRESENT])) {
+    /* can't be covered in a test */
+    return false;
+  }
+  track->values[NMEALIB_TRACK_COLUMN_PRESENT] = present;
+
+  if (nmeaInfoIsPresentAny(present, NMEALIB_PRESENT_SIG | NMEALIB_PRESENT_FIX) //
+      && !nmeaTrackPutVarint(&block->columns[NMEALIB_TRACK_COLUMN_SIGFIX],
+          (uint64_t) (((record->sig & 0x0f) << 4) | (record->fix & 0x0f)))) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_LAT) //
+      && !nmeaTrackPutDelta(track, NMEALIB_TRACK_COLUMN_LAT,
+          nmeaTrackToFixed(record->latitude, NMEALIB_TRACK_SCALE_DEGREES))) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_LON) //
+      && !nmeaTrackPutDelta(track, NMEALIB_TRACK_COLUMN_LON,
+          nmeaTrackToFixed(record->longitude, NMEALIB_TRACK_SCALE_DEGREES))) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_ELV) //
+      && !nmeaTrackPutDelta(track, NMEALIB_TRACK_COLUMN_ELV,
+          nmeaTrackToFixed((double) record->elevation, NMEALIB_TRACK_SCALE_HUNDREDTHS))) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_SPEED) //
+      && !nmeaTrackPutDelta(track, NMEALIB_TRACK_COLUMN_SPEED,
+          nmeaTrackToFixed((double) record->speed, NMEALIB_TRACK_SCALE_HUNDREDTHS))) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_TRACK) //
+      && !nmeaTrackPutDelta(track, NMEALIB_TRACK_COLUMN_TRACK,
+          nmeaTrackToFixed((double) record->track, NMEALIB_TRACK_SCALE_HUNDREDTHS))) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_HDOP) //
+      && !nmeaTrackPutDelta(track, NMEALIB_TRACK_COLUMN_HDOP,
+          nmeaTrackToFixed((double) record->hdop, NMEALIB_TRACK_SCALE_HUNDREDTHS))) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  /* summary */
+
+  if (!block->count) {
+    block->timeMin = record->time;
+  }
+  block->timeMax = record->time;
+
+  if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON)) {
+    int64_t lat = track->values[NMEALIB_TRACK_COLUMN_LAT];
+    int64_t lon = track->values[NMEALIB_TRACK_COLUMN_LON];
+
+    if (!block->area) {
+      block->area = true;
+      block->latMin = block->latMax = lat;
+      block->lonMin = block->lonMax = lon;
+    } else {
+      if (lat < block->latMin) {
+        block->latMin = lat;
+      } else if (lat > block->latMax) {
+        block->latMax = lat;
+      }
+
+      if (lon < block->lonMin) {
+        block->lonMin = lon;
+      } else if (lon > block->lonMax) {
+        block->lonMax = lon;
+      }
+    }
+  }
+
+  block->count++;
+  track->count++;
+
+  return true;
+}
+
+bool nmeaTrackAppendInfo(NmeaTrack *track, const NmeaInfo *info) {
+  NmeaRecord record;
+
+  if (!nmeaRecordFromInfo(info, &record)) {
+    return false;
+  }
+
+  return nmeaTrackAppend(track, &record);
+}
+
+size_t nmeaTrackMemory(const NmeaTrack *track) {
+  size_t r;
+  size_t i;
+  size_t j;
+
+  if (!track) {
+    return 0;
+  }
+
+  r = sizeof(*track) + (track->blockCapacity * sizeof(track->blocks[0]));
+
+  for (i = 0; i < track->blockCount; i++) {
+    for (j = 0; j < NMEALIB_TRACK_COLUMNS; j++) {
+      r += track->blocks[i].columns[j].capacity;
+    }
+  }
+
+  return r;
+}
+
+/*
+ * Iterator
+ */
+
+void nmeaTrackIteratorInit(NmeaTrackIterator *iterator, const NmeaTrack *track, int64_t from, int64_t to) {
+  if (!iterator) {
+    return;
+  }
+
+  memset(iterator, 0, sizeof(*iterator));
+  iterator->track = track;
+  iterator->from = from;
+  iterator->to = to;
+}
+
+void nmeaTrackIteratorSetArea(NmeaTrackIterator *iterator, double latMin, double lonMin, double latMax,
+    double lonMax) {
+  if (!iterator) {
+    return;
+  }
+
+  iterator->area = true;
+  iterator->latMin = nmeaTrackToFixed(latMin, NMEALIB_TRACK_SCALE_DEGREES);
+  iterator->lonMin = nmeaTrackToFixed(lonMin, NMEALIB_TRACK_SCALE_DEGREES);
+  iterator->latMax = nmeaTrackToFixed(latMax, NMEALIB_TRACK_SCALE_DEGREES);
+  iterator->lonMax = nmeaTrackToFixed(lonMax, NMEALIB_TRACK_SCALE_DEGREES);
+}
+
+/**
+ * Determine whether a block can be skipped by an iterator
+ *
+ * @param iterator The iterator
+ * @param block The block
+ * @return True when no record of the block can match the iterator
+ */
+static bool nmeaTrackIteratorSkip(const NmeaTrackIterator *iterator, const NmeaTrackBlock *block) {
+  if (block->timeMax < iterator->from) {
+    return true;
+  }
+
+  if (!iterator->area) {
+    return false;
+  }
+
+  return !block->area //
+      || (block->latMax < iterator->latMin) //
+      || (block->latMin > iterator->latMax) //
+      || (block->lonMax < iterator->lonMin) //
+      || (block->lonMin > iterator->lonMax);
+}
+
+bool nmeaTrackIteratorNext(NmeaTrackIterator *iterator, NmeaRecord *record) {
+  const NmeaTrack *track;
+
+  if (!iterator //
+      || !iterator->track //
+      || !record) {
+    return false;
+  }
+
+  track = iterator->track;
+
+  while (iterator->block < track->blockCount) {
+    const NmeaTrackBlock *block = &track->blocks[iterator->block];
+    uint32_t present;
+    int64_t lat;
+    int64_t lon;
+
+    if (!iterator->index) {
+      if (block->timeMin > iterator->to) {
+        /* blocks are in chronological order */
+        iterator->block = track->blockCount;
+        return false;
+      }
+
+      if (nmeaTrackIteratorSkip(iterator, block)) {
+        iterator->block++;
+        continue;
+      }
+
+      memset(iterator->offsets, 0, sizeof(iterator->offsets));
+      memset(iterator->values, 0, sizeof(iterator->values));
+      iterator->delta = 0;
+    }
+
+    memset(record, 0, sizeof(*record));
+
+    iterator->delta = nmeaTrackUnDelta(
+        nmeaTrackUnZigZag(
+            nmeaTrackGetVarint(&block->columns[NMEALIB_TRACK_COLUMN_TIME],
+                &iterator->offsets[NMEALIB_TRACK_COLUMN_TIME])), iterator->delta);
+    iterator->values[NMEALIB_TRACK_COLUMN_TIME] = nmeaTrackUnDelta(iterator->delta,
+        iterator->values[NMEALIB_TRACK_COLUMN_TIME]);
+    record->time = iterator->values[NMEALIB_TRACK_COLUMN_TIME];
+
+    iterator->values[NMEALIB_TRACK_COLUMN_PRESENT] ^= (int64_t) nmeaTrackGetVarint(
+        &block->columns[NMEALIB_TRACK_COLUMN_PRESENT], &iterator->offsets[NMEALIB_TRACK_COLUMN_PRESENT]);
+    present = (uint32_t) iterator->values[NMEALIB_TRACK_COLUMN_PRESENT];
+    record->present = present;
+
+    if (nmeaInfoIsPresentAny(present, NMEALIB_PRESENT_SIG | NMEALIB_PRESENT_FIX)) {
+      uint64_t sigFix = nmeaTrackGetVarint(&block->columns[NMEALIB_TRACK_COLUMN_SIGFIX],
+          &iterator->offsets[NMEALIB_TRACK_COLUMN_SIGFIX]);
+
+      if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_SIG)) {
+        record->sig = (uint8_t) ((sigFix >> 4) & 0x0f);
+      }
+
+      if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_FIX)) {
+        record->fix = (uint8_t) (sigFix & 0x0f);
+      }
+    }
+
+    lat = nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_LAT) ?
+        nmeaTrackGetDelta(iterator, block, NMEALIB_TRACK_COLUMN_LAT) :
+        0;
+    lon = nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_LON) ?
+        nmeaTrackGetDelta(iterator, block, NMEALIB_TRACK_COLUMN_LON) :
+        0;
+    record->latitude = (double) lat / NMEALIB_TRACK_SCALE_DEGREES;
+    record->longitude = (double) lon / NMEALIB_TRACK_SCALE_DEGREES;
+
+    if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_ELV)) {
+      record->elevation = nmeaTrackGetHundredths(iterator, block, NMEALIB_TRACK_COLUMN_ELV);
+    }
+
+    if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_SPEED)) {
+      record->speed = nmeaTrackGetHundredths(iterator, block, NMEALIB_TRACK_COLUMN_SPEED);
+    }
+
+    if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_TRACK)) {
+      record->track = nmeaTrackGetHundredths(iterator, block, NMEALIB_TRACK_COLUMN_TRACK);
+    }
+
+    if (nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_HDOP)) {
+      record->hdop = nmeaTrackGetHundredths(iterator, block, NMEALIB_TRACK_COLUMN_HDOP);
+    }
+
+    iterator->index++;
+    if (iterator->index >= block->count) {
+      iterator->block++;
+      iterator->index = 0;
+    }
+
+    /* filter */
+
+    if (record->time < iterator->from) {
+      continue;
+    }
+
+    if (record->time > iterator->to) {
+      iterator->block = track->blockCount;
+      return false;
+    }
+
+    if (iterator->area //
+        && (!nmeaInfoIsPresentAll(present, NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON) //
+            || (lat < iterator->latMin) //
+            || (lat > iterator->latMax) //
+            || (lon < iterator->lonMin) //
+            || (lon > iterator->lonMax))) {
+      continue;
+    }
+
+    return true;
+  }
+
+  return false;
+}
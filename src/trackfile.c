@@ -0,0 +1,529 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmealib/trackfile.h>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/** The number of bytes of a record that are covered by its CRC */
+#define NMEALIB_TRACKFILE_CRC_OFFSET (NMEALIB_TRACKFILE_RECORD_SIZE - 4u)
+
+/*
+ * Encoding
+ */
+
+static INLINE void nmeaTrackFilePutU32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t) v;
+  p[1] = (uint8_t) (v >> 8);
+  p[2] = (uint8_t) (v >> 16);
+  p[3] = (uint8_t) (v >> 24);
+}
+
+static INLINE uint32_t nmeaTrackFileGetU32(const uint8_t *p) {
+  return (uint32_t) p[0] //
+      | ((uint32_t) p[1] << 8) //
+      | ((uint32_t) p[2] << 16) //
+      | ((uint32_t) p[3] << 24);
+}
+
+static INLINE void nmeaTrackFilePutU64(uint8_t *p, uint64_t v) {
+  nmeaTrackFilePutU32(p, (uint32_t) v);
+  nmeaTrackFilePutU32(&p[4], (uint32_t) (v >> 32));
+}
+
+static INLINE uint64_t nmeaTrackFileGetU64(const uint8_t *p) {
+  return (uint64_t) nmeaTrackFileGetU32(p) | ((uint64_t) nmeaTrackFileGetU32(&p[4]) << 32);
+}
+
+static INLINE void nmeaTrackFilePutDouble(uint8_t *p, double v) {
+  uint64_t u;
+
+  memcpy(&u, &v, sizeof(u));
+  nmeaTrackFilePutU64(p, u);
+}
+
+static INLINE double nmeaTrackFileGetDouble(const uint8_t *p) {
+  uint64_t u = nmeaTrackFileGetU64(p);
+  double v;
+
+  memcpy(&v, &u, sizeof(v));
+  return v;
+}
+
+static INLINE void nmeaTrackFilePutFloat(uint8_t *p, float v) {
+  uint32_t u;
+
+  memcpy(&u, &v, sizeof(u));
+  nmeaTrackFilePutU32(p, u);
+}
+
+static INLINE float nmeaTrackFileGetFloat(const uint8_t *p) {
+  uint32_t u = nmeaTrackFileGetU32(p);
+  float v;
+
+  memcpy(&v, &u, sizeof(v));
+  return v;
+}
+
+/**
+ * Calculate the CRC-32 (IEEE 802.3) of a buffer
+ *
+ * @param p The buffer
+ * @param sz The size of the buffer
+ * @return The CRC-32
+ */
+static uint32_t nmeaTrackFileCRC(const uint8_t *p, size_t sz) {
+  static const uint32_t table[16] = {
+      0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c, //
+      0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c };
+  uint32_t crc = 0xffffffff;
+  size_t i;
+
+  for (i = 0; i < sz; i++) {
+    crc ^= p[i];
+    crc = (crc >> 4) ^ table[crc & 0x0f];
+    crc = (crc >> 4) ^ table[crc & 0x0f];
+  }
+
+  return ~crc;
+}
+
+/**
+ * Encode a fix record, including its CRC
+ *
+ * @param record The fix record
+ * @param p The buffer, NMEALIB_TRACKFILE_RECORD_SIZE bytes
+ */
+static void nmeaTrackFileEncode(const NmeaRecord *record, uint8_t *p) {
+  memset(p, 0, NMEALIB_TRACKFILE_RECORD_SIZE);
+  nmeaTrackFilePutU64(&p[0], (uint64_t) record->time);
+  nmeaTrackFilePutDouble(&p[8], record->latitude);
+  nmeaTrackFilePutDouble(&p[16], record->longitude);
+  nmeaTrackFilePutFloat(&p[24], record->elevation);
+  nmeaTrackFilePutFloat(&p[28], record->speed);
+  nmeaTrackFilePutFloat(&p[32], record->track);
+  nmeaTrackFilePutFloat(&p[36], record->pdop);
+  nmeaTrackFilePutFloat(&p[40], record->hdop);
+  nmeaTrackFilePutFloat(&p[44], record->vdop);
+  nmeaTrackFilePutU32(&p[48], record->present);
+  p[52] = record->sig;
+  p[53] = record->fix;
+  nmeaTrackFilePutU32(&p[NMEALIB_TRACKFILE_CRC_OFFSET], nmeaTrackFileCRC(p, NMEALIB_TRACKFILE_CRC_OFFSET));
+}
+
+/**
+ * Determine whether an encoded record is valid
+ *
+ * @param p The encoded record
+ * @return True when the CRC of the record matches
+ */
+static bool nmeaTrackFileValid(const uint8_t *p) {
+  return nmeaTrackFileGetU32(&p[NMEALIB_TRACKFILE_CRC_OFFSET]) == nmeaTrackFileCRC(p, NMEALIB_TRACKFILE_CRC_OFFSET);
+}
+
+/*
+ * Mapping and indexing
+ */
+
+static INLINE const uint8_t *nmeaTrackFileRecord(const NmeaTrackFile *file, size_t index) {
+  return &file->map[NMEALIB_TRACKFILE_HEADER_SIZE + (index * NMEALIB_TRACKFILE_RECORD_SIZE)];
+}
+
+static INLINE int64_t nmeaTrackFileTime(const NmeaTrackFile *file, size_t index) {
+  return (int64_t) nmeaTrackFileGetU64(nmeaTrackFileRecord(file, index));
+}
+
+/**
+ * (Re)map all records of a track file
+ *
+ * @param file The track file
+ * @return True on success
+ */
+static bool nmeaTrackFileMap(NmeaTrackFile *file) {
+  size_t size = NMEALIB_TRACKFILE_HEADER_SIZE + (file->count * NMEALIB_TRACKFILE_RECORD_SIZE);
+  void *map;
+
+  if (file->map) {
+    munmap((void *) (uintptr_t) file->map, file->mapSize);
+    file->map = NULL;
+    file->mapSize = 0;
+  }
+
+  map = mmap(NULL, size, PROT_READ, MAP_SHARED, file->fd, 0);
+  if (map == MAP_FAILED) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  file->map = map;
+  file->mapSize = size;
+  return true;
+}
+
+/**
+ * Ensure that a record is mapped, remapping when the file has grown
+ *
+ * @param file The track file
+ * @param index The index of the record
+ * @return True when the record is mapped
+ */
+static INLINE bool nmeaTrackFileMapped(NmeaTrackFile *file, size_t index) {
+  return ((NMEALIB_TRACKFILE_HEADER_SIZE + ((index + 1) * NMEALIB_TRACKFILE_RECORD_SIZE)) <= file->mapSize) //
+      || nmeaTrackFileMap(file);
+}
+
+/**
+ * Skip the older versions of a fix
+ *
+ * @param file The track file, with all records mapped
+ * @param index The index of a record
+ * @return The index of the last record with the same time as the record
+ */
+static size_t nmeaTrackFileLastVersion(const NmeaTrackFile *file, size_t index) {
+  int64_t time = nmeaTrackFileTime(file, index);
+
+  while (((index + 1) < file->count) //
+      && (nmeaTrackFileTime(file, index + 1) == time)) {
+    index++;
+  }
+
+  return index;
+}
+
+static bool nmeaTrackFileIndexAdd(NmeaTrackFile *file, int64_t time) {
+  if (file->indexCount == file->indexCapacity) {
+    size_t capacity = file->indexCapacity ?
+        (file->indexCapacity << 1) :
+        64;
+    int64_t *index = realloc(file->index, capacity * sizeof(*index));
+    if (!index) {
+      /* can't be covered in a test */
+      return false;
+    }
+
+    file->index = index;
+    file->indexCapacity = capacity;
+  }
+
+  file->index[file->indexCount++] = time;
+  return true;
+}
+
+/**
+ * Determine the number of records from the size of a track file, map them and
+ * build the sparse time index
+ *
+ * @param file The track file
+ * @return True on success
+ */
+static bool nmeaTrackFileLoad(NmeaTrackFile *file) {
+  struct stat st;
+  size_t i;
+
+  if (fstat(file->fd, &st) //
+      || (st.st_size < (off_t) NMEALIB_TRACKFILE_HEADER_SIZE)) {
+    return false;
+  }
+
+  /* a partially written record at the end of the file is not a record */
+  file->count = ((size_t) st.st_size - NMEALIB_TRACKFILE_HEADER_SIZE) / NMEALIB_TRACKFILE_RECORD_SIZE;
+
+  if (!nmeaTrackFileMap(file)) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  if (file->writable) {
+    size_t count = file->count;
+
+    while (count //
+        && !nmeaTrackFileValid(nmeaTrackFileRecord(file, count - 1))) {
+      count--;
+    }
+
+    if ((count != file->count) //
+        || ((size_t) st.st_size != file->mapSize)) {
+      if (ftruncate(file->fd, (off_t) (NMEALIB_TRACKFILE_HEADER_SIZE + (count * NMEALIB_TRACKFILE_RECORD_SIZE)))) {
+        /* can't be covered in a test */
+        return false;
+      }
+
+      file->count = count;
+      if (!nmeaTrackFileMap(file)) {
+        /* can't be covered in a test */
+        return false;
+      }
+    }
+  }
+
+  file->indexCount = 0;
+  for (i = 0; i < file->count; i += NMEALIB_TRACKFILE_INDEX_STRIDE) {
+    if (!nmeaTrackFileIndexAdd(file, nmeaTrackFileTime(file, i))) {
+      /* can't be covered in a test */
+      return false;
+    }
+  }
+
+  file->lastTime = file->count ?
+      nmeaTrackFileTime(file, file->count - 1) :
+      0;
+
+  return true;
+}
+
+/*
+ * Track file
+ */
+
+bool nmeaTrackFileOpen(NmeaTrackFile *file, const char *path, bool writable) {
+  uint8_t header[NMEALIB_TRACKFILE_HEADER_SIZE];
+  struct stat st;
+
+  if (!file //
+      || !path) {
+    return false;
+  }
+
+  memset(file, 0, sizeof(*file));
+  file->writable = writable;
+
+  file->fd = open(path, writable ?
+      (O_RDWR | O_CREAT) :
+      O_RDONLY, 0644);
+  if (file->fd < 0) {
+    return false;
+  }
+
+  if (fstat(file->fd, &st)) {
+    /* can't be covered in a test */
+    goto err;
+  }
+
+  if (!st.st_size //
+      && writable) {
+    memset(header, 0, sizeof(header));
+    memcpy(header, NMEALIB_TRACKFILE_MAGIC, sizeof(NMEALIB_TRACKFILE_MAGIC));
+    nmeaTrackFilePutU32(&header[8], NMEALIB_TRACKFILE_VERSION);
+    nmeaTrackFilePutU32(&header[12], NMEALIB_TRACKFILE_RECORD_SIZE);
+
+    if (pwrite(file->fd, header, sizeof(header), 0) != (ssize_t) sizeof(header)) {
+      /* can't be covered in a test */
+      goto err;
+    }
+  }
+
+  if ((pread(file->fd, header, sizeof(header), 0) != (ssize_t) sizeof(header)) //
+      || memcmp(header, NMEALIB_TRACKFILE_MAGIC, sizeof(NMEALIB_TRACKFILE_MAGIC)) //
+      || (nmeaTrackFileGetU32(&header[8]) != NMEALIB_TRACKFILE_VERSION) //
+      || (nmeaTrackFileGetU32(&header[12]) != NMEALIB_TRACKFILE_RECORD_SIZE)) {
+    goto err;
+  }
+
+  if (!nmeaTrackFileLoad(file)) {
+    /* can't be covered in a test */
+    goto err;
+  }
+
+  return true;
+
+err:
+  nmeaTrackFileClose(file);
+  return false;
+}
+
+bool nmeaTrackFileClose(NmeaTrackFile *file) {
+  bool r = true;
+
+  if (!file) {
+    return false;
+  }
+
+  if (file->map) {
+    munmap((void *) (uintptr_t) file->map, file->mapSize);
+  }
+
+  if (file->fd >= 0) {
+    r = !close(file->fd);
+  }
+
+  free(file->index);
+  memset(file, 0, sizeof(*file));
+  file->fd = -1;
+
+  return r;
+}
+
+bool nmeaTrackFileAppend(NmeaTrackFile *file, const NmeaRecord *record) {
+  uint8_t buffer[NMEALIB_TRACKFILE_RECORD_SIZE];
+
+  if (!file //
+      || (file->fd < 0) //
+      || !file->writable //
+      || !record //
+      || (file->count && (record->time < file->lastTime))) {
+    return false;
+  }
+
+  /* a new version of the last fix is appended too, so that no committed record is ever overwritten */
+  nmeaTrackFileEncode(record, buffer);
+
+  if (pwrite(file->fd, buffer, sizeof(buffer),
+      (off_t) (NMEALIB_TRACKFILE_HEADER_SIZE + (file->count * NMEALIB_TRACKFILE_RECORD_SIZE))) //
+      != (ssize_t) sizeof(buffer)) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  if (!(file->count % NMEALIB_TRACKFILE_INDEX_STRIDE) //
+      && !nmeaTrackFileIndexAdd(file, record->time)) {
+    /* can't be covered in a test */
+    return false;
+  }
+
+  file->count++;
+  file->lastTime = record->time;
+
+  return true;
+}
+
+bool nmeaTrackFileAppendInfo(NmeaTrackFile *file, const NmeaInfo *info) {
+  NmeaRecord record;
+
+  if (!nmeaRecordFromInfo(info, &record)) {
+    return false;
+  }
+
+  return nmeaTrackFileAppend(file, &record);
+}
+
+bool nmeaTrackFileSync(NmeaTrackFile *file) {
+  if (!file //
+      || (file->fd < 0) //
+      || !file->writable) {
+    return false;
+  }
+
+  return !fdatasync(file->fd);
+}
+
+bool nmeaTrackFileRefresh(NmeaTrackFile *file) {
+  if (!file //
+      || (file->fd < 0)) {
+    return false;
+  }
+
+  return nmeaTrackFileLoad(file);
+}
+
+bool nmeaTrackFileGet(NmeaTrackFile *file, size_t index, NmeaRecord *record) {
+  const uint8_t *p;
+
+  if (!file //
+      || !record //
+      || (index >= file->count) //
+      || !nmeaTrackFileMapped(file, index)) {
+    return false;
+  }
+
+  p = nmeaTrackFileRecord(file, index);
+  if (!nmeaTrackFileValid(p)) {
+    return false;
+  }
+
+  memset(record, 0, sizeof(*record));
+  record->time = (int64_t) nmeaTrackFileGetU64(&p[0]);
+  record->latitude = nmeaTrackFileGetDouble(&p[8]);
+  record->longitude = nmeaTrackFileGetDouble(&p[16]);
+  record->elevation = nmeaTrackFileGetFloat(&p[24]);
+  record->speed = nmeaTrackFileGetFloat(&p[28]);
+  record->track = nmeaTrackFileGetFloat(&p[32]);
+  record->pdop = nmeaTrackFileGetFloat(&p[36]);
+  record->hdop = nmeaTrackFileGetFloat(&p[40]);
+  record->vdop = nmeaTrackFileGetFloat(&p[44]);
+  record->present = nmeaTrackFileGetU32(&p[48]);
+  record->sig = p[52];
+  record->fix = p[53];
+
+  return true;
+}
+
+size_t nmeaTrackFileSeek(NmeaTrackFile *file, int64_t time) {
+  size_t low = 0;
+  size_t high;
+
+  if (!file //
+      || !file->count //
+      || !nmeaTrackFileMapped(file, file->count - 1)) {
+    return 0;
+  }
+
+  /* the first index entry that is not older than the time */
+  high = file->indexCount;
+  while (low < high) {
+    size_t middle = low + ((high - low) >> 1);
+
+    if (file->index[middle] < time) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  /* the record lies in <(low - 1) * stride, low * stride] */
+  high = (low < file->indexCount) ?
+      (low * NMEALIB_TRACKFILE_INDEX_STRIDE) :
+      file->count;
+  low = low ?
+      (((low - 1) * NMEALIB_TRACKFILE_INDEX_STRIDE) + 1) :
+      0;
+
+  while (low < high) {
+    size_t middle = low + ((high - low) >> 1);
+
+    if (nmeaTrackFileTime(file, middle) < time) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  return (low < file->count) ?
+      nmeaTrackFileLastVersion(file, low) :
+      low;
+}
+
+size_t nmeaTrackFileNext(NmeaTrackFile *file, size_t index) {
+  if (!file //
+      || (index >= file->count) //
+      || !nmeaTrackFileMapped(file, file->count - 1)) {
+    return file ?
+        file->count :
+        0;
+  }
+
+  index = nmeaTrackFileLastVersion(file, index) + 1;
+
+  return (index < file->count) ?
+      nmeaTrackFileLastVersion(file, index) :
+      file->count;
+}
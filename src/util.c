@@ -18,18 +18,22 @@
 #include <nmealib/util.h>
 
 #include <nmealib/context.h>
+#include <nmealib/format.h>
+#include <nmealib/random.h>
 #include <ctype.h>
 #include <errno.h>
-#include <fcntl.h>
 #include <limits.h>
 #include <math.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#ifndef WIN32
-# include <unistd.h>
+
+#ifndef NMEALIB_NO_SSE2
+  #if defined(__SSE2__) || defined(_M_X64)
+    #define NMEALIB_UTIL_SSE2
+    #include <emmintrin.h>
+  #endif
 #endif
 
 
@@ -37,39 +41,11 @@
 #define NMEALIB_CONVSTR_BUF    64
 
 void nmeaRandomInit(void) {
-#ifdef WIN32
-  srand((unsigned int) time(NULL));
-#else
-  srandom((unsigned int) time(NULL));
-#endif
+  nmeaRandomSeedEntropy(nmeaRandomThreadState());
 }
 
 double nmeaRandom(const double min, const double max) {
-  long value;
-  int randomFile;
-  double range = fabs(max - min);
-
-  randomFile = open("/dev/urandom", O_RDONLY);
-  if (randomFile == -1) {
-    /* can't be covered in a test */
-    randomFile = open("/dev/random", O_RDONLY);
-  }
-
-  if ((randomFile == -1) //
-      || (read(randomFile, &value, sizeof(value)) != sizeof(value))) {
-    /* can't be covered in a test */
-#ifdef WIN32
-    value = rand();
-#else
-    value = random();
-#endif
-  }
-
-  if (randomFile != -1) {
-    close(randomFile);
-  }
-
-  return min + ((fabs((double) value) * range) / (double) LONG_MAX);
+  return nmeaRandomDouble(nmeaRandomThreadState(), min, min + fabs(max - min));
 }
 
 size_t nmeaStringTrim(const char **s) {
@@ -114,6 +90,35 @@ bool nmeaStringContainsWhitespace(const char *s, size_t sz) {
   return false;
 }
 
+#ifdef NMEALIB_UTIL_SSE2
+
+/**
+ * XOR the blocks of 16 characters of a string
+ *
+ * @param s The string, need not be aligned
+ * @param sz The length of the string
+ * @param i The location of the index of the first character, set to the index
+ * of the remaining characters
+ * @return The XOR of the characters of the blocks
+ */
+static int nmeaCalculateCRCBlocks(const char *s, const size_t sz, size_t *i) {
+  __m128i crc = _mm_setzero_si128();
+
+  for (; (*i + 16) <= sz; *i += 16) {
+    crc = _mm_xor_si128(crc, _mm_loadu_si128((const __m128i *) (const void *) &s[*i]));
+  }
+
+  /* fold the 16 bytes into 1 */
+  crc = _mm_xor_si128(crc, _mm_srli_si128(crc, 8));
+  crc = _mm_xor_si128(crc, _mm_srli_si128(crc, 4));
+  crc = _mm_xor_si128(crc, _mm_srli_si128(crc, 2));
+  crc = _mm_xor_si128(crc, _mm_srli_si128(crc, 1));
+
+  return (_mm_cvtsi128_si32(crc) & 0xff);
+}
+
+#endif /* NMEALIB_UTIL_SSE2 */
+
 unsigned int nmeaCalculateCRC(const char *s, const size_t sz) {
   size_t i = 0;
   int crc = 0;
@@ -127,6 +132,10 @@ unsigned int nmeaCalculateCRC(const char *s, const size_t sz) {
     i++;
   }
 
+#ifdef NMEALIB_UTIL_SSE2
+  crc = nmeaCalculateCRCBlocks(s, sz, &i);
+#endif /* NMEALIB_UTIL_SSE2 */
+
   for (; i < sz; i++) {
     crc ^= (int) s[i];
   }
@@ -249,11 +258,20 @@ int nmeaAppendChecksum(char *s, size_t sz, size_t len) {
 #define dst       (&s[len])
 #define available ((sz <= len) ? 0 : (sz - len))
 
+  char trailer[NMEALIB_CHECKSUM_LENGTH + 1];
+
   if (!s) {
     return 0;
   }
 
-  return snprintf(dst, available, "*%02X\r\n", nmeaCalculateCRC(s, len));
+  if (len >= sz) {
+    /* the string was truncated, don't read beyond the buffer */
+    return (int) NMEALIB_CHECKSUM_LENGTH;
+  }
+
+  nmeaFormatChecksum(trailer, nmeaCalculateCRC(s, len));
+  trailer[NMEALIB_CHECKSUM_LENGTH] = '\0';
+  return nmeaFormatString(dst, available, trailer);
 
 #undef available
 #undef dst
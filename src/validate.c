@@ -19,6 +19,13 @@
 
 #include <nmealib/context.h>
 
+#ifndef NMEALIB_NO_SSE2
+  #if defined(__SSE2__) || defined(_M_X64)
+    #define NMEALIB_VALIDATE_SSE2
+    #include <emmintrin.h>
+  #endif
+#endif
+
 /** Invalid NMEA character: non-ASCII */
 static const NmeaInvalidCharacter nmealibInvalidNonAsciiCharsName = {
     .character = '*', //
@@ -76,6 +83,52 @@ const NmeaInvalidCharacter *nmeaValidateIsInvalidCharacter(const char c) {
   return NULL;
 }
 
+#ifdef NMEALIB_VALIDATE_SSE2
+
+/** The number of characters in nmealibInvalidCharacters, without the sentinel */
+#define NMEALIB_VALIDATE_INVALID_CHARACTERS ((sizeof(nmealibInvalidCharacters) / sizeof(nmealibInvalidCharacters[0])) - 1)
+
+/**
+ * Skip the blocks of 16 characters without invalid characters
+ *
+ * The characters of a block are classified with compares on all 16 at once:
+ * below 32 (which includes the non-ASCII characters, they are negative as
+ * signed bytes), 127, or one of the characters of nmealibInvalidCharacters.
+ *
+ * @param s The string, need not be aligned
+ * @param sz The length of the string
+ * @return The index of the first block with invalid characters, or of the
+ * remaining characters when there is no such block
+ */
+static size_t nmeaValidateSkipValidBlocks(const char *s, const size_t sz) {
+  __m128i characters[NMEALIB_VALIDATE_INVALID_CHARACTERS];
+  __m128i low = _mm_set1_epi8(32);
+  __m128i del = _mm_set1_epi8(127);
+  size_t i;
+  size_t j;
+
+  for (j = 0; j < NMEALIB_VALIDATE_INVALID_CHARACTERS; j++) {
+    characters[j] = _mm_set1_epi8(nmealibInvalidCharacters[j].character);
+  }
+
+  for (i = 0; (i + 16) <= sz; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *) (const void *) &s[i]);
+    __m128i invalid = _mm_or_si128(_mm_cmplt_epi8(v, low), _mm_cmpeq_epi8(v, del));
+
+    for (j = 0; j < NMEALIB_VALIDATE_INVALID_CHARACTERS; j++) {
+      invalid = _mm_or_si128(invalid, _mm_cmpeq_epi8(v, characters[j]));
+    }
+
+    if (_mm_movemask_epi8(invalid)) {
+      break;
+    }
+  }
+
+  return i;
+}
+
+#endif /* NMEALIB_VALIDATE_SSE2 */
+
 const NmeaInvalidCharacter *nmeaValidateSentenceHasInvalidCharacters(const char *s, const size_t sz) {
   size_t i = 0;
 
@@ -84,7 +137,12 @@ const NmeaInvalidCharacter *nmeaValidateSentenceHasInvalidCharacters(const char
     return NULL;
   }
 
-  for (i = 0; i < sz; i++) {
+#ifdef NMEALIB_VALIDATE_SSE2
+  /* the first invalid character is found below */
+  i = nmeaValidateSkipValidBlocks(s, sz);
+#endif /* NMEALIB_VALIDATE_SSE2 */
+
+  for (; i < sz; i++) {
     const NmeaInvalidCharacter *invalid = nmeaValidateIsInvalidCharacter(s[i]);
     if (invalid) {
       return invalid;
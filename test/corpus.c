@@ -0,0 +1,260 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/corpus.h>
+#include <nmealib/parser.h>
+#include <nmealib/util.h>
+#include <CUnit/Basic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+int corpusSuiteSetup(void);
+
+#define CORPUS_FIXES (200u)
+
+/*
+ * Helpers
+ */
+
+static void corpusConfig(NmeaCorpusConfig *config) {
+  memset(config, 0, sizeof(*config));
+  config->type = NMEALIB_GENERATOR_ROTATE;
+  config->mask = NMEALIB_SENTENCE_MASK;
+  config->seed = 7;
+}
+
+static size_t corpusParse(const NmeaMallocedBuffer *buf, size_t length, size_t parserSize) {
+  NmeaParser parser;
+  NmeaInfo info;
+  size_t parsed;
+
+  memset(&info, 0, sizeof(info));
+  CU_ASSERT_EQUAL_FATAL(nmeaParserInit(&parser, parserSize), true);
+  parsed = nmeaParserParse(&parser, buf->buffer, length, &info);
+  nmeaParserDestroy(&parser);
+
+  return parsed;
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaCorpusConfigGarbage(void) {
+  NmeaCorpusConfig config;
+
+  nmeaCorpusConfigGarbage(NULL, 0.5);
+
+  corpusConfig(&config);
+  nmeaCorpusConfigGarbage(&config, 0.5);
+  CU_ASSERT_DOUBLE_EQUAL(config.truncateRate, 0.1, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(config.bitFlipRate, 0.1, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(config.checksumRate, 0.1, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(config.hexRate, 0.1, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(config.overlongRate, 0.1, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(config.noiseRate, 0.5, 1E-12);
+  CU_ASSERT_EQUAL(config.seed, 7);
+
+  nmeaCorpusConfigGarbage(&config, 2.0);
+  CU_ASSERT_DOUBLE_EQUAL(config.truncateRate, 0.2, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(config.noiseRate, 1.0, 1E-12);
+
+  nmeaCorpusConfigGarbage(&config, -1.0);
+  CU_ASSERT_DOUBLE_EQUAL(config.overlongRate, 0.0, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(config.noiseRate, 0.0, 1E-12);
+}
+
+static void test_nmeaCorpusGenerate(void) {
+  NmeaMallocedBuffer buf;
+  NmeaMallocedBuffer other;
+  NmeaCorpusConfig config;
+  NmeaCorpusStats stats;
+  size_t length;
+
+  memset(&buf, 0, sizeof(buf));
+  memset(&other, 0, sizeof(other));
+  corpusConfig(&config);
+
+  /* invalid inputs */
+
+  length = nmeaCorpusGenerate(NULL, CORPUS_FIXES, &buf, &stats);
+  CU_ASSERT_EQUAL(length, 0);
+  CU_ASSERT_EQUAL(stats.sentences, 0);
+
+  length = nmeaCorpusGenerate(&config, 0, &buf, &stats);
+  CU_ASSERT_EQUAL(length, 0);
+
+  length = nmeaCorpusGenerate(&config, CORPUS_FIXES, NULL, &stats);
+  CU_ASSERT_EQUAL(length, 0);
+
+  buf.bufferSize = 1;
+  length = nmeaCorpusGenerate(&config, CORPUS_FIXES, &buf, &stats);
+  CU_ASSERT_EQUAL(length, 0);
+  buf.bufferSize = 0;
+
+  config.mask = 0;
+  length = nmeaCorpusGenerate(&config, CORPUS_FIXES, &buf, &stats);
+  CU_ASSERT_EQUAL(length, 0);
+
+  corpusConfig(&config);
+  config.type = NMEALIB_GENERATOR_LAST + 1;
+  length = nmeaCorpusGenerate(&config, CORPUS_FIXES, &buf, &stats);
+  CU_ASSERT_EQUAL(length, 0);
+
+  /* a clean corpus parses completely */
+
+  corpusConfig(&config);
+  length = nmeaCorpusGenerate(&config, CORPUS_FIXES, &buf, &stats);
+  CU_ASSERT_EQUAL_FATAL(length > 0, true);
+  CU_ASSERT_EQUAL(stats.fixes, CORPUS_FIXES);
+  CU_ASSERT_EQUAL(stats.sentences > CORPUS_FIXES, true);
+  CU_ASSERT_EQUAL(stats.intact, stats.sentences);
+  CU_ASSERT_EQUAL(stats.noiseBlocks, 0);
+  CU_ASSERT_EQUAL(stats.bytes, length);
+  CU_ASSERT_EQUAL(corpusParse(&buf, length, 0), stats.sentences);
+
+  /* without statistics */
+
+  CU_ASSERT_EQUAL(nmeaCorpusGenerate(&config, CORPUS_FIXES, &other, NULL), length);
+
+  /* reproducible */
+
+  nmeaCorpusConfigGarbage(&config, 0.5);
+  length = nmeaCorpusGenerate(&config, CORPUS_FIXES, &buf, &stats);
+  CU_ASSERT_EQUAL(nmeaCorpusGenerate(&config, CORPUS_FIXES, &other, NULL), length);
+  CU_ASSERT_EQUAL(memcmp(buf.buffer, other.buffer, length), 0);
+
+  CU_ASSERT_EQUAL(stats.intact + stats.truncated + stats.bitFlipped + stats.checksums + stats.badHex + stats.overlong,
+      stats.sentences);
+  CU_ASSERT_EQUAL(stats.truncated > 0, true);
+  CU_ASSERT_EQUAL(stats.bitFlipped > 0, true);
+  CU_ASSERT_EQUAL(stats.checksums > 0, true);
+  CU_ASSERT_EQUAL(stats.badHex > 0, true);
+  CU_ASSERT_EQUAL(stats.overlong > 0, true);
+  CU_ASSERT_EQUAL(stats.noiseBlocks > 0, true);
+  CU_ASSERT_EQUAL(stats.noiseBytes >= stats.noiseBlocks, true);
+  CU_ASSERT_EQUAL(stats.noiseBytes <= (stats.noiseBlocks * NMEALIB_CORPUS_NOISE_MAX_DEFAULT), true);
+
+  /* only the intact sentences are recovered */
+  CU_ASSERT_EQUAL(corpusParse(&buf, length, 0), stats.intact);
+
+  /* another seed */
+
+  config.seed++;
+  length = nmeaCorpusGenerate(&config, CORPUS_FIXES, &other, NULL);
+  CU_ASSERT_EQUAL(memcmp(buf.buffer, other.buffer, MIN(length, stats.bytes)) != 0, true);
+
+  free(buf.buffer);
+  free(other.buffer);
+}
+
+static void test_nmeaCorpusMutations(void) {
+  NmeaMallocedBuffer buf;
+  NmeaCorpusConfig config;
+  NmeaCorpusStats stats;
+  size_t length;
+  size_t clean;
+
+  memset(&buf, 0, sizeof(buf));
+
+  corpusConfig(&config);
+  clean = nmeaCorpusGenerate(&config, CORPUS_FIXES, &buf, NULL);
+
+  /* every mutation on its own makes every sentence unparsable */
+
+  corpusConfig(&config);
+  config.truncateRate = 1.0;
+  length = nmeaCorpusGenerate(&config, CORPUS_FIXES, &buf, &stats);
+  CU_ASSERT_EQUAL(stats.truncated, stats.sentences);
+  CU_ASSERT_EQUAL(stats.intact, 0);
+  CU_ASSERT_EQUAL(length < clean, true);
+  CU_ASSERT_EQUAL(memchr(buf.buffer, '\n', length), NULL);
+  CU_ASSERT_EQUAL(corpusParse(&buf, length, 0), 0);
+
+  corpusConfig(&config);
+  config.bitFlipRate = 1.0;
+  length = nmeaCorpusGenerate(&config, CORPUS_FIXES, &buf, &stats);
+  CU_ASSERT_EQUAL(stats.bitFlipped, stats.sentences);
+  CU_ASSERT_EQUAL(length, clean);
+  CU_ASSERT_EQUAL(corpusParse(&buf, length, 0), 0);
+
+  corpusConfig(&config);
+  config.checksumRate = 1.0;
+  length = nmeaCorpusGenerate(&config, CORPUS_FIXES, &buf, &stats);
+  CU_ASSERT_EQUAL(stats.checksums, stats.sentences);
+  CU_ASSERT_EQUAL(length, clean);
+  CU_ASSERT_EQUAL(corpusParse(&buf, length, 0), 0);
+
+  corpusConfig(&config);
+  config.hexRate = 1.0;
+  length = nmeaCorpusGenerate(&config, CORPUS_FIXES, &buf, &stats);
+  CU_ASSERT_EQUAL(stats.badHex, stats.sentences);
+  CU_ASSERT_EQUAL(length, clean);
+  CU_ASSERT_EQUAL(corpusParse(&buf, length, 0), 0);
+
+  corpusConfig(&config);
+  config.overlongRate = 1.0;
+  length = nmeaCorpusGenerate(&config, CORPUS_FIXES, &buf, &stats);
+  CU_ASSERT_EQUAL(stats.overlong, stats.sentences);
+  CU_ASSERT_EQUAL(length > (stats.sentences * NMEALIB_PARSER_SENTENCE_SIZE), true);
+  CU_ASSERT_EQUAL(corpusParse(&buf, length, 0), 0);
+
+  /* a configurable overlong length */
+
+  config.overlongLength = 100;
+  length = nmeaCorpusGenerate(&config, CORPUS_FIXES, &buf, &stats);
+  CU_ASSERT_EQUAL(length < (stats.sentences * 120), true);
+  CU_ASSERT_EQUAL(corpusParse(&buf, length, 100), 0);
+
+  /* noise between the sentences doesn't affect them */
+
+  corpusConfig(&config);
+  config.noiseRate = 1.0;
+  config.noiseMax = 16;
+  length = nmeaCorpusGenerate(&config, CORPUS_FIXES, &buf, &stats);
+  CU_ASSERT_EQUAL(stats.intact, stats.sentences);
+  CU_ASSERT_EQUAL(stats.noiseBlocks, stats.sentences);
+  CU_ASSERT_EQUAL(stats.noiseBytes <= (stats.sentences * 16), true);
+  CU_ASSERT_EQUAL(length, clean + stats.noiseBytes);
+  CU_ASSERT_EQUAL(corpusParse(&buf, length, 0), stats.sentences);
+
+  free(buf.buffer);
+}
+
+/*
+ * Setup
+ */
+
+int corpusSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("corpus", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaCorpusConfigGarbage", test_nmeaCorpusConfigGarbage)) //
+      || (!CU_add_test(pSuite, "nmeaCorpusGenerate", test_nmeaCorpusGenerate)) //
+      || (!CU_add_test(pSuite, "nmeaCorpusGenerate (mutations)", test_nmeaCorpusMutations)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
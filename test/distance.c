@@ -0,0 +1,205 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/distance.h>
+#include <nmealib/nmath.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+int distanceSuiteSetup(void);
+
+/* more than 2 blocks, not a multiple of the block size */
+#define DISTANCE_COUNT (150u)
+
+/*
+ * Helpers
+ */
+
+static void distancePositions(NmeaPosition *positions, size_t count, double scale) {
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    positions[i].lat = nmeaMathDegreeToRadian(scale * sin((double) i * 0.7) * 80.0);
+    positions[i].lon = nmeaMathDegreeToRadian(scale * cos((double) i * 1.3) * 179.0);
+  }
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaDistanceOneToMany(void) {
+  NmeaPosition from;
+  NmeaPosition to[DISTANCE_COUNT];
+  double exact[DISTANCE_COUNT];
+  double fast[DISTANCE_COUNT];
+  size_t i;
+
+  distancePositions(to, DISTANCE_COUNT, 1.0);
+  from.lat = nmeaMathDegreeToRadian(52.0);
+  from.lon = nmeaMathDegreeToRadian(4.5);
+
+  /* invalid inputs */
+
+  CU_ASSERT_EQUAL(nmeaDistanceOneToMany(NULL, to, DISTANCE_COUNT, exact, NMEALIB_DISTANCE_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaDistanceOneToMany(&from, NULL, DISTANCE_COUNT, exact, NMEALIB_DISTANCE_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaDistanceOneToMany(&from, to, DISTANCE_COUNT, NULL, NMEALIB_DISTANCE_EXACT), false);
+
+  /* nothing to do */
+
+  CU_ASSERT_EQUAL(nmeaDistanceOneToMany(&from, to, 0, exact, NMEALIB_DISTANCE_EXACT), true);
+
+  /* exact matches nmeaMathDistance, fast matches exact */
+
+  CU_ASSERT_EQUAL(nmeaDistanceOneToMany(&from, to, DISTANCE_COUNT, exact, NMEALIB_DISTANCE_EXACT), true);
+  CU_ASSERT_EQUAL(nmeaDistanceOneToMany(&from, to, DISTANCE_COUNT, fast, NMEALIB_DISTANCE_FAST), true);
+  for (i = 0; i < DISTANCE_COUNT; i++) {
+    CU_ASSERT_DOUBLE_EQUAL(exact[i], nmeaMathDistance(&from, &to[i]), 1E-3);
+    CU_ASSERT_DOUBLE_EQUAL(fast[i], exact[i], 1E-6);
+  }
+
+  /* the same position, antipodes */
+
+  to[0] = from;
+  to[1].lat = -from.lat;
+  to[1].lon = from.lon - NMEALIB_PI;
+  CU_ASSERT_EQUAL(nmeaDistanceOneToMany(&from, to, 2, fast, NMEALIB_DISTANCE_FAST), true);
+  CU_ASSERT_DOUBLE_EQUAL(fast[0], 0.0, 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(fast[1], NMEALIB_PI * NMEALIB_EARTHRADIUS_M, 1.0);
+
+  /* short distances stay accurate */
+
+  to[0].lat = from.lat + nmeaMathDegreeToRadian(1E-7);
+  to[0].lon = from.lon;
+  CU_ASSERT_EQUAL(nmeaDistanceOneToMany(&from, to, 1, exact, NMEALIB_DISTANCE_EXACT), true);
+  CU_ASSERT_EQUAL(nmeaDistanceOneToMany(&from, to, 1, fast, NMEALIB_DISTANCE_FAST), true);
+  CU_ASSERT_DOUBLE_EQUAL(exact[0], nmeaMathDegreeToRadian(1E-7) * NMEALIB_EARTHRADIUS_M, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(fast[0], exact[0], 1E-9);
+}
+
+static void test_nmeaDistancePath(void) {
+  NmeaPosition points[DISTANCE_COUNT];
+  double distances[DISTANCE_COUNT - 1];
+  double length;
+  double sum = 0.0;
+  size_t i;
+
+  distancePositions(points, DISTANCE_COUNT, 0.01);
+
+  /* invalid inputs */
+
+  CU_ASSERT_EQUAL(isnan(nmeaDistancePath(NULL, DISTANCE_COUNT, distances, NMEALIB_DISTANCE_EXACT)), true);
+
+  /* no segments */
+
+  CU_ASSERT_DOUBLE_EQUAL(nmeaDistancePath(points, 0, distances, NMEALIB_DISTANCE_EXACT), 0.0, 0.0);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaDistancePath(points, 1, distances, NMEALIB_DISTANCE_EXACT), 0.0, 0.0);
+
+  /* segments */
+
+  length = nmeaDistancePath(points, DISTANCE_COUNT, distances, NMEALIB_DISTANCE_EXACT);
+  for (i = 0; i < (DISTANCE_COUNT - 1); i++) {
+    CU_ASSERT_DOUBLE_EQUAL(distances[i], nmeaMathDistance(&points[i], &points[i + 1]), 1E-3);
+    sum += distances[i];
+  }
+  CU_ASSERT_DOUBLE_EQUAL(length, sum, 1E-6);
+
+  /* without segment distances, fast */
+
+  CU_ASSERT_DOUBLE_EQUAL(nmeaDistancePath(points, DISTANCE_COUNT, NULL, NMEALIB_DISTANCE_EXACT), length, 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaDistancePath(points, DISTANCE_COUNT, NULL, NMEALIB_DISTANCE_FAST), length, 1E-4);
+}
+
+static void test_nmeaDistanceTile(void) {
+  NmeaPosition rows[3];
+  NmeaPosition columns[DISTANCE_COUNT];
+  double distances[3 * DISTANCE_COUNT];
+  size_t r;
+  size_t c;
+
+  distancePositions(rows, 3, 0.5);
+  distancePositions(columns, DISTANCE_COUNT, 1.0);
+
+  /* invalid inputs */
+
+  CU_ASSERT_EQUAL(nmeaDistanceTile(NULL, 3, columns, DISTANCE_COUNT, distances, NMEALIB_DISTANCE_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaDistanceTile(rows, 3, NULL, DISTANCE_COUNT, distances, NMEALIB_DISTANCE_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaDistanceTile(rows, 3, columns, DISTANCE_COUNT, NULL, NMEALIB_DISTANCE_EXACT), false);
+
+  /* row-major */
+
+  CU_ASSERT_EQUAL(nmeaDistanceTile(rows, 3, columns, DISTANCE_COUNT, distances, NMEALIB_DISTANCE_FAST), true);
+  for (r = 0; r < 3; r++) {
+    for (c = 0; c < DISTANCE_COUNT; c++) {
+      CU_ASSERT_DOUBLE_EQUAL(distances[(r * DISTANCE_COUNT) + c], nmeaMathDistance(&rows[r], &columns[c]), 1E-3);
+    }
+  }
+}
+
+static void test_nmeaDistanceNearest(void) {
+  NmeaPosition from;
+  NmeaPosition to[DISTANCE_COUNT];
+  double distance = -1.0;
+
+  distancePositions(to, DISTANCE_COUNT, 1.0);
+  from.lat = to[137].lat + 1E-6;
+  from.lon = to[137].lon - 1E-6;
+
+  /* invalid inputs */
+
+  CU_ASSERT_EQUAL(nmeaDistanceNearest(NULL, to, DISTANCE_COUNT, &distance, NMEALIB_DISTANCE_EXACT), DISTANCE_COUNT);
+  CU_ASSERT_EQUAL(nmeaDistanceNearest(&from, NULL, DISTANCE_COUNT, &distance, NMEALIB_DISTANCE_EXACT), DISTANCE_COUNT);
+  CU_ASSERT_DOUBLE_EQUAL(distance, -1.0, 0.0);
+
+  /* no positions */
+
+  CU_ASSERT_EQUAL(nmeaDistanceNearest(&from, to, 0, &distance, NMEALIB_DISTANCE_EXACT), 0);
+  CU_ASSERT_DOUBLE_EQUAL(distance, -1.0, 0.0);
+
+  /* found */
+
+  CU_ASSERT_EQUAL(nmeaDistanceNearest(&from, to, DISTANCE_COUNT, NULL, NMEALIB_DISTANCE_EXACT), 137);
+  CU_ASSERT_EQUAL(nmeaDistanceNearest(&from, to, DISTANCE_COUNT, &distance, NMEALIB_DISTANCE_FAST), 137);
+  CU_ASSERT_DOUBLE_EQUAL(distance, nmeaMathDistance(&from, &to[137]), 1E-1);
+  CU_ASSERT_EQUAL(distance > 0.0, true);
+}
+
+/*
+ * Setup
+ */
+
+int distanceSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("distance", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaDistanceOneToMany", test_nmeaDistanceOneToMany)) //
+      || (!CU_add_test(pSuite, "nmeaDistancePath", test_nmeaDistancePath)) //
+      || (!CU_add_test(pSuite, "nmeaDistanceTile", test_nmeaDistanceTile)) //
+      || (!CU_add_test(pSuite, "nmeaDistanceNearest", test_nmeaDistanceNearest)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
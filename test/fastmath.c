@@ -0,0 +1,185 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/fastmath.h>
+#include <nmealib/util.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdbool.h>
+
+int fastmathSuiteSetup(void);
+
+#define FASTMATH_COUNT (1001u)
+#define FASTMATH_SIN_ERROR (1E-14)
+#define FASTMATH_ASIN_ERROR (1E-15)
+#define FASTMATH_ATAN_ERROR (1E-15)
+
+/*
+ * Tests
+ */
+
+static void test_nmeaFastSin(void) {
+  static const double ranges[] = {
+      1.0,
+      10.0,
+      1E3,
+      1E6 };
+  size_t r;
+  size_t i;
+  double s;
+  double c;
+
+  for (r = 0; r < (sizeof(ranges) / sizeof(ranges[0])); r++) {
+    for (i = 0; i < FASTMATH_COUNT; i++) {
+      double x = ranges[r] * ((2.0 * (double) i / (FASTMATH_COUNT - 1)) - 1.0);
+
+      CU_ASSERT_DOUBLE_EQUAL(nmeaFastSin(x), sin(x), FASTMATH_SIN_ERROR);
+      CU_ASSERT_DOUBLE_EQUAL(nmeaFastCos(x), cos(x), FASTMATH_SIN_ERROR);
+
+      nmeaFastSinCos(x, &s, &c);
+      CU_ASSERT_DOUBLE_EQUAL(s, sin(x), FASTMATH_SIN_ERROR);
+      CU_ASSERT_DOUBLE_EQUAL(c, cos(x), FASTMATH_SIN_ERROR);
+    }
+  }
+
+  /* small arguments keep their relative accuracy */
+  CU_ASSERT_DOUBLE_EQUAL(nmeaFastSin(1E-20), 1E-20, 1E-33);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaFastSin(0.0), 0.0, 0.0);
+  nmeaFastSinCos(1E-20, &s, &c);
+  CU_ASSERT_DOUBLE_EQUAL(s, 1E-20, 1E-33);
+  CU_ASSERT_DOUBLE_EQUAL(c, 1.0, FASTMATH_SIN_ERROR);
+}
+
+static void test_nmeaFastAsin(void) {
+  size_t i;
+
+  for (i = 0; i < FASTMATH_COUNT; i++) {
+    double x = (2.0 * (double) i / (FASTMATH_COUNT - 1)) - 1.0;
+
+    CU_ASSERT_DOUBLE_EQUAL(nmeaFastAsin(x), asin(x), FASTMATH_ASIN_ERROR);
+  }
+
+  CU_ASSERT_DOUBLE_EQUAL(nmeaFastAsin(1.0), asin(1.0), FASTMATH_ASIN_ERROR);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaFastAsin(-1.0), asin(-1.0), FASTMATH_ASIN_ERROR);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaFastAsin(0.5), asin(0.5), FASTMATH_ASIN_ERROR);
+}
+
+static void test_nmeaFastAtan2(void) {
+  static const double radii[] = {
+      1E-300,
+      1E-6,
+      1.0,
+      6378137.0 };
+  size_t r;
+  size_t i;
+
+  /* around the circle, at several scales */
+
+  for (r = 0; r < (sizeof(radii) / sizeof(radii[0])); r++) {
+    for (i = 0; i < FASTMATH_COUNT; i++) {
+      double angle = 3.2 * ((2.0 * (double) i / (FASTMATH_COUNT - 1)) - 1.0);
+      double y = radii[r] * sin(angle);
+      double x = radii[r] * cos(angle);
+
+      CU_ASSERT_DOUBLE_EQUAL(nmeaFastAtan2(y, x), atan2(y, x), FASTMATH_ATAN_ERROR);
+    }
+  }
+
+  /* the axes, signed zeros, NaN */
+
+  CU_ASSERT_DOUBLE_EQUAL(nmeaFastAtan2(0.0, 1.0), 0.0, 0.0);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaFastAtan2(1.0, 0.0), atan2(1.0, 0.0), FASTMATH_ATAN_ERROR);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaFastAtan2(-1.0, 0.0), atan2(-1.0, 0.0), FASTMATH_ATAN_ERROR);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaFastAtan2(0.0, -1.0), atan2(0.0, -1.0), FASTMATH_ATAN_ERROR);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaFastAtan2(-0.0, -1.0), atan2(-0.0, -1.0), FASTMATH_ATAN_ERROR);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaFastAtan2(0.0, 0.0), 0.0, 0.0);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaFastAtan2(0.0, -0.0), atan2(0.0, -0.0), FASTMATH_ATAN_ERROR);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaFastAtan2(1.0, 1.0), atan2(1.0, 1.0), FASTMATH_ATAN_ERROR);
+  CU_ASSERT_EQUAL(isNaN(nmeaFastAtan2(NaN, 1.0)), true);
+  CU_ASSERT_EQUAL(isNaN(nmeaFastAtan2(1.0, NaN)), true);
+}
+
+static void test_nmeaFastArrays(void) {
+  double x[FASTMATH_COUNT];
+  double y[FASTMATH_COUNT];
+  size_t i;
+
+  /* invalid inputs */
+
+  nmeaFastSinArray(NULL, y, FASTMATH_COUNT);
+  nmeaFastSinArray(x, NULL, FASTMATH_COUNT);
+  nmeaFastCosArray(NULL, y, FASTMATH_COUNT);
+  nmeaFastCosArray(x, NULL, FASTMATH_COUNT);
+  nmeaFastAsinArray(NULL, y, FASTMATH_COUNT);
+  nmeaFastAsinArray(x, NULL, FASTMATH_COUNT);
+
+  /* an odd count covers the scalar tail, the arrays match the scalar functions */
+
+  for (i = 0; i < FASTMATH_COUNT; i++) {
+    x[i] = 100.0 * ((2.0 * (double) i / (FASTMATH_COUNT - 1)) - 1.0);
+  }
+
+  nmeaFastSinArray(x, y, FASTMATH_COUNT);
+  for (i = 0; i < FASTMATH_COUNT; i++) {
+    CU_ASSERT_DOUBLE_EQUAL(y[i], nmeaFastSin(x[i]), 1E-15);
+  }
+
+  nmeaFastCosArray(x, y, FASTMATH_COUNT);
+  for (i = 0; i < FASTMATH_COUNT; i++) {
+    CU_ASSERT_DOUBLE_EQUAL(y[i], nmeaFastCos(x[i]), 1E-15);
+  }
+
+  for (i = 0; i < FASTMATH_COUNT; i++) {
+    x[i] = (2.0 * (double) i / (FASTMATH_COUNT - 1)) - 1.0;
+  }
+
+  nmeaFastAsinArray(x, y, FASTMATH_COUNT);
+  for (i = 0; i < FASTMATH_COUNT; i++) {
+    CU_ASSERT_DOUBLE_EQUAL(y[i], nmeaFastAsin(x[i]), 1E-15);
+  }
+
+  /* in place */
+
+  nmeaFastAsinArray(x, x, FASTMATH_COUNT);
+  for (i = 0; i < FASTMATH_COUNT; i++) {
+    CU_ASSERT_DOUBLE_EQUAL(x[i], y[i], 0.0);
+  }
+}
+
+/*
+ * Setup
+ */
+
+int fastmathSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("fastmath", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaFastSin*", test_nmeaFastSin)) //
+      || (!CU_add_test(pSuite, "nmeaFastAsin", test_nmeaFastAsin)) //
+      || (!CU_add_test(pSuite, "nmeaFastAtan2", test_nmeaFastAtan2)) //
+      || (!CU_add_test(pSuite, "nmeaFast*Array", test_nmeaFastArrays)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
@@ -0,0 +1,271 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/fleet.h>
+#include <CUnit/Basic.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+int fleetSuiteSetup(void);
+
+/*
+ * Helpers
+ */
+
+typedef struct _FleetOutput {
+  pthread_mutex_t mutex;
+  size_t shards[8];
+  size_t bytes;
+  size_t sentences;
+  size_t complete;
+  size_t calls;
+} FleetOutput;
+
+static void fleetOutput(void *userData, size_t shard, const char *s, size_t len) {
+  FleetOutput *out = userData;
+  size_t i;
+
+  pthread_mutex_lock(&out->mutex);
+
+  out->calls++;
+  out->bytes += len;
+  if (shard < 8) {
+    out->shards[shard]++;
+  }
+
+  for (i = 0; i < len; i++) {
+    if (s[i] == '$') {
+      out->sentences++;
+    } else if ((s[i] == '\n') && (i > 0) && (s[i - 1] == '\r')) {
+      out->complete++;
+    }
+  }
+
+  pthread_mutex_unlock(&out->mutex);
+}
+
+static void fleetConfig(NmeaFleetConfig *config, FleetOutput *out) {
+  memset(config, 0, sizeof(*config));
+  config->units = 10;
+  config->threads = 3;
+  config->type = NMEALIB_GENERATOR_ROTATE;
+  config->mask = NMEALIB_SENTENCE_GPGGA | NMEALIB_SENTENCE_GPRMC;
+  config->seed = 42;
+  config->bufferSize = NMEALIB_FLEET_BUFFER_SIZE_MIN;
+  config->output = fleetOutput;
+  config->userData = out;
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaFleetCreate(void) {
+  NmeaFleetConfig config;
+  FleetOutput out;
+  NmeaFleet *fleet;
+  NmeaFleet *other;
+  size_t i;
+
+  memset(&out, 0, sizeof(out));
+  fleetConfig(&config, &out);
+
+  /* invalid inputs */
+
+  CU_ASSERT_PTR_NULL(nmeaFleetCreate(NULL));
+
+  config.units = 0;
+  CU_ASSERT_PTR_NULL(nmeaFleetCreate(&config));
+  config.units = 10;
+
+  config.mask = 0;
+  CU_ASSERT_PTR_NULL(nmeaFleetCreate(&config));
+  config.mask = NMEALIB_SENTENCE_GPGGA;
+
+  config.rate = -1.0;
+  CU_ASSERT_PTR_NULL(nmeaFleetCreate(&config));
+  config.rate = 0.0;
+
+  config.bufferSize = NMEALIB_FLEET_BUFFER_SIZE_MIN - 1;
+  CU_ASSERT_PTR_NULL(nmeaFleetCreate(&config));
+  config.bufferSize = 0;
+
+  config.type = (NmeaGeneratorType) (NMEALIB_GENERATOR_LAST + 1);
+  CU_ASSERT_PTR_NULL(nmeaFleetCreate(&config));
+  config.type = NMEALIB_GENERATOR_ROTATE;
+
+  nmeaFleetDestroy(NULL);
+
+  /* units, seeded positions */
+
+  fleet = nmeaFleetCreate(&config);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(fleet);
+  other = nmeaFleetCreate(&config);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(other);
+
+  CU_ASSERT_PTR_NULL(nmeaFleetUnitInfo(NULL, 0));
+  CU_ASSERT_PTR_NULL(nmeaFleetUnitInfo(fleet, 10));
+
+  for (i = 0; i < 10; i++) {
+    const NmeaInfo *info = nmeaFleetUnitInfo(fleet, i);
+    const NmeaInfo *otherInfo = nmeaFleetUnitInfo(other, i);
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(info);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(otherInfo);
+    CU_ASSERT_DOUBLE_EQUAL(info->latitude, otherInfo->latitude, 1E-9);
+    CU_ASSERT_DOUBLE_EQUAL(info->longitude, otherInfo->longitude, 1E-9);
+    CU_ASSERT_EQUAL(info->latitude <= 30.0, true);
+    CU_ASSERT_EQUAL(info->latitude >= -30.0, true);
+    CU_ASSERT_EQUAL(info->satellites.inViewCount, 8);
+
+    if (i) {
+      CU_ASSERT_NOT_EQUAL(info->latitude, nmeaFleetUnitInfo(fleet, i - 1)->latitude);
+    }
+  }
+
+  nmeaFleetDestroy(other);
+
+  /* more threads than units */
+
+  config.threads = 20;
+  other = nmeaFleetCreate(&config);
+  CU_ASSERT_PTR_NOT_NULL(other);
+  CU_ASSERT_PTR_NOT_NULL(nmeaFleetUnitInfo(other, 9));
+  nmeaFleetDestroy(other);
+
+  nmeaFleetDestroy(fleet);
+}
+
+static void test_nmeaFleetRun(void) {
+  NmeaFleetConfig config;
+  NmeaFleetMetrics metrics;
+  FleetOutput out;
+  NmeaFleet *fleet;
+  size_t i;
+
+  memset(&out, 0, sizeof(out));
+  pthread_mutex_init(&out.mutex, NULL);
+  fleetConfig(&config, &out);
+
+  CU_ASSERT_EQUAL(nmeaFleetRun(NULL, 1), false);
+
+  nmeaFleetMetrics(NULL, &metrics);
+  CU_ASSERT_EQUAL(metrics.fixes, 0);
+  nmeaFleetMetrics(NULL, NULL);
+
+  fleet = nmeaFleetCreate(&config);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(fleet);
+
+  CU_ASSERT_EQUAL(nmeaFleetRun(fleet, 50), true);
+
+  nmeaFleetMetrics(fleet, &metrics);
+  CU_ASSERT_EQUAL(metrics.fixes, 500);
+  CU_ASSERT_EQUAL(metrics.bytes, out.bytes);
+  CU_ASSERT_EQUAL(metrics.flushes, out.calls);
+  CU_ASSERT_EQUAL(metrics.seconds > 0.0, true);
+  CU_ASSERT_EQUAL(metrics.fixesPerSecond > 0.0, true);
+  CU_ASSERT_EQUAL(metrics.bytesPerSecond > 0.0, true);
+
+  /* complete sentences only, 2 per fix */
+
+  CU_ASSERT_EQUAL(out.sentences, 1000);
+  CU_ASSERT_EQUAL(out.complete, 1000);
+
+  /* every shard emitted, every buffer was flushed at least once */
+
+  for (i = 0; i < 3; i++) {
+    CU_ASSERT_EQUAL(out.shards[i] > 0, true);
+  }
+  CU_ASSERT_EQUAL(out.shards[3], 0);
+  CU_ASSERT_EQUAL(out.calls > 3, true);
+
+  /* metrics accumulate */
+
+  CU_ASSERT_EQUAL(nmeaFleetRun(fleet, 1), true);
+  nmeaFleetMetrics(fleet, &metrics);
+  CU_ASSERT_EQUAL(metrics.fixes, 510);
+  CU_ASSERT_EQUAL(out.sentences, 1020);
+
+  nmeaFleetDestroy(fleet);
+
+  /* discarded output */
+
+  config.output = NULL;
+  fleet = nmeaFleetCreate(&config);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(fleet);
+  CU_ASSERT_EQUAL(nmeaFleetRun(fleet, 5), true);
+  nmeaFleetMetrics(fleet, &metrics);
+  CU_ASSERT_EQUAL(metrics.fixes, 50);
+  CU_ASSERT_EQUAL(metrics.bytes > 0, true);
+  nmeaFleetDestroy(fleet);
+
+  pthread_mutex_destroy(&out.mutex);
+}
+
+static void test_nmeaFleetRunRate(void) {
+  NmeaFleetConfig config;
+  NmeaFleetMetrics metrics;
+  FleetOutput out;
+  NmeaFleet *fleet;
+
+  memset(&out, 0, sizeof(out));
+  pthread_mutex_init(&out.mutex, NULL);
+  fleetConfig(&config, &out);
+
+  /* 2 shards of 64 units, 128 fixes at 1280 fixes per second take at least 0.1s */
+
+  config.units = 128;
+  config.threads = 2;
+  config.type = NMEALIB_GENERATOR_STATIC;
+  config.rate = 1280.0;
+
+  fleet = nmeaFleetCreate(&config);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(fleet);
+  CU_ASSERT_EQUAL(nmeaFleetRun(fleet, 1), true);
+
+  nmeaFleetMetrics(fleet, &metrics);
+  CU_ASSERT_EQUAL(metrics.fixes, 128);
+  CU_ASSERT_EQUAL(metrics.seconds >= 0.09, true);
+  CU_ASSERT_EQUAL(metrics.fixesPerSecond <= 1500.0, true);
+
+  nmeaFleetDestroy(fleet);
+  pthread_mutex_destroy(&out.mutex);
+}
+
+/*
+ * Setup
+ */
+
+int fleetSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("fleet", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaFleetCreate", test_nmeaFleetCreate)) //
+      || (!CU_add_test(pSuite, "nmeaFleetRun", test_nmeaFleetRun)) //
+      || (!CU_add_test(pSuite, "nmeaFleetRun (rate)", test_nmeaFleetRunRate)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
@@ -0,0 +1,423 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/format.h>
+#include <nmealib/util.h>
+#include <CUnit/Basic.h>
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+int formatSuiteSetup(void);
+
+/*
+ * Helpers
+ */
+
+#define FORMAT_BUFFER_SIZE (128u)
+
+static uint64_t formatSeed = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t formatNext(void) {
+  formatSeed ^= formatSeed << 13;
+  formatSeed ^= formatSeed >> 7;
+  formatSeed ^= formatSeed << 17;
+  return formatSeed;
+}
+
+/*
+ * Compare a formatted value against the snprintf reference for all buffer
+ * sizes from 0 to beyond the length of the value. Returns true on a match.
+ */
+static bool formatCompare(const char *expected, int expectedLen, int (*format)(char *, size_t, const void *), const void *arg) {
+  char buf[FORMAT_BUFFER_SIZE];
+  char ref[FORMAT_BUFFER_SIZE];
+  size_t sz;
+
+  for (sz = 0; sz <= ((size_t) expectedLen + 1); sz++) {
+    int r;
+
+    memset(buf, 'x', sizeof(buf));
+    memset(ref, 'x', sizeof(ref));
+    snprintf(ref, sz, "%s", expected);
+
+    r = format(buf, sz, arg);
+    if ((r != expectedLen) //
+        || memcmp(buf, ref, sizeof(buf))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+typedef struct _FormatArgs {
+  unsigned long u;
+  long i;
+  double d;
+  unsigned int width;
+  unsigned int precision;
+} FormatArgs;
+
+static int formatUnsigned(char *s, size_t sz, const void *arg) {
+  const FormatArgs *a = arg;
+  return nmeaFormatUnsigned(s, sz, a->u, a->width);
+}
+
+static int formatInt(char *s, size_t sz, const void *arg) {
+  const FormatArgs *a = arg;
+  return nmeaFormatInt(s, sz, a->i, a->width);
+}
+
+static int formatDouble(char *s, size_t sz, const void *arg) {
+  const FormatArgs *a = arg;
+  return nmeaFormatDouble(s, sz, a->d, a->width, a->precision);
+}
+
+static bool formatCheckDouble(double d, unsigned int width, unsigned int precision) {
+  char expected[FORMAT_BUFFER_SIZE];
+  int len;
+  FormatArgs a;
+
+  memset(&a, 0, sizeof(a));
+  a.d = d;
+  a.width = width;
+  a.precision = precision;
+
+  len = snprintf(expected, sizeof(expected), "%0*.*f", (int) width, (int) precision, d);
+  return formatCompare(expected, len, formatDouble, &a);
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaFormatString(void) {
+  char buf[8];
+  int r;
+
+  memset(buf, 'x', sizeof(buf));
+  r = nmeaFormatString(buf, sizeof(buf), NULL);
+  CU_ASSERT_EQUAL(r, 0);
+  CU_ASSERT_EQUAL(buf[0], 'x');
+
+  r = nmeaFormatString(NULL, 0, "$GPGGA");
+  CU_ASSERT_EQUAL(r, 6);
+
+  r = nmeaFormatString(buf, sizeof(buf), "$GPGGA");
+  CU_ASSERT_EQUAL(r, 6);
+  CU_ASSERT_STRING_EQUAL(buf, "$GPGGA");
+
+  r = nmeaFormatString(buf, 4, "$GPGGA");
+  CU_ASSERT_EQUAL(r, 6);
+  CU_ASSERT_STRING_EQUAL(buf, "$GP");
+
+  memset(buf, 'x', sizeof(buf));
+  r = nmeaFormatString(buf, 1, "$GPGGA");
+  CU_ASSERT_EQUAL(r, 6);
+  CU_ASSERT_EQUAL(buf[0], '\0');
+  CU_ASSERT_EQUAL(buf[1], 'x');
+}
+
+static void test_nmeaFormatChar(void) {
+  char buf[4];
+  int r;
+
+  memset(buf, 'x', sizeof(buf));
+  r = nmeaFormatChar(buf, 0, ',');
+  CU_ASSERT_EQUAL(r, 1);
+  CU_ASSERT_EQUAL(buf[0], 'x');
+
+  r = nmeaFormatChar(buf, 1, ',');
+  CU_ASSERT_EQUAL(r, 1);
+  CU_ASSERT_EQUAL(buf[0], '\0');
+
+  r = nmeaFormatChar(buf, sizeof(buf), ',');
+  CU_ASSERT_EQUAL(r, 1);
+  CU_ASSERT_STRING_EQUAL(buf, ",");
+}
+
+static void test_nmeaFormatUnsigned(void) {
+  char expected[FORMAT_BUFFER_SIZE];
+  unsigned long values[] = {
+      0,
+      1,
+      9,
+      10,
+      99,
+      100,
+      4294967295UL,
+      ULONG_MAX };
+  unsigned long v;
+  unsigned int width;
+  size_t i;
+  FormatArgs a;
+  bool ok = true;
+
+  memset(&a, 0, sizeof(a));
+
+  for (v = 0; ok && (v < 100000); v++) {
+    for (width = 0; ok && (width <= 3); width++) {
+      int len = snprintf(expected, sizeof(expected), "%0*lu", (int) width, v);
+      a.u = v;
+      a.width = width;
+      ok = formatCompare(expected, len, formatUnsigned, &a);
+    }
+  }
+  CU_ASSERT_EQUAL(ok, true);
+
+  for (i = 0; ok && (i < (sizeof(values) / sizeof(values[0]))); i++) {
+    for (width = 0; ok && (width <= 40); width++) {
+      int len = snprintf(expected, sizeof(expected), "%0*lu", (int) width, values[i]);
+      a.u = values[i];
+      a.width = width;
+      ok = formatCompare(expected, len, formatUnsigned, &a);
+    }
+  }
+  CU_ASSERT_EQUAL(ok, true);
+}
+
+static void test_nmeaFormatInt(void) {
+  char expected[FORMAT_BUFFER_SIZE];
+  long values[] = {
+      0,
+      1,
+      -1,
+      -9,
+      -10,
+      INT_MIN,
+      INT_MAX,
+      LONG_MIN,
+      LONG_MAX };
+  long v;
+  unsigned int width;
+  size_t i;
+  FormatArgs a;
+  bool ok = true;
+
+  memset(&a, 0, sizeof(a));
+
+  for (v = -10000; ok && (v < 10000); v++) {
+    for (width = 0; ok && (width <= 4); width++) {
+      int len = snprintf(expected, sizeof(expected), "%0*ld", (int) width, v);
+      a.i = v;
+      a.width = width;
+      ok = formatCompare(expected, len, formatInt, &a);
+    }
+  }
+  CU_ASSERT_EQUAL(ok, true);
+
+  for (i = 0; ok && (i < (sizeof(values) / sizeof(values[0]))); i++) {
+    for (width = 0; ok && (width <= 40); width++) {
+      int len = snprintf(expected, sizeof(expected), "%0*ld", (int) width, values[i]);
+      a.i = values[i];
+      a.width = width;
+      ok = formatCompare(expected, len, formatInt, &a);
+    }
+  }
+  CU_ASSERT_EQUAL(ok, true);
+}
+
+static void test_nmeaFormatDouble(void) {
+  double values[] = {
+      0.0,
+      -0.0,
+      0.05,
+      0.15,
+      0.25,
+      0.35,
+      0.5,
+      1.5,
+      2.5,
+      -2.5,
+      0.125,
+      0.375,
+      99.995,
+      5209.4612,
+      -5209.4612,
+      12345678.5,
+      281474976710655.5,
+      281474976710656.0,
+      1E20,
+      -1E30,
+      4.9406564584124654E-324,
+      NAN,
+      -NAN,
+      INFINITY,
+      -INFINITY };
+  size_t i;
+  unsigned int width;
+  unsigned int precision;
+  bool ok = true;
+
+  /* special values, all widths and precisions */
+
+  for (i = 0; ok && (i < (sizeof(values) / sizeof(values[0]))); i++) {
+    for (precision = 0; ok && (precision <= 6); precision++) {
+      for (width = 0; ok && (width <= 12); width++) {
+        ok = formatCheckDouble(values[i], width, precision);
+      }
+    }
+  }
+  CU_ASSERT_EQUAL(ok, true);
+
+  /* exact ties in the binary representation */
+
+  for (i = 0; ok && (i < 100000); i++) {
+    double d = (double) i / 32.0;
+    for (precision = 0; ok && (precision <= 4); precision++) {
+      ok = formatCheckDouble(d, 0, precision) //
+          && formatCheckDouble(-d, 0, precision);
+    }
+  }
+  CU_ASSERT_EQUAL(ok, true);
+
+  /* pseudo-random values in the ranges of the generators, and their neighbours */
+
+  for (i = 0; ok && (i < 100000); i++) {
+    double d = (double) (formatNext() % 1000000000ULL) / 10000.0;
+    double scale = 1.0 + (double) (formatNext() % 1000) / 1000.0;
+    double n;
+    precision = (unsigned int) (formatNext() % 6);
+    width = (unsigned int) (formatNext() % 13);
+
+    d *= scale;
+    if (formatNext() & 1) {
+      d = -d;
+    }
+
+    n = nextafter(d, HUGE_VAL);
+    ok = formatCheckDouble(d, width, precision) //
+        && formatCheckDouble(n, width, precision) //
+        && formatCheckDouble(nextafter(d, -HUGE_VAL), width, precision);
+  }
+  CU_ASSERT_EQUAL(ok, true);
+
+  /* pseudo-random bit patterns with exponents around the snprintf fallback */
+
+  for (i = 0; ok && (i < 100000); i++) {
+    uint64_t bits = formatNext();
+    uint64_t exponent = 1023 - 40 + (formatNext() % 100);
+    double d;
+
+    bits = (bits & ~(0x7ffULL << 52)) | (exponent << 52);
+
+    memcpy(&d, &bits, sizeof(d));
+    ok = formatCheckDouble(d, 0, (unsigned int) (i % 5));
+  }
+  CU_ASSERT_EQUAL(ok, true);
+}
+
+static void test_nmeaFormatChecksum(void) {
+  char trailer[NMEALIB_CHECKSUM_LENGTH];
+  unsigned int i;
+  bool ok = true;
+
+  for (i = 0; ok && (i < 256); i++) {
+    char expected[8];
+
+    snprintf(expected, sizeof(expected), "*%02X\r\n", i);
+    nmeaFormatChecksum(trailer, i);
+    ok = !memcmp(trailer, expected, sizeof(trailer));
+  }
+  CU_ASSERT_EQUAL(ok, true);
+}
+
+static size_t formatSentence(char *s, size_t sz) {
+  NmeaFormatter out;
+
+  nmeaFormatterInit(&out, s, sz);
+  nmeaFormatterString(&out, "$GPXXX");
+  nmeaFormatterChar(&out, ',');
+  nmeaFormatterUnsigned(&out, 7, 2);
+  nmeaFormatterChar(&out, ',');
+  nmeaFormatterInt(&out, -42, 0);
+  nmeaFormatterChar(&out, ',');
+  nmeaFormatterDouble(&out, 5209.4612, 9, 4);
+  nmeaFormatterChar(&out, ',');
+  nmeaFormatterDouble(&out, 1E20, 0, 1);
+  nmeaFormatterChar(&out, ',');
+  nmeaFormatterUnsigned(&out, 3, 40);
+  nmeaFormatterChar(&out, ',');
+  nmeaFormatterInt(&out, -3, 40);
+  nmeaFormatterString(&out, NULL);
+  nmeaFormatterChecksum(&out);
+
+  return out.length;
+}
+
+static void test_nmeaFormatter(void) {
+  char expected[256];
+  char buf[256];
+  char ref[256];
+  size_t len;
+  size_t r;
+  size_t sz;
+  bool ok = true;
+
+  len = (size_t) snprintf(expected, sizeof(expected), "$GPXXX,%02u,%d,%09.4f,%.1f,%040u,%040d", 7, -42, 5209.4612,
+      1E20, 3, -3);
+  len += (size_t) nmeaAppendChecksum(expected, sizeof(expected), len);
+
+  r = formatSentence(NULL, 0);
+  CU_ASSERT_EQUAL(r, len);
+
+  r = formatSentence(buf, sizeof(buf));
+  CU_ASSERT_EQUAL(r, len);
+  CU_ASSERT_STRING_EQUAL(buf, expected);
+
+  for (sz = 0; ok && (sz <= (len + 1)); sz++) {
+    memset(buf, 'x', sizeof(buf));
+    memset(ref, 'x', sizeof(ref));
+    snprintf(ref, sz, "%s", expected);
+
+    r = formatSentence(buf, sz);
+    ok = (r == len) //
+        && !memcmp(buf, ref, sizeof(buf));
+  }
+  CU_ASSERT_EQUAL(ok, true);
+}
+
+/*
+ * Setup
+ */
+
+int formatSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("format", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaFormatString", test_nmeaFormatString)) //
+      || (!CU_add_test(pSuite, "nmeaFormatChar", test_nmeaFormatChar)) //
+      || (!CU_add_test(pSuite, "nmeaFormatUnsigned", test_nmeaFormatUnsigned)) //
+      || (!CU_add_test(pSuite, "nmeaFormatInt", test_nmeaFormatInt)) //
+      || (!CU_add_test(pSuite, "nmeaFormatDouble", test_nmeaFormatDouble)) //
+      || (!CU_add_test(pSuite, "nmeaFormatChecksum", test_nmeaFormatChecksum)) //
+      || (!CU_add_test(pSuite, "nmeaFormatter", test_nmeaFormatter)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
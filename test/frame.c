@@ -0,0 +1,479 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/frame.h>
+#include <nmealib/nmath.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+int frameSuiteSetup(void);
+
+/* more than 2 blocks, not a multiple of the block size */
+#define FRAME_COUNT (150u)
+
+/** The WGS84 semi-minor axis */
+#define FRAME_B (6356752.314245179)
+
+/*
+ * Helpers
+ */
+
+static void frameCoordinates(double *lat, double *lon, double *height, size_t count) {
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    lat[i] = nmeaMathDegreeToRadian(sin((double) i * 0.7) * 90.0);
+    lon[i] = nmeaMathDegreeToRadian(cos((double) i * 1.3) * 180.0);
+    height[i] = sin((double) i * 0.3) * 1E4;
+  }
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaFrameSplit(void) {
+  NmeaPosition positions[3];
+  NmeaRecord records[2];
+  double lat[3];
+  double lon[3];
+  double height[3];
+
+  memset(positions, 0, sizeof(positions));
+  memset(records, 0, sizeof(records));
+
+  /* invalid inputs */
+
+  CU_ASSERT_EQUAL(nmeaFrameSplitPositions(NULL, 3, lat, lon), false);
+  CU_ASSERT_EQUAL(nmeaFrameSplitPositions(positions, 3, NULL, lon), false);
+  CU_ASSERT_EQUAL(nmeaFrameSplitPositions(positions, 3, lat, NULL), false);
+  CU_ASSERT_EQUAL(nmeaFrameSplitRecords(NULL, 2, lat, lon, height), false);
+  CU_ASSERT_EQUAL(nmeaFrameSplitRecords(records, 2, NULL, lon, height), false);
+  CU_ASSERT_EQUAL(nmeaFrameSplitRecords(records, 2, lat, NULL, height), false);
+
+  /* positions */
+
+  positions[0].lat = 0.1;
+  positions[0].lon = 0.2;
+  positions[2].lat = -0.3;
+  positions[2].lon = 0.4;
+  CU_ASSERT_EQUAL(nmeaFrameSplitPositions(positions, 3, lat, lon), true);
+  CU_ASSERT_DOUBLE_EQUAL(lat[0], 0.1, 0.0);
+  CU_ASSERT_DOUBLE_EQUAL(lon[0], 0.2, 0.0);
+  CU_ASSERT_DOUBLE_EQUAL(lat[1], 0.0, 0.0);
+  CU_ASSERT_DOUBLE_EQUAL(lat[2], -0.3, 0.0);
+  CU_ASSERT_DOUBLE_EQUAL(lon[2], 0.4, 0.0);
+
+  /* records, with and without an elevation */
+
+  records[0].latitude = 52.0;
+  records[0].longitude = -4.5;
+  records[0].elevation = 12.5f;
+  records[0].present = NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON | NMEALIB_PRESENT_ELV;
+  records[1].latitude = -33.0;
+  records[1].longitude = 151.0;
+  records[1].elevation = 100.0f;
+  records[1].present = NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON;
+  CU_ASSERT_EQUAL(nmeaFrameSplitRecords(records, 2, lat, lon, height), true);
+  CU_ASSERT_DOUBLE_EQUAL(lat[0], nmeaMathDegreeToRadian(52.0), 1E-15);
+  CU_ASSERT_DOUBLE_EQUAL(lon[0], nmeaMathDegreeToRadian(-4.5), 1E-15);
+  CU_ASSERT_DOUBLE_EQUAL(height[0], 12.5, 0.0);
+  CU_ASSERT_DOUBLE_EQUAL(lat[1], nmeaMathDegreeToRadian(-33.0), 1E-15);
+  CU_ASSERT_DOUBLE_EQUAL(lon[1], nmeaMathDegreeToRadian(151.0), 1E-15);
+  CU_ASSERT_DOUBLE_EQUAL(height[1], 0.0, 0.0);
+  CU_ASSERT_EQUAL(nmeaFrameSplitRecords(records, 2, lat, lon, NULL), true);
+}
+
+static void test_nmeaFrameEcef(void) {
+  double lat[FRAME_COUNT];
+  double lon[FRAME_COUNT];
+  double height[FRAME_COUNT];
+  double x[FRAME_COUNT];
+  double y[FRAME_COUNT];
+  double z[FRAME_COUNT];
+  double fx[FRAME_COUNT];
+  double fy[FRAME_COUNT];
+  double fz[FRAME_COUNT];
+  double lat2[FRAME_COUNT];
+  double lon2[FRAME_COUNT];
+  double height2[FRAME_COUNT];
+  size_t i;
+
+  frameCoordinates(lat, lon, height, FRAME_COUNT);
+
+  /* invalid inputs */
+
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEcef(NULL, lon, height, FRAME_COUNT, x, y, z, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEcef(lat, NULL, height, FRAME_COUNT, x, y, z, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEcef(lat, lon, height, FRAME_COUNT, NULL, y, z, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEcef(lat, lon, height, FRAME_COUNT, x, NULL, z, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEcef(lat, lon, height, FRAME_COUNT, x, y, NULL, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameEcefToGeodetic(NULL, y, z, FRAME_COUNT, lat2, lon2, height2), false);
+  CU_ASSERT_EQUAL(nmeaFrameEcefToGeodetic(x, NULL, z, FRAME_COUNT, lat2, lon2, height2), false);
+  CU_ASSERT_EQUAL(nmeaFrameEcefToGeodetic(x, y, NULL, FRAME_COUNT, lat2, lon2, height2), false);
+  CU_ASSERT_EQUAL(nmeaFrameEcefToGeodetic(x, y, z, FRAME_COUNT, NULL, lon2, height2), false);
+  CU_ASSERT_EQUAL(nmeaFrameEcefToGeodetic(x, y, z, FRAME_COUNT, lat2, NULL, height2), false);
+
+  /* nothing to do */
+
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEcef(lat, lon, height, 0, x, y, z, NMEALIB_FRAME_EXACT), true);
+  CU_ASSERT_EQUAL(nmeaFrameEcefToGeodetic(x, y, z, 0, lat2, lon2, height2), true);
+
+  /* the equator, the poles */
+
+  lat[0] = 0.0;
+  lon[0] = 0.0;
+  lat[1] = 0.0;
+  lon[1] = NMEALIB_PI / 2.0;
+  lat[2] = NMEALIB_PI / 2.0;
+  lon[2] = 1.0;
+  lat[3] = -NMEALIB_PI / 2.0;
+  lon[3] = -2.0;
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEcef(lat, lon, NULL, 4, x, y, z, NMEALIB_FRAME_EXACT), true);
+  CU_ASSERT_DOUBLE_EQUAL(x[0], NMEALIB_EARTHRADIUS_M, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(y[0], 0.0, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(z[0], 0.0, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(x[1], 0.0, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(y[1], NMEALIB_EARTHRADIUS_M, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(z[1], 0.0, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(hypot(x[2], y[2]), 0.0, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(z[2], FRAME_B, 1E-8);
+  CU_ASSERT_DOUBLE_EQUAL(z[3], -FRAME_B, 1E-8);
+
+  CU_ASSERT_EQUAL(nmeaFrameEcefToGeodetic(x, y, z, 4, lat2, lon2, height2), true);
+  CU_ASSERT_DOUBLE_EQUAL(lat2[0], 0.0, 1E-15);
+  CU_ASSERT_DOUBLE_EQUAL(lon2[0], 0.0, 1E-15);
+  CU_ASSERT_DOUBLE_EQUAL(height2[0], 0.0, 1E-8);
+  CU_ASSERT_DOUBLE_EQUAL(lon2[1], NMEALIB_PI / 2.0, 1E-15);
+  CU_ASSERT_DOUBLE_EQUAL(lat2[2], NMEALIB_PI / 2.0, 1E-15);
+  CU_ASSERT_DOUBLE_EQUAL(height2[2], 0.0, 1E-8);
+  CU_ASSERT_DOUBLE_EQUAL(lat2[3], -NMEALIB_PI / 2.0, 1E-15);
+  CU_ASSERT_DOUBLE_EQUAL(height2[3], 0.0, 1E-8);
+
+  /* a height along the normal */
+
+  lat[0] = nmeaMathDegreeToRadian(45.0);
+  lon[0] = 0.0;
+  height[0] = 0.0;
+  lat[1] = lat[0];
+  lon[1] = 0.0;
+  height[1] = 1000.0;
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEcef(lat, lon, height, 2, x, y, z, NMEALIB_FRAME_EXACT), true);
+  CU_ASSERT_DOUBLE_EQUAL(x[1] - x[0], 1000.0 * cos(lat[0]), 1E-8);
+  CU_ASSERT_DOUBLE_EQUAL(z[1] - z[0], 1000.0 * sin(lat[0]), 1E-8);
+
+  /* round trips, fast matches exact */
+
+  frameCoordinates(lat, lon, height, FRAME_COUNT);
+  height[5] = 2E7;
+  height[6] = -5E6;
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEcef(lat, lon, height, FRAME_COUNT, x, y, z, NMEALIB_FRAME_EXACT), true);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEcef(lat, lon, height, FRAME_COUNT, fx, fy, fz, NMEALIB_FRAME_FAST), true);
+  CU_ASSERT_EQUAL(nmeaFrameEcefToGeodetic(x, y, z, FRAME_COUNT, lat2, lon2, height2), true);
+  for (i = 0; i < FRAME_COUNT; i++) {
+    CU_ASSERT_DOUBLE_EQUAL(fx[i], x[i], 1E-8);
+    CU_ASSERT_DOUBLE_EQUAL(fy[i], y[i], 1E-8);
+    CU_ASSERT_DOUBLE_EQUAL(fz[i], z[i], 1E-8);
+    CU_ASSERT_DOUBLE_EQUAL(lat2[i], lat[i], 1E-14);
+    CU_ASSERT_DOUBLE_EQUAL(height2[i], height[i], 1E-7);
+    CU_ASSERT_DOUBLE_EQUAL(remainder(lon2[i] - lon[i], 2.0 * NMEALIB_PI) * cos(lat[i]), 0.0, 1E-14);
+  }
+
+  CU_ASSERT_EQUAL(nmeaFrameEcefToGeodetic(x, y, z, FRAME_COUNT, lat2, lon2, NULL), true);
+  CU_ASSERT_DOUBLE_EQUAL(lat2[FRAME_COUNT - 1], lat[FRAME_COUNT - 1], 1E-14);
+}
+
+static void test_nmeaFrameEnu(void) {
+  NmeaFrameOrigin origin;
+  NmeaPosition position;
+  double lat[FRAME_COUNT];
+  double lon[FRAME_COUNT];
+  double height[FRAME_COUNT];
+  double east[FRAME_COUNT];
+  double north[FRAME_COUNT];
+  double up[FRAME_COUNT];
+  double fast[3][FRAME_COUNT];
+  double lat2[FRAME_COUNT];
+  double lon2[FRAME_COUNT];
+  double height2[FRAME_COUNT];
+  size_t i;
+
+  position.lat = nmeaMathDegreeToRadian(52.0);
+  position.lon = nmeaMathDegreeToRadian(5.0);
+
+  /* invalid inputs */
+
+  CU_ASSERT_EQUAL(nmeaFrameOriginInit(NULL, &position, 0.0), false);
+  CU_ASSERT_EQUAL(nmeaFrameOriginInit(&origin, NULL, 0.0), false);
+  CU_ASSERT_EQUAL(nmeaFrameOriginInit(&origin, &position, 10.0), true);
+
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEnu(NULL, lat, lon, height, 1, east, north, up, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEnu(&origin, NULL, lon, height, 1, east, north, up, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEnu(&origin, lat, NULL, height, 1, east, north, up, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEnu(&origin, lat, lon, height, 1, NULL, north, up, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEnu(&origin, lat, lon, height, 1, east, NULL, up, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameEnuToGeodetic(NULL, east, north, up, 1, lat2, lon2, height2), false);
+  CU_ASSERT_EQUAL(nmeaFrameEnuToGeodetic(&origin, NULL, north, up, 1, lat2, lon2, height2), false);
+  CU_ASSERT_EQUAL(nmeaFrameEnuToGeodetic(&origin, east, NULL, up, 1, lat2, lon2, height2), false);
+  CU_ASSERT_EQUAL(nmeaFrameEnuToGeodetic(&origin, east, north, up, 1, NULL, lon2, height2), false);
+  CU_ASSERT_EQUAL(nmeaFrameEnuToGeodetic(&origin, east, north, up, 1, lat2, NULL, height2), false);
+
+  /* the origin, above it, north and east of it */
+
+  lat[0] = position.lat;
+  lon[0] = position.lon;
+  height[0] = 10.0;
+  lat[1] = position.lat;
+  lon[1] = position.lon;
+  height[1] = 110.0;
+  lat[2] = position.lat + 1E-5;
+  lon[2] = position.lon;
+  height[2] = 10.0;
+  lat[3] = position.lat;
+  lon[3] = position.lon + 1E-5;
+  height[3] = 10.0;
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEnu(&origin, lat, lon, height, 4, east, north, up, NMEALIB_FRAME_EXACT), true);
+  CU_ASSERT_DOUBLE_EQUAL(east[0], 0.0, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(north[0], 0.0, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(up[0], 0.0, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(east[1], 0.0, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(north[1], 0.0, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(up[1], 100.0, 1E-9);
+
+  /* the meridian radius of curvature at 52N: 6375149.741 m */
+  CU_ASSERT_DOUBLE_EQUAL(east[2], 0.0, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(north[2], 63.75149741 + (10.0 * 1E-5), 1E-3);
+  CU_ASSERT(up[2] < 0.0);
+
+  /* the prime vertical radius of curvature at 52N: 6391435.268 m */
+  CU_ASSERT_DOUBLE_EQUAL(east[3], (63.91435268 + (10.0 * 1E-5)) * cos(position.lat), 1E-3);
+  CU_ASSERT(north[3] > 0.0);
+  CU_ASSERT(up[3] < 0.0);
+
+  /* round trips, fast matches exact */
+
+  for (i = 0; i < FRAME_COUNT; i++) {
+    lat[i] = position.lat + (sin((double) i * 0.7) * 0.01);
+    lon[i] = position.lon + (cos((double) i * 1.3) * 0.01);
+    height[i] = sin((double) i * 0.3) * 500.0;
+  }
+
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEnu(&origin, lat, lon, height, FRAME_COUNT, east, north, up,
+      NMEALIB_FRAME_EXACT), true);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEnu(&origin, lat, lon, height, FRAME_COUNT, fast[0], fast[1], fast[2],
+      NMEALIB_FRAME_FAST), true);
+  CU_ASSERT_EQUAL(nmeaFrameEnuToGeodetic(&origin, east, north, up, FRAME_COUNT, lat2, lon2, height2), true);
+  for (i = 0; i < FRAME_COUNT; i++) {
+    CU_ASSERT_DOUBLE_EQUAL(fast[0][i], east[i], 1E-8);
+    CU_ASSERT_DOUBLE_EQUAL(fast[1][i], north[i], 1E-8);
+    CU_ASSERT_DOUBLE_EQUAL(fast[2][i], up[i], 1E-8);
+    CU_ASSERT_DOUBLE_EQUAL(lat2[i], lat[i], 1E-14);
+    CU_ASSERT_DOUBLE_EQUAL(lon2[i], lon[i], 1E-14);
+    CU_ASSERT_DOUBLE_EQUAL(height2[i], height[i], 1E-8);
+  }
+
+  /* without heights: on the ellipsoid, without up: in the tangent plane */
+
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEnu(&origin, lat, lon, NULL, FRAME_COUNT, east, north, up,
+      NMEALIB_FRAME_EXACT), true);
+  CU_ASSERT_EQUAL(nmeaFrameEnuToGeodetic(&origin, east, north, up, FRAME_COUNT, lat2, lon2, height2), true);
+  for (i = 0; i < FRAME_COUNT; i++) {
+    CU_ASSERT_DOUBLE_EQUAL(height2[i], 0.0, 1E-8);
+  }
+
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToEnu(&origin, lat, lon, NULL, FRAME_COUNT, fast[0], fast[1], NULL,
+      NMEALIB_FRAME_EXACT), true);
+  CU_ASSERT_DOUBLE_EQUAL(fast[0][FRAME_COUNT - 1], east[FRAME_COUNT - 1], 0.0);
+  CU_ASSERT_DOUBLE_EQUAL(fast[1][FRAME_COUNT - 1], north[FRAME_COUNT - 1], 0.0);
+
+  east[0] = 0.0;
+  north[0] = 0.0;
+  CU_ASSERT_EQUAL(nmeaFrameEnuToGeodetic(&origin, east, north, NULL, 1, lat2, lon2, height2), true);
+  CU_ASSERT_DOUBLE_EQUAL(lat2[0], position.lat, 1E-15);
+  CU_ASSERT_DOUBLE_EQUAL(height2[0], 10.0, 1E-8);
+  CU_ASSERT_EQUAL(nmeaFrameEnuToGeodetic(&origin, east, north, NULL, FRAME_COUNT, lat2, lon2, NULL), true);
+}
+
+static void test_nmeaFrameUtmZone(void) {
+  NmeaPosition position;
+
+  /* invalid inputs */
+
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(NULL), 0);
+  position.lat = NaN;
+  position.lon = 0.0;
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(&position), 0);
+  position.lat = 0.0;
+  position.lon = NaN;
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(&position), 0);
+
+  /* regular zones, the antimeridian */
+
+  position.lat = nmeaMathDegreeToRadian(52.1);
+  position.lon = nmeaMathDegreeToRadian(5.1);
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(&position), 31);
+  position.lon = nmeaMathDegreeToRadian(6.0);
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(&position), 32);
+  position.lat = nmeaMathDegreeToRadian(-33.9);
+  position.lon = nmeaMathDegreeToRadian(151.2);
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(&position), 56);
+  position.lon = nmeaMathDegreeToRadian(-180.0);
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(&position), 1);
+  position.lon = nmeaMathDegreeToRadian(179.9);
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(&position), 60);
+  position.lon = nmeaMathDegreeToRadian(360.0 + 5.1);
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(&position), 31);
+
+  /* southern Norway and Svalbard */
+
+  position.lat = nmeaMathDegreeToRadian(60.4);
+  position.lon = nmeaMathDegreeToRadian(5.3);
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(&position), 32);
+  position.lat = nmeaMathDegreeToRadian(78.2);
+  position.lon = nmeaMathDegreeToRadian(8.0);
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(&position), 31);
+  position.lon = nmeaMathDegreeToRadian(15.6);
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(&position), 33);
+  position.lon = nmeaMathDegreeToRadian(25.0);
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(&position), 35);
+  position.lon = nmeaMathDegreeToRadian(40.0);
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(&position), 37);
+  position.lon = nmeaMathDegreeToRadian(43.0);
+  CU_ASSERT_EQUAL(nmeaFrameUtmZone(&position), 38);
+}
+
+static void test_nmeaFrameUtm(void) {
+  double lat[FRAME_COUNT];
+  double lon[FRAME_COUNT];
+  double easting[FRAME_COUNT];
+  double northing[FRAME_COUNT];
+  double fastEasting[FRAME_COUNT];
+  double fastNorthing[FRAME_COUNT];
+  double lat2[FRAME_COUNT];
+  double lon2[FRAME_COUNT];
+  double lat3[FRAME_COUNT];
+  double lon3[FRAME_COUNT];
+  size_t i;
+
+  memset(lat, 0, sizeof(lat));
+  memset(lon, 0, sizeof(lon));
+  memset(easting, 0, sizeof(easting));
+  memset(northing, 0, sizeof(northing));
+
+  /* invalid inputs */
+
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToUtm(0, false, lat, lon, 1, easting, northing, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToUtm(61, false, lat, lon, 1, easting, northing, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToUtm(31, false, NULL, lon, 1, easting, northing, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToUtm(31, false, lat, NULL, 1, easting, northing, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToUtm(31, false, lat, lon, 1, NULL, northing, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToUtm(31, false, lat, lon, 1, easting, NULL, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameUtmToGeodetic(0, false, easting, northing, 1, lat, lon, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameUtmToGeodetic(61, false, easting, northing, 1, lat, lon, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameUtmToGeodetic(31, false, NULL, northing, 1, lat, lon, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameUtmToGeodetic(31, false, easting, NULL, 1, lat, lon, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameUtmToGeodetic(31, false, easting, northing, 1, NULL, lon, NMEALIB_FRAME_EXACT), false);
+  CU_ASSERT_EQUAL(nmeaFrameUtmToGeodetic(31, false, easting, northing, 1, lat, NULL, NMEALIB_FRAME_EXACT), false);
+
+  /* the central meridian at the equator, in both hemispheres */
+
+  lat[0] = 0.0;
+  lon[0] = nmeaMathDegreeToRadian(3.0);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToUtm(31, false, lat, lon, 1, easting, northing, NMEALIB_FRAME_EXACT), true);
+  CU_ASSERT_DOUBLE_EQUAL(easting[0], NMEALIB_UTM_EASTING, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(northing[0], 0.0, 1E-9);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToUtm(31, true, lat, lon, 1, easting, northing, NMEALIB_FRAME_EXACT), true);
+  CU_ASSERT_DOUBLE_EQUAL(northing[0], NMEALIB_UTM_NORTHING_SOUTH, 1E-9);
+
+  /* the meridian arc (integrated numerically), a position in the Netherlands */
+
+  lat[0] = nmeaMathDegreeToRadian(45.0);
+  lon[0] = nmeaMathDegreeToRadian(3.0);
+  lat[1] = nmeaMathDegreeToRadian(-30.0);
+  lon[1] = nmeaMathDegreeToRadian(3.0);
+  lat[2] = nmeaMathDegreeToRadian(52.1);
+  lon[2] = nmeaMathDegreeToRadian(5.1);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToUtm(31, false, lat, lon, 3, easting, northing, NMEALIB_FRAME_EXACT), true);
+  CU_ASSERT_DOUBLE_EQUAL(easting[0], NMEALIB_UTM_EASTING, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(northing[0], 4982950.400226721, 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(northing[1], -3318785.3525812137, 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(easting[2], 643836.81138510114, 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(northing[2], 5774240.986394332, 1E-6);
+
+  /* round trips (also outside of the zone), fast matches exact */
+
+  for (i = 0; i < FRAME_COUNT; i++) {
+    lat[i] = nmeaMathDegreeToRadian(sin((double) i * 0.7) * 84.0);
+    lon[i] = nmeaMathDegreeToRadian(-57.0 + (cos((double) i * 1.3) * 9.0));
+  }
+
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToUtm(21, true, lat, lon, FRAME_COUNT, easting, northing, NMEALIB_FRAME_EXACT),
+      true);
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToUtm(21, true, lat, lon, FRAME_COUNT, fastEasting, fastNorthing,
+      NMEALIB_FRAME_FAST), true);
+  CU_ASSERT_EQUAL(nmeaFrameUtmToGeodetic(21, true, easting, northing, FRAME_COUNT, lat2, lon2, NMEALIB_FRAME_EXACT),
+      true);
+  CU_ASSERT_EQUAL(nmeaFrameUtmToGeodetic(21, true, easting, northing, FRAME_COUNT, lat3, lon3, NMEALIB_FRAME_FAST),
+      true);
+  for (i = 0; i < FRAME_COUNT; i++) {
+    CU_ASSERT_DOUBLE_EQUAL(fastEasting[i], easting[i], 1E-8);
+    CU_ASSERT_DOUBLE_EQUAL(fastNorthing[i], northing[i], 1E-8);
+    CU_ASSERT_DOUBLE_EQUAL(lat2[i], lat[i], 1E-14);
+    CU_ASSERT_DOUBLE_EQUAL(lon2[i], lon[i], 1E-13);
+    CU_ASSERT_DOUBLE_EQUAL(lat3[i], lat[i], 1E-14);
+    CU_ASSERT_DOUBLE_EQUAL(lon3[i], lon[i], 1E-13);
+  }
+
+  /* the antimeridian */
+
+  lat[0] = nmeaMathDegreeToRadian(-17.5);
+  lon[0] = nmeaMathDegreeToRadian(179.5);
+  lon[1] = nmeaMathDegreeToRadian(-179.5);
+  lat[1] = lat[0];
+  CU_ASSERT_EQUAL(nmeaFrameGeodeticToUtm(60, true, lat, lon, 2, easting, northing, NMEALIB_FRAME_EXACT), true);
+  CU_ASSERT(easting[1] > easting[0]);
+  CU_ASSERT_EQUAL(nmeaFrameUtmToGeodetic(60, true, easting, northing, 2, lat2, lon2, NMEALIB_FRAME_EXACT), true);
+  CU_ASSERT_DOUBLE_EQUAL(lon2[0], lon[0], 1E-13);
+  CU_ASSERT_DOUBLE_EQUAL(lon2[1], lon[1], 1E-13);
+}
+
+/*
+ * Setup
+ */
+
+int frameSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("frame", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaFrameSplit", test_nmeaFrameSplit)) //
+      || (!CU_add_test(pSuite, "nmeaFrameEcef", test_nmeaFrameEcef)) //
+      || (!CU_add_test(pSuite, "nmeaFrameEnu", test_nmeaFrameEnu)) //
+      || (!CU_add_test(pSuite, "nmeaFrameUtmZone", test_nmeaFrameUtmZone)) //
+      || (!CU_add_test(pSuite, "nmeaFrameUtm", test_nmeaFrameUtm)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
@@ -18,6 +18,7 @@
 #include "testHelpers.h"
 
 #include <nmealib/generator.h>
+#include <nmealib/nmath.h>
 #include <CUnit/Basic.h>
 #include <float.h>
 #include <stddef.h>
@@ -942,6 +943,169 @@ static void test_nmeaGeneratorCreate(void) {
   nmeaGeneratorDestroy(gen);
 }
 
+static void test_nmeaGeneratorCreateIn(void) {
+  NmeaGenerator nodes[2];
+  NmeaGenerator *gen;
+  NmeaInfo info;
+
+  /* nodes */
+
+  CU_ASSERT_EQUAL(nmeaGeneratorNodes(NMEALIB_GENERATOR_LAST + 1), 0);
+  CU_ASSERT_EQUAL(nmeaGeneratorNodes(NMEALIB_GENERATOR_NOISE), 1);
+  CU_ASSERT_EQUAL(nmeaGeneratorNodes(NMEALIB_GENERATOR_STATIC), 1);
+  CU_ASSERT_EQUAL(nmeaGeneratorNodes(NMEALIB_GENERATOR_SAT_STATIC), 1);
+  CU_ASSERT_EQUAL(nmeaGeneratorNodes(NMEALIB_GENERATOR_SAT_ROTATE), 1);
+  CU_ASSERT_EQUAL(nmeaGeneratorNodes(NMEALIB_GENERATOR_POS_RANDMOVE), 1);
+  CU_ASSERT_EQUAL(nmeaGeneratorNodes(NMEALIB_GENERATOR_ROTATE), 2);
+
+  /* invalid inputs */
+
+  gen = nmeaGeneratorCreateIn(NULL, 2, NMEALIB_GENERATOR_NOISE, &info);
+  CU_ASSERT_PTR_NULL(gen);
+
+  gen = nmeaGeneratorCreateIn(nodes, 2, NMEALIB_GENERATOR_NOISE, NULL);
+  CU_ASSERT_PTR_NULL(gen);
+
+  gen = nmeaGeneratorCreateIn(nodes, 2, NMEALIB_GENERATOR_LAST + 1, &info);
+  CU_ASSERT_PTR_NULL(gen);
+
+  gen = nmeaGeneratorCreateIn(nodes, 1, NMEALIB_GENERATOR_ROTATE, &info);
+  CU_ASSERT_PTR_NULL(gen);
+
+  /* static */
+
+  memset(nodes, 0xaa, sizeof(nodes));
+  gen = nmeaGeneratorCreateIn(nodes, 2, NMEALIB_GENERATOR_STATIC, &info);
+  CU_ASSERT_PTR_EQUAL(gen, &nodes[0]);
+  CU_ASSERT_EQUAL(nodes[0].init, nmeaGeneratorInitStatic);
+  CU_ASSERT_EQUAL(nodes[0].invoke, nmeaGeneratorInvokeStatic);
+  CU_ASSERT_EQUAL(nodes[0].reset, nmeaGeneratorResetStatic);
+  CU_ASSERT_PTR_NULL(nodes[0].random);
+  CU_ASSERT_PTR_NULL(nodes[0].next);
+  CU_ASSERT_EQUAL(info.satellites.inViewCount, 4);
+
+  /* rotate */
+
+  memset(nodes, 0xaa, sizeof(nodes));
+  gen = nmeaGeneratorCreateIn(nodes, 2, NMEALIB_GENERATOR_ROTATE, &info);
+  CU_ASSERT_PTR_EQUAL(gen, &nodes[0]);
+  CU_ASSERT_EQUAL(nodes[0].init, nmeaGeneratorInitRotate);
+  CU_ASSERT_EQUAL(nodes[0].invoke, nmeaGeneratorInvokeRotate);
+  CU_ASSERT_EQUAL(nodes[0].reset, nmeaGeneratorResetRotate);
+  CU_ASSERT_PTR_EQUAL(nodes[0].next, &nodes[1]);
+  CU_ASSERT_EQUAL(nodes[1].init, nmeaGeneratorInitRandomMove);
+  CU_ASSERT_EQUAL(nodes[1].invoke, nmeaGeneratorInvokeRandomMove);
+  CU_ASSERT_PTR_NULL(nodes[1].reset);
+  CU_ASSERT_PTR_NULL(nodes[1].next);
+  CU_ASSERT_EQUAL(info.satellites.inViewCount, 8);
+  CU_ASSERT_DOUBLE_EQUAL(info.speed, 20.0, DBL_EPSILON);
+
+  CU_ASSERT_EQUAL(nmeaGeneratorInvoke(gen, &info), true);
+}
+
+static void test_nmeaGeneratorSetRandom(void) {
+  NmeaGenerator *gen;
+  NmeaGenerator *other;
+  NmeaRandom random;
+  NmeaRandom otherRandom;
+  NmeaInfo info;
+  NmeaInfo otherInfo;
+
+  memset(&info, 0, sizeof(info));
+  memset(&otherInfo, 0, sizeof(otherInfo));
+
+  nmeaGeneratorSetRandom(NULL, &random);
+
+  gen = nmeaGeneratorCreate(NMEALIB_GENERATOR_ROTATE, &info);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(gen);
+  nmeaGeneratorSetRandom(gen, &random);
+  CU_ASSERT_PTR_EQUAL(gen->random, &random);
+  CU_ASSERT_PTR_EQUAL(gen->next->random, &random);
+  nmeaGeneratorSetRandom(gen, NULL);
+  CU_ASSERT_PTR_NULL(gen->random);
+  CU_ASSERT_PTR_NULL(gen->next->random);
+  nmeaGeneratorDestroy(gen);
+
+  /* the same seed gives the same noise */
+
+  gen = nmeaGeneratorCreate(NMEALIB_GENERATOR_NOISE, &info);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(gen);
+  other = nmeaGeneratorCreate(NMEALIB_GENERATOR_NOISE, &otherInfo);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(other);
+
+  nmeaRandomSeed(&random, 1234);
+  nmeaRandomSeed(&otherRandom, 1234);
+  nmeaGeneratorSetRandom(gen, &random);
+  nmeaGeneratorSetRandom(other, &otherRandom);
+
+  CU_ASSERT_EQUAL(nmeaGeneratorInvoke(gen, &info), true);
+  CU_ASSERT_EQUAL(nmeaGeneratorInvoke(other, &otherInfo), true);
+  CU_ASSERT_EQUAL(memcmp(&info, &otherInfo, sizeof(info)), 0);
+
+  CU_ASSERT_EQUAL(nmeaGeneratorInvoke(gen, &info), true);
+  CU_ASSERT_EQUAL(memcmp(&info, &otherInfo, sizeof(info)) != 0, true);
+  CU_ASSERT_EQUAL(nmeaGeneratorInvoke(other, &otherInfo), true);
+  CU_ASSERT_EQUAL(memcmp(&info, &otherInfo, sizeof(info)), 0);
+
+  nmeaGeneratorDestroy(gen);
+  nmeaGeneratorDestroy(other);
+}
+
+static void test_nmeaGeneratorSetMathMode(void) {
+  NmeaGenerator *gen;
+  NmeaGenerator *other;
+  NmeaRandom random;
+  NmeaRandom otherRandom;
+  NmeaInfo info;
+  NmeaInfo otherInfo;
+  NmeaPosition pos;
+  NmeaPosition otherPos;
+  size_t i;
+
+  memset(&info, 0, sizeof(info));
+  memset(&otherInfo, 0, sizeof(otherInfo));
+
+  nmeaGeneratorSetMathMode(NULL, NMEALIB_MATH_FAST);
+
+  gen = nmeaGeneratorCreate(NMEALIB_GENERATOR_ROTATE, &info);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(gen);
+  CU_ASSERT_EQUAL(gen->mathMode, NMEALIB_MATH_EXACT);
+  CU_ASSERT_EQUAL(gen->next->mathMode, NMEALIB_MATH_EXACT);
+  nmeaGeneratorSetMathMode(gen, NMEALIB_MATH_FAST);
+  CU_ASSERT_EQUAL(gen->mathMode, NMEALIB_MATH_FAST);
+  CU_ASSERT_EQUAL(gen->next->mathMode, NMEALIB_MATH_FAST);
+  nmeaGeneratorSetMathMode(gen, NMEALIB_MATH_EXACT);
+  CU_ASSERT_EQUAL(gen->mathMode, NMEALIB_MATH_EXACT);
+  CU_ASSERT_EQUAL(gen->next->mathMode, NMEALIB_MATH_EXACT);
+  nmeaGeneratorDestroy(gen);
+
+  /* fast random moves stay within 0.1 micrometre (1E-10 km) per move of exact ones */
+
+  gen = nmeaGeneratorCreate(NMEALIB_GENERATOR_POS_RANDMOVE, &info);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(gen);
+  other = nmeaGeneratorCreate(NMEALIB_GENERATOR_POS_RANDMOVE, &otherInfo);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(other);
+
+  nmeaRandomSeed(&random, 1234);
+  nmeaRandomSeed(&otherRandom, 1234);
+  nmeaGeneratorSetRandom(gen, &random);
+  nmeaGeneratorSetRandom(other, &otherRandom);
+  nmeaGeneratorSetMathMode(other, NMEALIB_MATH_FAST);
+
+  for (i = 0; i < 100; i++) {
+    CU_ASSERT_EQUAL(nmeaGeneratorInvoke(gen, &info), true);
+    CU_ASSERT_EQUAL(nmeaGeneratorInvoke(other, &otherInfo), true);
+  }
+
+  nmeaMathInfoToPosition(&info, &pos);
+  nmeaMathInfoToPosition(&otherInfo, &otherPos);
+  CU_ASSERT_DOUBLE_EQUAL(otherPos.lat, pos.lat, (100 * 1E-10) / NMEALIB_EARTHRADIUS_KM);
+  CU_ASSERT_DOUBLE_EQUAL(otherPos.lon, pos.lon, (100 * 1E-10) / NMEALIB_EARTHRADIUS_KM);
+
+  nmeaGeneratorDestroy(gen);
+  nmeaGeneratorDestroy(other);
+}
+
 static void test_nmeaGeneratorReset(void) {
   bool r;
   NmeaGenerator gen;
@@ -1183,6 +1347,9 @@ int generatorSuiteSetup(void) {
       || (!CU_add_test(pSuite, "nmeaGeneratorInvokeRandomMove", test_nmeaGeneratorInvokeRandomMove)) //
       || (!CU_add_test(pSuite, "nmeaGeneratorInit", test_nmeaGeneratorInit)) //
       || (!CU_add_test(pSuite, "nmeaGeneratorCreate", test_nmeaGeneratorCreate)) //
+      || (!CU_add_test(pSuite, "nmeaGeneratorCreateIn", test_nmeaGeneratorCreateIn)) //
+      || (!CU_add_test(pSuite, "nmeaGeneratorSetRandom", test_nmeaGeneratorSetRandom)) //
+      || (!CU_add_test(pSuite, "nmeaGeneratorSetMathMode", test_nmeaGeneratorSetMathMode)) //
       || (!CU_add_test(pSuite, "nmeaGeneratorReset", test_nmeaGeneratorReset)) //
       || (!CU_add_test(pSuite, "nmeaGeneratorDestroy", test_nmeaGeneratorDestroy)) //
       || (!CU_add_test(pSuite, "nmeaGeneratorInvoke", test_nmeaGeneratorInvoke)) //
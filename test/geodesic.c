@@ -0,0 +1,415 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/geodesic.h>
+#include <nmealib/nmath.h>
+#include <nmealib/random.h>
+#include <nmealib/util.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+int geodesicSuiteSetup(void);
+
+#define GEODESIC_PAIRS (2000u)
+
+/** The ratio of the distances on WGS84 to the ones of nmeaMathDistanceEllipsoid, which has the semi-minor axis for a */
+#define GEODESIC_SCALE ((double) NMEALIB_EARTHRADIUS_M / NMEALIB_EARTH_SEMIMAJORAXIS_M)
+
+/*
+ * Helpers
+ */
+
+static void geodesicRandomPosition(NmeaRandom *random, NmeaPosition *position) {
+  position->lat = asin(nmeaRandomDouble(random, -1.0, 1.0));
+  position->lon = nmeaRandomDouble(random, -NMEALIB_PI, NMEALIB_PI);
+}
+
+/**
+ * The distance between 2 nearby positions, on a sphere
+ */
+static double geodesicOffset(const NmeaPosition *a, const NmeaPosition *b) {
+  return NMEALIB_EARTHRADIUS_M
+      * sqrt(((a->lat - b->lat) * (a->lat - b->lat)) //
+          + (remainder(a->lon - b->lon, 2.0 * NMEALIB_PI) * cos(a->lat)
+              * remainder(a->lon - b->lon, 2.0 * NMEALIB_PI) * cos(a->lat)));
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaGeodesicOriginInit(void) {
+  NmeaGeodesicOrigin origin;
+  NmeaPosition position;
+
+  /* invalid inputs */
+
+  position.lat = 0.5;
+  position.lon = 0.2;
+  CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(NULL, &position), false);
+  CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, NULL), false);
+
+  position.lat = NaN;
+  CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &position), false);
+
+  position.lat = 0.5;
+  position.lon = NaN;
+  CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &position), false);
+
+  /* normal */
+
+  position.lon = 0.2;
+  memset(&origin, 0, sizeof(origin));
+  CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &position), true);
+  CU_ASSERT_DOUBLE_EQUAL(origin.position.lat, 0.5, 0.0);
+  CU_ASSERT_DOUBLE_EQUAL(origin.position.lon, 0.2, 0.0);
+  CU_ASSERT_DOUBLE_EQUAL(origin.sinBeta / origin.cosBeta, (1.0 - NMEALIB_EARTH_FLATTENING) * tan(0.5), 1E-15);
+
+  /* a pole */
+
+  position.lat = -NMEALIB_PI / 2.0;
+  CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &position), true);
+  CU_ASSERT_DOUBLE_EQUAL(origin.sinBeta, -1.0, 0.0);
+  CU_ASSERT_EQUAL(origin.cosBeta > 0.0, true);
+}
+
+static void test_nmeaGeodesicInverse(void) {
+  NmeaGeodesicOrigin origin;
+  NmeaPosition from;
+  NmeaPosition to;
+  NmeaRandom random;
+  double fromAzimuth;
+  double toAzimuth;
+  double distance;
+  double expected;
+  double expectedFromAzimuth;
+  double expectedToAzimuth;
+  size_t compared = 0;
+  size_t i;
+
+  /* invalid inputs */
+
+  from.lat = 0.5;
+  from.lon = 0.2;
+  to = from;
+  CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &from), true);
+  CU_ASSERT_EQUAL(isnan(nmeaGeodesicInverse(NULL, &to, NULL, NULL)), true);
+  CU_ASSERT_EQUAL(isnan(nmeaGeodesicInverse(&origin, NULL, NULL, NULL)), true);
+  to.lat = NaN;
+  CU_ASSERT_EQUAL(isnan(nmeaGeodesicInverse(&origin, &to, NULL, NULL)), true);
+  to.lat = 0.5;
+  to.lon = NaN;
+  CU_ASSERT_EQUAL(isnan(nmeaGeodesicInverse(&origin, &to, NULL, NULL)), true);
+
+  /* the same position */
+
+  to = from;
+  CU_ASSERT_DOUBLE_EQUAL(nmeaGeodesicInverse(&origin, &to, NULL, NULL), 0.0, 0.0);
+
+  /* the same as nmeaMathDistanceEllipsoid, scaled, below a quarter meridian (beyond, it takes an arc sine of the arc length) */
+
+  nmeaRandomSeed(&random, 41);
+  for (i = 0; i < GEODESIC_PAIRS; i++) {
+    geodesicRandomPosition(&random, &from);
+    geodesicRandomPosition(&random, &to);
+    if (nmeaMathDistance(&from, &to) > 9E6) {
+      continue;
+    }
+
+    CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &from), true);
+    distance = nmeaGeodesicInverse(&origin, &to, &fromAzimuth, &toAzimuth);
+    expected = GEODESIC_SCALE * nmeaMathDistanceEllipsoid(&from, &to, &expectedFromAzimuth, &expectedToAzimuth);
+    CU_ASSERT_DOUBLE_EQUAL(distance, expected, 1E-3);
+
+    /* nmeaMathDistanceEllipsoid returns azimuths modulo pi */
+    CU_ASSERT_DOUBLE_EQUAL(remainder(fromAzimuth - expectedFromAzimuth, NMEALIB_PI), 0.0, 1E-9);
+    CU_ASSERT_DOUBLE_EQUAL(remainder(toAzimuth - expectedToAzimuth, NMEALIB_PI), 0.0, 1E-9);
+    compared++;
+  }
+  CU_ASSERT_EQUAL(compared > (GEODESIC_PAIRS / 4), true);
+
+  /* azimuths */
+
+  from.lat = 0.0;
+  from.lon = 0.0;
+  to.lat = 0.01;
+  to.lon = 0.0;
+  CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &from), true);
+  CU_ASSERT_EQUAL(nmeaGeodesicInverse(&origin, &to, &fromAzimuth, &toAzimuth) > 0.0, true);
+  CU_ASSERT_DOUBLE_EQUAL(fromAzimuth, 0.0, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(toAzimuth, 0.0, 1E-12);
+
+  to.lat = -0.01;
+  CU_ASSERT_EQUAL(nmeaGeodesicInverse(&origin, &to, &fromAzimuth, &toAzimuth) > 0.0, true);
+  CU_ASSERT_DOUBLE_EQUAL(fabs(fromAzimuth), NMEALIB_PI, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(fabs(toAzimuth), NMEALIB_PI, 1E-12);
+
+  to.lat = 0.0;
+  to.lon = -0.01;
+  CU_ASSERT_EQUAL(nmeaGeodesicInverse(&origin, &to, &fromAzimuth, &toAzimuth) > 0.0, true);
+  CU_ASSERT_DOUBLE_EQUAL(fromAzimuth, -NMEALIB_PI / 2.0, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(toAzimuth, -NMEALIB_PI / 2.0, 1E-12);
+
+  /* along the equator */
+
+  to.lon = 1.0;
+  CU_ASSERT_DOUBLE_EQUAL(nmeaGeodesicInverse(&origin, &to, &fromAzimuth, &toAzimuth),
+      NMEALIB_EARTHRADIUS_M, 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(fromAzimuth, NMEALIB_PI / 2.0, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(toAzimuth, NMEALIB_PI / 2.0, 1E-12);
+
+  /* antipodal on the equator: over a pole, as far as from pole to pole */
+
+  to.lon = NMEALIB_PI;
+  distance = nmeaGeodesicInverse(&origin, &to, &fromAzimuth, NULL);
+  CU_ASSERT_DOUBLE_EQUAL(fabs(fromAzimuth), 0.0, 1E-12);
+  from.lat = -NMEALIB_PI / 2.0;
+  to.lat = NMEALIB_PI / 2.0;
+  to.lon = 0.0;
+  CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &from), true);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaGeodesicInverse(&origin, &to, NULL, NULL), distance, 1E-6);
+  CU_ASSERT_EQUAL(distance < (NMEALIB_PI * NMEALIB_EARTHRADIUS_M), true);
+}
+
+static void test_nmeaGeodesicInverseAntipodal(void) {
+  NmeaGeodesicOrigin origin;
+  NmeaGeodesicOrigin reverse;
+  NmeaPosition from;
+  NmeaPosition to;
+  NmeaPosition end;
+  NmeaRandom random;
+  double fromAzimuth;
+  double distance;
+  size_t i;
+
+  nmeaRandomSeed(&random, 42);
+  for (i = 0; i < GEODESIC_PAIRS; i++) {
+    geodesicRandomPosition(&random, &from);
+    to.lat = MAX(-NMEALIB_PI / 2.0, MIN(NMEALIB_PI / 2.0, -from.lat + nmeaRandomDouble(&random, -1E-3, 1E-3)));
+    to.lon = from.lon + NMEALIB_PI + nmeaRandomDouble(&random, -1E-2, 1E-2);
+
+    CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &from), true);
+    CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&reverse, &to), true);
+    distance = nmeaGeodesicInverse(&origin, &to, &fromAzimuth, NULL);
+
+    /* converged: symmetric, and the direct problem ends where it started */
+    CU_ASSERT_EQUAL(distance > 1.99E7, true);
+    CU_ASSERT_EQUAL(distance < 2.01E7, true);
+    CU_ASSERT_DOUBLE_EQUAL(nmeaGeodesicInverse(&reverse, &from, NULL, NULL), distance, 1E-6);
+    CU_ASSERT_EQUAL(nmeaGeodesicDirect(&origin, fromAzimuth, distance, &end, NULL), true);
+    CU_ASSERT_DOUBLE_EQUAL(geodesicOffset(&end, &to), 0.0, 1E-5);
+  }
+
+  /* nearly antipodal across the equator: the spherical estimate is far off, the reference is GeographicLib 2.1 */
+  from.lat = nmeaMathDegreeToRadian(-0.0001);
+  from.lon = 0.0;
+  to.lat = nmeaMathDegreeToRadian(0.0001);
+  to.lon = nmeaMathDegreeToRadian(179.99);
+  CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &from), true);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaGeodesicInverse(&origin, &to, &fromAzimuth, NULL), 20003922.22814904, 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaMathRadianToDegree(fromAzimuth), 179.0497773201411, 1E-9);
+
+  /* nearly equatorial: the longitude difference is very sensitive to the azimuth */
+  from.lat = nmeaMathDegreeToRadian(1.9920615625938288E-14);
+  to.lat = nmeaMathDegreeToRadian(-2.93243106686021E-14);
+  to.lon = nmeaMathDegreeToRadian(178.48068511519642);
+  CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &from), true);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaGeodesicInverse(&origin, &to, NULL, NULL), 19868378.983458266, 1E-6);
+
+  /* mirrored across the equator, within 0.001 degrees of it */
+  for (i = 0; i < GEODESIC_PAIRS; i++) {
+    from.lat = nmeaMathDegreeToRadian(pow(10.0, nmeaRandomDouble(&random, -15.0, -3.0)));
+    if (i & 1) {
+      from.lat = -from.lat;
+    }
+    from.lon = nmeaRandomDouble(&random, -NMEALIB_PI, NMEALIB_PI);
+    to.lat = -from.lat;
+    to.lon = from.lon + NMEALIB_PI - nmeaMathDegreeToRadian(nmeaRandomDouble(&random, -1.0, 1.0));
+
+    CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &from), true);
+    CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&reverse, &to), true);
+    distance = nmeaGeodesicInverse(&origin, &to, &fromAzimuth, NULL);
+
+    /* never longer than to the equator, along it, and back */
+    CU_ASSERT_EQUAL(distance <= ((fabs(remainder(to.lon - from.lon, 2.0 * NMEALIB_PI)) * NMEALIB_EARTHRADIUS_M)
+        + (2.0 * fabs(from.lat) * NMEALIB_EARTHRADIUS_M) + 1E-6), true);
+    CU_ASSERT_DOUBLE_EQUAL(nmeaGeodesicInverse(&reverse, &from, NULL, NULL), distance, 1E-6);
+    CU_ASSERT_EQUAL(nmeaGeodesicDirect(&origin, fromAzimuth, distance, &end, NULL), true);
+    CU_ASSERT_DOUBLE_EQUAL(geodesicOffset(&end, &to), 0.0, 1E-5);
+  }
+}
+
+static void test_nmeaGeodesicInverseNearlyCoincident(void) {
+  NmeaGeodesicOrigin origin;
+  NmeaGeodesicOrigin reverse;
+  NmeaPosition from;
+  NmeaPosition to;
+  NmeaPosition end;
+  NmeaRandom random;
+  double fromAzimuth;
+  double toAzimuth;
+  double distance;
+  double offset;
+  size_t i;
+
+  /* once a negative distance */
+  from.lat = nmeaMathDegreeToRadian(84.817168060605013);
+  from.lon = nmeaMathDegreeToRadian(-101.42751408807352);
+  to.lat = nmeaMathDegreeToRadian(84.817168060605027);
+  to.lon = nmeaMathDegreeToRadian(-101.42751408807318);
+  CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &from), true);
+  distance = nmeaGeodesicInverse(&origin, &to, &fromAzimuth, &toAzimuth);
+  CU_ASSERT_EQUAL(distance >= 0.0, true);
+  CU_ASSERT_DOUBLE_EQUAL(distance, geodesicOffset(&from, &to), 1E-9);
+  CU_ASSERT_EQUAL(isNaN(fromAzimuth), false);
+  CU_ASSERT_EQUAL(isNaN(toAzimuth), false);
+
+  /* 1E-10 to 1E-13 degrees apart, at high latitudes */
+  nmeaRandomSeed(&random, 42);
+  for (i = 0; i < GEODESIC_PAIRS; i++) {
+    double e = nmeaMathDegreeToRadian(pow(10.0, nmeaRandomDouble(&random, -13.0, -10.0)));
+
+    from.lat = nmeaMathDegreeToRadian(nmeaRandomDouble(&random, 60.0, 89.9));
+    if (i & 1) {
+      from.lat = -from.lat;
+    }
+    from.lon = nmeaRandomDouble(&random, -NMEALIB_PI, NMEALIB_PI);
+    to.lat = from.lat + nmeaRandomDouble(&random, -e, e);
+    to.lon = from.lon + nmeaRandomDouble(&random, -e, e);
+
+    CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &from), true);
+    CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&reverse, &to), true);
+    distance = nmeaGeodesicInverse(&origin, &to, &fromAzimuth, &toAzimuth);
+    offset = geodesicOffset(&from, &to);
+
+    CU_ASSERT_EQUAL(distance >= 0.0, true);
+    CU_ASSERT_EQUAL(isNaN(fromAzimuth), false);
+    CU_ASSERT_EQUAL(isNaN(toAzimuth), false);
+    CU_ASSERT_DOUBLE_EQUAL(distance, offset, (0.01 * offset) + 1E-9);
+    CU_ASSERT_DOUBLE_EQUAL(nmeaGeodesicInverse(&reverse, &from, NULL, NULL), distance, 1E-9);
+    CU_ASSERT_EQUAL(nmeaGeodesicDirect(&origin, fromAzimuth, distance, &end, NULL), true);
+
+    /* an ulp of the latitude is about 1.4 nanometre */
+    CU_ASSERT_DOUBLE_EQUAL(geodesicOffset(&end, &to), 0.0, 1E-8);
+  }
+}
+
+static void test_nmeaGeodesicDistances(void) {
+  NmeaGeodesicOrigin origin;
+  NmeaPosition to[16];
+  double distances[16];
+  NmeaRandom random;
+  size_t i;
+
+  nmeaRandomSeed(&random, 43);
+  geodesicRandomPosition(&random, &origin.position);
+  CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &origin.position), true);
+  for (i = 0; i < 16; i++) {
+    geodesicRandomPosition(&random, &to[i]);
+  }
+
+  /* invalid inputs */
+
+  CU_ASSERT_EQUAL(nmeaGeodesicDistances(NULL, to, 16, distances), false);
+  CU_ASSERT_EQUAL(nmeaGeodesicDistances(&origin, NULL, 16, distances), false);
+  CU_ASSERT_EQUAL(nmeaGeodesicDistances(&origin, to, 16, NULL), false);
+
+  /* normal */
+
+  CU_ASSERT_EQUAL(nmeaGeodesicDistances(&origin, to, 0, distances), true);
+  CU_ASSERT_EQUAL(nmeaGeodesicDistances(&origin, to, 16, distances), true);
+  for (i = 0; i < 16; i++) {
+    CU_ASSERT_DOUBLE_EQUAL(distances[i], nmeaGeodesicInverse(&origin, &to[i], NULL, NULL), 0.0);
+  }
+}
+
+static void test_nmeaGeodesicDirect(void) {
+  NmeaGeodesicOrigin origin;
+  NmeaPosition from;
+  NmeaPosition to;
+  NmeaPosition expected;
+  NmeaRandom random;
+  double azimuth;
+  double distance;
+  double toAzimuth;
+  double expectedToAzimuth;
+  size_t i;
+
+  /* invalid inputs */
+
+  from.lat = 0.5;
+  from.lon = 0.2;
+  CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &from), true);
+  CU_ASSERT_EQUAL(nmeaGeodesicDirect(NULL, 0.0, 1000.0, &to, NULL), false);
+  CU_ASSERT_EQUAL(nmeaGeodesicDirect(&origin, 0.0, 1000.0, NULL, NULL), false);
+  CU_ASSERT_EQUAL(nmeaGeodesicDirect(&origin, NaN, 1000.0, &to, NULL), false);
+  CU_ASSERT_EQUAL(nmeaGeodesicDirect(&origin, 0.0, NaN, &to, NULL), false);
+
+  /* no distance */
+
+  CU_ASSERT_EQUAL(nmeaGeodesicDirect(&origin, 1.0, 0.0, &to, &toAzimuth), true);
+  CU_ASSERT_DOUBLE_EQUAL(to.lat, from.lat, 1E-15);
+  CU_ASSERT_DOUBLE_EQUAL(to.lon, from.lon, 1E-15);
+  CU_ASSERT_DOUBLE_EQUAL(toAzimuth, 1.0, 1E-15);
+
+  /* the same as nmeaMathMoveFlatEllipsoid, scaled, and the inverse problem goes back */
+
+  nmeaRandomSeed(&random, 44);
+  for (i = 0; i < GEODESIC_PAIRS; i++) {
+    geodesicRandomPosition(&random, &from);
+    azimuth = nmeaRandomDouble(&random, -NMEALIB_PI, NMEALIB_PI);
+    distance = nmeaRandomDouble(&random, 0.0, 1.9E7);
+
+    CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &from), true);
+    CU_ASSERT_EQUAL(nmeaGeodesicDirect(&origin, azimuth, distance, &to, &toAzimuth), true);
+    CU_ASSERT_EQUAL(nmeaMathMoveFlatEllipsoid(&from, &expected, azimuth, distance / GEODESIC_SCALE, &expectedToAzimuth),
+        true);
+    CU_ASSERT_DOUBLE_EQUAL(geodesicOffset(&to, &expected), 0.0, 1E-3);
+    CU_ASSERT_DOUBLE_EQUAL(remainder(toAzimuth - expectedToAzimuth, 2.0 * NMEALIB_PI), 0.0, 1E-9);
+    CU_ASSERT_EQUAL(fabs(to.lon) <= NMEALIB_PI, true);
+
+    CU_ASSERT_DOUBLE_EQUAL(nmeaGeodesicInverse(&origin, &to, NULL, NULL), distance, 1E-6);
+  }
+}
+
+/*
+ * Setup
+ */
+
+int geodesicSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("geodesic", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaGeodesicOriginInit", test_nmeaGeodesicOriginInit)) //
+      || (!CU_add_test(pSuite, "nmeaGeodesicInverse", test_nmeaGeodesicInverse)) //
+      || (!CU_add_test(pSuite, "nmeaGeodesicInverse (antipodal)", test_nmeaGeodesicInverseAntipodal)) //
+      || (!CU_add_test(pSuite, "nmeaGeodesicInverse (nearly coincident)", test_nmeaGeodesicInverseNearlyCoincident)) //
+      || (!CU_add_test(pSuite, "nmeaGeodesicDistances", test_nmeaGeodesicDistances)) //
+      || (!CU_add_test(pSuite, "nmeaGeodesicDirect", test_nmeaGeodesicDirect)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
@@ -0,0 +1,486 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/geofence.h>
+#include <nmealib/geodesic.h>
+#include <nmealib/nmath.h>
+#include <nmealib/random.h>
+#include <nmealib/util.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+int geofenceSuiteSetup(void);
+
+#define GEOFENCE_CIRCLES (400u)
+#define GEOFENCE_POINTS (2000u)
+#define GEOFENCE_EVENTS (16u)
+
+/**
+ * A recorded transition
+ */
+typedef struct _GeofenceEvent {
+    uint64_t               receiver;
+    uint64_t               fence;
+    NmeaGeofenceTransition transition;
+} GeofenceEvent;
+
+static GeofenceEvent geofenceEvents[GEOFENCE_EVENTS];
+static size_t geofenceEventCount;
+
+static NmeaPosition geofenceCenters[GEOFENCE_CIRCLES];
+static double geofenceRadii[GEOFENCE_CIRCLES];
+
+/*
+ * Helpers
+ */
+
+static void geofenceCallback(void *userData, uint64_t receiver, uint64_t fence, NmeaGeofenceTransition transition) {
+  CU_ASSERT_PTR_EQUAL(userData, &geofenceEventCount);
+  if (geofenceEventCount < GEOFENCE_EVENTS) {
+    geofenceEvents[geofenceEventCount].receiver = receiver;
+    geofenceEvents[geofenceEventCount].fence = fence;
+    geofenceEvents[geofenceEventCount].transition = transition;
+  }
+  geofenceEventCount++;
+}
+
+static void geofencePosition(NmeaPosition *position, double latDegrees, double lonDegrees) {
+  position->lat = nmeaMathDegreeToRadian(latDegrees);
+  position->lon = nmeaMathDegreeToRadian(lonDegrees);
+}
+
+/**
+ * The haversine distance between 2 positions
+ */
+static double geofenceDistance(const NmeaPosition *a, const NmeaPosition *b) {
+  double sinLat = sin((b->lat - a->lat) / 2.0);
+  double sinLon = sin((b->lon - a->lon) / 2.0);
+  double h = (sinLat * sinLat) + (cos(a->lat) * cos(b->lat) * sinLon * sinLon);
+
+  return 2.0 * NMEALIB_EARTHRADIUS_M * asin(MIN(sqrt(h), 1.0));
+}
+
+/**
+ * A random position: half in a region around Amsterdam, the rest near the
+ * antimeridian and the north pole, or anywhere
+ */
+static void geofenceRandomPosition(NmeaRandom *random, size_t i, NmeaPosition *position) {
+  switch (i % 4) {
+    case 0:
+    case 1:
+      geofencePosition(position, 52.0 + nmeaRandomDouble(random, -1.0, 1.0),
+          5.0 + nmeaRandomDouble(random, -1.5, 1.5));
+      break;
+
+    case 2:
+      geofencePosition(position, nmeaRandomDouble(random, 70.0, 90.0), nmeaRandomDouble(random, 175.0, 185.0));
+      break;
+
+    default:
+      position->lat = asin(nmeaRandomDouble(random, -1.0, 1.0));
+      position->lon = nmeaRandomDouble(random, -NMEALIB_PI, NMEALIB_PI);
+      break;
+  }
+}
+
+/**
+ * Check circle sets against brute force distances, with and without the grid
+ */
+static void geofenceCheckCircles(NmeaGeofenceMode mode) {
+  static uint64_t fences[GEOFENCE_CIRCLES];
+  static uint64_t linearFences[GEOFENCE_CIRCLES];
+  NmeaGeofenceSet *set = nmeaGeofenceCreate(mode, 20000.0, NULL, NULL);
+  NmeaGeofenceSet *linear = nmeaGeofenceCreate(mode, 20000.0, NULL, NULL);
+  NmeaGeodesicOrigin origin;
+  NmeaRandom random;
+  size_t checked = 0;
+  size_t i;
+  size_t p;
+
+  CU_ASSERT_PTR_NOT_NULL_FATAL(set);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(linear);
+  nmeaRandomSeed(&random, 43);
+
+  for (i = 0; i < GEOFENCE_CIRCLES; i++) {
+    geofenceRandomPosition(&random, i, &geofenceCenters[i]);
+    /* some circles are larger than the maximum number of cells */
+    geofenceRadii[i] = ((i % 50) == 0) ?
+        nmeaRandomDouble(&random, 1E6, 3E6) :
+        nmeaRandomDouble(&random, 100.0, 50000.0);
+    CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(set, 100 + i, &geofenceCenters[i], geofenceRadii[i]), true);
+    CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(linear, 100 + i, &geofenceCenters[i], geofenceRadii[i]), true);
+  }
+  CU_ASSERT_EQUAL(nmeaGeofenceCount(set), GEOFENCE_CIRCLES);
+  CU_ASSERT_EQUAL(nmeaGeofenceCompile(set), true);
+
+  for (p = 0; p < GEOFENCE_POINTS; p++) {
+    NmeaPosition position;
+    bool ambiguous = false;
+    size_t expected = 0;
+    size_t found;
+    size_t k;
+
+    geofenceRandomPosition(&random, p, &position);
+    if (p & 1) {
+      /* near the edge of a circle */
+      i = p % GEOFENCE_CIRCLES;
+      CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &geofenceCenters[i]), true);
+      nmeaGeodesicDirect(&origin, nmeaRandomDouble(&random, -NMEALIB_PI, NMEALIB_PI),
+          geofenceRadii[i] * nmeaRandomDouble(&random, 0.97, 1.03), &position, NULL);
+    }
+
+    found = nmeaGeofenceContains(set, &position, fences, GEOFENCE_CIRCLES);
+    CU_ASSERT_EQUAL(nmeaGeofenceContains(linear, &position, linearFences, GEOFENCE_CIRCLES), found);
+    CU_ASSERT_EQUAL(nmeaGeofenceContains(set, &position, NULL, 0), found);
+    for (k = 0; k < found; k++) {
+      CU_ASSERT_EQUAL(linearFences[k], fences[k]);
+    }
+
+    for (i = 0; i < GEOFENCE_CIRCLES; i++) {
+      double d;
+
+      if (mode == NMEALIB_GEOFENCE_ELLIPSOIDAL) {
+        CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &geofenceCenters[i]), true);
+        d = nmeaGeodesicInverse(&origin, &position, NULL, NULL);
+      } else {
+        d = geofenceDistance(&geofenceCenters[i], &position);
+      }
+
+      if (fabs(d - geofenceRadii[i]) < 1E-6) {
+        /* too close to call */
+        ambiguous = true;
+        break;
+      }
+
+      if (d <= geofenceRadii[i]) {
+        if (expected < found) {
+          CU_ASSERT_EQUAL(fences[expected], 100 + i);
+        }
+        expected++;
+      }
+    }
+
+    if (!ambiguous) {
+      CU_ASSERT_EQUAL(found, expected);
+      checked++;
+    }
+  }
+  CU_ASSERT_EQUAL(checked > (GEOFENCE_POINTS - 10), true);
+
+  nmeaGeofenceDestroy(set);
+  nmeaGeofenceDestroy(linear);
+}
+
+/**
+ * Check the fences of test_nmeaGeofenceContains
+ */
+static void geofenceCheckFences(const NmeaGeofenceSet *set) {
+  NmeaPosition position;
+  uint64_t fences[4];
+
+  geofencePosition(&position, 52.1, 4.1);
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(set, &position, fences, 4), 2);
+  CU_ASSERT_EQUAL(fences[0], 1);
+  CU_ASSERT_EQUAL(fences[1], 3);
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(set, &position, fences, 1), 2);
+  CU_ASSERT_EQUAL(fences[0], 1);
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(set, &position, NULL, 0), 2);
+
+  geofencePosition(&position, 52.7, 4.5);
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(set, &position, fences, 4), 1);
+  CU_ASSERT_EQUAL(fences[0], 1);
+
+  /* the missing quarter */
+  geofencePosition(&position, 52.7, 5.5);
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(set, &position, fences, 4), 0);
+
+  geofencePosition(&position, 51.9, 5.0);
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(set, &position, fences, 4), 0);
+
+  /* on both sides of the antimeridian, and with a longitude out of range */
+  geofencePosition(&position, -9.5, 179.5);
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(set, &position, fences, 4), 1);
+  CU_ASSERT_EQUAL(fences[0], 2);
+  geofencePosition(&position, -9.5, -179.5);
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(set, &position, fences, 4), 1);
+  geofencePosition(&position, -9.5, 180.5 + 720.0);
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(set, &position, fences, 4), 1);
+  geofencePosition(&position, -9.5, 178.5);
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(set, &position, fences, 4), 0);
+  geofencePosition(&position, -9.5, -178.5);
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(set, &position, fences, 4), 0);
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaGeofenceCreate(void) {
+  NmeaGeofenceSet *set;
+
+  CU_ASSERT_PTR_NULL(nmeaGeofenceCreate((NmeaGeofenceMode) 2, 0.0, NULL, NULL));
+  CU_ASSERT_PTR_NULL(nmeaGeofenceCreate(NMEALIB_GEOFENCE_SPHERICAL, NaN, NULL, NULL));
+  CU_ASSERT_PTR_NULL(nmeaGeofenceCreate(NMEALIB_GEOFENCE_SPHERICAL, NMEALIB_GEOFENCE_CELL_SIZE_MIN / 2.0, NULL, NULL));
+
+  set = nmeaGeofenceCreate(NMEALIB_GEOFENCE_SPHERICAL, 0.0, NULL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(set);
+  CU_ASSERT_EQUAL(nmeaGeofenceCount(set), 0);
+  CU_ASSERT_EQUAL(nmeaGeofenceCompile(set), true);
+  nmeaGeofenceDestroy(set);
+
+  set = nmeaGeofenceCreate(NMEALIB_GEOFENCE_ELLIPSOIDAL, NMEALIB_GEOFENCE_CELL_SIZE_MIN, NULL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(set);
+  nmeaGeofenceDestroy(set);
+
+  nmeaGeofenceDestroy(NULL);
+  CU_ASSERT_EQUAL(nmeaGeofenceCount(NULL), 0);
+  CU_ASSERT_EQUAL(nmeaGeofenceCompile(NULL), false);
+}
+
+static void test_nmeaGeofenceAdd(void) {
+  NmeaGeofenceSet *set = nmeaGeofenceCreate(NMEALIB_GEOFENCE_SPHERICAL, 0.0, NULL, NULL);
+  NmeaPosition center;
+  NmeaPosition vertices[4];
+
+  CU_ASSERT_PTR_NOT_NULL_FATAL(set);
+
+  /* circles */
+
+  geofencePosition(&center, 52.0, 5.0);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(NULL, 1, &center, 100.0), false);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(set, 1, NULL, 100.0), false);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(set, 1, &center, -1.0), false);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(set, 1, &center, NaN), false);
+  center.lat = NaN;
+  CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(set, 1, &center, 100.0), false);
+  center.lat = 2.0;
+  CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(set, 1, &center, 100.0), false);
+  CU_ASSERT_EQUAL(nmeaGeofenceCount(set), 0);
+
+  geofencePosition(&center, 52.0, 5.0);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(set, 1, &center, 100.0), true);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(set, 2, &center, 0.0), true);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(set, 3, &center, 3E7), true);
+
+  /* polygons */
+
+  geofencePosition(&vertices[0], 52.0, 4.0);
+  geofencePosition(&vertices[1], 52.0, 6.0);
+  geofencePosition(&vertices[2], 53.0, 6.0);
+  geofencePosition(&vertices[3], 53.0, 4.0);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddPolygon(NULL, 4, vertices, 4), false);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddPolygon(set, 4, NULL, 4), false);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddPolygon(set, 4, vertices, 2), false);
+  vertices[2].lon = INFINITY;
+  CU_ASSERT_EQUAL(nmeaGeofenceAddPolygon(set, 4, vertices, 4), false);
+  vertices[2].lon = nmeaMathDegreeToRadian(6.0);
+  vertices[2].lat = -2.0;
+  CU_ASSERT_EQUAL(nmeaGeofenceAddPolygon(set, 4, vertices, 4), false);
+
+  /* around the north pole */
+  geofencePosition(&vertices[0], 80.0, 0.0);
+  geofencePosition(&vertices[1], 80.0, 120.0);
+  geofencePosition(&vertices[2], 80.0, -120.0);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddPolygon(set, 4, vertices, 3), false);
+  CU_ASSERT_EQUAL(nmeaGeofenceCount(set), 3);
+
+  geofencePosition(&vertices[2], 85.0, 60.0);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddPolygon(set, 4, vertices, 3), true);
+  CU_ASSERT_EQUAL(nmeaGeofenceCount(set), 4);
+
+  nmeaGeofenceDestroy(set);
+}
+
+static void test_nmeaGeofenceContains(void) {
+  NmeaGeofenceSet *set = nmeaGeofenceCreate(NMEALIB_GEOFENCE_SPHERICAL, 0.0, NULL, NULL);
+  NmeaPosition vertices[6];
+  NmeaPosition position;
+  uint64_t fences[4];
+
+  CU_ASSERT_PTR_NOT_NULL_FATAL(set);
+
+  /* a concave polygon around Amsterdam: a square without its north-eastern quarter */
+  geofencePosition(&vertices[0], 52.0, 4.0);
+  geofencePosition(&vertices[1], 52.0, 6.0);
+  geofencePosition(&vertices[2], 52.5, 6.0);
+  geofencePosition(&vertices[3], 52.5, 5.0);
+  geofencePosition(&vertices[4], 53.0, 5.0);
+  geofencePosition(&vertices[5], 53.0, 4.0);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddPolygon(set, 1, vertices, 6), true);
+
+  /* a polygon across the antimeridian, with longitudes out of range */
+  geofencePosition(&vertices[0], -10.0, 179.0);
+  geofencePosition(&vertices[1], -10.0, 181.0);
+  geofencePosition(&vertices[2], -9.0, -179.0 - 360.0);
+  geofencePosition(&vertices[3], -9.0, 179.0);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddPolygon(set, 2, vertices, 4), true);
+
+  /* a circle that overlaps the first polygon */
+  geofencePosition(&position, 52.1, 4.1);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(set, 3, &position, 5000.0), true);
+
+  /* invalid inputs */
+
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(NULL, &position, fences, 4), 0);
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(set, NULL, fences, 4), 0);
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(set, &position, NULL, 4), 0);
+  position.lat = NaN;
+  CU_ASSERT_EQUAL(nmeaGeofenceContains(set, &position, fences, 4), 0);
+
+  /* not compiled, then compiled */
+
+  geofenceCheckFences(set);
+  CU_ASSERT_EQUAL(nmeaGeofenceCompile(set), true);
+  geofenceCheckFences(set);
+
+  nmeaGeofenceDestroy(set);
+}
+
+static void test_nmeaGeofenceContainsCircles(void) {
+  geofenceCheckCircles(NMEALIB_GEOFENCE_SPHERICAL);
+  geofenceCheckCircles(NMEALIB_GEOFENCE_ELLIPSOIDAL);
+}
+
+static void test_nmeaGeofenceUpdate(void) {
+  NmeaGeofenceSet *set = nmeaGeofenceCreate(NMEALIB_GEOFENCE_ELLIPSOIDAL, 0.0, geofenceCallback,
+      &geofenceEventCount);
+  NmeaPosition center;
+  NmeaPosition position;
+  NmeaInfo info;
+
+  CU_ASSERT_PTR_NOT_NULL_FATAL(set);
+
+  geofencePosition(&center, 52.0, 5.0);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(set, 1, &center, 1000.0), true);
+  geofencePosition(&center, 52.0, 5.01);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(set, 2, &center, 1000.0), true);
+
+  /* invalid inputs */
+
+  geofenceEventCount = 0;
+  geofencePosition(&position, 52.0, 5.0);
+  CU_ASSERT_EQUAL(nmeaGeofenceUpdate(NULL, 7, &position), false);
+  CU_ASSERT_EQUAL(nmeaGeofenceUpdate(set, 7, NULL), false);
+  position.lon = NaN;
+  CU_ASSERT_EQUAL(nmeaGeofenceUpdate(set, 7, &position), false);
+  CU_ASSERT_EQUAL(geofenceEventCount, 0);
+
+  /* the first fix enters */
+
+  geofencePosition(&position, 52.0, 4.99);
+  CU_ASSERT_EQUAL(nmeaGeofenceUpdate(set, 7, &position), true);
+  CU_ASSERT_EQUAL(geofenceEventCount, 1);
+  CU_ASSERT_EQUAL(geofenceEvents[0].receiver, 7);
+  CU_ASSERT_EQUAL(geofenceEvents[0].fence, 1);
+  CU_ASSERT_EQUAL(geofenceEvents[0].transition, NMEALIB_GEOFENCE_ENTER);
+
+  /* staying inside reports nothing */
+
+  geofenceEventCount = 0;
+  geofencePosition(&position, 52.0, 4.995);
+  CU_ASSERT_EQUAL(nmeaGeofenceUpdate(set, 7, &position), true);
+  CU_ASSERT_EQUAL(geofenceEventCount, 0);
+
+  /* into the overlap, then into the second only: the exit comes first */
+
+  geofencePosition(&position, 52.0, 5.005);
+  CU_ASSERT_EQUAL(nmeaGeofenceUpdate(set, 7, &position), true);
+  CU_ASSERT_EQUAL(geofenceEventCount, 1);
+  CU_ASSERT_EQUAL(geofenceEvents[0].fence, 2);
+  CU_ASSERT_EQUAL(geofenceEvents[0].transition, NMEALIB_GEOFENCE_ENTER);
+
+  geofenceEventCount = 0;
+  geofencePosition(&position, 52.0, 5.02);
+  CU_ASSERT_EQUAL(nmeaGeofenceUpdate(set, 7, &position), true);
+  CU_ASSERT_EQUAL(geofenceEventCount, 1);
+  CU_ASSERT_EQUAL(geofenceEvents[0].fence, 1);
+  CU_ASSERT_EQUAL(geofenceEvents[0].transition, NMEALIB_GEOFENCE_EXIT);
+
+  /* jump from the second to the first */
+
+  geofenceEventCount = 0;
+  geofencePosition(&position, 52.0, 4.99);
+  CU_ASSERT_EQUAL(nmeaGeofenceUpdate(set, 7, &position), true);
+  CU_ASSERT_EQUAL(geofenceEventCount, 2);
+  CU_ASSERT_EQUAL(geofenceEvents[0].fence, 2);
+  CU_ASSERT_EQUAL(geofenceEvents[0].transition, NMEALIB_GEOFENCE_EXIT);
+  CU_ASSERT_EQUAL(geofenceEvents[1].fence, 1);
+  CU_ASSERT_EQUAL(geofenceEvents[1].transition, NMEALIB_GEOFENCE_ENTER);
+
+  /* another receiver has its own state */
+
+  geofenceEventCount = 0;
+  geofencePosition(&position, 52.0, 5.6);
+  CU_ASSERT_EQUAL(nmeaGeofenceUpdate(set, 8, &position), true);
+  CU_ASSERT_EQUAL(geofenceEventCount, 0);
+
+  /* from an info structure, in NDEG */
+
+  memset(&info, 0, sizeof(info));
+  CU_ASSERT_EQUAL(nmeaGeofenceUpdateInfo(set, 8, NULL), false);
+  CU_ASSERT_EQUAL(nmeaGeofenceUpdateInfo(set, 8, &info), false);
+  info.latitude = 5200.0;
+  info.longitude = 500.3;
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_LAT);
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_LON);
+  CU_ASSERT_EQUAL(nmeaGeofenceUpdateInfo(NULL, 8, &info), false);
+  CU_ASSERT_EQUAL(nmeaGeofenceUpdateInfo(set, 8, &info), true);
+  CU_ASSERT_EQUAL(geofenceEventCount, 2);
+  CU_ASSERT_EQUAL(geofenceEvents[0].receiver, 8);
+  CU_ASSERT_EQUAL(geofenceEvents[0].fence, 1);
+  CU_ASSERT_EQUAL(geofenceEvents[1].fence, 2);
+
+  /* adding a fence recompiles, the states are kept */
+
+  geofenceEventCount = 0;
+  geofencePosition(&center, 52.0, 4.99);
+  CU_ASSERT_EQUAL(nmeaGeofenceAddCircle(set, 3, &center, 10.0), true);
+  geofencePosition(&position, 52.0, 4.99);
+  CU_ASSERT_EQUAL(nmeaGeofenceUpdate(set, 7, &position), true);
+  CU_ASSERT_EQUAL(geofenceEventCount, 1);
+  CU_ASSERT_EQUAL(geofenceEvents[0].fence, 3);
+  CU_ASSERT_EQUAL(geofenceEvents[0].transition, NMEALIB_GEOFENCE_ENTER);
+
+  nmeaGeofenceDestroy(set);
+}
+
+/*
+ * Setup
+ */
+
+int geofenceSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("geofence", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaGeofenceCreate", test_nmeaGeofenceCreate)) //
+      || (!CU_add_test(pSuite, "nmeaGeofenceAdd", test_nmeaGeofenceAdd)) //
+      || (!CU_add_test(pSuite, "nmeaGeofenceContains", test_nmeaGeofenceContains)) //
+      || (!CU_add_test(pSuite, "nmeaGeofenceContains (circles)", test_nmeaGeofenceContainsCircles)) //
+      || (!CU_add_test(pSuite, "nmeaGeofenceUpdate", test_nmeaGeofenceUpdate)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
@@ -191,6 +191,40 @@ static void test_nmeaGPGGAParse(void) {
   CU_ASSERT_EQUAL(pack.dgpsSid, 42);
 }
 
+static void test_nmeaGPGGAParsePolicy(void) {
+  const char * s = "$GPGGA,999999,,,,,,,,,,,,,";
+  NmeaGPGGA packEmpty;
+  NmeaGPGGA pack;
+  bool r;
+
+  memset(&packEmpty, 0, sizeof(packEmpty));
+  memset(&pack, 0, sizeof(pack));
+
+  /* values are range checked in strict mode only */
+
+  r = nmeaGPGGAParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRICT);
+  validateParsePack(&pack, r, false, 1, 1, true);
+
+  r = nmeaGPGGAParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRUCTURAL);
+  validateParsePack(&pack, r, true, 1, 0, false);
+  CU_ASSERT_EQUAL(pack.present, NMEALIB_PRESENT_UTCTIME);
+  CU_ASSERT_EQUAL(pack.utc.hour, 99);
+
+  r = nmeaGPGGAParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_TRUSTED);
+  validateParsePack(&pack, r, true, 1, 0, false);
+  CU_ASSERT_EQUAL(pack.present, NMEALIB_PRESENT_UTCTIME);
+  CU_ASSERT_EQUAL(pack.utc.hour, 99);
+
+  /* the number of fields is always checked */
+
+  s = "$GPGGA,104559.64,,";
+  r = nmeaGPGGAParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRUCTURAL);
+  validateParsePack(&pack, r, false, 1, 1, true);
+
+  r = nmeaGPGGAParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_TRUSTED);
+  validateParsePack(&pack, r, false, 1, 1, true);
+}
+
 static void test_nmeaGPGGAToInfo(void) {
   NmeaGPGGA pack;
   NmeaInfo infoEmpty;
@@ -850,6 +884,7 @@ int gpggaSuiteSetup(void) {
 
   if ( //
       (!CU_add_test(pSuite, "nmeaGPGGAParse", test_nmeaGPGGAParse)) //
+      || (!CU_add_test(pSuite, "nmeaGPGGAParsePolicy", test_nmeaGPGGAParsePolicy)) //
       || (!CU_add_test(pSuite, "nmeaGPGGAToInfo", test_nmeaGPGGAToInfo)) //
       || (!CU_add_test(pSuite, "nmeaGPGGAFromInfo", test_nmeaGPGGAFromInfo)) //
       || (!CU_add_test(pSuite, "nmeaGPGGAGenerate", test_nmeaGPGGAGenerate)) //
@@ -136,6 +136,41 @@ static void test_nmeaGPGSAParse(void) {
   CU_ASSERT_DOUBLE_EQUAL(pack.vdop, 12.128, FLT_EPSILON);
 }
 
+static void test_nmeaGPGSAParsePolicy(void) {
+  const char * s = "$GPGSA,,42,,,,,,,,,,,,,,,";
+  NmeaGPGSA packEmpty;
+  NmeaGPGSA pack;
+  bool r;
+
+  memset(&packEmpty, 0, sizeof(packEmpty));
+  memset(&pack, 0, sizeof(pack));
+  packEmpty.fix = NMEALIB_FIX_BAD;
+
+  /* values are range checked in strict mode only */
+
+  r = nmeaGPGSAParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRICT);
+  validateParsePack(&pack, r, false, 1, 1, true);
+
+  r = nmeaGPGSAParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRUCTURAL);
+  validateParsePack(&pack, r, true, 1, 0, false);
+  CU_ASSERT_EQUAL(pack.present, NMEALIB_PRESENT_FIX);
+  CU_ASSERT_EQUAL(pack.fix, 42);
+
+  r = nmeaGPGSAParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_TRUSTED);
+  validateParsePack(&pack, r, true, 1, 0, false);
+  CU_ASSERT_EQUAL(pack.present, NMEALIB_PRESENT_FIX);
+  CU_ASSERT_EQUAL(pack.fix, 42);
+
+  /* the number of fields is always checked */
+
+  s = "$GPGSA,A,3,,";
+  r = nmeaGPGSAParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRUCTURAL);
+  validateParsePack(&pack, r, false, 1, 1, true);
+
+  r = nmeaGPGSAParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_TRUSTED);
+  validateParsePack(&pack, r, false, 1, 1, true);
+}
+
 static void test_nmeaGPGSAToInfo(void) {
   size_t i;
   NmeaGPGSA pack;
@@ -624,6 +659,7 @@ int gpgsaSuiteSetup(void) {
 
   if ( //
       (!CU_add_test(pSuite, "nmeaGPGSAParse", test_nmeaGPGSAParse)) //
+      || (!CU_add_test(pSuite, "nmeaGPGSAParsePolicy", test_nmeaGPGSAParsePolicy)) //
       || (!CU_add_test(pSuite, "nmeaGPGSAToInfo", test_nmeaGPGSAToInfo)) //
       || (!CU_add_test(pSuite, "nmeaGPGSAFromInfo", test_nmeaGPGSAFromInfo)) //
       || (!CU_add_test(pSuite, "nmeaGPGSAGenerate", test_nmeaGPGSAGenerate)) //
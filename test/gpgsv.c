@@ -179,6 +179,40 @@ static void test_nmeaGPGSVParse(void) {
   CU_ASSERT_EQUAL(pack.inView[3].snr, 4);
 }
 
+static void test_nmeaGPGSVParsePolicy(void) {
+  const char * s = "$GPGSV,1,1,4,11,,,100,,,,,,,,,,,,";
+  NmeaGPGSV packEmpty;
+  NmeaGPGSV pack;
+  bool r;
+
+  memset(&packEmpty, 0, sizeof(packEmpty));
+  memset(&pack, 0, sizeof(pack));
+
+  /* values are range checked in strict mode only */
+
+  r = nmeaGPGSVParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRICT);
+  validateParsePack(&pack, r, false, 1, 1, true);
+
+  r = nmeaGPGSVParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRUCTURAL);
+  validateParsePack(&pack, r, true, 1, 0, false);
+  CU_ASSERT_EQUAL(pack.inView[0].prn, 11);
+  CU_ASSERT_EQUAL(pack.inView[0].snr, 100);
+
+  r = nmeaGPGSVParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_TRUSTED);
+  validateParsePack(&pack, r, true, 1, 0, false);
+  CU_ASSERT_EQUAL(pack.inView[0].prn, 11);
+  CU_ASSERT_EQUAL(pack.inView[0].snr, 100);
+
+  /* the number of fields is always checked */
+
+  s = "$GPGSV,1,1,4,,,,,,,,,,,,,,,";
+  r = nmeaGPGSVParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRUCTURAL);
+  validateParsePack(&pack, r, false, 1, 1, true);
+
+  r = nmeaGPGSVParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_TRUSTED);
+  validateParsePack(&pack, r, false, 1, 1, true);
+}
+
 static void test_nmeaGPGSVToInfo(void) {
   NmeaGPGSV pack;
   NmeaInfo infoEmpty;
@@ -774,6 +808,7 @@ int gpgsvSuiteSetup(void) {
   if ( //
       (!CU_add_test(pSuite, "nmeaGPGSVsatellitesToSentencesCount", test_nmeaGPGSVsatellitesToSentencesCount)) //
       || (!CU_add_test(pSuite, "nmeaGPGSVParse", test_nmeaGPGSVParse)) //
+      || (!CU_add_test(pSuite, "nmeaGPGSVParsePolicy", test_nmeaGPGSVParsePolicy)) //
       || (!CU_add_test(pSuite, "nmeaGPGSVToInfo", test_nmeaGPGSVToInfo)) //
       || (!CU_add_test(pSuite, "nmeaGPGSVFromInfo", test_nmeaGPGSVFromInfo)) //
       || (!CU_add_test(pSuite, "nmeaGPGSVGenerate", test_nmeaGPGSVGenerate)) //
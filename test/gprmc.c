@@ -241,6 +241,42 @@ static void test_nmeaGPRMCParse(void) {
   CU_ASSERT_EQUAL(pack.magvarEW, 'E');
 }
 
+static void test_nmeaGPRMCParsePolicy(void) {
+  const char * s = "$GPRMC,999999,,,,,,,,,,,";
+  NmeaGPRMC packEmpty;
+  NmeaGPRMC pack;
+  bool r;
+
+  memset(&packEmpty, 0, sizeof(packEmpty));
+  memset(&pack, 0, sizeof(pack));
+
+  /* values are range checked in strict mode only */
+
+  packEmpty.v23 = true;
+  r = nmeaGPRMCParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRICT);
+  validateParsePack(&pack, r, false, 1, 1, true);
+
+  r = nmeaGPRMCParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRUCTURAL);
+  validateParsePack(&pack, r, true, 1, 0, false);
+  CU_ASSERT_EQUAL(pack.present, NMEALIB_PRESENT_UTCTIME);
+  CU_ASSERT_EQUAL(pack.utc.hour, 99);
+
+  r = nmeaGPRMCParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_TRUSTED);
+  validateParsePack(&pack, r, true, 1, 0, false);
+  CU_ASSERT_EQUAL(pack.present, NMEALIB_PRESENT_UTCTIME);
+  CU_ASSERT_EQUAL(pack.utc.hour, 99);
+
+  /* the number of fields is always checked */
+
+  packEmpty.v23 = false;
+  s = "$GPRMC,104559.64,,";
+  r = nmeaGPRMCParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRUCTURAL);
+  validateParsePack(&pack, r, false, 1, 1, true);
+
+  r = nmeaGPRMCParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_TRUSTED);
+  validateParsePack(&pack, r, false, 1, 1, true);
+}
+
 static void test_nmeaGPRMCToInfo(void) {
   NmeaGPRMC pack;
   NmeaInfo infoEmpty;
@@ -1120,6 +1156,7 @@ int gprmcSuiteSetup(void) {
 
   if ( //
       (!CU_add_test(pSuite, "nmeaGPRMCParse", test_nmeaGPRMCParse)) //
+      || (!CU_add_test(pSuite, "nmeaGPRMCParsePolicy", test_nmeaGPRMCParsePolicy)) //
       || (!CU_add_test(pSuite, "nmeaGPRMCToInfo", test_nmeaGPRMCToInfo)) //
       || (!CU_add_test(pSuite, "nmeaGPRMCFromInfo", test_nmeaGPRMCFromInfo)) //
       || (!CU_add_test(pSuite, "nmeaGPRMCGenerate", test_nmeaGPRMCGenerate)) //
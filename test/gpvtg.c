@@ -134,6 +134,40 @@ static void test_nmeaGPVTGParse(void) {
   CU_ASSERT_EQUAL(pack.spnN, 'N');
 }
 
+static void test_nmeaGPVTGParsePolicy(void) {
+  const char * s = "$GPVTG,4.25,q,,,,,,";
+  NmeaGPVTG packEmpty;
+  NmeaGPVTG pack;
+  bool r;
+
+  memset(&packEmpty, 0, sizeof(packEmpty));
+  memset(&pack, 0, sizeof(pack));
+
+  /* values are range checked in strict mode only */
+
+  r = nmeaGPVTGParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRICT);
+  validateParsePack(&pack, r, false, 1, 1, true);
+
+  r = nmeaGPVTGParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRUCTURAL);
+  validateParsePack(&pack, r, true, 1, 0, false);
+  CU_ASSERT_EQUAL(pack.present, NMEALIB_PRESENT_TRACK);
+  CU_ASSERT_DOUBLE_EQUAL(pack.track, 4.25, DBL_EPSILON);
+
+  r = nmeaGPVTGParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_TRUSTED);
+  validateParsePack(&pack, r, true, 1, 0, false);
+  CU_ASSERT_EQUAL(pack.present, NMEALIB_PRESENT_TRACK);
+  CU_ASSERT_DOUBLE_EQUAL(pack.track, 4.25, DBL_EPSILON);
+
+  /* the number of fields is always checked */
+
+  s = "$GPVTG,4.25,T,,";
+  r = nmeaGPVTGParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_STRUCTURAL);
+  validateParsePack(&pack, r, false, 1, 1, true);
+
+  r = nmeaGPVTGParsePolicy(s, strlen(s), &pack, NMEALIB_VALIDATION_TRUSTED);
+  validateParsePack(&pack, r, false, 1, 1, true);
+}
+
 static void test_nmeaGPVTGToInfo(void) {
   NmeaGPVTG pack;
   NmeaInfo infoEmpty;
@@ -452,6 +486,7 @@ int gpvtgSuiteSetup(void) {
 
   if ( //
       (!CU_add_test(pSuite, "nmeaGPVTGParse", test_nmeaGPVTGParse)) //
+      || (!CU_add_test(pSuite, "nmeaGPVTGParsePolicy", test_nmeaGPVTGParsePolicy)) //
       || (!CU_add_test(pSuite, "nmeaGPVTGToInfo", test_nmeaGPVTGToInfo)) //
       || (!CU_add_test(pSuite, "nmeaGPVTGFromInfo", test_nmeaGPVTGFromInfo)) //
       || (!CU_add_test(pSuite, "nmeaGPVTGGenerate", test_nmeaGPVTGGenerate)) //
@@ -0,0 +1,321 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/history.h>
+#include <CUnit/Basic.h>
+#include <float.h>
+#include <string.h>
+
+int historySuiteSetup(void);
+
+/*
+ * Helpers
+ */
+
+static void historyRecord(NmeaRecord *record, int64_t time, double latitude) {
+  memset(record, 0, sizeof(*record));
+  record->time = time;
+  record->present = NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_LAT;
+  record->latitude = latitude;
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaHistoryInit(void) {
+  NmeaHistory history;
+  bool r;
+
+  /* invalid inputs */
+
+  r = nmeaHistoryInit(NULL, 10, 0);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaHistoryInit(&history, 0, 0);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaHistoryInit(&history, 10, -1);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* normal */
+
+  r = nmeaHistoryInit(&history, 10, 5);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_PTR_NOT_NULL(history.records);
+  CU_ASSERT_EQUAL(history.capacity, 10);
+  CU_ASSERT_EQUAL(history.head, 0);
+  CU_ASSERT_EQUAL(history.count, 0);
+  CU_ASSERT_EQUAL(history.maxAge, 5);
+
+  nmeaHistoryDestroy(NULL);
+  nmeaHistoryDestroy(&history);
+  CU_ASSERT_PTR_NULL(history.records);
+  CU_ASSERT_EQUAL(history.capacity, 0);
+}
+
+static void test_nmeaHistoryAdd(void) {
+  NmeaHistory history;
+  NmeaRecord record;
+  const NmeaRecord *p;
+  bool r;
+  int64_t i;
+
+  nmeaHistoryInit(&history, 4, 0);
+
+  /* invalid inputs */
+
+  historyRecord(&record, 10, 1.0);
+  r = nmeaHistoryAdd(NULL, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaHistoryAdd(&history, NULL);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* normal */
+
+  r = nmeaHistoryAdd(&history, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(history.count, 1);
+
+  /* older */
+
+  historyRecord(&record, 9, 2.0);
+  r = nmeaHistoryAdd(&history, &record);
+  CU_ASSERT_EQUAL(r, false);
+  CU_ASSERT_EQUAL(history.count, 1);
+
+  /* same time replaces the newest */
+
+  historyRecord(&record, 10, 3.0);
+  r = nmeaHistoryAdd(&history, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(history.count, 1);
+  p = nmeaHistoryGet(&history, 0);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(p);
+  CU_ASSERT_DOUBLE_EQUAL(p->latitude, 3.0, DBL_EPSILON);
+
+  /* wrap around, dropping the oldest */
+
+  for (i = 11; i <= 20; i++) {
+    historyRecord(&record, i, (double) i);
+    r = nmeaHistoryAdd(&history, &record);
+    CU_ASSERT_EQUAL(r, true);
+  }
+  CU_ASSERT_EQUAL(history.count, 4);
+  for (i = 0; i < 4; i++) {
+    p = nmeaHistoryGet(&history, (size_t) i);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p);
+    CU_ASSERT_EQUAL(p->time, 17 + i);
+  }
+  CU_ASSERT_PTR_NULL(nmeaHistoryGet(&history, 4));
+  CU_ASSERT_PTR_NULL(nmeaHistoryGet(NULL, 0));
+
+  /* clear */
+
+  nmeaHistoryClear(NULL);
+  nmeaHistoryClear(&history);
+  CU_ASSERT_EQUAL(history.count, 0);
+  CU_ASSERT_PTR_NULL(nmeaHistoryGet(&history, 0));
+
+  nmeaHistoryDestroy(&history);
+
+  /* maximum age */
+
+  nmeaHistoryInit(&history, 100, 5);
+  for (i = 0; i < 20; i++) {
+    historyRecord(&record, i * 2, (double) i);
+    nmeaHistoryAdd(&history, &record);
+  }
+  CU_ASSERT_EQUAL(history.count, 3);
+  p = nmeaHistoryGet(&history, 0);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(p);
+  CU_ASSERT_EQUAL(p->time, 34);
+
+  /* not usable after destroy */
+
+  nmeaHistoryDestroy(&history);
+  r = nmeaHistoryAdd(&history, &record);
+  CU_ASSERT_EQUAL(r, false);
+}
+
+static void test_nmeaHistoryAddInfo(void) {
+  NmeaHistory history;
+  NmeaInfo info;
+  const NmeaRecord *p;
+  bool r;
+
+  nmeaHistoryInit(&history, 4, 0);
+
+  memset(&info, 0, sizeof(info));
+  r = nmeaHistoryAddInfo(&history, &info);
+  CU_ASSERT_EQUAL(r, false);
+
+  info.present = NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_LAT;
+  info.utc.year = 1970;
+  info.utc.mon = 1;
+  info.utc.day = 1;
+  info.utc.sec = 1;
+  info.latitude = 5130.0;
+  r = nmeaHistoryAddInfo(&history, &info);
+  CU_ASSERT_EQUAL(r, true);
+
+  p = nmeaHistoryGet(&history, 0);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(p);
+  CU_ASSERT_EQUAL(p->time, 1000000000LL);
+  CU_ASSERT_DOUBLE_EQUAL(p->latitude, 51.5, 1E-9);
+
+  nmeaHistoryDestroy(&history);
+}
+
+static void test_nmeaHistoryFind(void) {
+  NmeaHistory history;
+  NmeaRecord record;
+  size_t first;
+  size_t r;
+  int64_t i;
+
+  nmeaHistoryInit(&history, 8, 0);
+
+  /* empty */
+
+  CU_ASSERT_EQUAL(nmeaHistoryFind(NULL, 0), 0);
+  CU_ASSERT_EQUAL(nmeaHistoryFind(&history, 0), 0);
+
+  first = 42;
+  r = nmeaHistoryRange(&history, 0, 100, &first);
+  CU_ASSERT_EQUAL(r, 0);
+  CU_ASSERT_EQUAL(first, 0);
+
+  /* times 20, 30, ..., 110 with the ring wrapped */
+
+  for (i = 0; i < 12; i++) {
+    historyRecord(&record, i * 10, (double) i);
+    nmeaHistoryAdd(&history, &record);
+  }
+
+  CU_ASSERT_EQUAL(nmeaHistoryFind(&history, 0), 0);
+  CU_ASSERT_EQUAL(nmeaHistoryFind(&history, 40), 0);
+  CU_ASSERT_EQUAL(nmeaHistoryFind(&history, 41), 1);
+  CU_ASSERT_EQUAL(nmeaHistoryFind(&history, 50), 1);
+  CU_ASSERT_EQUAL(nmeaHistoryFind(&history, 110), 7);
+  CU_ASSERT_EQUAL(nmeaHistoryFind(&history, 111), 8);
+
+  /* ranges */
+
+  r = nmeaHistoryRange(NULL, 0, 100, &first);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaHistoryRange(&history, 100, 0, &first);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaHistoryRange(&history, 50, 80, NULL);
+  CU_ASSERT_EQUAL(r, 4);
+
+  r = nmeaHistoryRange(&history, 45, 85, &first);
+  CU_ASSERT_EQUAL(r, 4);
+  CU_ASSERT_EQUAL(first, 1);
+  CU_ASSERT_EQUAL(nmeaHistoryGet(&history, first)->time, 50);
+
+  r = nmeaHistoryRange(&history, INT64_MIN, INT64_MAX, &first);
+  CU_ASSERT_EQUAL(r, 8);
+  CU_ASSERT_EQUAL(first, 0);
+
+  r = nmeaHistoryRange(&history, 111, 200, &first);
+  CU_ASSERT_EQUAL(r, 0);
+  CU_ASSERT_EQUAL(first, 8);
+
+  nmeaHistoryDestroy(&history);
+}
+
+static void test_nmeaHistoryInterpolate(void) {
+  NmeaHistory history;
+  NmeaRecord record;
+  bool r;
+  int64_t i;
+
+  nmeaHistoryInit(&history, 8, 0);
+
+  /* invalid inputs */
+
+  r = nmeaHistoryInterpolate(NULL, 0, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaHistoryInterpolate(&history, 0, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  for (i = 0; i < 4; i++) {
+    historyRecord(&record, 100 + (i * 100), (double) i);
+    nmeaHistoryAdd(&history, &record);
+  }
+
+  r = nmeaHistoryInterpolate(&history, 150, NULL);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* outside of the range */
+
+  r = nmeaHistoryInterpolate(&history, 99, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaHistoryInterpolate(&history, 401, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* exact */
+
+  r = nmeaHistoryInterpolate(&history, 100, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(record.time, 100);
+  CU_ASSERT_DOUBLE_EQUAL(record.latitude, 0.0, DBL_EPSILON);
+
+  r = nmeaHistoryInterpolate(&history, 400, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_DOUBLE_EQUAL(record.latitude, 3.0, DBL_EPSILON);
+
+  /* in between */
+
+  r = nmeaHistoryInterpolate(&history, 275, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(record.time, 275);
+  CU_ASSERT_DOUBLE_EQUAL(record.latitude, 1.75, 1E-9);
+
+  nmeaHistoryDestroy(&history);
+}
+
+/*
+ * Setup
+ */
+
+int historySuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("history", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaHistoryInit", test_nmeaHistoryInit)) //
+      || (!CU_add_test(pSuite, "nmeaHistoryAdd", test_nmeaHistoryAdd)) //
+      || (!CU_add_test(pSuite, "nmeaHistoryAddInfo", test_nmeaHistoryAddInfo)) //
+      || (!CU_add_test(pSuite, "nmeaHistoryFind", test_nmeaHistoryFind)) //
+      || (!CU_add_test(pSuite, "nmeaHistoryInterpolate", test_nmeaHistoryInterpolate)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
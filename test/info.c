@@ -585,6 +585,122 @@ static void test_nmeaTimeSet(void) {
   CU_ASSERT_EQUAL(present, NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME);
 }
 
+static void test_nmeaTimeToEpochNs(void) {
+  NmeaTime utc;
+  int64_t r;
+  time_t t;
+  struct tm tt;
+
+  /* invalid inputs */
+
+  r = nmeaTimeToEpochNs(NULL);
+  CU_ASSERT_EQUAL(r, 0);
+
+  /* epoch */
+
+  memset(&utc, 0, sizeof(utc));
+  utc.year = 1970;
+  utc.mon = 1;
+  utc.day = 1;
+  r = nmeaTimeToEpochNs(&utc);
+  CU_ASSERT_EQUAL(r, 0);
+
+  /* before the epoch */
+
+  memset(&utc, 0, sizeof(utc));
+  utc.year = 1969;
+  utc.mon = 12;
+  utc.day = 31;
+  utc.hour = 23;
+  utc.min = 59;
+  utc.sec = 59;
+  utc.hsec = 50;
+  r = nmeaTimeToEpochNs(&utc);
+  CU_ASSERT_EQUAL(r, -500000000LL);
+
+  /* normal, compare against the c-library */
+
+  for (t = 0; t < (time_t) 4102444800LL; t += (time_t) 7654321) {
+#ifdef WIN32
+    gmtime_s(&tt, &t);
+#else
+    gmtime_r(&t, &tt);
+#endif
+    utc.year = (unsigned int) tt.tm_year + 1900;
+    utc.mon = (unsigned int) tt.tm_mon + 1;
+    utc.day = (unsigned int) tt.tm_mday;
+    utc.hour = (unsigned int) tt.tm_hour;
+    utc.min = (unsigned int) tt.tm_min;
+    utc.sec = (unsigned int) tt.tm_sec;
+    utc.hsec = 42;
+    r = nmeaTimeToEpochNs(&utc);
+    CU_ASSERT_EQUAL(r, ((int64_t) t * 1000000000LL) + 420000000LL);
+  }
+
+  /* leap day */
+
+  memset(&utc, 0, sizeof(utc));
+  utc.year = 2016;
+  utc.mon = 2;
+  utc.day = 29;
+  utc.hour = 12;
+  r = nmeaTimeToEpochNs(&utc);
+  CU_ASSERT_EQUAL(r, 1456747200LL * 1000000000LL);
+}
+
+static void test_nmeaTimeFromEpochNs(void) {
+  NmeaTime utc;
+  NmeaTime utcExpected;
+  int64_t ns;
+
+  /* invalid inputs */
+
+  nmeaTimeFromEpochNs(0, NULL);
+
+  /* epoch */
+
+  memset(&utc, 0xaa, sizeof(utc));
+  memset(&utcExpected, 0, sizeof(utcExpected));
+  utcExpected.year = 1970;
+  utcExpected.mon = 1;
+  utcExpected.day = 1;
+  nmeaTimeFromEpochNs(0, &utc);
+  CU_ASSERT_EQUAL(memcmp(&utc, &utcExpected, sizeof(utc)), 0);
+
+  /* before the epoch */
+
+  memset(&utc, 0xaa, sizeof(utc));
+  utcExpected.year = 1969;
+  utcExpected.mon = 12;
+  utcExpected.day = 31;
+  utcExpected.hour = 23;
+  utcExpected.min = 59;
+  utcExpected.sec = 59;
+  utcExpected.hsec = 50;
+  nmeaTimeFromEpochNs(-500000000LL, &utc);
+  CU_ASSERT_EQUAL(memcmp(&utc, &utcExpected, sizeof(utc)), 0);
+
+  /* truncation of sub-hundredths */
+
+  memset(&utc, 0xaa, sizeof(utc));
+  utcExpected.year = 2016;
+  utcExpected.mon = 2;
+  utcExpected.day = 29;
+  utcExpected.hour = 12;
+  utcExpected.min = 0;
+  utcExpected.sec = 0;
+  utcExpected.hsec = 1;
+  nmeaTimeFromEpochNs((1456747200LL * 1000000000LL) + 19999999LL, &utc);
+  CU_ASSERT_EQUAL(memcmp(&utc, &utcExpected, sizeof(utc)), 0);
+
+  /* round trip */
+
+  for (ns = 0; ns < (4102444800LL * 1000000000LL); ns += 3333333330000000LL) {
+    nmeaTimeFromEpochNs(ns, &utc);
+    CU_ASSERT_EQUAL(nmeaTimeToEpochNs(&utc), ns);
+  }
+}
+
 static void test_nmeaInfoClear(void) {
   NmeaInfo info;
   NmeaInfo infoExpected;
@@ -1665,6 +1781,8 @@ int infoSuiteSetup(void) {
       || (!CU_add_test(pSuite, "nmeaTimeParseTime", test_nmeaTimeParseTime)) //
       || (!CU_add_test(pSuite, "nmeaTimeParseDate", test_nmeaTimeParseDate)) //
       || (!CU_add_test(pSuite, "nmeaTimeSet", test_nmeaTimeSet)) //
+      || (!CU_add_test(pSuite, "nmeaTimeToEpochNs", test_nmeaTimeToEpochNs)) //
+      || (!CU_add_test(pSuite, "nmeaTimeFromEpochNs", test_nmeaTimeFromEpochNs)) //
       || (!CU_add_test(pSuite, "nmeaInfoClear", test_nmeaInfoClear)) //
       || (!CU_add_test(pSuite, "nmeaInfoSanitise", test_nmeaInfoSanitise)) //
       || (!CU_add_test(pSuite, "nmeaInfoUnitConversion", test_nmeaInfoUnitConversion)) //
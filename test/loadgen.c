@@ -0,0 +1,483 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/loadgen.h>
+#include <CUnit/Basic.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+int loadgenSuiteSetup(void);
+
+/*
+ * Helpers
+ */
+
+static void loadgenConfig(NmeaLoadGenConfig *config) {
+  memset(config, 0, sizeof(*config));
+  config->type = NMEALIB_GENERATOR_ROTATE;
+  config->mask = NMEALIB_SENTENCE_GPGGA | NMEALIB_SENTENCE_GPRMC;
+  config->seed = 42;
+}
+
+/**
+ * Read everything that is available from a non-blocking descriptor and check
+ * that it consists of complete sentences
+ */
+static size_t loadgenDrain(int fd, size_t *sentences) {
+  char buf[4096];
+  size_t bytes = 0;
+  ssize_t r;
+
+  while ((r = read(fd, buf, sizeof(buf))) > 0) {
+    ssize_t i;
+
+    for (i = 0; i < r; i++) {
+      if (buf[i] == '\n') {
+        (*sentences)++;
+      }
+    }
+    bytes += (size_t) r;
+  }
+
+  return bytes;
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaLoadGenInit(void) {
+  NmeaLoadGenConfig config;
+  NmeaLoadGen loadgen;
+  bool r;
+
+  loadgenConfig(&config);
+
+  /* invalid inputs */
+
+  r = nmeaLoadGenInit(NULL, &config);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaLoadGenInit(&loadgen, NULL);
+  CU_ASSERT_EQUAL(r, false);
+  CU_ASSERT_EQUAL(loadgen.fd, -1);
+  CU_ASSERT_PTR_NULL(loadgen.gen);
+
+  config.mask = 0;
+  r = nmeaLoadGenInit(&loadgen, &config);
+  CU_ASSERT_EQUAL(r, false);
+
+  loadgenConfig(&config);
+  config.sentencesPerSecond = -1.0;
+  r = nmeaLoadGenInit(&loadgen, &config);
+  CU_ASSERT_EQUAL(r, false);
+
+  loadgenConfig(&config);
+  config.bytesPerSecond = -1.0;
+  r = nmeaLoadGenInit(&loadgen, &config);
+  CU_ASSERT_EQUAL(r, false);
+
+  loadgenConfig(&config);
+  config.type = NMEALIB_GENERATOR_LAST + 1;
+  r = nmeaLoadGenInit(&loadgen, &config);
+  CU_ASSERT_EQUAL(r, false);
+
+  nmeaLoadGenDestroy(NULL);
+
+  /* success */
+
+  loadgenConfig(&config);
+  r = nmeaLoadGenInit(&loadgen, &config);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(loadgen.config.burstFixes, 1);
+  CU_ASSERT_EQUAL(loadgen.fd, -1);
+  CU_ASSERT_EQUAL(loadgen.ptySlave, -1);
+  CU_ASSERT_PTR_NOT_NULL(loadgen.gen);
+
+  /* no output */
+  r = nmeaLoadGenRun(&loadgen, 0.01, 0);
+  CU_ASSERT_EQUAL(r, false);
+
+  nmeaLoadGenDestroy(&loadgen);
+  CU_ASSERT_PTR_NULL(loadgen.gen);
+  CU_ASSERT_EQUAL(loadgen.fd, -1);
+}
+
+static void test_nmeaLoadGenOpen(void) {
+  char dir[] = "/tmp/nmealibLoadGenXXXXXX";
+  char path[64];
+  NmeaLoadGenConfig config;
+  NmeaLoadGen loadgen;
+  int fds[2];
+  bool r;
+
+  loadgenConfig(&config);
+
+  r = nmeaLoadGenOpenFd(NULL, 1);
+  CU_ASSERT_EQUAL(r, false);
+  r = nmeaLoadGenOpenPath(NULL, "/dev/null");
+  CU_ASSERT_EQUAL(r, false);
+  r = nmeaLoadGenOpenUnix(NULL, "/tmp/socket");
+  CU_ASSERT_EQUAL(r, false);
+  r = nmeaLoadGenOpenPty(NULL);
+  CU_ASSERT_EQUAL(r, false);
+
+  CU_ASSERT_EQUAL_FATAL(nmeaLoadGenInit(&loadgen, &config), true);
+
+  r = nmeaLoadGenOpenFd(&loadgen, -1);
+  CU_ASSERT_EQUAL(r, false);
+  r = nmeaLoadGenOpenPath(&loadgen, NULL);
+  CU_ASSERT_EQUAL(r, false);
+  r = nmeaLoadGenOpenPath(&loadgen, "/nonexistent/path");
+  CU_ASSERT_EQUAL(r, false);
+  r = nmeaLoadGenOpenUnix(&loadgen, NULL);
+  CU_ASSERT_EQUAL(r, false);
+  r = nmeaLoadGenOpenUnix(&loadgen, "/nonexistent/socket");
+  CU_ASSERT_EQUAL(r, false);
+  memset(path, 'x', sizeof(path) - 1);
+  path[sizeof(path) - 1] = '\0';
+  r = nmeaLoadGenOpenUnix(&loadgen, path);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* a descriptor of the caller is not closed */
+
+  CU_ASSERT_EQUAL_FATAL(pipe(fds), 0);
+  r = nmeaLoadGenOpenFd(&loadgen, fds[1]);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(loadgen.ownFd, false);
+  CU_ASSERT_EQUAL((fcntl(fds[1], F_GETFL) & O_NONBLOCK) != 0, true);
+
+  /* already opened */
+  r = nmeaLoadGenOpenPath(&loadgen, "/dev/null");
+  CU_ASSERT_EQUAL(r, false);
+  r = nmeaLoadGenOpenPty(&loadgen);
+  CU_ASSERT_EQUAL(r, false);
+
+  nmeaLoadGenDestroy(&loadgen);
+  CU_ASSERT_EQUAL(fcntl(fds[1], F_GETFD) != -1, true);
+  close(fds[0]);
+  close(fds[1]);
+
+  /* a FIFO */
+
+  CU_ASSERT_PTR_NOT_NULL_FATAL(mkdtemp(dir));
+  snprintf(path, sizeof(path), "%s/fifo", dir);
+  CU_ASSERT_EQUAL_FATAL(mkfifo(path, 0600), 0);
+  fds[0] = open(path, O_RDONLY | O_NONBLOCK);
+  CU_ASSERT_EQUAL_FATAL(fds[0] != -1, true);
+
+  CU_ASSERT_EQUAL_FATAL(nmeaLoadGenInit(&loadgen, &config), true);
+  r = nmeaLoadGenOpenPath(&loadgen, path);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(loadgen.ownFd, true);
+
+  r = nmeaLoadGenRun(&loadgen, 0.0, 10);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(loadgen.metrics.sentences, 10);
+
+  nmeaLoadGenDestroy(&loadgen);
+  close(fds[0]);
+  unlink(path);
+  rmdir(dir);
+}
+
+static void test_nmeaLoadGenRun(void) {
+  NmeaLoadGenMetrics metrics;
+  NmeaLoadGenConfig config;
+  NmeaLoadGen loadgen;
+  size_t sentences = 0;
+  size_t bytes;
+  int fds[2];
+  bool r;
+
+  loadgenConfig(&config);
+  CU_ASSERT_EQUAL_FATAL(nmeaLoadGenInit(&loadgen, &config), true);
+  CU_ASSERT_EQUAL_FATAL(pipe(fds), 0);
+  CU_ASSERT_EQUAL_FATAL(fcntl(fds[0], F_SETFL, O_NONBLOCK), 0);
+  CU_ASSERT_EQUAL_FATAL(nmeaLoadGenOpenFd(&loadgen, fds[1]), true);
+
+  /* invalid inputs */
+
+  r = nmeaLoadGenRun(NULL, 0.0, 1);
+  CU_ASSERT_EQUAL(r, false);
+  r = nmeaLoadGenRun(&loadgen, 0.0, 0);
+  CU_ASSERT_EQUAL(r, false);
+  r = nmeaLoadGenRun(&loadgen, -1.0, 1);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* a number of sentences, stopping halfway a fix */
+
+  r = nmeaLoadGenRun(&loadgen, 0.0, 11);
+  CU_ASSERT_EQUAL(r, true);
+
+  bytes = loadgenDrain(fds[0], &sentences);
+  CU_ASSERT_EQUAL(sentences, 11);
+
+  nmeaLoadGenMetrics(&loadgen, &metrics);
+  CU_ASSERT_EQUAL(metrics.fixes, 6);
+  CU_ASSERT_EQUAL(metrics.sentences, 11);
+  CU_ASSERT_EQUAL(metrics.bytes, bytes);
+  CU_ASSERT_EQUAL(metrics.bursts, 6);
+  CU_ASSERT_EQUAL(metrics.blocked, 0);
+  CU_ASSERT_EQUAL(metrics.seconds > 0.0, true);
+  CU_ASSERT_EQUAL(metrics.sentencesPerSecond > 0.0, true);
+  CU_ASSERT_EQUAL(metrics.bytesPerSecond > 0.0, true);
+
+  /* the metrics accumulate */
+
+  r = nmeaLoadGenRun(&loadgen, 0.0, 4);
+  CU_ASSERT_EQUAL(r, true);
+  loadgenDrain(fds[0], &sentences);
+  CU_ASSERT_EQUAL(sentences, 15);
+
+  nmeaLoadGenMetrics(&loadgen, &metrics);
+  CU_ASSERT_EQUAL(metrics.sentences, 15);
+
+  nmeaLoadGenMetrics(NULL, &metrics);
+  CU_ASSERT_EQUAL(metrics.sentences, 0);
+  nmeaLoadGenMetrics(&loadgen, NULL);
+
+  /* a write error */
+
+  signal(SIGPIPE, SIG_IGN);
+  close(fds[0]);
+  r = nmeaLoadGenRun(&loadgen, 0.0, 10);
+  CU_ASSERT_EQUAL(r, false);
+
+  nmeaLoadGenDestroy(&loadgen);
+  close(fds[1]);
+}
+
+static void test_nmeaLoadGenRate(void) {
+  NmeaLoadGenMetrics metrics;
+  NmeaLoadGenConfig config;
+  NmeaLoadGen loadgen;
+  size_t sentences = 0;
+  int fds[2];
+  bool r;
+
+  CU_ASSERT_EQUAL_FATAL(pipe(fds), 0);
+  CU_ASSERT_EQUAL_FATAL(fcntl(fds[0], F_SETFL, O_NONBLOCK), 0);
+
+  /* 1000 sentences per second in bursts of 5 fixes (10 sentences): 50 sentences take 40ms */
+
+  loadgenConfig(&config);
+  config.sentencesPerSecond = 1000.0;
+  config.burstFixes = 5;
+  CU_ASSERT_EQUAL_FATAL(nmeaLoadGenInit(&loadgen, &config), true);
+  CU_ASSERT_EQUAL_FATAL(nmeaLoadGenOpenFd(&loadgen, fds[1]), true);
+
+  r = nmeaLoadGenRun(&loadgen, 0.0, 50);
+  CU_ASSERT_EQUAL(r, true);
+  loadgenDrain(fds[0], &sentences);
+  CU_ASSERT_EQUAL(sentences, 50);
+
+  nmeaLoadGenMetrics(&loadgen, &metrics);
+  CU_ASSERT_EQUAL(metrics.bursts, 5);
+  CU_ASSERT_EQUAL(metrics.fixes, 25);
+  CU_ASSERT_EQUAL(metrics.seconds >= 0.04, true);
+  CU_ASSERT_EQUAL(metrics.seconds < 0.5, true);
+
+  nmeaLoadGenDestroy(&loadgen);
+
+  /* a duration at a byte rate */
+
+  loadgenConfig(&config);
+  config.bytesPerSecond = 20000.0;
+  CU_ASSERT_EQUAL_FATAL(nmeaLoadGenInit(&loadgen, &config), true);
+  CU_ASSERT_EQUAL_FATAL(nmeaLoadGenOpenFd(&loadgen, fds[1]), true);
+
+  r = nmeaLoadGenRun(&loadgen, 0.05, 0);
+  CU_ASSERT_EQUAL(r, true);
+  loadgenDrain(fds[0], &sentences);
+
+  nmeaLoadGenMetrics(&loadgen, &metrics);
+  CU_ASSERT_EQUAL(metrics.seconds >= 0.05, true);
+  CU_ASSERT_EQUAL(metrics.bytes <= 1400, true);
+  CU_ASSERT_EQUAL(metrics.bytes >= 600, true);
+
+  nmeaLoadGenDestroy(&loadgen);
+
+  /* baud emulation: 4800 baud is 480 bytes per second */
+
+  loadgenConfig(&config);
+  config.baud = 4800;
+  config.burstFixes = 100;
+  CU_ASSERT_EQUAL_FATAL(nmeaLoadGenInit(&loadgen, &config), true);
+  CU_ASSERT_EQUAL_FATAL(nmeaLoadGenOpenFd(&loadgen, fds[1]), true);
+
+  r = nmeaLoadGenRun(&loadgen, 0.0, 3);
+  CU_ASSERT_EQUAL(r, true);
+  loadgenDrain(fds[0], &sentences);
+
+  nmeaLoadGenMetrics(&loadgen, &metrics);
+  CU_ASSERT_EQUAL(metrics.sentences, 3);
+  CU_ASSERT_EQUAL(metrics.bursts, 1);
+
+  /* the first 2 sentences occupy the line before the third is written */
+  CU_ASSERT_EQUAL(metrics.seconds >= 0.2, true);
+  CU_ASSERT_EQUAL(metrics.seconds < 0.5, true);
+
+  nmeaLoadGenDestroy(&loadgen);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+static void test_nmeaLoadGenBackpressure(void) {
+  NmeaLoadGenMetrics metrics;
+  NmeaLoadGenConfig config;
+  NmeaLoadGen loadgen;
+  int fds[2];
+  bool r;
+
+  CU_ASSERT_EQUAL_FATAL(pipe(fds), 0);
+
+  /* nobody reads the pipe */
+
+  loadgenConfig(&config);
+  config.burstFixes = 16;
+  CU_ASSERT_EQUAL_FATAL(nmeaLoadGenInit(&loadgen, &config), true);
+  CU_ASSERT_EQUAL_FATAL(nmeaLoadGenOpenFd(&loadgen, fds[1]), true);
+
+  r = nmeaLoadGenRun(&loadgen, 0.05, 0);
+  CU_ASSERT_EQUAL(r, true);
+
+  nmeaLoadGenMetrics(&loadgen, &metrics);
+  CU_ASSERT_EQUAL(metrics.blocked > 0, true);
+  CU_ASSERT_EQUAL(metrics.blockedSeconds > 0.0, true);
+  CU_ASSERT_EQUAL(metrics.blockedSeconds <= metrics.seconds, true);
+  CU_ASSERT_EQUAL(metrics.seconds < 0.5, true);
+
+  nmeaLoadGenDestroy(&loadgen);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+static void test_nmeaLoadGenPty(void) {
+  NmeaLoadGenConfig config;
+  NmeaLoadGen loadgen;
+  size_t sentences = 0;
+  size_t bytes;
+  int fd;
+  bool r;
+
+  loadgenConfig(&config);
+  CU_ASSERT_EQUAL_FATAL(nmeaLoadGenInit(&loadgen, &config), true);
+
+  r = nmeaLoadGenOpenPty(&loadgen);
+  CU_ASSERT_EQUAL_FATAL(r, true);
+  CU_ASSERT_EQUAL(loadgen.ptySlave != -1, true);
+  CU_ASSERT_EQUAL(strncmp(loadgen.ptyName, "/dev/", 5), 0);
+
+  fd = open(loadgen.ptyName, O_RDONLY | O_NOCTTY | O_NONBLOCK);
+  CU_ASSERT_EQUAL_FATAL(fd != -1, true);
+
+  r = nmeaLoadGenRun(&loadgen, 0.0, 8);
+  CU_ASSERT_EQUAL(r, true);
+
+  /* raw mode: the bytes arrive unchanged */
+  bytes = loadgenDrain(fd, &sentences);
+  CU_ASSERT_EQUAL(sentences, 8);
+  CU_ASSERT_EQUAL(bytes, loadgen.metrics.bytes);
+
+  close(fd);
+  nmeaLoadGenDestroy(&loadgen);
+  CU_ASSERT_EQUAL(loadgen.ptySlave, -1);
+}
+
+static void test_nmeaLoadGenUnix(void) {
+  char dir[] = "/tmp/nmealibLoadGenXXXXXX";
+  struct sockaddr_un addr;
+  NmeaLoadGenConfig config;
+  NmeaLoadGen loadgen;
+  size_t sentences = 0;
+  size_t bytes;
+  int server;
+  int client;
+  bool r;
+
+  CU_ASSERT_PTR_NOT_NULL_FATAL(mkdtemp(dir));
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  snprintf(addr.sun_path, sizeof(addr.sun_path), "%s/socket", dir);
+
+  server = socket(AF_UNIX, SOCK_STREAM, 0);
+  CU_ASSERT_EQUAL_FATAL(server != -1, true);
+  CU_ASSERT_EQUAL_FATAL(bind(server, (struct sockaddr *) &addr, sizeof(addr)), 0);
+  CU_ASSERT_EQUAL_FATAL(listen(server, 1), 0);
+
+  loadgenConfig(&config);
+  CU_ASSERT_EQUAL_FATAL(nmeaLoadGenInit(&loadgen, &config), true);
+
+  r = nmeaLoadGenOpenUnix(&loadgen, addr.sun_path);
+  CU_ASSERT_EQUAL_FATAL(r, true);
+
+  client = accept(server, NULL, NULL);
+  CU_ASSERT_EQUAL_FATAL(client != -1, true);
+  CU_ASSERT_EQUAL_FATAL(fcntl(client, F_SETFL, O_NONBLOCK), 0);
+
+  r = nmeaLoadGenRun(&loadgen, 0.0, 20);
+  CU_ASSERT_EQUAL(r, true);
+
+  bytes = loadgenDrain(client, &sentences);
+  CU_ASSERT_EQUAL(sentences, 20);
+  CU_ASSERT_EQUAL(bytes, loadgen.metrics.bytes);
+
+  nmeaLoadGenDestroy(&loadgen);
+  close(client);
+  close(server);
+  unlink(addr.sun_path);
+  rmdir(dir);
+}
+
+/*
+ * Setup
+ */
+
+int loadgenSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("loadgen", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaLoadGenInit", test_nmeaLoadGenInit)) //
+      || (!CU_add_test(pSuite, "nmeaLoadGenOpen", test_nmeaLoadGenOpen)) //
+      || (!CU_add_test(pSuite, "nmeaLoadGenRun", test_nmeaLoadGenRun)) //
+      || (!CU_add_test(pSuite, "nmeaLoadGenRun (rate)", test_nmeaLoadGenRate)) //
+      || (!CU_add_test(pSuite, "nmeaLoadGenRun (backpressure)", test_nmeaLoadGenBackpressure)) //
+      || (!CU_add_test(pSuite, "nmeaLoadGenOpenPty", test_nmeaLoadGenPty)) //
+      || (!CU_add_test(pSuite, "nmeaLoadGenOpenUnix", test_nmeaLoadGenUnix)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
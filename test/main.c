@@ -20,16 +20,37 @@
 #include <stdlib.h>
 
 extern int contextSuiteSetup(void);
+extern int corpusSuiteSetup(void);
+extern int distanceSuiteSetup(void);
+extern int fastmathSuiteSetup(void);
+extern int fleetSuiteSetup(void);
+extern int formatSuiteSetup(void);
+extern int frameSuiteSetup(void);
 extern int generatorSuiteSetup(void);
+extern int geodesicSuiteSetup(void);
+extern int geofenceSuiteSetup(void);
 extern int gpggaSuiteSetup(void);
 extern int gpgsaSuiteSetup(void);
 extern int gpgsvSuiteSetup(void);
 extern int gprmcSuiteSetup(void);
 extern int gpvtgSuiteSetup(void);
+extern int historySuiteSetup(void);
 extern int infoSuiteSetup(void);
+extern int loadgenSuiteSetup(void);
 extern int nmathSuiteSetup(void);
 extern int parserSuiteSetup(void);
+extern int randomSuiteSetup(void);
+extern int recordSuiteSetup(void);
+extern int renderSuiteSetup(void);
+extern int replaySuiteSetup(void);
+extern int scatterSuiteSetup(void);
 extern int sentenceSuiteSetup(void);
+extern int serializeSuiteSetup(void);
+extern int simplifySuiteSetup(void);
+extern int spatialSuiteSetup(void);
+extern int statsSuiteSetup(void);
+extern int trackSuiteSetup(void);
+extern int trackFileSuiteSetup(void);
 extern int utilSuiteSetup(void);
 extern int validateSuiteSetup(void);
 
@@ -42,16 +63,37 @@ int main(void) {
 
   if ( //
       (contextSuiteSetup() != CUE_SUCCESS) //
+      || (corpusSuiteSetup() != CUE_SUCCESS) //
+      || (distanceSuiteSetup() != CUE_SUCCESS) //
+      || (fastmathSuiteSetup() != CUE_SUCCESS) //
+      || (fleetSuiteSetup() != CUE_SUCCESS) //
+      || (formatSuiteSetup() != CUE_SUCCESS) //
+      || (frameSuiteSetup() != CUE_SUCCESS) //
       || (generatorSuiteSetup() != CUE_SUCCESS) //
+      || (geodesicSuiteSetup() != CUE_SUCCESS) //
+      || (geofenceSuiteSetup() != CUE_SUCCESS) //
       || (gpggaSuiteSetup() != CUE_SUCCESS) //
       || (gpgsaSuiteSetup() != CUE_SUCCESS) //
       || (gpgsvSuiteSetup() != CUE_SUCCESS) //
       || (gprmcSuiteSetup() != CUE_SUCCESS) //
       || (gpvtgSuiteSetup() != CUE_SUCCESS) //
+      || (historySuiteSetup() != CUE_SUCCESS) //
       || (infoSuiteSetup() != CUE_SUCCESS) //
+      || (loadgenSuiteSetup() != CUE_SUCCESS) //
       || (nmathSuiteSetup() != CUE_SUCCESS) //
       || (parserSuiteSetup() != CUE_SUCCESS) //
+      || (randomSuiteSetup() != CUE_SUCCESS) //
+      || (recordSuiteSetup() != CUE_SUCCESS) //
+      || (renderSuiteSetup() != CUE_SUCCESS) //
+      || (replaySuiteSetup() != CUE_SUCCESS) //
+      || (scatterSuiteSetup() != CUE_SUCCESS) //
       || (sentenceSuiteSetup() != CUE_SUCCESS) //
+      || (serializeSuiteSetup() != CUE_SUCCESS) //
+      || (simplifySuiteSetup() != CUE_SUCCESS) //
+      || (spatialSuiteSetup() != CUE_SUCCESS) //
+      || (statsSuiteSetup() != CUE_SUCCESS) //
+      || (trackSuiteSetup() != CUE_SUCCESS) //
+      || (trackFileSuiteSetup() != CUE_SUCCESS) //
       || (utilSuiteSetup() != CUE_SUCCESS) //
       || (validateSuiteSetup() != CUE_SUCCESS) //
       ) {
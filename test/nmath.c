@@ -21,6 +21,7 @@
 #include <nmealib/util.h>
 #include <CUnit/Basic.h>
 #include <float.h>
+#include <math.h>
 #include <string.h>
 
 int nmathSuiteSetup(void);
@@ -421,6 +422,84 @@ static void test_nmeaMathMoveFlat(void) {
   CU_ASSERT_DOUBLE_EQUAL(to.lon, 0.054014990832735969294997602219154941849410533905029296875, FLT_EPSILON);
 }
 
+static void test_nmeaMathMoveFlatMode(void) {
+  NmeaPosition from;
+  NmeaPosition exact;
+  NmeaPosition fast;
+  double distances[] = {
+      0.001,
+      1.0,
+      100.0,
+      5000.0 };
+  size_t i;
+  size_t j;
+  bool r;
+
+  /* invalid inputs */
+
+  memset(&from, 0, sizeof(from));
+  memset(&fast, 0, sizeof(fast));
+  r = nmeaMathMoveFlatMode(NULL, &fast, 20.0, 10.0, NMEALIB_MATH_FAST);
+  CU_ASSERT_EQUAL(r, false);
+  r = nmeaMathMoveFlatMode(&from, NULL, 20.0, 10.0, NMEALIB_MATH_FAST);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* NaN */
+
+  from.lat = NaN;
+  r = nmeaMathMoveFlatMode(&from, &fast, 20.0, 1000.0, NMEALIB_MATH_FAST);
+  CU_ASSERT_EQUAL(r, false);
+  CU_ASSERT_EQUAL(isNaN(fast.lat), true);
+  CU_ASSERT_EQUAL(isNaN(fast.lon), true);
+
+  /* the same move as nmeaMathMoveFlat */
+
+  memset(&from, 0, sizeof(from));
+  r = nmeaMathMoveFlatMode(&from, &exact, 20.0, 1000.0, NMEALIB_MATH_EXACT);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_DOUBLE_EQUAL(exact.lat, 0.14725904972540260207125584202003665268421173095703125, FLT_EPSILON);
+  CU_ASSERT_DOUBLE_EQUAL(exact.lon, 0.054014990832735969294997602219154941849410533905029296875, FLT_EPSILON);
+
+  /* fast moves are within 0.1 micrometre (1E-10 km) of exact moves below 85 degrees */
+
+  for (i = 0; i < (sizeof(distances) / sizeof(distances[0])); i++) {
+    for (j = 0; j < 35; j++) {
+      from.lat = nmeaMathDegreeToRadian(-85.0 + (double) (j * 5));
+      from.lon = nmeaMathDegreeToRadian(-175.0 + (double) (j * 10));
+      r = nmeaMathMoveFlatMode(&from, &exact, (double) (j * 10), distances[i], NMEALIB_MATH_EXACT);
+      CU_ASSERT_EQUAL(r, true);
+      r = nmeaMathMoveFlatMode(&from, &fast, (double) (j * 10), distances[i], NMEALIB_MATH_FAST);
+      CU_ASSERT_EQUAL(r, true);
+      CU_ASSERT_DOUBLE_EQUAL(fast.lat, exact.lat, 1E-10 / NMEALIB_EARTHRADIUS_KM);
+      CU_ASSERT_DOUBLE_EQUAL((fast.lon - exact.lon) * cos(exact.lat), 0.0, 1E-10 / NMEALIB_EARTHRADIUS_KM);
+    }
+  }
+
+  /* near the poles: within a millimetre (1E-6 km) to 0.01 degree, within 10 centimetres (1E-4 km) closer */
+
+  for (i = 0; i < (sizeof(distances) / sizeof(distances[0])); i++) {
+    for (j = 0; j < 36; j++) {
+      double d = (j & 2) ?
+          1E-4 :
+          0.01;
+      double tolerance = ((j & 2) ?
+          1E-4 :
+          1E-6) / NMEALIB_EARTHRADIUS_KM;
+
+      from.lat = nmeaMathDegreeToRadian((j & 1) ?
+          d - 90.0 :
+          90.0 - d);
+      from.lon = nmeaMathDegreeToRadian(-175.0 + (double) (j * 10));
+      r = nmeaMathMoveFlatMode(&from, &exact, (double) (j * 10), distances[i], NMEALIB_MATH_EXACT);
+      CU_ASSERT_EQUAL(r, true);
+      r = nmeaMathMoveFlatMode(&from, &fast, (double) (j * 10), distances[i], NMEALIB_MATH_FAST);
+      CU_ASSERT_EQUAL(r, true);
+      CU_ASSERT_DOUBLE_EQUAL(fast.lat, exact.lat, tolerance);
+      CU_ASSERT_DOUBLE_EQUAL(remainder(fast.lon - exact.lon, 2.0 * NMEALIB_PI) * cos(exact.lat), 0.0, tolerance);
+    }
+  }
+}
+
 static void test_nmeaMathMoveFlatEllipsoid(void) {
   NmeaPosition from;
   NmeaPosition to;
@@ -539,6 +618,7 @@ int nmathSuiteSetup(void) {
       || (!CU_add_test(pSuite, "nmeaMathDistanceEllipsoid", test_nmeaMathDistanceEllipsoid)) //
       || (!CU_add_test(pSuite, "nmeaMathDistanceEllipsoid", test_nmeaMathDistanceEllipsoid)) //
       || (!CU_add_test(pSuite, "nmeaMathMoveFlat", test_nmeaMathMoveFlat)) //
+      || (!CU_add_test(pSuite, "nmeaMathMoveFlatMode", test_nmeaMathMoveFlatMode)) //
       || (!CU_add_test(pSuite, "nmeaMathMoveFlatEllipsoid", test_nmeaMathMoveFlatEllipsoid)) //
       ) {
     return CU_get_error();
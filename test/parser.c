@@ -19,6 +19,7 @@
 
 #include <nmealib/parser.h>
 #include <CUnit/Basic.h>
+#include <float.h>
 #include <stddef.h>
 #include <stdlib.h>
 
@@ -161,9 +162,11 @@ static void test_nmeaParserInit(void) {
 
   /* normal */
 
+  parser.validation = NMEALIB_VALIDATION_TRUSTED;
   r = nmeaParserInit(&parser, 0);
   CU_ASSERT_EQUAL(r, true);
   CU_ASSERT_EQUAL(parser.sentence.state, NMEALIB_SENTENCE_STATE_SKIP_UNTIL_START);
+  CU_ASSERT_EQUAL(parser.validation, NMEALIB_VALIDATION_STRICT);
   nmeaParserDestroy(&parser);
   memset(&parser, 0, sizeof(parser));
 }
@@ -550,6 +553,51 @@ static void test_nmeaParserParse(void) {
   nmeaParserDestroy(&parser);
 }
 
+static void test_nmeaParserParseValidation(void) {
+  NmeaParser parser;
+  NmeaInfo info;
+  const char *time = "$GPGGA,250000.00,,,,,,,,,,,,,*7F\r\n";
+  const char *character = "$GPVTG,4.25,~,,,,,,*31\r\n";
+  const char *checksum = "$GPGGA,,,,,,,,,,,,,,*00\r\n";
+  size_t r;
+
+  memset(&info, 0, sizeof(info));
+  nmeaParserInit(&parser, 0);
+
+  /* strict */
+
+  r = nmeaParserParse(&parser, time, strlen(time), &info);
+  CU_ASSERT_EQUAL(r, 0);
+  r = nmeaParserParse(&parser, character, strlen(character), &info);
+  CU_ASSERT_EQUAL(r, 0);
+  r = nmeaParserParse(&parser, checksum, strlen(checksum), &info);
+  CU_ASSERT_EQUAL(r, 0);
+
+  /* structural: no range checks */
+
+  parser.validation = NMEALIB_VALIDATION_STRUCTURAL;
+  r = nmeaParserParse(&parser, time, strlen(time), &info);
+  CU_ASSERT_EQUAL(r, 1);
+  CU_ASSERT_EQUAL(info.utc.hour, 25);
+  r = nmeaParserParse(&parser, character, strlen(character), &info);
+  CU_ASSERT_EQUAL(r, 0);
+  r = nmeaParserParse(&parser, checksum, strlen(checksum), &info);
+  CU_ASSERT_EQUAL(r, 0);
+
+  /* trusted: the checksum only */
+
+  parser.validation = NMEALIB_VALIDATION_TRUSTED;
+  r = nmeaParserParse(&parser, time, strlen(time), &info);
+  CU_ASSERT_EQUAL(r, 1);
+  r = nmeaParserParse(&parser, character, strlen(character), &info);
+  CU_ASSERT_EQUAL(r, 1);
+  CU_ASSERT_DOUBLE_EQUAL(info.track, 4.25, DBL_EPSILON);
+  r = nmeaParserParse(&parser, checksum, strlen(checksum), &info);
+  CU_ASSERT_EQUAL(r, 0);
+
+  nmeaParserDestroy(&parser);
+}
+
 /*
  * Setup
  */
@@ -567,6 +615,7 @@ int parserSuiteSetup(void) {
       || (!CU_add_test(pSuite, "nmeaParserDestroy", test_nmeaParserDestroy)) //
       || (!CU_add_test(pSuite, "nmeaParserProcessCharacter", test_nmeaParserProcessCharacter)) //
       || (!CU_add_test(pSuite, "nmeaParserParse", test_nmeaParserParse)) //
+      || (!CU_add_test(pSuite, "nmeaParserParseValidation", test_nmeaParserParseValidation)) //
       ) {
     return CU_get_error();
   }
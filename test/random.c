@@ -0,0 +1,206 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/random.h>
+#include <CUnit/Basic.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+
+int randomSuiteSetup(void);
+
+/*
+ * Helpers
+ */
+
+static void *randomThread(void *arg) {
+  NmeaRandom **state = arg;
+
+  *state = nmeaRandomThreadState();
+  nmeaRandomNext(*state);
+
+  return NULL;
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaRandomNext(void) {
+  NmeaRandom random;
+
+  /* the reference sequence of xoshiro256** */
+
+  random.s[0] = 1;
+  random.s[1] = 2;
+  random.s[2] = 3;
+  random.s[3] = 4;
+  CU_ASSERT_EQUAL(nmeaRandomNext(&random), 11520ull);
+  CU_ASSERT_EQUAL(nmeaRandomNext(&random), 0ull);
+  CU_ASSERT_EQUAL(nmeaRandomNext(&random), 1509978240ull);
+}
+
+static void test_nmeaRandomSeed(void) {
+  NmeaRandom random;
+  NmeaRandom other;
+  size_t i;
+
+  nmeaRandomSeed(NULL, 0);
+  nmeaRandomSeedEntropy(NULL);
+
+  /* a zero seed gives a valid state */
+
+  nmeaRandomSeed(&random, 0);
+  CU_ASSERT_EQUAL((random.s[0] | random.s[1] | random.s[2] | random.s[3]) != 0, true);
+
+  /* the same seed gives the same sequence, another seed another sequence */
+
+  nmeaRandomSeed(&random, 42);
+  nmeaRandomSeed(&other, 42);
+  for (i = 0; i < 100; i++) {
+    CU_ASSERT_EQUAL(nmeaRandomNext(&random), nmeaRandomNext(&other));
+  }
+
+  nmeaRandomSeed(&other, 43);
+  CU_ASSERT_NOT_EQUAL(nmeaRandomNext(&random), nmeaRandomNext(&other));
+
+  /* entropy */
+
+  nmeaRandomSeedEntropy(&random);
+  nmeaRandomSeedEntropy(&other);
+  CU_ASSERT_EQUAL(memcmp(&random, &other, sizeof(random)) != 0, true);
+}
+
+static void test_nmeaRandomJump(void) {
+  NmeaRandom random;
+  NmeaRandom other;
+  size_t i;
+  size_t j;
+  uint64_t values[64];
+  size_t equal = 0;
+
+  nmeaRandomJump(NULL);
+
+  nmeaRandomSeed(&random, 42);
+  other = random;
+  nmeaRandomJump(&other);
+  CU_ASSERT_EQUAL(memcmp(&random, &other, sizeof(random)) != 0, true);
+
+  /* the streams don't overlap */
+
+  for (i = 0; i < 64; i++) {
+    values[i] = nmeaRandomNext(&random);
+  }
+
+  for (i = 0; i < 1000; i++) {
+    uint64_t v = nmeaRandomNext(&other);
+
+    for (j = 0; j < 64; j++) {
+      if (v == values[j]) {
+        equal++;
+      }
+    }
+  }
+
+  CU_ASSERT_EQUAL(equal, 0);
+}
+
+static void test_nmeaRandomDouble(void) {
+  NmeaRandom random;
+  double sum = 0.0;
+  double r;
+  size_t i;
+
+  nmeaRandomSeed(&random, 42);
+
+  for (i = 0; i < 10000; i++) {
+    r = nmeaRandomDouble(&random, 10.0, 20.0);
+    CU_ASSERT_EQUAL(r >= 10.0, true);
+    CU_ASSERT_EQUAL(r < 20.0, true);
+    sum += r;
+  }
+
+  CU_ASSERT_DOUBLE_EQUAL(sum / 10000.0, 15.0, 0.1);
+
+  r = nmeaRandomDouble(&random, 5.0, 5.0);
+  CU_ASSERT_DOUBLE_EQUAL(r, 5.0, 0.0);
+}
+
+static void test_nmeaRandomFill(void) {
+  double values[150];
+  NmeaRandom random;
+  NmeaRandom other;
+  size_t i;
+
+  nmeaRandomFill(NULL, values, 150, 0.0, 1.0);
+  nmeaRandomFill(&random, NULL, 150, 0.0, 1.0);
+
+  /* the same numbers as nmeaRandomDouble, across blocks */
+
+  nmeaRandomSeed(&random, 42);
+  nmeaRandomSeed(&other, 42);
+  memset(values, 0, sizeof(values));
+
+  nmeaRandomFill(&random, values, 149, -3.0, 7.0);
+  for (i = 0; i < 149; i++) {
+    CU_ASSERT_DOUBLE_EQUAL(values[i], nmeaRandomDouble(&other, -3.0, 7.0), 1E-12);
+  }
+  CU_ASSERT_DOUBLE_EQUAL(values[149], 0.0, 0.0);
+  CU_ASSERT_EQUAL(nmeaRandomNext(&random), nmeaRandomNext(&other));
+}
+
+static void test_nmeaRandomThreadState(void) {
+  NmeaRandom *state = nmeaRandomThreadState();
+  NmeaRandom *other = NULL;
+  pthread_t thread;
+
+  CU_ASSERT_PTR_NOT_NULL_FATAL(state);
+  CU_ASSERT_PTR_EQUAL(nmeaRandomThreadState(), state);
+  CU_ASSERT_EQUAL((state->s[0] | state->s[1] | state->s[2] | state->s[3]) != 0, true);
+
+  CU_ASSERT_EQUAL_FATAL(pthread_create(&thread, NULL, randomThread, &other), 0);
+  pthread_join(thread, NULL);
+
+  CU_ASSERT_PTR_NOT_NULL(other);
+  CU_ASSERT_EQUAL(other != state, true);
+}
+
+/*
+ * Setup
+ */
+
+int randomSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("random", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaRandomNext", test_nmeaRandomNext)) //
+      || (!CU_add_test(pSuite, "nmeaRandomSeed", test_nmeaRandomSeed)) //
+      || (!CU_add_test(pSuite, "nmeaRandomJump", test_nmeaRandomJump)) //
+      || (!CU_add_test(pSuite, "nmeaRandomDouble", test_nmeaRandomDouble)) //
+      || (!CU_add_test(pSuite, "nmeaRandomFill", test_nmeaRandomFill)) //
+      || (!CU_add_test(pSuite, "nmeaRandomThreadState", test_nmeaRandomThreadState)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
@@ -0,0 +1,275 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/nmath.h>
+#include <nmealib/record.h>
+#include <CUnit/Basic.h>
+#include <float.h>
+#include <string.h>
+
+int recordSuiteSetup(void);
+
+/*
+ * Tests
+ */
+
+static void test_nmeaRecordFromInfo(void) {
+  NmeaInfo info;
+  NmeaRecord record;
+  bool r;
+
+  /* invalid inputs */
+
+  memset(&info, 0, sizeof(info));
+  r = nmeaRecordFromInfo(NULL, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaRecordFromInfo(&info, NULL);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* no time */
+
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_UTCDATE);
+  r = nmeaRecordFromInfo(&info, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* original units */
+
+  memset(&info, 0, sizeof(info));
+  info.present = NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_SIG | NMEALIB_PRESENT_FIX
+      | NMEALIB_PRESENT_HDOP | NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON | NMEALIB_PRESENT_ELV | NMEALIB_PRESENT_SPEED
+      | NMEALIB_PRESENT_TRACK | NMEALIB_PRESENT_SATINVIEWCOUNT;
+  info.utc.year = 1970;
+  info.utc.mon = 1;
+  info.utc.day = 2;
+  info.utc.hsec = 10;
+  info.sig = NMEALIB_SIG_DIFFERENTIAL;
+  info.fix = NMEALIB_FIX_3D;
+  info.pdop = 9.0;
+  info.hdop = 1.5;
+  info.latitude = 5130.0;
+  info.longitude = -12015.0;
+  info.elevation = 42.5;
+  info.speed = 10.25;
+  info.track = 359.5;
+
+  r = nmeaRecordFromInfo(&info, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(record.time, (86400LL * 1000000000LL) + 100000000LL);
+  CU_ASSERT_EQUAL(record.present, info.present & NMEALIB_RECORD_PRESENT_MASK);
+  CU_ASSERT_EQUAL(record.sig, NMEALIB_SIG_DIFFERENTIAL);
+  CU_ASSERT_EQUAL(record.fix, NMEALIB_FIX_3D);
+  CU_ASSERT_DOUBLE_EQUAL(record.pdop, 0.0, FLT_EPSILON);
+  CU_ASSERT_DOUBLE_EQUAL(record.hdop, 1.5, FLT_EPSILON);
+  CU_ASSERT_DOUBLE_EQUAL(record.latitude, 51.5, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(record.longitude, -120.25, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(record.elevation, 42.5, FLT_EPSILON);
+  CU_ASSERT_DOUBLE_EQUAL(record.speed, 10.25, FLT_EPSILON);
+  CU_ASSERT_DOUBLE_EQUAL(record.track, 359.5, FLT_EPSILON);
+
+  /* metric units */
+
+  info.metric = true;
+  info.hdop = nmeaMathDopToMeters(1.5);
+  info.latitude = 51.5;
+  info.longitude = -120.25;
+
+  r = nmeaRecordFromInfo(&info, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_DOUBLE_EQUAL(record.hdop, 1.5, 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(record.latitude, 51.5, DBL_EPSILON);
+  CU_ASSERT_DOUBLE_EQUAL(record.longitude, -120.25, DBL_EPSILON);
+}
+
+static void test_nmeaRecordToInfo(void) {
+  NmeaInfo info;
+  NmeaInfo infoExpected;
+  NmeaRecord record;
+
+  /* invalid inputs */
+
+  memset(&record, 0, sizeof(record));
+  memset(&info, 0, sizeof(info));
+  memset(&infoExpected, 0, sizeof(infoExpected));
+  nmeaRecordToInfo(NULL, &info);
+  nmeaRecordToInfo(&record, NULL);
+  CU_ASSERT_EQUAL(memcmp(&info, &infoExpected, sizeof(info)), 0);
+
+  /* nothing present */
+
+  info.latitude = 1234.0;
+  infoExpected.latitude = 1234.0;
+  nmeaRecordToInfo(&record, &info);
+  CU_ASSERT_EQUAL(memcmp(&info, &infoExpected, sizeof(info)), 0);
+
+  /* original units */
+
+  record.time = (86400LL * 1000000000LL) + 100000000LL;
+  record.present = NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_SIG | NMEALIB_PRESENT_FIX
+      | NMEALIB_PRESENT_PDOP | NMEALIB_PRESENT_HDOP | NMEALIB_PRESENT_VDOP | NMEALIB_PRESENT_LAT
+      | NMEALIB_PRESENT_LON | NMEALIB_PRESENT_ELV | NMEALIB_PRESENT_SPEED | NMEALIB_PRESENT_TRACK;
+  record.sig = NMEALIB_SIG_FIX;
+  record.fix = NMEALIB_FIX_2D;
+  record.pdop = 2.0f;
+  record.hdop = 1.5f;
+  record.vdop = 1.25f;
+  record.latitude = 51.5;
+  record.longitude = -120.25;
+  record.elevation = 42.5f;
+  record.speed = 10.25f;
+  record.track = 359.5f;
+
+  memset(&info, 0, sizeof(info));
+  nmeaRecordToInfo(&record, &info);
+  CU_ASSERT_EQUAL(info.present, record.present);
+  CU_ASSERT_EQUAL(info.utc.year, 1970);
+  CU_ASSERT_EQUAL(info.utc.mon, 1);
+  CU_ASSERT_EQUAL(info.utc.day, 2);
+  CU_ASSERT_EQUAL(info.utc.hour, 0);
+  CU_ASSERT_EQUAL(info.utc.min, 0);
+  CU_ASSERT_EQUAL(info.utc.sec, 0);
+  CU_ASSERT_EQUAL(info.utc.hsec, 10);
+  CU_ASSERT_EQUAL(info.sig, NMEALIB_SIG_FIX);
+  CU_ASSERT_EQUAL(info.fix, NMEALIB_FIX_2D);
+  CU_ASSERT_DOUBLE_EQUAL(info.pdop, 2.0, DBL_EPSILON);
+  CU_ASSERT_DOUBLE_EQUAL(info.hdop, 1.5, DBL_EPSILON);
+  CU_ASSERT_DOUBLE_EQUAL(info.vdop, 1.25, DBL_EPSILON);
+  CU_ASSERT_DOUBLE_EQUAL(info.latitude, 5130.0, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(info.longitude, -12015.0, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(info.elevation, 42.5, DBL_EPSILON);
+  CU_ASSERT_DOUBLE_EQUAL(info.speed, 10.25, DBL_EPSILON);
+  CU_ASSERT_DOUBLE_EQUAL(info.track, 359.5, DBL_EPSILON);
+
+  /* metric units, time only */
+
+  memset(&info, 0, sizeof(info));
+  info.metric = true;
+  record.present = NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_HDOP | NMEALIB_PRESENT_LAT;
+  nmeaRecordToInfo(&record, &info);
+  CU_ASSERT_EQUAL(info.present, record.present);
+  CU_ASSERT_EQUAL(info.utc.year, 0);
+  CU_ASSERT_EQUAL(info.utc.hsec, 10);
+  CU_ASSERT_DOUBLE_EQUAL(info.hdop, nmeaMathDopToMeters(1.5), DBL_EPSILON);
+  CU_ASSERT_DOUBLE_EQUAL(info.latitude, 51.5, DBL_EPSILON);
+}
+
+static void test_nmeaRecordInterpolate(void) {
+  NmeaRecord from;
+  NmeaRecord to;
+  NmeaRecord record;
+  bool r;
+
+  memset(&from, 0, sizeof(from));
+  memset(&to, 0, sizeof(to));
+  from.time = 1000;
+  from.present = NMEALIB_RECORD_PRESENT_MASK;
+  from.sig = NMEALIB_SIG_FIX;
+  from.fix = NMEALIB_FIX_2D;
+  from.latitude = 10.0;
+  from.longitude = 179.0;
+  from.elevation = 100.0f;
+  from.speed = 10.0f;
+  from.track = 350.0f;
+  from.hdop = 1.0f;
+  to = from;
+  to.time = 2000;
+  to.present &= ~(uint32_t) NMEALIB_PRESENT_PDOP;
+  to.sig = NMEALIB_SIG_DIFFERENTIAL;
+  to.fix = NMEALIB_FIX_3D;
+  to.latitude = 12.0;
+  to.longitude = -179.0;
+  to.elevation = 200.0f;
+  to.speed = 20.0f;
+  to.track = 20.0f;
+  to.hdop = 3.0f;
+
+  /* invalid inputs */
+
+  r = nmeaRecordInterpolate(NULL, &to, 1500, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaRecordInterpolate(&from, NULL, 1500, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaRecordInterpolate(&from, &to, 1500, NULL);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaRecordInterpolate(&from, &to, 999, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaRecordInterpolate(&from, &to, 2001, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* end points */
+
+  r = nmeaRecordInterpolate(&from, &to, 1000, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(memcmp(&record, &from, sizeof(record)), 0);
+
+  r = nmeaRecordInterpolate(&from, &to, 2000, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(memcmp(&record, &to, sizeof(record)), 0);
+
+  /* nearer to from */
+
+  r = nmeaRecordInterpolate(&from, &to, 1250, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(record.time, 1250);
+  CU_ASSERT_EQUAL(record.present, to.present);
+  CU_ASSERT_EQUAL(record.sig, NMEALIB_SIG_FIX);
+  CU_ASSERT_EQUAL(record.fix, NMEALIB_FIX_2D);
+  CU_ASSERT_DOUBLE_EQUAL(record.latitude, 10.5, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(record.longitude,179.5, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(record.elevation, 125.0, 1E-4);
+  CU_ASSERT_DOUBLE_EQUAL(record.speed, 12.5, 1E-5);
+  CU_ASSERT_DOUBLE_EQUAL(record.track, 357.5, 1E-4);
+  CU_ASSERT_DOUBLE_EQUAL(record.hdop, 1.5, 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(record.pdop, 0.0, FLT_EPSILON);
+
+  /* nearer to to, across the anti-meridian and north */
+
+  r = nmeaRecordInterpolate(&from, &to, 1750, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(record.sig, NMEALIB_SIG_DIFFERENTIAL);
+  CU_ASSERT_EQUAL(record.fix, NMEALIB_FIX_3D);
+  CU_ASSERT_DOUBLE_EQUAL(record.latitude, 11.5, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(record.longitude, -179.5, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(record.track, 12.5, 1E-4);
+}
+
+/*
+ * Setup
+ */
+
+int recordSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("record", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaRecordFromInfo", test_nmeaRecordFromInfo)) //
+      || (!CU_add_test(pSuite, "nmeaRecordToInfo", test_nmeaRecordToInfo)) //
+      || (!CU_add_test(pSuite, "nmeaRecordInterpolate", test_nmeaRecordInterpolate)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
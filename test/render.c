@@ -0,0 +1,265 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/render.h>
+#include <CUnit/Basic.h>
+#include <stdlib.h>
+#include <string.h>
+
+int renderSuiteSetup(void);
+
+/*
+ * Helpers
+ */
+
+static void renderInfo(NmeaInfo *info) {
+  size_t i;
+
+  memset(info, 0, sizeof(*info));
+  info->utc.year = 116;
+  info->utc.mon = 2;
+  info->utc.day = 29;
+  info->utc.hour = 12;
+  info->utc.min = 22;
+  info->utc.sec = 32;
+  info->utc.hsec = 42;
+  info->sig = NMEALIB_SIG_FIX;
+  info->fix = NMEALIB_FIX_3D;
+  info->latitude = 5000.1234;
+  info->longitude = -3600.5678;
+  info->elevation = 10.86;
+  info->speed = 7.704;
+  info->track = 45;
+  info->hdop = 2.3;
+  nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_SIG
+      | NMEALIB_PRESENT_FIX | NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON | NMEALIB_PRESENT_ELV
+      | NMEALIB_PRESENT_SPEED | NMEALIB_PRESENT_TRACK | NMEALIB_PRESENT_HDOP);
+
+  info->satellites.inViewCount = 9;
+  for (i = 0; i < info->satellites.inViewCount; i++) {
+    info->satellites.inView[i].prn = (unsigned int) (i + 1);
+    info->satellites.inView[i].elevation = (int) (i * 10);
+    info->satellites.inView[i].azimuth = (unsigned int) (i * 40);
+    info->satellites.inView[i].snr = 30 + (unsigned int) i;
+  }
+  nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_SATINVIEWCOUNT | NMEALIB_PRESENT_SATINVIEW);
+}
+
+/**
+ * Render and compare against nmeaSentenceFromInfo
+ */
+static void renderCompare(NmeaRender *render, NmeaMallocedBuffer *rendered, NmeaMallocedBuffer *expected,
+    const NmeaInfo *info, NmeaSentence mask) {
+  size_t length = nmeaSentenceFromInfo(expected, info, mask);
+  size_t r = nmeaRenderFromInfo(render, rendered, info, mask);
+
+  CU_ASSERT_EQUAL(r, length);
+  CU_ASSERT_EQUAL(strlen(rendered->buffer), r);
+  CU_ASSERT_STRING_EQUAL(rendered->buffer, expected->buffer);
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaRenderInit(void) {
+  NmeaRender render;
+
+  nmeaRenderInit(NULL);
+
+  memset(&render, 0xaa, sizeof(render));
+  nmeaRenderInit(&render);
+  CU_ASSERT_EQUAL(render.gpggaText.valid, false);
+  CU_ASSERT_EQUAL(render.gpgsvText[0].valid, false);
+  CU_ASSERT_EQUAL(render.sentencesReused, 0);
+  CU_ASSERT_EQUAL(render.sentencesRendered, 0);
+  CU_ASSERT_EQUAL(render.fieldsRendered, 0);
+}
+
+static void test_nmeaRenderFromInfo(void) {
+  NmeaMallocedBuffer rendered;
+  NmeaMallocedBuffer expected;
+  NmeaRender render;
+  NmeaInfo info;
+  size_t r;
+
+  memset(&rendered, 0, sizeof(rendered));
+  memset(&expected, 0, sizeof(expected));
+  renderInfo(&info);
+  nmeaRenderInit(&render);
+
+  /* invalid inputs */
+
+  r = nmeaRenderFromInfo(NULL, &rendered, &info, NMEALIB_SENTENCE_MASK);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaRenderFromInfo(&render, NULL, &info, NMEALIB_SENTENCE_MASK);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaRenderFromInfo(&render, &rendered, NULL, NMEALIB_SENTENCE_MASK);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaRenderFromInfo(&render, &rendered, &info, 0);
+  CU_ASSERT_EQUAL(r, 0);
+  CU_ASSERT_PTR_NULL(rendered.buffer);
+
+  /* first render: everything is rendered */
+
+  renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_MASK);
+  CU_ASSERT_EQUAL(render.sentencesRendered, 7);
+  CU_ASSERT_EQUAL(render.sentencesReused, 0);
+  CU_ASSERT_EQUAL(render.fieldsRendered, NMEALIB_GPGGA_FIELD_COUNT + NMEALIB_GPRMC_FIELD_COUNT);
+
+  /* unchanged: everything is reused */
+
+  renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_MASK);
+  CU_ASSERT_EQUAL(render.sentencesRendered, 7);
+  CU_ASSERT_EQUAL(render.sentencesReused, 7);
+  CU_ASSERT_EQUAL(render.fieldsRendered, NMEALIB_GPGGA_FIELD_COUNT + NMEALIB_GPRMC_FIELD_COUNT);
+
+  /* a new fix: only time and position are rendered, in place */
+
+  render.sentencesRendered = 0;
+  render.sentencesReused = 0;
+  render.fieldsRendered = 0;
+  info.utc.sec = 33;
+  info.latitude = 5000.1300;
+  info.longitude = -3600.5600;
+  renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_MASK);
+  CU_ASSERT_EQUAL(render.sentencesRendered, 2);
+  CU_ASSERT_EQUAL(render.sentencesReused, 5);
+  CU_ASSERT_EQUAL(render.fieldsRendered, 6);
+
+  /* fields that change length */
+
+  info.hdop = 12.3;
+  info.elevation = 1234.5;
+  info.latitude = 12.5;
+  renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_MASK);
+
+  /* fields that change presence */
+
+  nmeaInfoUnsetPresent(&info.present, NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_SPEED);
+  renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_MASK);
+
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_SPEED | NMEALIB_PRESENT_MAGVAR);
+  info.magvar = -2.5;
+  renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_MASK);
+
+  /* the signal changes GPGGA, GPGSA, GPRMC and GPVTG */
+
+  info.sig = NMEALIB_SIG_DIFFERENTIAL;
+  info.fix = NMEALIB_FIX_2D;
+  renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_MASK);
+
+  /* satellites: the number of GPGSV sentences changes */
+
+  info.satellites.inViewCount = 3;
+  renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_MASK);
+
+  info.satellites.inViewCount = 12;
+  info.satellites.inView[11].prn = 32;
+  info.satellites.inView[11].snr = 45;
+  renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_MASK);
+
+  /* subsets */
+
+  renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_GPRMC | NMEALIB_SENTENCE_GPGSV);
+  renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_GPGGA);
+
+  /* sentences and fields that exceed the cache are rendered without it */
+
+  info.elevation = 1E200;
+  renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_MASK);
+  CU_ASSERT_EQUAL(render.gpggaText.valid, false);
+  CU_ASSERT_EQUAL(rendered.buffer[0], '$');
+
+  info.elevation = 1E20;
+  renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_MASK);
+
+  info.elevation = 10.86;
+  renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_MASK);
+  CU_ASSERT_EQUAL(render.gpggaText.valid, true);
+
+  free(rendered.buffer);
+  free(expected.buffer);
+}
+
+static void test_nmeaRenderFromInfoSequence(void) {
+  NmeaMallocedBuffer rendered;
+  NmeaMallocedBuffer expected;
+  NmeaRender render;
+  NmeaInfo info;
+  unsigned int state = 0x12345678u;
+  size_t i;
+
+  memset(&rendered, 0, sizeof(rendered));
+  memset(&expected, 0, sizeof(expected));
+  renderInfo(&info);
+  nmeaRenderInit(&render);
+
+  for (i = 0; i < 2000; i++) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    info.utc.sec = (unsigned int) (i % 60);
+    info.utc.min = (unsigned int) ((i / 60) % 60);
+    info.latitude += (double) (state % 2000) / 10000.0 - 0.1;
+    info.longitude -= (double) ((state >> 11) % 2000) / 10000.0 - 0.1;
+    info.speed = (double) ((state >> 7) % 5000) / 100.0;
+    info.track = (double) ((state >> 3) % 3600) / 10.0;
+
+    if (!(state % 17)) {
+      info.satellites.inViewCount = (state >> 5) % (NMEALIB_MAX_SATELLITES + 1);
+    }
+
+    if (!(state % 23)) {
+      info.present ^= (uint32_t) NMEALIB_PRESENT_ELV;
+    }
+
+    renderCompare(&render, &rendered, &expected, &info, NMEALIB_SENTENCE_MASK);
+  }
+
+  CU_ASSERT_EQUAL(render.sentencesReused > render.sentencesRendered, true);
+
+  free(rendered.buffer);
+  free(expected.buffer);
+}
+
+/*
+ * Setup
+ */
+
+int renderSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("render", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaRenderInit", test_nmeaRenderInit)) //
+      || (!CU_add_test(pSuite, "nmeaRenderFromInfo", test_nmeaRenderFromInfo)) //
+      || (!CU_add_test(pSuite, "nmeaRenderFromInfo (sequence)", test_nmeaRenderFromInfoSequence)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
@@ -0,0 +1,300 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/replay.h>
+#include <CUnit/Basic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+int replaySuiteSetup(void);
+
+/*
+ * Helpers
+ */
+
+/* 4 fixes, 20ms apart, with a sentence without time in every fix */
+static const char *replayLog = //
+    "garbage line\r\n" //
+        "$GPGSA,A,3,,,,,,,,,,,,,,,*6E\r\n" //
+        "$GPGGA,235959.98,,,,,0,00,,,M,0.0,M,,0000*5F\r\n" //
+        "$GPGSA,A,3,,,,,,,,,,,,,,,*6E\r\n" //
+        "$GPRMC,000000.00,V,,,,,,,010207,,,N*40\r\n" //
+        "$GPGSA,A,3,,,,,,,,,,,,,,,*6E\r\n" //
+        "$GPGGA,000000.02,,,,,0,00,,,M,0.0,M,,0000*5F\r\n" //
+        "$GPGSA,A,3,,,,,,,,,,,,,,,*6E\r\n" //
+        "$GPGGA,000000.04,,,,,0,00,,,M,0.0,M,,0000*5F\n" //
+        "$GPGSA,A,3,,,,,,,,,,,,,,,*6E";
+
+typedef struct _ReplayOutput {
+  size_t count;
+  size_t bytes;
+  size_t stopAt;
+} ReplayOutput;
+
+static bool replayOutput(void *userData, const char *s, size_t len) {
+  ReplayOutput *out = userData;
+
+  CU_ASSERT_EQUAL(s[0], '$');
+  out->count++;
+  out->bytes += len;
+
+  return out->count != out->stopAt;
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaReplayInit(void) {
+  NmeaReplay replay;
+  bool r;
+
+  /* invalid inputs */
+
+  r = nmeaReplayInit(NULL, replayLog, strlen(replayLog));
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaReplayInit(&replay, NULL, 1);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaReplayInit(&replay, replayLog, 0);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaReplayInit(&replay, "no sentences\n", 13);
+  CU_ASSERT_EQUAL(r, false);
+  CU_ASSERT_PTR_NULL(replay.log);
+  CU_ASSERT_PTR_NULL(replay.sentences);
+
+  nmeaReplayDestroy(NULL);
+
+  /* index */
+
+  r = nmeaReplayInit(&replay, replayLog, strlen(replayLog));
+  CU_ASSERT_EQUAL_FATAL(r, true);
+  CU_ASSERT_EQUAL_FATAL(replay.count, 9);
+
+  CU_ASSERT_EQUAL(replay.sentences[0].offset, 14);
+  CU_ASSERT_EQUAL(replay.sentences[0].length, 30);
+  CU_ASSERT_EQUAL(replay.sentences[0].time, 0);
+  CU_ASSERT_EQUAL(replay.sentences[1].time, 0);
+  CU_ASSERT_EQUAL(replay.sentences[2].time, 0);
+  CU_ASSERT_EQUAL(replay.sentences[3].time, 20000000); /* wrapped past midnight */
+  CU_ASSERT_EQUAL(replay.sentences[4].time, 20000000);
+  CU_ASSERT_EQUAL(replay.sentences[5].time, 40000000);
+  CU_ASSERT_EQUAL(replay.sentences[6].time, 40000000);
+  CU_ASSERT_EQUAL(replay.sentences[7].time, 60000000);
+  CU_ASSERT_EQUAL(replay.sentences[7].length, 45);
+  CU_ASSERT_EQUAL(replay.sentences[8].time, 60000000);
+  CU_ASSERT_EQUAL(replay.sentences[8].length, 28);
+
+  /* the next loop starts one fix interval after the last fix */
+  CU_ASSERT_EQUAL(replay.period, 80000000);
+
+  nmeaReplayDestroy(&replay);
+  CU_ASSERT_PTR_NULL(replay.log);
+}
+
+static void test_nmeaReplayOpen(void) {
+  char path[] = "/tmp/nmealibReplayXXXXXX";
+  NmeaReplay replay;
+  bool r;
+  int fd;
+
+  r = nmeaReplayOpen(NULL, path);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaReplayOpen(&replay, NULL);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaReplayOpen(&replay, "/nonexistent/log");
+  CU_ASSERT_EQUAL(r, false);
+
+  fd = mkstemp(path);
+  CU_ASSERT_EQUAL_FATAL(fd != -1, true);
+  CU_ASSERT_EQUAL(write(fd, replayLog, strlen(replayLog)), (ssize_t) strlen(replayLog));
+  close(fd);
+
+  r = nmeaReplayOpen(&replay, path);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(replay.count, 9);
+  CU_ASSERT_EQUAL(replay.logSize, strlen(replayLog));
+
+  nmeaReplayDestroy(&replay);
+  unlink(path);
+}
+
+static void test_nmeaReplayNext(void) {
+  NmeaReplayMetrics metrics;
+  NmeaReplay replay;
+  const char *s = NULL;
+  size_t len;
+  size_t i;
+
+  CU_ASSERT_EQUAL(nmeaReplayNext(NULL, &s), 0);
+
+  CU_ASSERT_EQUAL_FATAL(nmeaReplayInit(&replay, replayLog, strlen(replayLog)), true);
+  CU_ASSERT_EQUAL(nmeaReplayNext(&replay, NULL), 0);
+
+  /* as fast as possible */
+
+  nmeaReplayStart(&replay, 0.0, false);
+  for (i = 0; i < 9; i++) {
+    len = nmeaReplayNext(&replay, &s);
+    CU_ASSERT_EQUAL(len, replay.sentences[i].length);
+    CU_ASSERT_PTR_EQUAL(s, &replay.log[replay.sentences[i].offset]);
+  }
+  CU_ASSERT_EQUAL(nmeaReplayNext(&replay, &s), 0);
+
+  nmeaReplayMetrics(&replay, &metrics);
+  CU_ASSERT_EQUAL(metrics.sentences, 9);
+  CU_ASSERT_EQUAL(metrics.bytes, strlen(replayLog) - 14);
+  CU_ASSERT_EQUAL(metrics.loops, 0);
+  CU_ASSERT_EQUAL(metrics.seconds < 0.01, true);
+  CU_ASSERT_DOUBLE_EQUAL(metrics.targetSentencesPerSecond, 0.0, 0.0);
+
+  /* real time: the last fix is due after 60ms */
+
+  nmeaReplayStart(&replay, 1.0, false);
+  for (i = 0; i < 9; i++) {
+    CU_ASSERT_EQUAL(nmeaReplayNext(&replay, &s), replay.sentences[i].length);
+  }
+  CU_ASSERT_EQUAL(nmeaReplayNext(&replay, &s), 0);
+
+  nmeaReplayMetrics(&replay, &metrics);
+  CU_ASSERT_EQUAL(metrics.sentences, 9);
+  CU_ASSERT_EQUAL(metrics.seconds >= 0.06, true);
+  CU_ASSERT_EQUAL(metrics.seconds < 0.5, true);
+  CU_ASSERT_DOUBLE_EQUAL(metrics.targetSentencesPerSecond, 150.0, 0.01);
+  CU_ASSERT_EQUAL(metrics.sentencesPerSecond <= 150.0, true);
+  CU_ASSERT_EQUAL(metrics.maxLateSeconds >= 0.0, true);
+
+  /* time warp */
+
+  nmeaReplayStart(&replay, 10.0, false);
+  for (i = 0; i < 9; i++) {
+    CU_ASSERT_EQUAL(nmeaReplayNext(&replay, &s), replay.sentences[i].length);
+  }
+
+  nmeaReplayMetrics(&replay, &metrics);
+  CU_ASSERT_EQUAL(metrics.seconds >= 0.006, true);
+  CU_ASSERT_EQUAL(metrics.seconds < 0.05, true);
+  CU_ASSERT_DOUBLE_EQUAL(metrics.targetSentencesPerSecond, 1500.0, 0.1);
+
+  nmeaReplayDestroy(&replay);
+}
+
+static void test_nmeaReplayLoop(void) {
+  NmeaReplayMetrics metrics;
+  NmeaReplay replay;
+  const char *s = NULL;
+  size_t i;
+
+  CU_ASSERT_EQUAL_FATAL(nmeaReplayInit(&replay, replayLog, strlen(replayLog)), true);
+
+  /* 2.5 loops at 10x: (2 * 80ms + 40ms) / 10 */
+
+  nmeaReplayStart(&replay, 10.0, true);
+  for (i = 0; i < 24; i++) {
+    CU_ASSERT_EQUAL(nmeaReplayNext(&replay, &s), replay.sentences[i % 9].length);
+    CU_ASSERT_PTR_EQUAL(s, &replay.log[replay.sentences[i % 9].offset]);
+  }
+
+  nmeaReplayMetrics(&replay, &metrics);
+  CU_ASSERT_EQUAL(metrics.sentences, 24);
+  CU_ASSERT_EQUAL(metrics.loops, 2);
+  CU_ASSERT_EQUAL(metrics.seconds >= 0.02, true);
+  CU_ASSERT_DOUBLE_EQUAL(metrics.targetSentencesPerSecond, 24.0 / 0.02, 0.1);
+
+  nmeaReplayDestroy(&replay);
+}
+
+static void test_nmeaReplayRun(void) {
+  NmeaReplayMetrics metrics;
+  ReplayOutput out;
+  NmeaReplay replay;
+  size_t r;
+
+  memset(&out, 0, sizeof(out));
+
+  CU_ASSERT_EQUAL_FATAL(nmeaReplayInit(&replay, replayLog, strlen(replayLog)), true);
+
+  r = nmeaReplayRun(NULL, replayOutput, &out, 0);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaReplayRun(&replay, NULL, &out, 0);
+  CU_ASSERT_EQUAL(r, 0);
+
+  /* to the end */
+
+  nmeaReplayStart(&replay, 0.0, false);
+  r = nmeaReplayRun(&replay, replayOutput, &out, 0);
+  CU_ASSERT_EQUAL(r, 9);
+  CU_ASSERT_EQUAL(out.count, 9);
+  CU_ASSERT_EQUAL(out.bytes, strlen(replayLog) - 14);
+
+  /* a maximum */
+
+  memset(&out, 0, sizeof(out));
+  nmeaReplayStart(&replay, 0.0, true);
+  r = nmeaReplayRun(&replay, replayOutput, &out, 100);
+  CU_ASSERT_EQUAL(r, 100);
+  CU_ASSERT_EQUAL(out.count, 100);
+
+  nmeaReplayMetrics(&replay, &metrics);
+  CU_ASSERT_EQUAL(metrics.loops, 11);
+
+  /* stopped by the output */
+
+  memset(&out, 0, sizeof(out));
+  out.stopAt = 5;
+  nmeaReplayStart(&replay, 0.0, true);
+  r = nmeaReplayRun(&replay, replayOutput, &out, 0);
+  CU_ASSERT_EQUAL(r, 5);
+
+  nmeaReplayMetrics(NULL, &metrics);
+  CU_ASSERT_EQUAL(metrics.sentences, 0);
+  nmeaReplayMetrics(&replay, NULL);
+
+  nmeaReplayDestroy(&replay);
+}
+
+/*
+ * Setup
+ */
+
+int replaySuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("replay", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaReplayInit", test_nmeaReplayInit)) //
+      || (!CU_add_test(pSuite, "nmeaReplayOpen", test_nmeaReplayOpen)) //
+      || (!CU_add_test(pSuite, "nmeaReplayNext", test_nmeaReplayNext)) //
+      || (!CU_add_test(pSuite, "nmeaReplayNext (loop)", test_nmeaReplayLoop)) //
+      || (!CU_add_test(pSuite, "nmeaReplayRun", test_nmeaReplayRun)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
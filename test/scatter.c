@@ -0,0 +1,288 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/scatter.h>
+#include <CUnit/Basic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+int scatterSuiteSetup(void);
+
+/*
+ * Helpers
+ */
+
+static void scatterInfo(NmeaInfo *info) {
+  size_t i;
+
+  memset(info, 0, sizeof(*info));
+  info->utc.year = 116;
+  info->utc.mon = 2;
+  info->utc.day = 29;
+  info->utc.hour = 12;
+  info->utc.min = 22;
+  info->utc.sec = 32;
+  info->utc.hsec = 42;
+  info->sig = NMEALIB_SIG_FIX;
+  info->fix = NMEALIB_FIX_3D;
+  info->latitude = 5000.1234;
+  info->longitude = -3600.5678;
+  info->elevation = 10.86;
+  info->speed = 7.704;
+  info->track = 45;
+  info->hdop = 2.3;
+  nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_SIG
+      | NMEALIB_PRESENT_FIX | NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON | NMEALIB_PRESENT_ELV
+      | NMEALIB_PRESENT_SPEED | NMEALIB_PRESENT_TRACK | NMEALIB_PRESENT_HDOP);
+
+  info->satellites.inViewCount = 9;
+  for (i = 0; i < info->satellites.inViewCount; i++) {
+    info->satellites.inView[i].prn = (unsigned int) (i + 1);
+    info->satellites.inView[i].elevation = (int) (i * 10);
+    info->satellites.inView[i].azimuth = (unsigned int) (i * 40);
+    info->satellites.inView[i].snr = 30 + (unsigned int) i;
+  }
+  nmeaInfoSetPresent(&info->present, NMEALIB_PRESENT_SATINVIEWCOUNT | NMEALIB_PRESENT_SATINVIEW);
+}
+
+static size_t scatterGather(const struct iovec *iov, size_t count, char *s) {
+  size_t length = 0;
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    memcpy(&s[length], iov[i].iov_base, iov[i].iov_len);
+    length += iov[i].iov_len;
+  }
+
+  s[length] = '\0';
+
+  return length;
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaScatterInit(void) {
+  NmeaScatter scatter;
+
+  nmeaScatterInit(NULL);
+  nmeaScatterDestroy(NULL);
+
+  memset(&scatter, 0xaa, sizeof(scatter));
+  nmeaScatterInit(&scatter);
+  CU_ASSERT_PTR_NULL(scatter.arena);
+  CU_ASSERT_PTR_NULL(scatter.iov);
+  CU_ASSERT_EQUAL(scatter.count, 0);
+  CU_ASSERT_EQUAL(scatter.length, 0);
+
+  nmeaScatterDestroy(&scatter);
+}
+
+static void test_nmeaScatterFromInfo(void) {
+  char gathered[4096];
+  NmeaMallocedBuffer buf;
+  NmeaScatter scatter;
+  NmeaInfo info;
+  char *arena;
+  size_t length;
+  size_t r;
+  size_t i;
+
+  memset(&buf, 0, sizeof(buf));
+  scatterInfo(&info);
+  nmeaScatterInit(&scatter);
+
+  /* invalid inputs */
+
+  r = nmeaScatterFromInfo(NULL, &info, NMEALIB_SENTENCE_MASK);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaScatterFromInfo(&scatter, NULL, NMEALIB_SENTENCE_MASK);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaScatterFromInfo(&scatter, &info, 0);
+  CU_ASSERT_EQUAL(r, 0);
+  CU_ASSERT_EQUAL(scatter.count, 0);
+
+  /* all sentences, identical to nmeaSentenceFromInfo */
+
+  length = nmeaSentenceFromInfo(&buf, &info, NMEALIB_SENTENCE_MASK);
+
+  r = nmeaScatterFromInfo(&scatter, &info, NMEALIB_SENTENCE_MASK);
+  CU_ASSERT_EQUAL(r, 7);
+  CU_ASSERT_EQUAL(scatter.count, 7);
+  CU_ASSERT_EQUAL(scatter.length, length);
+  CU_ASSERT_EQUAL(scatterGather(scatter.iov, scatter.count, gathered), length);
+  CU_ASSERT_STRING_EQUAL(gathered, buf.buffer);
+
+  CU_ASSERT_EQUAL(scatter.sentences[0], NMEALIB_SENTENCE_GPGGA);
+  CU_ASSERT_EQUAL(scatter.sentences[1], NMEALIB_SENTENCE_GPGSA);
+  CU_ASSERT_EQUAL(scatter.sentences[2], NMEALIB_SENTENCE_GPGSV);
+  CU_ASSERT_EQUAL(scatter.sentences[3], NMEALIB_SENTENCE_GPGSV);
+  CU_ASSERT_EQUAL(scatter.sentences[4], NMEALIB_SENTENCE_GPGSV);
+  CU_ASSERT_EQUAL(scatter.sentences[5], NMEALIB_SENTENCE_GPRMC);
+  CU_ASSERT_EQUAL(scatter.sentences[6], NMEALIB_SENTENCE_GPVTG);
+
+  /* every iovec is exactly one sentence */
+
+  for (i = 0; i < scatter.count; i++) {
+    const char *sentence = scatter.iov[i].iov_base;
+    size_t len = scatter.iov[i].iov_len;
+
+    CU_ASSERT_EQUAL(sentence[0], '$');
+    CU_ASSERT_EQUAL(sentence[len - 2], '\r');
+    CU_ASSERT_EQUAL(sentence[len - 1], '\n');
+    CU_ASSERT_EQUAL(nmeaSentenceFromPrefix(sentence, len), scatter.sentences[i]);
+  }
+
+  /* reuse: no reallocation */
+
+  arena = scatter.arena;
+  r = nmeaScatterFromInfo(&scatter, &info, NMEALIB_SENTENCE_GPRMC | NMEALIB_SENTENCE_GPGGA);
+  CU_ASSERT_EQUAL(r, 2);
+  CU_ASSERT_PTR_EQUAL(scatter.arena, arena);
+  CU_ASSERT_EQUAL(scatter.sentences[0], NMEALIB_SENTENCE_GPGGA);
+  CU_ASSERT_EQUAL(scatter.sentences[1], NMEALIB_SENTENCE_GPRMC);
+
+  length = nmeaSentenceFromInfo(&buf, &info, NMEALIB_SENTENCE_GPRMC | NMEALIB_SENTENCE_GPGGA);
+  CU_ASSERT_EQUAL(scatterGather(scatter.iov, scatter.count, gathered), length);
+  CU_ASSERT_STRING_EQUAL(gathered, buf.buffer);
+
+  /* sentences that exceed the maximum length */
+
+  info.elevation = 1E200;
+  length = nmeaSentenceFromInfo(&buf, &info, NMEALIB_SENTENCE_MASK);
+  r = nmeaScatterFromInfo(&scatter, &info, NMEALIB_SENTENCE_MASK);
+  CU_ASSERT_EQUAL(r, 7);
+  CU_ASSERT_EQUAL(scatter.length, length);
+  CU_ASSERT_EQUAL(scatter.iov[0].iov_len > NMEALIB_SENTENCE_MAX_LENGTH, true);
+  CU_ASSERT_EQUAL(scatterGather(scatter.iov, scatter.count, gathered), length);
+  CU_ASSERT_STRING_EQUAL(gathered, buf.buffer);
+
+  nmeaScatterDestroy(&scatter);
+  free(buf.buffer);
+}
+
+static void test_nmeaScatterSelect(void) {
+  struct iovec iov[NMEALIB_SCATTER_MAX_SENTENCES];
+  char gathered[4096];
+  NmeaMallocedBuffer buf;
+  NmeaScatter scatter;
+  NmeaInfo info;
+  size_t length;
+  size_t r;
+
+  memset(&buf, 0, sizeof(buf));
+  scatterInfo(&info);
+  nmeaScatterInit(&scatter);
+
+  r = nmeaScatterSelect(&scatter, NMEALIB_SENTENCE_MASK, iov, NMEALIB_SCATTER_MAX_SENTENCES);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaScatterFromInfo(&scatter, &info, NMEALIB_SENTENCE_MASK);
+  CU_ASSERT_EQUAL(r, 7);
+
+  /* invalid inputs */
+
+  r = nmeaScatterSelect(NULL, NMEALIB_SENTENCE_MASK, iov, NMEALIB_SCATTER_MAX_SENTENCES);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaScatterSelect(&scatter, NMEALIB_SENTENCE_MASK, NULL, NMEALIB_SCATTER_MAX_SENTENCES);
+  CU_ASSERT_EQUAL(r, 0);
+
+  /* subsets, without copies */
+
+  r = nmeaScatterSelect(&scatter, 0, iov, NMEALIB_SCATTER_MAX_SENTENCES);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaScatterSelect(&scatter, NMEALIB_SENTENCE_GPGSV | NMEALIB_SENTENCE_GPVTG, iov,
+      NMEALIB_SCATTER_MAX_SENTENCES);
+  CU_ASSERT_EQUAL(r, 4);
+  CU_ASSERT_PTR_EQUAL(iov[0].iov_base, scatter.iov[2].iov_base);
+  CU_ASSERT_PTR_EQUAL(iov[3].iov_base, scatter.iov[6].iov_base);
+
+  length = nmeaSentenceFromInfo(&buf, &info, NMEALIB_SENTENCE_GPGSV | NMEALIB_SENTENCE_GPVTG);
+  CU_ASSERT_EQUAL(scatterGather(iov, r, gathered), length);
+  CU_ASSERT_STRING_EQUAL(gathered, buf.buffer);
+
+  /* limited by the array */
+
+  r = nmeaScatterSelect(&scatter, NMEALIB_SENTENCE_MASK, iov, 3);
+  CU_ASSERT_EQUAL(r, 3);
+  CU_ASSERT_PTR_EQUAL(iov[2].iov_base, scatter.iov[2].iov_base);
+
+  nmeaScatterDestroy(&scatter);
+  free(buf.buffer);
+}
+
+static void test_nmeaScatterWritev(void) {
+  char gathered[4096];
+  NmeaMallocedBuffer buf;
+  NmeaScatter scatter;
+  NmeaInfo info;
+  size_t length;
+  ssize_t r;
+  int fds[2];
+
+  memset(&buf, 0, sizeof(buf));
+  scatterInfo(&info);
+  nmeaScatterInit(&scatter);
+
+  CU_ASSERT_EQUAL_FATAL(pipe(fds), 0);
+
+  length = nmeaSentenceFromInfo(&buf, &info, NMEALIB_SENTENCE_MASK);
+  nmeaScatterFromInfo(&scatter, &info, NMEALIB_SENTENCE_MASK);
+
+  r = writev(fds[1], scatter.iov, (int) scatter.count);
+  CU_ASSERT_EQUAL(r, (ssize_t) length);
+
+  r = read(fds[0], gathered, sizeof(gathered) - 1);
+  CU_ASSERT_EQUAL(r, (ssize_t) length);
+  gathered[length] = '\0';
+  CU_ASSERT_STRING_EQUAL(gathered, buf.buffer);
+
+  close(fds[0]);
+  close(fds[1]);
+  nmeaScatterDestroy(&scatter);
+  free(buf.buffer);
+}
+
+/*
+ * Setup
+ */
+
+int scatterSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("scatter", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaScatterInit", test_nmeaScatterInit)) //
+      || (!CU_add_test(pSuite, "nmeaScatterFromInfo", test_nmeaScatterFromInfo)) //
+      || (!CU_add_test(pSuite, "nmeaScatterSelect", test_nmeaScatterSelect)) //
+      || (!CU_add_test(pSuite, "nmeaScatterWritev", test_nmeaScatterWritev)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
@@ -248,6 +248,34 @@ static void test_nmeaSentenceToInfo(void) {
   memset(&info, 0, sizeof(info));
 }
 
+static void test_nmeaSentenceToInfoPolicy(void) {
+  NmeaInfo infoEmpty;
+  NmeaInfo info;
+  const char *s = "$GPGGA,250000.00,,,,,,,,,,,,,";
+  bool r;
+
+  memset(&infoEmpty, 0, sizeof(infoEmpty));
+  memset(&info, 0, sizeof(info));
+
+  r = nmeaSentenceToInfoPolicy(s, strlen(s), &info, NMEALIB_VALIDATION_STRICT);
+  CU_ASSERT_EQUAL(r, false);
+  validatePackToInfo(&info, 1, 1, true);
+  memset(&info, 0, sizeof(info));
+
+  r = nmeaSentenceToInfoPolicy(s, strlen(s), &info, NMEALIB_VALIDATION_STRUCTURAL);
+  CU_ASSERT_EQUAL(r, true);
+  validatePackToInfo(&info, 1, 0, false);
+  CU_ASSERT_EQUAL(info.present, NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_SMASK);
+  CU_ASSERT_EQUAL(info.utc.hour, 25);
+  memset(&info, 0, sizeof(info));
+
+  r = nmeaSentenceToInfoPolicy(s, strlen(s), &info, NMEALIB_VALIDATION_TRUSTED);
+  CU_ASSERT_EQUAL(r, true);
+  validatePackToInfo(&info, 1, 0, false);
+  CU_ASSERT_EQUAL(info.utc.hour, 25);
+  memset(&info, 0, sizeof(info));
+}
+
 static void test_nmeaSentenceFromInfo(void) {
   size_t r;
   NmeaInfo infoEmpty;
@@ -401,6 +429,127 @@ static void test_nmeaSentenceFromInfo(void) {
   buf.bufferSize = 0;
 }
 
+static void test_nmeaSentenceFromInfoSize(void) {
+  NmeaInfo info;
+  size_t r;
+
+  memset(&info, 0, sizeof(info));
+
+  r = nmeaSentenceFromInfoSize(NULL, NMEALIB_SENTENCE_GPGGA);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaSentenceFromInfoSize(&info, 0);
+  CU_ASSERT_EQUAL(r, 1);
+
+  r = nmeaSentenceFromInfoSize(&info, NMEALIB_SENTENCE_GPGGA | NMEALIB_SENTENCE_GPVTG);
+  CU_ASSERT_EQUAL(r, (2 * NMEALIB_SENTENCE_MAX_LENGTH) + 1);
+
+  /* GPGSV without satellites is still generated once */
+  r = nmeaSentenceFromInfoSize(&info, NMEALIB_SENTENCE_GPGSV);
+  CU_ASSERT_EQUAL(r, (1 * NMEALIB_SENTENCE_MAX_LENGTH) + 1);
+
+  info.satellites.inViewCount = 9;
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_SATINVIEWCOUNT);
+  r = nmeaSentenceFromInfoSize(&info, NMEALIB_SENTENCE_MASK);
+  CU_ASSERT_EQUAL(r, (7 * NMEALIB_SENTENCE_MAX_LENGTH) + 1);
+}
+
+static void test_nmeaSentenceFromInfoFixed(void) {
+  const char *expected = "$GPGGA,122232.42,,,,,,,,,,,,,*7C\r\n$GPRMC,122232.42,,,,,,,,,,,*61\r\n";
+  char buf[128];
+  NmeaInfo info;
+  size_t r;
+
+  memset(&info, 0, sizeof(info));
+  info.utc.hour = 12;
+  info.utc.min = 22;
+  info.utc.sec = 32;
+  info.utc.hsec = 42;
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_UTCTIME);
+
+  /* invalid inputs */
+
+  r = nmeaSentenceFromInfoFixed(NULL, sizeof(buf), &info, NMEALIB_SENTENCE_GPGGA);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaSentenceFromInfoFixed(buf, sizeof(buf), NULL, NMEALIB_SENTENCE_GPGGA);
+  CU_ASSERT_EQUAL(r, 0);
+
+  /* nothing to generate */
+
+  memset(buf, 'x', sizeof(buf));
+  r = nmeaSentenceFromInfoFixed(buf, sizeof(buf), &info, 0);
+  CU_ASSERT_EQUAL(r, 0);
+  CU_ASSERT_STRING_EQUAL(buf, "");
+
+  /* length only */
+
+  r = nmeaSentenceFromInfoFixed(NULL, 0, &info, NMEALIB_SENTENCE_GPGGA | NMEALIB_SENTENCE_GPRMC);
+  CU_ASSERT_EQUAL(r, 66);
+
+  memset(buf, 'x', sizeof(buf));
+  r = nmeaSentenceFromInfoFixed(buf, 0, &info, NMEALIB_SENTENCE_GPGGA | NMEALIB_SENTENCE_GPRMC);
+  CU_ASSERT_EQUAL(r, 66);
+  CU_ASSERT_EQUAL(buf[0], 'x');
+
+  /* fits */
+
+  r = nmeaSentenceFromInfoFixed(buf, sizeof(buf), &info, NMEALIB_SENTENCE_GPGGA | NMEALIB_SENTENCE_GPRMC);
+  CU_ASSERT_EQUAL(r, 66);
+  CU_ASSERT_STRING_EQUAL(buf, expected);
+
+  r = nmeaSentenceFromInfoFixed(buf, 67, &info, NMEALIB_SENTENCE_GPGGA | NMEALIB_SENTENCE_GPRMC);
+  CU_ASSERT_EQUAL(r, 66);
+  CU_ASSERT_STRING_EQUAL(buf, expected);
+
+  /* truncated: only complete sentences */
+
+  memset(buf, 'x', sizeof(buf));
+  r = nmeaSentenceFromInfoFixed(buf, 66, &info, NMEALIB_SENTENCE_GPGGA | NMEALIB_SENTENCE_GPRMC);
+  CU_ASSERT_EQUAL(r, 66);
+  CU_ASSERT_STRING_EQUAL(buf, "$GPGGA,122232.42,,,,,,,,,,,,,*7C\r\n");
+
+  memset(buf, 'x', sizeof(buf));
+  r = nmeaSentenceFromInfoFixed(buf, 35, &info, NMEALIB_SENTENCE_GPGGA | NMEALIB_SENTENCE_GPRMC);
+  CU_ASSERT_EQUAL(r, 66);
+  CU_ASSERT_STRING_EQUAL(buf, "$GPGGA,122232.42,,,,,,,,,,,,,*7C\r\n");
+
+  memset(buf, 'x', sizeof(buf));
+  r = nmeaSentenceFromInfoFixed(buf, 34, &info, NMEALIB_SENTENCE_GPGGA | NMEALIB_SENTENCE_GPRMC);
+  CU_ASSERT_EQUAL(r, 66);
+  CU_ASSERT_STRING_EQUAL(buf, "");
+
+  memset(buf, 'x', sizeof(buf));
+  r = nmeaSentenceFromInfoFixed(buf, 1, &info, NMEALIB_SENTENCE_GPGGA | NMEALIB_SENTENCE_GPRMC);
+  CU_ASSERT_EQUAL(r, 66);
+  CU_ASSERT_STRING_EQUAL(buf, "");
+}
+
+static void test_nmeaSentenceFromInfo_overlong(void) {
+  NmeaMallocedBuffer buf;
+  NmeaInfo info;
+  size_t r;
+
+  memset(&buf, 0, sizeof(buf));
+  memset(&info, 0, sizeof(info));
+
+  /* sentences that exceed the maximum length of the standard */
+
+  info.elevation = 1E200;
+  info.height = 1E200;
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_ELV | NMEALIB_PRESENT_HEIGHT);
+  r = nmeaSentenceFromInfo(&buf, &info, NMEALIB_SENTENCE_GPGGA);
+  CU_ASSERT_EQUAL(r, nmeaSentenceFromInfoFixed(NULL, 0, &info, NMEALIB_SENTENCE_GPGGA));
+  CU_ASSERT_EQUAL(r > NMEALIB_SENTENCE_MAX_LENGTH, true);
+  CU_ASSERT_EQUAL(strlen(buf.buffer), r);
+  CU_ASSERT_EQUAL(buf.bufferSize, NMEALIB_BUFFER_CHUNK_SIZE);
+  CU_ASSERT_EQUAL(strncmp(buf.buffer, "$GPGGA,,,,,,,,,9999", 19), 0);
+  CU_ASSERT_EQUAL(strcmp(&buf.buffer[r - 2], "\r\n"), 0);
+  validateContext(0, 0);
+
+  free(buf.buffer);
+}
+
 /*
  * Setup
  */
@@ -415,7 +564,11 @@ int sentenceSuiteSetup(void) {
       (!CU_add_test(pSuite, "nmeaSentenceToPrefix", test_nmeaSentenceToPrefix)) //
       || (!CU_add_test(pSuite, "nmeaSentenceFromPrefix", test_nmeaSentenceFromPrefix)) //
       || (!CU_add_test(pSuite, "nmeaSentenceToInfo", test_nmeaSentenceToInfo)) //
+      || (!CU_add_test(pSuite, "nmeaSentenceToInfoPolicy", test_nmeaSentenceToInfoPolicy)) //
       || (!CU_add_test(pSuite, "nmeaSentenceFromInfo", test_nmeaSentenceFromInfo)) //
+      || (!CU_add_test(pSuite, "nmeaSentenceFromInfoSize", test_nmeaSentenceFromInfoSize)) //
+      || (!CU_add_test(pSuite, "nmeaSentenceFromInfoFixed", test_nmeaSentenceFromInfoFixed)) //
+      || (!CU_add_test(pSuite, "nmeaSentenceFromInfo (overlong)", test_nmeaSentenceFromInfo_overlong)) //
       ) {
     return CU_get_error();
   }
@@ -0,0 +1,367 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/sentence.h>
+#include <nmealib/serialize.h>
+#include <CUnit/Basic.h>
+#include <float.h>
+#include <limits.h>
+#include <string.h>
+
+int serializeSuiteSetup(void);
+
+/*
+ * Helpers
+ */
+
+static void serializeInfoFull(NmeaInfo *info) {
+  size_t i;
+
+  memset(info, 0, sizeof(*info));
+  info->present = NMEALIB_INFO_PRESENT_MASK;
+  info->smask = NMEALIB_SENTENCE_GPGGA | NMEALIB_SENTENCE_GPRMC;
+  info->utc.year = 2016;
+  info->utc.mon = 2;
+  info->utc.day = 29;
+  info->utc.hour = 23;
+  info->utc.min = 59;
+  info->utc.sec = 60;
+  info->utc.hsec = 99;
+  info->sig = NMEALIB_SIG_RTKIN;
+  info->fix = NMEALIB_FIX_3D;
+  info->pdop = 2.594224354;
+  info->hdop = 2.3;
+  info->vdop = 1.2;
+  info->latitude = -5130.123456789;
+  info->longitude = 12015.987654321;
+  info->elevation = -10.86;
+  info->height = 47.1;
+  info->speed = 7.704;
+  info->track = 359.99;
+  info->mtrack = 1.0 / 3.0;
+  info->magvar = -2.5;
+  info->dgpsAge = 1.75;
+  info->dgpsSid = 1023;
+  info->satellites.inUseCount = 3;
+  info->satellites.inUse[0] = 1;
+  info->satellites.inUse[5] = 200;
+  info->satellites.inUse[NMEALIB_MAX_SATELLITES - 1] = 3;
+  info->satellites.inViewCount = NMEALIB_MAX_SATELLITES;
+  for (i = 0; i < NMEALIB_MAX_SATELLITES; i += 2) {
+    info->satellites.inView[i].prn = (unsigned int) i + 1;
+    info->satellites.inView[i].elevation = (int) i - 10;
+    info->satellites.inView[i].azimuth = (unsigned int) (i * 5);
+    info->satellites.inView[i].snr = 99 - (unsigned int) i;
+  }
+  info->metric = true;
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaSerializeInfo(void) {
+  uint8_t buffer[NMEALIB_SERIALIZE_MAX_SIZE];
+  NmeaInfo info;
+  size_t r;
+  size_t length;
+  size_t i;
+
+  serializeInfoFull(&info);
+
+  /* invalid inputs */
+
+  r = nmeaSerializeInfo(NULL, buffer, sizeof(buffer));
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaSerializeInfo(&info, NULL, sizeof(buffer));
+  CU_ASSERT_EQUAL(r, 0);
+
+  /* size query */
+
+  length = nmeaSerializeInfo(&info, NULL, 0);
+  CU_ASSERT(length > NMEALIB_SERIALIZE_HEADER_SIZE);
+  CU_ASSERT(length <= NMEALIB_SERIALIZE_MAX_SIZE);
+
+  /* too small */
+
+  memset(buffer, 0, sizeof(buffer));
+  r = nmeaSerializeInfo(&info, buffer, length - 1);
+  CU_ASSERT_EQUAL(r, length);
+  CU_ASSERT_EQUAL(buffer[length - 1], 0);
+
+  /* normal */
+
+  r = nmeaSerializeInfo(&info, buffer, sizeof(buffer));
+  CU_ASSERT_EQUAL(r, length);
+  CU_ASSERT_EQUAL(buffer[0], NMEALIB_SERIALIZE_MAGIC);
+  CU_ASSERT_EQUAL(buffer[1], NMEALIB_SERIALIZE_VERSION);
+  CU_ASSERT_EQUAL(buffer[2], 1);
+  CU_ASSERT_EQUAL(buffer[3] | (buffer[4] << 8), length);
+
+  /* empty */
+
+  memset(&info, 0, sizeof(info));
+  r = nmeaSerializeInfo(&info, buffer, sizeof(buffer));
+  CU_ASSERT_EQUAL(r, NMEALIB_SERIALIZE_HEADER_SIZE + 1);
+  CU_ASSERT_EQUAL(buffer[2], 0);
+  CU_ASSERT_EQUAL(buffer[5], 0);
+
+  /* fields that are not present are not encoded */
+
+  info.latitude = 5000.0;
+  info.present = NMEALIB_PRESENT_LON;
+  info.longitude = 400.0;
+  r = nmeaSerializeInfo(&info, buffer, sizeof(buffer));
+  CU_ASSERT_EQUAL(r, NMEALIB_SERIALIZE_HEADER_SIZE + 2 + 8);
+
+  /* the maximum size is not exceeded */
+
+  serializeInfoFull(&info);
+  info.smask = UINT32_MAX;
+  info.dgpsSid = UINT32_MAX;
+  info.satellites.inUseCount = UINT32_MAX;
+  info.satellites.inViewCount = UINT32_MAX;
+  memset(info.satellites.inUse, 0xff, sizeof(info.satellites.inUse));
+  memset(info.satellites.inView, 0xff, sizeof(info.satellites.inView));
+  for (i = 0; i < NMEALIB_MAX_SATELLITES; i++) {
+    info.satellites.inView[i].elevation = INT_MIN;
+  }
+  r = nmeaSerializeInfo(&info, NULL, 0);
+  CU_ASSERT_EQUAL(r, NMEALIB_SERIALIZE_MAX_SIZE);
+}
+
+static void test_nmeaDeserializeInfo(void) {
+  uint8_t buffer[NMEALIB_SERIALIZE_MAX_SIZE + 16];
+  NmeaInfo info;
+  NmeaInfo infoOut;
+  size_t length;
+  size_t r;
+  size_t i;
+
+  serializeInfoFull(&info);
+  length = nmeaSerializeInfo(&info, buffer, sizeof(buffer));
+
+  /* invalid inputs */
+
+  r = nmeaDeserializeInfo(NULL, length, &infoOut);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaDeserializeInfo(buffer, length, NULL);
+  CU_ASSERT_EQUAL(r, 0);
+
+  /* round trip */
+
+  memset(&infoOut, 0xaa, sizeof(infoOut));
+  r = nmeaDeserializeInfo(buffer, sizeof(buffer), &infoOut);
+  CU_ASSERT_EQUAL(r, length);
+  CU_ASSERT_EQUAL(memcmp(&infoOut, &info, sizeof(info)), 0);
+
+  /* round trip, partial */
+
+  memset(&info, 0, sizeof(info));
+  info.present = NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_SATINVIEW;
+  info.utc.hour = 12;
+  info.utc.min = 34;
+  info.latitude = 1234.5678;
+  info.satellites.inView[3].elevation = -5;
+  length = nmeaSerializeInfo(&info, buffer, sizeof(buffer));
+
+  memset(&infoOut, 0xaa, sizeof(infoOut));
+  r = nmeaDeserializeInfo(buffer, length, &infoOut);
+  CU_ASSERT_EQUAL(r, length);
+  CU_ASSERT_EQUAL(memcmp(&infoOut, &info, sizeof(info)), 0);
+
+  /* incomplete frames */
+
+  for (i = 0; i < length; i++) {
+    r = nmeaDeserializeInfo(buffer, i, &infoOut);
+    CU_ASSERT_EQUAL(r, 0);
+  }
+
+  /* corrupt frames */
+
+  buffer[0] = 0;
+  r = nmeaDeserializeInfo(buffer, length, &infoOut);
+  CU_ASSERT_EQUAL(r, 0);
+  buffer[0] = NMEALIB_SERIALIZE_MAGIC;
+
+  buffer[1] = NMEALIB_SERIALIZE_VERSION + 1;
+  r = nmeaDeserializeInfo(buffer, length, &infoOut);
+  CU_ASSERT_EQUAL(r, 0);
+  buffer[1] = NMEALIB_SERIALIZE_VERSION;
+
+  buffer[2] = 2;
+  r = nmeaDeserializeInfo(buffer, length, &infoOut);
+  CU_ASSERT_EQUAL(r, 0);
+  buffer[2] = 0;
+
+  buffer[3]--;
+  r = nmeaDeserializeInfo(buffer, length, &infoOut);
+  CU_ASSERT_EQUAL(r, 0);
+  buffer[3]++;
+
+  r = nmeaDeserializeInfo(buffer, length, &infoOut);
+  CU_ASSERT_EQUAL(r, length);
+}
+
+static void test_nmeaSerializeView(void) {
+  uint8_t buffer[NMEALIB_SERIALIZE_MAX_SIZE];
+  NmeaSerializeView view;
+  NmeaInfo info;
+  NmeaTime utc;
+  NmeaSatellites satellites;
+  size_t length;
+  size_t r;
+  uint32_t u;
+  double d;
+  bool b;
+
+  serializeInfoFull(&info);
+  length = nmeaSerializeInfo(&info, buffer, sizeof(buffer));
+
+  /* invalid inputs */
+
+  r = nmeaSerializeViewInit(NULL, buffer, length);
+  CU_ASSERT_EQUAL(r, 0);
+
+  r = nmeaSerializeViewInit(&view, NULL, length);
+  CU_ASSERT_EQUAL(r, 0);
+
+  /* normal */
+
+  r = nmeaSerializeViewInit(&view, buffer, length);
+  CU_ASSERT_EQUAL(r, length);
+  CU_ASSERT_PTR_EQUAL(view.buffer, buffer);
+  CU_ASSERT_EQUAL(view.length, length);
+  CU_ASSERT_EQUAL(view.metric, true);
+  CU_ASSERT_EQUAL(view.present, NMEALIB_INFO_PRESENT_MASK);
+
+  /* unsigned */
+
+  b = nmeaSerializeViewGetUnsigned(NULL, NMEALIB_PRESENT_SIG, &u);
+  CU_ASSERT_EQUAL(b, false);
+
+  b = nmeaSerializeViewGetUnsigned(&view, NMEALIB_PRESENT_SIG, NULL);
+  CU_ASSERT_EQUAL(b, false);
+
+  b = nmeaSerializeViewGetUnsigned(&view, NMEALIB_PRESENT_LAT, &u);
+  CU_ASSERT_EQUAL(b, false);
+
+  b = nmeaSerializeViewGetUnsigned(&view, (NmeaPresence) 0, &u);
+  CU_ASSERT_EQUAL(b, false);
+
+  b = nmeaSerializeViewGetUnsigned(&view, NMEALIB_PRESENT_SIG | NMEALIB_PRESENT_FIX, &u);
+  CU_ASSERT_EQUAL(b, false);
+
+  b = nmeaSerializeViewGetUnsigned(&view, NMEALIB_PRESENT_SIG, &u);
+  CU_ASSERT_EQUAL(b, true);
+  CU_ASSERT_EQUAL(u, NMEALIB_SIG_RTKIN);
+
+  b = nmeaSerializeViewGetUnsigned(&view, NMEALIB_PRESENT_DGPSSID, &u);
+  CU_ASSERT_EQUAL(b, true);
+  CU_ASSERT_EQUAL(u, 1023);
+
+  /* double */
+
+  b = nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_LAT, NULL);
+  CU_ASSERT_EQUAL(b, false);
+
+  b = nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_SIG, &d);
+  CU_ASSERT_EQUAL(b, false);
+
+  b = nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_LAT, &d);
+  CU_ASSERT_EQUAL(b, true);
+  CU_ASSERT_DOUBLE_EQUAL(d, -5130.123456789, 0.0);
+
+  b = nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_DGPSAGE, &d);
+  CU_ASSERT_EQUAL(b, true);
+  CU_ASSERT_DOUBLE_EQUAL(d, 1.75, 0.0);
+
+  /* time */
+
+  b = nmeaSerializeViewGetTime(&view, NULL);
+  CU_ASSERT_EQUAL(b, false);
+
+  memset(&utc, 0, sizeof(utc));
+  b = nmeaSerializeViewGetTime(&view, &utc);
+  CU_ASSERT_EQUAL(b, true);
+  CU_ASSERT_EQUAL(memcmp(&utc, &info.utc, sizeof(utc)), 0);
+
+  /* satellites */
+
+  b = nmeaSerializeViewGetSatellites(&view, NULL);
+  CU_ASSERT_EQUAL(b, false);
+
+  memset(&satellites, 0xaa, sizeof(satellites));
+  b = nmeaSerializeViewGetSatellites(&view, &satellites);
+  CU_ASSERT_EQUAL(b, true);
+  CU_ASSERT_EQUAL(memcmp(&satellites, &info.satellites, sizeof(satellites)), 0);
+
+  /* not present */
+
+  info.present = NMEALIB_PRESENT_LAT;
+  length = nmeaSerializeInfo(&info, buffer, sizeof(buffer));
+  r = nmeaSerializeViewInit(&view, buffer, length);
+  CU_ASSERT_EQUAL(r, length);
+
+  b = nmeaSerializeViewGetUnsigned(&view, NMEALIB_PRESENT_SIG, &u);
+  CU_ASSERT_EQUAL(b, false);
+
+  b = nmeaSerializeViewGetDouble(&view, NMEALIB_PRESENT_LON, &d);
+  CU_ASSERT_EQUAL(b, false);
+
+  b = nmeaSerializeViewGetTime(&view, &utc);
+  CU_ASSERT_EQUAL(b, false);
+
+  b = nmeaSerializeViewGetSatellites(&view, &satellites);
+  CU_ASSERT_EQUAL(b, false);
+
+  /* invalid satellite slot */
+
+  memset(&info, 0, sizeof(info));
+  info.present = NMEALIB_PRESENT_SATINUSE;
+  info.satellites.inUse[0] = 1;
+  length = nmeaSerializeInfo(&info, buffer, sizeof(buffer));
+  CU_ASSERT_EQUAL(length, NMEALIB_SERIALIZE_HEADER_SIZE + 3 + 1 + 1 + 1);
+  buffer[length - 2] = NMEALIB_MAX_SATELLITES;
+  r = nmeaSerializeViewInit(&view, buffer, length);
+  CU_ASSERT_EQUAL(r, 0);
+}
+
+/*
+ * Setup
+ */
+
+int serializeSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("serialize", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaSerializeInfo", test_nmeaSerializeInfo)) //
+      || (!CU_add_test(pSuite, "nmeaDeserializeInfo", test_nmeaDeserializeInfo)) //
+      || (!CU_add_test(pSuite, "nmeaSerializeView", test_nmeaSerializeView)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
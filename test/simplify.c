@@ -0,0 +1,348 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/simplify.h>
+#include <nmealib/geodesic.h>
+#include <nmealib/nmath.h>
+#include <nmealib/random.h>
+#include <nmealib/util.h>
+#include <CUnit/Basic.h>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+int simplifySuiteSetup(void);
+
+#define SIMPLIFY_POINTS (3000u)
+
+static NmeaRecord simplifyTrack[SIMPLIFY_POINTS];
+static size_t simplifyKept[SIMPLIFY_POINTS + 1];
+
+/*
+ * Helpers
+ */
+
+static void simplifyRecord(NmeaRecord *record, int64_t time, const NmeaPosition *position) {
+  memset(record, 0, sizeof(*record));
+  record->time = time;
+  record->present = NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON;
+  record->latitude = nmeaMathRadianToDegree(position->lat);
+  record->longitude = nmeaMathRadianToDegree(position->lon);
+}
+
+static void simplifyPosition(const NmeaRecord *record, NmeaPosition *position) {
+  position->lat = nmeaMathDegreeToRadian(record->latitude);
+  position->lon = nmeaMathDegreeToRadian(record->longitude);
+}
+
+/**
+ * Generate a track with time = index: straight stretches, turns and a
+ * jitter, starting at a position and heading
+ */
+static void simplifyGenerate(NmeaRandom *random, double lat, double lon, double heading, double jitter) {
+  NmeaGeodesicOrigin origin;
+  NmeaPosition position;
+  NmeaPosition noisy;
+  size_t i;
+
+  position.lat = nmeaMathDegreeToRadian(lat);
+  position.lon = nmeaMathDegreeToRadian(lon);
+  heading = nmeaMathDegreeToRadian(heading);
+
+  for (i = 0; i < SIMPLIFY_POINTS; i++) {
+    CU_ASSERT_EQUAL(nmeaGeodesicOriginInit(&origin, &position), true);
+    nmeaGeodesicDirect(&origin, nmeaRandomDouble(random, -NMEALIB_PI, NMEALIB_PI),
+        nmeaRandomDouble(random, 0.0, jitter), &noisy, NULL);
+    simplifyRecord(&simplifyTrack[i], (int64_t) i, &noisy);
+
+    if ((i % 200) == 199) {
+      /* a turn */
+      heading += nmeaRandomDouble(random, -2.0, 2.0);
+    } else if ((i % 1000) >= 500) {
+      /* a curve */
+      heading += 0.01;
+    }
+    nmeaGeodesicDirect(&origin, heading, nmeaRandomDouble(random, 5.0, 15.0), &position, NULL);
+  }
+}
+
+/**
+ * Simplify the track
+ *
+ * @return The number of kept records, their indices are in simplifyKept
+ */
+static size_t simplifyRun(NmeaSimplifier *simplifier) {
+  NmeaRecord kept;
+  size_t count = 0;
+  size_t i;
+
+  for (i = 0; i < SIMPLIFY_POINTS; i++) {
+    if (nmeaSimplifierAdd(simplifier, &simplifyTrack[i], &kept)) {
+      simplifyKept[count++] = (size_t) kept.time;
+      CU_ASSERT_EQUAL(memcmp(&kept, &simplifyTrack[kept.time], sizeof(kept)), 0);
+    }
+  }
+  if (nmeaSimplifierFlush(simplifier, &kept)) {
+    simplifyKept[count++] = (size_t) kept.time;
+  }
+
+  CU_ASSERT_EQUAL(simplifier->added, SIMPLIFY_POINTS);
+  CU_ASSERT_EQUAL(simplifier->kept, count);
+  return count;
+}
+
+/**
+ * Check that every dropped record lies within the tolerance of the great
+ * circle (or the geodesic) through the kept records around it, and not
+ * beyond the tolerance past the later one
+ */
+static void simplifyCheck(NmeaSimplifyMode mode, double tolerance, size_t count) {
+  size_t k;
+
+  CU_ASSERT_EQUAL(simplifyKept[0], 0);
+  CU_ASSERT_EQUAL(simplifyKept[count - 1], SIMPLIFY_POINTS - 1);
+
+  for (k = 1; k < count; k++) {
+    NmeaGeodesicOrigin origin;
+    NmeaPosition from;
+    NmeaPosition to;
+    double length;
+    double azimuth;
+    size_t i;
+
+    CU_ASSERT_EQUAL(simplifyKept[k] > simplifyKept[k - 1], true);
+
+    simplifyPosition(&simplifyTrack[simplifyKept[k - 1]], &from);
+    simplifyPosition(&simplifyTrack[simplifyKept[k]], &to);
+    nmeaGeodesicOriginInit(&origin, &from);
+    length = nmeaGeodesicInverse(&origin, &to, &azimuth, NULL);
+
+    for (i = simplifyKept[k - 1] + 1; i < simplifyKept[k]; i++) {
+      NmeaPosition position;
+      double d;
+      double a;
+      double cross;
+
+      simplifyPosition(&simplifyTrack[i], &position);
+      d = nmeaGeodesicInverse(&origin, &position, &a, NULL);
+
+      if (mode == NMEALIB_SIMPLIFY_SPHERICAL) {
+        /* the distance to the great circle, with the spherical azimuths */
+        double r = NMEALIB_EARTHRADIUS_M;
+        double dLon = to.lon - from.lon;
+        double gc = atan2(sin(dLon) * cos(to.lat),
+            (cos(from.lat) * sin(to.lat)) - (sin(from.lat) * cos(to.lat) * cos(dLon)));
+
+        dLon = position.lon - from.lon;
+        a = atan2(sin(dLon) * cos(position.lat),
+            (cos(from.lat) * sin(position.lat)) - (sin(from.lat) * cos(position.lat) * cos(dLon)));
+        d = nmeaMathDistance(&from, &position);
+        length = nmeaMathDistance(&from, &to);
+        cross = fabs(r * asin(sin(d / r) * sin(a - gc)));
+      } else {
+        cross = fabs(d * sin(a - azimuth));
+      }
+
+      CU_ASSERT_EQUAL(cross <= (tolerance + 1E-6), true);
+      CU_ASSERT_EQUAL(d <= (length + tolerance + 1E-3), true);
+    }
+  }
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaSimplifierInit(void) {
+  NmeaSimplifier simplifier;
+
+  CU_ASSERT_EQUAL(nmeaSimplifierInit(NULL, NMEALIB_SIMPLIFY_SPHERICAL, 1.0), false);
+  CU_ASSERT_EQUAL(nmeaSimplifierInit(&simplifier, (NmeaSimplifyMode) 2, 1.0), false);
+  CU_ASSERT_EQUAL(nmeaSimplifierInit(&simplifier, NMEALIB_SIMPLIFY_SPHERICAL, 0.0), false);
+  CU_ASSERT_EQUAL(nmeaSimplifierInit(&simplifier, NMEALIB_SIMPLIFY_SPHERICAL, -1.0), false);
+  CU_ASSERT_EQUAL(nmeaSimplifierInit(&simplifier, NMEALIB_SIMPLIFY_SPHERICAL, NaN), false);
+  CU_ASSERT_EQUAL(nmeaSimplifierInit(&simplifier, NMEALIB_SIMPLIFY_SPHERICAL, INFINITY), false);
+
+  CU_ASSERT_EQUAL(nmeaSimplifierInit(&simplifier, NMEALIB_SIMPLIFY_ELLIPSOIDAL, 2.5), true);
+  CU_ASSERT_EQUAL(simplifier.mode, NMEALIB_SIMPLIFY_ELLIPSOIDAL);
+  CU_ASSERT_DOUBLE_EQUAL(simplifier.tolerance, 2.5, DBL_EPSILON);
+  CU_ASSERT_EQUAL(simplifier.anchored, false);
+  CU_ASSERT_EQUAL(simplifier.added, 0);
+  CU_ASSERT_EQUAL(simplifier.kept, 0);
+}
+
+static void test_nmeaSimplifierAdd(void) {
+  NmeaSimplifier simplifier;
+  NmeaPosition position;
+  NmeaRecord record;
+  NmeaRecord kept;
+  NmeaInfo info;
+  size_t i;
+
+  CU_ASSERT_EQUAL(nmeaSimplifierInit(&simplifier, NMEALIB_SIMPLIFY_SPHERICAL, 1.0), true);
+
+  /* invalid inputs */
+
+  position.lat = nmeaMathDegreeToRadian(52.0);
+  position.lon = nmeaMathDegreeToRadian(5.0);
+  simplifyRecord(&record, 0, &position);
+  CU_ASSERT_EQUAL(nmeaSimplifierAdd(NULL, &record, &kept), false);
+  CU_ASSERT_EQUAL(nmeaSimplifierAdd(&simplifier, NULL, &kept), false);
+  CU_ASSERT_EQUAL(nmeaSimplifierAdd(&simplifier, &record, NULL), false);
+  CU_ASSERT_EQUAL(nmeaSimplifierFlush(NULL, &kept), false);
+  CU_ASSERT_EQUAL(nmeaSimplifierFlush(&simplifier, NULL), false);
+  CU_ASSERT_EQUAL(nmeaSimplifierFlush(&simplifier, &kept), false);
+
+  /* without a (valid) position */
+
+  record.present = NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_LAT;
+  CU_ASSERT_EQUAL(nmeaSimplifierAdd(&simplifier, &record, &kept), false);
+  simplifyRecord(&record, 0, &position);
+  record.latitude = 91.0;
+  CU_ASSERT_EQUAL(nmeaSimplifierAdd(&simplifier, &record, &kept), false);
+  record.latitude = NaN;
+  CU_ASSERT_EQUAL(nmeaSimplifierAdd(&simplifier, &record, &kept), false);
+  CU_ASSERT_EQUAL(simplifier.added, 0);
+
+  /* the first record is kept */
+
+  simplifyRecord(&record, 0, &position);
+  memset(&kept, 0, sizeof(kept));
+  CU_ASSERT_EQUAL(nmeaSimplifierAdd(&simplifier, &record, &kept), true);
+  CU_ASSERT_EQUAL(memcmp(&kept, &record, sizeof(kept)), 0);
+  CU_ASSERT_EQUAL(simplifier.kept, 1);
+  CU_ASSERT_EQUAL(nmeaSimplifierFlush(&simplifier, &kept), false);
+
+  /* north, then east: only the corner is kept */
+
+  for (i = 1; i <= 20; i++) {
+    position.lat += nmeaMathDegreeToRadian(1E-4);
+    simplifyRecord(&record, (int64_t) i, &position);
+    CU_ASSERT_EQUAL(nmeaSimplifierAdd(&simplifier, &record, &kept), false);
+  }
+  for (i = 21; i <= 40; i++) {
+    position.lon += nmeaMathDegreeToRadian(1E-4);
+    simplifyRecord(&record, (int64_t) i, &position);
+    CU_ASSERT_EQUAL(nmeaSimplifierAdd(&simplifier, &record, &kept), (i == 21));
+    if (i == 21) {
+      CU_ASSERT_EQUAL(kept.time, 20);
+    }
+  }
+
+  /* the end of the track */
+
+  CU_ASSERT_EQUAL(nmeaSimplifierFlush(&simplifier, &kept), true);
+  CU_ASSERT_EQUAL(kept.time, 40);
+  CU_ASSERT_EQUAL(nmeaSimplifierFlush(&simplifier, &kept), false);
+  CU_ASSERT_EQUAL(simplifier.added, 41);
+  CU_ASSERT_EQUAL(simplifier.kept, 3);
+
+  /* standing still after a flush, within the tolerance */
+
+  position.lat += nmeaMathDegreeToRadian(5E-6);
+  simplifyRecord(&record, 41, &position);
+  CU_ASSERT_EQUAL(nmeaSimplifierAdd(&simplifier, &record, &kept), false);
+  CU_ASSERT_EQUAL(nmeaSimplifierAdd(&simplifier, &record, &kept), false);
+
+  /* back: too far before the end of the window */
+
+  position.lat -= nmeaMathDegreeToRadian(1E-4);
+  simplifyRecord(&record, 42, &position);
+  CU_ASSERT_EQUAL(nmeaSimplifierAdd(&simplifier, &record, &kept), false);
+  position.lat += nmeaMathDegreeToRadian(5E-5);
+  simplifyRecord(&record, 43, &position);
+  CU_ASSERT_EQUAL(nmeaSimplifierAdd(&simplifier, &record, &kept), true);
+  CU_ASSERT_EQUAL(kept.time, 42);
+
+  /* from a NmeaInfo structure */
+
+  memset(&info, 0, sizeof(info));
+  CU_ASSERT_EQUAL(nmeaSimplifierAddInfo(&simplifier, NULL, &kept), false);
+  CU_ASSERT_EQUAL(nmeaSimplifierAddInfo(&simplifier, &info, &kept), false);
+  info.utc.year = 2020;
+  info.utc.mon = 1;
+  info.utc.day = 1;
+  info.latitude = 5210.0;
+  info.longitude = 600.0;
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_UTCDATE);
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_UTCTIME);
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_LAT);
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_LON);
+  CU_ASSERT_EQUAL(nmeaSimplifierAddInfo(&simplifier, &info, &kept), true);
+  CU_ASSERT_EQUAL(kept.time, 43);
+  CU_ASSERT_EQUAL(nmeaSimplifierFlush(&simplifier, &kept), true);
+  CU_ASSERT_DOUBLE_EQUAL(kept.latitude, 52.0 + (10.0 / 60.0), 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(kept.longitude, 6.0, 1E-9);
+}
+
+static void test_nmeaSimplifierTrack(void) {
+  static const NmeaSimplifyMode modes[2] = {
+      NMEALIB_SIMPLIFY_SPHERICAL,
+      NMEALIB_SIMPLIFY_ELLIPSOIDAL };
+  static const double tolerances[3] = {
+      1.0,
+      5.0,
+      20.0 };
+  NmeaSimplifier simplifier;
+  NmeaRandom random;
+  size_t previous;
+  size_t count;
+  size_t m;
+  size_t t;
+
+  nmeaRandomSeed(&random, 44);
+
+  for (m = 0; m < 2; m++) {
+    /* around Amsterdam, then across the antimeridian near the north pole */
+    simplifyGenerate(&random, (m == 0) ? 52.0 : 84.0, (m == 0) ? 5.0 : 179.9, 80.0, 2.0);
+
+    previous = SIMPLIFY_POINTS + 1;
+    for (t = 0; t < 3; t++) {
+      CU_ASSERT_EQUAL(nmeaSimplifierInit(&simplifier, modes[m], tolerances[t]), true);
+      count = simplifyRun(&simplifier);
+      simplifyCheck(modes[m], tolerances[t], count);
+
+      /* a larger tolerance keeps fewer records */
+      CU_ASSERT_EQUAL(count < previous, true);
+      previous = count;
+    }
+    CU_ASSERT_EQUAL(previous < (SIMPLIFY_POINTS / 20), true);
+  }
+}
+
+/*
+ * Setup
+ */
+
+int simplifySuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("simplify", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaSimplifierInit", test_nmeaSimplifierInit)) //
+      || (!CU_add_test(pSuite, "nmeaSimplifierAdd", test_nmeaSimplifierAdd)) //
+      || (!CU_add_test(pSuite, "nmeaSimplifierTrack", test_nmeaSimplifierTrack)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
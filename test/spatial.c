@@ -0,0 +1,389 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/spatial.h>
+#include <nmealib/nmath.h>
+#include <nmealib/random.h>
+#include <nmealib/util.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+int spatialSuiteSetup(void);
+
+#define SPATIAL_UNITS (3000u)
+#define SPATIAL_QUERIES (200u)
+#define SPATIAL_K (12u)
+
+static NmeaPosition spatialPositions[SPATIAL_UNITS];
+static bool spatialPresent[SPATIAL_UNITS];
+
+/*
+ * Helpers
+ */
+
+/**
+ * The haversine distance between 2 positions
+ */
+static double spatialDistance(const NmeaPosition *a, const NmeaPosition *b) {
+  double sinLat = sin((b->lat - a->lat) / 2.0);
+  double sinLon = sin((b->lon - a->lon) / 2.0);
+  double h = (sinLat * sinLat) + (cos(a->lat) * cos(b->lat) * sinLon * sinLon);
+
+  return 2.0 * NMEALIB_EARTHRADIUS_M * asin(MIN(sqrt(h), 1.0));
+}
+
+/**
+ * A random position: a third in a cluster around Amsterdam, a third near
+ * the antimeridian and the north pole, and a third anywhere
+ */
+static void spatialRandomPosition(NmeaRandom *random, size_t i, NmeaPosition *position) {
+  switch (i % 3) {
+    case 0:
+      position->lat = nmeaMathDegreeToRadian(52.37 + nmeaRandomDouble(random, -0.3, 0.3));
+      position->lon = nmeaMathDegreeToRadian(4.9 + nmeaRandomDouble(random, -0.5, 0.5));
+      break;
+
+    case 1:
+      position->lat = nmeaMathDegreeToRadian(nmeaRandomDouble(random, 60.0, 90.0));
+      position->lon = nmeaMathDegreeToRadian(nmeaRandomDouble(random, 170.0, 190.0));
+      break;
+
+    default:
+      position->lat = asin(nmeaRandomDouble(random, -1.0, 1.0));
+      position->lon = nmeaRandomDouble(random, -NMEALIB_PI, NMEALIB_PI);
+      break;
+  }
+}
+
+static void spatialFill(NmeaSpatial *index, NmeaRandom *random) {
+  size_t i;
+
+  for (i = 0; i < SPATIAL_UNITS; i++) {
+    spatialRandomPosition(random, i, &spatialPositions[i]);
+    spatialPresent[i] = nmeaSpatialUpdate(index, 1000 + i, &spatialPositions[i]);
+    CU_ASSERT_EQUAL(spatialPresent[i], true);
+  }
+}
+
+/**
+ * Check the index against the units it should hold
+ */
+static void spatialCheck(NmeaSpatial *index, NmeaRandom *random) {
+  static NmeaSpatialResult results[SPATIAL_UNITS];
+  static uint64_t ids[SPATIAL_UNITS];
+  NmeaPosition center;
+  NmeaPosition southWest;
+  NmeaPosition northEast;
+  size_t present = 0;
+  size_t q;
+  size_t i;
+
+  for (i = 0; i < SPATIAL_UNITS; i++) {
+    NmeaPosition position;
+
+    CU_ASSERT_EQUAL(nmeaSpatialGet(index, 1000 + i, &position), spatialPresent[i]);
+    if (spatialPresent[i]) {
+      CU_ASSERT_DOUBLE_EQUAL(position.lat, spatialPositions[i].lat, 0.0);
+      CU_ASSERT_DOUBLE_EQUAL(remainder(position.lon - spatialPositions[i].lon, 2.0 * NMEALIB_PI), 0.0, 1E-15);
+      present++;
+    }
+  }
+  CU_ASSERT_EQUAL(nmeaSpatialCount(index), present);
+
+  for (q = 0; q < SPATIAL_QUERIES; q++) {
+    double radius = nmeaRandomDouble(random, 0.0, (q & 1) ?
+        10000.0 :
+        2E6);
+    size_t expected = 0;
+    size_t found;
+    size_t closer;
+
+    spatialRandomPosition(random, q, &center);
+
+    /* k nearest: sorted, and no unit outside the results is nearer */
+
+    found = nmeaSpatialNearest(index, &center, results, SPATIAL_K);
+    CU_ASSERT_EQUAL(found, MIN(SPATIAL_K, present));
+    for (i = 1; i < found; i++) {
+      CU_ASSERT_EQUAL(results[i - 1].distance <= results[i].distance, true);
+    }
+    for (i = 0; i < found; i++) {
+      size_t unit = (size_t) (results[i].id - 1000);
+
+      CU_ASSERT_EQUAL(spatialPresent[unit], true);
+      CU_ASSERT_DOUBLE_EQUAL(results[i].distance, spatialDistance(&center, &spatialPositions[unit]), 1E-6);
+    }
+    closer = 0;
+    for (i = 0; i < SPATIAL_UNITS; i++) {
+      if (spatialPresent[i] //
+          && found //
+          && (spatialDistance(&center, &spatialPositions[i]) < (results[found - 1].distance - 1E-6))) {
+        closer++;
+      }
+    }
+    CU_ASSERT_EQUAL(closer < found, true);
+
+    /* radius */
+
+    for (i = 0; i < SPATIAL_UNITS; i++) {
+      if (spatialPresent[i] //
+          && (spatialDistance(&center, &spatialPositions[i]) <= radius)) {
+        expected++;
+      }
+    }
+    found = nmeaSpatialRadius(index, &center, radius, results, SPATIAL_UNITS);
+    CU_ASSERT_EQUAL(found, expected);
+    for (i = 0; i < MIN(found, SPATIAL_UNITS); i++) {
+      size_t unit = (size_t) (results[i].id - 1000);
+
+      CU_ASSERT_EQUAL(spatialPresent[unit], true);
+      CU_ASSERT_EQUAL(results[i].distance <= radius, true);
+      CU_ASSERT_DOUBLE_EQUAL(results[i].distance, spatialDistance(&center, &spatialPositions[unit]), 1E-6);
+    }
+    CU_ASSERT_EQUAL(nmeaSpatialRadius(index, &center, radius, NULL, 0), expected);
+
+    /* box, which may cross the antimeridian */
+
+    southWest.lat = center.lat - (radius / NMEALIB_EARTHRADIUS_M);
+    northEast.lat = center.lat + (radius / NMEALIB_EARTHRADIUS_M);
+    southWest.lon = center.lon - (radius / NMEALIB_EARTHRADIUS_M);
+    northEast.lon = center.lon + (radius / NMEALIB_EARTHRADIUS_M);
+    expected = 0;
+    for (i = 0; i < SPATIAL_UNITS; i++) {
+      double lon = remainder(spatialPositions[i].lon - center.lon, 2.0 * NMEALIB_PI);
+
+      if (spatialPresent[i] //
+          && (spatialPositions[i].lat >= southWest.lat) //
+          && (spatialPositions[i].lat <= northEast.lat) //
+          && (fabs(lon) <= (radius / NMEALIB_EARTHRADIUS_M))) {
+        expected++;
+      }
+    }
+    found = nmeaSpatialBox(index, &southWest, &northEast, ids, SPATIAL_UNITS);
+    CU_ASSERT_EQUAL(found, expected);
+  }
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaSpatialCreate(void) {
+  NmeaSpatial *index;
+
+  CU_ASSERT_PTR_NULL(nmeaSpatialCreate(NaN));
+  CU_ASSERT_PTR_NULL(nmeaSpatialCreate(-1.0));
+  CU_ASSERT_PTR_NULL(nmeaSpatialCreate(NMEALIB_SPATIAL_CELL_SIZE_MIN / 2.0));
+
+  index = nmeaSpatialCreate(0.0);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+  CU_ASSERT_EQUAL(nmeaSpatialCount(index), 0);
+  nmeaSpatialDestroy(index);
+
+  index = nmeaSpatialCreate(NMEALIB_SPATIAL_CELL_SIZE_MIN);
+  CU_ASSERT_PTR_NOT_NULL(index);
+  nmeaSpatialDestroy(index);
+
+  nmeaSpatialDestroy(NULL);
+  nmeaSpatialClear(NULL);
+  CU_ASSERT_EQUAL(nmeaSpatialCount(NULL), 0);
+}
+
+static void test_nmeaSpatialUpdate(void) {
+  NmeaSpatial *index = nmeaSpatialCreate(0.0);
+  NmeaPosition position;
+  NmeaPosition got;
+  NmeaInfo info;
+
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+
+  /* invalid inputs */
+
+  position.lat = 0.9;
+  position.lon = 0.1;
+  CU_ASSERT_EQUAL(nmeaSpatialUpdate(NULL, 1, &position), false);
+  CU_ASSERT_EQUAL(nmeaSpatialUpdate(index, 1, NULL), false);
+  position.lat = NaN;
+  CU_ASSERT_EQUAL(nmeaSpatialUpdate(index, 1, &position), false);
+  position.lat = 2.0;
+  CU_ASSERT_EQUAL(nmeaSpatialUpdate(index, 1, &position), false);
+  position.lat = 0.9;
+  position.lon = INFINITY;
+  CU_ASSERT_EQUAL(nmeaSpatialUpdate(index, 1, &position), false);
+  CU_ASSERT_EQUAL(nmeaSpatialCount(index), 0);
+
+  /* add, then move within and across cells, with a longitude that is normalised */
+
+  position.lon = 0.1;
+  CU_ASSERT_EQUAL(nmeaSpatialUpdate(index, 1, &position), true);
+  CU_ASSERT_EQUAL(nmeaSpatialUpdate(index, UINT64_MAX, &position), true);
+  CU_ASSERT_EQUAL(nmeaSpatialCount(index), 2);
+
+  position.lon = 0.1 + 1E-7;
+  CU_ASSERT_EQUAL(nmeaSpatialUpdate(index, 1, &position), true);
+  position.lon = 0.1 + (2.0 * NMEALIB_PI) + 0.5;
+  CU_ASSERT_EQUAL(nmeaSpatialUpdate(index, 1, &position), true);
+  CU_ASSERT_EQUAL(nmeaSpatialCount(index), 2);
+  CU_ASSERT_EQUAL(nmeaSpatialGet(index, 1, &got), true);
+  CU_ASSERT_DOUBLE_EQUAL(got.lat, 0.9, 0.0);
+  CU_ASSERT_DOUBLE_EQUAL(got.lon, 0.6, 1E-15);
+  CU_ASSERT_EQUAL(nmeaSpatialGet(index, 1, NULL), true);
+  CU_ASSERT_EQUAL(nmeaSpatialGet(index, 2, &got), false);
+  CU_ASSERT_EQUAL(nmeaSpatialGet(NULL, 1, &got), false);
+
+  /* from an info structure, in NDEG */
+
+  memset(&info, 0, sizeof(info));
+  CU_ASSERT_EQUAL(nmeaSpatialUpdateInfo(index, 3, NULL), false);
+  CU_ASSERT_EQUAL(nmeaSpatialUpdateInfo(index, 3, &info), false);
+  info.latitude = 5222.2;
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_LAT);
+  CU_ASSERT_EQUAL(nmeaSpatialUpdateInfo(index, 3, &info), false);
+  info.longitude = -454.0;
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_LON);
+  CU_ASSERT_EQUAL(nmeaSpatialUpdateInfo(NULL, 3, &info), false);
+  CU_ASSERT_EQUAL(nmeaSpatialUpdateInfo(index, 3, &info), true);
+  CU_ASSERT_EQUAL(nmeaSpatialGet(index, 3, &got), true);
+  CU_ASSERT_DOUBLE_EQUAL(got.lat, nmeaMathNdegToRadian(5222.2), 1E-15);
+  CU_ASSERT_DOUBLE_EQUAL(got.lon, nmeaMathNdegToRadian(-454.0), 1E-15);
+  CU_ASSERT_EQUAL(nmeaSpatialCount(index), 3);
+
+  /* remove */
+
+  CU_ASSERT_EQUAL(nmeaSpatialRemove(NULL, 1), false);
+  CU_ASSERT_EQUAL(nmeaSpatialRemove(index, 2), false);
+  CU_ASSERT_EQUAL(nmeaSpatialRemove(index, 1), true);
+  CU_ASSERT_EQUAL(nmeaSpatialRemove(index, 1), false);
+  CU_ASSERT_EQUAL(nmeaSpatialCount(index), 2);
+  CU_ASSERT_EQUAL(nmeaSpatialGet(index, UINT64_MAX, &got), true);
+  CU_ASSERT_EQUAL(nmeaSpatialGet(index, 3, &got), true);
+
+  /* clear */
+
+  nmeaSpatialClear(index);
+  CU_ASSERT_EQUAL(nmeaSpatialCount(index), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialGet(index, 3, &got), false);
+  CU_ASSERT_EQUAL(nmeaSpatialUpdate(index, 3, &position), true);
+  CU_ASSERT_EQUAL(nmeaSpatialCount(index), 1);
+
+  nmeaSpatialDestroy(index);
+}
+
+static void test_nmeaSpatialQueries(void) {
+  NmeaSpatial *index = nmeaSpatialCreate(20000.0);
+  NmeaSpatialResult results[SPATIAL_K];
+  uint64_t ids[4];
+  NmeaPosition position;
+  NmeaPosition northEast;
+  NmeaRandom random;
+  size_t i;
+
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+  nmeaRandomSeed(&random, 42);
+
+  /* invalid inputs and an empty index */
+
+  position.lat = 0.9;
+  position.lon = 0.1;
+  northEast.lat = 1.0;
+  northEast.lon = 0.2;
+  CU_ASSERT_EQUAL(nmeaSpatialNearest(NULL, &position, results, SPATIAL_K), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialNearest(index, NULL, results, SPATIAL_K), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialNearest(index, &position, NULL, SPATIAL_K), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialNearest(index, &position, results, 0), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialNearest(index, &position, results, SPATIAL_K), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialRadius(NULL, &position, 1000.0, results, SPATIAL_K), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialRadius(index, NULL, 1000.0, results, SPATIAL_K), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialRadius(index, &position, 1000.0, NULL, SPATIAL_K), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialRadius(index, &position, -1.0, results, SPATIAL_K), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialRadius(index, &position, NaN, results, SPATIAL_K), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialRadius(index, &position, 1000.0, results, SPATIAL_K), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialBox(NULL, &position, &northEast, ids, 4), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialBox(index, NULL, &northEast, ids, 4), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialBox(index, &position, NULL, ids, 4), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialBox(index, &position, &northEast, NULL, 4), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialBox(index, &northEast, &position, ids, 4), 0);
+  CU_ASSERT_EQUAL(nmeaSpatialBox(index, &position, &northEast, ids, 4), 0);
+
+  /* few units */
+
+  CU_ASSERT_EQUAL(nmeaSpatialUpdate(index, 7, &position), true);
+  CU_ASSERT_EQUAL(nmeaSpatialNearest(index, &northEast, results, SPATIAL_K), 1);
+  CU_ASSERT_EQUAL(results[0].id, 7);
+  CU_ASSERT_DOUBLE_EQUAL(results[0].distance, spatialDistance(&position, &northEast), 1E-6);
+  CU_ASSERT_EQUAL(nmeaSpatialRadius(index, &position, 0.0, results, SPATIAL_K), 1);
+  CU_ASSERT_DOUBLE_EQUAL(results[0].distance, 0.0, 0.0);
+  CU_ASSERT_EQUAL(nmeaSpatialRadius(index, &northEast, 3E7, results, SPATIAL_K), 1);
+  CU_ASSERT_EQUAL(nmeaSpatialBox(index, &position, &northEast, ids, 4), 1);
+  CU_ASSERT_EQUAL(ids[0], 7);
+  nmeaSpatialClear(index);
+
+  /* many units */
+
+  spatialFill(index, &random);
+  spatialCheck(index, &random);
+
+  /* move all units, remove some */
+
+  for (i = 0; i < SPATIAL_UNITS; i++) {
+    if ((i % 7) == 0) {
+      CU_ASSERT_EQUAL(nmeaSpatialRemove(index, 1000 + i), true);
+      spatialPresent[i] = false;
+    } else {
+      spatialPositions[i].lat = MIN(spatialPositions[i].lat + nmeaRandomDouble(&random, -1E-3, 1E-3),
+          NMEALIB_PI / 2.0);
+      spatialPositions[i].lon += nmeaRandomDouble(&random, -1E-2, 1E-2);
+      CU_ASSERT_EQUAL(nmeaSpatialUpdate(index, 1000 + i, &spatialPositions[i]), true);
+    }
+  }
+  spatialCheck(index, &random);
+
+  /* a coarse grid that falls back to scanning */
+
+  nmeaSpatialDestroy(index);
+  index = nmeaSpatialCreate(3E6);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+  spatialFill(index, &random);
+  spatialCheck(index, &random);
+
+  nmeaSpatialDestroy(index);
+}
+
+/*
+ * Setup
+ */
+
+int spatialSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("spatial", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaSpatialCreate", test_nmeaSpatialCreate)) //
+      || (!CU_add_test(pSuite, "nmeaSpatialUpdate", test_nmeaSpatialUpdate)) //
+      || (!CU_add_test(pSuite, "nmeaSpatialQueries", test_nmeaSpatialQueries)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
@@ -0,0 +1,412 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/stats.h>
+#include <nmealib/nmath.h>
+#include <nmealib/random.h>
+#include <nmealib/util.h>
+#include <CUnit/Basic.h>
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+int statsSuiteSetup(void);
+
+#define STATS_VALUES (20000u)
+#define STATS_EPOCHS (6000u)
+
+/** The meridian radius of curvature at 52N (WGS84) */
+#define STATS_M (6375149.741)
+
+/** The prime vertical radius of curvature at 52N (WGS84) */
+#define STATS_N (6391435.268)
+
+static double statsValues[STATS_VALUES];
+static double statsEast[STATS_EPOCHS];
+static double statsNorth[STATS_EPOCHS];
+
+/*
+ * Helpers
+ */
+
+static int statsCompare(const void *a, const void *b) {
+  double x = *(const double *) a;
+  double y = *(const double *) b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+ * A normally distributed random number (Box-Muller)
+ */
+static double statsNormal(NmeaRandom *random) {
+  double u = nmeaRandomDouble(random, DBL_MIN, 1.0);
+  double v = nmeaRandomDouble(random, 0.0, 2.0 * NMEALIB_PI);
+
+  return sqrt(-2.0 * log(u)) * cos(v);
+}
+
+/**
+ * An epoch at 10 Hz with a 3D fix at an offset (in meters) from 52N 5E
+ */
+static void statsInfo(NmeaInfo *info, size_t epoch, double east, double north) {
+  double lat = 52.0 + nmeaMathRadianToDegree(north / STATS_M);
+  double lon = 5.0 + nmeaMathRadianToDegree(east / (STATS_N * cos(nmeaMathDegreeToRadian(52.0))));
+
+  memset(info, 0, sizeof(*info));
+  info->utc.year = 2020;
+  info->utc.mon = 1;
+  info->utc.day = 1;
+  info->utc.hour = (unsigned int) (epoch / 36000);
+  info->utc.min = (unsigned int) ((epoch / 600) % 60);
+  info->utc.sec = (unsigned int) ((epoch / 10) % 60);
+  info->utc.hsec = (unsigned int) ((epoch % 10) * 10);
+  info->fix = NMEALIB_FIX_3D;
+  info->latitude = nmeaMathDegreeToNdeg(lat);
+  info->longitude = nmeaMathDegreeToNdeg(lon);
+  info->elevation = 10.0 + (double) (epoch % 5);
+  info->hdop = 0.8 + (double) (epoch % 10) / 10.0;
+  info->satellites.inView[0].prn = 1;
+  info->satellites.inView[0].snr = 40;
+  info->satellites.inView[3].prn = 7;
+  info->satellites.inView[3].snr = 20;
+  info->satellites.inView[5].prn = 9;
+  info->present = NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_FIX | NMEALIB_PRESENT_LAT
+      | NMEALIB_PRESENT_LON | NMEALIB_PRESENT_ELV | NMEALIB_PRESENT_HDOP | NMEALIB_PRESENT_SATINVIEW;
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaSketch(void) {
+  static const double quantiles[] = {
+      0.0,
+      0.01,
+      0.1,
+      0.5,
+      0.9,
+      0.95,
+      0.99,
+      1.0 };
+  NmeaSketch sketch;
+  NmeaSketch half;
+  NmeaRandom random;
+  size_t i;
+
+  /* invalid inputs */
+
+  nmeaSketchClear(NULL);
+  nmeaSketchAdd(NULL, 1.0);
+  nmeaSketchMerge(NULL, &sketch);
+  nmeaSketchMerge(&sketch, NULL);
+  CU_ASSERT_EQUAL(isNaN(nmeaSketchQuantile(NULL, 0.5)), true);
+
+  nmeaSketchClear(&sketch);
+  CU_ASSERT_EQUAL(sketch.count, 0);
+  CU_ASSERT_EQUAL(isNaN(nmeaSketchQuantile(&sketch, 0.5)), true);
+
+  nmeaSketchAdd(&sketch, -1.0);
+  nmeaSketchAdd(&sketch, NaN);
+  nmeaSketchAdd(&sketch, INFINITY);
+  CU_ASSERT_EQUAL(sketch.count, 0);
+
+  nmeaSketchAdd(&sketch, 2.0);
+  CU_ASSERT_EQUAL(isNaN(nmeaSketchQuantile(&sketch, -0.1)), true);
+  CU_ASSERT_EQUAL(isNaN(nmeaSketchQuantile(&sketch, 1.1)), true);
+  CU_ASSERT_EQUAL(isNaN(nmeaSketchQuantile(&sketch, NaN)), true);
+
+  /* a single value, below and above the range */
+
+  CU_ASSERT_DOUBLE_EQUAL(nmeaSketchQuantile(&sketch, 0.5), 2.0, 1E-12);
+  nmeaSketchClear(&sketch);
+  nmeaSketchAdd(&sketch, 0.0);
+  nmeaSketchAdd(&sketch, 0.01);
+  nmeaSketchAdd(&sketch, 5000.0);
+  CU_ASSERT_EQUAL(sketch.count, 3);
+  CU_ASSERT_EQUAL(sketch.low, 2);
+  CU_ASSERT_EQUAL(sketch.buckets[NMEALIB_SKETCH_BUCKETS - 1], 1);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaSketchQuantile(&sketch, 0.0), 0.0, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaSketchQuantile(&sketch, 0.5), 0.0, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaSketchQuantile(&sketch, 1.0), 5000.0, 1E-12);
+
+  /* against exact quantiles, of merged halves */
+
+  nmeaRandomSeed(&random, 45);
+  nmeaSketchClear(&sketch);
+  nmeaSketchClear(&half);
+  for (i = 0; i < STATS_VALUES; i++) {
+    statsValues[i] = exp(statsNormal(&random));
+    nmeaSketchAdd((i & 1) ?
+        &half :
+        &sketch, statsValues[i]);
+  }
+  nmeaSketchMerge(&sketch, &half);
+  CU_ASSERT_EQUAL(sketch.count, STATS_VALUES);
+
+  qsort(statsValues, STATS_VALUES, sizeof(statsValues[0]), statsCompare);
+  for (i = 0; i < (sizeof(quantiles) / sizeof(quantiles[0])); i++) {
+    double exact = statsValues[(size_t) (quantiles[i] * (STATS_VALUES - 1))];
+    double estimate = nmeaSketchQuantile(&sketch, quantiles[i]);
+
+    CU_ASSERT_DOUBLE_EQUAL(estimate, exact, exact * 0.0197);
+  }
+}
+
+static void test_nmeaStatsAddInfo(void) {
+  NmeaStats stats;
+  NmeaPosition mean;
+  NmeaInfo info;
+  double east;
+  double north;
+  double eastNorth;
+
+  /* invalid inputs */
+
+  nmeaStatsClear(NULL);
+  nmeaStatsClear(&stats);
+  statsInfo(&info, 0, 0.0, 0.0);
+  CU_ASSERT_EQUAL(nmeaStatsAddInfo(NULL, &info), false);
+  CU_ASSERT_EQUAL(nmeaStatsAddInfo(&stats, NULL), false);
+  nmeaStatsFlush(NULL);
+
+  /* empty */
+
+  CU_ASSERT_EQUAL(stats.epochs, 0);
+  CU_ASSERT_EQUAL(isNaN(nmeaStatsFixRate(&stats)), true);
+  CU_ASSERT_EQUAL(isNaN(nmeaStatsEpochRate(&stats)), true);
+  CU_ASSERT_EQUAL(nmeaStatsMean(NULL, &mean), false);
+  CU_ASSERT_EQUAL(nmeaStatsMean(&stats, NULL), false);
+  CU_ASSERT_EQUAL(nmeaStatsMean(&stats, &mean), false);
+  CU_ASSERT_EQUAL(nmeaStatsCovariance(&stats, &east, &north, &eastNorth), false);
+  CU_ASSERT_EQUAL(isNaN(nmeaStatsCep(&stats)), true);
+  CU_ASSERT_EQUAL(isNaN(nmeaStatsDrms2(&stats)), true);
+  CU_ASSERT_EQUAL(isNaN(nmeaStatsFixRate(NULL)), true);
+  CU_ASSERT_EQUAL(isNaN(nmeaStatsEpochRate(NULL)), true);
+
+  /* the first epoch, of which the first version (without a fix) is replaced by the next */
+
+  info.fix = NMEALIB_FIX_BAD;
+  nmeaInfoUnsetPresent(&info.present, NMEALIB_PRESENT_HDOP);
+  nmeaInfoUnsetPresent(&info.present, NMEALIB_PRESENT_SATINVIEW);
+  CU_ASSERT_EQUAL(nmeaStatsAddInfo(&stats, &info), true);
+  CU_ASSERT_EQUAL(stats.epochs, 0);
+  CU_ASSERT_EQUAL(stats.pending, true);
+  statsInfo(&info, 0, 0.0, 0.0);
+  CU_ASSERT_EQUAL(nmeaStatsAddInfo(&stats, &info), false);
+  CU_ASSERT_EQUAL(nmeaStatsAddInfo(&stats, &info), false);
+  nmeaStatsFlush(&stats);
+  nmeaStatsFlush(&stats);
+  CU_ASSERT_EQUAL(stats.pending, false);
+  CU_ASSERT_EQUAL(stats.epochs, 1);
+  CU_ASSERT_EQUAL(stats.fixes, 1);
+  CU_ASSERT_EQUAL(stats.positions, 1);
+  CU_ASSERT_EQUAL(stats.elevations, 1);
+  CU_ASSERT_EQUAL(stats.hdop.count, 1);
+  CU_ASSERT_EQUAL(stats.pdop.count, 0);
+  CU_ASSERT_EQUAL(stats.snr.count, 2);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaSketchQuantile(&stats.snr, 0.0), 20.0, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaSketchQuantile(&stats.snr, 1.0), 40.0, 1E-12);
+  CU_ASSERT_EQUAL(nmeaStatsCovariance(&stats, NULL, NULL, NULL), false);
+
+  /* a 2D fix: no elevation */
+
+  statsInfo(&info, 1, 1.0, 0.0);
+  info.fix = NMEALIB_FIX_2D;
+  CU_ASSERT_EQUAL(nmeaStatsAddInfo(&stats, &info), true);
+  nmeaStatsFlush(&stats);
+  CU_ASSERT_EQUAL(stats.positions, 2);
+  CU_ASSERT_EQUAL(stats.elevations, 1);
+
+  /* no fix: no position, but DOPs */
+
+  statsInfo(&info, 2, 50.0, 0.0);
+  info.fix = NMEALIB_FIX_BAD;
+  info.pdop = 3.0;
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_PDOP);
+  CU_ASSERT_EQUAL(nmeaStatsAddInfo(&stats, &info), true);
+  nmeaStatsFlush(&stats);
+  CU_ASSERT_EQUAL(stats.fixes, 2);
+  CU_ASSERT_EQUAL(stats.positions, 2);
+  CU_ASSERT_EQUAL(stats.pdop.count, 1);
+
+  /* a signal instead of a fix, in metric units, without a time */
+
+  statsInfo(&info, 3, 2.0, 0.0);
+  info.latitude = nmeaMathNdegToDegree(info.latitude);
+  info.longitude = nmeaMathNdegToDegree(info.longitude);
+  info.hdop = nmeaMathDopToMeters(4.0);
+  info.metric = true;
+  info.sig = NMEALIB_SIG_FIX;
+  info.present &= ~((uint32_t) (NMEALIB_PRESENT_FIX | NMEALIB_PRESENT_UTCDATE));
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_SIG);
+  CU_ASSERT_EQUAL(nmeaStatsAddInfo(&stats, &info), true);
+  CU_ASSERT_EQUAL(nmeaStatsAddInfo(&stats, &info), true);
+  nmeaStatsFlush(&stats);
+  CU_ASSERT_EQUAL(stats.epochs, 5);
+  CU_ASSERT_EQUAL(stats.fixes, 4);
+  CU_ASSERT_EQUAL(stats.timed, 3);
+  CU_ASSERT_EQUAL(stats.positions, 4);
+  CU_ASSERT_EQUAL(stats.elevations, 3);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaSketchQuantile(&stats.hdop, 1.0), 4.0, 1E-9);
+
+  CU_ASSERT_DOUBLE_EQUAL(nmeaStatsFixRate(&stats), 0.8, 1E-12);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaStatsEpochRate(&stats), 10.0, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(stats.elevation, 12.0, 1E-12);
+
+  /* offsets 0, 1, 2, 2 east */
+
+  CU_ASSERT_DOUBLE_EQUAL(stats.east, 1.25, 1E-3);
+  CU_ASSERT_DOUBLE_EQUAL(stats.north, 0.0, 1E-3);
+  CU_ASSERT_EQUAL(nmeaStatsCovariance(&stats, &east, &north, &eastNorth), true);
+  CU_ASSERT_DOUBLE_EQUAL(east, 0.9167, 1E-3);
+  CU_ASSERT_DOUBLE_EQUAL(north, 0.0, 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(eastNorth, 0.0, 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaStatsDrms2(&stats), 2.0 * sqrt(0.9167), 1E-3);
+}
+
+static void test_nmeaStatsMoments(void) {
+  NmeaStats stats;
+  NmeaStats shards[3];
+  NmeaStats merged;
+  NmeaPosition mean;
+  NmeaRandom random;
+  NmeaInfo info;
+  double meanEast = 0.0;
+  double meanNorth = 0.0;
+  double varEast = 0.0;
+  double varNorth = 0.0;
+  double covariance = 0.0;
+  double east;
+  double north;
+  double eastNorth;
+  size_t inside = 0;
+  size_t i;
+
+  nmeaRandomSeed(&random, 46);
+  nmeaStatsClear(&stats);
+  nmeaStatsClear(&merged);
+  for (i = 0; i < 3; i++) {
+    nmeaStatsClear(&shards[i]);
+  }
+
+  /* correlated noise, 3 m east and 1.5 m north, around an offset */
+  for (i = 0; i < STATS_EPOCHS; i++) {
+    double a = statsNormal(&random);
+    double b = statsNormal(&random);
+
+    statsEast[i] = 20.0 + (3.0 * a);
+    statsNorth[i] = -10.0 + (1.5 * ((0.6 * a) + (0.8 * b)));
+    statsInfo(&info, i, statsEast[i], statsNorth[i]);
+    CU_ASSERT_EQUAL(nmeaStatsAddInfo(&stats, &info), true);
+    CU_ASSERT_EQUAL(nmeaStatsAddInfo(&shards[(i * 3) / STATS_EPOCHS], &info), true);
+
+    meanEast += statsEast[i];
+    meanNorth += statsNorth[i];
+  }
+  nmeaStatsFlush(&stats);
+
+  /* two-pass moments */
+
+  meanEast /= STATS_EPOCHS;
+  meanNorth /= STATS_EPOCHS;
+  for (i = 0; i < STATS_EPOCHS; i++) {
+    varEast += (statsEast[i] - meanEast) * (statsEast[i] - meanEast);
+    varNorth += (statsNorth[i] - meanNorth) * (statsNorth[i] - meanNorth);
+    covariance += (statsEast[i] - meanEast) * (statsNorth[i] - meanNorth);
+  }
+  varEast /= STATS_EPOCHS - 1;
+  varNorth /= STATS_EPOCHS - 1;
+  covariance /= STATS_EPOCHS - 1;
+
+  CU_ASSERT_EQUAL(stats.positions, STATS_EPOCHS);
+  CU_ASSERT_EQUAL(nmeaStatsCovariance(&stats, &east, &north, &eastNorth), true);
+  CU_ASSERT_DOUBLE_EQUAL(east, varEast, varEast * 1E-3);
+  CU_ASSERT_DOUBLE_EQUAL(north, varNorth, varNorth * 1E-3);
+  CU_ASSERT_DOUBLE_EQUAL(eastNorth, covariance, fabs(covariance) * 1E-3);
+
+  /* the mean position, the first offset is the reference */
+
+  CU_ASSERT_EQUAL(nmeaStatsMean(&stats, &mean), true);
+  CU_ASSERT_DOUBLE_EQUAL((mean.lat - nmeaMathDegreeToRadian(52.0)) * STATS_M, meanNorth, 1E-3);
+  CU_ASSERT_DOUBLE_EQUAL((mean.lon - nmeaMathDegreeToRadian(5.0)) * STATS_N * cos(nmeaMathDegreeToRadian(52.0)),
+      meanEast, 1E-3);
+
+  /* CEP: the median distance to the mean */
+
+  for (i = 0; i < STATS_EPOCHS; i++) {
+    double dEast = statsEast[i] - meanEast;
+    double dNorth = statsNorth[i] - meanNorth;
+
+    if (sqrt((dEast * dEast) + (dNorth * dNorth)) <= nmeaStatsCep(&stats)) {
+      inside++;
+    }
+  }
+  CU_ASSERT_DOUBLE_EQUAL((double) inside / STATS_EPOCHS, 0.5, 0.03);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaStatsDrms2(&stats), 2.0 * sqrt(varEast + varNorth), 1E-2);
+
+  /* merged shards, with their last epochs still held back */
+
+  nmeaStatsMerge(NULL, &shards[0]);
+  nmeaStatsMerge(&merged, NULL);
+  for (i = 0; i < 3; i++) {
+    nmeaStatsMerge(&merged, &shards[i]);
+  }
+  nmeaStatsMerge(&merged, &merged);
+
+  CU_ASSERT_EQUAL(merged.epochs, stats.epochs);
+  CU_ASSERT_EQUAL(merged.fixes, stats.fixes);
+  CU_ASSERT_EQUAL(merged.timed, stats.timed);
+  CU_ASSERT_EQUAL(merged.timeFirst, stats.timeFirst);
+  CU_ASSERT_EQUAL(merged.timeLast, stats.timeLast);
+  CU_ASSERT_EQUAL(merged.positions, stats.positions);
+  CU_ASSERT_EQUAL(merged.elevations, stats.elevations);
+  CU_ASSERT_DOUBLE_EQUAL(merged.east, stats.east, 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(merged.north, stats.north, 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(merged.m2East, stats.m2East, stats.m2East * 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(merged.m2North, stats.m2North, stats.m2North * 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(merged.cEastNorth, stats.cEastNorth, fabs(stats.cEastNorth) * 1E-6);
+  CU_ASSERT_DOUBLE_EQUAL(merged.elevation, stats.elevation, 1E-9);
+  CU_ASSERT_DOUBLE_EQUAL(merged.m2Elevation, stats.m2Elevation, stats.m2Elevation * 1E-9);
+  CU_ASSERT_EQUAL(memcmp(&merged.hdop, &stats.hdop, sizeof(stats.hdop)), 0);
+  CU_ASSERT_EQUAL(memcmp(&merged.snr, &stats.snr, sizeof(stats.snr)), 0);
+  CU_ASSERT_DOUBLE_EQUAL(nmeaStatsEpochRate(&merged), 10.0, 1E-9);
+}
+
+/*
+ * Setup
+ */
+
+int statsSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("stats", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaSketch", test_nmeaSketch)) //
+      || (!CU_add_test(pSuite, "nmeaStatsAddInfo", test_nmeaStatsAddInfo)) //
+      || (!CU_add_test(pSuite, "nmeaStatsMoments", test_nmeaStatsMoments)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
@@ -0,0 +1,268 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/track.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <string.h>
+
+int trackSuiteSetup(void);
+
+/*
+ * Helpers
+ */
+
+#define TRACK_RECORDS (1000)
+
+static void trackRecord(NmeaRecord *record, int64_t i) {
+  memset(record, 0, sizeof(*record));
+  record->time = 1456747200000000000LL + (i * 1000000000LL);
+  record->present = NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_SIG | NMEALIB_PRESENT_FIX
+      | NMEALIB_PRESENT_HDOP | NMEALIB_PRESENT_LAT | NMEALIB_PRESENT_LON | NMEALIB_PRESENT_ELV | NMEALIB_PRESENT_SPEED
+      | NMEALIB_PRESENT_TRACK;
+  record->sig = NMEALIB_SIG_FIX;
+  record->fix = NMEALIB_FIX_3D;
+  record->latitude = 52.0 + ((double) i * 0.0001);
+  record->longitude = -4.0 - ((double) i * 0.00015);
+  record->elevation = 10.0f + (float) (i % 7);
+  record->speed = 36.5f;
+  record->track = (float) ((i * 10) % 360);
+  record->hdop = 1.2f;
+
+  /* a fix drop-out every 100 records */
+  if (!(i % 100)) {
+    record->present = NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME | NMEALIB_PRESENT_SIG | NMEALIB_PRESENT_FIX;
+    record->sig = NMEALIB_SIG_INVALID;
+    record->fix = NMEALIB_FIX_BAD;
+    record->latitude = 0.0;
+    record->longitude = 0.0;
+    record->elevation = 0.0f;
+    record->speed = 0.0f;
+    record->track = 0.0f;
+    record->hdop = 0.0f;
+  }
+}
+
+static void trackCheck(const NmeaRecord *record, int64_t i) {
+  NmeaRecord expected;
+
+  trackRecord(&expected, i);
+  CU_ASSERT_EQUAL(record->time, expected.time);
+  CU_ASSERT_EQUAL(record->present, expected.present);
+  CU_ASSERT_EQUAL(record->sig, expected.sig);
+  CU_ASSERT_EQUAL(record->fix, expected.fix);
+  CU_ASSERT_DOUBLE_EQUAL(record->latitude, expected.latitude, 1E-7);
+  CU_ASSERT_DOUBLE_EQUAL(record->longitude, expected.longitude, 1E-7);
+  CU_ASSERT_DOUBLE_EQUAL(record->elevation, expected.elevation, 0.01);
+  CU_ASSERT_DOUBLE_EQUAL(record->speed, expected.speed, 0.01);
+  CU_ASSERT_DOUBLE_EQUAL(record->track, expected.track, 0.01);
+  CU_ASSERT_DOUBLE_EQUAL(record->hdop, expected.hdop, 0.01);
+}
+
+static void trackFill(NmeaTrack *track) {
+  NmeaRecord record;
+  int64_t i;
+
+  nmeaTrackInit(track);
+  for (i = 0; i < TRACK_RECORDS; i++) {
+    trackRecord(&record, i);
+    CU_ASSERT_EQUAL(nmeaTrackAppend(track, &record), true);
+  }
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaTrackAppend(void) {
+  NmeaTrack track;
+  NmeaRecord record;
+  NmeaInfo info;
+  bool r;
+
+  /* invalid inputs */
+
+  nmeaTrackInit(NULL);
+  nmeaTrackDestroy(NULL);
+  CU_ASSERT_EQUAL(nmeaTrackMemory(NULL), 0);
+
+  nmeaTrackInit(&track);
+  trackRecord(&record, 1);
+
+  r = nmeaTrackAppend(NULL, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaTrackAppend(&track, NULL);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* normal */
+
+  r = nmeaTrackAppend(&track, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(track.count, 1);
+  CU_ASSERT_EQUAL(track.blockCount, 1);
+
+  /* same time */
+
+  r = nmeaTrackAppend(&track, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(track.count, 2);
+
+  /* older */
+
+  trackRecord(&record, 0);
+  r = nmeaTrackAppend(&track, &record);
+  CU_ASSERT_EQUAL(r, false);
+  CU_ASSERT_EQUAL(track.count, 2);
+
+  /* from info */
+
+  memset(&info, 0, sizeof(info));
+  r = nmeaTrackAppendInfo(&track, &info);
+  CU_ASSERT_EQUAL(r, false);
+
+  info.present = NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME;
+  info.utc.year = 2016;
+  info.utc.mon = 3;
+  info.utc.day = 1;
+  r = nmeaTrackAppendInfo(&track, &info);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(track.count, 3);
+
+  nmeaTrackDestroy(&track);
+  CU_ASSERT_EQUAL(track.count, 0);
+  CU_ASSERT_PTR_NULL(track.blocks);
+
+  /* blocks and memory */
+
+  trackFill(&track);
+  CU_ASSERT_EQUAL(track.count, TRACK_RECORDS);
+  CU_ASSERT_EQUAL(track.blockCount, (TRACK_RECORDS + NMEALIB_TRACK_BLOCK_SIZE - 1) / NMEALIB_TRACK_BLOCK_SIZE);
+  CU_ASSERT(nmeaTrackMemory(&track) < ((TRACK_RECORDS * sizeof(NmeaInfo)) / 10));
+  CU_ASSERT(nmeaTrackMemory(&track) < (TRACK_RECORDS * 32));
+  nmeaTrackDestroy(&track);
+}
+
+static void test_nmeaTrackIterator(void) {
+  NmeaTrack track;
+  NmeaTrackIterator iterator;
+  NmeaRecord record;
+  int64_t i;
+  int64_t from;
+  int64_t to;
+  bool r;
+
+  trackFill(&track);
+
+  /* invalid inputs */
+
+  nmeaTrackIteratorInit(NULL, &track, INT64_MIN, INT64_MAX);
+  nmeaTrackIteratorSetArea(NULL, 0.0, 0.0, 0.0, 0.0);
+
+  r = nmeaTrackIteratorNext(NULL, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  nmeaTrackIteratorInit(&iterator, NULL, INT64_MIN, INT64_MAX);
+  r = nmeaTrackIteratorNext(&iterator, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  nmeaTrackIteratorInit(&iterator, &track, INT64_MIN, INT64_MAX);
+  r = nmeaTrackIteratorNext(&iterator, NULL);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* sequential decode */
+
+  nmeaTrackIteratorInit(&iterator, &track, INT64_MIN, INT64_MAX);
+  for (i = 0; i < TRACK_RECORDS; i++) {
+    r = nmeaTrackIteratorNext(&iterator, &record);
+    CU_ASSERT_EQUAL_FATAL(r, true);
+    trackCheck(&record, i);
+  }
+  r = nmeaTrackIteratorNext(&iterator, &record);
+  CU_ASSERT_EQUAL(r, false);
+  r = nmeaTrackIteratorNext(&iterator, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* time range, crossing a block boundary */
+
+  trackRecord(&record, 250);
+  from = record.time;
+  trackRecord(&record, 300);
+  to = record.time;
+
+  nmeaTrackIteratorInit(&iterator, &track, from, to);
+  for (i = 250; i <= 300; i++) {
+    r = nmeaTrackIteratorNext(&iterator, &record);
+    CU_ASSERT_EQUAL_FATAL(r, true);
+    trackCheck(&record, i);
+  }
+  r = nmeaTrackIteratorNext(&iterator, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* time range outside of the track */
+
+  nmeaTrackIteratorInit(&iterator, &track, INT64_MIN, from - (300LL * 1000000000LL));
+  r = nmeaTrackIteratorNext(&iterator, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  nmeaTrackIteratorInit(&iterator, &track, to + (1000LL * 1000000000LL), INT64_MAX);
+  r = nmeaTrackIteratorNext(&iterator, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* area: latitude [52.06, 52.065], records 600 - 650 minus the drop-out */
+
+  nmeaTrackIteratorInit(&iterator, &track, INT64_MIN, INT64_MAX);
+  nmeaTrackIteratorSetArea(&iterator, 52.05995, -180.0, 52.06505, 180.0);
+  for (i = 601; i <= 650; i++) {
+    r = nmeaTrackIteratorNext(&iterator, &record);
+    CU_ASSERT_EQUAL_FATAL(r, true);
+    trackCheck(&record, i);
+  }
+  r = nmeaTrackIteratorNext(&iterator, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* area outside of the track */
+
+  nmeaTrackIteratorInit(&iterator, &track, INT64_MIN, INT64_MAX);
+  nmeaTrackIteratorSetArea(&iterator, 10.0, 10.0, 20.0, 20.0);
+  r = nmeaTrackIteratorNext(&iterator, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  nmeaTrackDestroy(&track);
+}
+
+/*
+ * Setup
+ */
+
+int trackSuiteSetup(void) {
+  CU_pSuite pSuite = CU_add_suite("track", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaTrackAppend", test_nmeaTrackAppend)) //
+      || (!CU_add_test(pSuite, "nmeaTrackIterator", test_nmeaTrackIterator)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
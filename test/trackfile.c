@@ -0,0 +1,424 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testHelpers.h"
+
+#include <nmealib/trackfile.h>
+#include <CUnit/Basic.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int trackFileSuiteSetup(void);
+
+/*
+ * Helpers
+ */
+
+#define TRACKFILE_RECORDS (3000)
+
+static char trackFilePath[] = "/tmp/nmealib-trackfile-XXXXXX";
+
+static void trackFileRecord(NmeaRecord *record, int64_t i) {
+  memset(record, 0, sizeof(*record));
+  record->time = 1456747200000000000LL + (i * 500000000LL);
+  record->present = NMEALIB_RECORD_PRESENT_MASK;
+  record->sig = NMEALIB_SIG_FIX;
+  record->fix = NMEALIB_FIX_3D;
+  record->latitude = 52.0 + ((double) i * 0.0001);
+  record->longitude = -4.0 - ((double) i * 0.00015);
+  record->elevation = (float) i;
+  record->speed = 36.5f;
+  record->track = (float) (i % 360);
+  record->pdop = 2.5f;
+  record->hdop = 1.5f;
+  record->vdop = 2.0f;
+}
+
+static off_t trackFileSize(void) {
+  struct stat st;
+
+  if (stat(trackFilePath, &st)) {
+    return -1;
+  }
+
+  return st.st_size;
+}
+
+static void trackFileCreate(void) {
+  NmeaTrackFile file;
+  NmeaRecord record;
+  int64_t i;
+
+  unlink(trackFilePath);
+  CU_ASSERT_EQUAL_FATAL(nmeaTrackFileOpen(&file, trackFilePath, true), true);
+  for (i = 0; i < TRACKFILE_RECORDS; i++) {
+    trackFileRecord(&record, i);
+    CU_ASSERT_EQUAL(nmeaTrackFileAppend(&file, &record), true);
+  }
+  CU_ASSERT_EQUAL(nmeaTrackFileSync(&file), true);
+  CU_ASSERT_EQUAL(nmeaTrackFileClose(&file), true);
+}
+
+/*
+ * Tests
+ */
+
+static void test_nmeaTrackFileOpen(void) {
+  NmeaTrackFile file;
+  bool r;
+  int fd;
+
+  /* invalid inputs */
+
+  r = nmeaTrackFileOpen(NULL, trackFilePath, true);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaTrackFileOpen(&file, NULL, true);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaTrackFileClose(NULL);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* does not exist */
+
+  unlink(trackFilePath);
+  r = nmeaTrackFileOpen(&file, trackFilePath, false);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* create */
+
+  r = nmeaTrackFileOpen(&file, trackFilePath, true);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(file.count, 0);
+  CU_ASSERT_EQUAL(nmeaTrackFileSeek(&file, 0), 0);
+  r = nmeaTrackFileClose(&file);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(trackFileSize(), NMEALIB_TRACKFILE_HEADER_SIZE);
+
+  /* empty, read-only */
+
+  r = nmeaTrackFileOpen(&file, trackFilePath, false);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(file.count, 0);
+  nmeaTrackFileClose(&file);
+
+  /* not a track file */
+
+  fd = open(trackFilePath, O_WRONLY);
+  CU_ASSERT_FATAL(fd >= 0);
+  CU_ASSERT_EQUAL(pwrite(fd, "X", 1, 0), 1);
+  close(fd);
+
+  r = nmeaTrackFileOpen(&file, trackFilePath, false);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaTrackFileOpen(&file, trackFilePath, true);
+  CU_ASSERT_EQUAL(r, false);
+
+  unlink(trackFilePath);
+}
+
+static void test_nmeaTrackFileAppend(void) {
+  NmeaTrackFile file;
+  NmeaTrackFile reader;
+  NmeaRecord record;
+  NmeaRecord out;
+  NmeaInfo info;
+  bool r;
+
+  unlink(trackFilePath);
+  nmeaTrackFileOpen(&file, trackFilePath, true);
+
+  /* invalid inputs */
+
+  trackFileRecord(&record, 10);
+  r = nmeaTrackFileAppend(NULL, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaTrackFileAppend(&file, NULL);
+  CU_ASSERT_EQUAL(r, false);
+
+  CU_ASSERT_EQUAL(nmeaTrackFileSync(NULL), false);
+  CU_ASSERT_EQUAL(nmeaTrackFileRefresh(NULL), false);
+
+  /* normal */
+
+  r = nmeaTrackFileAppend(&file, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(file.count, 1);
+
+  /* older */
+
+  trackFileRecord(&record, 9);
+  r = nmeaTrackFileAppend(&file, &record);
+  CU_ASSERT_EQUAL(r, false);
+  CU_ASSERT_EQUAL(file.count, 1);
+
+  /* same time appends a new version and keeps the previous one */
+
+  trackFileRecord(&record, 10);
+  record.latitude = 1.0;
+  r = nmeaTrackFileAppend(&file, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(file.count, 2);
+  CU_ASSERT_EQUAL(trackFileSize(), NMEALIB_TRACKFILE_HEADER_SIZE + (2 * NMEALIB_TRACKFILE_RECORD_SIZE));
+
+  r = nmeaTrackFileGet(&file, 1, &out);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(memcmp(&out, &record, sizeof(out)), 0);
+
+  trackFileRecord(&out, 10);
+  r = nmeaTrackFileGet(&file, 0, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(memcmp(&out, &record, sizeof(out)), 0);
+
+  CU_ASSERT_EQUAL(nmeaTrackFileSeek(&file, record.time), 1);
+  CU_ASSERT_EQUAL(nmeaTrackFileSeek(&file, INT64_MIN), 1);
+  CU_ASSERT_EQUAL(nmeaTrackFileNext(&file, 1), 2);
+
+  r = nmeaTrackFileGet(&file, 1, &record);
+  CU_ASSERT_EQUAL(r, true);
+
+  /* from info */
+
+  memset(&info, 0, sizeof(info));
+  r = nmeaTrackFileAppendInfo(&file, &info);
+  CU_ASSERT_EQUAL(r, false);
+
+  info.present = NMEALIB_PRESENT_UTCDATE | NMEALIB_PRESENT_UTCTIME;
+  info.utc.year = 2016;
+  info.utc.mon = 3;
+  info.utc.day = 1;
+  r = nmeaTrackFileAppendInfo(&file, &info);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(file.count, 3);
+  CU_ASSERT_EQUAL(nmeaTrackFileNext(&file, 0), 2);
+  CU_ASSERT_EQUAL(nmeaTrackFileNext(&file, 1), 2);
+  CU_ASSERT_EQUAL(nmeaTrackFileNext(&file, 2), 3);
+
+  /* a reader picks up appends on refresh */
+
+  r = nmeaTrackFileOpen(&reader, trackFilePath, false);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(reader.count, 3);
+
+  r = nmeaTrackFileAppend(&reader, &record);
+  CU_ASSERT_EQUAL(r, false);
+  CU_ASSERT_EQUAL(nmeaTrackFileSync(&reader), false);
+
+  info.utc.day = 2;
+  r = nmeaTrackFileAppendInfo(&file, &info);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(reader.count, 3);
+
+  r = nmeaTrackFileRefresh(&reader);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(reader.count, 4);
+
+  r = nmeaTrackFileGet(&reader, 3, &out);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(out.time, nmeaTimeToEpochNs(&info.utc));
+
+  nmeaTrackFileClose(&reader);
+  nmeaTrackFileClose(&file);
+  unlink(trackFilePath);
+}
+
+static void test_nmeaTrackFileGet(void) {
+  NmeaTrackFile file;
+  NmeaRecord record;
+  NmeaRecord expected;
+  size_t i;
+  bool r;
+
+  trackFileCreate();
+  CU_ASSERT_EQUAL(trackFileSize(),
+      NMEALIB_TRACKFILE_HEADER_SIZE + (TRACKFILE_RECORDS * NMEALIB_TRACKFILE_RECORD_SIZE));
+
+  r = nmeaTrackFileOpen(&file, trackFilePath, false);
+  CU_ASSERT_EQUAL_FATAL(r, true);
+  CU_ASSERT_EQUAL(file.count, TRACKFILE_RECORDS);
+  CU_ASSERT_EQUAL(file.indexCount,
+      (TRACKFILE_RECORDS + NMEALIB_TRACKFILE_INDEX_STRIDE - 1) / NMEALIB_TRACKFILE_INDEX_STRIDE);
+
+  /* invalid inputs */
+
+  r = nmeaTrackFileGet(NULL, 0, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaTrackFileGet(&file, 0, NULL);
+  CU_ASSERT_EQUAL(r, false);
+
+  r = nmeaTrackFileGet(&file, TRACKFILE_RECORDS, &record);
+  CU_ASSERT_EQUAL(r, false);
+
+  /* normal */
+
+  for (i = 0; i < TRACKFILE_RECORDS; i++) {
+    trackFileRecord(&expected, (int64_t) i);
+    r = nmeaTrackFileGet(&file, i, &record);
+    CU_ASSERT_EQUAL(r, true);
+    CU_ASSERT_EQUAL(memcmp(&record, &expected, sizeof(record)), 0);
+  }
+
+  nmeaTrackFileClose(&file);
+  unlink(trackFilePath);
+}
+
+static void test_nmeaTrackFileSeek(void) {
+  NmeaTrackFile file;
+  NmeaRecord record;
+  int64_t i;
+
+  trackFileCreate();
+  nmeaTrackFileOpen(&file, trackFilePath, false);
+
+  CU_ASSERT_EQUAL(nmeaTrackFileSeek(NULL, 0), 0);
+
+  /* before the first record */
+
+  CU_ASSERT_EQUAL(nmeaTrackFileSeek(&file, INT64_MIN), 0);
+
+  /* every record, exactly and just after */
+
+  for (i = 0; i < TRACKFILE_RECORDS; i++) {
+    trackFileRecord(&record, i);
+    CU_ASSERT_EQUAL(nmeaTrackFileSeek(&file, record.time), (size_t) i);
+    CU_ASSERT_EQUAL(nmeaTrackFileSeek(&file, record.time + 1), (size_t) i + 1);
+  }
+
+  /* after the last record */
+
+  CU_ASSERT_EQUAL(nmeaTrackFileSeek(&file, INT64_MAX), TRACKFILE_RECORDS);
+
+  /* next */
+
+  CU_ASSERT_EQUAL(nmeaTrackFileNext(NULL, 0), 0);
+  for (i = 0; i < TRACKFILE_RECORDS; i++) {
+    CU_ASSERT_EQUAL(nmeaTrackFileNext(&file, (size_t) i), (size_t) i + 1);
+  }
+  CU_ASSERT_EQUAL(nmeaTrackFileNext(&file, SIZE_MAX), TRACKFILE_RECORDS);
+
+  nmeaTrackFileClose(&file);
+  unlink(trackFilePath);
+}
+
+static void test_nmeaTrackFileRecovery(void) {
+  NmeaTrackFile file;
+  NmeaRecord record;
+  off_t size;
+  bool r;
+  int fd;
+
+  trackFileCreate();
+  size = trackFileSize();
+
+  /* corrupt the last record and write a partial record */
+
+  fd = open(trackFilePath, O_WRONLY);
+  CU_ASSERT_FATAL(fd >= 0);
+  CU_ASSERT_EQUAL(pwrite(fd, "X", 1, size - 10), 1);
+  CU_ASSERT_EQUAL(pwrite(fd, "PARTIAL", 7, size), 7);
+  close(fd);
+
+  /* a reader ignores the partial record and detects the corrupt record */
+
+  r = nmeaTrackFileOpen(&file, trackFilePath, false);
+  CU_ASSERT_EQUAL_FATAL(r, true);
+  CU_ASSERT_EQUAL(file.count, TRACKFILE_RECORDS);
+
+  r = nmeaTrackFileGet(&file, TRACKFILE_RECORDS - 2, &record);
+  CU_ASSERT_EQUAL(r, true);
+
+  r = nmeaTrackFileGet(&file, TRACKFILE_RECORDS - 1, &record);
+  CU_ASSERT_EQUAL(r, false);
+  nmeaTrackFileClose(&file);
+
+  /* a writer removes both */
+
+  r = nmeaTrackFileOpen(&file, trackFilePath, true);
+  CU_ASSERT_EQUAL_FATAL(r, true);
+  CU_ASSERT_EQUAL(file.count, TRACKFILE_RECORDS - 1);
+  CU_ASSERT_EQUAL(trackFileSize(), size - NMEALIB_TRACKFILE_RECORD_SIZE);
+
+  /* and can continue appending */
+
+  trackFileRecord(&record, TRACKFILE_RECORDS - 1);
+  r = nmeaTrackFileAppend(&file, &record);
+  CU_ASSERT_EQUAL(r, true);
+  CU_ASSERT_EQUAL(trackFileSize(), size);
+  CU_ASSERT_EQUAL(nmeaTrackFileSeek(&file, record.time), TRACKFILE_RECORDS - 1);
+
+  r = nmeaTrackFileGet(&file, TRACKFILE_RECORDS - 1, &record);
+  CU_ASSERT_EQUAL(r, true);
+  nmeaTrackFileClose(&file);
+
+  /* a partially written new version of the last fix leaves the previous version intact */
+
+  fd = open(trackFilePath, O_WRONLY);
+  CU_ASSERT_FATAL(fd >= 0);
+  CU_ASSERT_EQUAL(pwrite(fd, "PARTIAL", 7, size), 7);
+  close(fd);
+
+  r = nmeaTrackFileOpen(&file, trackFilePath, true);
+  CU_ASSERT_EQUAL_FATAL(r, true);
+  CU_ASSERT_EQUAL(file.count, TRACKFILE_RECORDS);
+  CU_ASSERT_EQUAL(trackFileSize(), size);
+  CU_ASSERT_EQUAL(nmeaTrackFileSeek(&file, record.time), TRACKFILE_RECORDS - 1);
+
+  r = nmeaTrackFileGet(&file, TRACKFILE_RECORDS - 1, &record);
+  CU_ASSERT_EQUAL(r, true);
+
+  nmeaTrackFileClose(&file);
+  unlink(trackFilePath);
+}
+
+/*
+ * Setup
+ */
+
+int trackFileSuiteSetup(void) {
+  CU_pSuite pSuite;
+  int fd;
+
+  fd = mkstemp(trackFilePath);
+  if (fd < 0) {
+    return CUE_SINIT_FAILED;
+  }
+  close(fd);
+
+  pSuite = CU_add_suite("trackfile", mockContextSuiteInit, mockContextSuiteClean);
+  if (!pSuite) {
+    return CU_get_error();
+  }
+
+  if ( //
+      (!CU_add_test(pSuite, "nmeaTrackFileOpen", test_nmeaTrackFileOpen)) //
+      || (!CU_add_test(pSuite, "nmeaTrackFileAppend", test_nmeaTrackFileAppend)) //
+      || (!CU_add_test(pSuite, "nmeaTrackFileGet", test_nmeaTrackFileGet)) //
+      || (!CU_add_test(pSuite, "nmeaTrackFileSeek", test_nmeaTrackFileSeek)) //
+      || (!CU_add_test(pSuite, "nmeaTrackFileRecovery", test_nmeaTrackFileRecovery)) //
+      ) {
+    return CU_get_error();
+  }
+
+  return CUE_SUCCESS;
+}
@@ -136,6 +136,10 @@ static void test_nmeaStringContainsWhitespace(void) {
 static void test_nmeaCalculateCRC(void) {
   unsigned int r;
   const char *s = "dummy sentence";
+  char buffer[256 + 16];
+  size_t offset;
+  size_t sz;
+  size_t i;
 
   /* invalid inputs */
 
@@ -160,6 +164,28 @@ static void test_nmeaCalculateCRC(void) {
   s = "$GPGGA,dummy sentence";
   r = nmeaCalculateCRC(s, strlen(s));
   CU_ASSERT_EQUAL(r, 51);
+
+  /* the same as a byte by byte XOR, on all byte values, at every length and alignment */
+
+  for (i = 0; i < sizeof(buffer); i++) {
+    buffer[i] = (char) ((i * 37) + 11);
+  }
+
+  for (offset = 0; offset < 16; offset++) {
+    for (sz = 1; sz <= 256; sz++) {
+      unsigned int crc = 0;
+
+      for (i = offset; i < (offset + sz); i++) {
+        crc ^= (unsigned char) buffer[i];
+      }
+      if (buffer[offset] == '$') {
+        crc ^= '$';
+      }
+
+      r = nmeaCalculateCRC(&buffer[offset], sz);
+      CU_ASSERT_EQUAL(r, crc);
+    }
+  }
 }
 
 static void test_nmeaStringToInteger(void) {
@@ -68,6 +68,11 @@ static void test_nmeaValidateIsInvalidCharacter(void) {
 static void test_nmeaValidateSentenceHasInvalidCharacters(void) {
   const NmeaInvalidCharacter *r;
   const char *s;
+  char buffer[128];
+  size_t offset;
+  size_t sz;
+  size_t i;
+  int c;
 
   r = nmeaValidateSentenceHasInvalidCharacters(NULL, 1);
   CU_ASSERT_PTR_NULL(r);
@@ -84,6 +89,45 @@ static void test_nmeaValidateSentenceHasInvalidCharacters(void) {
   r = nmeaValidateSentenceHasInvalidCharacters(s, strlen(s));
   CU_ASSERT_EQUAL(r->character, '!');
   CU_ASSERT_STRING_EQUAL(r->description, "exclamation mark");
+
+  /* the same as nmeaValidateIsInvalidCharacter on every character, at every length and alignment */
+
+  for (offset = 0; offset < 16; offset++) {
+    for (sz = 0; sz <= 100; sz++) {
+      for (i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (char) ('A' + (i % 26));
+      }
+      r = nmeaValidateSentenceHasInvalidCharacters(&buffer[offset], sz);
+      CU_ASSERT_PTR_NULL(r);
+
+      /* an invalid character just beyond the string */
+      buffer[offset + sz] = '$';
+      r = nmeaValidateSentenceHasInvalidCharacters(&buffer[offset], sz);
+      CU_ASSERT_PTR_NULL(r);
+    }
+  }
+
+  for (offset = 0; offset < 4; offset++) {
+    for (i = 0; i < 63; i++) {
+      for (c = 0; c < 256; c++) {
+        const NmeaInvalidCharacter *expected = nmeaValidateIsInvalidCharacter((char) c);
+        size_t j;
+
+        for (j = 0; j < sizeof(buffer); j++) {
+          buffer[j] = (char) ('a' + (j % 26));
+        }
+        buffer[offset + i] = (char) c;
+
+        /* the first invalid character wins */
+        buffer[offset + 63] = '~';
+
+        r = nmeaValidateSentenceHasInvalidCharacters(&buffer[offset], 64);
+        CU_ASSERT_PTR_EQUAL(r, expected ?
+            expected :
+            nmeaValidateIsInvalidCharacter('~'));
+      }
+    }
+  }
 }
 
 static void test_nmeaValidateTime(void) {